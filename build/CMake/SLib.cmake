@@ -45,6 +45,7 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/core/locale.cpp"
  "${SLIB_PATH}/src/slib/core/log.cpp"
  "${SLIB_PATH}/src/slib/core/memory.cpp"
+ "${SLIB_PATH}/src/slib/core/memory_pool.cpp"
  "${SLIB_PATH}/src/slib/core/mutex.cpp"
  "${SLIB_PATH}/src/slib/core/object.cpp"
  "${SLIB_PATH}/src/slib/core/red_black_tree.cpp"
@@ -62,7 +63,9 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/core/thread_unix.cpp"
  "${SLIB_PATH}/src/slib/core/time.cpp"
  "${SLIB_PATH}/src/slib/core/time_unix.cpp"
+ "${SLIB_PATH}/src/slib/core/time_zone_info.cpp"
  "${SLIB_PATH}/src/slib/core/timer.cpp"
+ "${SLIB_PATH}/src/slib/core/timing_wheel.cpp"
  "${SLIB_PATH}/src/slib/core/variant.cpp"
 
  "${SLIB_PATH}/src/slib/system/dynamic_library.cpp"
@@ -89,6 +92,7 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/data/lzma.cpp"
  "${SLIB_PATH}/src/slib/data/table_model.cpp"
  "${SLIB_PATH}/src/slib/data/xml.cpp"
+ "${SLIB_PATH}/src/slib/data/xml_push_parser.cpp"
  "${SLIB_PATH}/src/slib/data/zlib.cpp"
  "${SLIB_PATH}/src/slib/data/zstd.cpp"
 
@@ -171,6 +175,8 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/graphics/animation.cpp"
  "${SLIB_PATH}/src/slib/graphics/bitmap.cpp"
  "${SLIB_PATH}/src/slib/graphics/bitmap_data.cpp"
+ "${SLIB_PATH}/src/slib/graphics/bitmap_data_sse2.cpp"
+ "${SLIB_PATH}/src/slib/graphics/bitmap_data_avx2.cpp"
  "${SLIB_PATH}/src/slib/graphics/bitmap_ext.cpp"
  "${SLIB_PATH}/src/slib/graphics/bitmap_format.cpp"
  "${SLIB_PATH}/src/slib/graphics/brush.cpp"
@@ -192,6 +198,7 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/graphics/image_canvas.cpp"
  "${SLIB_PATH}/src/slib/graphics/image_jpeg.cpp"
  "${SLIB_PATH}/src/slib/graphics/image_png.cpp"
+ "${SLIB_PATH}/src/slib/graphics/image_resize.cpp"
  "${SLIB_PATH}/src/slib/graphics/image_stb.cpp"
  "${SLIB_PATH}/src/slib/graphics/jpeg.cpp"
  "${SLIB_PATH}/src/slib/graphics/pen.cpp"
@@ -229,8 +236,12 @@ set (SLIB_SOURCE_FILES
  "${SLIB_PATH}/src/slib/device/performance.cpp"
  "${SLIB_PATH}/src/slib/device/sensor.cpp"
 
+ "${SLIB_PATH}/src/slib/db/async_redis.cpp"
+ "${SLIB_PATH}/src/slib/db/btree_store.cpp"
  "${SLIB_PATH}/src/slib/db/database.cpp"
  "${SLIB_PATH}/src/slib/db/database_cursor.cpp"
+ "${SLIB_PATH}/src/slib/db/database_pool.cpp"
+ "${SLIB_PATH}/src/slib/db/database_column_batch.cpp"
  "${SLIB_PATH}/src/slib/db/database_expression.cpp"
  "${SLIB_PATH}/src/slib/db/database_model.cpp"
  "${SLIB_PATH}/src/slib/db/database_sql.cpp"
@@ -252,10 +263,15 @@ set (SLIB_SOURCE_FILES
 
  "${SLIB_PATH}/src/slib/geo/dem.cpp"
  "${SLIB_PATH}/src/slib/geo/earth.cpp"
+ "${SLIB_PATH}/src/slib/geo/geo_batch.cpp"
+ "${SLIB_PATH}/src/slib/geo/geo_batch_sse2.cpp"
+ "${SLIB_PATH}/src/slib/geo/geo_batch_avx2.cpp"
  "${SLIB_PATH}/src/slib/geo/geo_line.cpp"
  "${SLIB_PATH}/src/slib/geo/geo_location.cpp"
  "${SLIB_PATH}/src/slib/geo/geo_rectangle.cpp"
+ "${SLIB_PATH}/src/slib/geo/geo_rtree.cpp"
  "${SLIB_PATH}/src/slib/geo/globe.cpp"
+ "${SLIB_PATH}/src/slib/geo/tiled_dem.cpp"
  "${SLIB_PATH}/src/slib/geo/latlon.cpp"
  "${SLIB_PATH}/src/slib/geo/utm.cpp"
 
@@ -486,6 +502,8 @@ endif()
 
 if (SLIB_X86_64)
  SET_PROPERTY( SOURCE ${SLIB_PATH}/src/slib/data/crc32c.cpp PROPERTY COMPILE_FLAGS -msse4.2 )
+ SET_PROPERTY( SOURCE ${SLIB_PATH}/src/slib/graphics/bitmap_data_avx2.cpp PROPERTY COMPILE_FLAGS -mavx2 )
+ SET_PROPERTY( SOURCE ${SLIB_PATH}/src/slib/geo/geo_batch_avx2.cpp PROPERTY COMPILE_FLAGS -mavx2 )
 endif()
 
 set (EXTERNAL_SRC_DIR "${SLIB_PATH}/external/src")
@@ -26,10 +26,163 @@
 #include <slib/core/memory.h>
 #include <slib/core/search.h>
 #include <slib/core/string.h>
+#include <slib/core/hash_map.h>
+#include <slib/core/mio.h>
+#include <slib/core/endian.h>
+#include <slib/math/math.h>
+
+#define INDEX_SIGNATURE "SDBIPIX1"
+#define INDEX_SIGNATURE_SIZE 8
+#define INDEX_HEADER_SIZE 128
+#define INDEX_SECTION_ALIGN 64
+#define INDEX_MAX_CODE_COUNT 0x10000
+#define BATCH_SIZE 16
+
+/*
+	Index File Format (little endian)
+
+	Header (128 bytes)
+		0: Signature ("SDBIPIX1")
+		8: Number of IPv4 ranges (uint32)
+		12: Number of IPv6 ranges (uint32)
+		16: Number of country codes (uint32)
+		20: Reserved (uint32)
+		24: Offsets of the sections (uint64 x 7): codes, IPv4 starts, IPv4 ends, IPv4 code indices, IPv6 starts, IPv6 ends, IPv6 code indices
+
+	Country codes: char[4] for each code
+	IPv4 starts, ends: uint32 x (N + 1), in the Eytzinger order (first element is not used)
+	IPv6 starts, ends: (uint64 high, uint64 low) x (N + 1), in the Eytzinger order
+	Code indices: uint16 x (N + 1), in the Eytzinger order
+	Every section is aligned to 64 bytes.
+*/
 
 namespace slib
 {
 
+	namespace
+	{
+		enum
+		{
+			SectionCodes = 0,
+			SectionIPv4Starts = 1,
+			SectionIPv4Ends = 2,
+			SectionIPv4Codes = 3,
+			SectionIPv6Starts = 4,
+			SectionIPv6Ends = 5,
+			SectionIPv6Codes = 6,
+			SectionCount = 7
+		};
+
+		static sl_uint64 AlignSection(sl_uint64 offset)
+		{
+			return (offset + INDEX_SECTION_ALIGN - 1) & ~((sl_uint64)(INDEX_SECTION_ALIGN - 1));
+		}
+
+		static void GetSectionSizes(sl_uint64* sizes, sl_uint32 nIPv4, sl_uint32 nIPv6, sl_uint32 nCodes)
+		{
+			sizes[SectionCodes] = (sl_uint64)nCodes * 4;
+			sizes[SectionIPv4Starts] = ((sl_uint64)nIPv4 + 1) * 4;
+			sizes[SectionIPv4Ends] = ((sl_uint64)nIPv4 + 1) * 4;
+			sizes[SectionIPv4Codes] = ((sl_uint64)nIPv4 + 1) * 2;
+			sizes[SectionIPv6Starts] = ((sl_uint64)nIPv6 + 1) * 16;
+			sizes[SectionIPv6Ends] = ((sl_uint64)nIPv6 + 1) * 16;
+			sizes[SectionIPv6Codes] = ((sl_uint64)nIPv6 + 1) * 2;
+		}
+
+		// Fills `order[k]` (1 <= k <= n) with the sorted index of the k-th node in the Eytzinger order
+		static sl_uint32 BuildEytzingerOrder(sl_uint32* order, sl_uint32 n, sl_uint32 i, sl_uint32 k)
+		{
+			if (k <= n) {
+				i = BuildEytzingerOrder(order, n, i, k << 1);
+				order[k] = i++;
+				i = BuildEytzingerOrder(order, n, i, (k << 1) | 1);
+			}
+			return i;
+		}
+
+		// `k`: the node reached by the search, where every step goes right if the node is not greater than the key. Returns the last node going right, which is the greatest one not greater than the key (0 if not found)
+		SLIB_INLINE static sl_uint32 GetSearchResult(sl_uint32 k)
+		{
+			return k >> (Math::getLeastSignificantBits(k) + 1);
+		}
+
+		// Returns the previous node in the sorted order (0 if not found)
+		static sl_uint32 GetPreviousNode(sl_uint32 k, sl_uint32 n)
+		{
+			if ((k << 1) <= n) {
+				k <<= 1;
+				while (((k << 1) | 1) <= n) {
+					k = (k << 1) | 1;
+				}
+				return k;
+			}
+			return GetSearchResult(k);
+		}
+
+		SLIB_INLINE static sl_uint32 SearchIPv4(const sl_uint32* starts, sl_uint32 n, sl_uint32 ip)
+		{
+			sl_uint32 k = 1;
+			while (k <= n) {
+				k = (k << 1) | (sl_uint32)(starts[k] <= ip);
+			}
+			return GetSearchResult(k);
+		}
+
+		// `k`: the node of the greatest start not greater than `ip`
+		static sl_uint32 MatchIPv4(const sl_uint32* starts, const sl_uint32* ends, sl_uint32 n, sl_uint32 k, sl_uint32 ip, sl_size depth)
+		{
+			if (!k) {
+				return 0;
+			}
+			if (starts[k] == ip) {
+				return k;
+			}
+			// reverse search for overlapped ip ranges
+			for (sl_size i = 0; i < depth && k; i++) {
+				if (ip <= ends[k]) {
+					return k;
+				}
+				k = GetPreviousNode(k, n);
+			}
+			return 0;
+		}
+
+		template <class KEY>
+		SLIB_INLINE static sl_bool IsLessThanOrEqual(const KEY& a, sl_uint64 high, sl_uint64 low)
+		{
+			return a.high < high || (a.high == high && a.low <= low);
+		}
+
+		template <class KEY>
+		SLIB_INLINE static sl_uint32 SearchIPv6(const KEY* starts, sl_uint32 n, sl_uint64 high, sl_uint64 low)
+		{
+			sl_uint32 k = 1;
+			while (k <= n) {
+				k = (k << 1) | (sl_uint32)(IsLessThanOrEqual(starts[k], high, low));
+			}
+			return GetSearchResult(k);
+		}
+
+		template <class KEY>
+		static sl_uint32 MatchIPv6(const KEY* starts, const KEY* ends, sl_uint32 n, sl_uint32 k, sl_uint64 high, sl_uint64 low, sl_size depth)
+		{
+			if (!k) {
+				return 0;
+			}
+			if (starts[k].high == high && starts[k].low == low) {
+				return k;
+			}
+			// reverse search for overlapped ip ranges
+			for (sl_size i = 0; i < depth && k; i++) {
+				if (high < ends[k].high || (high == ends[k].high && low <= ends[k].low)) {
+					return k;
+				}
+				k = GetPreviousNode(k, n);
+			}
+			return 0;
+		}
+	}
+
 	template<>
 	class Compare<DbIp::IPv4Item, sl_uint32>
 	{
@@ -170,6 +323,8 @@ namespace slib
 			return sl_false;
 		}
 
+		clearAll();
+
 		m_ipv4 = list4.getData();
 		m_countIPv4 = (sl_uint32)(list4.getCount());
 		m_listIPv4 = Move(list4);
@@ -190,6 +345,202 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool DbIp::compileIndex(const StringParam& pathToIndexFile)
+	{
+		List<IPv4Item> list4 = m_listIPv4.duplicate();
+		List<IPv6Item> list6 = m_listIPv6.duplicate();
+		list4.sort_NoLock([](const IPv4Item& a, const IPv4Item& b) {
+			return Compare<sl_uint32>()(a.start, b.start);
+		});
+		list6.sort_NoLock([](const IPv6Item& a, const IPv6Item& b) {
+			return Compare<IPv6Address>()(a.start, b.start);
+		});
+		sl_uint32 n4 = (sl_uint32)(list4.getCount());
+		sl_uint32 n6 = (sl_uint32)(list6.getCount());
+		if (!n4 && !n6) {
+			return sl_false;
+		}
+		IPv4Item* items4 = list4.getData();
+		IPv6Item* items6 = list6.getData();
+
+		// country code table
+		HashMap<sl_uint32, sl_uint16> mapCodes;
+		List<sl_uint32> codes;
+		auto getCodeIndex = [&mapCodes, &codes](const char* code, sl_uint16& outIndex) -> sl_bool {
+			sl_uint32 key = MIO::readUint32LE(code);
+			if (mapCodes.get_NoLock(key, &outIndex)) {
+				return sl_true;
+			}
+			if (codes.getCount() >= INDEX_MAX_CODE_COUNT) {
+				return sl_false;
+			}
+			outIndex = (sl_uint16)(codes.getCount());
+			return codes.add_NoLock(key) && mapCodes.put_NoLock(key, outIndex);
+		};
+		sl_uint32 nCodes;
+		Array<sl_uint16> codeIndices = Array<sl_uint16>::create(n4 + n6);
+		if (codeIndices.isNull()) {
+			return sl_false;
+		}
+		{
+			sl_uint16* p = codeIndices.getData();
+			for (sl_uint32 i = 0; i < n4; i++) {
+				if (!(getCodeIndex(items4[i].code, p[i]))) {
+					return sl_false;
+				}
+			}
+			for (sl_uint32 i = 0; i < n6; i++) {
+				if (!(getCodeIndex(items6[i].code, p[n4 + i]))) {
+					return sl_false;
+				}
+			}
+			nCodes = (sl_uint32)(codes.getCount());
+		}
+
+		sl_uint64 sizes[SectionCount];
+		sl_uint64 offsets[SectionCount];
+		GetSectionSizes(sizes, n4, n6, nCodes);
+		sl_uint64 offset = INDEX_HEADER_SIZE;
+		for (sl_uint32 i = 0; i < SectionCount; i++) {
+			offsets[i] = offset;
+			offset = AlignSection(offset + sizes[i]);
+		}
+		if (offset > SLIB_SIZE_MAX) {
+			return sl_false;
+		}
+		Memory mem = Memory::create((sl_size)offset);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		sl_uint8* data = (sl_uint8*)(mem.getData());
+		Base::zeroMemory(data, (sl_size)offset);
+
+		Base::copyMemory(data, INDEX_SIGNATURE, INDEX_SIGNATURE_SIZE);
+		MIO::writeUint32LE(data + 8, n4);
+		MIO::writeUint32LE(data + 12, n6);
+		MIO::writeUint32LE(data + 16, nCodes);
+		for (sl_uint32 i = 0; i < SectionCount; i++) {
+			MIO::writeUint64LE(data + 24 + (i << 3), offsets[i]);
+		}
+		{
+			sl_uint8* p = data + offsets[SectionCodes];
+			for (sl_uint32 i = 0; i < nCodes; i++) {
+				MIO::writeUint32LE(p + (i << 2), codes.getValueAt_NoLock(i));
+			}
+		}
+		Array<sl_uint32> order = Array<sl_uint32>::create(Math::max(n4, n6) + 1);
+		if (order.isNull()) {
+			return sl_false;
+		}
+		sl_uint32* pOrder = order.getData();
+		const sl_uint16* pCodeIndices = codeIndices.getData();
+		if (n4) {
+			BuildEytzingerOrder(pOrder, n4, 0, 1);
+			sl_uint8* starts = data + offsets[SectionIPv4Starts];
+			sl_uint8* ends = data + offsets[SectionIPv4Ends];
+			sl_uint8* indices = data + offsets[SectionIPv4Codes];
+			for (sl_uint32 k = 1; k <= n4; k++) {
+				IPv4Item& item = items4[pOrder[k]];
+				MIO::writeUint32LE(starts + (k << 2), item.start);
+				MIO::writeUint32LE(ends + (k << 2), item.end);
+				MIO::writeUint16LE(indices + (k << 1), pCodeIndices[pOrder[k]]);
+			}
+		}
+		if (n6) {
+			BuildEytzingerOrder(pOrder, n6, 0, 1);
+			sl_uint8* starts = data + offsets[SectionIPv6Starts];
+			sl_uint8* ends = data + offsets[SectionIPv6Ends];
+			sl_uint8* indices = data + offsets[SectionIPv6Codes];
+			for (sl_uint32 k = 1; k <= n6; k++) {
+				IPv6Item& item = items6[pOrder[k]];
+				MIO::writeUint64LE(starts + (k << 4), MIO::readUint64BE(item.start.m));
+				MIO::writeUint64LE(starts + (k << 4) + 8, MIO::readUint64BE(item.start.m + 8));
+				MIO::writeUint64LE(ends + (k << 4), MIO::readUint64BE(item.end.m));
+				MIO::writeUint64LE(ends + (k << 4) + 8, MIO::readUint64BE(item.end.m + 8));
+				MIO::writeUint16LE(indices + (k << 1), pCodeIndices[n4 + pOrder[k]]);
+			}
+		}
+		return File::writeAllBytes(pathToIndexFile, mem);
+	}
+
+	sl_bool DbIp::compileIndex(const StringParam& pathToCSVFile, const StringParam& pathToIndexFile)
+	{
+		DbIp db;
+		if (db.parseFile(pathToCSVFile)) {
+			return db.compileIndex(pathToIndexFile);
+		}
+		return sl_false;
+	}
+
+	sl_bool DbIp::openIndex(const StringParam& pathToIndexFile)
+	{
+		Memory mem = File::mapAllBytes(pathToIndexFile);
+		if (mem.isNotNull()) {
+			return loadIndex(mem);
+		}
+		return sl_false;
+	}
+
+	sl_bool DbIp::loadIndex(const Memory& index)
+	{
+		// The sections are accessed in place, which requires the little-endian host
+		if (Endian::isBE()) {
+			return sl_false;
+		}
+		sl_uint8* data = (sl_uint8*)(index.getData());
+		sl_size size = index.getSize();
+		if (size < INDEX_HEADER_SIZE || ((sl_size)data & 7)) {
+			return sl_false;
+		}
+		if (!(Base::equalsMemory(data, INDEX_SIGNATURE, INDEX_SIGNATURE_SIZE))) {
+			return sl_false;
+		}
+		sl_uint32 n4 = MIO::readUint32LE(data + 8);
+		sl_uint32 n6 = MIO::readUint32LE(data + 12);
+		sl_uint32 nCodes = MIO::readUint32LE(data + 16);
+		if (n4 >= 0x80000000 || n6 >= 0x80000000 || nCodes > INDEX_MAX_CODE_COUNT) {
+			return sl_false;
+		}
+		sl_uint64 sizes[SectionCount];
+		sl_uint64 offsets[SectionCount];
+		GetSectionSizes(sizes, n4, n6, nCodes);
+		for (sl_uint32 i = 0; i < SectionCount; i++) {
+			offsets[i] = MIO::readUint64LE(data + 24 + (i << 3));
+			if (offsets[i] < INDEX_HEADER_SIZE || offsets[i] > size || sizes[i] > size - offsets[i] || (offsets[i] & 7)) {
+				return sl_false;
+			}
+		}
+		const sl_uint16* codes4 = (const sl_uint16*)(data + offsets[SectionIPv4Codes]);
+		for (sl_uint32 k = 1; k <= n4; k++) {
+			if (codes4[k] >= nCodes) {
+				return sl_false;
+			}
+		}
+		const sl_uint16* codes6 = (const sl_uint16*)(data + offsets[SectionIPv6Codes]);
+		for (sl_uint32 k = 1; k <= n6; k++) {
+			if (codes6[k] >= nCodes) {
+				return sl_false;
+			}
+		}
+		clearAll();
+		m_index = index;
+		m_indexCodes = (const char(*)[4])(data + offsets[SectionCodes]);
+		m_indexCountIPv4 = n4;
+		m_indexIPv4Starts = (const sl_uint32*)(data + offsets[SectionIPv4Starts]);
+		m_indexIPv4Ends = (const sl_uint32*)(data + offsets[SectionIPv4Ends]);
+		m_indexIPv4Codes = codes4;
+		m_indexCountIPv6 = n6;
+		m_indexIPv6Starts = (const IPv6Key*)(data + offsets[SectionIPv6Starts]);
+		m_indexIPv6Ends = (const IPv6Key*)(data + offsets[SectionIPv6Ends]);
+		m_indexIPv6Codes = codes6;
+		return sl_true;
+	}
+
+	sl_bool DbIp::isIndexLoaded()
+	{
+		return m_index.isNotNull();
+	}
+
 	void DbIp::clearAll()
 	{
 		m_ipv4 = sl_null;
@@ -199,13 +550,33 @@ namespace slib
 		m_ipv6 = sl_null;
 		m_countIPv6 = 0;
 		m_listIPv6.setNull();
+
+		m_index.setNull();
+		m_indexCodes = sl_null;
+		m_indexCountIPv4 = 0;
+		m_indexIPv4Starts = sl_null;
+		m_indexIPv4Ends = sl_null;
+		m_indexIPv4Codes = sl_null;
+		m_indexCountIPv6 = 0;
+		m_indexIPv6Starts = sl_null;
+		m_indexIPv6Ends = sl_null;
+		m_indexIPv6Codes = sl_null;
 	}
 
 
 	const char* DbIp::getCountryCode(const IPv4Address& _ipv4, sl_size depth)
 	{
-		sl_size index = 0;
 		sl_uint32 ipv4 = _ipv4.toInt();
+		if (m_index.isNotNull()) {
+			sl_uint32 n = m_indexCountIPv4;
+			sl_uint32 k = SearchIPv4(m_indexIPv4Starts, n, ipv4);
+			k = MatchIPv4(m_indexIPv4Starts, m_indexIPv4Ends, n, k, ipv4, depth);
+			if (k) {
+				return m_indexCodes[m_indexIPv4Codes[k]];
+			}
+			return sl_null;
+		}
+		sl_size index = 0;
 		if (BinarySearch::search(m_ipv4, m_countIPv4, ipv4, &index)) {
 			return m_ipv4[index].code;
 		} else {
@@ -221,10 +592,67 @@ namespace slib
 		return sl_null;
 	}
 
+	void DbIp::getCountryCodes(const char** outCodes, const IPv4Address* addresses, sl_size count, sl_size depth)
+	{
+		if (m_index.isNull()) {
+			for (sl_size i = 0; i < count; i++) {
+				outCodes[i] = getCountryCode(addresses[i], depth);
+			}
+			return;
+		}
+		sl_uint32 n = m_indexCountIPv4;
+		const sl_uint32* starts = m_indexIPv4Starts;
+		sl_uint32 keys[BATCH_SIZE];
+		sl_uint32 nodes[BATCH_SIZE];
+		while (count) {
+			sl_uint32 m = (sl_uint32)(Math::min(count, (sl_size)BATCH_SIZE));
+			sl_uint32 i;
+			for (i = 0; i < m; i++) {
+				keys[i] = addresses[i].toInt();
+				nodes[i] = 1;
+			}
+			// Independent searches advance together, so that their memory loads overlap
+			sl_bool flagContinue = sl_true;
+			while (flagContinue) {
+				flagContinue = sl_false;
+				for (i = 0; i < m; i++) {
+					sl_uint32 k = nodes[i];
+					if (k <= n) {
+						nodes[i] = (k << 1) | (sl_uint32)(starts[k] <= keys[i]);
+						flagContinue = sl_true;
+					}
+				}
+			}
+			for (i = 0; i < m; i++) {
+				sl_uint32 k = MatchIPv4(starts, m_indexIPv4Ends, n, GetSearchResult(nodes[i]), keys[i], depth);
+				outCodes[i] = k ? m_indexCodes[m_indexIPv4Codes[k]] : sl_null;
+			}
+			outCodes += m;
+			addresses += m;
+			count -= m;
+		}
+	}
+
 	List<DbIp::IPv4Item> DbIp::getIPv4Items(const StringParam& _code)
 	{
 		List<IPv4Item> ret;
 		String code = _code.toString();
+		if (m_index.isNotNull()) {
+			for (sl_uint32 k = 1; k <= m_indexCountIPv4; k++) {
+				const char* itemCode = m_indexCodes[m_indexIPv4Codes[k]];
+				if (code.equals(itemCode)) {
+					IPv4Item item;
+					item.start = m_indexIPv4Starts[k];
+					item.end = m_indexIPv4Ends[k];
+					Base::copyMemory(item.code, itemCode, 4);
+					ret.add_NoLock(item);
+				}
+			}
+			ret.sort_NoLock([](const IPv4Item& a, const IPv4Item& b) {
+				return Compare<sl_uint32>()(a.start, b.start);
+			});
+			return ret;
+		}
 		for (auto&& item : m_listIPv4) {
 			if (code.equals(item.code)) {
 				ret.add_NoLock(item);
@@ -245,6 +673,17 @@ namespace slib
 
 	const char* DbIp::getCountryCode(const IPv6Address& ipv6, sl_size depth)
 	{
+		if (m_index.isNotNull()) {
+			sl_uint64 high = MIO::readUint64BE(ipv6.m);
+			sl_uint64 low = MIO::readUint64BE(ipv6.m + 8);
+			sl_uint32 n = m_indexCountIPv6;
+			sl_uint32 k = SearchIPv6(m_indexIPv6Starts, n, high, low);
+			k = MatchIPv6(m_indexIPv6Starts, m_indexIPv6Ends, n, k, high, low, depth);
+			if (k) {
+				return m_indexCodes[m_indexIPv6Codes[k]];
+			}
+			return sl_null;
+		}
 		sl_size index = 0;
 		if (BinarySearch::search(m_ipv6, m_countIPv6, ipv6, &index)) {
 			return m_ipv6[index].code;
@@ -261,10 +700,69 @@ namespace slib
 		return sl_null;
 	}
 
+	void DbIp::getCountryCodes(const char** outCodes, const IPv6Address* addresses, sl_size count, sl_size depth)
+	{
+		if (m_index.isNull()) {
+			for (sl_size i = 0; i < count; i++) {
+				outCodes[i] = getCountryCode(addresses[i], depth);
+			}
+			return;
+		}
+		sl_uint32 n = m_indexCountIPv6;
+		const IPv6Key* starts = m_indexIPv6Starts;
+		IPv6Key keys[BATCH_SIZE];
+		sl_uint32 nodes[BATCH_SIZE];
+		while (count) {
+			sl_uint32 m = (sl_uint32)(Math::min(count, (sl_size)BATCH_SIZE));
+			sl_uint32 i;
+			for (i = 0; i < m; i++) {
+				keys[i].high = MIO::readUint64BE(addresses[i].m);
+				keys[i].low = MIO::readUint64BE(addresses[i].m + 8);
+				nodes[i] = 1;
+			}
+			sl_bool flagContinue = sl_true;
+			while (flagContinue) {
+				flagContinue = sl_false;
+				for (i = 0; i < m; i++) {
+					sl_uint32 k = nodes[i];
+					if (k <= n) {
+						nodes[i] = (k << 1) | (sl_uint32)(IsLessThanOrEqual(starts[k], keys[i].high, keys[i].low));
+						flagContinue = sl_true;
+					}
+				}
+			}
+			for (i = 0; i < m; i++) {
+				sl_uint32 k = MatchIPv6(starts, m_indexIPv6Ends, n, GetSearchResult(nodes[i]), keys[i].high, keys[i].low, depth);
+				outCodes[i] = k ? m_indexCodes[m_indexIPv6Codes[k]] : sl_null;
+			}
+			outCodes += m;
+			addresses += m;
+			count -= m;
+		}
+	}
+
 	List<DbIp::IPv6Item> DbIp::getIPv6Items(const StringParam& _code)
 	{
 		List<IPv6Item> ret;
 		String code = _code.toString();
+		if (m_index.isNotNull()) {
+			for (sl_uint32 k = 1; k <= m_indexCountIPv6; k++) {
+				const char* itemCode = m_indexCodes[m_indexIPv6Codes[k]];
+				if (code.equals(itemCode)) {
+					IPv6Item item;
+					MIO::writeUint64BE(item.start.m, m_indexIPv6Starts[k].high);
+					MIO::writeUint64BE(item.start.m + 8, m_indexIPv6Starts[k].low);
+					MIO::writeUint64BE(item.end.m, m_indexIPv6Ends[k].high);
+					MIO::writeUint64BE(item.end.m + 8, m_indexIPv6Ends[k].low);
+					Base::copyMemory(item.code, itemCode, 4);
+					ret.add_NoLock(item);
+				}
+			}
+			ret.sort_NoLock([](const IPv6Item& a, const IPv6Item& b) {
+				return Compare<IPv6Address>()(a.start, b.start);
+			});
+			return ret;
+		}
 		for (auto&& item : m_listIPv6) {
 			if (code.equals(item.code)) {
 				ret.add_NoLock(item);
@@ -32,10 +32,14 @@ For example,
 
    211.106.66.5 => CN
 
+The parsed database can be compiled into a binary index file (`compileIndex`), which is mapped into the memory by `openIndex` instead of parsing the CSV file at every startup.
+The range starts are stored in the Eytzinger (BFS) order so that a lookup touches a few cache lines, and the country codes are stored in a separate table.
+
 *************************************************/
 
 #include <slib/network/ip_address.h>
 #include <slib/core/list.h>
+#include <slib/core/memory.h>
 
 namespace slib
 {
@@ -69,6 +73,19 @@ namespace slib
 		// Not thread safe
 		sl_bool parseFile(const StringParam& pathToCSVFile);
 
+		// Writes the binary index of the parsed items
+		sl_bool compileIndex(const StringParam& pathToIndexFile);
+
+		static sl_bool compileIndex(const StringParam& pathToCSVFile, const StringParam& pathToIndexFile);
+
+		// Not thread safe. Maps the index file into the memory, shared with the other processes opening the same file
+		sl_bool openIndex(const StringParam& pathToIndexFile);
+
+		// Not thread safe. `index` should be kept during the use
+		sl_bool loadIndex(const Memory& index);
+
+		sl_bool isIndexLoaded();
+
 		void clearAll();
 
 	public:
@@ -77,6 +94,11 @@ namespace slib
 
 		const char* getCountryCode(const IPv6Address& ipv6, sl_size depth = 1);
 
+		// Batch lookup, interleaving the searches of the addresses when the index is loaded
+		void getCountryCodes(const char** outCodes, const IPv4Address* addresses, sl_size count, sl_size depth = 1);
+
+		void getCountryCodes(const char** outCodes, const IPv6Address* addresses, sl_size count, sl_size depth = 1);
+
 		List<IPv4Item> getIPv4Items(const StringParam& code);
 
 		List<IPv6Item> getIPv6Items(const StringParam& code);
@@ -90,6 +112,24 @@ namespace slib
 		IPv6Item* m_ipv6;
 		sl_uint32 m_countIPv6;
 
+		struct IPv6Key
+		{
+			sl_uint64 high;
+			sl_uint64 low;
+		};
+
+		// Arrays of the index are 1-based in the Eytzinger order
+		Memory m_index;
+		const char (*m_indexCodes)[4];
+		sl_uint32 m_indexCountIPv4;
+		const sl_uint32* m_indexIPv4Starts;
+		const sl_uint32* m_indexIPv4Ends;
+		const sl_uint16* m_indexIPv4Codes;
+		sl_uint32 m_indexCountIPv6;
+		const IPv6Key* m_indexIPv6Starts;
+		const IPv6Key* m_indexIPv6Ends;
+		const sl_uint16* m_indexIPv6Codes;
+
 	};
 
 }
@@ -0,0 +1,462 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_COROUTINE
+#define CHECKHEADER_SLIB_CORE_COROUTINE
+
+#include "promise.h"
+#include "memory_pool.h"
+
+/*
+	C++20 coroutine support (enabled when the application is compiled with coroutines).
+
+	`Task<T>` is a lazily started coroutine. Awaiting a task starts it and resumes the awaiting coroutine by symmetric transfer when it finishes.
+	Frames are allocated from `MemoryPool`.
+	Awaiters resume the coroutine inline on the thread which completes the operation (for example, the `AsyncIoLoop` thread), without extra dispatch.
+*/
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#	if __has_include(<coroutine>)
+#		define SLIB_SUPPORT_COROUTINE
+#	endif
+#endif
+
+#ifdef SLIB_SUPPORT_COROUTINE
+
+#include <coroutine>
+#include <exception>
+
+namespace slib
+{
+
+	template <class T = void>
+	class Task;
+
+	class SLIB_EXPORT Coroutine
+	{
+	public:
+		static void* allocateFrame(sl_size size) noexcept
+		{
+			if (size <= SLIB_MEMORY_POOL_MAX_SIZE) {
+				return MemoryPool::allocate(size);
+			}
+			return Base::createMemory(size);
+		}
+
+		static void freeFrame(void* ptr, sl_size size) noexcept
+		{
+			if (size <= SLIB_MEMORY_POOL_MAX_SIZE) {
+				MemoryPool::free(ptr, size);
+			} else {
+				Base::freeMemory(ptr);
+			}
+		}
+
+	public:
+		class ResumeOnAwaiter
+		{
+		public:
+			Ref<Dispatcher> dispatcher;
+			sl_uint64 delayMillis;
+
+		public:
+			sl_bool await_ready() const noexcept
+			{
+				return sl_false;
+			}
+
+			sl_bool await_suspend(std::coroutine_handle<> handle) noexcept
+			{
+				Function<void()> callback = [handle]() {
+					handle.resume();
+				};
+				if (delayMillis) {
+					return Dispatch::setTimeout(dispatcher, callback, delayMillis);
+				} else {
+					return Dispatch::dispatch(dispatcher, callback);
+				}
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+
+		};
+
+		// continues the coroutine on `dispatcher` (default dispatch loop when `dispatcher` is null)
+		static ResumeOnAwaiter resumeOn(const Ref<Dispatcher>& dispatcher) noexcept
+		{
+			return ResumeOnAwaiter{dispatcher, 0};
+		}
+
+		// continues the coroutine on `dispatcher` (default dispatch loop when `dispatcher` is null) after `delayMillis`
+		static ResumeOnAwaiter sleep(const Ref<Dispatcher>& dispatcher, sl_uint64 delayMillis) noexcept
+		{
+			return ResumeOnAwaiter{dispatcher, delayMillis};
+		}
+
+		static ResumeOnAwaiter sleep(sl_uint64 delayMillis) noexcept
+		{
+			return ResumeOnAwaiter{sl_null, delayMillis};
+		}
+
+		// starts `task` without waiting, and resolves the returned promise with the result of `task`
+		template <class T>
+		static Promise<T> toPromise(Task<T>&& task);
+
+		static Promise<sl_bool> toPromise(Task<void>&& task);
+
+	};
+
+	namespace priv
+	{
+		namespace coroutine
+		{
+
+			class FinalAwaiter
+			{
+			public:
+				sl_bool await_ready() const noexcept
+				{
+					return sl_false;
+				}
+
+				template <class PROMISE>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE> handle) noexcept
+				{
+					PROMISE& promise = handle.promise();
+					std::coroutine_handle<> continuation = promise.continuation;
+					if (continuation) {
+						return continuation;
+					}
+					if (promise.flagDetached) {
+						handle.destroy();
+					}
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept
+				{
+				}
+
+			};
+
+			class TaskPromiseBase
+			{
+			public:
+				std::coroutine_handle<> continuation;
+				sl_bool flagDetached = sl_false;
+
+			public:
+				static void* operator new(std::size_t size) noexcept
+				{
+					return Coroutine::allocateFrame(size);
+				}
+
+				static void operator delete(void* ptr, std::size_t size) noexcept
+				{
+					Coroutine::freeFrame(ptr, size);
+				}
+
+				std::suspend_always initial_suspend() const noexcept
+				{
+					return {};
+				}
+
+				FinalAwaiter final_suspend() const noexcept
+				{
+					return {};
+				}
+
+				void unhandled_exception() const noexcept
+				{
+					std::terminate();
+				}
+
+			};
+
+			template <class T>
+			class TaskPromise : public TaskPromiseBase
+			{
+			public:
+				sl_bool flagResult = sl_false;
+				alignas(T) sl_uint8 result[sizeof(T)];
+
+			public:
+				~TaskPromise()
+				{
+					if (flagResult) {
+						((T*)((void*)result))->T::~T();
+					}
+				}
+
+			public:
+				Task<T> get_return_object() noexcept;
+
+				static Task<T> get_return_object_on_allocation_failure() noexcept;
+
+				template <class VALUE>
+				void return_value(VALUE&& value)
+				{
+					new ((T*)((void*)result)) T(Forward<VALUE>(value));
+					flagResult = sl_true;
+				}
+
+				T& getResult() noexcept
+				{
+					return *((T*)((void*)result));
+				}
+
+			};
+
+			template <>
+			class TaskPromise<void> : public TaskPromiseBase
+			{
+			public:
+				Task<void> get_return_object() noexcept;
+
+				static Task<void> get_return_object_on_allocation_failure() noexcept;
+
+				void return_void() const noexcept
+				{
+				}
+
+				void getResult() const noexcept
+				{
+				}
+
+			};
+
+		}
+	}
+
+	template <class T>
+	class SLIB_EXPORT Task
+	{
+	public:
+		typedef priv::coroutine::TaskPromise<T> promise_type;
+		typedef std::coroutine_handle<promise_type> Handle;
+
+	public:
+		Task() noexcept {}
+
+		Task(Handle handle) noexcept: m_handle(handle) {}
+
+		Task(const Task& other) = delete;
+
+		Task(Task&& other) noexcept: m_handle(other.m_handle)
+		{
+			other.m_handle = sl_null;
+		}
+
+		~Task()
+		{
+			if (m_handle) {
+				m_handle.destroy();
+			}
+		}
+
+	public:
+		Task& operator=(const Task& other) = delete;
+
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other) {
+				if (m_handle) {
+					m_handle.destroy();
+				}
+				m_handle = other.m_handle;
+				other.m_handle = sl_null;
+			}
+			return *this;
+		}
+
+	public:
+		sl_bool isNull() const noexcept
+		{
+			return !m_handle;
+		}
+
+		sl_bool isNotNull() const noexcept
+		{
+			return m_handle != sl_null;
+		}
+
+		sl_bool isDone() const noexcept
+		{
+			return !m_handle || m_handle.done();
+		}
+
+		// runs the task until its first suspension, and releases the ownership. The frame is freed when the task finishes
+		void start() noexcept
+		{
+			Handle handle = m_handle;
+			if (handle) {
+				m_handle = sl_null;
+				handle.promise().flagDetached = sl_true;
+				handle.resume();
+			}
+		}
+
+	public:
+		class Awaiter
+		{
+		public:
+			Handle handle;
+
+		public:
+			sl_bool await_ready() const noexcept
+			{
+				return !handle || handle.done();
+			}
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+			{
+				handle.promise().continuation = continuation;
+				return handle;
+			}
+
+			T await_resume() noexcept
+			{
+				if constexpr (!(std::is_void<T>::value)) {
+					if (handle && handle.promise().flagResult) {
+						return Move(handle.promise().getResult());
+					}
+					// failed to allocate the frame
+					return T();
+				}
+			}
+
+		};
+
+		Awaiter operator co_await() && noexcept
+		{
+			return Awaiter{m_handle};
+		}
+
+		Awaiter operator co_await() & noexcept
+		{
+			return Awaiter{m_handle};
+		}
+
+	private:
+		Handle m_handle;
+
+	};
+
+	namespace priv
+	{
+		namespace coroutine
+		{
+
+			template <class T>
+			SLIB_INLINE Task<T> TaskPromise<T>::get_return_object() noexcept
+			{
+				return Task<T>(std::coroutine_handle< TaskPromise<T> >::from_promise(*this));
+			}
+
+			template <class T>
+			SLIB_INLINE Task<T> TaskPromise<T>::get_return_object_on_allocation_failure() noexcept
+			{
+				return Task<T>();
+			}
+
+			SLIB_INLINE Task<void> TaskPromise<void>::get_return_object() noexcept
+			{
+				return Task<void>(std::coroutine_handle< TaskPromise<void> >::from_promise(*this));
+			}
+
+			SLIB_INLINE Task<void> TaskPromise<void>::get_return_object_on_allocation_failure() noexcept
+			{
+				return Task<void>();
+			}
+
+			template <class T>
+			static Task<void> RunTaskToPromise(Task<T> task, Promise<T> promise)
+			{
+				promise.resolve(co_await Move(task));
+			}
+
+			static Task<void> RunVoidTaskToPromise(Task<void> task, Promise<sl_bool> promise)
+			{
+				co_await Move(task);
+				promise.resolve(sl_true);
+			}
+
+			template <class T>
+			class PromiseAwaiter
+			{
+			public:
+				Promise<T> promise;
+				T result{};
+
+			public:
+				sl_bool await_ready() const noexcept
+				{
+					return promise.isNull();
+				}
+
+				void await_suspend(std::coroutine_handle<> handle)
+				{
+					promise.then([this, handle](T& value) {
+						result = Move(value);
+						handle.resume();
+					});
+				}
+
+				T await_resume()
+				{
+					return Move(result);
+				}
+
+			};
+
+		}
+	}
+
+	template <class T>
+	Promise<T> Coroutine::toPromise(Task<T>&& task)
+	{
+		Promise<T> promise = Promise<T>::create();
+		priv::coroutine::RunTaskToPromise(Move(task), promise).start();
+		return promise;
+	}
+
+	SLIB_INLINE Promise<sl_bool> Coroutine::toPromise(Task<void>&& task)
+	{
+		Promise<sl_bool> promise = Promise<sl_bool>::create();
+		priv::coroutine::RunVoidTaskToPromise(Move(task), promise).start();
+		return promise;
+	}
+
+	// resumes the awaiting coroutine on the thread which resolves `promise`
+	template <class T>
+	SLIB_INLINE priv::coroutine::PromiseAwaiter<T> operator co_await(const Promise<T>& promise) noexcept
+	{
+		return priv::coroutine::PromiseAwaiter<T>{promise};
+	}
+
+}
+
+#endif
+
+#endif
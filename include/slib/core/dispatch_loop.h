@@ -26,6 +26,7 @@
 #include "dispatch.h"
 #include "thread_service.h"
 #include "time_counter.h"
+#include "timing_wheel.h"
 #include "map.h"
 #include "queue.h"
 
@@ -67,33 +68,12 @@ namespace slib
 
 		LinkedQueue< Function<void()> > m_queueTasks;
 
-		struct TimeTask
-		{
-			sl_uint64 time;
-			Function<void()> task;
-		};
-		CMap<sl_uint64, TimeTask> m_timeTasks;
-
-		class TimerTask
-		{
-		public:
-			TimerTask();
-
-			SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(TimerTask)
-
-		public:
-			WeakRef<Timer> timer;
-
-		public:
-			sl_bool operator==(const TimerTask& other) const noexcept;
-		};
-		LinkedQueue<TimerTask> m_queueTimers;
+		// delayed tasks and timers
+		TimingWheel m_timers;
 
 	protected:
 		void _wake();
 		sl_int32 _getTimeout();
-		sl_int32 _getTimeout_TimeTasks();
-		sl_int32 _getTimeout_Timer();
 		void _runLoop();
 
 	};
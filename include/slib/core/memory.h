@@ -150,6 +150,11 @@ namespace slib
 
 		static Memory createNoCopy(const void* buf, sl_size size) noexcept;
 
+		// allocates from `MemoryPool` (falls back to `create()` for sizes out of the pooled range)
+		static Memory createPooled(sl_size size) noexcept;
+
+		static Memory createPooled(const void* buf, sl_size size) noexcept;
+
 		static Memory createStatic(const void* buf, sl_size size) noexcept;
 
 		template <class T>
@@ -0,0 +1,79 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MEMORY_POOL
+#define CHECKHEADER_SLIB_CORE_MEMORY_POOL
+
+#include "definition.h"
+
+/*
+	Size-class pool for buffers between 64 bytes and 1 megabytes.
+	Each thread keeps a small cache of free blocks per size class, and exchanges them with the shared lists in batches.
+*/
+
+#define SLIB_MEMORY_POOL_MIN_SIZE 64
+#define SLIB_MEMORY_POOL_MAX_SIZE 0x100000
+#define SLIB_MEMORY_POOL_SIZE_CLASS_COUNT 15
+
+namespace slib
+{
+
+	class SLIB_EXPORT MemoryPoolStatistics
+	{
+	public:
+		sl_size blockSize;
+		sl_uint64 hitCount; // allocations served from the cached blocks
+		sl_uint64 missCount; // allocations passed to the system allocator
+		sl_size cachedCount; // free blocks in the shared list
+
+	public:
+		MemoryPoolStatistics() noexcept;
+
+	};
+
+	class SLIB_EXPORT MemoryPool
+	{
+	public:
+		// returns `sl_null` when `size` is zero or larger than `SLIB_MEMORY_POOL_MAX_SIZE`
+		static void* allocate(sl_size size) noexcept;
+
+		// `size` must be the size passed to `allocate()`
+		static void free(void* ptr, sl_size size) noexcept;
+
+		// returns -1 when `size` is out of the pooled range
+		static sl_int32 getSizeClass(sl_size size) noexcept;
+
+		static sl_size getBlockSize(sl_uint32 sizeClass) noexcept;
+
+		static void getStatistics(sl_uint32 sizeClass, MemoryPoolStatistics& _out) noexcept;
+
+		// returns the blocks cached by the calling thread to the shared lists
+		static void flushThreadCache() noexcept;
+
+		// frees the blocks in the shared lists
+		static void trim() noexcept;
+
+	};
+
+}
+
+#endif
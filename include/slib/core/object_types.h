@@ -48,6 +48,7 @@ namespace slib
 			Application,
 			CTimeZone,
 			GenericTimeZone,
+			ZoneInfoTimeZone,
 			Timer,
 			Dispatcher,
 			DispatchLoop,
@@ -959,7 +959,7 @@ namespace slib
 
 	private:
 		Container* m_container;
-		SpinLock m_lock;
+		EpochLock m_lock;
 
 	public:
 		/**
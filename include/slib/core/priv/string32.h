@@ -960,7 +960,7 @@ namespace slib
 
 	private:
 		Container* m_container;
-		SpinLock m_lock;
+		EpochLock m_lock;
 
 	public:
 		/**
@@ -973,7 +973,7 @@ namespace slib
 
 	private:
 		Container* m_container;
-		SpinLock m_lock;
+		EpochLock m_lock;
 
 	public:
 		/**
@@ -108,8 +108,8 @@ public: \
 
 #define SLIB_REF_WRAPPER_OP(WRAPPER, ...) \
 	SLIB_REF_WRAPPER_NO_ATOMIC_OP(WRAPPER, __VA_ARGS__) \
-	SLIB_CONSTEXPR sl_bool equals(const Atomic<WRAPPER>& other) const { return ref.equals(*(reinterpret_cast<const AtomicRef<__VA_ARGS__>*>(&other))); } \
-	SLIB_CONSTEXPR sl_compare_result compare(const Atomic<WRAPPER>& other) const { return ref.compare(*(reinterpret_cast<const AtomicRef<__VA_ARGS__>*>(&other))); }
+	sl_bool equals(const Atomic<WRAPPER>& other) const { return ref.equals(*(reinterpret_cast<const AtomicRef<__VA_ARGS__>*>(&other))); } \
+	sl_compare_result compare(const Atomic<WRAPPER>& other) const { return ref.compare(*(reinterpret_cast<const AtomicRef<__VA_ARGS__>*>(&other))); }
 
 #define SLIB_REF_WRAPPER_NO_ATOMIC(WRAPPER, ...) \
 	SLIB_REF_WRAPPER_NO_ATOMIC_NO_OP(WRAPPER, __VA_ARGS__) \
@@ -885,12 +885,12 @@ namespace slib
 			if (!_ptr) {
 				return sl_null;
 			}
-			m_lock.lock();
+			sl_int32 ticket = m_lock.enter();
 			T* o = _ptr;
 			if (o) {
 				o->increaseReference_NoSync();
 			}
-			m_lock.unlock();
+			m_lock.leave(ticket);
 			return o;
 		}
 
@@ -899,6 +899,9 @@ namespace slib
 			m_lock.lock();
 			T* before = _ptr;
 			_ptr = other;
+			if (before) {
+				m_lock.synchronize();
+			}
 			m_lock.unlock();
 			if (before) {
 				before->decreaseReference();
@@ -923,6 +926,9 @@ namespace slib
 			m_lock.lock();
 			T* before = _ptr;
 			_ptr = sl_null;
+			if (before) {
+				m_lock.synchronize();
+			}
 			m_lock.unlock();
 			return before;
 		}
@@ -932,6 +938,9 @@ namespace slib
 			m_lock.lock();
 			T* before = _ptr;
 			_ptr = *other;
+			if (before) {
+				m_lock.synchronize();
+			}
 			*other = before;
 			m_lock.unlock();
 		}
@@ -940,7 +949,7 @@ namespace slib
 		T* _ptr;
 
 	private:
-		SpinLock m_lock;
+		EpochLock m_lock;
 
 	};
 
@@ -41,7 +41,9 @@ namespace slib
 		Extended = 0x0040,
 		Awk = 0x0080,
 		Grep = 0x0100,
-		Egrep = 0x0200
+		Egrep = 0x0200,
+		// uses `std::regex` instead of the native engine. The native engine supports ECMAScript syntax without backreferences and lookarounds, and falls back to `std::regex` for the others
+		StdRegex = 0x1000
 	})
 
 	SLIB_DEFINE_FLAGS(RegularExpressionMatchFlags, {
@@ -71,8 +73,12 @@ namespace slib
 		RegularExpression(const StringParam& pattern, const RegularExpressionFlags& flags) noexcept;
 
 	public:
+		// returns `true` when the whole `str` matches
 		sl_bool match(const StringParam& str, const RegularExpressionMatchFlags& flags = RegularExpressionMatchFlags::Default) noexcept;
 
+		// returns `true` when a part of `str` matches
+		sl_bool search(const StringParam& str, const RegularExpressionMatchFlags& flags = RegularExpressionMatchFlags::Default) noexcept;
+
 		static sl_bool matchEmail(const StringParam& str) noexcept;
 
 	};
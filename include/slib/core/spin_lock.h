@@ -85,6 +85,40 @@ namespace slib
 
 	};
 
+	/*
+		Guards a pointer which is read much more often than it is written.
+		Readers wait only while a writer advances the epoch: they are counted in the current epoch while retaining the pointed object.
+		Writers are serialized by `lock()`, and after publishing a new pointer, `synchronize()` advances the epoch and waits until the readers of the previous epoch leave.
+	*/
+	class SLIB_EXPORT EpochLock
+	{
+	public:
+		SLIB_CONSTEXPR EpochLock(): m_state(0) {}
+
+		SLIB_CONSTEXPR EpochLock(const EpochLock&): m_state(0) {}
+
+	public:
+		// returns the ticket to be passed to `leave()`
+		sl_int32 enter() const noexcept;
+
+		void leave(sl_int32 ticket) const noexcept;
+
+		void lock() const noexcept;
+
+		void unlock() const noexcept;
+
+		// call while locked, after publishing the new pointer
+		void synchronize() const noexcept;
+
+	public:
+		EpochLock& operator=(const EpochLock& other) noexcept;
+
+	private:
+		SLIB_ALIGN(8) sl_int64 m_state;
+		SpinLock m_lockWriting;
+
+	};
+
 #define SLIB_SPINLOCK_POOL_SIZE 971
 
 	template <int CATEGORY>
@@ -152,6 +152,9 @@ namespace slib
 	public:
 		static Time now() noexcept;
 
+		// resolution of the kernel tick (several milliseconds), without the cost of precise clock
+		static Time nowCoarse() noexcept;
+
 		static Time withMicroseconds(sl_int64 s) noexcept;
 
 		static Time withMicrosecondsF(double s) noexcept;
@@ -621,6 +624,8 @@ namespace slib
 
 		void _setNow() noexcept;
 
+		void _setNowCoarse() noexcept;
+
 		sl_bool _setToSystem() const noexcept;
 
 		// helper functions
@@ -630,6 +635,18 @@ namespace slib
 
 	};
 
+	// Text of the current time, formatted once per second for the log lines and HTTP headers
+	class SLIB_EXPORT CachedTimeText
+	{
+	public:
+		// same as `Time::now().toString()`
+		static String getLocalString() noexcept;
+
+		// same as `Time::now().toHttpDate()`
+		static String getHttpDate() noexcept;
+
+	};
+
 }
 
 #endif
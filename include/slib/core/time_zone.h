@@ -23,7 +23,9 @@
 #ifndef CHECKHEADER_SLIB_CORE_TIME_ZONE
 #define CHECKHEADER_SLIB_CORE_TIME_ZONE
 
-#include "ref.h"
+#include "time.h"
+#include "string.h"
+#include "memory.h"
 
 namespace slib
 {
@@ -65,6 +67,89 @@ namespace slib
 
 	};
 
+	// POSIX TZ rule, such as `EST5EDT,M3.2.0,M11.1.0`
+	class SLIB_EXPORT ZoneInfoRule
+	{
+	public:
+		class Transition
+		{
+		public:
+			sl_uint8 type; // 'J': Julian day (1~365, not counting February 29), 'N': zero-based day (0~365), 'M': `Mm.w.d`
+			sl_uint8 month;
+			sl_uint8 week; // 5 means the last week
+			sl_uint8 dayOfWeek;
+			sl_uint16 day;
+			sl_int32 time; // local time in seconds, may be negative or over 24 hours
+		};
+
+		// in seconds, east of UTC
+		sl_int32 offsetStandard;
+		sl_int32 offsetDaylight;
+		sl_bool flagDaylight;
+		Transition start; // in local standard time
+		Transition end; // in local daylight time
+
+	public:
+		ZoneInfoRule() noexcept;
+
+	public:
+		sl_bool parse(const StringView& str) noexcept;
+
+		// `seconds`: seconds since epoch (UTC)
+		sl_int32 getOffset(sl_int64 seconds) const noexcept;
+
+	};
+
+	// Time zone parsed from TZif data (IANA time zone database). The offsets are looked up without locking
+	class SLIB_EXPORT ZoneInfoTimeZone : public CTimeZone
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		ZoneInfoTimeZone();
+
+		~ZoneInfoTimeZone();
+
+	public:
+		static Ref<ZoneInfoTimeZone> loadFromMemory(const void* data, sl_size size);
+
+		static Ref<ZoneInfoTimeZone> loadFromFile(const StringParam& path);
+
+		// `name`: IANA time zone name, such as `Asia/Seoul`
+		static Ref<ZoneInfoTimeZone> load(const StringParam& name);
+
+		// `rule`: POSIX TZ rule
+		static Ref<ZoneInfoTimeZone> createFromRule(const StringParam& rule);
+
+		// zone of `TZ` environment variable or `/etc/localtime`. Reloaded when `TZ` or `/etc/localtime` is changed, which is checked at most once per second. Null when not available
+		static Ref<ZoneInfoTimeZone> getLocal() noexcept;
+
+	public:
+		using CTimeZone::getOffset;
+
+		sl_int64 getOffset(const Time& time) override;
+
+		// `seconds`: seconds since epoch (UTC)
+		sl_int32 getOffsetAt(sl_int64 seconds) noexcept;
+
+		// `localSeconds`: local civil time counted as seconds since epoch
+		sl_int32 getOffsetForLocal(sl_int64 localSeconds) noexcept;
+
+		sl_size getTransitionCount() noexcept;
+
+		const ZoneInfoRule* getRule() noexcept;
+
+	protected:
+		Memory m_memTransitions;
+		const sl_int64* m_transitionTimes;
+		const sl_int32* m_transitionOffsets;
+		sl_size m_nTransitions;
+		sl_int32 m_offsetInitial;
+		sl_bool m_flagRule;
+		ZoneInfoRule m_rule;
+
+	};
+
 	class TimeZone;
 	template <> class Atomic<TimeZone>;
 
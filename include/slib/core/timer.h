@@ -100,6 +100,10 @@ namespace slib
 
 		sl_bool m_flagDispatched;
 
+		sl_uint64 m_idLoopEntry; // entry in the timing wheel of `m_loop`
+
+		friend class DispatchLoop;
+
 	};
 
 }
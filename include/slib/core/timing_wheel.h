@@ -0,0 +1,108 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_TIMING_WHEEL
+#define CHECKHEADER_SLIB_CORE_TIMING_WHEEL
+
+#include "lockable.h"
+#include "function.h"
+
+namespace slib
+{
+
+	/*
+		Hierarchical timing wheel (4 levels of 256 slots).
+		Adding, rescheduling and removing an entry is O(1), and `advance` costs O(number of expired entries) plus cascading.
+		Expired entries run in the order of their deadlines (in ticks), and the entries of the same tick run in the order of their linking.
+		Times are in milliseconds on a caller-defined monotonic clock.
+	*/
+	class SLIB_EXPORT TimingWheel : public Lockable
+	{
+	public:
+		TimingWheel(sl_uint64 now = 0, sl_uint32 tickMillis = 1);
+
+		~TimingWheel();
+
+	public:
+		// returns the identifier of the entry (0 on failure)
+		sl_uint64 add(sl_uint64 expireTime, const Function<void()>& task);
+
+		sl_uint64 add_NoLock(sl_uint64 expireTime, const Function<void()>& task);
+
+		// `check` is called when the deadline passes, and returns the next deadline to keep the entry, or 0 to remove it
+		sl_uint64 addDeadline(sl_uint64 expireTime, const Function<sl_uint64(sl_uint64 now)>& check);
+
+		sl_uint64 addDeadline_NoLock(sl_uint64 expireTime, const Function<sl_uint64(sl_uint64 now)>& check);
+
+		sl_bool reschedule(sl_uint64 id, sl_uint64 expireTime);
+
+		sl_bool reschedule_NoLock(sl_uint64 id, sl_uint64 expireTime);
+
+		sl_bool remove(sl_uint64 id);
+
+		sl_bool remove_NoLock(sl_uint64 id);
+
+		void removeAll();
+
+		// runs the expired entries (outside of the lock)
+		void advance(sl_uint64 now);
+
+		// returns the time when `advance` should be called next, or -1 if there is no entry. The result can be earlier than the actual expiration
+		sl_int64 getNextExpireTime();
+
+		sl_size getCount();
+
+	private:
+		struct Node;
+
+		sl_uint64 _add(sl_uint64 expireTime, const Function<void()>* task, const Function<sl_uint64(sl_uint64)>* check);
+
+		Node* _getNode(sl_uint64 id);
+
+		void _link(sl_uint32 index);
+
+		void _unlink(sl_uint32 index);
+
+		void _free(sl_uint32 index);
+
+		void _cascade(sl_uint32 level, sl_uint32 slot);
+
+		sl_uint64 _getTick(sl_uint64 time);
+
+	private:
+		Node* m_nodes;
+		sl_uint32 m_nNodes;
+		sl_uint32 m_capacity;
+		sl_uint32 m_freeNode;
+		sl_uint32 m_slots[4][256];
+		sl_uint32 m_slotTails[4][256];
+		sl_size m_countLevels[4];
+		sl_size m_count;
+		sl_uint64 m_currentTick;
+		sl_uint32 m_tickMillis;
+
+	};
+
+}
+
+#endif
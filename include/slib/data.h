@@ -29,6 +29,7 @@
 #include "data/crc32.h"
 #include "data/ini.h"
 #include "data/xml.h"
+#include "data/xml_push_parser.h"
 #include "data/serialize.h"
 #include "data/enum_int.h"
 
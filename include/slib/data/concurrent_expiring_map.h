@@ -0,0 +1,656 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_DATA_CONCURRENT_EXPIRING_MAP
+#define CHECKHEADER_SLIB_DATA_CONCURRENT_EXPIRING_MAP
+
+#include "definition.h"
+
+#include "../core/hash_map.h"
+#include "../core/list.h"
+#include "../core/mutex.h"
+#include "../core/spin_lock.h"
+#include "../core/dispatch_loop.h"
+#include "../core/timer.h"
+#include "../system/system.h"
+
+#define SLIB_CONCURRENT_EXPIRING_MAP_DEFAULT_SHARD_COUNT 16
+
+/*
+	Concurrent variant of `ExpiringMap`.
+
+	The items are distributed into lock-striped shards by the hash of the key, so that the operations on the different shards do not block each other.
+	Every item has its own lifetime (the expiring duration of the map by default), which is extended when the item is accessed with `flagUpdateLifetime`. Expired items are never returned, and are removed by the timer, which invokes `onExpired` outside of the locks.
+
+	When the maximum count is set, every shard keeps at most (maxCount / shardCount) items:
+	- Eviction (approximate LRU): the CLOCK hand skips and clears the recently referenced items, and evicts the first one not referenced since its last pass.
+	- Admission (TinyLFU): the access frequencies of the keys are estimated by a count-min sketch of each shard, which halves its counters periodically. A new item replaces the eviction candidate only if its key is accessed more frequently, so a burst of one-time keys does not flush the frequently used items.
+	Evicted and rejected items are not passed to `onExpired`.
+*/
+
+namespace slib
+{
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_COMPARE = Compare<KT> >
+	class SLIB_EXPORT ConcurrentExpiringMap
+	{
+	public:
+		typedef HashMap<KT, VT, HASH, KEY_COMPARE> MAP;
+
+	public:
+		ConcurrentExpiringMap(sl_uint32 shardCount = SLIB_CONCURRENT_EXPIRING_MAP_DEFAULT_SHARD_COUNT, sl_size maxCount = 0)
+		{
+			sl_uint32 n = 1;
+			while (n < shardCount && n < 0x10000) {
+				n <<= 1;
+			}
+			m_shards = new Shard[n];
+			m_countShards = n;
+			m_duration = 0;
+			m_sweepInterval = 0;
+			m_flagTimerRunning = sl_false;
+			setMaximumCount(maxCount);
+		}
+
+		~ConcurrentExpiringMap()
+		{
+			Ref<Timer> timer;
+			{
+				MutexLocker lock(&m_lockTimer);
+				timer = Move(m_timer);
+			}
+			if (timer.isNotNull()) {
+				timer->stopAndWait();
+			}
+			delete[] m_shards;
+		}
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(ConcurrentExpiringMap)
+
+	public:
+		sl_uint32 getShardCount() const
+		{
+			return m_countShards;
+		}
+
+		// Default lifetime of the items (0: never expires)
+		sl_uint32 getExpiringMilliseconds() const
+		{
+			return m_duration;
+		}
+
+		void setExpiringMilliseconds(sl_uint32 expiring_duration_ms)
+		{
+			m_duration = expiring_duration_ms;
+		}
+
+		Ref<DispatchLoop> getDispatchLoop() const
+		{
+			MutexLocker lock(&m_lockTimer);
+			return m_dispatchLoop;
+		}
+
+		void setDispatchLoop(const Ref<DispatchLoop>& loop)
+		{
+			MutexLocker lock(&m_lockTimer);
+			if (m_dispatchLoop != loop) {
+				m_dispatchLoop = loop;
+				if (m_timer.isNotNull()) {
+					_startTimer(m_sweepInterval);
+				}
+			}
+		}
+
+		sl_size getMaximumCount() const
+		{
+			return m_maxCount;
+		}
+
+		// 0 means unlimited count. Existing items above the new limit are evicted by the following insertions.
+		void setMaximumCount(sl_size maxCount)
+		{
+			m_maxCount = maxCount;
+			sl_size capacity = 0;
+			if (maxCount) {
+				capacity = (maxCount + m_countShards - 1) / m_countShards;
+			}
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				shard.setCapacity(capacity);
+			}
+		}
+
+		const Function<void(MAP& removedItems)>& getOnExpired() const
+		{
+			return m_onExpired;
+		}
+
+		void setOnExpired(const Function<void(MAP& removedItems)>& callback)
+		{
+			m_onExpired = callback;
+		}
+
+		sl_size getCount() const
+		{
+			sl_size n = 0;
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				n += shard.map.getCount();
+			}
+			return n;
+		}
+
+		sl_bool isEmpty() const
+		{
+			return !(getCount());
+		}
+
+		sl_bool isNotEmpty() const
+		{
+			return getCount() != 0;
+		}
+
+		sl_bool get(const KT& key, VT* _out = sl_null, sl_bool flagUpdateLifetime = sl_true)
+		{
+			sl_uint64 hash = _getHash(key);
+			Shard& shard = _getShard(hash);
+			MAP expired;
+			{
+				SpinLocker lock(&(shard.lock));
+				shard.recordAccess(hash);
+				NODE* node = shard.map.find_NoLock(key);
+				if (node) {
+					Entry& entry = node->value;
+					if (entry.expireTick) {
+						sl_uint64 now = System::getTickCount64();
+						if (now >= entry.expireTick) {
+							expired.add_NoLock(Move(node->key), Move(entry.value));
+							shard.removeNode(node);
+							shard.countExpired++;
+							node = sl_null;
+						} else if (flagUpdateLifetime) {
+							entry.expireTick = now + entry.lifetime;
+						}
+					}
+					if (node) {
+						entry.flagReferenced = sl_true;
+						if (_out) {
+							*_out = entry.value;
+						}
+						shard.countHit++;
+						return sl_true;
+					}
+				}
+				shard.countMiss++;
+			}
+			if (expired.isNotEmpty() && m_onExpired.isNotNull()) {
+				m_onExpired(expired);
+			}
+			return sl_false;
+		}
+
+		VT getValue(const KT& key, const VT& def, sl_bool flagUpdateLifetime = sl_true)
+		{
+			VT ret;
+			if (get(key, &ret, flagUpdateLifetime)) {
+				return ret;
+			}
+			return def;
+		}
+
+		// Returns `sl_false` when the item is not admitted to the full shard
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value)
+		{
+			return put(Forward<KEY>(key), Forward<VALUE>(value), m_duration);
+		}
+
+		// `lifetime`: milliseconds (0: never expires)
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_uint32 lifetime)
+		{
+			sl_uint64 hash = _getHash(key);
+			Shard& shard = _getShard(hash);
+			MAP removed;
+			sl_bool flagExpired = sl_false;
+			{
+				SpinLocker lock(&(shard.lock));
+				shard.recordAccess(hash);
+				sl_uint64 expireTick = lifetime ? System::getTickCount64() + lifetime : 0;
+				NODE* node = shard.map.find_NoLock(key);
+				if (node) {
+					Entry& entry = node->value;
+					entry.value = Forward<VALUE>(value);
+					entry.expireTick = expireTick;
+					entry.lifetime = lifetime;
+					entry.flagReferenced = sl_true;
+				} else {
+					if (shard.capacity && shard.map.getCount() >= shard.capacity) {
+						NODE* victim = shard.findVictim();
+						Entry& entry = victim->value;
+						if (entry.expireTick && System::getTickCount64() >= entry.expireTick) {
+							flagExpired = sl_true;
+							shard.countExpired++;
+						} else {
+							if (shard.estimateFrequency(hash) <= shard.estimateFrequency(_getHash(victim->key))) {
+								shard.countRejected++;
+								return sl_false;
+							}
+							shard.countEvicted++;
+						}
+						removed.add_NoLock(Move(victim->key), Move(entry.value));
+						shard.removeNode(victim);
+					}
+					if (!(shard.map.add_NoLock(Forward<KEY>(key), Forward<VALUE>(value), expireTick, lifetime))) {
+						return sl_false;
+					}
+				}
+			}
+			if (lifetime) {
+				_checkTimer(lifetime);
+			}
+			if (flagExpired && m_onExpired.isNotNull()) {
+				m_onExpired(removed);
+			}
+			return sl_true;
+		}
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null)
+		{
+			sl_uint64 hash = _getHash(key);
+			Shard& shard = _getShard(hash);
+			VT value;
+			{
+				SpinLocker lock(&(shard.lock));
+				NODE* node = shard.map.find_NoLock(key);
+				if (!node) {
+					return sl_false;
+				}
+				value = Move(node->value.value);
+				shard.removeNode(node);
+			}
+			if (outValue) {
+				*outValue = Move(value);
+			}
+			return sl_true;
+		}
+
+		void removeAll()
+		{
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				HashMap<KT, Entry, HASH, KEY_COMPARE> map;
+				{
+					SpinLocker lock(&(shard.lock));
+					map = Move(shard.map);
+					shard.clockHand = sl_null;
+				}
+			}
+		}
+
+		// Removes the expired items, and invokes `onExpired`
+		void removeExpired()
+		{
+			MAP expired;
+			_removeExpired(expired);
+			if (expired.isNotEmpty() && m_onExpired.isNotNull()) {
+				m_onExpired(expired);
+			}
+		}
+
+		sl_bool contains(const KT& key) const
+		{
+			sl_uint64 hash = _getHash(key);
+			Shard& shard = _getShard(hash);
+			SpinLocker lock(&(shard.lock));
+			NODE* node = shard.map.find_NoLock(key);
+			if (node) {
+				sl_uint64 expireTick = node->value.expireTick;
+				return !(expireTick && System::getTickCount64() >= expireTick);
+			}
+			return sl_false;
+		}
+
+		List<KT> getAllKeys() const
+		{
+			List<KT> ret;
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				ret.addAll_NoLock(shard.map.getAllKeys_NoLock());
+			}
+			return ret;
+		}
+
+		List< Pair<KT, VT> > toList() const
+		{
+			List< Pair<KT, VT> > ret;
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				NODE* node = shard.map.getFirstNode();
+				while (node) {
+					ret.add_NoLock(node->key, node->value.value);
+					node = node->next;
+				}
+			}
+			return ret;
+		}
+
+	public:
+		sl_uint64 getHitCount() const
+		{
+			return _sumCounters(&Shard::countHit);
+		}
+
+		sl_uint64 getMissCount() const
+		{
+			return _sumCounters(&Shard::countMiss);
+		}
+
+		// Items removed to make room for the new items
+		sl_uint64 getEvictionCount() const
+		{
+			return _sumCounters(&Shard::countEvicted);
+		}
+
+		// New items not admitted to the full shards
+		sl_uint64 getRejectionCount() const
+		{
+			return _sumCounters(&Shard::countRejected);
+		}
+
+		sl_uint64 getExpirationCount() const
+		{
+			return _sumCounters(&Shard::countExpired);
+		}
+
+		void resetCounters()
+		{
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				shard.countHit = 0;
+				shard.countMiss = 0;
+				shard.countEvicted = 0;
+				shard.countRejected = 0;
+				shard.countExpired = 0;
+			}
+		}
+
+	protected:
+		class Entry
+		{
+		public:
+			VT value;
+			sl_uint64 expireTick; // 0: never expires
+			sl_uint32 lifetime;
+			sl_bool flagReferenced;
+
+		public:
+			template <class VALUE>
+			Entry(VALUE&& _value, sl_uint64 _expireTick, sl_uint32 _lifetime): value(Forward<VALUE>(_value)), expireTick(_expireTick), lifetime(_lifetime), flagReferenced(sl_false) {}
+
+		};
+
+		typedef HashMapNode<KT, Entry> NODE;
+
+		class Shard
+		{
+		public:
+			SpinLock lock;
+			HashMap<KT, Entry, HASH, KEY_COMPARE> map;
+			sl_size capacity = 0;
+			NODE* clockHand = sl_null;
+
+			// count-min sketch of 4 hash functions over (capacity * 8) counters, saturating at 15
+			sl_uint8* sketch = sl_null;
+			sl_uint32 sketchMask = 0;
+			sl_size sketchAdditions = 0;
+			sl_size sketchResetPeriod = 0;
+
+			sl_uint64 countHit = 0;
+			sl_uint64 countMiss = 0;
+			sl_uint64 countEvicted = 0;
+			sl_uint64 countRejected = 0;
+			sl_uint64 countExpired = 0;
+
+			// keeps the shards on the different cache lines
+			sl_uint8 padding[64];
+
+		public:
+			~Shard()
+			{
+				if (sketch) {
+					Base::freeMemory(sketch);
+				}
+			}
+
+		public:
+			void setCapacity(sl_size _capacity)
+			{
+				capacity = _capacity;
+				if (sketch) {
+					Base::freeMemory(sketch);
+					sketch = sl_null;
+				}
+				sketchMask = 0;
+				sketchAdditions = 0;
+				if (!capacity) {
+					return;
+				}
+				sl_uint32 width = 64;
+				while (width < (capacity << 3) && width < 0x1000000) {
+					width <<= 1;
+				}
+				sketch = (sl_uint8*)(Base::createZeroMemory(width));
+				if (sketch) {
+					sketchMask = width - 1;
+					sketchResetPeriod = capacity * 10;
+				}
+			}
+
+			static void getSketchHashes(sl_uint64 hash, sl_uint32& h1, sl_uint32& h2)
+			{
+				h1 = (sl_uint32)hash;
+				h2 = (sl_uint32)((hash * SLIB_UINT64(0x9e3779b97f4a7c15)) >> 32) | 1;
+			}
+
+			void recordAccess(sl_uint64 hash)
+			{
+				if (!sketch) {
+					return;
+				}
+				sl_uint32 h1, h2;
+				getSketchHashes(hash, h1, h2);
+				for (sl_uint32 i = 0; i < 4; i++) {
+					sl_uint8& c = sketch[(h1 + i * h2) & sketchMask];
+					if (c < 15) {
+						c++;
+					}
+				}
+				sketchAdditions++;
+				if (sketchAdditions >= sketchResetPeriod) {
+					// aging
+					for (sl_uint32 i = 0; i <= sketchMask; i++) {
+						sketch[i] >>= 1;
+					}
+					sketchAdditions >>= 1;
+				}
+			}
+
+			sl_uint32 estimateFrequency(sl_uint64 hash)
+			{
+				if (!sketch) {
+					return 0;
+				}
+				sl_uint32 h1, h2;
+				getSketchHashes(hash, h1, h2);
+				sl_uint32 ret = 15;
+				for (sl_uint32 i = 0; i < 4; i++) {
+					sl_uint32 c = sketch[(h1 + i * h2) & sketchMask];
+					if (c < ret) {
+						ret = c;
+					}
+				}
+				return ret;
+			}
+
+			// CLOCK: returns the first item which is not referenced since the last pass of the hand
+			NODE* findVictim()
+			{
+				for (;;) {
+					NODE* node = clockHand;
+					if (!node) {
+						node = map.getFirstNode();
+					}
+					clockHand = node->next;
+					Entry& entry = node->value;
+					if (entry.flagReferenced) {
+						entry.flagReferenced = sl_false;
+					} else {
+						return node;
+					}
+				}
+			}
+
+			void removeNode(NODE* node)
+			{
+				if (clockHand == node) {
+					clockHand = node->next;
+				}
+				map.removeAt(node);
+			}
+		};
+
+	protected:
+		// `Rehash` is linear and keeps the high bits of the small keys zero, so the hash is mixed by multiplication for the shards and the sketch
+		static sl_uint64 _getHash(const KT& key)
+		{
+			sl_uint64 h = (sl_uint64)(HASH()(key));
+			h ^= h >> 33;
+			h *= SLIB_UINT64(0xff51afd7ed558ccd);
+			h ^= h >> 33;
+			return h;
+		}
+
+		Shard& _getShard(sl_uint64 hash) const
+		{
+			return m_shards[(sl_uint32)(hash >> 48) & (m_countShards - 1)];
+		}
+
+		sl_uint64 _sumCounters(sl_uint64 Shard::*counter) const
+		{
+			sl_uint64 n = 0;
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				n += shard.*counter;
+			}
+			return n;
+		}
+
+		void _removeExpired(MAP& expired)
+		{
+			sl_uint64 now = System::getTickCount64();
+			for (sl_uint32 i = 0; i < m_countShards; i++) {
+				Shard& shard = m_shards[i];
+				SpinLocker lock(&(shard.lock));
+				NODE* node = shard.map.getFirstNode();
+				while (node) {
+					NODE* next = node->next;
+					Entry& entry = node->value;
+					if (entry.expireTick && now >= entry.expireTick) {
+						expired.add_NoLock(Move(node->key), Move(entry.value));
+						shard.removeNode(node);
+						shard.countExpired++;
+					}
+					node = next;
+				}
+			}
+		}
+
+		void _checkTimer(sl_uint32 lifetime)
+		{
+			if (m_flagTimerRunning && lifetime >= m_sweepInterval) {
+				return;
+			}
+			MutexLocker lock(&m_lockTimer);
+			if (m_timer.isNull() || lifetime < m_sweepInterval) {
+				_startTimer(lifetime);
+			}
+		}
+
+		void _startTimer(sl_uint32 interval)
+		{
+			if (m_timer.isNotNull()) {
+				m_timer->stop();
+				m_timer.setNull();
+			}
+			m_sweepInterval = interval;
+			m_timer = Timer::startWithLoop(m_dispatchLoop, SLIB_FUNCTION_MEMBER(this, _onTimer), interval);
+			m_flagTimerRunning = m_timer.isNotNull();
+		}
+
+		void _onTimer(Timer* timer)
+		{
+			MAP expired;
+			_removeExpired(expired);
+			{
+				MutexLocker lock(&m_lockTimer);
+				if (m_timer == timer) {
+					// cleared before counting, so that a `put` missed by the count sees the cleared flag and restarts the timer
+					m_flagTimerRunning = sl_false;
+					if (isEmpty()) {
+						m_timer->stop();
+						m_timer.setNull();
+					} else {
+						m_flagTimerRunning = sl_true;
+					}
+				}
+			}
+			if (expired.isNotEmpty() && m_onExpired.isNotNull()) {
+				m_onExpired(expired);
+			}
+		}
+
+	protected:
+		Shard* m_shards;
+		sl_uint32 m_countShards;
+		sl_uint32 m_duration;
+		sl_size m_maxCount;
+
+		Mutex m_lockTimer;
+		Ref<DispatchLoop> m_dispatchLoop;
+		Ref<Timer> m_timer;
+		sl_uint32 m_sweepInterval;
+		volatile sl_bool m_flagTimerRunning;
+
+		Function<void(MAP& removedItems)> m_onExpired;
+
+	};
+
+}
+
+#endif
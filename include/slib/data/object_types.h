@@ -41,6 +41,7 @@ namespace slib
 			XmlComment,
 			XmlWhiteSpace,
 			XmlDocumentTypeDefinition,
+			XmlPushParser,
 			TableModel
 		};
 
@@ -0,0 +1,135 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_DATA_XML_PUSH_PARSER
+#define CHECKHEADER_SLIB_DATA_XML_PUSH_PARSER
+
+/************************************************************
+
+		Incremental (push mode) XML parser
+
+ - Accepts UTF-8 input in arbitrary chunks and keeps its state across chunk boundaries
+ - Emits events with views into the input (or into small internal buffers), no nodes are created
+ - Memory is bounded by `maxTokenSize` and `maxDepth`, independent of the document size
+ - Namespaces are not processed (names are reported with their prefixes), DTD is skipped
+
+************************************************************/
+
+#include "definition.h"
+
+#include "../core/object.h"
+#include "../core/string.h"
+#include "../core/function.h"
+#include "../core/memory.h"
+
+namespace slib
+{
+
+	class IReader;
+	class AsyncStream;
+	class XmlPushParser;
+
+	class SLIB_EXPORT XmlPushAttribute
+	{
+	public:
+		StringView name;
+		StringView value; // entities are decoded
+	};
+
+	class SLIB_EXPORT XmlPushParser_Param
+	{
+	public:
+		sl_size maxTokenSize; // maximum length of a tag, comment, processing instruction or a text piece kept across chunks
+		sl_uint32 maxDepth; // maximum nesting depth of elements
+		sl_bool flagDecodeEntities; // decode entities in texts and attribute values
+		sl_bool flagIgnoreWhiteSpaces; // do not report texts consisting of white spaces only (for a text delivered in pieces, only the leading pieces)
+
+		// callbacks (views are valid only during the call)
+		Function<void(XmlPushParser*, const StringView& name, const XmlPushAttribute* attributes, sl_size nAttributes)> onStartElement;
+		Function<void(XmlPushParser*, const StringView& name)> onEndElement;
+		// a text longer than `maxTokenSize` may be delivered in several pieces
+		Function<void(XmlPushParser*, const StringView& text)> onText;
+		Function<void(XmlPushParser*, const StringView& text)> onCDATA;
+		Function<void(XmlPushParser*, const StringView& content)> onComment;
+		Function<void(XmlPushParser*, const StringView& target, const StringView& content)> onProcessingInstruction;
+
+	public:
+		XmlPushParser_Param();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(XmlPushParser_Param)
+
+	};
+
+	class SLIB_EXPORT XmlPushParser : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		XmlPushParser();
+
+		~XmlPushParser();
+
+	public:
+		typedef XmlPushParser_Param Param;
+
+		static Ref<XmlPushParser> create(const XmlPushParser_Param& param);
+
+	public:
+		// returns `false` on error or when stopped
+		virtual sl_bool push(const void* data, sl_size size) = 0;
+
+		// call after the last chunk; checks that the document is complete
+		virtual sl_bool finish() = 0;
+
+		// pushes all data of `reader` and finishes
+		sl_bool parse(IReader* reader, sl_size chunkSize = 65536);
+
+		// reads `stream` until it ends, then finishes and calls `onComplete`
+		void parse(const Ref<AsyncStream>& stream, const Function<void(XmlPushParser*, sl_bool flagSuccess)>& onComplete, sl_size chunkSize = 65536);
+
+		// can be called in callbacks
+		virtual void stop() = 0;
+
+		// starts a new document
+		virtual void reset() = 0;
+
+		virtual sl_bool isError() = 0;
+
+		virtual String getErrorMessage() = 0;
+
+		// byte offset in the input where the error was detected
+		virtual sl_uint64 getErrorPosition() = 0;
+
+		// number of bytes consumed
+		virtual sl_uint64 getPosition() = 0;
+
+		virtual sl_uint32 getDepth() = 0;
+
+	protected:
+		void _readAsync(const Ref<AsyncStream>& stream, const Memory& mem, const Function<void(XmlPushParser*, sl_bool flagSuccess)>& onComplete);
+
+	};
+
+}
+
+#endif
@@ -28,11 +28,14 @@
 #include "db/sqlite.h"
 #include "db/mysql.h"
 #include "db/postgresql.h"
+#include "db/database_pool.h"
 
 #include "db/redis.h"
+#include "db/async_redis.h"
 #include "db/leveldb.h"
 #include "db/rocksdb.h"
 #include "db/lmdb.h"
+#include "db/btree_store.h"
 
 #include "db/mongodb.h"
 
@@ -0,0 +1,156 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_DB_ASYNC_REDIS
+#define CHECKHEADER_SLIB_DB_ASYNC_REDIS
+
+#include "definition.h"
+
+#include "../network/socket_address.h"
+#include "../core/promise.h"
+#include "../core/function.h"
+#include "../core/variant.h"
+
+/*
+	Redis client on `AsyncIoLoop`, with a native RESP2/RESP3 parser.
+	Commands are pipelined: each command is queued to the connection of its shard, and the commands queued in the same loop tick are written together.
+	Replies are delivered on the I/O loop in the order of the commands.
+*/
+
+namespace slib
+{
+
+	class AsyncIoLoop;
+	class AsyncRedis;
+
+	class SLIB_EXPORT AsyncRedisResult
+	{
+	public:
+		// String, Int64, Double, Boolean, List (arrays, sets) or Map (RESP3 maps). Null for null replies
+		Variant value;
+
+		// error reply, or error of the connection
+		String error;
+
+	public:
+		AsyncRedisResult() noexcept;
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(AsyncRedisResult)
+
+	public:
+		sl_bool isSuccess() const noexcept
+		{
+			return error.isNull();
+		}
+
+		sl_bool isError() const noexcept
+		{
+			return error.isNotNull();
+		}
+
+	};
+
+	class SLIB_EXPORT AsyncRedisParam
+	{
+	public:
+		// one connection per address. The commands are distributed by the hash slot of the key (`args[1]`)
+		List<SocketAddress> addresses;
+
+		Ref<AsyncIoLoop> ioLoop;
+
+		// 2 or 3 (sends `HELLO 3` after connecting). Default: 2
+		sl_uint32 protocolVersion;
+		String password;
+
+		sl_int32 connectTimeout; // milliseconds. Default: 10000
+		sl_bool flagLogErrors; // Default: true
+
+		// RESP3 push messages (such as Pub/Sub messages)
+		Function<void(AsyncRedis*, Variant& message)> onPush;
+
+	public:
+		AsyncRedisParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(AsyncRedisParam)
+
+	};
+
+	class SLIB_EXPORT AsyncRedis : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		AsyncRedis();
+
+		~AsyncRedis();
+
+	public:
+		static Ref<AsyncRedis> create(const AsyncRedisParam& param);
+
+		static Ref<AsyncRedis> create(const SocketAddress& address);
+
+	public:
+		// `args[0]` is the command name. The connections are opened on the first command, and reopened after errors
+		virtual void executeBy(const Variant* args, sl_size nArgs, const Function<void(AsyncRedisResult&)>& callback) = 0;
+
+		Promise<AsyncRedisResult> executeBy(const Variant* args, sl_size nArgs);
+
+		template <class... ARGS>
+		Promise<AsyncRedisResult> execute(ARGS&&... args)
+		{
+			Variant params[] = {Forward<ARGS>(args)...};
+			return executeBy(params, sizeof...(args));
+		}
+
+		Promise<AsyncRedisResult> get(const StringParam& key);
+
+		Promise<AsyncRedisResult> set(const StringParam& key, const Variant& value);
+
+		Promise<AsyncRedisResult> del(const StringParam& key);
+
+		Promise<AsyncRedisResult> incr(const StringParam& key);
+
+		Promise<AsyncRedisResult> incrby(const StringParam& key, sl_int64 n);
+
+		Promise<AsyncRedisResult> lpush(const StringParam& key, const Variant& value);
+
+		Promise<AsyncRedisResult> rpush(const StringParam& key, const Variant& value);
+
+		Promise<AsyncRedisResult> lrange(const StringParam& key, sl_int64 start = 0, sl_int64 stop = -1);
+
+		virtual sl_uint32 getShardCount() = 0;
+
+		// fails the pending commands, and closes the connections
+		virtual void close() = 0;
+
+	public:
+		// CRC16 of the key (or of its `{hash tag}`) modulo 16384, compatible with Redis Cluster
+		static sl_uint32 getHashSlot(const void* key, sl_size size);
+
+		static sl_uint32 getHashSlot(const StringView& key);
+
+	};
+
+}
+
+#endif
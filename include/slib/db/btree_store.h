@@ -0,0 +1,89 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_DB_BTREE_STORE
+#define CHECKHEADER_SLIB_DB_BTREE_STORE
+
+#include "key_value_store.h"
+
+#include "../core/string.h"
+
+namespace slib
+{
+
+	class BTreeStore_Param
+	{
+	public:
+		StringParam path;
+
+		sl_bool flagCreateIfMissing;
+		sl_bool flagReadOnly;
+		sl_bool flagSync; // flush file on every commit
+
+		sl_uint32 pageSize; // power of 2 in [512, 32768]. Used only when creating new file
+		sl_uint32 cacheSize; // maximum number of pages in the page cache
+
+		// output
+		String errorText;
+
+	public:
+		BTreeStore_Param();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(BTreeStore_Param)
+
+	};
+
+	/*
+		Persistent B+tree on fixed-size pages of a single file.
+		Modified pages are written to free pages (copy-on-write), and the commit is completed by switching one of two meta pages.
+		Readers see the state committed before they started, and never block the writer.
+	*/
+	class SLIB_EXPORT BTreeStore : public KeyValueStore
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		BTreeStore();
+
+		~BTreeStore();
+
+	public:
+		typedef BTreeStore_Param Param;
+
+		static Ref<BTreeStore> open(BTreeStore_Param& param);
+
+		static Ref<BTreeStore> open(const StringParam& path);
+
+	public:
+		virtual sl_uint64 getCount() = 0;
+
+		virtual sl_uint32 getPageSize() = 0;
+
+		virtual sl_uint64 getCacheHitCount() = 0;
+
+		virtual sl_uint64 getCacheMissCount() = 0;
+
+	};
+
+}
+
+#endif
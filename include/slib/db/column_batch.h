@@ -0,0 +1,176 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_DB_COLUMN_BATCH
+#define CHECKHEADER_SLIB_DB_COLUMN_BATCH
+
+#include "definition.h"
+
+#include "../core/variant.h"
+
+/*
+	Column-major batch of rows, filled by `DatabaseCursor::fetchBatch()`.
+	The buffers are kept between the fetches, so a batch can be reused to read a large result without allocating per row.
+*/
+
+namespace slib
+{
+
+	class DatabaseCursor;
+
+	enum class DatabaseColumnBatchType
+	{
+		Auto = 0, // resolved by the first non-null value, and kept for the next fetches
+		Int64 = 1,
+		Double = 2,
+		String = 3,
+		Blob = 4
+	};
+
+	class SLIB_EXPORT DatabaseColumnBatch
+	{
+	public:
+		String name;
+		DatabaseColumnBatchType type;
+
+	public:
+		DatabaseColumnBatch() noexcept;
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DatabaseColumnBatch)
+
+	public:
+		sl_uint32 getRowCount() const noexcept
+		{
+			return m_nRows;
+		}
+
+		sl_bool isNull(sl_uint32 row) const noexcept
+		{
+			return (((sl_uint8*)(m_nulls.getData()))[row >> 3] >> (row & 7)) & 1;
+		}
+
+		// bit `row` is set for the NULL values
+		const sl_uint8* getNullBitmap() const noexcept
+		{
+			return (sl_uint8*)(m_nulls.getData());
+		}
+
+		// valid for `Int64` columns (0 for the NULL values)
+		const sl_int64* getInt64Values() const noexcept
+		{
+			return (sl_int64*)(m_values.getData());
+		}
+
+		// valid for `Double` columns (0 for the NULL values)
+		const double* getDoubleValues() const noexcept
+		{
+			return (double*)(m_values.getData());
+		}
+
+		// valid for `String` and `Blob` columns: the value of `row` is stored in [getEndOffsets()[row - 1], getEndOffsets()[row]) of `getData()`, starting at 0 for the first row
+		const sl_uint64* getEndOffsets() const noexcept
+		{
+			return (sl_uint64*)(m_values.getData());
+		}
+
+		const sl_uint8* getData() const noexcept
+		{
+			return (sl_uint8*)(m_data.getData());
+		}
+
+		sl_size getDataSize() const noexcept
+		{
+			return m_sizeData;
+		}
+
+
+		sl_int64 getInt64(sl_uint32 row) const noexcept;
+
+		double getDouble(sl_uint32 row) const noexcept;
+
+		// points to the string arena, valid until the next fetch
+		StringView getStringView(sl_uint32 row) const noexcept;
+
+		String getString(sl_uint32 row) const noexcept;
+
+		Memory getBlob(sl_uint32 row) const noexcept;
+
+		Variant getValue(sl_uint32 row) const noexcept;
+
+
+		// clears the rows, keeping `type` and the allocated buffers
+		sl_bool reset(sl_uint32 capacity) noexcept;
+
+		// the following functions must not be called more than `capacity` times after `reset()`
+		void addNull() noexcept;
+
+		void addInt64(sl_int64 value) noexcept;
+
+		void addDouble(double value) noexcept;
+
+		void addBytes(const void* data, sl_size size) noexcept;
+
+		// converts `value` to `type`, resolving `Auto` type
+		void addValue(const Variant& value) noexcept;
+
+	protected:
+		Memory m_values;
+		Memory m_nulls;
+		Memory m_data;
+		sl_size m_sizeData;
+		sl_uint32 m_nRows;
+		sl_uint32 m_capacity;
+
+	};
+
+	class SLIB_EXPORT DatabaseRowBatch
+	{
+	public:
+		sl_uint32 rowCount;
+
+		// set the types before the first fetch to convert the values, otherwise they are resolved by the fetched values
+		List<DatabaseColumnBatch> columns;
+
+	public:
+		DatabaseRowBatch() noexcept;
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DatabaseRowBatch)
+
+	public:
+		sl_uint32 getColumnCount() const noexcept;
+
+		// returns -1 when the column name not found
+		sl_int32 getColumnIndex(const StringView& name) const noexcept;
+
+		DatabaseColumnBatch* getColumn(sl_uint32 index) const noexcept;
+
+		DatabaseColumnBatch* getColumn(const StringView& name) const noexcept;
+
+		// prepares the columns of `cursor` for `maxRows` rows. Called by `DatabaseCursor::fetchBatch()`
+		sl_bool prepare(DatabaseCursor* cursor, sl_uint32 maxRows) noexcept;
+
+	};
+
+}
+
+#endif
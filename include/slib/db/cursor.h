@@ -24,6 +24,7 @@
 #define CHECKHEADER_SLIB_DB_CURSOR
 
 #include "definition.h"
+#include "column_batch.h"
 
 #include "../core/variant.h"
 
@@ -116,6 +117,9 @@ namespace slib
 
 		virtual sl_bool moveNext() = 0;
 
+		// moves to the next `maxRows` rows (at most) and reads them into the column buffers of `batch`, reusing the buffers of the previous fetch. Returns the count of the fetched rows, 0 at the end
+		virtual sl_uint32 fetchBatch(DatabaseRowBatch& batch, sl_uint32 maxRows);
+
 	protected:
 		Ref<Database> m_db;
 
@@ -27,9 +27,25 @@
 #include "cursor.h"
 #include "statement.h"
 
+#include "../core/linked_list.h"
+#include "../core/hash_map.h"
+#include "../core/spin_lock.h"
+
 namespace slib
 {
 
+	class SLIB_EXPORT DatabaseStatementCacheStatistics
+	{
+	public:
+		sl_uint64 hitCount;
+		sl_uint64 missCount;
+		sl_size cachedCount;
+
+	public:
+		DatabaseStatementCacheStatistics() noexcept;
+
+	};
+
 	class SLIB_EXPORT Database : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -134,6 +150,9 @@ namespace slib
 			return getValueBy(sql, params, sizeof...(args));
 		}
 
+		// executes `sql` for each of `nRows` rows of `params` (`nParamsPerRow` values per row) with one prepared statement. Returns the total count of the affected rows, or -1 on the first failed row (the previous rows are not rolled back)
+		sl_int64 executeBatch(const StringParam& sql, const Variant* params, sl_size nParamsPerRow, sl_size nRows);
+
 		sl_bool isLoggingSQL();
 
 		void setLoggingSQL(sl_bool flag = sl_true);
@@ -146,6 +165,17 @@ namespace slib
 		DatabaseDialect getDialect();
 
 
+		// Maximum count of the prepared statements cached by SQL text, used by `executeBy()` and `queryBy()` (and the derived functions). 0 disables the cache. Default: 64
+		sl_uint32 getStatementCacheSize();
+
+		void setStatementCacheSize(sl_uint32 size);
+
+		// Called automatically after `CREATE`, `ALTER` and `DROP` statements
+		void clearStatementCache();
+
+		void getStatementCacheStatistics(DatabaseStatementCacheStatistics& _out);
+
+
 		virtual String getErrorMessage() = 0;
 
 		virtual sl_bool isDatabaseExisting(const StringParam& name) = 0;
@@ -195,6 +225,11 @@ namespace slib
 			return -1;
 		}
 
+		// inserts `nRows` rows of `values` (row-major) using multi-row `INSERT` statements, split by the parameter limit of the dialect
+		sl_int64 insertBatch(const DatabaseIdentifier& table, const ListParam<String>& columns, const Variant* values, sl_size nRows);
+
+		sl_int64 insertBatch(const DatabaseIdentifier& table, const DatabaseRowBatch& batch);
+
 		Ref<DatabaseStatement> prepareUpdate(const DatabaseIdentifier& table, const ListParam<String>& columns, const DatabaseExpression& where);
 
 		template <class MAP>
@@ -419,12 +454,34 @@ namespace slib
 
 		void _logError(const StringParam& sql, const Variant* params, sl_size nParams);
 
+		Ref<DatabaseStatement> _getCachedStatement(const String& sql);
+
+		void _releaseCachedStatement(const String& sql, Ref<DatabaseStatement>& statement, sl_bool flagSuccess);
+
+		void _clearStatementCache(sl_bool flagDestroying);
+
+		// must be called by the destructor of the implementation, before closing the connection
+		void _freeStatementCache();
+
 	protected:
 		sl_bool m_flagLogSQL;
 		sl_bool m_flagLogErrors;
 
 		DatabaseDialect m_dialect;
 
+		struct CachedStatement
+		{
+			String sql;
+			Ref<DatabaseStatement> statement;
+		};
+		SpinLock m_lockStatementCache;
+		// front: most recently used
+		CLinkedList<CachedStatement> m_listCachedStatements;
+		CHashMap< String, Link<CachedStatement>* > m_mapCachedStatements;
+		sl_uint32 m_sizeStatementCache;
+		sl_uint64 m_nStatementCacheHits;
+		sl_uint64 m_nStatementCacheMisses;
+
 	};
 
 }
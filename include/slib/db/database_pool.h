@@ -0,0 +1,228 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_DB_DATABASE_POOL
+#define CHECKHEADER_SLIB_DB_DATABASE_POOL
+
+#include "database.h"
+
+#include "../core/mutex.h"
+#include "../core/function.h"
+
+/*
+	Pool of the connections created by `DatabasePoolParam::onCreate`.
+	Idle connections are reused in LIFO order, so that the least recently used ones are evicted after `idleTimeout`.
+	When all connections are borrowed, the borrowers wait in FIFO order and the returned connections are handed over to them directly.
+*/
+
+namespace slib
+{
+
+	class DatabasePool;
+	class Event;
+
+	class SLIB_EXPORT DatabasePoolParam
+	{
+	public:
+		Function<Ref<Database>()> onCreate;
+
+		// Checks the connection which has been idle longer than `checkInterval`. Default: runs `checkSQL`
+		Function<sl_bool(Database*)> onCheck;
+		String checkSQL; // Default: SELECT 1
+
+		sl_uint32 minimumSize; // Connections opened on creation, and kept from the idle eviction. Default: 1
+		sl_uint32 maximumSize; // Default: 8
+
+		// milliseconds
+		sl_uint32 idleTimeout; // Default: 60000 (0: no eviction)
+		sl_uint32 checkInterval; // Default: 30000 (0: checks on every borrow)
+		sl_int32 borrowTimeout; // Default: 30000 (negative: infinite)
+
+	public:
+		DatabasePoolParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DatabasePoolParam)
+
+	};
+
+	class SLIB_EXPORT DatabasePoolStatistics
+	{
+	public:
+		sl_uint32 totalCount; // open connections, including the ones being created
+		sl_uint32 idleCount;
+		sl_uint32 borrowedCount;
+		sl_uint32 waitingCount;
+
+		sl_uint64 borrowCount;
+		sl_uint64 waitCount; // borrows which had to wait
+		sl_uint64 timeoutCount;
+		sl_uint64 createCount;
+		sl_uint64 createFailureCount;
+		sl_uint64 closeCount; // evicted, discarded and failed connections
+		sl_uint64 checkFailureCount;
+
+		// microseconds
+		sl_uint64 totalWaitTime;
+		sl_uint64 maxWaitTime;
+		sl_uint64 totalBorrowedTime; // sum of the returned leases
+
+		// `totalBorrowedTime` divided by `maximumSize` x the lifetime of the pool
+		double utilization;
+
+	public:
+		DatabasePoolStatistics() noexcept;
+
+	};
+
+	class SLIB_EXPORT DatabaseLease
+	{
+	public:
+		DatabaseLease() noexcept;
+
+		DatabaseLease(DatabasePool* pool, Ref<Database>&& db, sl_uint64 timeBorrowed) noexcept;
+
+		SLIB_DECLARE_MOVEONLY_CLASS_DEFAULT_MEMBERS(DatabaseLease)
+
+	public:
+		Database* get() const noexcept
+		{
+			return m_db.get();
+		}
+
+		Database* operator->() const noexcept
+		{
+			return m_db.get();
+		}
+
+		sl_bool isNull() const noexcept
+		{
+			return m_db.isNull();
+		}
+
+		sl_bool isNotNull() const noexcept
+		{
+			return m_db.isNotNull();
+		}
+
+		// returns the connection to the pool
+		void release() noexcept;
+
+		// closes the connection instead of returning it, when it is broken
+		void discard() noexcept;
+
+	private:
+		void _release(sl_bool flagDiscard) noexcept;
+
+	private:
+		Ref<DatabasePool> m_pool;
+		Ref<Database> m_db;
+		sl_uint64 m_timeBorrowed; // microseconds
+
+	};
+
+	class SLIB_EXPORT DatabasePool : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		DatabasePool();
+
+		~DatabasePool();
+
+	public:
+		static Ref<DatabasePool> create(const DatabasePoolParam& param);
+
+	public:
+		// waits for `borrowTimeout`. returns null lease on timeout or failure
+		DatabaseLease borrow();
+
+		// milliseconds. negative means INFINITE
+		DatabaseLease borrow(sl_int32 timeout);
+
+		// closes the idle connections unused for `idleTimeout`. Also called on every borrow and return
+		void evictIdleConnections();
+
+		// closes the idle connections, and fails the waiting and later borrows. The borrowed connections are closed when they are returned
+		void close();
+
+		sl_bool isClosed();
+
+		void getStatistics(DatabasePoolStatistics& _out);
+
+	protected:
+		Ref<Database> _borrow(sl_int32 timeout, sl_uint64& timeBorrowed);
+
+		void _return(Ref<Database>& db, sl_uint64 timeBorrowed, sl_bool flagDiscard);
+
+		sl_bool _check(Database* db);
+
+		Ref<Database> _createConnection();
+
+		// hands over `db` to the first waiter, or wakes it up to retry when `db` is null
+		sl_bool _wakeWaiter_NoLock(Ref<Database>* db);
+
+		void _addWaitTime_NoLock(sl_uint64 timeStart);
+
+		void _evictIdleConnections(List< Ref<Database> >& evicted, sl_uint64 now);
+
+	protected:
+		DatabasePoolParam m_param;
+		sl_bool m_flagClosed;
+		sl_uint64 m_timeCreated; // microseconds
+
+		struct IdleConnection
+		{
+			Ref<Database> db;
+			sl_uint64 timeReturned;
+		};
+		struct Waiter
+		{
+			Ref<Event> event;
+			sl_bool flagWoken;
+			Ref<Database> db; // handed over by `_return()`
+			sl_uint64 timeHandedOver;
+		};
+		Mutex m_lock;
+		// front: most recently returned
+		CLinkedList<IdleConnection> m_listIdle;
+		CLinkedList<Waiter*> m_listWaiters;
+		sl_uint32 m_nTotal;
+		sl_uint32 m_nBorrowed;
+
+		sl_uint64 m_nBorrows;
+		sl_uint64 m_nWaits;
+		sl_uint64 m_nTimeouts;
+		sl_uint64 m_nCreates;
+		sl_uint64 m_nCreateFailures;
+		sl_uint64 m_nCloses;
+		sl_uint64 m_nCheckFailures;
+		sl_uint64 m_timeTotalWait;
+		sl_uint64 m_timeMaxWait;
+		sl_uint64 m_timeTotalBorrowed;
+
+		friend class DatabaseLease;
+	};
+
+}
+
+#endif
@@ -40,6 +40,15 @@ namespace slib
 		StringParam path;
 		Ref<KeyValueStore> store;
 
+		// Maximum number of decoded items and dictionary ids kept in memory (0: no cache). Cached lists, maps and memories are copied on get and put
+		sl_uint32 cacheSize;
+
+		// Pending writes are coalesced and committed as one batch after this delay in milliseconds (0: write-through).
+		// Unflushed writes are visible to readers but are lost on crash; each flush is committed atomically.
+		sl_uint32 writeBehindDelay;
+		// Pending writes which force an immediate flush (0: 1024)
+		sl_uint32 writeBehindBatchSize;
+
 	public:
 		ObjectStoreParam();
 
@@ -88,6 +97,8 @@ namespace slib
 
 		PropertyIterator getItemIterator() const;
 
+		sl_bool flush() const;
+
 	public:
 		static const ObjectStore& undefined() noexcept
 		{
@@ -273,6 +284,9 @@ namespace slib
 
 		virtual Ref<ObjectStoreDictionary> getRootDictionary() = 0;
 
+		// Commits pending write-behind items. Iterators and dictionary removal flush implicitly
+		virtual sl_bool flush() = 0;
+
 	};
 
 }
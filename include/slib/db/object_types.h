@@ -56,7 +56,10 @@ namespace slib
 			DocumentDatabase,
 			DocumentCollection,
 			DocumentCursor,
-			MongoDB
+			MongoDB,
+			DatabasePool,
+			AsyncRedis,
+			BTreeStore
 		};
 
 	}
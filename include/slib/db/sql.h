@@ -521,6 +521,9 @@ namespace slib
 
 		void generateInsert(const DatabaseIdentifier& table, const ListParam<String>& columns);
 
+		// multi-row `INSERT` statement with the parameters of `nRows` rows
+		void generateInsert(const DatabaseIdentifier& table, const ListParam<String>& columns, sl_size nRows);
+
 		void generateUpdate(const DatabaseIdentifier& table, const ListParam<DatabaseColumn>& columns, const DatabaseExpression& where);
 
 		void generateUpdate(const DatabaseIdentifier& table, const ListParam<String>& columns, const DatabaseExpression& where);
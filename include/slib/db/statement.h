@@ -152,9 +152,12 @@ namespace slib
 		}
 
 	protected:
+		// null while the statement is idle in the cache of the database
 		Ref<Database> m_db;
 		List<String> m_names;
 
+		friend class Database;
+
 	};
 
 }
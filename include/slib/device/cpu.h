@@ -37,11 +37,18 @@ namespace slib
 
 #ifdef SLIB_ARCH_IS_X64
 		static sl_bool isSupportedSSE42() noexcept;
+
+		static sl_bool isSupportedAVX2() noexcept;
 #else
 		static constexpr sl_bool isSupportedSSE42()
 		{
 			return sl_false;
 		}
+
+		static constexpr sl_bool isSupportedAVX2()
+		{
+			return sl_false;
+		}
 #endif
 
 		static String getName();
@@ -81,6 +81,94 @@ namespace slib
 		)
 		#define curl_easy_strerror slib::curl::getApi_curl_easy_strerror()
 
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_easy_reset,
+			void, ,
+			CURL *curl
+		)
+		#define curl_easy_reset slib::curl::getApi_curl_easy_reset()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_init,
+			CURLM*,
+		)
+		#define curl_multi_init slib::curl::getApi_curl_multi_init()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_cleanup,
+			CURLMcode, ,
+			CURLM *multi_handle
+		)
+		#define curl_multi_cleanup slib::curl::getApi_curl_multi_cleanup()
+
+		#ifdef curl_multi_setopt
+		#undef curl_multi_setopt
+		#endif
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_setopt,
+			CURLMcode, ,
+			CURLM *multi_handle, CURLMoption option, ...
+		)
+		#define curl_multi_setopt slib::curl::getApi_curl_multi_setopt()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_add_handle,
+			CURLMcode, ,
+			CURLM *multi_handle, CURL *curl_handle
+		)
+		#define curl_multi_add_handle slib::curl::getApi_curl_multi_add_handle()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_remove_handle,
+			CURLMcode, ,
+			CURLM *multi_handle, CURL *curl_handle
+		)
+		#define curl_multi_remove_handle slib::curl::getApi_curl_multi_remove_handle()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_perform,
+			CURLMcode, ,
+			CURLM *multi_handle, int *running_handles
+		)
+		#define curl_multi_perform slib::curl::getApi_curl_multi_perform()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_wait,
+			CURLMcode, ,
+			CURLM *multi_handle, struct curl_waitfd extra_fds[], unsigned int extra_nfds, int timeout_ms, int *ret
+		)
+		#define curl_multi_wait slib::curl::getApi_curl_multi_wait()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_info_read,
+			CURLMsg*, ,
+			CURLM *multi_handle, int *msgs_in_queue
+		)
+		#define curl_multi_info_read slib::curl::getApi_curl_multi_info_read()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_init,
+			CURLSH*,
+		)
+		#define curl_share_init slib::curl::getApi_curl_share_init()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_cleanup,
+			CURLSHcode, ,
+			CURLSH *share
+		)
+		#define curl_share_cleanup slib::curl::getApi_curl_share_cleanup()
+
+		#ifdef curl_share_setopt
+		#undef curl_share_setopt
+		#endif
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_setopt,
+			CURLSHcode, ,
+			CURLSH *share, CURLSHoption option, ...
+		)
+		#define curl_share_setopt slib::curl::getApi_curl_share_setopt()
+
 		SLIB_IMPORT_LIBRARY_FUNCTION(
 			curl_slist_append,
 			struct curl_slist*, ,
@@ -263,6 +263,7 @@ namespace slib
 	class PdfImage;
 	class PdfOperation;
 	class Canvas;
+	class Bitmap;
 	class Image;
 	class Color;
 	class Brush;
@@ -1162,6 +1163,14 @@ namespace slib
 
 		Ref<PdfExternalObject> getExternalObject(const PdfReference& ref, PdfResourceCache& cache);
 
+		/*
+			Renders the pages [startIndex, startIndex + count) in parallel on a thread pool of `threadCount` workers (0: number of CPU cores).
+			Every page is fitted into `width` x `height` keeping its aspect ratio, and `callback` is invoked on the worker thread as soon as the page is rendered.
+			Fonts and images are decoded once and shared by all the pages through `cache` (created internally when null).
+			Returns `sl_false` when any page fails. Do not modify the document while rendering.
+		*/
+		sl_bool renderPages(sl_uint32 startIndex, sl_uint32 count, sl_uint32 width, sl_uint32 height, sl_uint32 threadCount, const Function<void(sl_uint32 pageIndex, Bitmap* bitmap)>& callback, const Ref<PdfResourceCache>& cache = sl_null);
+
 		sl_bool isEncrypted();
 
 		sl_bool isAuthenticated();
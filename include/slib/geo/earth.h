@@ -83,6 +83,19 @@ namespace slib
 
 		static GeoLocation getGeoLocation(const Double3& position);
 
+		static void getCartesianPositions(const double* latitudes, const double* longitudes, const double* altitudes, double* outX, double* outY, double* outZ, sl_size count, ThreadPool* threadPool = sl_null);
+
+		static void getGeoLocations(const double* x, const double* y, const double* z, double* outLatitudes, double* outLongitudes, double* outAltitudes, sl_size count, ThreadPool* threadPool = sl_null);
+
+		// great-circle distance on the sphere of the average radius, unit: m
+		static double getDistance(const LatLon& from, const LatLon& to);
+
+		static double getBearing(const LatLon& from, const LatLon& to);
+
+		static void getDistances(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outDistances, sl_size count, ThreadPool* threadPool = sl_null);
+
+		static void getBearings(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outBearings, sl_size count, ThreadPool* threadPool = sl_null);
+
 	};
 
 	// spherical earth
@@ -0,0 +1,155 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_GEO_RTREE
+#define CHECKHEADER_SLIB_GEO_RTREE
+
+#include "geo_rectangle.h"
+
+#include "../core/list.h"
+#include "../core/hash_map.h"
+#include "../core/function.h"
+
+/*
+	Spatial indexes of `LatLon` and `GeoRectangle` entries, identified by `sl_size` ids.
+
+	A `GeoRectangle` whose `bottomLeft.longitude` is greater than `topRight.longitude` crosses the antimeridian (for example, 170 ~ -170), both as an entry and as a query.
+	Such an entry is stored in two pieces, and is reported once by every query.
+	Distances are great-circle distances on the sphere of `SLIB_GEO_EARTH_AVERAGE_RADIUS`, unit: meter.
+*/
+
+namespace slib
+{
+
+	class SLIB_EXPORT GeoRTreeBox
+	{
+	public:
+		double south;
+		double west;
+		double north;
+		double east;
+	};
+
+	// Packed Hilbert R-tree. Built once from the arrays, immutable and thread-safe to query after building.
+	class SLIB_EXPORT GeoPackedRTree
+	{
+	public:
+		GeoPackedRTree();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(GeoPackedRTree)
+
+	public:
+		// id of each entry is the index in the arrays
+		sl_bool build(const double* latitudes, const double* longitudes, sl_size count, sl_uint32 nodeSize = 16);
+
+		sl_bool build(const LatLon* points, sl_size count, sl_uint32 nodeSize = 16);
+
+		sl_bool build(const GeoRectangle* rectangles, sl_size count, sl_uint32 nodeSize = 16);
+
+		sl_size getCount() const;
+
+		sl_bool isEmpty() const;
+
+		// Stops when `callback` returns `sl_false`
+		void search(const GeoRectangle& rect, const Function<sl_bool(sl_size id)>& callback) const;
+
+		List<sl_size> search(const GeoRectangle& rect) const;
+
+		void searchInRadius(const LatLon& center, double radius, const Function<sl_bool(sl_size id)>& callback) const;
+
+		List<sl_size> searchInRadius(const LatLon& center, double radius) const;
+
+		// ordered by the distance
+		List<sl_size> searchNearest(const LatLon& pt, sl_size count, double maxDistance = -1) const;
+
+	protected:
+		sl_bool _build(const GeoRTreeBox* boxes, const sl_size* ids, sl_size count, sl_uint32 nodeSize);
+
+	protected:
+		sl_size m_countItems;
+		sl_size m_countSlots;
+		sl_uint32 m_nodeSize;
+		// boxes of the item slots (sorted by Hilbert value), followed by the boxes of the nodes, level by level
+		List<GeoRTreeBox> m_boxes;
+		// item slot: id of the item, node slot: index of the first child slot
+		List<sl_size> m_indices;
+		// end of the slots of each level
+		List<sl_size> m_levelEnds;
+		// entries crossing the antimeridian
+		HashMap<sl_size, GeoRTreeBox> m_wrapped;
+
+	};
+
+	// Dynamic R*-tree. Not thread-safe.
+	class SLIB_EXPORT GeoRTree
+	{
+	public:
+		GeoRTree();
+
+		SLIB_DECLARE_MOVEONLY_CLASS_DEFAULT_MEMBERS(GeoRTree)
+
+	public:
+		sl_bool insert(const LatLon& pt, sl_size id);
+
+		sl_bool insert(const GeoRectangle& rect, sl_size id);
+
+		// `rect` should be same as the rectangle used for inserting
+		sl_bool remove(const LatLon& pt, sl_size id);
+
+		sl_bool remove(const GeoRectangle& rect, sl_size id);
+
+		void removeAll();
+
+		sl_size getCount() const;
+
+		sl_bool isEmpty() const;
+
+		void search(const GeoRectangle& rect, const Function<sl_bool(sl_size id)>& callback) const;
+
+		List<sl_size> search(const GeoRectangle& rect) const;
+
+		void searchInRadius(const LatLon& center, double radius, const Function<sl_bool(sl_size id)>& callback) const;
+
+		List<sl_size> searchInRadius(const LatLon& center, double radius) const;
+
+		List<sl_size> searchNearest(const LatLon& pt, sl_size count, double maxDistance = -1) const;
+
+	public:
+		class Node;
+
+	protected:
+		sl_bool _insert(const GeoRTreeBox& box, sl_size id);
+
+		sl_bool _remove(const GeoRTreeBox& box, sl_size id);
+
+		void _freeNode(Node* node);
+
+	protected:
+		Node* m_root;
+		sl_size m_count;
+		HashMap<sl_size, GeoRTreeBox> m_wrapped;
+
+	};
+
+}
+
+#endif
@@ -30,6 +30,8 @@
 namespace slib
 {
 
+	class ThreadPool;
+
 	// ellipsoid globe structure
 	class SLIB_EXPORT Globe
 	{
@@ -96,6 +98,17 @@ namespace slib
 
 		GeoLocation getGeoLocation(const Double3& position) const;
 
+		/*
+			Batched transforms on the arrays of coordinates (structure of arrays).
+			`altitudes` can be null for the points on the surface.
+			The arrays are split across `threadPool` when it is not null and the array is large.
+			Evaluated with SIMD polynomial approximations; compared to the single point functions, the positions differ by less than 1e-7 m and the angles by less than 1e-10 degrees (the longitudes of `getGeoLocations` by less than 1e-4 m along the parallel, where `getGeoLocation` loses the precision near the antimeridian), and the great-circle distances by less than 1e-5 m, which is the rounding error of the haversine formula for nearly antipodal points.
+			`getGeoLocations` uses Bowring's iteration and is valid for the points farther than 50 km from the center.
+		*/
+		void getCartesianPositions(const double* latitudes, const double* longitudes, const double* altitudes, double* outX, double* outY, double* outZ, sl_size count, ThreadPool* threadPool = sl_null) const;
+
+		void getGeoLocations(const double* x, const double* y, const double* z, double* outLatitudes, double* outLongitudes, double* outAltitudes, sl_size count, ThreadPool* threadPool = sl_null) const;
+
 	protected:
 		void _initializeParameters();
 
@@ -151,6 +164,17 @@ namespace slib
 
 		GeoLocation getGeoLocation(const Double3& position) const;
 
+		// great-circle distance by the haversine formula, unit: m
+		double getDistance(const LatLon& from, const LatLon& to) const;
+
+		// initial bearing on the great circle, clockwise from north, unit: degree [0, 360)
+		static double getBearing(const LatLon& from, const LatLon& to);
+
+		// batched versions of `getDistance` and `getBearing`, see `Globe::getCartesianPositions`
+		void getDistances(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outDistances, sl_size count, ThreadPool* threadPool = sl_null) const;
+
+		static void getBearings(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outBearings, sl_size count, ThreadPool* threadPool = sl_null);
+
 	};
 
 }
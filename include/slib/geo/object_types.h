@@ -31,7 +31,8 @@ namespace slib
 	{
 
 		enum {
-			Package_Geo = packages::Geo
+			Package_Geo = packages::Geo,
+			TiledDEM
 		};
 
 	}
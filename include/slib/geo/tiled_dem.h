@@ -0,0 +1,183 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_GEO_TILED_DEM
+#define CHECKHEADER_SLIB_GEO_TILED_DEM
+
+#include "definition.h"
+
+#include "geo_rectangle.h"
+#include "geo_location.h"
+
+#include "../core/object.h"
+#include "../core/array.h"
+#include "../core/memory.h"
+#include "../core/hash_map.h"
+#include "../core/function.h"
+#include "../core/mutex.h"
+#include "../io/file.h"
+
+#define SLIB_TILED_DEM_MAX_LEVEL_COUNT 32
+
+/*
+	Tiled digital elevation model stored in a file, for the elevation data which does not fit in memory.
+
+	Level 0 is the grid of `width` x `height` samples at the full resolution. The first sample is at the north-west corner of `bounds`, and the last one is at the south-east corner.
+	Every following level is an overview of the half resolution, until the level fits in one tile.
+	The levels are split into the square tiles of fixed size (32-bit float, little endian), which are loaded on demand into an LRU cache.
+	Locations outside of `bounds` are clamped to the edges.
+*/
+
+namespace slib
+{
+
+	class DEM;
+
+	enum class DEMInterpolation
+	{
+		Nearest = 0,
+		Bilinear = 1,
+		Bicubic = 2 // Catmull-Rom
+	};
+
+	class SLIB_EXPORT TiledDEMParam
+	{
+	public:
+		StringParam filePath;
+
+		sl_uint32 maxCachedTiles; // default: 256
+
+	public:
+		TiledDEMParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(TiledDEMParam)
+
+	};
+
+	class SLIB_EXPORT TiledDEM : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		TiledDEM();
+
+		~TiledDEM();
+
+	public:
+		typedef TiledDEMParam Param;
+
+		// `readRow` fills `width` samples of the row `y` (from north to south)
+		static sl_bool create(const StringParam& filePath, sl_uint32 width, sl_uint32 height, const GeoRectangle& bounds, const Function<sl_bool(sl_uint32 y, float* row)>& readRow, sl_uint32 tileSize = 256);
+
+		static sl_bool create(const StringParam& filePath, const float* data, sl_uint32 width, sl_uint32 height, const GeoRectangle& bounds, sl_uint32 tileSize = 256);
+
+		static sl_bool create(const StringParam& filePath, const DEM& dem, const GeoRectangle& bounds, sl_uint32 tileSize = 256);
+
+		static Ref<TiledDEM> open(const TiledDEMParam& param);
+
+		static Ref<TiledDEM> open(const StringParam& filePath);
+
+	public:
+		const GeoRectangle& getBounds();
+
+		sl_uint32 getTileSize();
+
+		sl_uint32 getLevelCount();
+
+		sl_uint32 getWidth(sl_uint32 level = 0);
+
+		sl_uint32 getHeight(sl_uint32 level = 0);
+
+		// Returns the coarsest level whose sample spacing (along the meridian) is not greater than `metersPerSample`
+		sl_uint32 getLevelForResolution(double metersPerSample);
+
+		float getAltitudeAt(const LatLon& location, DEMInterpolation interpolation = DEMInterpolation::Bilinear, sl_uint32 level = 0);
+
+		void getAltitudes(float* _out, const LatLon* locations, sl_size count, DEMInterpolation interpolation = DEMInterpolation::Bilinear, sl_uint32 level = 0);
+
+		void getAltitudes(float* _out, const double* latitudes, const double* longitudes, sl_size count, DEMInterpolation interpolation = DEMInterpolation::Bilinear, sl_uint32 level = 0);
+
+		// Samples `count` altitudes along the great circle from `start` to `end` (both inclusive)
+		void getProfile(float* _out, const LatLon& start, const LatLon& end, sl_uint32 count, DEMInterpolation interpolation = DEMInterpolation::Bilinear, sl_uint32 level = 0);
+
+		// Returns `sl_true` if the straight line between the two locations does not pass under the terrain. Samples the line at the half spacing of `level`.
+		sl_bool isVisible(const GeoLocation& from, const GeoLocation& to, sl_uint32 level = 0);
+
+		// Loads the tiles along the path (great circle segments) in the background, in the order of the path
+		void prefetchPath(const LatLon* points, sl_size count, sl_uint32 level = 0);
+
+		void clearCache();
+
+	protected:
+		struct Level
+		{
+			sl_uint32 width;
+			sl_uint32 height;
+			sl_uint32 countTilesX;
+			sl_uint32 countTilesY;
+			sl_uint64 offset;
+		};
+
+		struct CachedTile
+		{
+			sl_uint64 key;
+			Array<float> data;
+			sl_uint32 prev;
+			sl_uint32 next;
+		};
+
+		class Sampler;
+		friend class Sampler;
+
+		Array<float> _getTile(sl_uint32 level, sl_uint32 tx, sl_uint32 ty);
+
+		sl_bool _getCachedTile(sl_uint64 key, Array<float>& _out);
+
+		void _putCachedTile(sl_uint64 key, const Array<float>& data);
+
+		List<sl_uint64> _getTilesAlongPath(const LatLon* points, sl_size count, sl_uint32 level);
+
+		void _prefetchTiles(const List<sl_uint64>& tiles);
+
+	protected:
+		File m_file;
+		Mutex m_lockFile;
+
+		GeoRectangle m_bounds;
+		double m_widthDegrees;
+		double m_heightDegrees;
+		sl_uint32 m_tileSize;
+		sl_uint32 m_countLevels;
+		Level m_levels[SLIB_TILED_DEM_MAX_LEVEL_COUNT];
+
+		// LRU list of the loaded tiles, from the most recently used
+		Array<CachedTile> m_cache;
+		HashMap<sl_uint64, sl_uint32> m_mapCache;
+		sl_uint32 m_countCachedTiles;
+		sl_uint32 m_cacheHead;
+		sl_uint32 m_cacheTail;
+
+	};
+
+}
+
+#endif
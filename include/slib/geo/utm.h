@@ -30,6 +30,8 @@
 namespace slib
 {
 
+	class ThreadPool;
+
 	class SLIB_EXPORT UTMCoordinate
 	{
 	public:
@@ -70,6 +72,11 @@ namespace slib
 
 		LatLon getLatLon(const UTMCoordinate& coord) const;
 
+		// batched versions on the arrays of coordinates, see `Globe::getCartesianPositions`
+		void getCoordinates(const double* latitudes, const double* longitudes, double* outN, double* outE, sl_size count, ThreadPool* threadPool = sl_null) const;
+
+		void getLatLons(const double* N, const double* E, double* outLatitudes, double* outLongitudes, sl_size count, ThreadPool* threadPool = sl_null) const;
+
 	};
 
 }
@@ -31,6 +31,8 @@
 namespace slib
 {
 
+	class ThreadPool;
+
 	class SLIB_EXPORT ColorComponentBuffer
 	{
 	public:
@@ -118,6 +120,9 @@ namespace slib
 
 		void copyPixelsFrom(const BitmapData& other) const;
 
+		// converts horizontal bands concurrently on `threadPool` (`nBands`: 0 for the number of CPU cores)
+		void copyPixelsFrom(const BitmapData& other, ThreadPool* threadPool, sl_uint32 nBands = 0) const;
+
 		void setFromColors(sl_uint32 width, sl_uint32 height, const Color* colors, sl_reg stride = 0);
 
 	};
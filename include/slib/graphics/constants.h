@@ -114,6 +114,10 @@ namespace slib
 		Nearest = 0,
 		Linear = 1,
 		Box = 2,
+		// Separable fixed-point resampling (see `Image::resize`)
+		Mitchell = 3,
+		Lanczos3 = 4,
+		Area = 5,
 
 		Default = Box
 	};
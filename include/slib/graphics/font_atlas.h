@@ -27,6 +27,15 @@
 #include "bitmap.h"
 
 #include "../core/hash_map.h"
+#include "../core/list.h"
+
+/*
+	Glyphs are packed into the planes by the skyline bottom-left method.
+	When all `maxPlanes` are full, the least recently used plane is cleared and reused.
+	Characters below `SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT` are looked up without the object lock.
+*/
+
+#define SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT 256
 
 namespace slib
 {
@@ -43,6 +52,10 @@ namespace slib
 		sl_uint32 planeHeight;
 		sl_uint32 maxPlanes;
 
+		// Stores the glyphs as signed distance fields in the alpha channel (0.5 at the outline), to be drawn at any scale by alpha-testing. Color and stroke are ignored.
+		sl_bool flagSignedDistanceField;
+		sl_uint32 distanceFieldSpread; // In plane pixels
+
 	public:
 		FontAtlasBaseParam();
 
@@ -137,6 +150,12 @@ namespace slib
 
 		void removeAll();
 
+		sl_bool isSignedDistanceField();
+
+		sl_uint32 getDistanceFieldSpread();
+
+		sl_uint32 getPlaneCount();
+
 	protected:
 		void _initialize(const FontAtlasBaseParam& param, sl_real sourceHeight, sl_real fontHeight, sl_real strokeWidth, sl_uint32 planeWidth, sl_uint32 planeHeight);
 
@@ -146,9 +165,59 @@ namespace slib
 
 		virtual sl_bool _measureChar(sl_char32 ch, TextMetrics& metrics) = 0;
 
-		virtual Ref<Bitmap> _drawChar(sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) = 0;
+		virtual sl_bool _drawChar(Bitmap* plane, sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) = 0;
+
+		virtual Ref<Bitmap> _createPlane() = 0;
+
+	protected:
+		class SkylineSegment
+		{
+		public:
+			sl_uint32 x;
+			sl_uint32 y;
+			sl_uint32 width;
+		};
+
+		class Plane : public CRef
+		{
+		public:
+			Ref<Bitmap> bitmap;
+			List<SkylineSegment> skyline;
+			List<sl_char32> chars;
+			volatile sl_uint64 lastUsed;
+
+		public:
+			Plane(const Ref<Bitmap>& bitmap, sl_uint32 width);
+
+		public:
+			sl_bool findPosition(sl_uint32 width, sl_uint32 height, sl_uint32 planeWidth, sl_uint32 planeHeight, sl_uint32& outX, sl_uint32& outY);
+
+			void addRegion(sl_uint32 x, sl_uint32 y, sl_uint32 width, sl_uint32 height);
+
+			void reset(sl_uint32 width);
+		};
+
+		class Glyph : public FontAtlasChar
+		{
+		public:
+			Ref<Plane> plane;
+		};
+
+		class DirectChar : public CRef
+		{
+		public:
+			Glyph glyph;
+		};
+
+		sl_bool _getDirectChar(sl_char32 ch, sl_bool flagSizeOnly, FontAtlasChar& _out);
+
+		void _putGlyph(sl_char32 ch, const Glyph& glyph);
+
+		Ref<Plane> _allocateRegion(sl_uint32 width, sl_uint32 height, sl_uint32& outX, sl_uint32& outY);
+
+		void _clearPlane(Plane* plane);
 
-		virtual sl_bool _createPlane() = 0;
+		void _applyDistanceField(Bitmap* plane, sl_uint32 x, sl_uint32 y, sl_uint32 width, sl_uint32 height);
 
 	protected:
 		sl_real m_drawHeight;
@@ -160,12 +229,13 @@ namespace slib
 		sl_uint32 m_planeWidth;
 		sl_uint32 m_planeHeight;
 		sl_uint32 m_maxPlanes;
+		sl_bool m_flagSignedDistanceField;
+		sl_uint32 m_distanceFieldSpread;
 
-		CHashMap<sl_char32, FontAtlasChar> m_map;
-		sl_uint32 m_countPlanes;
-		sl_uint32 m_currentPlaneY;
-		sl_uint32 m_currentPlaneX;
-		sl_uint32 m_currentPlaneRowHeight;
+		CHashMap<sl_char32, Glyph> m_map;
+		List< Ref<Plane> > m_planes;
+		sl_uint64 m_clock;
+		AtomicRef<DirectChar> m_directChars[SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT];
 	};
 
 }
@@ -63,13 +63,12 @@ namespace slib
 
 		sl_bool _measureChar(sl_char32 ch, TextMetrics& _out) override;
 
-		Ref<Bitmap> _drawChar(sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) override;
+		sl_bool _drawChar(Bitmap* plane, sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) override;
 
-		sl_bool _createPlane() override;
+		Ref<Bitmap> _createPlane() override;
 
 	protected:
 		Ref<FreeType> m_font;
-		Ref<Image> m_currentPlane;
 	};
 
 }
@@ -192,6 +192,11 @@ namespace slib
 
 		Ref<Image> stretchToSmall(sl_uint32 sampleSize) const;
 
+		// High-quality separable resampling. Mitchell, Lanczos3 and Area run the fixed-point filter engine in horizontal strips on `threadPool`; other modes fall back to `draw`
+		static sl_bool resize(ImageDesc& dst, const ImageDesc& src, StretchMode stretch = StretchMode::Lanczos3, ThreadPool* threadPool = sl_null);
+
+		Ref<Image> resize(sl_uint32 width, sl_uint32 height, StretchMode stretch = StretchMode::Lanczos3, ThreadPool* threadPool = sl_null) const;
+
 		Ref<Image> rotateImage(RotationMode rotate, FlipMode flip = FlipMode::None) const;
 
 		Ref<Image> flipImage(FlipMode flip) const;
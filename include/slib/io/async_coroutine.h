@@ -0,0 +1,144 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_IO_ASYNC_COROUTINE
+#define CHECKHEADER_SLIB_IO_ASYNC_COROUTINE
+
+#include "async_stream.h"
+
+#include "../core/coroutine.h"
+#include "../core/memory.h"
+
+#ifdef SLIB_SUPPORT_COROUTINE
+
+namespace slib
+{
+
+	class SLIB_EXPORT AsyncStreamAwaitResult
+	{
+	public:
+		sl_size size;
+		AsyncStreamResultCode resultCode;
+
+	public:
+		sl_bool isSuccess() const noexcept
+		{
+			return resultCode == AsyncStreamResultCode::Success;
+		}
+
+		sl_bool isEnded() const noexcept
+		{
+			return resultCode == AsyncStreamResultCode::Ended;
+		}
+
+		sl_bool isError() const noexcept
+		{
+			return resultCode > AsyncStreamResultCode::Ended;
+		}
+
+	};
+
+	// resumes the coroutine inline in the I/O loop when the request is completed
+	class SLIB_EXPORT AsyncStreamAwaiter
+	{
+	public:
+		Ref<AsyncStream> stream;
+		void* data;
+		sl_size size;
+		Memory memory; // keeps the buffer
+		sl_bool flagRead;
+		sl_bool flagFully;
+		sl_int32 timeout;
+		AsyncStreamAwaitResult result;
+
+	public:
+		sl_bool await_ready() const noexcept
+		{
+			return stream.isNull();
+		}
+
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			AsyncStreamAwaitResult* pResult = &result;
+			Function<void(AsyncStreamResult&)> callback = [pResult, handle](AsyncStreamResult& r) {
+				pResult->size = r.size;
+				pResult->resultCode = r.resultCode;
+				handle.resume();
+			};
+			if (flagRead) {
+				if (flagFully) {
+					stream->readFully(data, size, callback, sl_null, timeout);
+				} else {
+					stream->read(data, size, callback, sl_null, timeout);
+				}
+			} else {
+				stream->write(data, size, callback, sl_null, timeout);
+			}
+		}
+
+		AsyncStreamAwaitResult await_resume() const noexcept
+		{
+			return result;
+		}
+
+	};
+
+	class SLIB_EXPORT AsyncStreamCoroutine
+	{
+	public:
+		static AsyncStreamAwaiter read(const Ref<AsyncStream>& stream, void* data, sl_size size, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, data, size, sl_null, sl_true, sl_false, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+		static AsyncStreamAwaiter read(const Ref<AsyncStream>& stream, const Memory& mem, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, mem.getData(), mem.getSize(), mem, sl_true, sl_false, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+		static AsyncStreamAwaiter readFully(const Ref<AsyncStream>& stream, void* data, sl_size size, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, data, size, sl_null, sl_true, sl_true, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+		static AsyncStreamAwaiter readFully(const Ref<AsyncStream>& stream, const Memory& mem, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, mem.getData(), mem.getSize(), mem, sl_true, sl_true, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+		static AsyncStreamAwaiter write(const Ref<AsyncStream>& stream, const void* data, sl_size size, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, (void*)data, size, sl_null, sl_false, sl_false, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+		static AsyncStreamAwaiter write(const Ref<AsyncStream>& stream, const Memory& mem, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncStreamAwaiter{stream, mem.getData(), mem.getSize(), mem, sl_false, sl_false, timeout, {0, AsyncStreamResultCode::Unknown}};
+		}
+
+	};
+
+}
+
+#endif
+
+#endif
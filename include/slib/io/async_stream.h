@@ -165,6 +165,15 @@ namespace slib
 
 		static Ref<AsyncStream> create(AsyncStreamInstance* instance, AsyncIoMode mode);
 
+		// I/O buffers are allocated from `MemoryPool` when enabled (disabled by default). Can be changed at any time: the buffers already allocated are released to where they came from
+		static sl_bool isUsingMemoryPool();
+
+		static void setUsingMemoryPool(sl_bool flag);
+
+		static Memory createBuffer(sl_size size);
+
+		static Memory createBuffer(const void* data, sl_size size);
+
 	public:
 		virtual sl_bool requestIo(AsyncStreamRequest* request) = 0;
 
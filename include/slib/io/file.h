@@ -240,6 +240,9 @@ namespace slib
 
 		sl_int32 read32(void* buf, sl_uint32 size, sl_int32 timeout = -1) const noexcept;
 
+		// Reads at `offset` in one call (pread, overlapped ReadFile), so that the concurrent reads on the same handle do not interfere. The current position is not defined after the call.
+		sl_int32 readPositional32(sl_uint64 offset, void* buf, sl_uint32 size) const noexcept;
+
 		sl_reg write(const void* buf, sl_size size, sl_int32 timeout = -1) const noexcept;
 
 		sl_int32 write32(const void* buf, sl_uint32 size, sl_int32 timeout = -1) const noexcept;
@@ -369,6 +372,9 @@ namespace slib
 
 		static Memory readAllBytes(const StringParam& path, sl_size maxSize = SLIB_SIZE_MAX) noexcept;
 
+		// Maps the whole file into the memory for reading. The pages are shared with the other processes mapping the same file, and unmapped when the returned memory is released.
+		static Memory mapAllBytes(const StringParam& path) noexcept;
+
 		static String readAllTextUTF8(const StringParam& path, sl_size maxSize = SLIB_SIZE_MAX) noexcept;
 
 		static String16 readAllTextUTF16(const StringParam& path, EndianType endian = Endian::Little, sl_size maxSize = SLIB_SIZE_MAX) noexcept;
@@ -0,0 +1,225 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_ASYNC_COROUTINE
+#define CHECKHEADER_SLIB_NETWORK_ASYNC_COROUTINE
+
+#include "async.h"
+
+#include "../io/async_coroutine.h"
+#include "../core/linked_list.h"
+
+#ifdef SLIB_SUPPORT_COROUTINE
+
+namespace slib
+{
+
+	class SLIB_EXPORT AsyncTcpConnectAwaiter
+	{
+	public:
+		Ref<AsyncTcpSocket> socket;
+		SocketAddress address;
+		sl_int32 timeout;
+		sl_bool flagSuccess;
+
+	public:
+		sl_bool await_ready() const noexcept
+		{
+			return socket.isNull();
+		}
+
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			sl_bool* pSuccess = &flagSuccess;
+			socket->connect(address, [pSuccess, handle](AsyncTcpSocket*, sl_bool flagError) {
+				*pSuccess = !flagError;
+				handle.resume();
+			}, timeout);
+		}
+
+		sl_bool await_resume() const noexcept
+		{
+			return flagSuccess;
+		}
+
+	};
+
+	class SLIB_EXPORT AsyncSocketCoroutine
+	{
+	public:
+		static AsyncTcpConnectAwaiter connect(const Ref<AsyncTcpSocket>& socket, const SocketAddress& address, sl_int32 timeout = -1) noexcept
+		{
+			return AsyncTcpConnectAwaiter{socket, address, timeout, sl_false};
+		}
+
+	};
+
+	// Queues the connections accepted by `AsyncTcpServer`, and passes them to the coroutine awaiting `accept()`
+	class SLIB_EXPORT AsyncTcpAcceptor : public CRef
+	{
+	public:
+		class Awaiter
+		{
+		public:
+			AsyncTcpAcceptor* acceptor;
+			Socket* socket;
+			SocketAddress* address;
+			std::coroutine_handle<> handle;
+			sl_bool flagSuccess;
+
+		public:
+			sl_bool await_ready() noexcept
+			{
+				return sl_false;
+			}
+
+			sl_bool await_suspend(std::coroutine_handle<> _handle) noexcept
+			{
+				SpinLocker locker(&(acceptor->m_lock));
+				if (acceptor->m_flagClosed) {
+					flagSuccess = sl_false;
+					return sl_false;
+				}
+				Item item;
+				if (acceptor->m_queue.popFront_NoLock(&item)) {
+					*socket = Move(item.socket);
+					*address = item.address;
+					flagSuccess = sl_true;
+					return sl_false;
+				}
+				handle = _handle;
+				acceptor->m_waiter = this;
+				return sl_true;
+			}
+
+			sl_bool await_resume() const noexcept
+			{
+				return flagSuccess;
+			}
+
+		};
+
+	public:
+		~AsyncTcpAcceptor()
+		{
+			close();
+		}
+
+	public:
+		// `param.onAccept` is replaced by the acceptor
+		static Ref<AsyncTcpAcceptor> create(AsyncTcpServerParam& param)
+		{
+			Ref<AsyncTcpAcceptor> ret = new AsyncTcpAcceptor;
+			if (ret.isNull()) {
+				return sl_null;
+			}
+			WeakRef<AsyncTcpAcceptor> weak = ret;
+			param.onAccept = [weak](AsyncTcpServer*, Socket& socket, SocketAddress& address) {
+				Ref<AsyncTcpAcceptor> acceptor = weak;
+				if (acceptor.isNotNull()) {
+					acceptor->_onAccept(socket, address);
+				}
+			};
+			ret->m_server = AsyncTcpServer::create(param);
+			if (ret->m_server.isNull()) {
+				return sl_null;
+			}
+			return ret;
+		}
+
+	public:
+		const Ref<AsyncTcpServer>& getServer() const noexcept
+		{
+			return m_server;
+		}
+
+		// `co_await` returns `false` when the acceptor is closed
+		Awaiter accept(Socket& socket, SocketAddress& address) noexcept
+		{
+			return Awaiter{this, &socket, &address, sl_null, sl_false};
+		}
+
+		// closes the server, and resumes the awaiting coroutine with `false`
+		void close()
+		{
+			Ref<AsyncTcpServer> server = Move(m_server);
+			if (server.isNotNull()) {
+				server->close();
+			}
+			SpinLocker locker(&m_lock);
+			m_flagClosed = sl_true;
+			m_queue.removeAll_NoLock();
+			Awaiter* waiter = m_waiter;
+			if (waiter) {
+				m_waiter = sl_null;
+				locker.unlock();
+				waiter->flagSuccess = sl_false;
+				waiter->handle.resume();
+			}
+		}
+
+	protected:
+		AsyncTcpAcceptor(): m_waiter(sl_null), m_flagClosed(sl_false) {}
+
+	protected:
+		void _onAccept(Socket& socket, SocketAddress& address)
+		{
+			SpinLocker locker(&m_lock);
+			if (m_flagClosed) {
+				return;
+			}
+			Awaiter* waiter = m_waiter;
+			if (waiter) {
+				m_waiter = sl_null;
+				locker.unlock();
+				*(waiter->socket) = Move(socket);
+				*(waiter->address) = address;
+				waiter->flagSuccess = sl_true;
+				waiter->handle.resume();
+			} else {
+				Item item;
+				item.socket = Move(socket);
+				item.address = address;
+				m_queue.pushBack_NoLock(Move(item));
+			}
+		}
+
+	protected:
+		struct Item
+		{
+			Socket socket;
+			SocketAddress address;
+		};
+
+		Ref<AsyncTcpServer> m_server;
+		SpinLock m_lock;
+		LinkedList<Item> m_queue;
+		Awaiter* m_waiter;
+		sl_bool m_flagClosed;
+
+	};
+
+}
+
+#endif
+
+#endif
@@ -99,6 +99,21 @@ namespace slib
 
 		static Ref<UrlRequest> postJsonSynchronous(const String& url, const HttpHeaderMap& headers, const Json& json);
 
+	public:
+		/*
+			When the multi engine is enabled, the requests are driven by a single `curl_multi` handle on the engine thread.
+			The engine reuses the easy handles per host, shares the DNS, connection and SSL session caches,
+			and queues the requests exceeding the limit of the concurrent transfers per host.
+			The callbacks without the dispatcher are invoked on the engine thread.
+		*/
+		static sl_bool isMultiEngineEnabled();
+
+		static void setMultiEngineEnabled(sl_bool flag);
+
+		static sl_uint32 getMaximumConnectionsPerHost();
+
+		static void setMaximumConnectionsPerHost(sl_uint32 n);
+
 	protected:
 		static Ref<UrlRequest> _create(const UrlRequestParam& param, const String& url);
 
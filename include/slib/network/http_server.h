@@ -29,6 +29,7 @@
 
 #include "../core/property.h"
 #include "../core/shared.h"
+#include "../core/timing_wheel.h"
 #include "../io/io.h"
 #include "../crypto/tls.h"
 
@@ -169,6 +170,7 @@ namespace slib
 		sl_bool m_flagKeepAlive;
 		List<char> m_bufReadUnprocessed;
 		sl_uint64 m_timeLastRead;
+		sl_uint64 m_idExpiringDeadline; // entry in the connection deadlines of the server
 
 	protected:
 		void _free();
@@ -469,7 +471,8 @@ namespace slib
 
 		void _onTimerExpireConnections(Timer*);
 
-		sl_bool _isConnectionExpiring(HttpServerConnection* connection, sl_uint64 currentTick);
+		// returns the next deadline, or 0 when the connection is expired
+		sl_uint64 _checkConnectionDeadline(HttpServerConnection* connection, sl_uint64 currentTick);
 
 	protected:
 		AtomicRef<AsyncIoLoop> m_ioLoop;
@@ -479,6 +482,7 @@ namespace slib
 
 		CHashMap< HttpServerConnection*, Ref<HttpServerConnection> > m_connections;
 		Ref<Timer> m_timerExpireConnections;
+		TimingWheel m_connectionDeadlines;
 
 		CList< Ref<HttpServerConnectionProvider> > m_connectionProviders;
 
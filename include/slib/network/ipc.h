@@ -71,6 +71,9 @@ namespace slib
 		sl_uint32 maximumMessageSize;
 		sl_uint32 messageSegmentSize;
 
+		// Linux: size of each shared memory ring (rounded up to the page size). 0 disables the shared memory transport
+		sl_uint32 sharedMemorySize;
+
 		Function<void(IPCResponseMessage&)> onResponse;
 
 	public:
@@ -151,6 +154,7 @@ namespace slib
 		sl_uint32 maximumMessageSize;
 		sl_uint32 messageSegmentSize;
 		sl_bool flagAcceptOtherUsers; // default: true
+		sl_bool flagSharedMemory; // Linux: accepts the shared memory transport besides the domain socket, default: false
 
 		Function<void(IPCRequestMessage&, IPCResponseMessage&)> onReceiveMessage;
 
@@ -196,13 +200,15 @@ namespace slib
 
 		void onReceiveRequest(AsyncStream*, Memory& data, sl_bool flagError);
 
-		void processRequest(AsyncStream*, const Memory& data);
-
-		void sendResponse(AsyncStream*, const Memory& data);
-
 		void onSentResponse(AsyncStream*, sl_bool flagError);
 
 	protected:
+		virtual void processRequest(AsyncStream*, const Memory& data);
+
+		virtual void sendResponse(AsyncStream*, const Memory& data);
+
+		virtual void closeStream(AsyncStream*);
+
 		virtual void prepareRequest(AsyncStream*, IPCRequestMessage&);
 
 	protected:
@@ -24,6 +24,7 @@
 #define CHECKHEADER_SLIB_NETWORK_SMB
 
 #include "socket.h"
+#include "async.h"
 #include "smb_constant.h"
 
 #include "../core/thread_pool.h"
@@ -158,7 +159,8 @@ namespace slib
 
 			HashMap< String16, Ref<Share>, Hash_IgnoreCase<String16>, Compare_IgnoreCase<String16> > shares;
 
-			sl_uint32 maxThreadCount;
+			Ref<AsyncIoLoop> ioLoop; // optional
+			sl_uint32 maxThreadCount; // worker threads running the file I/O
 			sl_bool flagStopWindowsService;
 
 			sl_bool flagAutoStart;
@@ -194,11 +196,11 @@ namespace slib
 		const Param& getParam();
 
 	protected:
-		void _onRunListen();
-
-		void _onRunClient(const Socket& socket);
+		void _onAccept(Socket& socket);
 
 	public:
+		class Connection;
+
 		class Session
 		{
 		public:
@@ -219,19 +221,14 @@ namespace slib
 			Ref<FileContext> getFile(sl_uint64 fileId) noexcept;
 		};
 
-		class Connection
-		{
-		public:
-			const Socket* socket;
-			SocketEvent* event;
-		};
-
-		class IOParam : public Connection
+		class IOParam
 		{
 		public:
+			Connection* connection;
 			sl_uint8* data;
 			sl_uint32 size;
 			Session* session;
+			MemoryBuffer* output; // responses of the message, sent as one NetBIOS frame
 		};
 
 		class SmbParam : public IOParam
@@ -244,11 +241,12 @@ namespace slib
 		{
 		public:
 			Smb2Header* smb;
-			void* chain;
 			sl_uint64 lastCreatedFileId;
 		};
 
 	protected:
+		void _processMessage(Connection* connection, const Memory& message);
+
 		sl_bool _onProcessMessage(IOParam& param);
 
 		sl_bool _onProcessSMB(SmbParam& param);
@@ -286,8 +284,10 @@ namespace slib
 		sl_bool m_flagRunning;
 
 		Socket m_socketListen;
-		AtomicRef<Thread> m_threadListen;
+		Ref<AsyncIoLoop> m_ioLoop;
+		AtomicRef<AsyncTcpServer> m_server;
 		AtomicRef<ThreadPool> m_threadPool;
+		CHashMap< Connection*, Ref<Connection> > m_connections;
 
 		Param m_param;
 
@@ -43,6 +43,7 @@ namespace slib
 		Unsuccessful = 0xc0000001,
 		NotImplemented = 0xc0000002,
 		InvalidInfoClass = 0xc0000003,
+		InvalidParameter = 0xc000000d,
 		InvalidDeviceRequest = 0xc0000010,
 		EndOfFile = 0xc0000011,
 		MoreProcessingRequired = 0xc0000016,
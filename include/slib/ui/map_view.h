@@ -36,6 +36,7 @@ namespace slib
 	class MapSurface;
 	class MapTileLoader;
 	class MapViewObject;
+	class MapViewObjectList;
 	class MapViewExtension;
 
 	class SLIB_EXPORT MapViewState
@@ -26,6 +26,7 @@
 #include "map_view.h"
 
 #include "../geo/geo_rectangle.h"
+#include "../geo/geo_rtree.h"
 #include "../geo/dem.h"
 #include "../math/triangle.h"
 #include "../render/program_ext.h"
@@ -619,6 +620,13 @@ namespace slib
 
 		virtual Ref<MapViewObject> getObjectAt(MapViewData* data, MapPlane* plane, const Point& pt);
 
+		// Used for culling in `MapViewObjectList`. Returns `sl_false` for the objects which are always drawn.
+		virtual sl_bool getBounds(GeoRectangle& _out);
+
+	protected:
+		// Call after the bounds are changed, to update the culling index of the parent list
+		void invalidateBounds();
+
 	public:
 		SLIB_PROPERTY_FUNCTION(void(const Point& pt), OnClick)
 		SLIB_PROPERTY_FUNCTION(void(const Point& pt), OnRightButtonClick)
@@ -632,6 +640,12 @@ namespace slib
 		double m_maxEyeAltitude;
 		AtomicString m_toolTip;
 		AtomicRef<Cursor> m_cursor;
+
+		// the list which added this object last, and the index in it
+		AtomicWeakRef<MapViewObjectList> m_parent;
+		sl_size m_indexInParent;
+
+		friend class MapViewObjectList;
 	};
 
 	class SLIB_EXPORT MapViewObjectList : public MapViewObject
@@ -646,6 +660,9 @@ namespace slib
 	public:
 		void addChild(const Ref<MapViewObject>& child);
 
+		// Call after the bounds of the child are changed. Not needed for the changes made by the setters of the child.
+		void updateChild(const Ref<MapViewObject>& child);
+
 		void removeAll();
 
 	public:
@@ -655,8 +672,25 @@ namespace slib
 
 		Ref<MapViewObject> getObjectAt(MapViewData* data, MapPlane* plane, const Point& pt) override;
 
+	protected:
+		/*
+			Returns the indices of the children which can be visible (in drawing order), or `sl_false` to visit all children.
+			The children beyond the horizon (objects lower than 20km) are culled in the globe mode.
+		*/
+		sl_bool _getVisibleChildren(MapViewData* data, MapPlane* plane, List<sl_size>& _out);
+
+		void _updateChild(MapViewObject* child, sl_size index);
+
 	protected:
 		List< Ref<MapViewObject> > m_children;
+		// bounds of the children at `addChild`, `updateChild` or `MapViewObject::invalidateBounds()`
+		List<GeoRectangle> m_childBounds;
+		List<sl_bool> m_childBoundsFlags;
+		GeoRTree m_index;
+		// children without bounds
+		List<sl_size> m_unboundedChildren;
+
+		friend class MapViewObject;
 	};
 
 	class MapViewObjectLocation
@@ -745,6 +779,8 @@ namespace slib
 
 		sl_bool getViewPoint(Point& _out, MapViewData* data);
 
+		sl_bool getBounds(GeoRectangle& _out) override;
+
 	protected:
 		void onPreDrawOrRender(MapViewData* data);
 
@@ -807,6 +843,8 @@ namespace slib
 
 		void render(RenderEngine* engine, MapViewData* data, MapSurface* surface) override;
 
+		sl_bool getBounds(GeoRectangle& _out) override;
+
 	public:
 		MapViewObjectLocation m_startLocation;
 		MapViewObjectLocation m_endLocation;
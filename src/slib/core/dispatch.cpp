@@ -98,13 +98,6 @@ namespace slib
 	}
 
 
-	SLIB_DEFINE_NESTED_CLASS_DEFAULT_MEMBERS(DispatchLoop, TimerTask)
-
-	DispatchLoop::TimerTask::TimerTask()
-	{
-	}
-
-
 	SLIB_DEFINE_OBJECT(DispatchLoop, Dispatcher)
 
 	DispatchLoop::DispatchLoop()
@@ -174,8 +167,7 @@ namespace slib
 	{
 		ThreadService::release();
 		m_queueTasks.removeAll();
-		m_timeTasks.removeAll();
-		m_queueTimers.removeAll();
+		m_timers.removeAll();
 	}
 
 	void DispatchLoop::_wake()
@@ -188,20 +180,23 @@ namespace slib
 
 	sl_int32 DispatchLoop::_getTimeout()
 	{
-		sl_int32 t1 = _getTimeout_TimeTasks();
-		sl_int32 t2 = _getTimeout_Timer();
+		m_timers.advance(getElapsedMilliseconds());
 		if (m_queueTasks.isNotEmpty()) {
 			return 0;
 		}
-		if (t1 < 0) {
-			return t2;
-		} else {
-			if (t2 < 0) {
-				return t1;
-			} else {
-				return SLIB_MIN(t1, t2);
-			}
+		sl_int64 timeNext = m_timers.getNextExpireTime();
+		if (timeNext < 0) {
+			return -1;
+		}
+		sl_uint64 now = getElapsedMilliseconds();
+		if ((sl_uint64)timeNext <= now) {
+			return 0;
+		}
+		sl_uint64 timeout = (sl_uint64)timeNext - now;
+		if (timeout > 0x7FFFFFFF) {
+			return 0x7FFFFFFF;
 		}
+		return (sl_int32)timeout;
 	}
 
 	sl_bool DispatchLoop::dispatch(const Function<void()>& task, sl_uint64 delayMillis)
@@ -215,10 +210,7 @@ namespace slib
 				return sl_true;
 			}
 		} else {
-			TimeTask tt;
-			tt.time = getElapsedMilliseconds() + delayMillis;
-			tt.task = task;
-			if (m_timeTasks.add(tt.time, tt)) {
+			if (m_timers.add(getElapsedMilliseconds() + delayMillis, task)) {
 				_wake();
 				return sl_true;
 			}
@@ -226,104 +218,47 @@ namespace slib
 		return sl_false;
 	}
 
-	sl_int32 DispatchLoop::_getTimeout_TimeTasks()
+	sl_bool DispatchLoop::addTimer(const Ref<Timer>& timer)
 	{
-		ObjectLocker lock(&m_timeTasks);
-		sl_uint64 rel = getElapsedMilliseconds();
-		if (m_timeTasks.isEmpty()) {
-			return -1;
-		}
-		sl_int32 timeout = -1;
-		LinkedQueue< Function<void()> > tasks;
-		while (MapNode<sl_uint64, TimeTask>* node = m_timeTasks.getFirstNode()) {
-			if (rel >= node->key) {
-				tasks.push_NoLock(node->value.task);
-				m_timeTasks.removeAt(node);
-			} else {
-				timeout = (sl_int32)(node->key - rel);
-				break;
-			}
+		if (timer.isNull()) {
+			return sl_false;
 		}
-		lock.unlock();
-
-		Function<void()> task;
-		while (tasks.pop_NoLock(&task)) {
-			task();
+		sl_uint64 now = getElapsedMilliseconds();
+		WeakRef<Timer> weak = timer;
+		ObjectLocker lock(&m_timers);
+		if (timer->m_idLoopEntry) {
+			m_timers.remove_NoLock(timer->m_idLoopEntry);
 		}
-		return timeout;
-	}
-
-	sl_int32 DispatchLoop::_getTimeout_Timer()
-	{
-		ObjectLocker lock(&m_queueTimers);
-
-		sl_int32 timeout = -1;
-		LinkedQueue< Ref<Timer> > tasks;
-
-		sl_uint64 rel = getElapsedMilliseconds();
-		Link<TimerTask>* link = m_queueTimers.getFront();
-		while (link) {
-			Ref<Timer> timer(link->value.timer);
-			if (timer.isNotNull()) {
-				if (timer->isStarted()) {
-					sl_uint64 t = rel - timer->getLastRunTime();
-					if (t >= timer->getInterval()) {
-						tasks.push_NoLock(timer);
-						timer->setLastRunTime(rel);
-						t = timer->getInterval();
-					} else {
-						t = timer->getInterval() - t;
-					}
-					if (timeout < 0 || t < (sl_uint64)timeout) {
-						timeout = (sl_uint32)t;
-					}
-				}
-				link = link->next;
-			} else {
-				Link<TimerTask>* linkRemove = link;
-				link = link->next;
-				m_queueTimers.removeAt(linkRemove);
+		timer->setLastRunTime(now);
+		timer->m_idLoopEntry = m_timers.addDeadline_NoLock(now + timer->getInterval(), [weak](sl_uint64 time) -> sl_uint64 {
+			Ref<Timer> timer = weak;
+			if (timer.isNull() || !(timer->isStarted())) {
+				return 0;
 			}
+			timer->setLastRunTime(time);
+			timer->run();
+			return time + timer->getInterval();
+		});
+		if (!(timer->m_idLoopEntry)) {
+			return sl_false;
 		}
-
 		lock.unlock();
-
-		Ref<Timer> task;
-		while (tasks.pop_NoLock(&task)) {
-			if (task.isNotNull()) {
-				task->run();
-			}
-		}
-		return timeout;
-	}
-
-	sl_bool DispatchLoop::TimerTask::operator==(const DispatchLoop::TimerTask& other) const noexcept
-	{
-		return timer == other.timer;
+		_wake();
+		return sl_true;
 	}
 
-	sl_bool DispatchLoop::addTimer(const Ref<Timer>& timer)
+	void DispatchLoop::removeTimer(const Ref<Timer>& timer)
 	{
 		if (timer.isNull()) {
-			return sl_false;
+			return;
 		}
-		TimerTask t;
-		t.timer = timer;
-		if (m_queueTimers.push(t)) {
-			_wake();
-			return sl_true;
-		} else {
-			return sl_false;
+		ObjectLocker lock(&m_timers);
+		if (timer->m_idLoopEntry) {
+			m_timers.remove_NoLock(timer->m_idLoopEntry);
+			timer->m_idLoopEntry = 0;
 		}
 	}
 
-	void DispatchLoop::removeTimer(const Ref<Timer>& timer)
-	{
-		TimerTask t;
-		t.timer = timer;
-		m_queueTimers.remove(t);
-	}
-
 	sl_uint64 DispatchLoop::getElapsedMilliseconds()
 	{
 		return m_timeCounter.getElapsedMilliseconds();
@@ -159,7 +159,7 @@ namespace slib
 	namespace {
 		static String GetLineStringCRLF(const StringParam& tag, const StringParam& content)
 		{
-			return String::format("%s [%s] %s\r\n", Time::now(), tag, content);
+			return String::format("%s [%s] %s\r\n", CachedTimeText::getLocalString(), tag, content);
 		}
 	}
 
@@ -190,13 +190,13 @@ namespace slib
 	namespace {
 		static String GetLineString(const StringParam& tag, const StringParam& content)
 		{
-			return String::format("%s [%s] %s\n", Time::now(), tag, content);
+			return String::format("%s [%s] %s\n", CachedTimeText::getLocalString(), tag, content);
 		}
 
 #ifdef SLIB_PLATFORM_IS_WIN32
 		static String16 GetLineString16(const StringParam& tag, const StringParam& content)
 		{
-			return String16::format(SLIB_UNICODE("%s [%s] %s\n"), Time::now(), tag, content);
+			return String16::format(SLIB_UNICODE("%s [%s] %s\n"), CachedTimeText::getLocalString(), tag, content);
 		}
 
 		static void PrintError(const void* data, sl_size size)
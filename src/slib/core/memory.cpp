@@ -23,6 +23,7 @@
 #include "slib/core/memory.h"
 #include "slib/core/memory_buffer.h"
 #include "slib/core/memory_queue.h"
+#include "slib/core/memory_pool.h"
 
 #include "slib/core/string_buffer.h"
 #include "slib/core/stringx.h"
@@ -132,6 +133,56 @@ namespace slib
 			return sl_null;
 		}
 
+		class PooledMemory : public CMemory
+		{
+		public:
+			PooledMemory(void* _data, sl_size _size) noexcept: CMemory(_data, _size), m_block(_data), m_sizeBlock(_size) {}
+
+		protected:
+			void free() override
+			{
+				_clearWeak();
+				void* block = m_block;
+				sl_size sizeBlock = m_sizeBlock;
+				this->~PooledMemory();
+				MemoryPool::free(block, sizeBlock);
+				MemoryPool::free(this, sizeof(PooledMemory));
+			}
+
+		private:
+			void* m_block;
+			sl_size m_sizeBlock;
+
+		};
+
+		static CMemory* CreatePooled(sl_size size) noexcept
+		{
+			if (MemoryPool::getSizeClass(size) < 0) {
+				return Create(size);
+			}
+			void* mem = MemoryPool::allocate(sizeof(PooledMemory));
+			if (mem) {
+				void* data = MemoryPool::allocate(size);
+				if (data) {
+					return new (mem) PooledMemory(data, size);
+				}
+				MemoryPool::free(mem, sizeof(PooledMemory));
+			}
+			return sl_null;
+		}
+
+		static CMemory* CreatePooled(const void* data, sl_size size) noexcept
+		{
+			CMemory* ret = CreatePooled(size);
+			if (ret) {
+				if (data) {
+					Base::copyMemory(ret->data, data, size);
+				}
+				return ret;
+			}
+			return sl_null;
+		}
+
 		class StaticMemory : public CMemory
 		{
 		public:
@@ -534,6 +585,16 @@ namespace slib
 		return CreateNoCopy(buf, size);
 	}
 
+	Memory Memory::createPooled(sl_size size) noexcept
+	{
+		return CreatePooled(size);
+	}
+
+	Memory Memory::createPooled(const void* buf, sl_size size) noexcept
+	{
+		return CreatePooled(buf, size);
+	}
+
 	Memory Memory::createStatic(const void* buf, sl_size size) noexcept
 	{
 		return CreateStatic(buf, size);
@@ -0,0 +1,385 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/memory_pool.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+// maximum bytes of the free blocks kept by a thread per size class
+#define THREAD_CACHE_MAX_BYTES 0x40000
+// maximum bytes of the free blocks kept in the shared list per size class
+#define SHARED_LIST_MAX_BYTES 0x800000
+// bytes moved between a thread cache and the shared list at once
+#define TRANSFER_BYTES 0x10000
+
+namespace slib
+{
+
+	namespace
+	{
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		struct ThreadFreeList
+		{
+			FreeBlock* first;
+			sl_size count;
+			sl_uint64 countHit;
+			sl_uint64 countMiss;
+		};
+
+		struct SharedFreeList
+		{
+			SpinLock lock;
+			FreeBlock* first;
+			sl_size count;
+			// counters of the exited threads and of the allocations without the thread cache
+			sl_uint64 countHit;
+			sl_uint64 countMiss;
+		};
+
+		static SharedFreeList g_sharedLists[SLIB_MEMORY_POOL_SIZE_CLASS_COUNT];
+
+		static sl_size GetBlockSize(sl_uint32 sizeClass)
+		{
+			return ((sl_size)SLIB_MEMORY_POOL_MIN_SIZE) << sizeClass;
+		}
+
+		static sl_size GetThreadCacheLimit(sl_uint32 sizeClass)
+		{
+			sl_size n = THREAD_CACHE_MAX_BYTES / GetBlockSize(sizeClass);
+			return n < 2 ? 2 : n;
+		}
+
+		static sl_size GetSharedListLimit(sl_uint32 sizeClass)
+		{
+			return SHARED_LIST_MAX_BYTES / GetBlockSize(sizeClass);
+		}
+
+		static sl_size GetTransferCount(sl_uint32 sizeClass)
+		{
+			sl_size n = TRANSFER_BYTES / GetBlockSize(sizeClass);
+			if (n < 1) {
+				return 1;
+			}
+			if (n > 64) {
+				return 64;
+			}
+			return n;
+		}
+
+		static void FreeBlocks(FreeBlock* block)
+		{
+			while (block) {
+				FreeBlock* next = block->next;
+				Base::freeMemory(block);
+				block = next;
+			}
+		}
+
+		// `first` ~ `last` are linked
+		static void PushShared(sl_uint32 sizeClass, FreeBlock* first, FreeBlock* last, sl_size count)
+		{
+			SharedFreeList& list = g_sharedLists[sizeClass];
+			FreeBlock* blocksToFree = sl_null;
+			{
+				SpinLocker lock(&(list.lock));
+				sl_size limit = GetSharedListLimit(sizeClass);
+				if (list.count + count <= limit) {
+					last->next = list.first;
+					list.first = first;
+					list.count += count;
+				} else {
+					last->next = sl_null;
+					blocksToFree = first;
+				}
+			}
+			FreeBlocks(blocksToFree);
+		}
+
+		class ThreadCache
+		{
+		public:
+			ThreadFreeList lists[SLIB_MEMORY_POOL_SIZE_CLASS_COUNT];
+			ThreadCache* previous;
+			ThreadCache* next;
+
+		public:
+			ThreadCache();
+
+			~ThreadCache();
+
+		public:
+			void flush(sl_uint32 sizeClass, sl_size countRemain)
+			{
+				ThreadFreeList& list = lists[sizeClass];
+				if (list.count <= countRemain) {
+					return;
+				}
+				FreeBlock* first = list.first;
+				FreeBlock* last = first;
+				sl_size n = list.count - countRemain;
+				for (sl_size i = 1; i < n; i++) {
+					last = last->next;
+				}
+				list.first = last->next;
+				list.count = countRemain;
+				PushShared(sizeClass, first, last, n);
+			}
+
+		};
+
+		SLIB_STATIC_SPINLOCK(g_lockThreadCaches)
+		static ThreadCache* g_firstThreadCache = sl_null;
+
+		ThreadCache::ThreadCache()
+		{
+			Base::zeroMemory(lists, sizeof(lists));
+			previous = sl_null;
+			SpinLocker lock(&g_lockThreadCaches);
+			next = g_firstThreadCache;
+			if (next) {
+				next->previous = this;
+			}
+			g_firstThreadCache = this;
+		}
+
+		ThreadCache::~ThreadCache()
+		{
+			for (sl_uint32 i = 0; i < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT; i++) {
+				flush(i, 0);
+			}
+			SpinLocker lock(&g_lockThreadCaches);
+			for (sl_uint32 i = 0; i < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT; i++) {
+				SharedFreeList& shared = g_sharedLists[i];
+				SpinLocker lockShared(&(shared.lock));
+				shared.countHit += lists[i].countHit;
+				shared.countMiss += lists[i].countMiss;
+			}
+			if (previous) {
+				previous->next = next;
+			} else {
+				g_firstThreadCache = next;
+			}
+			if (next) {
+				next->previous = previous;
+			}
+		}
+
+		SLIB_THREAD ThreadCache* g_threadCache = sl_null;
+		SLIB_THREAD sl_bool g_flagThreadCacheReleased = sl_false;
+
+		class ThreadCacheReleaser
+		{
+		public:
+			ThreadCache* cache = sl_null;
+
+		public:
+			~ThreadCacheReleaser()
+			{
+				g_flagThreadCacheReleased = sl_true;
+				g_threadCache = sl_null;
+				if (cache) {
+					delete cache;
+				}
+			}
+
+		};
+
+		static thread_local ThreadCacheReleaser g_threadCacheReleaser;
+
+		static ThreadCache* GetThreadCache()
+		{
+			ThreadCache* cache = g_threadCache;
+			if (cache) {
+				return cache;
+			}
+			// blocks freed while the thread is exiting go to the shared list directly
+			if (g_flagThreadCacheReleased) {
+				return sl_null;
+			}
+			cache = new ThreadCache;
+			g_threadCacheReleaser.cache = cache;
+			g_threadCache = cache;
+			return cache;
+		}
+
+	}
+
+	MemoryPoolStatistics::MemoryPoolStatistics() noexcept: blockSize(0), hitCount(0), missCount(0), cachedCount(0)
+	{
+	}
+
+	void* MemoryPool::allocate(sl_size size) noexcept
+	{
+		sl_int32 sizeClass = getSizeClass(size);
+		if (sizeClass < 0) {
+			return sl_null;
+		}
+		ThreadCache* cache = GetThreadCache();
+		SharedFreeList& shared = g_sharedLists[sizeClass];
+		if (cache) {
+			ThreadFreeList& list = cache->lists[sizeClass];
+			FreeBlock* block = list.first;
+			if (!block) {
+				// refill from the shared list
+				sl_size n = GetTransferCount(sizeClass);
+				SpinLocker lock(&(shared.lock));
+				FreeBlock* first = shared.first;
+				if (first) {
+					FreeBlock* last = first;
+					sl_size k = 1;
+					while (k < n && last->next) {
+						last = last->next;
+						k++;
+					}
+					shared.first = last->next;
+					shared.count -= k;
+					last->next = sl_null;
+					list.first = first;
+					list.count = k;
+					block = first;
+				}
+			}
+			if (block) {
+				list.first = block->next;
+				list.count--;
+				list.countHit++;
+				return block;
+			}
+			list.countMiss++;
+		} else {
+			SpinLocker lock(&(shared.lock));
+			FreeBlock* block = shared.first;
+			if (block) {
+				shared.first = block->next;
+				shared.count--;
+				shared.countHit++;
+				return block;
+			}
+			shared.countMiss++;
+		}
+		return Base::createMemory(GetBlockSize(sizeClass));
+	}
+
+	void MemoryPool::free(void* ptr, sl_size size) noexcept
+	{
+		if (!ptr) {
+			return;
+		}
+		sl_int32 sizeClass = getSizeClass(size);
+		if (sizeClass < 0) {
+			return;
+		}
+		FreeBlock* block = (FreeBlock*)ptr;
+		ThreadCache* cache = GetThreadCache();
+		if (cache) {
+			ThreadFreeList& list = cache->lists[sizeClass];
+			block->next = list.first;
+			list.first = block;
+			list.count++;
+			sl_size limit = GetThreadCacheLimit(sizeClass);
+			if (list.count > limit) {
+				cache->flush(sizeClass, limit >> 1);
+			}
+		} else {
+			block->next = sl_null;
+			PushShared(sizeClass, block, block, 1);
+		}
+	}
+
+	sl_int32 MemoryPool::getSizeClass(sl_size size) noexcept
+	{
+		if (!size || size > SLIB_MEMORY_POOL_MAX_SIZE) {
+			return -1;
+		}
+		sl_int32 sizeClass = 0;
+		sl_size n = SLIB_MEMORY_POOL_MIN_SIZE;
+		while (n < size) {
+			n <<= 1;
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	sl_size MemoryPool::getBlockSize(sl_uint32 sizeClass) noexcept
+	{
+		if (sizeClass < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT) {
+			return GetBlockSize(sizeClass);
+		}
+		return 0;
+	}
+
+	void MemoryPool::getStatistics(sl_uint32 sizeClass, MemoryPoolStatistics& _out) noexcept
+	{
+		if (sizeClass >= SLIB_MEMORY_POOL_SIZE_CLASS_COUNT) {
+			_out = MemoryPoolStatistics();
+			return;
+		}
+		_out.blockSize = GetBlockSize(sizeClass);
+		SpinLocker lock(&g_lockThreadCaches);
+		{
+			SharedFreeList& shared = g_sharedLists[sizeClass];
+			SpinLocker lockShared(&(shared.lock));
+			_out.hitCount = shared.countHit;
+			_out.missCount = shared.countMiss;
+			_out.cachedCount = shared.count;
+		}
+		// counters of the running threads are read without synchronization
+		ThreadCache* cache = g_firstThreadCache;
+		while (cache) {
+			_out.hitCount += cache->lists[sizeClass].countHit;
+			_out.missCount += cache->lists[sizeClass].countMiss;
+			cache = cache->next;
+		}
+	}
+
+	void MemoryPool::flushThreadCache() noexcept
+	{
+		ThreadCache* cache = g_threadCache;
+		if (cache) {
+			for (sl_uint32 i = 0; i < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT; i++) {
+				cache->flush(i, 0);
+			}
+		}
+	}
+
+	void MemoryPool::trim() noexcept
+	{
+		for (sl_uint32 i = 0; i < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT; i++) {
+			SharedFreeList& shared = g_sharedLists[i];
+			FreeBlock* blocks;
+			{
+				SpinLocker lock(&(shared.lock));
+				blocks = shared.first;
+				shared.first = sl_null;
+				shared.count = 0;
+			}
+			FreeBlocks(blocks);
+		}
+	}
+
+}
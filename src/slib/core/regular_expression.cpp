@@ -23,108 +23,1505 @@
 #include "slib/core/regular_expression.h"
 
 #include "slib/core/base.h"
+#include "slib/core/list.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/mutex.h"
 #include "slib/core/safe_static.h"
 
 #include <regex>
 #include <bitset>
 
+#if defined(SLIB_ARCH_IS_X64)
+#	include <emmintrin.h>
+#endif
+
+/*
+	Native engine
+
+	The pattern is parsed into a syntax tree and compiled to a Thompson NFA, which is executed by a lazily built DFA.
+	DFA states are sets of NFA instructions, and are created on demand and cached in the expression (up to MAX_DFA_MEMORY).
+	When the cache is full, the remaining input is processed by the NFA simulation, so the running time is always linear to the input length.
+	Searching skips to the occurrences of the literal prefix of the pattern with SSE2.
+*/
+
+#define MAX_PARSE_DEPTH 256
+#define MAX_PROGRAM_SIZE 0x10000
+#define MAX_REPEAT_COUNT 1000
+#define MAX_DFA_STATES 0x4000
+#define MAX_DFA_MEMORY 0x200000
+
+// flags of DFA states
+#define STATE_AT_START 0x01
+#define STATE_PREV_WORD 0x02
+#define STATE_NOT_BOL 0x04
+#define STATE_NOT_EOL 0x08
+#define STATE_NOT_BOW 0x10
+#define STATE_NOT_EOW 0x20
+// restarts the match at every position
+#define STATE_SEARCH 0x40
+// `Match` reached before the end ends the execution
+#define STATE_PARTIAL 0x80
+
 namespace slib
 {
 
 	namespace {
 
-		static constexpr int ToInt(int n)
+		static sl_bool IsWordChar(sl_uint8 c)
 		{
-			return n;
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
 		}
 
-		template<std::size_t N>
-		static int ToInt(const std::bitset<N>& n) noexcept
+		class ByteSet
 		{
-			return (int)(n.to_ulong());
-		}
+		public:
+			sl_uint32 bits[8];
 
-		static std::regex* Create(const StringParam& _pattern, int _flags) noexcept
+		public:
+			ByteSet()
+			{
+				Base::zeroMemory(bits, sizeof(bits));
+			}
+
+		public:
+			sl_bool contains(sl_uint8 c) const
+			{
+				return (bits[c >> 5] >> (c & 31)) & 1;
+			}
+
+			void add(sl_uint8 c)
+			{
+				bits[c >> 5] |= (1 << (c & 31));
+			}
+
+			void addRange(sl_uint8 first, sl_uint8 last)
+			{
+				for (sl_uint32 c = first; c <= last; c++) {
+					add((sl_uint8)c);
+				}
+			}
+
+			void add(const ByteSet& other)
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					bits[i] |= other.bits[i];
+				}
+			}
+
+			void invert()
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					bits[i] = ~(bits[i]);
+				}
+			}
+
+			void addOtherCases()
+			{
+				for (sl_uint32 c = 'a'; c <= 'z'; c++) {
+					if (contains((sl_uint8)c)) {
+						add((sl_uint8)(c - 'a' + 'A'));
+					} else if (contains((sl_uint8)(c - 'a' + 'A'))) {
+						add((sl_uint8)c);
+					}
+				}
+			}
+
+			// returns -1 when the set does not consist of one byte
+			sl_int32 getSingleByte() const
+			{
+				sl_int32 ret = -1;
+				for (sl_uint32 c = 0; c < 256; c++) {
+					if (contains((sl_uint8)c)) {
+						if (ret >= 0) {
+							return -1;
+						}
+						ret = c;
+					}
+				}
+				return ret;
+			}
+
+		};
+
+		enum class NodeType
 		{
-			StringData pattern(_pattern);
-			std::regex* handle = (std::regex*)(Base::createMemory(sizeof(std::regex)));
-			if (handle) {
-				int flags = 0;
-				if (_flags & RegularExpressionFlags::Icase) {
-					flags |= std::regex_constants::icase;
+			Empty,
+			Set,
+			Concat,
+			Alternate,
+			Repeat,
+			Bol,
+			Eol,
+			WordBoundary,
+			NotWordBoundary
+		};
+
+		class Node
+		{
+		public:
+			NodeType type;
+			sl_uint32 set; // index of the set
+			List<sl_uint32> children;
+			sl_uint32 minRepeat;
+			sl_int32 maxRepeat; // -1: infinite
+
+		public:
+			Node(): type(NodeType::Empty), set(0), minRepeat(0), maxRepeat(0) {}
+
+		};
+
+		class Parser
+		{
+		public:
+			const sl_uint8* current;
+			const sl_uint8* end;
+			sl_bool flagIcase;
+			// the pattern uses the features which the native engine does not support
+			sl_bool flagUnsupported;
+			sl_uint32 depth;
+
+			List<Node> nodes;
+			List<ByteSet> sets;
+
+		public:
+			Parser(const sl_uint8* pattern, sl_size len, sl_bool _flagIcase): current(pattern), end(pattern + len), flagIcase(_flagIcase), flagUnsupported(sl_false), depth(0) {}
+
+		public:
+			// returns -1 on error
+			sl_int32 parse()
+			{
+				sl_int32 root = parseAlternate();
+				if (root < 0 || current != end) {
+					return -1;
+				}
+				return root;
+			}
+
+		private:
+			sl_int32 addNode(NodeType type)
+			{
+				Node node;
+				node.type = type;
+				if (nodes.add_NoLock(Move(node))) {
+					return (sl_int32)(nodes.getCount() - 1);
+				}
+				return -1;
+			}
+
+			sl_int32 addSetNode(ByteSet& set)
+			{
+				if (flagIcase) {
+					set.addOtherCases();
+				}
+				if (!(sets.add_NoLock(set))) {
+					return -1;
+				}
+				sl_int32 index = addNode(NodeType::Set);
+				if (index >= 0) {
+					nodes[index].set = (sl_uint32)(sets.getCount() - 1);
+				}
+				return index;
+			}
+
+			sl_int32 parseAlternate()
+			{
+				if (depth >= MAX_PARSE_DEPTH) {
+					return -1;
+				}
+				depth++;
+				sl_int32 first = parseConcat();
+				if (first < 0) {
+					return -1;
+				}
+				if (current >= end || *current != '|') {
+					depth--;
+					return first;
+				}
+				sl_int32 index = addNode(NodeType::Alternate);
+				if (index < 0) {
+					return -1;
+				}
+				nodes[index].children.add_NoLock(first);
+				while (current < end && *current == '|') {
+					current++;
+					sl_int32 child = parseConcat();
+					if (child < 0) {
+						return -1;
+					}
+					nodes[index].children.add_NoLock(child);
+				}
+				depth--;
+				return index;
+			}
+
+			sl_int32 parseConcat()
+			{
+				List<sl_uint32> children;
+				while (current < end && *current != '|' && *current != ')') {
+					sl_int32 child = parseRepeat();
+					if (child < 0) {
+						return -1;
+					}
+					children.add_NoLock(child);
+				}
+				if (children.getCount() == 1) {
+					return children[0];
+				}
+				sl_int32 index = addNode(children.isEmpty() ? NodeType::Empty : NodeType::Concat);
+				if (index >= 0) {
+					nodes[index].children = Move(children);
+				}
+				return index;
+			}
+
+			static sl_bool ParseNumber(const sl_uint8*& s, const sl_uint8* end, sl_uint32& _out)
+			{
+				const sl_uint8* start = s;
+				sl_uint32 n = 0;
+				while (s < end && *s >= '0' && *s <= '9') {
+					n = n * 10 + (*s - '0');
+					if (n > MAX_REPEAT_COUNT) {
+						return sl_false;
+					}
+					s++;
+				}
+				_out = n;
+				return s != start;
+			}
+
+			sl_int32 parseRepeat()
+			{
+				sl_int32 atom = parseAtom();
+				if (atom < 0) {
+					return -1;
+				}
+				if (current >= end) {
+					return atom;
+				}
+				sl_uint32 minRepeat;
+				sl_int32 maxRepeat;
+				sl_uint8 c = *current;
+				if (c == '*') {
+					minRepeat = 0;
+					maxRepeat = -1;
+					current++;
+				} else if (c == '+') {
+					minRepeat = 1;
+					maxRepeat = -1;
+					current++;
+				} else if (c == '?') {
+					minRepeat = 0;
+					maxRepeat = 1;
+					current++;
+				} else if (c == '{') {
+					current++;
+					if (!(ParseNumber(current, end, minRepeat))) {
+						return -1;
+					}
+					maxRepeat = (sl_int32)minRepeat;
+					if (current < end && *current == ',') {
+						current++;
+						if (current < end && *current == '}') {
+							maxRepeat = -1;
+						} else {
+							sl_uint32 n;
+							if (!(ParseNumber(current, end, n)) || n < minRepeat) {
+								return -1;
+							}
+							maxRepeat = (sl_int32)n;
+						}
+					}
+					if (current >= end || *current != '}') {
+						return -1;
+					}
+					current++;
+				} else {
+					return atom;
+				}
+				// lazy quantifier does not change the result of matching
+				if (current < end && *current == '?') {
+					current++;
+				}
+				if (current < end && (*current == '*' || *current == '+' || *current == '?' || *current == '{')) {
+					return -1;
+				}
+				NodeType typeAtom = nodes[atom].type;
+				if (typeAtom == NodeType::Bol || typeAtom == NodeType::Eol || typeAtom == NodeType::WordBoundary || typeAtom == NodeType::NotWordBoundary) {
+					return -1;
+				}
+				sl_int32 index = addNode(NodeType::Repeat);
+				if (index >= 0) {
+					Node& node = nodes[index];
+					node.children.add_NoLock(atom);
+					node.minRepeat = minRepeat;
+					node.maxRepeat = maxRepeat;
+				}
+				return index;
+			}
+
+			sl_int32 parseAtom()
+			{
+				sl_uint8 c = *current;
+				switch (c) {
+					case '(':
+						{
+							current++;
+							if (current < end && *current == '?') {
+								if (current + 1 < end && current[1] == ':') {
+									current += 2;
+								} else {
+									// lookarounds
+									flagUnsupported = sl_true;
+									return -1;
+								}
+							}
+							sl_int32 index = parseAlternate();
+							if (index < 0) {
+								return -1;
+							}
+							if (current >= end || *current != ')') {
+								return -1;
+							}
+							current++;
+							return index;
+						}
+					case '[':
+						current++;
+						return parseClass();
+					case '.':
+						{
+							current++;
+							ByteSet set;
+							set.invert();
+							set.bits['\n' >> 5] &= ~(1 << ('\n' & 31));
+							set.bits['\r' >> 5] &= ~(1 << ('\r' & 31));
+							return addSetNode(set);
+						}
+					case '^':
+						current++;
+						return addNode(NodeType::Bol);
+					case '$':
+						current++;
+						return addNode(NodeType::Eol);
+					case '\\':
+						{
+							current++;
+							if (current >= end) {
+								return -1;
+							}
+							c = *current;
+							if (c == 'b') {
+								current++;
+								return addNode(NodeType::WordBoundary);
+							}
+							if (c == 'B') {
+								current++;
+								return addNode(NodeType::NotWordBoundary);
+							}
+							ByteSet set;
+							if (!(parseEscape(set, sl_false))) {
+								return -1;
+							}
+							return addSetNode(set);
+						}
+					case '*':
+					case '+':
+					case '?':
+					case '{':
+					case ')':
+						return -1;
+					default:
+						{
+							current++;
+							ByteSet set;
+							set.add(c);
+							return addSetNode(set);
+						}
+				}
+			}
+
+			// `current` points the character after the backslash
+			sl_bool parseEscape(ByteSet& set, sl_bool flagInClass)
+			{
+				sl_uint8 c = *(current++);
+				switch (c) {
+					case 'd':
+					case 'D':
+						{
+							ByteSet s;
+							s.addRange('0', '9');
+							if (c == 'D') {
+								s.invert();
+							}
+							set.add(s);
+							return sl_true;
+						}
+					case 'w':
+					case 'W':
+						{
+							ByteSet s;
+							s.addRange('a', 'z');
+							s.addRange('A', 'Z');
+							s.addRange('0', '9');
+							s.add('_');
+							if (c == 'W') {
+								s.invert();
+							}
+							set.add(s);
+							return sl_true;
+						}
+					case 's':
+					case 'S':
+						{
+							ByteSet s;
+							s.add(' ');
+							s.addRange('\t', '\r');
+							if (c == 'S') {
+								s.invert();
+							}
+							set.add(s);
+							return sl_true;
+						}
+					case 'n':
+						set.add('\n');
+						return sl_true;
+					case 'r':
+						set.add('\r');
+						return sl_true;
+					case 't':
+						set.add('\t');
+						return sl_true;
+					case 'v':
+						set.add('\v');
+						return sl_true;
+					case 'f':
+						set.add('\f');
+						return sl_true;
+					case '0':
+						set.add(0);
+						return sl_true;
+					case 'b':
+						if (flagInClass) {
+							set.add('\b');
+							return sl_true;
+						}
+						return sl_false;
+					case 'x':
+						{
+							sl_uint32 n = 0;
+							for (sl_uint32 i = 0; i < 2; i++) {
+								if (current >= end) {
+									return sl_false;
+								}
+								sl_int32 h = SLIB_CHAR_HEX_TO_INT(*current);
+								if (h < 0 || h >= 16) {
+									return sl_false;
+								}
+								n = (n << 4) | (sl_uint32)h;
+								current++;
+							}
+							set.add((sl_uint8)n);
+							return sl_true;
+						}
+					default:
+						if ((c >= '1' && c <= '9') || c == 'u' || c == 'c' || c == 'k') {
+							// backreferences, unicode escapes and control letters
+							flagUnsupported = sl_true;
+							return sl_false;
+						}
+						if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+							return sl_false;
+						}
+						set.add(c);
+						return sl_true;
 				}
-				if (_flags & RegularExpressionFlags::Nosubs) {
-					flags |= std::regex_constants::nosubs;
+			}
+
+			// `current` points the character after `[`
+			sl_int32 parseClass()
+			{
+				ByteSet set;
+				sl_bool flagNegative = sl_false;
+				if (current < end && *current == '^') {
+					flagNegative = sl_true;
+					current++;
 				}
-				if (_flags & RegularExpressionFlags::Optimize) {
-					flags |= std::regex_constants::optimize;
+				for (;;) {
+					if (current >= end) {
+						return -1;
+					}
+					sl_uint8 c = *current;
+					if (c == ']') {
+						current++;
+						break;
+					}
+					if (c == '[' && current + 1 < end && (current[1] == ':' || current[1] == '=' || current[1] == '.')) {
+						// character class names, equivalence classes and collating symbols
+						flagUnsupported = sl_true;
+						return -1;
+					}
+					sl_int32 first;
+					if (c == '\\') {
+						current++;
+						if (current >= end) {
+							return -1;
+						}
+						sl_uint8 e = *current;
+						if (e == 'd' || e == 'D' || e == 'w' || e == 'W' || e == 's' || e == 'S') {
+							if (!(parseEscape(set, sl_true))) {
+								return -1;
+							}
+							continue;
+						}
+						ByteSet s;
+						if (!(parseEscape(s, sl_true))) {
+							return -1;
+						}
+						first = s.getSingleByte();
+						if (first < 0) {
+							return -1;
+						}
+					} else {
+						first = c;
+						current++;
+					}
+					if (current + 1 < end && *current == '-' && current[1] != ']') {
+						current++;
+						sl_int32 last;
+						if (*current == '\\') {
+							current++;
+							if (current >= end) {
+								return -1;
+							}
+							ByteSet s;
+							if (!(parseEscape(s, sl_true))) {
+								return -1;
+							}
+							last = s.getSingleByte();
+							if (last < 0) {
+								return -1;
+							}
+						} else {
+							last = *(current++);
+						}
+						if (last < first) {
+							return -1;
+						}
+						set.addRange((sl_uint8)first, (sl_uint8)last);
+					} else {
+						set.add((sl_uint8)first);
+					}
 				}
-				if (_flags & RegularExpressionFlags::Collate) {
-					flags |= std::regex_constants::collate;
+				if (flagIcase) {
+					set.addOtherCases();
 				}
-				if (_flags & RegularExpressionFlags::ECMAScript) {
-					flags |= std::regex_constants::ECMAScript;
+				if (flagNegative) {
+					set.invert();
 				}
-				if (_flags & RegularExpressionFlags::Basic) {
-					flags |= std::regex_constants::basic;
+				if (!(sets.add_NoLock(set))) {
+					return -1;
 				}
-				if (_flags & RegularExpressionFlags::Extended) {
-					flags |= std::regex_constants::extended;
+				sl_int32 index = addNode(NodeType::Set);
+				if (index >= 0) {
+					nodes[index].set = (sl_uint32)(sets.getCount() - 1);
 				}
-				if (_flags & RegularExpressionFlags::Awk) {
-					flags |= std::regex_constants::awk;
+				return index;
+			}
+
+		};
+
+		enum class InstType : sl_uint8
+		{
+			Match,
+			ByteSet,
+			Split,
+			Jump,
+			Bol,
+			Eol,
+			WordBoundary,
+			NotWordBoundary
+		};
+
+		struct Inst
+		{
+			InstType type;
+			sl_uint32 out;
+			sl_uint32 out1;
+			sl_uint32 set;
+		};
+
+		class SparseSet
+		{
+		public:
+			sl_uint32* dense;
+			sl_uint32* sparse;
+			sl_uint32 count;
+
+		public:
+			SparseSet(sl_uint32 capacity): count(0)
+			{
+				dense = new sl_uint32[capacity];
+				sparse = new sl_uint32[capacity];
+			}
+
+			~SparseSet()
+			{
+				delete[] dense;
+				delete[] sparse;
+			}
+
+		public:
+			sl_bool contains(sl_uint32 value) const
+			{
+				sl_uint32 i = sparse[value];
+				return i < count && dense[i] == value;
+			}
+
+			void add(sl_uint32 value)
+			{
+				sparse[value] = count;
+				dense[count++] = value;
+			}
+
+		};
+
+		class Program
+		{
+		public:
+			List<Inst> insts;
+			List<ByteSet> sets;
+			sl_uint32 start;
+			sl_uint8 classes[256];
+			sl_uint32 nClasses;
+			sl_bool flagAnchoredStart;
+			String prefix;
+
+		public:
+			// `set` has the capacity of the instruction count, and `stack` has twice of it
+			sl_bool closure(const sl_uint32* kernel, sl_uint32 nKernel, sl_uint32 flags, sl_bool flagAtEnd, sl_bool flagNextWord, sl_uint32* stack, SparseSet& set) const
+			{
+				const Inst* program = insts.getData();
+				sl_bool flagAtStart = (flags & STATE_AT_START) != 0;
+				sl_bool flagPrevWord = (flags & STATE_PREV_WORD) != 0;
+				sl_bool flagBoundary = flagPrevWord != flagNextWord;
+				if (flagAtStart && (flags & STATE_NOT_BOW)) {
+					flagBoundary = sl_false;
+				}
+				if (flagAtEnd && (flags & STATE_NOT_EOW)) {
+					flagBoundary = sl_false;
+				}
+				sl_bool flagMatch = sl_false;
+				set.count = 0;
+				sl_uint32 nStack = 0;
+				for (sl_uint32 i = 0; i < nKernel; i++) {
+					stack[nStack++] = kernel[i];
+					while (nStack) {
+						sl_uint32 pc = stack[--nStack];
+						if (set.contains(pc)) {
+							continue;
+						}
+						set.add(pc);
+						const Inst& inst = program[pc];
+						switch (inst.type) {
+							case InstType::Match:
+								flagMatch = sl_true;
+								break;
+							case InstType::Split:
+								stack[nStack++] = inst.out1;
+								stack[nStack++] = inst.out;
+								break;
+							case InstType::Jump:
+								stack[nStack++] = inst.out;
+								break;
+							case InstType::Bol:
+								if (flagAtStart && !(flags & STATE_NOT_BOL)) {
+									stack[nStack++] = inst.out;
+								}
+								break;
+							case InstType::Eol:
+								if (flagAtEnd && !(flags & STATE_NOT_EOL)) {
+									stack[nStack++] = inst.out;
+								}
+								break;
+							case InstType::WordBoundary:
+								if (flagBoundary) {
+									stack[nStack++] = inst.out;
+								}
+								break;
+							case InstType::NotWordBoundary:
+								if (!flagBoundary) {
+									stack[nStack++] = inst.out;
+								}
+								break;
+							default:
+								break;
+						}
+					}
 				}
-				if (_flags & RegularExpressionFlags::Grep) {
-					flags |= std::regex_constants::grep;
+				return flagMatch;
+			}
+
+			// returns the count of the next kernel
+			sl_uint32 step(const SparseSet& set, sl_uint8 c, sl_uint32 flags, sl_uint32* kernel, SparseSet& next) const
+			{
+				const Inst* program = insts.getData();
+				const ByteSet* pSets = sets.getData();
+				next.count = 0;
+				for (sl_uint32 i = 0; i < set.count; i++) {
+					const Inst& inst = program[set.dense[i]];
+					if (inst.type == InstType::ByteSet && pSets[inst.set].contains(c)) {
+						if (!(next.contains(inst.out))) {
+							next.add(inst.out);
+						}
+					}
 				}
-				if (_flags & RegularExpressionFlags::Egrep) {
-					flags |= std::regex_constants::egrep;
+				if ((flags & STATE_SEARCH) && !(next.contains(start))) {
+					next.add(start);
+				}
+				Base::copyMemory(kernel, next.dense, next.count * sizeof(sl_uint32));
+				return next.count;
+			}
+
+			sl_uint32 getNextFlags(sl_uint32 flags, sl_uint8 c) const
+			{
+				flags &= ~(STATE_AT_START | STATE_PREV_WORD);
+				if (IsWordChar(c)) {
+					flags |= STATE_PREV_WORD;
 				}
-				try {
-					if (flags) {
-						new (handle) std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()), (std::regex_constants::syntax_option_type)flags);
+				return flags;
+			}
+
+			// NFA simulation
+			sl_bool run(const sl_uint32* kernel, sl_uint32 nKernel, sl_uint32 flags, const sl_uint8* data, sl_size pos, sl_size len) const
+			{
+				sl_uint32 n = (sl_uint32)(insts.getCount());
+				SparseSet set(n), next(n);
+				sl_uint32* stack = new sl_uint32[n * 3 + 1];
+				sl_uint32* current = stack + n * 2 + 1;
+				Base::copyMemory(current, kernel, nKernel * sizeof(sl_uint32));
+				sl_bool flagResult = sl_false;
+				for (;;) {
+					if (pos >= len) {
+						flagResult = closure(current, nKernel, flags, sl_true, sl_false, stack, set);
+						break;
+					}
+					sl_uint8 c = data[pos];
+					if (closure(current, nKernel, flags, sl_false, IsWordChar(c), stack, set) && (flags & STATE_PARTIAL)) {
+						flagResult = sl_true;
+						break;
+					}
+					nKernel = step(set, c, flags, current, next);
+					if (!nKernel) {
+						break;
+					}
+					flags = getNextFlags(flags, c);
+					pos++;
+				}
+				delete[] stack;
+				return flagResult;
+			}
+
+		};
+
+		class Compiler
+		{
+		public:
+			Parser& parser;
+			Program& program;
+
+			struct Fragment
+			{
+				sl_uint32 start;
+				List<sl_uint32> holes; // (pc << 1) | slot
+			};
+
+		public:
+			Compiler(Parser& _parser, Program& _program): parser(_parser), program(_program) {}
+
+		public:
+			sl_bool compile(sl_uint32 root)
+			{
+				Fragment f;
+				if (!(compileNode(root, f))) {
+					return sl_false;
+				}
+				sl_int32 pc = addInst(InstType::Match);
+				if (pc < 0) {
+					return sl_false;
+				}
+				patch(f.holes, pc);
+				program.start = f.start;
+				return sl_true;
+			}
+
+		private:
+			sl_int32 addInst(InstType type, sl_uint32 set = 0)
+			{
+				sl_size n = program.insts.getCount();
+				if (n >= MAX_PROGRAM_SIZE) {
+					return -1;
+				}
+				Inst inst;
+				inst.type = type;
+				inst.out = 0;
+				inst.out1 = 0;
+				inst.set = set;
+				if (program.insts.add_NoLock(inst)) {
+					return (sl_int32)n;
+				}
+				return -1;
+			}
+
+			void patch(const List<sl_uint32>& holes, sl_uint32 target)
+			{
+				Inst* insts = program.insts.getData();
+				ListElements<sl_uint32> list(holes);
+				for (sl_size i = 0; i < list.count; i++) {
+					sl_uint32 hole = list[i];
+					if (hole & 1) {
+						insts[hole >> 1].out1 = target;
+					} else {
+						insts[hole >> 1].out = target;
+					}
+				}
+			}
+
+			sl_bool compileSingle(InstType type, Fragment& f, sl_uint32 set = 0)
+			{
+				sl_int32 pc = addInst(type, set);
+				if (pc < 0) {
+					return sl_false;
+				}
+				f.start = pc;
+				f.holes.removeAll_NoLock();
+				f.holes.add_NoLock(pc << 1);
+				return sl_true;
+			}
+
+			sl_bool compileNode(sl_uint32 index, Fragment& f)
+			{
+				Node& node = parser.nodes[index];
+				switch (node.type) {
+					case NodeType::Empty:
+						return compileSingle(InstType::Jump, f);
+					case NodeType::Set:
+						return compileSingle(InstType::ByteSet, f, node.set);
+					case NodeType::Bol:
+						return compileSingle(InstType::Bol, f);
+					case NodeType::Eol:
+						return compileSingle(InstType::Eol, f);
+					case NodeType::WordBoundary:
+						return compileSingle(InstType::WordBoundary, f);
+					case NodeType::NotWordBoundary:
+						return compileSingle(InstType::NotWordBoundary, f);
+					case NodeType::Concat:
+						{
+							List<sl_uint32> children = node.children;
+							ListElements<sl_uint32> list(children);
+							for (sl_size i = 0; i < list.count; i++) {
+								Fragment child;
+								if (!(compileNode(list[i], child))) {
+									return sl_false;
+								}
+								if (i) {
+									patch(f.holes, child.start);
+									f.holes = Move(child.holes);
+								} else {
+									f.start = child.start;
+									f.holes = Move(child.holes);
+								}
+							}
+							return sl_true;
+						}
+					case NodeType::Alternate:
+						{
+							List<sl_uint32> children = node.children;
+							ListElements<sl_uint32> list(children);
+							f.holes.removeAll_NoLock();
+							sl_int32 pcPrevSplit = -1;
+							for (sl_size i = 0; i < list.count; i++) {
+								Fragment child;
+								if (!(compileNode(list[i], child))) {
+									return sl_false;
+								}
+								f.holes.addAll_NoLock(child.holes);
+								sl_uint32 start = child.start;
+								if (i + 1 < list.count) {
+									sl_int32 pc = addInst(InstType::Split);
+									if (pc < 0) {
+										return sl_false;
+									}
+									program.insts[pc].out = start;
+									start = pc;
+								}
+								if (pcPrevSplit >= 0) {
+									program.insts[pcPrevSplit].out1 = start;
+								} else {
+									f.start = start;
+								}
+								pcPrevSplit = (i + 1 < list.count) ? (sl_int32)start : -1;
+							}
+							return sl_true;
+						}
+					case NodeType::Repeat:
+						return compileRepeat(node.children[0], node.minRepeat, node.maxRepeat, f);
+				}
+				return sl_false;
+			}
+
+			// x*
+			sl_bool compileStar(sl_uint32 child, Fragment& f)
+			{
+				Fragment body;
+				if (!(compileNode(child, body))) {
+					return sl_false;
+				}
+				sl_int32 pc = addInst(InstType::Split);
+				if (pc < 0) {
+					return sl_false;
+				}
+				program.insts[pc].out = body.start;
+				patch(body.holes, pc);
+				f.start = pc;
+				f.holes.removeAll_NoLock();
+				f.holes.add_NoLock((pc << 1) | 1);
+				return sl_true;
+			}
+
+			sl_bool compileRepeat(sl_uint32 child, sl_uint32 minRepeat, sl_int32 maxRepeat, Fragment& f)
+			{
+				if (!minRepeat && !maxRepeat) {
+					return compileSingle(InstType::Jump, f);
+				}
+				sl_bool flagFirst = sl_true;
+				auto append = [&](Fragment& g) {
+					if (flagFirst) {
+						f.start = g.start;
+						f.holes = Move(g.holes);
+						flagFirst = sl_false;
 					} else {
-						new (handle) std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()));
+						patch(f.holes, g.start);
+						f.holes = Move(g.holes);
+					}
+				};
+				for (sl_uint32 i = 0; i < minRepeat; i++) {
+					Fragment g;
+					if (!(compileNode(child, g))) {
+						return sl_false;
+					}
+					append(g);
+				}
+				if (maxRepeat < 0) {
+					Fragment g;
+					if (!(compileStar(child, g))) {
+						return sl_false;
+					}
+					append(g);
+					return sl_true;
+				}
+				// (x(x(x)?)?)?
+				sl_uint32 nOptional = (sl_uint32)maxRepeat - minRepeat;
+				List<sl_uint32> holesOptional;
+				for (sl_uint32 i = 0; i < nOptional; i++) {
+					Fragment g;
+					if (!(compileNode(child, g))) {
+						return sl_false;
+					}
+					sl_int32 pc = addInst(InstType::Split);
+					if (pc < 0) {
+						return sl_false;
+					}
+					program.insts[pc].out = g.start;
+					holesOptional.add_NoLock((pc << 1) | 1);
+					Fragment s;
+					s.start = pc;
+					s.holes = Move(g.holes);
+					append(s);
+				}
+				f.holes.addAll_NoLock(holesOptional);
+				return sl_true;
+			}
+
+		};
+
+		class DfaState
+		{
+		public:
+			sl_uint32* kernel;
+			sl_uint32 nKernel;
+			sl_uint32 flags;
+			sl_bool flagDead;
+			sl_bool flagStartOnly;
+			// (index of next state << 1) | (1 if `Match` is reached before the byte), -1: not computed
+			volatile sl_int32* next;
+			// -1: not computed
+			volatile sl_int32 acceptAtEnd;
+
+		};
+
+		class Dfa
+		{
+		public:
+			const Program& program;
+			Mutex lock;
+			DfaState** states;
+			volatile sl_int32 nStates;
+			sl_size sizeMemory;
+			CHashMap<String, sl_int32> mapStates;
+			volatile sl_int32 startStates[256];
+			// working buffers, used in the lock
+			sl_uint32* stack;
+			sl_uint32* kernel;
+			SparseSet set;
+			SparseSet next;
+
+		public:
+			Dfa(const Program& _program): program(_program), nStates(0), sizeMemory(0), set((sl_uint32)(_program.insts.getCount())), next((sl_uint32)(_program.insts.getCount()))
+			{
+				states = new DfaState*[MAX_DFA_STATES];
+				for (sl_uint32 i = 0; i < 256; i++) {
+					startStates[i] = -1;
+				}
+				sl_uint32 n = (sl_uint32)(program.insts.getCount());
+				stack = new sl_uint32[n * 2 + 1];
+				kernel = new sl_uint32[n];
+			}
+
+			~Dfa()
+			{
+				for (sl_int32 i = 0; i < nStates; i++) {
+					DfaState* state = states[i];
+					delete[] state->kernel;
+					delete[] state->next;
+					delete state;
+				}
+				delete[] states;
+				delete[] stack;
+				delete[] kernel;
+			}
+
+		public:
+			// returns -1 when the cache is full
+			sl_int32 getStartState(sl_uint32 flags)
+			{
+				sl_int32 index = startStates[flags & 0xff];
+				if (index >= 0) {
+					return index;
+				}
+				MutexLocker locker(&lock);
+				index = startStates[flags & 0xff];
+				if (index >= 0) {
+					return index;
+				}
+				kernel[0] = program.start;
+				index = addState(kernel, 1, flags);
+				if (index >= 0) {
+					startStates[flags & 0xff] = index;
+				}
+				return index;
+			}
+
+			// returns -1 when the cache is full
+			sl_int32 getNext(sl_int32 index, sl_uint8 c)
+			{
+				DfaState* state = states[index];
+				sl_uint32 k = program.classes[c];
+				MutexLocker locker(&lock);
+				sl_int32 entry = state->next[k];
+				if (entry >= 0) {
+					return entry;
+				}
+				sl_bool flagMatch = program.closure(state->kernel, state->nKernel, state->flags, sl_false, IsWordChar(c), stack, set);
+				sl_uint32 nKernel = program.step(set, c, state->flags, kernel, next);
+				sl_int32 indexNext = addState(kernel, nKernel, program.getNextFlags(state->flags, c));
+				if (indexNext < 0) {
+					return -1;
+				}
+				entry = (indexNext << 1) | (flagMatch ? 1 : 0);
+				Base::interlockedCompareExchange32(state->next + k, entry, -1);
+				return entry;
+			}
+
+			sl_bool isAcceptedAtEnd(sl_int32 index)
+			{
+				DfaState* state = states[index];
+				sl_int32 accept = state->acceptAtEnd;
+				if (accept >= 0) {
+					return accept != 0;
+				}
+				MutexLocker locker(&lock);
+				sl_bool flagMatch = program.closure(state->kernel, state->nKernel, state->flags, sl_true, sl_false, stack, set);
+				state->acceptAtEnd = flagMatch ? 1 : 0;
+				return flagMatch;
+			}
+
+		private:
+			// called in the lock
+			sl_int32 addState(sl_uint32* kernel, sl_uint32 nKernel, sl_uint32 flags)
+			{
+				// canonical order
+				for (sl_uint32 i = 1; i < nKernel; i++) {
+					sl_uint32 v = kernel[i];
+					sl_uint32 j = i;
+					while (j > 0 && kernel[j - 1] > v) {
+						kernel[j] = kernel[j - 1];
+						j--;
 					}
-				} catch (std::regex_error&) {
-					Base::freeMemory(handle);
+					kernel[j] = v;
+				}
+				String key = String::allocate((nKernel + 1) * sizeof(sl_uint32));
+				if (key.isNull()) {
+					return -1;
+				}
+				sl_uint32* pKey = (sl_uint32*)(key.getData());
+				pKey[0] = flags;
+				Base::copyMemory(pKey + 1, kernel, nKernel * sizeof(sl_uint32));
+				sl_int32* pIndex = mapStates.getItemPointer(key);
+				if (pIndex) {
+					return *pIndex;
+				}
+				sl_uint32 nClasses = program.nClasses;
+				sl_size size = sizeof(DfaState) + (nKernel + nClasses) * sizeof(sl_uint32) + key.getLength() * 2;
+				if (nStates >= MAX_DFA_STATES || sizeMemory + size > MAX_DFA_MEMORY) {
+					return -1;
+				}
+				DfaState* state = new DfaState;
+				state->kernel = new sl_uint32[nKernel ? nKernel : 1];
+				Base::copyMemory(state->kernel, kernel, nKernel * sizeof(sl_uint32));
+				state->nKernel = nKernel;
+				state->flags = flags;
+				state->flagDead = !nKernel;
+				state->flagStartOnly = (flags & STATE_SEARCH) && nKernel == 1 && kernel[0] == program.start;
+				state->next = new sl_int32[nClasses];
+				for (sl_uint32 i = 0; i < nClasses; i++) {
+					state->next[i] = -1;
+				}
+				state->acceptAtEnd = -1;
+				sl_int32 index = nStates;
+				states[index] = state;
+				if (!(mapStates.put_NoLock(key, index))) {
+					return -1;
+				}
+				sizeMemory += size;
+				Base::interlockedIncrement32(&nStates);
+				return index;
+			}
+
+		};
+
+		static const sl_uint8* FindPrefix(const sl_uint8* data, sl_size size, const sl_uint8* prefix, sl_size n)
+		{
+			if (size < n) {
+				return sl_null;
+			}
+			if (n == 1) {
+				return Base::findMemory(data, size, prefix[0]);
+			}
+			sl_size i = 0;
+#if defined(SLIB_ARCH_IS_X64)
+			// compares the first and the last bytes of the prefix at 16 positions at once
+			sl_size nPositions = size - n + 1;
+			__m128i vFirst = _mm_set1_epi8((char)(prefix[0]));
+			__m128i vLast = _mm_set1_epi8((char)(prefix[n - 1]));
+			for (; i + 16 <= nPositions; i += 16) {
+				__m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+				__m128i b = _mm_loadu_si128((const __m128i*)(data + i + n - 1));
+				sl_uint32 mask = (sl_uint32)(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, vFirst), _mm_cmpeq_epi8(b, vLast))));
+				sl_uint32 k = 0;
+				while (mask) {
+					if (mask & 1) {
+						if (Base::equalsMemory(data + i + k + 1, prefix + 1, n - 2)) {
+							return data + i + k;
+						}
+					}
+					mask >>= 1;
+					k++;
+				}
+			}
+#endif
+			return Base::findMemory(data + i, size - i, prefix, n);
+		}
+
+		class NativeRegEx
+		{
+		public:
+			Program program;
+			Dfa* dfa;
+
+		public:
+			NativeRegEx(): dfa(sl_null) {}
+
+			~NativeRegEx()
+			{
+				if (dfa) {
+					delete dfa;
+				}
+			}
+
+		public:
+			static NativeRegEx* create(const StringData& pattern, sl_bool flagIcase, sl_bool& flagUnsupported)
+			{
+				Parser parser((const sl_uint8*)(pattern.getData()), pattern.getLength(), flagIcase);
+				sl_int32 root = parser.parse();
+				flagUnsupported = parser.flagUnsupported;
+				if (root < 0) {
+					return sl_null;
+				}
+				NativeRegEx* ret = new NativeRegEx;
+				Program& program = ret->program;
+				Compiler compiler(parser, program);
+				if (!(compiler.compile(root))) {
+					// too large program
+					flagUnsupported = sl_true;
+					delete ret;
+					return sl_null;
+				}
+				program.sets = parser.sets;
+				ret->prepare(parser, root);
+				ret->dfa = new Dfa(program);
+				return ret;
+			}
+
+			void prepare(Parser& parser, sl_uint32 root)
+			{
+				// byte classes: the bytes which can not be distinguished by the sets and by the word boundaries share a class
+				sl_uint8* classes = program.classes;
+				sl_uint32 nClasses = 2;
+				for (sl_uint32 c = 0; c < 256; c++) {
+					classes[c] = IsWordChar((sl_uint8)c) ? 1 : 0;
+				}
+				ListElements<ByteSet> sets(program.sets);
+				for (sl_size i = 0; i < sets.count; i++) {
+					sl_int32 map[512];
+					for (sl_uint32 k = 0; k < 512; k++) {
+						map[k] = -1;
+					}
+					sl_uint32 n = 0;
+					for (sl_uint32 c = 0; c < 256; c++) {
+						sl_uint32 key = ((sl_uint32)(classes[c]) << 1) | (sets[i].contains((sl_uint8)c) ? 1 : 0);
+						if (map[key] < 0) {
+							map[key] = n++;
+						}
+						classes[c] = (sl_uint8)(map[key]);
+					}
+					nClasses = n;
+				}
+				program.nClasses = nClasses;
+
+				// literal prefix and the anchor at the start
+				program.flagAnchoredStart = sl_false;
+				Node* node = &(parser.nodes[root]);
+				ListElements<sl_uint32> children(node->children);
+				sl_size nChildren = 1;
+				sl_uint32 single = root;
+				const sl_uint32* pChildren = &single;
+				if (node->type == NodeType::Concat) {
+					pChildren = children.data;
+					nChildren = children.count;
+				}
+				sl_char8 prefix[64];
+				sl_uint32 lenPrefix = 0;
+				for (sl_size i = 0; i < nChildren; i++) {
+					Node& child = parser.nodes[pChildren[i]];
+					if (!i && child.type == NodeType::Bol) {
+						program.flagAnchoredStart = sl_true;
+						break;
+					}
+					if (child.type != NodeType::Set) {
+						break;
+					}
+					sl_int32 c = sets[child.set].getSingleByte();
+					if (c < 0) {
+						break;
+					}
+					prefix[lenPrefix++] = (sl_char8)c;
+					if (lenPrefix >= sizeof(prefix)) {
+						break;
+					}
+				}
+				program.prefix = String(prefix, lenPrefix);
+			}
+
+			// STATE_SEARCH, STATE_PARTIAL and the match flags
+			sl_bool execute(const sl_uint8* data, sl_size len, sl_uint32 flags)
+			{
+				if (program.flagAnchoredStart) {
+					flags &= ~STATE_SEARCH;
+				}
+				const sl_uint8* prefix = (const sl_uint8*)(program.prefix.getData());
+				sl_size lenPrefix = (flags & STATE_SEARCH) ? program.prefix.getLength() : 0;
+				sl_int32 index = dfa->getStartState(flags | STATE_AT_START);
+				if (index < 0) {
+					sl_uint32 start = program.start;
+					return program.run(&start, 1, flags | STATE_AT_START, data, 0, len);
+				}
+				DfaState** states = dfa->states;
+				const sl_uint8* classes = program.classes;
+				DfaState* state = states[index];
+				sl_size pos = 0;
+				while (pos < len) {
+					if (lenPrefix && state->flagStartOnly) {
+						const sl_uint8* found = FindPrefix(data + pos, len - pos, prefix, lenPrefix);
+						if (!found) {
+							// the pattern can not match without the prefix
+							return sl_false;
+						}
+						sl_size posFound = found - data;
+						if (posFound != pos) {
+							pos = posFound;
+							sl_uint32 f = flags;
+							if (IsWordChar(data[pos - 1])) {
+								f |= STATE_PREV_WORD;
+							}
+							index = dfa->getStartState(f);
+							if (index < 0) {
+								sl_uint32 start = program.start;
+								return program.run(&start, 1, f, data, pos, len);
+							}
+							state = states[index];
+						}
+					}
+					sl_uint8 c = data[pos];
+					sl_int32 entry = state->next[classes[c]];
+					if (entry < 0) {
+						entry = dfa->getNext(index, c);
+						if (entry < 0) {
+							// the cache is full
+							return program.run(state->kernel, state->nKernel, state->flags, data, pos, len);
+						}
+					}
+					if ((entry & 1) && (flags & STATE_PARTIAL)) {
+						return sl_true;
+					}
+					index = entry >> 1;
+					state = states[index];
+					if (state->flagDead) {
+						return sl_false;
+					}
+					pos++;
+				}
+				return dfa->isAcceptedAtEnd(index);
+			}
+
+		};
+
+		static constexpr int ToInt(int n)
+		{
+			return n;
+		}
+
+		template<std::size_t N>
+		static int ToInt(const std::bitset<N>& n) noexcept
+		{
+			return (int)(n.to_ulong());
+		}
+
+		class RegExHandle
+		{
+		public:
+			std::regex* stdRegex;
+			NativeRegEx* native;
+			// used to create `stdRegex` for the match flags which the native engine does not support
+			String pattern;
+			int flags;
+			SpinLock lock;
+
+		public:
+			RegExHandle(): stdRegex(sl_null), native(sl_null), flags(0) {}
+
+			~RegExHandle()
+			{
+				if (stdRegex) {
+					delete stdRegex;
+				}
+				if (native) {
+					delete native;
+				}
+			}
+
+		};
+
+		static std::regex* CreateStd(const StringData& pattern, int _flags) noexcept
+		{
+			int flags = 0;
+			if (_flags & RegularExpressionFlags::Icase) {
+				flags |= std::regex_constants::icase;
+			}
+			if (_flags & RegularExpressionFlags::Nosubs) {
+				flags |= std::regex_constants::nosubs;
+			}
+			if (_flags & RegularExpressionFlags::Optimize) {
+				flags |= std::regex_constants::optimize;
+			}
+			if (_flags & RegularExpressionFlags::Collate) {
+				flags |= std::regex_constants::collate;
+			}
+			if (_flags & RegularExpressionFlags::ECMAScript) {
+				flags |= std::regex_constants::ECMAScript;
+			}
+			if (_flags & RegularExpressionFlags::Basic) {
+				flags |= std::regex_constants::basic;
+			}
+			if (_flags & RegularExpressionFlags::Extended) {
+				flags |= std::regex_constants::extended;
+			}
+			if (_flags & RegularExpressionFlags::Awk) {
+				flags |= std::regex_constants::awk;
+			}
+			if (_flags & RegularExpressionFlags::Grep) {
+				flags |= std::regex_constants::grep;
+			}
+			if (_flags & RegularExpressionFlags::Egrep) {
+				flags |= std::regex_constants::egrep;
+			}
+			try {
+				if (flags) {
+					return new std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()), (std::regex_constants::syntax_option_type)flags);
+				} else {
+					return new std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()));
+				}
+			} catch (std::regex_error&) {
+			}
+			return sl_null;
+		}
+
+		static RegExHandle* Create(const StringParam& _pattern, int flags) noexcept
+		{
+			StringData pattern(_pattern);
+			RegExHandle* handle = new RegExHandle;
+			if (!(flags & (RegularExpressionFlags::StdRegex | RegularExpressionFlags::Collate | RegularExpressionFlags::Basic | RegularExpressionFlags::Extended | RegularExpressionFlags::Awk | RegularExpressionFlags::Grep | RegularExpressionFlags::Egrep))) {
+				sl_bool flagUnsupported = sl_false;
+				handle->native = NativeRegEx::create(pattern, (flags & RegularExpressionFlags::Icase) != 0, flagUnsupported);
+				if (handle->native) {
+					handle->pattern = pattern.toString(_pattern);
+					handle->flags = flags;
+					return handle;
+				}
+				if (!flagUnsupported) {
+					// invalid pattern
+					delete handle;
 					return sl_null;
 				}
+			}
+			handle->stdRegex = CreateStd(pattern, flags);
+			if (handle->stdRegex) {
 				return handle;
 			}
+			delete handle;
 			return sl_null;
 		}
 
 		static void DeleteRegExHandle(void* _handle) noexcept
 		{
-			std::regex* handle = reinterpret_cast<std::regex*>(_handle);
+			RegExHandle* handle = reinterpret_cast<RegExHandle*>(_handle);
 			if (handle) {
-				handle->~basic_regex();
-				Base::freeMemory(handle);
+				delete handle;
 			}
 		}
 
-	}
-
-	SLIB_DEFINE_HANDLE_CONTAINER_MEMBERS(RegularExpression, HRegEx, m_handle, sl_null, DeleteRegExHandle)
-
-	RegularExpression::RegularExpression(const StringParam& pattern) noexcept
-	{
-		m_handle = reinterpret_cast<HRegEx>(Create(pattern, 0));
-	}
-
-	RegularExpression::RegularExpression(const StringParam& pattern, const RegularExpressionFlags& flags) noexcept
-	{
-		m_handle = reinterpret_cast<HRegEx>(Create(pattern, flags));
-	}
-
-	sl_bool RegularExpression::match(const StringParam& _str, const RegularExpressionMatchFlags& _flags) noexcept
-	{
-		std::regex* handle = reinterpret_cast<std::regex*>(m_handle);
-		if (handle) {
-			StringData str(_str);
+		static int GetStdMatchFlags(int v)
+		{
 			int flags = 0;
-			int v = _flags.value;
 			if (v) {
 				if (v & RegularExpressionMatchFlags::NotBol) {
 					flags |= ToInt(std::regex_constants::match_not_bol);
@@ -160,9 +1557,102 @@ namespace slib
 					flags |= ToInt(std::regex_constants::format_first_only);
 				}
 			}
+			return flags;
+		}
+
+		static sl_uint32 GetNativeMatchFlags(int v)
+		{
+			sl_uint32 flags = 0;
+			if (v & RegularExpressionMatchFlags::NotBol) {
+				flags |= STATE_NOT_BOL;
+			}
+			if (v & RegularExpressionMatchFlags::NotEol) {
+				flags |= STATE_NOT_EOL;
+			}
+			if (v & RegularExpressionMatchFlags::NotBow) {
+				flags |= STATE_NOT_BOW;
+			}
+			if (v & RegularExpressionMatchFlags::NotEow) {
+				flags |= STATE_NOT_EOW;
+			}
+			return flags;
+		}
+
+		static std::regex* GetStdRegex(RegExHandle* handle)
+		{
+			std::regex* ret = handle->stdRegex;
+			if (ret) {
+				return ret;
+			}
+			SpinLocker locker(&(handle->lock));
+			ret = handle->stdRegex;
+			if (ret) {
+				return ret;
+			}
+			StringData pattern(handle->pattern);
+			ret = CreateStd(pattern, handle->flags);
+			handle->stdRegex = ret;
+			return ret;
+		}
+
+		// the native engine does not handle these flags
+#define STD_ONLY_MATCH_FLAGS (RegularExpressionMatchFlags::NotNull | RegularExpressionMatchFlags::PrevAvail)
+
+		static sl_bool Execute(RegExHandle* handle, const StringParam& _str, int flags, sl_bool flagSearch) noexcept
+		{
+			StringData str(_str);
 			const char* start = (char*)(str.getData());
-			const char* end = start + str.getLength();
-			return std::regex_match(start, end, *handle, (std::regex_constants::match_flag_type)flags);
+			sl_size len = str.getLength();
+			if (handle->native && !(flags & STD_ONLY_MATCH_FLAGS)) {
+				sl_uint32 f = GetNativeMatchFlags(flags);
+				if (flagSearch) {
+					f |= STATE_PARTIAL;
+					if (!(flags & RegularExpressionMatchFlags::Continuous)) {
+						f |= STATE_SEARCH;
+					}
+				}
+				return handle->native->execute((const sl_uint8*)start, len, f);
+			}
+			std::regex* stdRegex = GetStdRegex(handle);
+			if (!stdRegex) {
+				return sl_false;
+			}
+			const char* end = start + len;
+			if (flagSearch) {
+				return std::regex_search(start, end, *stdRegex, (std::regex_constants::match_flag_type)GetStdMatchFlags(flags));
+			} else {
+				return std::regex_match(start, end, *stdRegex, (std::regex_constants::match_flag_type)GetStdMatchFlags(flags));
+			}
+		}
+
+	}
+
+	SLIB_DEFINE_HANDLE_CONTAINER_MEMBERS(RegularExpression, HRegEx, m_handle, sl_null, DeleteRegExHandle)
+
+	RegularExpression::RegularExpression(const StringParam& pattern) noexcept
+	{
+		m_handle = reinterpret_cast<HRegEx>(Create(pattern, 0));
+	}
+
+	RegularExpression::RegularExpression(const StringParam& pattern, const RegularExpressionFlags& flags) noexcept
+	{
+		m_handle = reinterpret_cast<HRegEx>(Create(pattern, flags));
+	}
+
+	sl_bool RegularExpression::match(const StringParam& str, const RegularExpressionMatchFlags& flags) noexcept
+	{
+		RegExHandle* handle = reinterpret_cast<RegExHandle*>(m_handle);
+		if (handle) {
+			return Execute(handle, str, flags.value, sl_false);
+		}
+		return sl_false;
+	}
+
+	sl_bool RegularExpression::search(const StringParam& str, const RegularExpressionMatchFlags& flags) noexcept
+	{
+		RegExHandle* handle = reinterpret_cast<RegExHandle*>(m_handle);
+		if (handle) {
+			return Execute(handle, str, flags.value, sl_true);
 		}
 		return sl_false;
 	}
@@ -23,6 +23,7 @@
 #include "slib/core/spin_lock.h"
 
 #include "slib/system/system.h"
+#include "slib/core/base.h"
 #include "slib/core/swap.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
@@ -148,6 +149,76 @@ namespace slib
 		}
 	}
 
+	// bit 0: current epoch, bits 1~31 and bits 32~62: readers of epoch 0 and 1
+#define EPOCH_LOCK_FLAG_EPOCH 1
+#define EPOCH_LOCK_READERS_SHIFT0 1
+#define EPOCH_LOCK_READERS_SHIFT1 32
+#define EPOCH_LOCK_READERS_MASK 0x7fffffff
+
+	namespace {
+		SLIB_INLINE static sl_uint32 GetEpochReaders(sl_int64 state, sl_uint32 epoch)
+		{
+			return (sl_uint32)((((sl_uint64)state) >> (epoch ? EPOCH_LOCK_READERS_SHIFT1 : EPOCH_LOCK_READERS_SHIFT0)) & EPOCH_LOCK_READERS_MASK);
+		}
+
+		SLIB_INLINE static sl_int64 GetEpochTicket(sl_uint32 epoch)
+		{
+			return (sl_int64)1 << (epoch ? EPOCH_LOCK_READERS_SHIFT1 : EPOCH_LOCK_READERS_SHIFT0);
+		}
+	}
+
+	sl_int32 EpochLock::enter() const noexcept
+	{
+		volatile sl_int64* p = (volatile sl_int64*)(&m_state);
+		for (;;) {
+			sl_uint32 epoch = (sl_uint32)(*p & EPOCH_LOCK_FLAG_EPOCH);
+			sl_int64 ticket = GetEpochTicket(epoch);
+			sl_int64 state = Base::interlockedAdd64(p, ticket);
+			// The reader is waited only if it was counted while its epoch was current.
+			// Otherwise two writers could advance the epoch twice between reading the epoch and counting, and neither would wait for the reader.
+			if ((sl_uint32)(state & EPOCH_LOCK_FLAG_EPOCH) == epoch) {
+				return (sl_int32)epoch;
+			}
+			Base::interlockedAdd64(p, -ticket);
+		}
+	}
+
+	void EpochLock::leave(sl_int32 ticket) const noexcept
+	{
+		Base::interlockedAdd64((volatile sl_int64*)(&m_state), -GetEpochTicket((sl_uint32)ticket));
+	}
+
+	void EpochLock::lock() const noexcept
+	{
+		// the writers are serialized on a separate word, so that the reader traffic on `m_state` does not delay them
+		m_lockWriting.lock();
+	}
+
+	void EpochLock::unlock() const noexcept
+	{
+		m_lockWriting.unlock();
+	}
+
+	void EpochLock::synchronize() const noexcept
+	{
+		volatile sl_int64* p = (volatile sl_int64*)(&m_state);
+		// only the locked writer changes the epoch bit
+		sl_uint32 epoch = (sl_uint32)(*p & EPOCH_LOCK_FLAG_EPOCH);
+		sl_int64 state = Base::interlockedAdd64(p, epoch ? -1 : 1);
+		sl_uint32 count = 0;
+		while (GetEpochReaders(state, epoch)) {
+			System::yield(count);
+			count++;
+			state = Base::interlockedAdd64(p, 0);
+		}
+	}
+
+	EpochLock& EpochLock::operator=(const EpochLock& other) noexcept
+	{
+		return *this;
+	}
+
+
 	template class SpinLockPool<-10>;
 
 	template class SpinLockPool<-11>;
@@ -4460,6 +4460,9 @@ namespace slib
 		m_lock.lock(); \
 		Container* before = m_container; \
 		m_container = container; \
+		if (before) { \
+			m_lock.synchronize(); \
+		} \
 		m_lock.unlock(); \
 		if (before) { \
 			before->decreaseReference(); \
@@ -4471,12 +4474,12 @@ namespace slib
 		if (!m_container) { \
 			return sl_null; \
 		} \
-		m_lock.lock(); \
+		sl_int32 ticket = m_lock.enter(); \
 		Container* container = m_container; \
 		if (container) { \
 			container->increaseReference_NoSync(); \
 		} \
-		m_lock.unlock(); \
+		m_lock.leave(ticket); \
 		return container; \
 	} \
 	\
@@ -4488,6 +4491,9 @@ namespace slib
 		m_lock.lock(); \
 		Container* container = m_container; \
 		m_container = sl_null; \
+		if (container) { \
+			m_lock.synchronize(); \
+		} \
 		m_lock.unlock(); \
 		return container; \
 	} \
@@ -4497,6 +4503,9 @@ namespace slib
 		m_lock.lock(); \
 		Container* container = m_container; \
 		m_container = *other; \
+		if (container) { \
+			m_lock.synchronize(); \
+		} \
 		*other = container; \
 		m_lock.unlock(); \
 	}
@@ -30,6 +30,7 @@
 #include "slib/core/variant.h"
 #include "slib/core/string_buffer.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/spin_lock.h"
 
 #define TIME_MILLIS SLIB_INT64(1000)
 #define TIME_MILLISF 1000.0
@@ -96,6 +97,14 @@ namespace slib
 		return ret;
 	}
 
+	Time Time::nowCoarse() noexcept
+	{
+		Time ret;
+		ret._setNowCoarse();
+		ret.m_time = ToTimeValue(ret.m_time);
+		return ret;
+	}
+
 	Time Time::withMicroseconds(sl_int64 s) noexcept
 	{
 		return s;
@@ -438,12 +447,21 @@ namespace slib
 		day += d;
 		sl_int64 t;
 		if (zone.isNull()) {
-			t = _toSeconds(year, month, day, sl_false);
+			Ref<ZoneInfoTimeZone> local = ZoneInfoTimeZone::getLocal();
+			if (local.isNotNull()) {
+				// offset at the given time, not at the midnight
+				t = _toSeconds(year, month, day, sl_true);
+				t -= local->getOffsetForLocal(t + s / TIME_SECOND);
+			} else {
+				t = _toSeconds(year, month, day, sl_false);
+			}
 		} else if (zone.isUTC()) {
 			t = _toSeconds(year, month, day, sl_true);
 		} else {
 			t = _toSeconds(year, month, day, sl_true);
-			t -= zone.getOffset(t);
+			sl_int64 local = t + s / TIME_SECOND;
+			sl_int64 offset = zone.getOffset(Time::withSeconds(local));
+			t -= zone.getOffset(Time::withSeconds(local - offset));
 		}
 		m_time = ToTimeValue(t * TIME_SECOND + s);
 		return *this;
@@ -2594,6 +2612,65 @@ namespace slib
 	}
 
 
+	namespace {
+
+		class TimeTextCache
+		{
+		public:
+			SpinLock lock;
+			sl_int64 second;
+			String text;
+
+		public:
+			TimeTextCache(): second(-1) {}
+
+		public:
+			template <class FORMAT>
+			String get(const FORMAT& format)
+			{
+				sl_int64 now = Time::nowCoarse().getSecondCount();
+				{
+					SpinLocker locker(&lock);
+					if (now == second) {
+						return text;
+					}
+				}
+				String ret = format(Time::withSeconds(now));
+				SpinLocker locker(&lock);
+				if (now > second) {
+					second = now;
+					text = ret;
+				}
+				return ret;
+			}
+
+		};
+
+	}
+
+	String CachedTimeText::getLocalString() noexcept
+	{
+		SLIB_SAFE_LOCAL_STATIC(TimeTextCache, cache)
+		if (SLIB_SAFE_STATIC_CHECK_FREED(cache)) {
+			return Time::now().toString();
+		}
+		return cache.get([](const Time& time) {
+			return time.toString();
+		});
+	}
+
+	String CachedTimeText::getHttpDate() noexcept
+	{
+		SLIB_SAFE_LOCAL_STATIC(TimeTextCache, cache)
+		if (SLIB_SAFE_STATIC_CHECK_FREED(cache)) {
+			return Time::now().toHttpDate();
+		}
+		return cache.get([](const Time& time) {
+			return time.toHttpDate();
+		});
+	}
+
+
 	SLIB_DEFINE_ROOT_OBJECT(CTimeZone)
 
 	CTimeZone::CTimeZone() noexcept
@@ -2665,7 +2742,7 @@ namespace slib
 			if (isUTC()) {
 				return 0;
 			}
-			return obj->getOffset();
+			return obj->getOffset(time);
 		}
 		return time.getLocalTimeOffset();
 	}
@@ -25,6 +25,7 @@
 #if defined(SLIB_PLATFORM_IS_UNIX)
 
 #include "slib/core/time.h"
+#include "slib/core/time_zone.h"
 
 #include <time.h>
 #include <sys/time.h>
@@ -37,16 +38,19 @@ namespace slib
 
 	sl_bool Time::_toPlatformComponents(TimeComponents& output, sl_int64 _t, sl_bool flagUTC) noexcept
 	{
+		if (flagUTC) {
+			// calculated without `gmtime_r()`, which takes the global lock of libc
+			return sl_false;
+		}
+		Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::getLocal();
+		if (zone.isNotNull()) {
+			_toComponents(output, _t + zone->getOffsetAt(_t), sl_true);
+			return sl_true;
+		}
 		time_t t = (time_t)_t;
 		tm v;
-		if (flagUTC) {
-			if (!(gmtime_r(&t, &v))) {
-				return sl_false;
-			}
-		} else {
-			if (!(localtime_r(&t, &v))) {
-				return sl_false;
-			}
+		if (!(localtime_r(&t, &v))) {
+			return sl_false;
 		}
 		output.year = v.tm_year + 1900;
 		output.month = v.tm_mon + 1;
@@ -60,17 +64,21 @@ namespace slib
 
 	sl_bool Time::_toPlatformSeconds(sl_int64& output, sl_int32 year, sl_int32 month, sl_int32 day, sl_bool flagUTC) noexcept
 	{
+		if (flagUTC) {
+			return sl_false;
+		}
+		Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::getLocal();
+		if (zone.isNotNull()) {
+			sl_int64 t = _toSeconds(year, month, day, sl_true);
+			output = t - zone->getOffsetForLocal(t);
+			return sl_true;
+		}
 		tm v = {0};
 		v.tm_year = year - 1900;
 		v.tm_mon = month - 1;
 		v.tm_mday = day;
 		v.tm_isdst = -1;
-		time_t t;
-		if (flagUTC) {
-			t = timegm(&v);
-		} else {
-			t = mktime(&v);
-		}
+		time_t t = mktime(&v);
 		if (t == (time_t)-1 && errno == EOVERFLOW) {
 			return sl_false;
 		}
@@ -93,6 +101,18 @@ namespace slib
 		m_time = t;
 	}
 
+	void Time::_setNowCoarse() noexcept
+	{
+#if defined(CLOCK_REALTIME_COARSE)
+		timespec ts;
+		if (!(clock_gettime(CLOCK_REALTIME_COARSE, &ts))) {
+			m_time = (sl_int64)(ts.tv_sec) * TIME_SECOND + ts.tv_nsec / 1000;
+			return;
+		}
+#endif
+		_setNow();
+	}
+
 	sl_bool Time::_setToSystem() const noexcept
 	{
 		sl_int64 t = m_time;
@@ -109,6 +129,10 @@ namespace slib
 
 	sl_int64 Time::getLocalTimeOffset(sl_int32 year, sl_int32 month, sl_int32 day) noexcept
 	{
+		Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::getLocal();
+		if (zone.isNotNull()) {
+			return zone->getOffsetForLocal(_toSeconds(year, month, day, sl_true));
+		}
 		tm v = {0};
 		v.tm_year = year - 1900;
 		v.tm_mon = month - 1;
@@ -68,6 +68,12 @@ namespace slib
 		setWindowsFileTime(n);
 	}
 
+	void Time::_setNowCoarse() noexcept
+	{
+		// `GetSystemTimeAsFileTime()` is updated at every clock tick
+		_setNow();
+	}
+
 	sl_bool Time::_setToSystem() const noexcept
 	{
 #if defined(SLIB_PLATFORM_IS_WIN32)
@@ -0,0 +1,676 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/core/time_zone.h"
+
+#include "slib/core/time.h"
+#include "slib/core/string.h"
+#include "slib/core/charset.h"
+#include "slib/core/list.h"
+#include "slib/core/safe_static.h"
+#include "slib/core/spin_lock.h"
+#include "slib/io/file.h"
+#include "slib/system/system.h"
+
+#define LOCAL_TIME_PATH "/etc/localtime"
+// milliseconds between the checks of `TZ` and `/etc/localtime`
+#define LOCAL_ZONE_CHECK_INTERVAL 1000
+
+namespace slib
+{
+
+	namespace {
+
+		SLIB_INLINE static sl_int64 DivFloor(sl_int64 n, sl_int64 m)
+		{
+			sl_int64 q = n / m;
+			if ((n % m) < 0) {
+				q--;
+			}
+			return q;
+		}
+
+		SLIB_INLINE static sl_bool IsLeapYear(sl_int64 year)
+		{
+			return !(year & 3) && ((year % 100) || !(year % 400));
+		}
+
+		// days since 1970-01-01 of the proleptic Gregorian date
+		static sl_int64 GetDaysFromCivil(sl_int64 year, sl_uint32 month, sl_uint32 day)
+		{
+			if (month <= 2) {
+				year--;
+			}
+			sl_int64 era = DivFloor(year, 400);
+			sl_uint32 yoe = (sl_uint32)(year - era * 400);
+			sl_uint32 doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+			sl_uint32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+			return era * 146097 + (sl_int64)doe - 719468;
+		}
+
+		static sl_int64 GetYearFromDays(sl_int64 days)
+		{
+			days += 719468;
+			sl_int64 era = DivFloor(days, 146097);
+			sl_uint32 doe = (sl_uint32)(days - era * 146097);
+			sl_uint32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+			sl_uint32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+			sl_uint32 mp = (5 * doy + 2) / 153;
+			sl_int64 year = (sl_int64)yoe + era * 400;
+			if (mp >= 10) {
+				year++;
+			}
+			return year;
+		}
+
+		static sl_int64 GetTransitionLocalTime(const ZoneInfoRule::Transition& t, sl_int64 year)
+		{
+			sl_int64 days;
+			if (t.type == 'J') {
+				sl_int64 d = t.day - 1;
+				if (t.day >= 60 && IsLeapYear(year)) {
+					d++;
+				}
+				days = GetDaysFromCivil(year, 1, 1) + d;
+			} else if (t.type == 'N') {
+				days = GetDaysFromCivil(year, 1, 1) + t.day;
+			} else {
+				sl_int64 first = GetDaysFromCivil(year, t.month, 1);
+				sl_int64 next = t.month == 12 ? GetDaysFromCivil(year + 1, 1, 1) : GetDaysFromCivil(year, t.month + 1, 1);
+				// January 1, 1970 was a Thursday
+				sl_int32 weekdayFirst = (sl_int32)(first + 4 - DivFloor(first + 4, 7) * 7);
+				sl_int64 d = (t.dayOfWeek - weekdayFirst + 7) % 7 + (t.week - 1) * 7;
+				while (d >= next - first) {
+					d -= 7;
+				}
+				days = first + d;
+			}
+			return days * 86400 + t.time;
+		}
+
+		class RuleParser
+		{
+		public:
+			const sl_char8* s;
+			sl_size n;
+			sl_size pos;
+
+		public:
+			sl_bool isEnd()
+			{
+				return pos >= n;
+			}
+
+			sl_bool skip(sl_char8 c)
+			{
+				if (pos < n && s[pos] == c) {
+					pos++;
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			sl_bool parseName()
+			{
+				if (skip('<')) {
+					sl_size start = pos;
+					while (pos < n && s[pos] != '>') {
+						pos++;
+					}
+					if (pos >= n || pos == start) {
+						return sl_false;
+					}
+					pos++;
+					return sl_true;
+				}
+				sl_size start = pos;
+				while (pos < n && SLIB_CHAR_IS_ALPHA(s[pos])) {
+					pos++;
+				}
+				return pos - start >= 3;
+			}
+
+			sl_bool parseNumber(sl_uint32 max, sl_uint32& _out)
+			{
+				sl_size start = pos;
+				sl_uint32 v = 0;
+				while (pos < n && SLIB_CHAR_IS_DIGIT(s[pos])) {
+					v = v * 10 + (s[pos] - '0');
+					if (v > max) {
+						return sl_false;
+					}
+					pos++;
+				}
+				if (pos == start) {
+					return sl_false;
+				}
+				_out = v;
+				return sl_true;
+			}
+
+			// [+|-]hh[:mm[:ss]]
+			sl_bool parseTime(sl_uint32 maxHours, sl_int32& _out)
+			{
+				sl_bool flagNegative = sl_false;
+				if (skip('-')) {
+					flagNegative = sl_true;
+				} else {
+					skip('+');
+				}
+				sl_uint32 h, m = 0, sec = 0;
+				if (!(parseNumber(maxHours, h))) {
+					return sl_false;
+				}
+				if (skip(':')) {
+					if (!(parseNumber(59, m))) {
+						return sl_false;
+					}
+					if (skip(':')) {
+						if (!(parseNumber(59, sec))) {
+							return sl_false;
+						}
+					}
+				}
+				sl_int32 v = (sl_int32)(h * 3600 + m * 60 + sec);
+				_out = flagNegative ? -v : v;
+				return sl_true;
+			}
+
+			sl_bool parseTransition(ZoneInfoRule::Transition& t)
+			{
+				sl_uint32 v;
+				if (skip('J')) {
+					if (!(parseNumber(365, v)) || !v) {
+						return sl_false;
+					}
+					t.type = 'J';
+					t.day = (sl_uint16)v;
+				} else if (skip('M')) {
+					sl_uint32 w, d;
+					if (!(parseNumber(12, v) && v && skip('.') && parseNumber(5, w) && w && skip('.') && parseNumber(6, d))) {
+						return sl_false;
+					}
+					t.type = 'M';
+					t.month = (sl_uint8)v;
+					t.week = (sl_uint8)w;
+					t.dayOfWeek = (sl_uint8)d;
+				} else {
+					if (!(parseNumber(365, v))) {
+						return sl_false;
+					}
+					t.type = 'N';
+					t.day = (sl_uint16)v;
+				}
+				t.time = 7200;
+				if (skip('/')) {
+					// RFC 8536 allows -167 ~ 167 hours
+					return parseTime(167, t.time);
+				}
+				return sl_true;
+			}
+
+		};
+
+		static void SetTransition(ZoneInfoRule::Transition& t, sl_uint8 month, sl_uint8 week)
+		{
+			t.type = 'M';
+			t.month = month;
+			t.week = week;
+			t.dayOfWeek = 0;
+			t.day = 0;
+			t.time = 7200;
+		}
+
+		SLIB_INLINE static sl_uint32 ReadUint32(const sl_uint8* p)
+		{
+			return ((sl_uint32)(p[0]) << 24) | ((sl_uint32)(p[1]) << 16) | ((sl_uint32)(p[2]) << 8) | (sl_uint32)(p[3]);
+		}
+
+		SLIB_INLINE static sl_int64 ReadInt64(const sl_uint8* p)
+		{
+			return (sl_int64)(((sl_uint64)(ReadUint32(p)) << 32) | ReadUint32(p + 4));
+		}
+
+		class ZoneInfoHeader
+		{
+		public:
+			sl_uint8 version;
+			sl_uint32 isutcnt;
+			sl_uint32 isstdcnt;
+			sl_uint32 leapcnt;
+			sl_uint32 timecnt;
+			sl_uint32 typecnt;
+			sl_uint32 charcnt;
+
+		public:
+			sl_bool read(const sl_uint8* data, sl_size size)
+			{
+				if (size < 44 || !(Base::equalsMemory(data, "TZif", 4))) {
+					return sl_false;
+				}
+				version = data[4];
+				isutcnt = ReadUint32(data + 20);
+				isstdcnt = ReadUint32(data + 24);
+				leapcnt = ReadUint32(data + 28);
+				timecnt = ReadUint32(data + 32);
+				typecnt = ReadUint32(data + 36);
+				charcnt = ReadUint32(data + 40);
+				return typecnt != 0;
+			}
+
+			sl_uint64 getDataSize(sl_uint32 sizeTime)
+			{
+				return (sl_uint64)timecnt * (sizeTime + 1) + (sl_uint64)typecnt * 6 + charcnt + (sl_uint64)leapcnt * (sizeTime + 4) + isstdcnt + isutcnt;
+			}
+		};
+
+		static const char* g_zoneInfoDirs[] = {
+			"/usr/share/zoneinfo",
+			"/usr/lib/zoneinfo",
+			"/usr/share/lib/zoneinfo"
+		};
+
+		// `tz`: value of `TZ` environment variable (null when not set)
+		static Ref<ZoneInfoTimeZone> LoadLocalZone(String tz)
+		{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+			if (tz.isNotNull()) {
+				if (tz.isEmpty()) {
+					return ZoneInfoTimeZone::createFromRule("UTC0");
+				}
+				if (tz.startsWith(':')) {
+					tz = tz.substring(1);
+				}
+				if (tz.startsWith('/')) {
+					return ZoneInfoTimeZone::loadFromFile(tz);
+				}
+				Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::load(tz);
+				if (zone.isNotNull()) {
+					return zone;
+				}
+				return ZoneInfoTimeZone::createFromRule(tz);
+			}
+			return ZoneInfoTimeZone::loadFromFile(LOCAL_TIME_PATH);
+#else
+			return sl_null;
+#endif
+		}
+
+		class LocalZoneState : public CRef
+		{
+		public:
+			Ref<ZoneInfoTimeZone> zone;
+			// source of the zone
+			String tz;
+			String pathLocalTime;
+			Time timeModified;
+
+		public:
+			sl_bool isSameSource(const String& _tz, const String& _pathLocalTime, const Time& _timeModified)
+			{
+				return tz == _tz && tz.isNull() == _tz.isNull() && pathLocalTime == _pathLocalTime && timeModified == _timeModified;
+			}
+		};
+
+		class LocalZone
+		{
+		public:
+			SpinLock lock;
+			// the states are kept until the exit, so that `current` is read without locking
+			List< Ref<LocalZoneState> > states;
+			LocalZoneState* volatile current = sl_null;
+			volatile sl_uint64 tickChecked = 0;
+		};
+
+	}
+
+	ZoneInfoRule::ZoneInfoRule() noexcept
+	{
+		offsetStandard = 0;
+		offsetDaylight = 0;
+		flagDaylight = sl_false;
+		SetTransition(start, 3, 2);
+		SetTransition(end, 11, 1);
+	}
+
+	sl_bool ZoneInfoRule::parse(const StringView& str) noexcept
+	{
+		RuleParser parser;
+		parser.s = str.getData();
+		parser.n = str.getLength();
+		parser.pos = 0;
+		if (!(parser.parseName())) {
+			return sl_false;
+		}
+		sl_int32 offset;
+		// POSIX offsets are west of UTC
+		if (!(parser.parseTime(24, offset))) {
+			return sl_false;
+		}
+		offsetStandard = -offset;
+		offsetDaylight = offsetStandard;
+		flagDaylight = sl_false;
+		if (parser.isEnd()) {
+			return sl_true;
+		}
+		if (!(parser.parseName())) {
+			return sl_false;
+		}
+		flagDaylight = sl_true;
+		offsetDaylight = offsetStandard + 3600;
+		if (!(parser.isEnd()) && parser.s[parser.pos] != ',') {
+			if (!(parser.parseTime(24, offset))) {
+				return sl_false;
+			}
+			offsetDaylight = -offset;
+		}
+		if (parser.isEnd()) {
+			// rule of the United States
+			SetTransition(start, 3, 2);
+			SetTransition(end, 11, 1);
+			return sl_true;
+		}
+		if (!(parser.skip(',') && parser.parseTransition(start) && parser.skip(',') && parser.parseTransition(end))) {
+			return sl_false;
+		}
+		return parser.isEnd();
+	}
+
+	sl_int32 ZoneInfoRule::getOffset(sl_int64 seconds) const noexcept
+	{
+		if (!flagDaylight) {
+			return offsetStandard;
+		}
+		sl_int64 year = GetYearFromDays(DivFloor(seconds + offsetStandard, 86400));
+		sl_int64 timeStart = GetTransitionLocalTime(start, year) - offsetStandard;
+		sl_int64 timeEnd = GetTransitionLocalTime(end, year) - offsetDaylight;
+		if (timeStart < timeEnd) {
+			// northern hemisphere
+			return (seconds >= timeStart && seconds < timeEnd) ? offsetDaylight : offsetStandard;
+		} else {
+			return (seconds >= timeEnd && seconds < timeStart) ? offsetStandard : offsetDaylight;
+		}
+	}
+
+
+	SLIB_DEFINE_OBJECT(ZoneInfoTimeZone, CTimeZone)
+
+	ZoneInfoTimeZone::ZoneInfoTimeZone()
+	{
+		m_transitionTimes = sl_null;
+		m_transitionOffsets = sl_null;
+		m_nTransitions = 0;
+		m_offsetInitial = 0;
+		m_flagRule = sl_false;
+	}
+
+	ZoneInfoTimeZone::~ZoneInfoTimeZone()
+	{
+	}
+
+	Ref<ZoneInfoTimeZone> ZoneInfoTimeZone::loadFromMemory(const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		ZoneInfoHeader header;
+		if (!(header.read(data, size))) {
+			return sl_null;
+		}
+		sl_uint32 sizeTime = 4;
+		sl_uint64 sizeData = header.getDataSize(4);
+		if (44 + sizeData > size) {
+			return sl_null;
+		}
+		if (header.version >= '2') {
+			// version 2+ data block with 64-bit times
+			data += 44 + sizeData;
+			size -= (sl_size)(44 + sizeData);
+			if (!(header.read(data, size))) {
+				return sl_null;
+			}
+			sizeTime = 8;
+			sizeData = header.getDataSize(8);
+			if (44 + sizeData > size) {
+				return sl_null;
+			}
+		}
+		const sl_uint8* times = data + 44;
+		const sl_uint8* indices = times + (sl_size)header.timecnt * sizeTime;
+		const sl_uint8* types = indices + header.timecnt;
+		sl_uint32 nTransitions = header.timecnt;
+
+		Ref<ZoneInfoTimeZone> ret = new ZoneInfoTimeZone;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		if (nTransitions) {
+			Memory mem = Memory::create((sl_size)nTransitions * (sizeof(sl_int64) + sizeof(sl_int32)));
+			if (mem.isNull()) {
+				return sl_null;
+			}
+			sl_int64* outTimes = (sl_int64*)(mem.getData());
+			sl_int32* outOffsets = (sl_int32*)(outTimes + nTransitions);
+			for (sl_uint32 i = 0; i < nTransitions; i++) {
+				if (sizeTime == 8) {
+					outTimes[i] = ReadInt64(times + i * 8);
+				} else {
+					outTimes[i] = (sl_int32)(ReadUint32(times + i * 4));
+				}
+				if (i && outTimes[i] <= outTimes[i - 1]) {
+					return sl_null;
+				}
+				sl_uint32 index = indices[i];
+				if (index >= header.typecnt) {
+					return sl_null;
+				}
+				outOffsets[i] = (sl_int32)(ReadUint32(types + index * 6));
+			}
+			ret->m_memTransitions = Move(mem);
+			ret->m_transitionTimes = outTimes;
+			ret->m_transitionOffsets = outOffsets;
+			ret->m_nTransitions = nTransitions;
+		}
+		// local time type 0 applies before the first transition
+		ret->m_offsetInitial = (sl_int32)(ReadUint32(types));
+		if (sizeTime == 8) {
+			// footer: POSIX TZ rule for the times after the last transition
+			const sl_char8* footer = (const sl_char8*)(data + 44 + sizeData);
+			const sl_char8* end = (const sl_char8*)(data + size);
+			if (footer < end && *footer == '\n') {
+				footer++;
+				const sl_char8* p = footer;
+				while (p < end && *p != '\n') {
+					p++;
+				}
+				if (p < end && p > footer) {
+					ret->m_flagRule = ret->m_rule.parse(StringView(footer, p - footer));
+				}
+			}
+		}
+		return ret;
+	}
+
+	Ref<ZoneInfoTimeZone> ZoneInfoTimeZone::loadFromFile(const StringParam& path)
+	{
+		Memory mem = File::readAllBytes(path, 0x100000);
+		if (mem.isNull()) {
+			return sl_null;
+		}
+		return loadFromMemory(mem.getData(), mem.getSize());
+	}
+
+	Ref<ZoneInfoTimeZone> ZoneInfoTimeZone::load(const StringParam& _name)
+	{
+		StringData name(_name);
+		if (name.isEmpty() || name.startsWith('/') || name.contains("..")) {
+			return sl_null;
+		}
+		String dir = System::getEnvironmentVariable("TZDIR");
+		if (dir.isNotEmpty()) {
+			Ref<ZoneInfoTimeZone> ret = loadFromFile(File::concatPath(dir, name));
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
+		for (sl_size i = 0; i < CountOfArray(g_zoneInfoDirs); i++) {
+			String path = File::concatPath(g_zoneInfoDirs[i], name);
+			if (File::isFile(path)) {
+				return loadFromFile(path);
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<ZoneInfoTimeZone> ZoneInfoTimeZone::createFromRule(const StringParam& _rule)
+	{
+		StringData rule(_rule);
+		Ref<ZoneInfoTimeZone> ret = new ZoneInfoTimeZone;
+		if (ret.isNotNull()) {
+			if (ret->m_rule.parse(rule)) {
+				ret->m_flagRule = sl_true;
+				ret->m_offsetInitial = ret->m_rule.offsetStandard;
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<ZoneInfoTimeZone> ZoneInfoTimeZone::getLocal() noexcept
+	{
+		SLIB_SAFE_LOCAL_STATIC(LocalZone, local)
+		if (SLIB_SAFE_STATIC_CHECK_FREED(local)) {
+			return sl_null;
+		}
+		sl_uint64 tick = System::getTickCount64();
+		LocalZoneState* state = local.current;
+		if (state && tick - local.tickChecked < LOCAL_ZONE_CHECK_INTERVAL) {
+			return state->zone;
+		}
+		{
+			SpinLocker lock(&(local.lock));
+			state = local.current;
+			if (state) {
+				if (tick - local.tickChecked < LOCAL_ZONE_CHECK_INTERVAL) {
+					return state->zone;
+				}
+				// the other threads keep using the current zone while this thread checks the source
+				local.tickChecked = tick;
+			}
+		}
+		String tz = System::getEnvironmentVariable("TZ");
+		String pathLocalTime;
+		Time timeModified;
+#if defined(SLIB_PLATFORM_IS_UNIX)
+		if (tz.isNull()) {
+			// `/etc/localtime` is usually a symbolic link into the zone database
+			pathLocalTime = File::getRealPath(LOCAL_TIME_PATH);
+			timeModified = File::getModifiedTime(LOCAL_TIME_PATH);
+		}
+#endif
+		if (state && state->isSameSource(tz, pathLocalTime, timeModified)) {
+			return state->zone;
+		}
+		Ref<LocalZoneState> stateNew = new LocalZoneState;
+		if (stateNew.isNull()) {
+			return sl_null;
+		}
+		stateNew->zone = LoadLocalZone(tz);
+		stateNew->tz = Move(tz);
+		stateNew->pathLocalTime = Move(pathLocalTime);
+		stateNew->timeModified = timeModified;
+		SpinLocker lock(&(local.lock));
+		if (!(local.states.add_NoLock(stateNew))) {
+			return stateNew->zone;
+		}
+		// publishes the state after its members are written
+		Base::interlockedCompareExchangePtr((volatile void**)&(local.current), stateNew.get(), local.current);
+		local.tickChecked = tick;
+		return stateNew->zone;
+	}
+
+	sl_int64 ZoneInfoTimeZone::getOffset(const Time& time)
+	{
+		return getOffsetAt(DivFloor(time.toInt(), 1000000));
+	}
+
+	sl_int32 ZoneInfoTimeZone::getOffsetAt(sl_int64 seconds) noexcept
+	{
+		sl_size n = m_nTransitions;
+		if (!n) {
+			if (m_flagRule) {
+				return m_rule.getOffset(seconds);
+			}
+			return m_offsetInitial;
+		}
+		const sl_int64* times = m_transitionTimes;
+		if (seconds < times[0]) {
+			return m_offsetInitial;
+		}
+		if (seconds >= times[n - 1]) {
+			if (m_flagRule) {
+				return m_rule.getOffset(seconds);
+			}
+			return m_transitionOffsets[n - 1];
+		}
+		// last transition not after `seconds`
+		sl_size low = 0;
+		sl_size high = n - 1;
+		while (low + 1 < high) {
+			sl_size mid = (low + high) >> 1;
+			if (times[mid] <= seconds) {
+				low = mid;
+			} else {
+				high = mid;
+			}
+		}
+		return m_transitionOffsets[low];
+	}
+
+	sl_int32 ZoneInfoTimeZone::getOffsetForLocal(sl_int64 localSeconds) noexcept
+	{
+		sl_int32 offset1 = getOffsetAt(localSeconds);
+		sl_int32 offset2 = getOffsetAt(localSeconds - offset1);
+		if (offset1 == offset2) {
+			return offset1;
+		}
+		sl_int32 offset3 = getOffsetAt(localSeconds - offset2);
+		if (offset3 == offset2) {
+			return offset2;
+		}
+		// skipped local time (gap): uses the offset before the transition
+		return offset1 < offset2 ? offset1 : offset2;
+	}
+
+	sl_size ZoneInfoTimeZone::getTransitionCount() noexcept
+	{
+		return m_nTransitions;
+	}
+
+	const ZoneInfoRule* ZoneInfoTimeZone::getRule() noexcept
+	{
+		if (m_flagRule) {
+			return &m_rule;
+		}
+		return sl_null;
+	}
+
+}
@@ -39,6 +39,8 @@ namespace slib
 		m_maxConcurrentThread = 1;
 
 		m_flagDispatched = sl_false;
+
+		m_idLoopEntry = 0;
 	}
 
 	Timer::~Timer()
@@ -0,0 +1,443 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/core/timing_wheel.h"
+
+#define LEVEL_COUNT 4
+#define SLOT_BITS 8
+#define SLOT_COUNT 256
+#define SLOT_MASK 255
+#define NULL_INDEX 0xFFFFFFFF
+
+namespace slib
+{
+
+	namespace
+	{
+		enum
+		{
+			NodeState_Free = 0,
+			NodeState_Scheduled = 1,
+			NodeState_Running = 2,
+			NodeState_Cancelled = 3
+		};
+	}
+
+	struct TimingWheel::Node
+	{
+		sl_uint64 expireTick;
+		Function<void()> task;
+		Function<sl_uint64(sl_uint64)> check;
+		sl_uint32 prev;
+		sl_uint32 next;
+		sl_uint32 generation;
+		sl_uint16 slot; // level * SLOT_COUNT + index
+		sl_uint8 state;
+		sl_bool flagRescheduled;
+
+		Node(): expireTick(0), prev(NULL_INDEX), next(NULL_INDEX), generation(1), slot(0), state(NodeState_Free), flagRescheduled(sl_false)
+		{
+		}
+	};
+
+	TimingWheel::TimingWheel(sl_uint64 now, sl_uint32 tickMillis)
+	{
+		if (!tickMillis) {
+			tickMillis = 1;
+		}
+		m_tickMillis = tickMillis;
+		m_currentTick = now / tickMillis;
+		m_nodes = sl_null;
+		m_nNodes = 0;
+		m_capacity = 0;
+		m_freeNode = NULL_INDEX;
+		for (sl_uint32 i = 0; i < LEVEL_COUNT; i++) {
+			for (sl_uint32 k = 0; k < SLOT_COUNT; k++) {
+				m_slots[i][k] = NULL_INDEX;
+				m_slotTails[i][k] = NULL_INDEX;
+			}
+			m_countLevels[i] = 0;
+		}
+		m_count = 0;
+	}
+
+	TimingWheel::~TimingWheel()
+	{
+		if (m_nodes) {
+			delete[] m_nodes;
+		}
+	}
+
+	sl_uint64 TimingWheel::_getTick(sl_uint64 time)
+	{
+		// round up, so that entries never expire early
+		sl_uint64 tick = (time + m_tickMillis - 1) / m_tickMillis;
+		if (tick <= m_currentTick) {
+			tick = m_currentTick + 1;
+		}
+		return tick;
+	}
+
+	void TimingWheel::_link(sl_uint32 index)
+	{
+		Node& node = m_nodes[index];
+		sl_uint64 tick = node.expireTick;
+		if (tick < m_currentTick) {
+			tick = m_currentTick;
+		}
+		sl_uint64 delta = tick - m_currentTick;
+		sl_uint32 level = 0;
+		while (level < LEVEL_COUNT - 1 && delta >= ((sl_uint64)1 << (SLOT_BITS * (level + 1)))) {
+			level++;
+		}
+		if (delta >= ((sl_uint64)1 << (SLOT_BITS * LEVEL_COUNT))) {
+			// beyond the range: parked in the farthest slot and linked again when cascaded
+			tick = m_currentTick + ((sl_uint64)1 << (SLOT_BITS * LEVEL_COUNT)) - 1;
+		}
+		sl_uint32 slot = (sl_uint32)((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+		// appended to the tail, so that the slot keeps the linking order
+		sl_uint32& tail = m_slotTails[level][slot];
+		node.slot = (sl_uint16)(level * SLOT_COUNT + slot);
+		node.prev = tail;
+		node.next = NULL_INDEX;
+		if (tail != NULL_INDEX) {
+			m_nodes[tail].next = index;
+		} else {
+			m_slots[level][slot] = index;
+		}
+		tail = index;
+		node.state = NodeState_Scheduled;
+		m_countLevels[level]++;
+	}
+
+	void TimingWheel::_unlink(sl_uint32 index)
+	{
+		Node& node = m_nodes[index];
+		sl_uint32 level = node.slot / SLOT_COUNT;
+		sl_uint32 slot = node.slot % SLOT_COUNT;
+		if (node.prev != NULL_INDEX) {
+			m_nodes[node.prev].next = node.next;
+		} else {
+			m_slots[level][slot] = node.next;
+		}
+		if (node.next != NULL_INDEX) {
+			m_nodes[node.next].prev = node.prev;
+		} else {
+			m_slotTails[level][slot] = node.prev;
+		}
+		node.prev = NULL_INDEX;
+		node.next = NULL_INDEX;
+		m_countLevels[level]--;
+	}
+
+	void TimingWheel::_free(sl_uint32 index)
+	{
+		Node& node = m_nodes[index];
+		node.task.setNull();
+		node.check.setNull();
+		node.state = NodeState_Free;
+		node.flagRescheduled = sl_false;
+		node.generation++;
+		if (!(node.generation)) {
+			node.generation = 1;
+		}
+		node.next = m_freeNode;
+		m_freeNode = index;
+		m_count--;
+	}
+
+	sl_uint64 TimingWheel::_add(sl_uint64 expireTime, const Function<void()>* task, const Function<sl_uint64(sl_uint64)>* check)
+	{
+		sl_uint32 index = m_freeNode;
+		if (index != NULL_INDEX) {
+			m_freeNode = m_nodes[index].next;
+		} else {
+			if (m_nNodes >= m_capacity) {
+				sl_uint32 capacity = m_capacity ? m_capacity * 2 : 64;
+				Node* nodes = new Node[capacity];
+				if (!nodes) {
+					return 0;
+				}
+				for (sl_uint32 i = 0; i < m_nNodes; i++) {
+					nodes[i] = Move(m_nodes[i]);
+				}
+				if (m_nodes) {
+					delete[] m_nodes;
+				}
+				m_nodes = nodes;
+				m_capacity = capacity;
+			}
+			index = m_nNodes++;
+		}
+		Node& node = m_nodes[index];
+		if (task) {
+			node.task = *task;
+		} else {
+			node.check = *check;
+		}
+		node.expireTick = _getTick(expireTime);
+		m_count++;
+		_link(index);
+		return ((sl_uint64)(node.generation) << 32) | index;
+	}
+
+	TimingWheel::Node* TimingWheel::_getNode(sl_uint64 id)
+	{
+		sl_uint32 index = (sl_uint32)id;
+		if (index >= m_nNodes) {
+			return sl_null;
+		}
+		Node& node = m_nodes[index];
+		if (node.generation != (sl_uint32)(id >> 32) || node.state == NodeState_Free || node.state == NodeState_Cancelled) {
+			return sl_null;
+		}
+		return &node;
+	}
+
+	sl_uint64 TimingWheel::add(sl_uint64 expireTime, const Function<void()>& task)
+	{
+		ObjectLocker lock(this);
+		return add_NoLock(expireTime, task);
+	}
+
+	sl_uint64 TimingWheel::add_NoLock(sl_uint64 expireTime, const Function<void()>& task)
+	{
+		if (task.isNull()) {
+			return 0;
+		}
+		return _add(expireTime, &task, sl_null);
+	}
+
+	sl_uint64 TimingWheel::addDeadline(sl_uint64 expireTime, const Function<sl_uint64(sl_uint64 now)>& check)
+	{
+		ObjectLocker lock(this);
+		return addDeadline_NoLock(expireTime, check);
+	}
+
+	sl_uint64 TimingWheel::addDeadline_NoLock(sl_uint64 expireTime, const Function<sl_uint64(sl_uint64 now)>& check)
+	{
+		if (check.isNull()) {
+			return 0;
+		}
+		return _add(expireTime, sl_null, &check);
+	}
+
+	sl_bool TimingWheel::reschedule(sl_uint64 id, sl_uint64 expireTime)
+	{
+		ObjectLocker lock(this);
+		return reschedule_NoLock(id, expireTime);
+	}
+
+	sl_bool TimingWheel::reschedule_NoLock(sl_uint64 id, sl_uint64 expireTime)
+	{
+		Node* node = _getNode(id);
+		if (!node) {
+			return sl_false;
+		}
+		node->expireTick = _getTick(expireTime);
+		if (node->state == NodeState_Running) {
+			// linked again after the callback returns
+			node->flagRescheduled = sl_true;
+		} else {
+			sl_uint32 index = (sl_uint32)id;
+			_unlink(index);
+			_link(index);
+		}
+		return sl_true;
+	}
+
+	sl_bool TimingWheel::remove(sl_uint64 id)
+	{
+		ObjectLocker lock(this);
+		return remove_NoLock(id);
+	}
+
+	sl_bool TimingWheel::remove_NoLock(sl_uint64 id)
+	{
+		Node* node = _getNode(id);
+		if (!node) {
+			return sl_false;
+		}
+		if (node->state == NodeState_Running) {
+			node->state = NodeState_Cancelled;
+		} else {
+			sl_uint32 index = (sl_uint32)id;
+			_unlink(index);
+			_free(index);
+		}
+		return sl_true;
+	}
+
+	void TimingWheel::removeAll()
+	{
+		ObjectLocker lock(this);
+		for (sl_uint32 i = 0; i < m_nNodes; i++) {
+			Node& node = m_nodes[i];
+			if (node.state == NodeState_Scheduled) {
+				_unlink(i);
+				_free(i);
+			} else if (node.state == NodeState_Running) {
+				node.state = NodeState_Cancelled;
+			}
+		}
+	}
+
+	void TimingWheel::_cascade(sl_uint32 level, sl_uint32 slot)
+	{
+		sl_uint32 index = m_slots[level][slot];
+		m_slots[level][slot] = NULL_INDEX;
+		m_slotTails[level][slot] = NULL_INDEX;
+		while (index != NULL_INDEX) {
+			sl_uint32 next = m_nodes[index].next;
+			m_countLevels[level]--;
+			_link(index);
+			index = next;
+		}
+	}
+
+	void TimingWheel::advance(sl_uint64 now)
+	{
+		sl_uint64 target = now / m_tickMillis;
+		ObjectLocker lock(this);
+		if (!m_count) {
+			if (target > m_currentTick) {
+				m_currentTick = target;
+			}
+			return;
+		}
+		// expired entries in the order of the ticks
+		sl_uint32 indexExpired = NULL_INDEX;
+		sl_uint32 indexExpiredLast = NULL_INDEX;
+		while (m_currentTick < target) {
+			if (!(m_countLevels[0])) {
+				// skip empty ticks up to the next cascading point
+				sl_uint64 boundary = m_currentTick | SLOT_MASK;
+				if (boundary >= target) {
+					m_currentTick = target;
+					break;
+				}
+				m_currentTick = boundary;
+			}
+			m_currentTick++;
+			sl_uint32 level = 0;
+			while (level < LEVEL_COUNT - 1 && !((m_currentTick >> (SLOT_BITS * (level + 1) - SLOT_BITS)) & SLOT_MASK)) {
+				level++;
+			}
+			// cascade from the highest level whose lower digits are all zero
+			for (sl_uint32 k = level; k > 0; k--) {
+				_cascade(k, (sl_uint32)((m_currentTick >> (SLOT_BITS * k)) & SLOT_MASK));
+			}
+			sl_uint32 slot = (sl_uint32)(m_currentTick & SLOT_MASK);
+			sl_uint32 index = m_slots[0][slot];
+			m_slots[0][slot] = NULL_INDEX;
+			m_slotTails[0][slot] = NULL_INDEX;
+			while (index != NULL_INDEX) {
+				Node& node = m_nodes[index];
+				sl_uint32 next = node.next;
+				m_countLevels[0]--;
+				if (node.expireTick > m_currentTick) {
+					_link(index);
+				} else {
+					node.state = NodeState_Running;
+					node.prev = NULL_INDEX;
+					node.next = NULL_INDEX;
+					if (indexExpiredLast != NULL_INDEX) {
+						m_nodes[indexExpiredLast].next = index;
+					} else {
+						indexExpired = index;
+					}
+					indexExpiredLast = index;
+				}
+				index = next;
+			}
+		}
+		while (indexExpired != NULL_INDEX) {
+			Node& node = m_nodes[indexExpired];
+			sl_uint32 index = indexExpired;
+			indexExpired = node.next;
+			node.next = NULL_INDEX;
+			// removed or rescheduled by the callback of the preceding entry
+			if (node.state == NodeState_Cancelled) {
+				_free(index);
+				continue;
+			}
+			if (node.flagRescheduled) {
+				node.flagRescheduled = sl_false;
+				_link(index);
+				continue;
+			}
+			Function<void()> task = node.task;
+			Function<sl_uint64(sl_uint64)> check = node.check;
+			lock.unlock();
+			sl_uint64 timeNext = 0;
+			if (task.isNotNull()) {
+				task();
+			} else {
+				timeNext = check(now);
+			}
+			lock.lock(this);
+			// `m_nodes` may be reallocated in the callback
+			Node& nodeAfter = m_nodes[index];
+			if (nodeAfter.state == NodeState_Cancelled) {
+				_free(index);
+			} else if (nodeAfter.flagRescheduled) {
+				nodeAfter.flagRescheduled = sl_false;
+				_link(index);
+			} else if (timeNext) {
+				nodeAfter.expireTick = _getTick(timeNext);
+				_link(index);
+			} else {
+				_free(index);
+			}
+		}
+	}
+
+	sl_int64 TimingWheel::getNextExpireTime()
+	{
+		ObjectLocker lock(this);
+		if (!m_count) {
+			return -1;
+		}
+		for (sl_uint32 level = 0; level < LEVEL_COUNT; level++) {
+			if (!(m_countLevels[level])) {
+				continue;
+			}
+			sl_uint32 shift = SLOT_BITS * level;
+			sl_uint64 base = m_currentTick >> shift;
+			for (sl_uint32 i = 1; i <= SLOT_COUNT; i++) {
+				sl_uint64 t = base + i;
+				if (m_slots[level][t & SLOT_MASK] != NULL_INDEX) {
+					return (sl_int64)((t << shift) * m_tickMillis);
+				}
+			}
+		}
+		// only running entries
+		return -1;
+	}
+
+	sl_size TimingWheel::getCount()
+	{
+		return m_count;
+	}
+
+}
@@ -0,0 +1,878 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/data/xml_push_parser.h"
+
+#include "slib/io/io.h"
+#include "slib/io/async_stream.h"
+#include "slib/core/list.h"
+
+namespace slib
+{
+
+	namespace
+	{
+
+		class CharBuffer
+		{
+		public:
+			sl_char8* data;
+			sl_size size;
+			sl_size capacity;
+
+		public:
+			CharBuffer(): data(sl_null), size(0), capacity(0)
+			{
+			}
+
+			~CharBuffer()
+			{
+				if (data) {
+					Base::freeMemory(data);
+				}
+			}
+
+		public:
+			sl_bool reserve(sl_size n)
+			{
+				if (n <= capacity) {
+					return sl_true;
+				}
+				sl_size c = capacity ? capacity : 256;
+				while (c < n) {
+					c <<= 1;
+				}
+				sl_char8* p = (sl_char8*)(Base::reallocMemory(data, c));
+				if (!p) {
+					return sl_false;
+				}
+				data = p;
+				capacity = c;
+				return sl_true;
+			}
+
+			sl_bool append(const sl_char8* s, sl_size n)
+			{
+				if (!(reserve(size + n))) {
+					return sl_false;
+				}
+				Base::copyMemory(data + size, s, n);
+				size += n;
+				return sl_true;
+			}
+
+			void clear()
+			{
+				size = 0;
+			}
+
+		};
+
+		enum class MarkupKind
+		{
+			Unknown,
+			StartTag,
+			EndTag,
+			Comment,
+			CDATA,
+			ProcessingInstruction,
+			Declaration
+		};
+
+		SLIB_INLINE static sl_bool IsWhiteSpace(sl_char8 c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		static sl_bool IsWhiteSpaces(const sl_char8* s, sl_size n)
+		{
+			for (sl_size i = 0; i < n; i++) {
+				if (!(IsWhiteSpace(s[i]))) {
+					return sl_false;
+				}
+			}
+			return sl_true;
+		}
+
+		static void AppendUtf8(CharBuffer& out, sl_uint32 code)
+		{
+			sl_char8 s[4];
+			sl_size n;
+			if (code < 0x80) {
+				s[0] = (sl_char8)code;
+				n = 1;
+			} else if (code < 0x800) {
+				s[0] = (sl_char8)(0xC0 | (code >> 6));
+				s[1] = (sl_char8)(0x80 | (code & 0x3F));
+				n = 2;
+			} else if (code < 0x10000) {
+				s[0] = (sl_char8)(0xE0 | (code >> 12));
+				s[1] = (sl_char8)(0x80 | ((code >> 6) & 0x3F));
+				s[2] = (sl_char8)(0x80 | (code & 0x3F));
+				n = 3;
+			} else {
+				s[0] = (sl_char8)(0xF0 | (code >> 18));
+				s[1] = (sl_char8)(0x80 | ((code >> 12) & 0x3F));
+				s[2] = (sl_char8)(0x80 | ((code >> 6) & 0x3F));
+				s[3] = (sl_char8)(0x80 | (code & 0x3F));
+				n = 4;
+			}
+			out.append(s, n);
+		}
+
+		// appends the decoded text to `out`, returns `false` on invalid entity
+		static sl_bool DecodeEntities(const sl_char8* s, sl_size n, CharBuffer& out)
+		{
+			if (!(out.reserve(out.size + n))) {
+				return sl_false;
+			}
+			sl_size start = 0;
+			sl_size i = 0;
+			while (i < n) {
+				if (s[i] != '&') {
+					i++;
+					continue;
+				}
+				out.append(s + start, i - start);
+				sl_size e = i + 1;
+				while (e < n && s[e] != ';' && e - i < 12) {
+					e++;
+				}
+				if (e >= n || s[e] != ';') {
+					return sl_false;
+				}
+				const sl_char8* name = s + i + 1;
+				sl_size len = e - i - 1;
+				if (len >= 2 && name[0] == '#') {
+					sl_uint32 code = 0;
+					sl_size k = 1;
+					sl_uint32 radix = 10;
+					if (name[1] == 'x') {
+						radix = 16;
+						k = 2;
+					}
+					if (k >= len) {
+						return sl_false;
+					}
+					for (; k < len; k++) {
+						sl_char8 c = name[k];
+						sl_uint32 v;
+						if (c >= '0' && c <= '9') {
+							v = c - '0';
+						} else if (radix == 16 && c >= 'a' && c <= 'f') {
+							v = c - 'a' + 10;
+						} else if (radix == 16 && c >= 'A' && c <= 'F') {
+							v = c - 'A' + 10;
+						} else {
+							return sl_false;
+						}
+						code = code * radix + v;
+						if (code > 0x10FFFF) {
+							return sl_false;
+						}
+					}
+					AppendUtf8(out, code);
+				} else if (len == 2 && name[0] == 'l' && name[1] == 't') {
+					out.append("<", 1);
+				} else if (len == 2 && name[0] == 'g' && name[1] == 't') {
+					out.append(">", 1);
+				} else if (len == 3 && Base::equalsMemory(name, "amp", 3)) {
+					out.append("&", 1);
+				} else if (len == 4 && Base::equalsMemory(name, "quot", 4)) {
+					out.append("\"", 1);
+				} else if (len == 4 && Base::equalsMemory(name, "apos", 4)) {
+					out.append("'", 1);
+				} else {
+					return sl_false;
+				}
+				i = e + 1;
+				start = i;
+			}
+			out.append(s + start, n - start);
+			return sl_true;
+		}
+
+		class XmlPushParserImpl : public XmlPushParser
+		{
+		public:
+			XmlPushParser_Param m_param;
+
+			sl_bool m_flagError;
+			sl_bool m_flagStopped;
+			String m_errorMessage;
+			sl_uint64 m_errorPosition;
+			sl_uint64 m_position;
+			sl_uint32 m_nBom;
+
+			sl_bool m_flagInMarkup;
+			MarkupKind m_kind;
+			sl_size m_lenMarkup;
+			sl_char8 m_prefix;
+			sl_char8 m_quote;
+			sl_uint32 m_run;
+			sl_uint32 m_nBrackets;
+
+			// bytes of the current markup or text kept across chunks
+			CharBuffer m_token;
+			// decoded texts and attribute values
+			CharBuffer m_decoded;
+			List<XmlPushAttribute> m_attributes;
+
+			// names of open elements
+			CharBuffer m_stack;
+			List<sl_size> m_stackOffsets;
+			sl_bool m_flagRootClosed;
+			// a piece of the current text was delivered
+			sl_bool m_flagTextDelivered;
+
+			const sl_char8* m_chunk;
+
+		public:
+			XmlPushParserImpl()
+			{
+				reset();
+			}
+
+		public:
+			void reset() override
+			{
+				m_flagError = sl_false;
+				m_flagStopped = sl_false;
+				m_errorMessage.setNull();
+				m_errorPosition = 0;
+				m_position = 0;
+				m_nBom = 0;
+				m_flagInMarkup = sl_false;
+				startMarkup();
+				m_token.clear();
+				m_stack.clear();
+				m_stackOffsets.removeAll_NoLock();
+				m_flagRootClosed = sl_false;
+				m_flagTextDelivered = sl_false;
+				m_chunk = sl_null;
+			}
+
+			void startMarkup()
+			{
+				m_kind = MarkupKind::Unknown;
+				m_lenMarkup = 0;
+				m_prefix = 0;
+				m_quote = 0;
+				m_run = 0;
+				m_nBrackets = 0;
+			}
+
+			sl_bool setError(const char* message, const sl_char8* pos)
+			{
+				if (!m_flagError) {
+					m_flagError = sl_true;
+					m_errorMessage = message;
+					m_errorPosition = m_position;
+					if (pos && m_chunk) {
+						m_errorPosition += (sl_uint64)(pos - m_chunk);
+					}
+				}
+				return sl_false;
+			}
+
+			sl_bool push(const void* _data, sl_size size) override
+			{
+				if (m_flagError || m_flagStopped) {
+					return sl_false;
+				}
+				const sl_char8* data = (const sl_char8*)_data;
+				const sl_char8* end = data + size;
+				m_chunk = data;
+				const sl_char8* p = data;
+				while (m_nBom < 3 && p < end) {
+					static const sl_char8 bom[] = { (sl_char8)0xEF, (sl_char8)0xBB, (sl_char8)0xBF };
+					if (*p != bom[m_nBom]) {
+						if (m_nBom) {
+							return setError("Invalid byte order mark", p);
+						}
+						m_nBom = 3;
+						break;
+					}
+					m_nBom++;
+					p++;
+				}
+				sl_bool bRet = process(p, end);
+				m_position += size;
+				m_chunk = sl_null;
+				return bRet;
+			}
+
+			sl_bool process(const sl_char8* p, const sl_char8* end)
+			{
+				while (p < end) {
+					if (m_flagStopped) {
+						return sl_false;
+					}
+					if (m_flagInMarkup) {
+						sl_bool flagFound = sl_false;
+						sl_size n = scanMarkup(p, end - p, flagFound);
+						if (m_flagError) {
+							return sl_false;
+						}
+						if (!flagFound) {
+							if (m_token.size + n > m_param.maxTokenSize) {
+								return setError("Markup is too long", p + n);
+							}
+							m_token.append(p, n);
+							return sl_true;
+						}
+						sl_bool bRet;
+						if (m_token.size) {
+							if (!(m_token.append(p, n))) {
+								return setError("Out of memory", p + n);
+							}
+							bRet = dispatchMarkup(m_token.data, m_token.size - 1, p + n);
+							m_token.clear();
+						} else {
+							bRet = dispatchMarkup(p, n - 1, p + n);
+						}
+						if (!bRet) {
+							return sl_false;
+						}
+						p += n;
+						m_flagInMarkup = sl_false;
+					} else {
+						const sl_char8* q = (const sl_char8*)(Base::findMemory(p, end - p, '<'));
+						if (!q) {
+							return appendText(p, end - p);
+						}
+						if (m_token.size) {
+							if (!(m_token.append(p, q - p))) {
+								return setError("Out of memory", q);
+							}
+							sl_bool bRet = emitText(m_token.data, m_token.size, q);
+							m_token.clear();
+							if (!bRet) {
+								return sl_false;
+							}
+						} else if (q > p) {
+							if (!(emitText(p, q - p, q))) {
+								return sl_false;
+							}
+						}
+						p = q + 1;
+						m_flagInMarkup = sl_true;
+						m_flagTextDelivered = sl_false;
+						startMarkup();
+					}
+				}
+				return !m_flagStopped;
+			}
+
+			// text without the closing `<` yet
+			sl_bool appendText(const sl_char8* p, sl_size n)
+			{
+				if (m_token.size + n <= m_param.maxTokenSize) {
+					if (!(m_token.append(p, n))) {
+						return setError("Out of memory", p + n);
+					}
+					return sl_true;
+				}
+				if (!(m_token.append(p, n))) {
+					return setError("Out of memory", p + n);
+				}
+				// deliver the text except an incomplete entity at the end
+				sl_size nKeep = 0;
+				for (sl_size i = m_token.size; i > 0 && m_token.size - i < 12; i--) {
+					sl_char8 c = m_token.data[i - 1];
+					if (c == ';') {
+						break;
+					}
+					if (c == '&') {
+						nKeep = m_token.size - i + 1;
+						break;
+					}
+				}
+				sl_size nEmit = m_token.size - nKeep;
+				if (!(emitText(m_token.data, nEmit, p + n, sl_true))) {
+					return sl_false;
+				}
+				Base::moveMemory(m_token.data, m_token.data + nEmit, nKeep);
+				m_token.size = nKeep;
+				return sl_true;
+			}
+
+			// `flagPiece`: the rest of the text follows
+			sl_bool emitText(const sl_char8* s, sl_size n, const sl_char8* pos, sl_bool flagPiece = sl_false)
+			{
+				if (m_stackOffsets.isEmpty()) {
+					if (!(IsWhiteSpaces(s, n))) {
+						return setError("Text is not allowed outside of the root element", pos);
+					}
+					return sl_true;
+				}
+				if (m_param.flagIgnoreWhiteSpaces && !m_flagTextDelivered) {
+					// once a piece is delivered, the rest of the text is delivered too
+					if (IsWhiteSpaces(s, n)) {
+						return sl_true;
+					}
+				}
+				if (flagPiece) {
+					m_flagTextDelivered = sl_true;
+				}
+				if (m_param.onText.isNull()) {
+					return sl_true;
+				}
+				if (m_param.flagDecodeEntities && Base::findMemory(s, n, '&')) {
+					m_decoded.clear();
+					if (!(DecodeEntities(s, n, m_decoded))) {
+						return setError("Invalid entity", pos);
+					}
+					m_param.onText(this, StringView(m_decoded.data, m_decoded.size));
+				} else {
+					m_param.onText(this, StringView(s, n));
+				}
+				return sl_true;
+			}
+
+			// returns the number of bytes consumed; `flagFound` is set when the closing `>` is consumed
+			sl_size scanMarkup(const sl_char8* p, sl_size n, sl_bool& flagFound)
+			{
+				static const char* prefixCDATA = "![CDATA[";
+				for (sl_size i = 0; i < n; i++) {
+					sl_char8 c = p[i];
+					sl_size index = m_lenMarkup++;
+					if (m_kind == MarkupKind::Unknown) {
+						if (!index) {
+							if (c == '/') {
+								m_kind = MarkupKind::EndTag;
+								continue;
+							} else if (c == '?') {
+								m_kind = MarkupKind::ProcessingInstruction;
+								continue;
+							} else if (c == '!') {
+								continue;
+							}
+							m_kind = MarkupKind::StartTag;
+						} else if (index == 1) {
+							m_prefix = c;
+							if (c == '-' || c == '[') {
+								continue;
+							}
+							m_kind = MarkupKind::Declaration;
+						} else if (m_prefix == '-') {
+							if (c != '-') {
+								setError("Invalid comment", p + i);
+								return i;
+							}
+							m_kind = MarkupKind::Comment;
+							continue;
+						} else {
+							if (c != prefixCDATA[index]) {
+								setError("Invalid CDATA section", p + i);
+								return i;
+							}
+							if (index == 7) {
+								m_kind = MarkupKind::CDATA;
+							}
+							continue;
+						}
+					}
+					switch (m_kind) {
+						case MarkupKind::StartTag:
+						case MarkupKind::EndTag:
+							if (m_quote) {
+								if (c == m_quote) {
+									m_quote = 0;
+								}
+							} else if (c == '>') {
+								flagFound = sl_true;
+								return i + 1;
+							} else if (c == '"' || c == '\'') {
+								m_quote = c;
+							}
+							break;
+						case MarkupKind::Comment:
+						case MarkupKind::CDATA:
+							if (c == '>' && m_run >= 2) {
+								flagFound = sl_true;
+								return i + 1;
+							}
+							if (c == (m_kind == MarkupKind::Comment ? '-' : ']')) {
+								m_run++;
+							} else {
+								m_run = 0;
+							}
+							break;
+						case MarkupKind::ProcessingInstruction:
+							if (c == '>' && m_run) {
+								flagFound = sl_true;
+								return i + 1;
+							}
+							m_run = c == '?';
+							break;
+						default:
+							if (m_quote) {
+								if (c == m_quote) {
+									m_quote = 0;
+								}
+							} else if (c == '"' || c == '\'') {
+								m_quote = c;
+							} else if (c == '[') {
+								m_nBrackets++;
+							} else if (c == ']') {
+								if (m_nBrackets) {
+									m_nBrackets--;
+								}
+							} else if (c == '>' && !m_nBrackets) {
+								flagFound = sl_true;
+								return i + 1;
+							}
+							break;
+					}
+				}
+				return n;
+			}
+
+			// `s`: content between `<` and `>`
+			sl_bool dispatchMarkup(const sl_char8* s, sl_size n, const sl_char8* pos)
+			{
+				switch (m_kind) {
+					case MarkupKind::StartTag:
+						return processStartTag(s, n, pos);
+					case MarkupKind::EndTag:
+						return processEndTag(s + 1, n - 1, pos);
+					case MarkupKind::Comment:
+						if (n < 5) {
+							return setError("Invalid comment", pos);
+						}
+						if (m_param.onComment.isNotNull()) {
+							m_param.onComment(this, StringView(s + 3, n - 5));
+						}
+						return sl_true;
+					case MarkupKind::CDATA:
+						if (m_stackOffsets.isEmpty()) {
+							return setError("CDATA is not allowed outside of the root element", pos);
+						}
+						if (m_param.onCDATA.isNotNull()) {
+							m_param.onCDATA(this, StringView(s + 8, n - 10));
+						}
+						return sl_true;
+					case MarkupKind::ProcessingInstruction:
+						return processProcessingInstruction(s + 1, n - 2, pos);
+					default:
+						// DTD and other declarations are skipped
+						return sl_true;
+				}
+			}
+
+			sl_bool processStartTag(const sl_char8* s, sl_size n, const sl_char8* pos)
+			{
+				sl_bool flagEmpty = sl_false;
+				if (n && s[n - 1] == '/') {
+					flagEmpty = sl_true;
+					n--;
+				}
+				sl_size i = 0;
+				while (i < n && !(IsWhiteSpace(s[i]))) {
+					i++;
+				}
+				if (!i) {
+					return setError("Element name is empty", pos);
+				}
+				StringView name(s, i);
+				if (m_stackOffsets.isEmpty() && m_flagRootClosed) {
+					return setError("Only one root element is allowed", pos);
+				}
+				m_attributes.removeAll_NoLock();
+				m_decoded.clear();
+				if (!(m_decoded.reserve(n))) {
+					return setError("Out of memory", pos);
+				}
+				for (;;) {
+					while (i < n && IsWhiteSpace(s[i])) {
+						i++;
+					}
+					if (i >= n) {
+						break;
+					}
+					sl_size startName = i;
+					while (i < n && s[i] != '=' && !(IsWhiteSpace(s[i]))) {
+						i++;
+					}
+					sl_size endName = i;
+					while (i < n && IsWhiteSpace(s[i])) {
+						i++;
+					}
+					if (i >= n || s[i] != '=' || endName == startName) {
+						return setError("Invalid attribute", pos);
+					}
+					i++;
+					while (i < n && IsWhiteSpace(s[i])) {
+						i++;
+					}
+					if (i >= n || (s[i] != '"' && s[i] != '\'')) {
+						return setError("Attribute value must be quoted", pos);
+					}
+					sl_char8 quote = s[i];
+					i++;
+					sl_size startValue = i;
+					while (i < n && s[i] != quote) {
+						i++;
+					}
+					if (i >= n) {
+						return setError("Invalid attribute", pos);
+					}
+					XmlPushAttribute attr;
+					attr.name = StringView(s + startName, endName - startName);
+					const sl_char8* value = s + startValue;
+					sl_size lenValue = i - startValue;
+					i++;
+					if (m_param.flagDecodeEntities && Base::findMemory(value, lenValue, '&')) {
+						// `m_decoded` is reserved for `n` bytes, so views into it stay valid
+						sl_size start = m_decoded.size;
+						if (!(DecodeEntities(value, lenValue, m_decoded))) {
+							return setError("Invalid entity", pos);
+						}
+						attr.value = StringView(m_decoded.data + start, m_decoded.size - start);
+					} else {
+						attr.value = StringView(value, lenValue);
+					}
+					if (!(m_attributes.add_NoLock(attr))) {
+						return setError("Out of memory", pos);
+					}
+				}
+				if (m_param.onStartElement.isNotNull()) {
+					m_param.onStartElement(this, name, m_attributes.getData(), m_attributes.getCount());
+				}
+				if (flagEmpty) {
+					if (m_param.onEndElement.isNotNull() && !m_flagStopped) {
+						m_param.onEndElement(this, name);
+					}
+					if (m_stackOffsets.isEmpty()) {
+						m_flagRootClosed = sl_true;
+					}
+					return sl_true;
+				}
+				if (m_stackOffsets.getCount() >= m_param.maxDepth) {
+					return setError("Elements are nested too deeply", pos);
+				}
+				if (!(m_stackOffsets.add_NoLock(m_stack.size))) {
+					return setError("Out of memory", pos);
+				}
+				if (!(m_stack.append(name.getData(), name.getLength()))) {
+					return setError("Out of memory", pos);
+				}
+				return sl_true;
+			}
+
+			sl_bool processEndTag(const sl_char8* s, sl_size n, const sl_char8* pos)
+			{
+				while (n && IsWhiteSpace(s[n - 1])) {
+					n--;
+				}
+				sl_size offset;
+				if (!(m_stackOffsets.popBack_NoLock(&offset))) {
+					return setError("Unexpected end tag", pos);
+				}
+				if (m_stack.size - offset != n || !(Base::equalsMemory(m_stack.data + offset, s, n))) {
+					return setError("End tag does not match the start tag", pos);
+				}
+				m_stack.size = offset;
+				if (m_stackOffsets.isEmpty()) {
+					m_flagRootClosed = sl_true;
+				}
+				if (m_param.onEndElement.isNotNull()) {
+					m_param.onEndElement(this, StringView(s, n));
+				}
+				return sl_true;
+			}
+
+			sl_bool processProcessingInstruction(const sl_char8* s, sl_size n, const sl_char8* pos)
+			{
+				sl_size i = 0;
+				while (i < n && !(IsWhiteSpace(s[i]))) {
+					i++;
+				}
+				if (!i) {
+					return setError("Invalid processing instruction", pos);
+				}
+				StringView target(s, i);
+				if (i == 3 && (s[0] | 0x20) == 'x' && (s[1] | 0x20) == 'm' && (s[2] | 0x20) == 'l') {
+					// XML declaration
+					return sl_true;
+				}
+				while (i < n && IsWhiteSpace(s[i])) {
+					i++;
+				}
+				if (m_param.onProcessingInstruction.isNotNull()) {
+					m_param.onProcessingInstruction(this, target, StringView(s + i, n - i));
+				}
+				return sl_true;
+			}
+
+			sl_bool finish() override
+			{
+				if (m_flagError || m_flagStopped) {
+					return sl_false;
+				}
+				if (m_flagInMarkup) {
+					return setError("Unexpected end of document in markup", sl_null);
+				}
+				if (m_token.size) {
+					sl_bool bRet = emitText(m_token.data, m_token.size, sl_null);
+					m_token.clear();
+					if (!bRet) {
+						return sl_false;
+					}
+				}
+				if (m_stackOffsets.isNotEmpty()) {
+					return setError("Unexpected end of document", sl_null);
+				}
+				if (!m_flagRootClosed) {
+					return setError("Root element is missing", sl_null);
+				}
+				return sl_true;
+			}
+
+			void stop() override
+			{
+				m_flagStopped = sl_true;
+			}
+
+			sl_bool isError() override
+			{
+				return m_flagError;
+			}
+
+			String getErrorMessage() override
+			{
+				return m_errorMessage;
+			}
+
+			sl_uint64 getErrorPosition() override
+			{
+				return m_errorPosition;
+			}
+
+			sl_uint64 getPosition() override
+			{
+				return m_position;
+			}
+
+			sl_uint32 getDepth() override
+			{
+				return (sl_uint32)(m_stackOffsets.getCount());
+			}
+
+		};
+
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(XmlPushParser_Param)
+
+	XmlPushParser_Param::XmlPushParser_Param()
+	{
+		maxTokenSize = 1024 * 1024;
+		maxDepth = 1024;
+		flagDecodeEntities = sl_true;
+		flagIgnoreWhiteSpaces = sl_false;
+	}
+
+
+	SLIB_DEFINE_OBJECT(XmlPushParser, Object)
+
+	XmlPushParser::XmlPushParser()
+	{
+	}
+
+	XmlPushParser::~XmlPushParser()
+	{
+	}
+
+	Ref<XmlPushParser> XmlPushParser::create(const XmlPushParser_Param& param)
+	{
+		Ref<XmlPushParserImpl> ret = new XmlPushParserImpl;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			if (!(ret->m_param.maxTokenSize)) {
+				ret->m_param.maxTokenSize = 1;
+			}
+			return ret;
+		}
+		return sl_null;
+	}
+
+	sl_bool XmlPushParser::parse(IReader* reader, sl_size chunkSize)
+	{
+		if (!reader || !chunkSize) {
+			return sl_false;
+		}
+		Memory mem = Memory::create(chunkSize);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		void* buf = mem.getData();
+		for (;;) {
+			sl_reg n = reader->read(buf, chunkSize);
+			if (n > 0) {
+				if (!(push(buf, n))) {
+					return sl_false;
+				}
+			} else if (n == SLIB_IO_ENDED) {
+				return finish();
+			} else if (n != SLIB_IO_WOULD_BLOCK) {
+				return sl_false;
+			}
+		}
+	}
+
+	void XmlPushParser::parse(const Ref<AsyncStream>& stream, const Function<void(XmlPushParser*, sl_bool flagSuccess)>& onComplete, sl_size chunkSize)
+	{
+		Memory mem;
+		if (stream.isNotNull() && chunkSize) {
+			mem = Memory::create(chunkSize);
+		}
+		if (mem.isNull()) {
+			onComplete(this, sl_false);
+			return;
+		}
+		_readAsync(stream, mem, onComplete);
+	}
+
+	void XmlPushParser::_readAsync(const Ref<AsyncStream>& stream, const Memory& mem, const Function<void(XmlPushParser*, sl_bool flagSuccess)>& onComplete)
+	{
+		Ref<XmlPushParser> thiz = this;
+		stream->read(mem, [thiz, stream, mem, onComplete](AsyncStreamResult& result) {
+			if (result.size) {
+				if (!(thiz->push(result.data, result.size))) {
+					onComplete(thiz.get(), sl_false);
+					return;
+				}
+			}
+			if (result.isSuccess()) {
+				thiz->_readAsync(stream, mem, onComplete);
+			} else if (result.isEnded()) {
+				onComplete(thiz.get(), thiz->finish());
+			} else {
+				onComplete(thiz.get(), sl_false);
+			}
+		});
+	}
+
+}
@@ -0,0 +1,939 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/db/async_redis.h"
+
+#include "slib/network/async.h"
+#include "slib/core/linked_list.h"
+#include "slib/core/mutex.h"
+#include "slib/core/log.h"
+
+#include <math.h>
+
+#define TAG "AsyncRedis"
+
+#define READ_BUFFER_SIZE 65536
+#define MAX_REPLY_DEPTH 64
+
+namespace slib
+{
+
+	namespace {
+
+		typedef Function<void(AsyncRedisResult&)> ResultCallback;
+
+		static void FailCallback(const ResultCallback& callback, const String& error)
+		{
+			AsyncRedisResult result;
+			result.error = error;
+			callback(result);
+		}
+
+		class Buffer
+		{
+		public:
+			Memory mem;
+			sl_uint8* data = sl_null;
+			sl_size size = 0;
+			sl_size capacity = 0;
+
+		public:
+			sl_bool reserve(sl_size n)
+			{
+				if (size + n <= capacity) {
+					return sl_true;
+				}
+				sl_size capacityNew = capacity << 1;
+				if (capacityNew < size + n) {
+					capacityNew = size + n;
+				}
+				if (capacityNew < 4096) {
+					capacityNew = 4096;
+				}
+				Memory memNew = Memory::create(capacityNew);
+				if (memNew.isNull()) {
+					return sl_false;
+				}
+				sl_uint8* dataNew = (sl_uint8*)(memNew.getData());
+				if (size) {
+					Base::copyMemory(dataNew, data, size);
+				}
+				mem = Move(memNew);
+				data = dataNew;
+				capacity = capacityNew;
+				return sl_true;
+			}
+
+			sl_bool append(const void* src, sl_size n)
+			{
+				if (!(reserve(n))) {
+					return sl_false;
+				}
+				if (n) {
+					Base::copyMemory(data + size, src, n);
+					size += n;
+				}
+				return sl_true;
+			}
+
+			sl_bool appendHeader(sl_char8 type, sl_size n)
+			{
+				sl_char8 buf[32];
+				sl_size pos = sizeof(buf);
+				buf[--pos] = '\n';
+				buf[--pos] = '\r';
+				do {
+					buf[--pos] = (sl_char8)('0' + n % 10);
+					n /= 10;
+				} while (n);
+				buf[--pos] = type;
+				return append(buf + pos, sizeof(buf) - pos);
+			}
+
+			void removeFront(sl_size n)
+			{
+				if (n >= size) {
+					size = 0;
+				} else if (n) {
+					Base::moveMemory(data, data + n, size - n);
+					size -= n;
+				}
+			}
+
+			void swap(Buffer& other)
+			{
+				Swap(mem, other.mem);
+				Swap(data, other.data);
+				Swap(size, other.size);
+				Swap(capacity, other.capacity);
+			}
+
+		};
+
+		// RESP array of bulk strings
+		static sl_bool AppendCommand(Buffer& buf, const Variant* args, sl_size nArgs)
+		{
+			sl_size sizeOld = buf.size;
+			if (buf.appendHeader('*', nArgs)) {
+				sl_size i = 0;
+				for (; i < nArgs; i++) {
+					const Variant& arg = args[i];
+					if (arg.isMemory()) {
+						Memory mem = arg.getMemory();
+						sl_size n = mem.getSize();
+						if (!(buf.appendHeader('$', n) && buf.append(mem.getData(), n) && buf.append("\r\n", 2))) {
+							break;
+						}
+					} else {
+						String str = arg.getString();
+						sl_size n = str.getLength();
+						if (!(buf.appendHeader('$', n) && buf.append(str.getData(), n) && buf.append("\r\n", 2))) {
+							break;
+						}
+					}
+				}
+				if (i == nArgs) {
+					return sl_true;
+				}
+			}
+			buf.size = sizeOld;
+			return sl_false;
+		}
+
+		static sl_bool ParseInteger(const sl_char8* s, sl_size n, sl_int64& _out)
+		{
+			if (!n) {
+				return sl_false;
+			}
+			sl_bool flagNegative = sl_false;
+			sl_size i = 0;
+			if (s[0] == '-' || s[0] == '+') {
+				flagNegative = s[0] == '-';
+				i = 1;
+				if (n == 1) {
+					return sl_false;
+				}
+			}
+			sl_uint64 v = 0;
+			for (; i < n; i++) {
+				sl_char8 c = s[i];
+				if (c < '0' || c > '9') {
+					return sl_false;
+				}
+				v = v * 10 + (c - '0');
+			}
+			_out = flagNegative ? -(sl_int64)v : (sl_int64)v;
+			return sl_true;
+		}
+
+		static sl_bool ParseDouble(const sl_char8* s, sl_size n, double& _out)
+		{
+			StringView str(s, n);
+			if (str == StringView::literal("inf") || str == StringView::literal("+inf")) {
+				_out = HUGE_VAL;
+				return sl_true;
+			}
+			if (str == StringView::literal("-inf")) {
+				_out = -HUGE_VAL;
+				return sl_true;
+			}
+			if (str == StringView::literal("nan") || str == StringView::literal("-nan")) {
+				_out = NAN;
+				return sl_true;
+			}
+			return String::parseDouble(&_out, s, 0, n) == (sl_reg)n;
+		}
+
+		// returns 1 when a reply is parsed, 0 when more data is needed, -1 on protocol error
+		static sl_int32 ParseReply(const sl_uint8* data, sl_size size, sl_size& pos, Variant& value, String* error, sl_bool* pFlagPush, sl_uint32 depth)
+		{
+			if (depth > MAX_REPLY_DEPTH) {
+				return -1;
+			}
+			if (pos >= size) {
+				return 0;
+			}
+			sl_uint8 type = data[pos];
+			sl_size start = pos + 1;
+			sl_size end = start;
+			for (;;) {
+				if (end + 1 >= size) {
+					return 0;
+				}
+				if (data[end] == '\r' && data[end + 1] == '\n') {
+					break;
+				}
+				end++;
+			}
+			pos = end + 2;
+			const sl_char8* line = (const sl_char8*)(data + start);
+			sl_size lenLine = end - start;
+			switch (type) {
+				case '+':
+				case '(':
+					value = String(line, lenLine);
+					return 1;
+				case '-':
+					if (error) {
+						*error = String(line, lenLine);
+					} else {
+						value = String(line, lenLine);
+					}
+					return 1;
+				case ':':
+					{
+						sl_int64 n;
+						if (!(ParseInteger(line, lenLine, n))) {
+							return -1;
+						}
+						value = n;
+						return 1;
+					}
+				case '_':
+					value.setNull();
+					return 1;
+				case '#':
+					if (lenLine != 1) {
+						return -1;
+					}
+					value = line[0] == 't';
+					return 1;
+				case ',':
+					{
+						double f;
+						if (!(ParseDouble(line, lenLine, f))) {
+							return -1;
+						}
+						value = f;
+						return 1;
+					}
+				case '$':
+				case '!':
+				case '=':
+					{
+						sl_int64 n;
+						if (!(ParseInteger(line, lenLine, n))) {
+							return -1;
+						}
+						if (n < 0) {
+							value.setNull();
+							return 1;
+						}
+						if ((sl_uint64)(size - pos) < (sl_uint64)n + 2) {
+							return 0;
+						}
+						const sl_char8* s = (const sl_char8*)(data + pos);
+						sl_size len = (sl_size)n;
+						pos += len + 2;
+						if (type == '=' && len >= 4 && s[3] == ':') {
+							// verbatim string: skip the format (`txt:`, `mkd:`)
+							s += 4;
+							len -= 4;
+						}
+						if (type == '!' && error) {
+							*error = String(s, len);
+						} else {
+							value = String(s, len);
+						}
+						return 1;
+					}
+				case '*':
+				case '~':
+				case '>':
+					{
+						sl_int64 n;
+						if (!(ParseInteger(line, lenLine, n))) {
+							return -1;
+						}
+						if (n < 0) {
+							value.setNull();
+							return 1;
+						}
+						// each element takes 3 bytes at least
+						if ((sl_uint64)n > (sl_uint64)(size - pos) / 3) {
+							return 0;
+						}
+						VariantList list = VariantList::create((sl_size)n);
+						if (list.isNull() && n) {
+							return -1;
+						}
+						Variant* elements = list.getData();
+						for (sl_size i = 0; i < (sl_size)n; i++) {
+							sl_int32 iRet = ParseReply(data, size, pos, elements[i], sl_null, sl_null, depth + 1);
+							if (iRet <= 0) {
+								return iRet;
+							}
+						}
+						if (type == '>' && pFlagPush) {
+							*pFlagPush = sl_true;
+						}
+						value = Move(list);
+						return 1;
+					}
+				case '%':
+				case '|':
+					{
+						sl_int64 n;
+						if (!(ParseInteger(line, lenLine, n))) {
+							return -1;
+						}
+						if (n < 0) {
+							return -1;
+						}
+						if ((sl_uint64)n > (sl_uint64)(size - pos) / 6) {
+							return 0;
+						}
+						VariantMap map;
+						for (sl_size i = 0; i < (sl_size)n; i++) {
+							Variant k, v;
+							sl_int32 iRet = ParseReply(data, size, pos, k, sl_null, sl_null, depth + 1);
+							if (iRet <= 0) {
+								return iRet;
+							}
+							iRet = ParseReply(data, size, pos, v, sl_null, sl_null, depth + 1);
+							if (iRet <= 0) {
+								return iRet;
+							}
+							if (type == '%') {
+								map.put_NoLock(k.getString(), Move(v));
+							}
+						}
+						if (type == '|') {
+							// attributes are followed by the actual reply
+							return ParseReply(data, size, pos, value, error, pFlagPush, depth);
+						}
+						value = Move(map);
+						return 1;
+					}
+				default:
+					break;
+			}
+			return -1;
+		}
+
+		static sl_uint16 GetCrc16(const sl_uint8* data, sl_size size)
+		{
+			// CRC16-XMODEM (polynomial 0x1021), as used by Redis Cluster
+			sl_uint16 crc = 0;
+			for (sl_size i = 0; i < size; i++) {
+				crc ^= (sl_uint16)(data[i]) << 8;
+				for (sl_uint32 k = 0; k < 8; k++) {
+					if (crc & 0x8000) {
+						crc = (sl_uint16)((crc << 1) ^ 0x1021);
+					} else {
+						crc <<= 1;
+					}
+				}
+			}
+			return crc;
+		}
+
+		class Session : public CRef
+		{
+		public:
+			Ref<AsyncTcpSocket> socket;
+			Memory memRead;
+			Buffer bufParse;
+		};
+
+		class Connection : public CRef
+		{
+		public:
+			WeakRef<AsyncRedis> m_client;
+			SocketAddress m_address;
+			Ref<AsyncIoLoop> m_ioLoop;
+			sl_uint32 m_protocolVersion;
+			String m_password;
+			sl_int32 m_connectTimeout;
+			sl_bool m_flagLogErrors;
+			Function<void(AsyncRedis*, Variant&)> m_onPush;
+
+			Mutex m_lock;
+			Ref<Session> m_session;
+			sl_bool m_flagConnected = sl_false;
+			sl_bool m_flagWriting = sl_false;
+			sl_bool m_flagFlushRequested = sl_false;
+			sl_bool m_flagClosed = sl_false;
+			Buffer m_bufPending;
+			Buffer m_bufWriting;
+			CLinkedList<ResultCallback> m_callbacks;
+
+		public:
+			void execute(const Variant* args, sl_size nArgs, const ResultCallback& callback)
+			{
+				Ref<Session> sessionNew;
+				{
+					MutexLocker lock(&m_lock);
+					if (m_flagClosed) {
+						lock.unlock();
+						FailCallback(callback, "Closed");
+						return;
+					}
+					if (m_session.isNull()) {
+						sessionNew = _createSession();
+						if (sessionNew.isNull()) {
+							lock.unlock();
+							FailCallback(callback, "Failed to create socket");
+							return;
+						}
+					}
+					sl_size sizeOld = m_bufPending.size;
+					if (!(AppendCommand(m_bufPending, args, nArgs) && m_callbacks.pushBack_NoLock(callback))) {
+						m_bufPending.size = sizeOld;
+						lock.unlock();
+						FailCallback(callback, "Out of memory");
+						return;
+					}
+					if (m_flagConnected) {
+						_requestFlush();
+					}
+				}
+				if (sessionNew.isNotNull()) {
+					Ref<Connection> thiz = this;
+					sessionNew->socket->connect(m_address, [thiz, sessionNew](AsyncTcpSocket*, sl_bool flagError) {
+						thiz->_onConnect(sessionNew.get(), flagError);
+					}, m_connectTimeout);
+				}
+			}
+
+			void close()
+			{
+				Ref<Session> session;
+				{
+					MutexLocker lock(&m_lock);
+					m_flagClosed = sl_true;
+					session = m_session;
+				}
+				if (session.isNotNull()) {
+					_onError(session.get(), "Closed");
+				}
+			}
+
+		public:
+			// called in locked context. The handshake commands are queued before any other command
+			Ref<Session> _createSession()
+			{
+				Ref<Session> session = new Session;
+				if (session.isNull()) {
+					return sl_null;
+				}
+				session->memRead = Memory::create(READ_BUFFER_SIZE);
+				if (session->memRead.isNull()) {
+					return sl_null;
+				}
+				AsyncTcpSocketParam param;
+				if (m_address.ip.isIPv6()) {
+					param.socket = Socket::openTcp_IPv6();
+				} else {
+					param.socket = Socket::openTcp();
+				}
+				if (param.socket.isNone()) {
+					return sl_null;
+				}
+				param.socket.setTcpNoDelay();
+				param.ioLoop = m_ioLoop;
+				param.flagLogError = m_flagLogErrors;
+				session->socket = AsyncTcpSocket::create(param);
+				if (session->socket.isNull()) {
+					return sl_null;
+				}
+				m_bufPending.size = 0;
+				if (m_protocolVersion >= 3) {
+					if (m_password.isNotEmpty()) {
+						Variant args[] = { "HELLO", m_protocolVersion, "AUTH", "default", m_password };
+						_queueHandshake(args, CountOfArray(args));
+					} else {
+						Variant args[] = { "HELLO", m_protocolVersion };
+						_queueHandshake(args, CountOfArray(args));
+					}
+				} else if (m_password.isNotEmpty()) {
+					Variant args[] = { "AUTH", m_password };
+					_queueHandshake(args, CountOfArray(args));
+				}
+				m_session = session;
+				m_flagConnected = sl_false;
+				m_flagWriting = sl_false;
+				return session;
+			}
+
+			void _queueHandshake(const Variant* args, sl_size nArgs)
+			{
+				sl_bool flagLog = m_flagLogErrors;
+				String command = args[0].getString();
+				AppendCommand(m_bufPending, args, nArgs);
+				m_callbacks.pushBack_NoLock([flagLog, command](AsyncRedisResult& result) {
+					if (result.isError() && flagLog) {
+						LogError(TAG, "%s failed: %s", command, result.error);
+					}
+				});
+			}
+
+			// called in locked context
+			void _requestFlush()
+			{
+				if (m_flagWriting || m_flagFlushRequested || !(m_bufPending.size)) {
+					return;
+				}
+				// the commands queued until the dispatched task runs are written together
+				m_flagFlushRequested = sl_true;
+				Ref<Connection> thiz = this;
+				m_ioLoop->dispatch([thiz]() {
+					thiz->_flush();
+				});
+			}
+
+			void _flush()
+			{
+				Ref<Session> session;
+				Memory mem;
+				const void* data;
+				sl_size size;
+				{
+					MutexLocker lock(&m_lock);
+					m_flagFlushRequested = sl_false;
+					if (m_flagWriting || !m_flagConnected || !(m_bufPending.size)) {
+						return;
+					}
+					m_bufWriting.swap(m_bufPending);
+					m_bufPending.size = 0;
+					m_flagWriting = sl_true;
+					session = m_session;
+					mem = m_bufWriting.mem;
+					data = m_bufWriting.data;
+					size = m_bufWriting.size;
+				}
+				Ref<Connection> thiz = this;
+				session->socket->write(data, size, [thiz, session, mem](AsyncStreamResult& result) {
+					thiz->_onWrite(session.get(), result);
+				});
+			}
+
+			void _onConnect(Session* session, sl_bool flagError)
+			{
+				if (flagError) {
+					_onError(session, "Failed to connect");
+					return;
+				}
+				{
+					MutexLocker lock(&m_lock);
+					if (m_session != session) {
+						return;
+					}
+					m_flagConnected = sl_true;
+					_requestFlush();
+				}
+				_read(session);
+			}
+
+			void _onWrite(Session* session, AsyncStreamResult& result)
+			{
+				if (!(result.isSuccess())) {
+					_onError(session, "Failed to write");
+					return;
+				}
+				{
+					MutexLocker lock(&m_lock);
+					if (m_session != session) {
+						return;
+					}
+					m_flagWriting = sl_false;
+					m_bufWriting.size = 0;
+					if (!(m_bufPending.size)) {
+						return;
+					}
+					m_flagFlushRequested = sl_true;
+				}
+				_flush();
+			}
+
+			void _read(Session* session)
+			{
+				Ref<Connection> thiz = this;
+				Ref<Session> refSession = session;
+				session->socket->read(session->memRead.getData(), session->memRead.getSize(), [thiz, refSession](AsyncStreamResult& result) {
+					thiz->_onRead(refSession.get(), result);
+				});
+			}
+
+			void _onRead(Session* session, AsyncStreamResult& result)
+			{
+				if (!(result.isSuccess()) || !(result.size)) {
+					_onError(session, result.isEnded() ? "Connection closed" : "Failed to read");
+					return;
+				}
+				{
+					MutexLocker lock(&m_lock);
+					if (m_session != session) {
+						return;
+					}
+				}
+				Buffer& bufParse = session->bufParse;
+				const sl_uint8* data;
+				sl_size size;
+				if (bufParse.size) {
+					if (!(bufParse.append(result.data, result.size))) {
+						_onError(session, "Out of memory");
+						return;
+					}
+					data = bufParse.data;
+					size = bufParse.size;
+				} else {
+					// parses the replies from the read buffer directly, and keeps the incomplete reply only
+					data = (const sl_uint8*)(result.data);
+					size = result.size;
+				}
+				sl_size pos = 0;
+				for (;;) {
+					sl_size start = pos;
+					AsyncRedisResult reply;
+					sl_bool flagPush = sl_false;
+					sl_int32 iRet = ParseReply(data, size, pos, reply.value, &(reply.error), &flagPush, 0);
+					if (iRet < 0) {
+						_onError(session, "Protocol error");
+						return;
+					}
+					if (!iRet) {
+						pos = start;
+						break;
+					}
+					if (flagPush) {
+						_onPush(reply.value);
+						continue;
+					}
+					ResultCallback callback;
+					{
+						MutexLocker lock(&m_lock);
+						if (m_session != session) {
+							return;
+						}
+						if (!(m_callbacks.popFront_NoLock(&callback))) {
+							lock.unlock();
+							_onError(session, "Unexpected reply");
+							return;
+						}
+					}
+					callback(reply);
+				}
+				if (bufParse.size) {
+					bufParse.removeFront(pos);
+				} else if (pos < size) {
+					if (!(bufParse.append(data + pos, size - pos))) {
+						_onError(session, "Out of memory");
+						return;
+					}
+				}
+				{
+					MutexLocker lock(&m_lock);
+					if (m_session != session) {
+						return;
+					}
+				}
+				_read(session);
+			}
+
+			void _onPush(Variant& message)
+			{
+				if (m_onPush.isNull()) {
+					return;
+				}
+				Ref<AsyncRedis> client = m_client;
+				if (client.isNotNull()) {
+					m_onPush(client.get(), message);
+				}
+			}
+
+			// fails the pending commands. The connection is reopened by the next command
+			void _onError(Session* session, const String& error)
+			{
+				CLinkedList<ResultCallback> callbacks;
+				{
+					MutexLocker lock(&m_lock);
+					if (m_session != session) {
+						return;
+					}
+					m_session.setNull();
+					m_flagConnected = sl_false;
+					m_flagWriting = sl_false;
+					m_bufPending.size = 0;
+					callbacks.merge_NoLock(&m_callbacks);
+				}
+				session->socket->close();
+				if (m_flagLogErrors && !m_flagClosed) {
+					LogError(TAG, "%s: %s", m_address.toString(), error);
+				}
+				ResultCallback callback;
+				while (callbacks.popFront_NoLock(&callback)) {
+					FailCallback(callback, error);
+				}
+			}
+
+		};
+
+		class AsyncRedisImpl : public AsyncRedis
+		{
+		public:
+			List< Ref<Connection> > m_connections;
+
+		public:
+			AsyncRedisImpl()
+			{
+			}
+
+			~AsyncRedisImpl()
+			{
+				close();
+			}
+
+		public:
+			static Ref<AsyncRedisImpl> create(const AsyncRedisParam& param)
+			{
+				ListElements<SocketAddress> addresses(param.addresses);
+				if (!(addresses.count)) {
+					return sl_null;
+				}
+				Ref<AsyncIoLoop> ioLoop = param.ioLoop;
+				if (ioLoop.isNull()) {
+					ioLoop = AsyncIoLoop::getDefault();
+					if (ioLoop.isNull()) {
+						return sl_null;
+					}
+				}
+				Ref<AsyncRedisImpl> ret = new AsyncRedisImpl;
+				if (ret.isNull()) {
+					return sl_null;
+				}
+				for (sl_size i = 0; i < addresses.count; i++) {
+					Ref<Connection> connection = new Connection;
+					if (connection.isNull()) {
+						return sl_null;
+					}
+					connection->m_client = ret.get();
+					connection->m_address = addresses[i];
+					connection->m_ioLoop = ioLoop;
+					connection->m_protocolVersion = param.protocolVersion;
+					connection->m_password = param.password;
+					connection->m_connectTimeout = param.connectTimeout;
+					connection->m_flagLogErrors = param.flagLogErrors;
+					connection->m_onPush = param.onPush;
+					if (!(ret->m_connections.add_NoLock(Move(connection)))) {
+						return sl_null;
+					}
+				}
+				return ret;
+			}
+
+		public:
+			void executeBy(const Variant* args, sl_size nArgs, const ResultCallback& callback) override
+			{
+				if (!nArgs) {
+					FailCallback(callback, "Empty command");
+					return;
+				}
+				ListElements< Ref<Connection> > connections(m_connections);
+				sl_size index = 0;
+				if (connections.count > 1 && nArgs > 1) {
+					// slot ranges are assigned in order, like Redis Cluster
+					const Variant& key = args[1];
+					sl_uint32 slot;
+					if (key.isMemory()) {
+						Memory mem = key.getMemory();
+						slot = getHashSlot(mem.getData(), mem.getSize());
+					} else {
+						slot = getHashSlot(key.getString());
+					}
+					index = (sl_size)(((sl_uint64)slot * connections.count) >> 14);
+				}
+				connections[index]->execute(args, nArgs, callback);
+			}
+
+			sl_uint32 getShardCount() override
+			{
+				return (sl_uint32)(m_connections.getCount());
+			}
+
+			void close() override
+			{
+				ListElements< Ref<Connection> > connections(m_connections);
+				for (sl_size i = 0; i < connections.count; i++) {
+					connections[i]->close();
+				}
+			}
+
+		};
+
+	}
+
+	AsyncRedisResult::AsyncRedisResult() noexcept
+	{
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(AsyncRedisResult)
+
+
+	AsyncRedisParam::AsyncRedisParam()
+	{
+		protocolVersion = 2;
+		connectTimeout = 10000;
+		flagLogErrors = sl_true;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(AsyncRedisParam)
+
+
+	SLIB_DEFINE_OBJECT(AsyncRedis, Object)
+
+	AsyncRedis::AsyncRedis()
+	{
+	}
+
+	AsyncRedis::~AsyncRedis()
+	{
+	}
+
+	Ref<AsyncRedis> AsyncRedis::create(const AsyncRedisParam& param)
+	{
+		return Ref<AsyncRedis>::cast(AsyncRedisImpl::create(param));
+	}
+
+	Ref<AsyncRedis> AsyncRedis::create(const SocketAddress& address)
+	{
+		AsyncRedisParam param;
+		param.addresses.add_NoLock(address);
+		return create(param);
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::executeBy(const Variant* args, sl_size nArgs)
+	{
+		Promise<AsyncRedisResult> promise = Promise<AsyncRedisResult>::create();
+		executeBy(args, nArgs, [promise](AsyncRedisResult& result) {
+			promise.resolve(Move(result));
+		});
+		return promise;
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::get(const StringParam& key)
+	{
+		return execute("GET", key.toString());
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::set(const StringParam& key, const Variant& value)
+	{
+		return execute("SET", key.toString(), value);
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::del(const StringParam& key)
+	{
+		return execute("DEL", key.toString());
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::incr(const StringParam& key)
+	{
+		return execute("INCR", key.toString());
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::incrby(const StringParam& key, sl_int64 n)
+	{
+		return execute("INCRBY", key.toString(), n);
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::lpush(const StringParam& key, const Variant& value)
+	{
+		return execute("LPUSH", key.toString(), value);
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::rpush(const StringParam& key, const Variant& value)
+	{
+		return execute("RPUSH", key.toString(), value);
+	}
+
+	Promise<AsyncRedisResult> AsyncRedis::lrange(const StringParam& key, sl_int64 start, sl_int64 stop)
+	{
+		return execute("LRANGE", key.toString(), start, stop);
+	}
+
+	sl_uint32 AsyncRedis::getHashSlot(const void* _key, sl_size size)
+	{
+		const sl_uint8* key = (const sl_uint8*)_key;
+		// hash tag: only the substring between the first `{` and the next `}` is hashed, when it is not empty
+		for (sl_size i = 0; i < size; i++) {
+			if (key[i] == '{') {
+				for (sl_size k = i + 1; k < size; k++) {
+					if (key[k] == '}') {
+						if (k > i + 1) {
+							return GetCrc16(key + i + 1, k - i - 1) & 16383;
+						}
+						break;
+					}
+				}
+				break;
+			}
+		}
+		return GetCrc16(key, size) & 16383;
+	}
+
+	sl_uint32 AsyncRedis::getHashSlot(const StringView& key)
+	{
+		return getHashSlot(key.getData(), key.getLength());
+	}
+
+}
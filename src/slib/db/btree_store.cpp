@@ -0,0 +1,2164 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/db/btree_store.h"
+
+#include "slib/io/file.h"
+#include "slib/data/crc32.h"
+#include "slib/core/memory.h"
+#include "slib/core/mio.h"
+#include "slib/core/list.h"
+#include "slib/core/map.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/mutex.h"
+#include "slib/core/spin_lock.h"
+#include "slib/core/safe_static.h"
+
+/*
+	File Layout
+
+	Page 0, 1: Meta (double buffered, the valid one with higher transaction id is used)
+		0	Magic (8 bytes)
+		8	Version (uint32)
+		12	Page Size (uint32)
+		16	Transaction Id (uint64)
+		24	Root Page (uint64)
+		32	Page Count (uint64)
+		40	Item Count (uint64)
+		48	Free-list Page (uint64)
+		56	CRC32C of [0, 56) (uint32)
+
+	Leaf/Branch Page:
+		0	Type (uint8)
+		2	Entry Count (uint16)
+		4	Prefix Length (uint16)
+		8	First Child (uint64, Branch)
+		16	Entry Offsets (uint16 * Count)
+			Prefix
+			Entries
+				Leaf: Suffix Length (uint16), Value Info (uint32), Suffix, Value or Overflow Page (uint64)
+				Branch: Suffix Length (uint16), Child (uint64), Suffix
+
+	Overflow Page:
+		0	Type (uint8)
+		4	Data Length (uint32)
+		8	Next Page (uint64)
+		16	Data
+
+	Free-list Page:
+		0	Type (uint8)
+		4	Count (uint32)
+		8	Next Page (uint64)
+		16	Pages (uint64 * Count)
+*/
+
+#define META_MAGIC "SLBTREE1"
+#define META_VERSION 1
+#define META_SIZE 64
+#define META_CHECKSUM_OFFSET 56
+
+#define PAGE_HEADER_SIZE 16
+#define PAGE_TYPE_LEAF 1
+#define PAGE_TYPE_BRANCH 2
+#define PAGE_TYPE_OVERFLOW 3
+#define PAGE_TYPE_FREELIST 4
+
+#define LEAF_ENTRY_HEADER_SIZE 6
+#define BRANCH_ENTRY_HEADER_SIZE 10
+#define VALUE_FLAG_OVERFLOW 0x80000000
+#define MAX_VALUE_SIZE 0x7fffffff
+
+#define MIN_PAGE_SIZE 512
+#define MAX_PAGE_SIZE 32768
+#define DEFAULT_PAGE_SIZE 4096
+#define DEFAULT_CACHE_SIZE 4096
+
+namespace slib
+{
+
+	namespace {
+
+		class Meta
+		{
+		public:
+			sl_uint64 txnId;
+			sl_uint64 root;
+			sl_uint64 pageCount;
+			sl_uint64 itemCount;
+			sl_uint64 freeList;
+
+		public:
+			Meta(): txnId(0), root(0), pageCount(2), itemCount(0), freeList(0) {}
+
+		public:
+			void write(sl_uint8* buf, sl_uint32 pageSize) const
+			{
+				Base::zeroMemory(buf, META_SIZE);
+				Base::copyMemory(buf, META_MAGIC, 8);
+				MIO::writeUint32LE(buf + 8, META_VERSION);
+				MIO::writeUint32LE(buf + 12, pageSize);
+				MIO::writeUint64LE(buf + 16, txnId);
+				MIO::writeUint64LE(buf + 24, root);
+				MIO::writeUint64LE(buf + 32, pageCount);
+				MIO::writeUint64LE(buf + 40, itemCount);
+				MIO::writeUint64LE(buf + 48, freeList);
+				MIO::writeUint32LE(buf + META_CHECKSUM_OFFSET, Crc32c::get(buf, META_CHECKSUM_OFFSET));
+			}
+
+			sl_bool read(const sl_uint8* buf, sl_uint32& pageSize)
+			{
+				if (!(Base::equalsMemory(buf, META_MAGIC, 8))) {
+					return sl_false;
+				}
+				if (MIO::readUint32LE(buf + META_CHECKSUM_OFFSET) != Crc32c::get(buf, META_CHECKSUM_OFFSET)) {
+					return sl_false;
+				}
+				if (MIO::readUint32LE(buf + 8) != META_VERSION) {
+					return sl_false;
+				}
+				pageSize = MIO::readUint32LE(buf + 12);
+				txnId = MIO::readUint64LE(buf + 16);
+				root = MIO::readUint64LE(buf + 24);
+				pageCount = MIO::readUint64LE(buf + 32);
+				itemCount = MIO::readUint64LE(buf + 40);
+				freeList = MIO::readUint64LE(buf + 48);
+				return sl_true;
+			}
+
+		};
+
+		static sl_compare_result CompareKey(const sl_uint8* k1, sl_size n1, const sl_uint8* k2, sl_size n2)
+		{
+			sl_compare_result c = Base::compareMemory(k1, k2, SLIB_MIN(n1, n2));
+			if (c) {
+				return c;
+			}
+			if (n1 < n2) {
+				return -1;
+			}
+			if (n1 > n2) {
+				return 1;
+			}
+			return 0;
+		}
+
+		static sl_uint32 GetCommonPrefixLength(const sl_uint8* k1, sl_uint32 n1, const sl_uint8* k2, sl_uint32 n2)
+		{
+			sl_uint32 n = SLIB_MIN(n1, n2);
+			sl_uint32 i = 0;
+			while (i < n && k1[i] == k2[i]) {
+				i++;
+			}
+			return i;
+		}
+
+		static sl_bool IsValidPageSize(sl_uint32 size)
+		{
+			return size >= MIN_PAGE_SIZE && size <= MAX_PAGE_SIZE && !(size & (size - 1));
+		}
+
+		// Read-only view on leaf/branch page
+		class PageView
+		{
+		public:
+			const sl_uint8* data;
+			sl_uint32 type;
+			sl_uint32 count;
+			const sl_uint8* prefix;
+			sl_uint32 sizePrefix;
+
+		public:
+			PageView(const void* _data)
+			{
+				data = (const sl_uint8*)_data;
+				type = data[0];
+				count = MIO::readUint16LE(data + 2);
+				sizePrefix = MIO::readUint16LE(data + 4);
+				prefix = data + PAGE_HEADER_SIZE + (count << 1);
+			}
+
+		public:
+			sl_bool isLeaf() const
+			{
+				return type == PAGE_TYPE_LEAF;
+			}
+
+			sl_bool isBranch() const
+			{
+				return type == PAGE_TYPE_BRANCH;
+			}
+
+			const sl_uint8* getEntry(sl_uint32 index) const
+			{
+				return data + MIO::readUint16LE(data + PAGE_HEADER_SIZE + (index << 1));
+			}
+
+			sl_uint32 getSuffixSize(sl_uint32 index) const
+			{
+				return MIO::readUint16LE(getEntry(index));
+			}
+
+			const sl_uint8* getSuffix(sl_uint32 index) const
+			{
+				return getEntry(index) + (type == PAGE_TYPE_LEAF ? LEAF_ENTRY_HEADER_SIZE : BRANCH_ENTRY_HEADER_SIZE);
+			}
+
+			sl_uint32 getKeySize(sl_uint32 index) const
+			{
+				return sizePrefix + getSuffixSize(index);
+			}
+
+			void copyKey(sl_uint32 index, void* _out) const
+			{
+				sl_uint8* out = (sl_uint8*)_out;
+				const sl_uint8* entry = getEntry(index);
+				sl_uint32 n = MIO::readUint16LE(entry);
+				Base::copyMemory(out, prefix, sizePrefix);
+				Base::copyMemory(out + sizePrefix, getSuffix(index), n);
+			}
+
+			sl_uint64 getChild(sl_uint32 index) const
+			{
+				if (index) {
+					return MIO::readUint64LE(getEntry(index - 1) + 2);
+				} else {
+					return MIO::readUint64LE(data + 8);
+				}
+			}
+
+			sl_bool isOverflowValue(sl_uint32 index) const
+			{
+				return (MIO::readUint32LE(getEntry(index) + 2) & VALUE_FLAG_OVERFLOW) != 0;
+			}
+
+			sl_uint32 getValueSize(sl_uint32 index) const
+			{
+				return MIO::readUint32LE(getEntry(index) + 2) & MAX_VALUE_SIZE;
+			}
+
+			// inline value, or overflow page number
+			const sl_uint8* getValue(sl_uint32 index) const
+			{
+				const sl_uint8* entry = getEntry(index);
+				return entry + LEAF_ENTRY_HEADER_SIZE + MIO::readUint16LE(entry);
+			}
+
+			sl_uint64 getOverflowPage(sl_uint32 index) const
+			{
+				return MIO::readUint64LE(getValue(index));
+			}
+
+			// returns the first index whose key is not less than `key` (flagUpper: greater than `key`)
+			sl_uint32 search(const void* _key, sl_size sizeKey, sl_bool flagUpper, sl_bool* pFlagEqual = sl_null) const
+			{
+				if (pFlagEqual) {
+					*pFlagEqual = sl_false;
+				}
+				const sl_uint8* key = (const sl_uint8*)_key;
+				sl_compare_result c = Base::compareMemory(key, prefix, SLIB_MIN(sizeKey, sizePrefix));
+				if (!c && sizeKey < sizePrefix) {
+					c = -1;
+				}
+				if (c < 0) {
+					return 0;
+				}
+				if (c > 0) {
+					return count;
+				}
+				key += sizePrefix;
+				sizeKey -= sizePrefix;
+				sl_uint32 start = 0;
+				sl_uint32 end = count;
+				while (start < end) {
+					sl_uint32 mid = (start + end) >> 1;
+					c = CompareKey(getSuffix(mid), getSuffixSize(mid), key, sizeKey);
+					if (c < 0 || (flagUpper && !c)) {
+						start = mid + 1;
+					} else {
+						if (!c && pFlagEqual) {
+							*pFlagEqual = sl_true;
+						}
+						end = mid;
+					}
+				}
+				return start;
+			}
+
+		};
+
+		// Decoded node used by the writer
+		struct NodeItem
+		{
+			const sl_uint8* key;
+			sl_uint32 sizeKey;
+			const sl_uint8* value; // inline value
+			sl_uint32 sizeValue;
+			sl_uint64 overflow; // first overflow page (0 for inline value)
+			sl_uint64 child; // branch
+		};
+
+		class Node
+		{
+		public:
+			sl_uint32 type;
+			sl_uint64 firstChild;
+			List<NodeItem> items;
+			List<Memory> buffers;
+
+		public:
+			Node(): type(PAGE_TYPE_LEAF), firstChild(0) {}
+
+		public:
+			sl_bool isLeaf() const
+			{
+				return type == PAGE_TYPE_LEAF;
+			}
+
+			sl_uint32 getCount() const
+			{
+				return (sl_uint32)(items.getCount());
+			}
+
+			NodeItem* getItems() const
+			{
+				return items.getData();
+			}
+
+			sl_uint64 getChild(sl_uint32 index) const
+			{
+				if (index) {
+					return items.getData()[index - 1].child;
+				} else {
+					return firstChild;
+				}
+			}
+
+			void setChild(sl_uint32 index, sl_uint64 page)
+			{
+				if (index) {
+					items.getData()[index - 1].child = page;
+				} else {
+					firstChild = page;
+				}
+			}
+
+			sl_bool decode(const Memory& mem)
+			{
+				PageView view(mem.getData());
+				if (!(view.isLeaf() || view.isBranch())) {
+					return sl_false;
+				}
+				type = view.type;
+				firstChild = view.isBranch() ? view.getChild(0) : 0;
+				sl_uint32 n = view.count;
+				items = List<NodeItem>::create(n);
+				if (!n) {
+					return sl_true;
+				}
+				if (items.isNull()) {
+					return sl_false;
+				}
+				sl_size sizeKeys = 0;
+				sl_uint32 i;
+				for (i = 0; i < n; i++) {
+					sizeKeys += view.getKeySize(i);
+				}
+				Memory memKeys = Memory::create(sizeKeys);
+				if (memKeys.isNull()) {
+					return sl_false;
+				}
+				sl_uint8* keys = (sl_uint8*)(memKeys.getData());
+				NodeItem* item = items.getData();
+				for (i = 0; i < n; i++) {
+					item->key = keys;
+					item->sizeKey = view.getKeySize(i);
+					view.copyKey(i, keys);
+					keys += item->sizeKey;
+					if (view.isLeaf()) {
+						item->sizeValue = view.getValueSize(i);
+						if (view.isOverflowValue(i)) {
+							item->value = sl_null;
+							item->overflow = view.getOverflowPage(i);
+						} else {
+							item->value = view.getValue(i);
+							item->overflow = 0;
+						}
+						item->child = 0;
+					} else {
+						item->value = sl_null;
+						item->sizeValue = 0;
+						item->overflow = 0;
+						item->child = view.getChild(i + 1);
+					}
+					item++;
+				}
+				buffers.add_NoLock(mem);
+				buffers.add_NoLock(Move(memKeys));
+				return sl_true;
+			}
+
+			sl_uint32 search(const void* key, sl_size sizeKey, sl_bool flagUpper, sl_bool* pFlagEqual = sl_null) const
+			{
+				if (pFlagEqual) {
+					*pFlagEqual = sl_false;
+				}
+				NodeItem* data = items.getData();
+				sl_uint32 start = 0;
+				sl_uint32 end = getCount();
+				while (start < end) {
+					sl_uint32 mid = (start + end) >> 1;
+					sl_compare_result c = CompareKey(data[mid].key, data[mid].sizeKey, (const sl_uint8*)key, sizeKey);
+					if (c < 0 || (flagUpper && !c)) {
+						start = mid + 1;
+					} else {
+						if (!c && pFlagEqual) {
+							*pFlagEqual = sl_true;
+						}
+						end = mid;
+					}
+				}
+				return start;
+			}
+
+			sl_uint32 getEntrySize(const NodeItem& item) const
+			{
+				if (type == PAGE_TYPE_LEAF) {
+					return 2 + LEAF_ENTRY_HEADER_SIZE + item.sizeKey + (item.overflow ? 8 : item.sizeValue);
+				} else {
+					return 2 + BRANCH_ENTRY_HEADER_SIZE + item.sizeKey;
+				}
+			}
+
+			sl_uint32 getPrefixLength(sl_uint32 start, sl_uint32 end) const
+			{
+				if (start >= end) {
+					return 0;
+				}
+				NodeItem* data = items.getData();
+				NodeItem& first = data[start];
+				NodeItem& last = data[end - 1];
+				return GetCommonPrefixLength(first.key, first.sizeKey, last.key, last.sizeKey);
+			}
+
+			sl_size getEncodedSize(sl_uint32 start, sl_uint32 end) const
+			{
+				NodeItem* data = items.getData();
+				sl_uint32 sizePrefix = getPrefixLength(start, end);
+				sl_size size = PAGE_HEADER_SIZE + sizePrefix;
+				for (sl_uint32 i = start; i < end; i++) {
+					size += getEntrySize(data[i]) - sizePrefix;
+				}
+				return size;
+			}
+
+			void encode(sl_uint8* buf, sl_uint32 sizePage, sl_uint32 start, sl_uint32 end, sl_uint64 _firstChild) const
+			{
+				NodeItem* data = items.getData();
+				sl_uint32 n = end - start;
+				sl_uint32 sizePrefix = getPrefixLength(start, end);
+				Base::zeroMemory(buf, sizePage);
+				buf[0] = (sl_uint8)type;
+				MIO::writeUint16LE(buf + 2, (sl_uint16)n);
+				MIO::writeUint16LE(buf + 4, (sl_uint16)sizePrefix);
+				MIO::writeUint64LE(buf + 8, _firstChild);
+				sl_uint32 offset = PAGE_HEADER_SIZE + (n << 1);
+				if (n) {
+					Base::copyMemory(buf + offset, data[start].key, sizePrefix);
+					offset += sizePrefix;
+				}
+				for (sl_uint32 i = 0; i < n; i++) {
+					NodeItem& item = data[start + i];
+					MIO::writeUint16LE(buf + PAGE_HEADER_SIZE + (i << 1), (sl_uint16)offset);
+					sl_uint8* entry = buf + offset;
+					sl_uint32 sizeSuffix = item.sizeKey - sizePrefix;
+					MIO::writeUint16LE(entry, (sl_uint16)sizeSuffix);
+					if (type == PAGE_TYPE_LEAF) {
+						sl_uint8* p = entry + LEAF_ENTRY_HEADER_SIZE;
+						Base::copyMemory(p, item.key + sizePrefix, sizeSuffix);
+						p += sizeSuffix;
+						if (item.overflow) {
+							MIO::writeUint32LE(entry + 2, item.sizeValue | VALUE_FLAG_OVERFLOW);
+							MIO::writeUint64LE(p, item.overflow);
+							offset += LEAF_ENTRY_HEADER_SIZE + sizeSuffix + 8;
+						} else {
+							MIO::writeUint32LE(entry + 2, item.sizeValue);
+							Base::copyMemory(p, item.value, item.sizeValue);
+							offset += LEAF_ENTRY_HEADER_SIZE + sizeSuffix + item.sizeValue;
+						}
+					} else {
+						MIO::writeUint64LE(entry + 2, item.child);
+						Base::copyMemory(entry + BRANCH_ENTRY_HEADER_SIZE, item.key + sizePrefix, sizeSuffix);
+						offset += BRANCH_ENTRY_HEADER_SIZE + sizeSuffix;
+					}
+				}
+			}
+
+		};
+
+		// A page replacing (a part of) the modified node. `key` is the separator from the previous piece
+		struct NodePiece
+		{
+			Memory key;
+			sl_uint64 page;
+			sl_size size;
+		};
+
+		// Range of items to be stored in a page, during splitting
+		struct NodeRange
+		{
+			sl_uint32 start;
+			sl_uint32 end;
+			sl_uint64 firstChild;
+			const sl_uint8* separator;
+			sl_uint32 sizeSeparator;
+		};
+
+		struct ModifyParam
+		{
+			const sl_uint8* key;
+			sl_uint32 sizeKey;
+			const sl_uint8* value;
+			sl_uint32 sizeValue;
+			sl_bool flagRemove;
+
+			// output
+			sl_bool flagChanged;
+			sl_int32 countDelta;
+		};
+
+		struct PendingPages
+		{
+			sl_uint64 txnId;
+			List<sl_uint64> pages;
+		};
+
+		struct BatchItem
+		{
+			Memory key;
+			Memory value;
+			sl_bool flagRemove;
+		};
+
+		// Bounded page cache with clock (second chance) eviction
+		class PageCache
+		{
+		public:
+			struct Slot
+			{
+				sl_uint64 page;
+				Memory data;
+				sl_bool flagReferenced;
+			};
+
+		public:
+			PageCache(): m_capacity(0), m_hand(0), m_countHit(0), m_countMiss(0) {}
+
+		public:
+			sl_bool initialize(sl_uint32 capacity)
+			{
+				if (capacity < 16) {
+					capacity = 16;
+				}
+				m_slots = List<Slot>::create();
+				if (m_slots.isNull()) {
+					return sl_false;
+				}
+				m_capacity = capacity;
+				return sl_true;
+			}
+
+			Memory get(sl_uint64 page)
+			{
+				SpinLocker lock(&m_lock);
+				HashMapNode<sl_uint64, sl_uint32>* node = m_map.find_NoLock(page);
+				if (node) {
+					Slot& slot = m_slots.getData()[node->value];
+					slot.flagReferenced = sl_true;
+					m_countHit++;
+					return slot.data;
+				}
+				m_countMiss++;
+				return sl_null;
+			}
+
+			void put(sl_uint64 page, const Memory& data)
+			{
+				SpinLocker lock(&m_lock);
+				HashMapNode<sl_uint64, sl_uint32>* node = m_map.find_NoLock(page);
+				if (node) {
+					Slot& slot = m_slots.getData()[node->value];
+					slot.data = data;
+					slot.flagReferenced = sl_true;
+					return;
+				}
+				sl_uint32 n = (sl_uint32)(m_slots.getCount());
+				if (n < m_capacity) {
+					Slot slot;
+					slot.page = page;
+					slot.data = data;
+					slot.flagReferenced = sl_false;
+					if (m_slots.add_NoLock(Move(slot))) {
+						m_map.put_NoLock(page, n);
+					}
+					return;
+				}
+				Slot* slots = m_slots.getData();
+				for (;;) {
+					Slot& slot = slots[m_hand];
+					sl_uint32 index = m_hand;
+					m_hand = (m_hand + 1) % n;
+					if (slot.flagReferenced) {
+						slot.flagReferenced = sl_false;
+					} else {
+						m_map.remove_NoLock(slot.page);
+						slot.page = page;
+						slot.data = data;
+						m_map.put_NoLock(page, index);
+						return;
+					}
+				}
+			}
+
+			sl_uint64 getHitCount()
+			{
+				return m_countHit;
+			}
+
+			sl_uint64 getMissCount()
+			{
+				return m_countMiss;
+			}
+
+		private:
+			SpinLock m_lock;
+			sl_uint32 m_capacity;
+			List<Slot> m_slots;
+			CHashMap<sl_uint64, sl_uint32> m_map;
+			sl_uint32 m_hand;
+			sl_uint64 m_countHit;
+			sl_uint64 m_countMiss;
+
+		};
+
+		class BTreeStoreImpl;
+
+		// Registers a reader on the committed state, so that the pages of the state are not reused while the reader is alive
+		class ReadState : public CRef
+		{
+		public:
+			Ref<BTreeStoreImpl> store;
+			Meta meta;
+
+		public:
+			ReadState(BTreeStoreImpl* _store);
+
+			~ReadState();
+
+		};
+
+		class BTreeStoreImpl : public BTreeStore
+		{
+		public:
+			File m_file;
+			sl_uint32 m_pageSize;
+			sl_uint32 m_maxKeySize;
+			sl_uint32 m_maxInlineValueSize;
+			sl_bool m_flagReadOnly;
+			sl_bool m_flagSync;
+
+			PageCache m_cache;
+			Mutex m_lockFile;
+
+			// committed state
+			SpinLock m_lockState;
+			Meta m_meta;
+			CMap<sl_uint64, sl_uint32> m_readers; // txnId -> count
+
+			// writer state
+			Mutex m_lockWrite;
+			List<sl_uint64> m_freePages;
+			List<PendingPages> m_pendingPages;
+			List<sl_uint64> m_freeListPages; // pages storing the committed free-list
+
+			// current transaction
+			Meta m_txnMeta;
+			CHashMap<sl_uint64, Memory> m_txnDirtyPages;
+			List<sl_uint64> m_txnFreedPages; // committed pages released by the transaction
+			List<sl_uint64> m_txnTakenPages; // pages taken from `m_freePages`
+			List<sl_uint64> m_txnUnusedPages; // pages allocated and released in the transaction
+
+		public:
+			BTreeStoreImpl()
+			{
+				m_pageSize = DEFAULT_PAGE_SIZE;
+				m_maxKeySize = 0;
+				m_maxInlineValueSize = 0;
+				m_flagReadOnly = sl_false;
+				m_flagSync = sl_true;
+			}
+
+			~BTreeStoreImpl()
+			{
+			}
+
+		public:
+			static Ref<BTreeStoreImpl> open(BTreeStore_Param& param)
+			{
+				StringCstr path(param.path);
+				if (path.isEmpty()) {
+					SLIB_STATIC_STRING(error, "Empty path")
+					param.errorText = error;
+					return sl_null;
+				}
+				sl_bool flagExists = File::exists(path);
+				if (!flagExists) {
+					if (param.flagReadOnly || !(param.flagCreateIfMissing)) {
+						SLIB_STATIC_STRING(error, "File not found")
+						param.errorText = error;
+						return sl_null;
+					}
+					if (!(IsValidPageSize(param.pageSize))) {
+						SLIB_STATIC_STRING(error, "Invalid page size")
+						param.errorText = error;
+						return sl_null;
+					}
+				}
+				File file;
+				if (param.flagReadOnly) {
+					file = File::openForRandomRead(path);
+				} else {
+					file = File::openForRandomAccess(path);
+				}
+				if (!(file.isOpened())) {
+					SLIB_STATIC_STRING(error, "Failed to open file")
+					param.errorText = error;
+					return sl_null;
+				}
+				if (!(file.lock(0, 0, param.flagReadOnly))) {
+					SLIB_STATIC_STRING(error, "File is locked by another process")
+					param.errorText = error;
+					return sl_null;
+				}
+				Ref<BTreeStoreImpl> ret = new BTreeStoreImpl;
+				if (ret.isNull()) {
+					return sl_null;
+				}
+				ret->m_flagReadOnly = param.flagReadOnly;
+				ret->m_flagSync = param.flagSync;
+				if (!(ret->m_cache.initialize(param.cacheSize))) {
+					return sl_null;
+				}
+				sl_uint64 sizeFile = 0;
+				file.getSize(sizeFile);
+				if (!sizeFile) {
+					if (param.flagReadOnly) {
+						SLIB_STATIC_STRING(error, "Empty file")
+						param.errorText = error;
+						return sl_null;
+					}
+					if (!(ret->_initializeFile(file, param.pageSize))) {
+						SLIB_STATIC_STRING(error, "Failed to initialize file")
+						param.errorText = error;
+						return sl_null;
+					}
+				} else {
+					if (!(ret->_loadMeta(file, sizeFile))) {
+						SLIB_STATIC_STRING(error, "Invalid file format")
+						param.errorText = error;
+						return sl_null;
+					}
+				}
+				ret->m_file = Move(file);
+				ret->_initializeLimits();
+				if (!(ret->_loadFreeList())) {
+					SLIB_STATIC_STRING(error, "Failed to load free-list")
+					param.errorText = error;
+					return sl_null;
+				}
+				return ret;
+			}
+
+			sl_bool _initializeFile(const File& file, sl_uint32 pageSize)
+			{
+				Memory mem = Memory::create(pageSize << 1);
+				if (mem.isNull()) {
+					return sl_false;
+				}
+				sl_uint8* buf = (sl_uint8*)(mem.getData());
+				Base::zeroMemory(buf, pageSize << 1);
+				Meta meta;
+				meta.write(buf, pageSize);
+				if (file.writeFullyAt(0, buf, pageSize << 1) != (sl_reg)(pageSize << 1)) {
+					return sl_false;
+				}
+				file.flush();
+				m_pageSize = pageSize;
+				m_meta = meta;
+				return sl_true;
+			}
+
+			sl_bool _loadMeta(const File& file, sl_uint64 sizeFile)
+			{
+				sl_uint8 buf[META_SIZE];
+				sl_uint32 pageSize = 0;
+				Meta meta;
+				sl_bool flagValid = sl_false;
+				if (file.readFullyAt(0, buf, META_SIZE) == META_SIZE) {
+					flagValid = meta.read(buf, pageSize) && IsValidPageSize(pageSize);
+				}
+				if (flagValid) {
+					Meta meta2;
+					sl_uint32 pageSize2 = 0;
+					if (file.readFullyAt(pageSize, buf, META_SIZE) == META_SIZE) {
+						if (meta2.read(buf, pageSize2) && pageSize2 == pageSize && meta2.txnId > meta.txnId) {
+							meta = meta2;
+						}
+					}
+				} else {
+					// first meta page is torn. find the second one
+					for (pageSize = MIN_PAGE_SIZE; pageSize <= MAX_PAGE_SIZE; pageSize <<= 1) {
+						sl_uint32 pageSize2 = 0;
+						if (file.readFullyAt(pageSize, buf, META_SIZE) == META_SIZE) {
+							if (meta.read(buf, pageSize2) && pageSize2 == pageSize) {
+								flagValid = sl_true;
+								break;
+							}
+						}
+					}
+					if (!flagValid) {
+						return sl_false;
+					}
+				}
+				if (meta.pageCount < 2 || meta.pageCount * pageSize > sizeFile) {
+					return sl_false;
+				}
+				m_pageSize = pageSize;
+				m_meta = meta;
+				return sl_true;
+			}
+
+			void _initializeLimits()
+			{
+				// guarantees that a page split into two halves always fits
+				m_maxKeySize = (m_pageSize - PAGE_HEADER_SIZE) >> 3;
+				m_maxInlineValueSize = m_maxKeySize;
+			}
+
+			sl_bool _loadFreeList()
+			{
+				sl_uint64 page = m_meta.freeList;
+				while (page) {
+					Memory mem = _readPage(page);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* data = (sl_uint8*)(mem.getData());
+					if (data[0] != PAGE_TYPE_FREELIST) {
+						return sl_false;
+					}
+					sl_uint32 n = MIO::readUint32LE(data + 4);
+					if (n > ((m_pageSize - PAGE_HEADER_SIZE) >> 3)) {
+						return sl_false;
+					}
+					for (sl_uint32 i = 0; i < n; i++) {
+						m_freePages.add_NoLock(MIO::readUint64LE(data + PAGE_HEADER_SIZE + (i << 3)));
+					}
+					m_freeListPages.add_NoLock(page);
+					page = MIO::readUint64LE(data + 8);
+				}
+				return sl_true;
+			}
+
+		public:
+			sl_uint64 getCount() override
+			{
+				SpinLocker lock(&m_lockState);
+				return m_meta.itemCount;
+			}
+
+			sl_uint32 getPageSize() override
+			{
+				return m_pageSize;
+			}
+
+			sl_uint64 getCacheHitCount() override
+			{
+				return m_cache.getHitCount();
+			}
+
+			sl_uint64 getCacheMissCount() override
+			{
+				return m_cache.getMissCount();
+			}
+
+			Ref<KeyValueWriteBatch> createWriteBatch() override;
+
+			Ref<KeyValueIterator> getIterator() override;
+
+			Ref<KeyValueSnapshot> getSnapshot() override;
+
+			sl_bool get(const void* key, sl_size sizeKey, MemoryData* value) override
+			{
+				Meta meta;
+				_beginRead(meta);
+				sl_bool bRet = _get(meta.root, key, sizeKey, value);
+				_endRead(meta.txnId);
+				return bRet;
+			}
+
+			sl_bool put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue) override
+			{
+				MutexLocker lock(&m_lockWrite);
+				_beginWrite();
+				if (_put(key, sizeKey, value, sizeValue)) {
+					if (_commitWrite()) {
+						return sl_true;
+					}
+				}
+				_abortWrite();
+				return sl_false;
+			}
+
+			sl_bool remove(const void* key, sl_size sizeKey) override
+			{
+				MutexLocker lock(&m_lockWrite);
+				_beginWrite();
+				sl_bool flagRemoved = sl_false;
+				if (_remove(key, sizeKey, flagRemoved)) {
+					if (_commitWrite()) {
+						return flagRemoved;
+					}
+				}
+				_abortWrite();
+				return sl_false;
+			}
+
+			sl_bool applyBatch(const List<BatchItem>& items)
+			{
+				MutexLocker lock(&m_lockWrite);
+				_beginWrite();
+				ListElements<BatchItem> list(items);
+				for (sl_size i = 0; i < list.count; i++) {
+					BatchItem& item = list[i];
+					sl_bool flagSuccess;
+					if (item.flagRemove) {
+						sl_bool flagRemoved;
+						flagSuccess = _remove(item.key.getData(), item.key.getSize(), flagRemoved);
+					} else {
+						flagSuccess = _put(item.key.getData(), item.key.getSize(), item.value.getData(), item.value.getSize());
+					}
+					if (!flagSuccess) {
+						_abortWrite();
+						return sl_false;
+					}
+				}
+				if (_commitWrite()) {
+					return sl_true;
+				}
+				_abortWrite();
+				return sl_false;
+			}
+
+		public:
+			void _beginRead(Meta& meta)
+			{
+				SpinLocker lock(&m_lockState);
+				meta = m_meta;
+				MapNode<sl_uint64, sl_uint32>* node = m_readers.find_NoLock(meta.txnId);
+				if (node) {
+					node->value++;
+				} else {
+					m_readers.add_NoLock(meta.txnId, 1);
+				}
+			}
+
+			void _endRead(sl_uint64 txnId)
+			{
+				SpinLocker lock(&m_lockState);
+				MapNode<sl_uint64, sl_uint32>* node = m_readers.find_NoLock(txnId);
+				if (node) {
+					node->value--;
+					if (!(node->value)) {
+						m_readers.removeAt(node);
+					}
+				}
+			}
+
+			Memory _readPage(sl_uint64 page)
+			{
+				Memory mem = m_cache.get(page);
+				if (mem.isNotNull()) {
+					return mem;
+				}
+				mem = Memory::create(m_pageSize);
+				if (mem.isNull()) {
+					return sl_null;
+				}
+				{
+					MutexLocker lock(&m_lockFile);
+					if (m_file.readFullyAt(page * m_pageSize, mem.getData(), m_pageSize) != (sl_reg)m_pageSize) {
+						return sl_null;
+					}
+				}
+				m_cache.put(page, mem);
+				return mem;
+			}
+
+			sl_bool _readOverflow(sl_uint64 page, sl_uint32 size, void* _out)
+			{
+				sl_uint8* out = (sl_uint8*)_out;
+				while (size) {
+					if (!page) {
+						return sl_false;
+					}
+					Memory mem = _readPage(page);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* data = (sl_uint8*)(mem.getData());
+					if (data[0] != PAGE_TYPE_OVERFLOW) {
+						return sl_false;
+					}
+					sl_uint32 n = MIO::readUint32LE(data + 4);
+					if (n > size || n > m_pageSize - PAGE_HEADER_SIZE) {
+						return sl_false;
+					}
+					Base::copyMemory(out, data + PAGE_HEADER_SIZE, n);
+					out += n;
+					size -= n;
+					page = MIO::readUint64LE(data + 8);
+				}
+				return sl_true;
+			}
+
+			sl_bool _getValue(const Memory& mem, const PageView& view, sl_uint32 index, MemoryData* value)
+			{
+				if (!value) {
+					return sl_true;
+				}
+				sl_uint32 size = view.getValueSize(index);
+				if (view.isOverflowValue(index)) {
+					if (size <= value->size) {
+						if (_readOverflow(view.getOverflowPage(index), size, value->data)) {
+							value->size = size;
+							return sl_true;
+						}
+						return sl_false;
+					}
+					Memory memValue = Memory::create(size);
+					if (memValue.isNull()) {
+						return sl_false;
+					}
+					if (_readOverflow(view.getOverflowPage(index), size, memValue.getData())) {
+						*value = Move(memValue);
+						return sl_true;
+					}
+					return sl_false;
+				} else {
+					if (size <= value->size) {
+						Base::copyMemory(value->data, view.getValue(index), size);
+					} else {
+						value->data = (void*)(view.getValue(index));
+						value->ref = mem.ref;
+					}
+					value->size = size;
+					return sl_true;
+				}
+			}
+
+			sl_bool _get(sl_uint64 page, const void* key, sl_size sizeKey, MemoryData* value)
+			{
+				while (page) {
+					Memory mem = _readPage(page);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					PageView view(mem.getData());
+					if (view.isBranch()) {
+						page = view.getChild(view.search(key, sizeKey, sl_true));
+					} else if (view.isLeaf()) {
+						sl_bool flagFound = sl_false;
+						sl_uint32 index = view.search(key, sizeKey, sl_false, &flagFound);
+						if (flagFound) {
+							return _getValue(mem, view, index, value);
+						}
+						return sl_false;
+					} else {
+						return sl_false;
+					}
+				}
+				return sl_false;
+			}
+
+		public:
+			void _beginWrite()
+			{
+				m_txnMeta = m_meta;
+				m_txnDirtyPages.removeAll_NoLock();
+				m_txnFreedPages.setNull();
+				m_txnTakenPages.setNull();
+				m_txnUnusedPages.setNull();
+				// release the pages which can no longer be seen by any reader
+				sl_uint64 minReader;
+				{
+					SpinLocker lock(&m_lockState);
+					MapNode<sl_uint64, sl_uint32>* node = m_readers.getFirstNode();
+					if (node) {
+						minReader = node->key;
+					} else {
+						minReader = SLIB_UINT64_MAX;
+					}
+				}
+				for (;;) {
+					PendingPages* pending = m_pendingPages.getPointerAt(0);
+					if (!pending || pending->txnId > minReader) {
+						break;
+					}
+					m_freePages.addAll_NoLock(pending->pages);
+					m_pendingPages.removeAt_NoLock(0);
+				}
+			}
+
+			void _abortWrite()
+			{
+				m_freePages.addAll_NoLock(m_txnTakenPages);
+				m_txnDirtyPages.removeAll_NoLock();
+				m_txnFreedPages.setNull();
+				m_txnTakenPages.setNull();
+				m_txnUnusedPages.setNull();
+			}
+
+			sl_bool _commitWrite()
+			{
+				if (m_flagReadOnly) {
+					return sl_false;
+				}
+				if (m_txnDirtyPages.isEmpty() && m_txnFreedPages.isEmpty()) {
+					return sl_true;
+				}
+				// old free-list is released, and can be reused after this commit (not visible to readers)
+				List<sl_uint64> pagesOldFreeList = m_freeListPages;
+				List<sl_uint64> pagesNewFreeList;
+				if (!(_writeFreeList(pagesOldFreeList, pagesNewFreeList))) {
+					return sl_false;
+				}
+				// write pages
+				{
+					MutexLocker lock(&m_lockFile);
+					List<sl_uint64> pages = m_txnDirtyPages.getAllKeys_NoLock();
+					pages.sort_NoLock();
+					ListElements<sl_uint64> list(pages);
+					for (sl_size i = 0; i < list.count; i++) {
+						sl_uint64 page = list[i];
+						Memory mem = m_txnDirtyPages.getValue_NoLock(page);
+						if (m_file.writeFullyAt(page * m_pageSize, mem.getData(), m_pageSize) != (sl_reg)m_pageSize) {
+							return sl_false;
+						}
+					}
+					if (m_flagSync) {
+						if (!(m_file.flush())) {
+							return sl_false;
+						}
+					}
+					m_txnMeta.txnId++;
+					sl_uint8 bufMeta[META_SIZE];
+					m_txnMeta.write(bufMeta, m_pageSize);
+					if (m_file.writeFullyAt((m_txnMeta.txnId & 1) * m_pageSize, bufMeta, META_SIZE) != META_SIZE) {
+						m_txnMeta.txnId--;
+						return sl_false;
+					}
+					if (m_flagSync) {
+						m_file.flush();
+					}
+				}
+				// publish
+				{
+					auto node = m_txnDirtyPages.getFirstNode();
+					while (node) {
+						m_cache.put(node->key, node->value);
+						node = node->next;
+					}
+				}
+				{
+					SpinLocker lock(&m_lockState);
+					m_meta = m_txnMeta;
+				}
+				if (m_txnFreedPages.isNotEmpty()) {
+					PendingPages pending;
+					pending.txnId = m_txnMeta.txnId;
+					pending.pages = Move(m_txnFreedPages);
+					m_pendingPages.add_NoLock(Move(pending));
+				}
+				m_freePages.addAll_NoLock(m_txnUnusedPages);
+				m_freePages.addAll_NoLock(pagesOldFreeList);
+				m_freeListPages = Move(pagesNewFreeList);
+				m_txnDirtyPages.removeAll_NoLock();
+				m_txnTakenPages.setNull();
+				m_txnUnusedPages.setNull();
+				return sl_true;
+			}
+
+			sl_bool _writeFreeList(const List<sl_uint64>& pagesOldFreeList, List<sl_uint64>& pagesNewFreeList)
+			{
+				sl_uint32 nPerPage = (m_pageSize - PAGE_HEADER_SIZE) >> 3;
+				sl_size nTotal = m_freePages.getCount() + m_txnFreedPages.getCount() + m_txnUnusedPages.getCount() + pagesOldFreeList.getCount();
+				{
+					ListElements<PendingPages> list(m_pendingPages);
+					for (sl_size i = 0; i < list.count; i++) {
+						nTotal += list[i].pages.getCount();
+					}
+				}
+				// allocating pages for free-list decreases the number of free pages
+				sl_size nPages = (nTotal + nPerPage - 1) / nPerPage;
+				for (sl_size i = 0; i < nPages; i++) {
+					sl_uint64 page = _allocatePage();
+					if (!(pagesNewFreeList.add_NoLock(page))) {
+						return sl_false;
+					}
+				}
+				List<sl_uint64> all;
+				all.addAll_NoLock(m_freePages);
+				all.addAll_NoLock(m_txnFreedPages);
+				all.addAll_NoLock(m_txnUnusedPages);
+				all.addAll_NoLock(pagesOldFreeList);
+				{
+					ListElements<PendingPages> list(m_pendingPages);
+					for (sl_size i = 0; i < list.count; i++) {
+						all.addAll_NoLock(list[i].pages);
+					}
+				}
+				ListElements<sl_uint64> pages(all);
+				ListElements<sl_uint64> pagesFreeList(pagesNewFreeList);
+				sl_size k = 0;
+				for (sl_size i = 0; i < pagesFreeList.count; i++) {
+					Memory mem = Memory::create(m_pageSize);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* data = (sl_uint8*)(mem.getData());
+					Base::zeroMemory(data, m_pageSize);
+					sl_uint32 n = 0;
+					while (n < nPerPage && k < pages.count) {
+						MIO::writeUint64LE(data + PAGE_HEADER_SIZE + (n << 3), pages[k]);
+						n++;
+						k++;
+					}
+					data[0] = PAGE_TYPE_FREELIST;
+					MIO::writeUint32LE(data + 4, n);
+					MIO::writeUint64LE(data + 8, i + 1 < pagesFreeList.count ? pagesFreeList[i + 1] : 0);
+					m_txnDirtyPages.put_NoLock(pagesFreeList[i], Move(mem));
+				}
+				if (pagesFreeList.count) {
+					m_txnMeta.freeList = pagesFreeList[0];
+				} else {
+					m_txnMeta.freeList = 0;
+				}
+				return sl_true;
+			}
+
+			sl_uint64 _allocatePage()
+			{
+				sl_uint64 page;
+				if (m_txnUnusedPages.popBack_NoLock(&page)) {
+					return page;
+				}
+				if (m_freePages.popBack_NoLock(&page)) {
+					m_txnTakenPages.add_NoLock(page);
+					return page;
+				}
+				page = m_txnMeta.pageCount;
+				m_txnMeta.pageCount++;
+				return page;
+			}
+
+			void _freePage(sl_uint64 page)
+			{
+				if (m_txnDirtyPages.remove_NoLock(page)) {
+					m_txnUnusedPages.add_NoLock(page);
+				} else {
+					m_txnFreedPages.add_NoLock(page);
+				}
+			}
+
+			// returns the page number where the data is written
+			sl_uint64 _writePage(sl_uint64 page, Memory&& mem)
+			{
+				if (page) {
+					HashMapNode<sl_uint64, Memory>* dirty = m_txnDirtyPages.find_NoLock(page);
+					if (dirty) {
+						dirty->value = Move(mem);
+						return page;
+					}
+					m_txnFreedPages.add_NoLock(page);
+				}
+				page = _allocatePage();
+				m_txnDirtyPages.put_NoLock(page, Move(mem));
+				return page;
+			}
+
+			Memory _readPageForWrite(sl_uint64 page)
+			{
+				HashMapNode<sl_uint64, Memory>* dirty = m_txnDirtyPages.find_NoLock(page);
+				if (dirty) {
+					return dirty->value;
+				}
+				return _readPage(page);
+			}
+
+			sl_bool _loadNode(sl_uint64 page, Node& node)
+			{
+				Memory mem = _readPageForWrite(page);
+				if (mem.isNull()) {
+					return sl_false;
+				}
+				return node.decode(mem);
+			}
+
+			sl_uint64 _writeOverflow(const void* _value, sl_uint32 size)
+			{
+				const sl_uint8* value = (const sl_uint8*)_value;
+				sl_uint32 nPerPage = m_pageSize - PAGE_HEADER_SIZE;
+				sl_uint32 nPages = (size + nPerPage - 1) / nPerPage;
+				sl_uint64 next = 0;
+				// write from the last page, so that each page knows the next page
+				for (sl_uint32 i = nPages; i > 0; i--) {
+					sl_uint32 offset = (i - 1) * nPerPage;
+					sl_uint32 n = SLIB_MIN(nPerPage, size - offset);
+					Memory mem = Memory::create(m_pageSize);
+					if (mem.isNull()) {
+						return 0;
+					}
+					sl_uint8* data = (sl_uint8*)(mem.getData());
+					Base::zeroMemory(data, PAGE_HEADER_SIZE);
+					data[0] = PAGE_TYPE_OVERFLOW;
+					MIO::writeUint32LE(data + 4, n);
+					MIO::writeUint64LE(data + 8, next);
+					Base::copyMemory(data + PAGE_HEADER_SIZE, value + offset, n);
+					if (n < nPerPage) {
+						Base::zeroMemory(data + PAGE_HEADER_SIZE + n, nPerPage - n);
+					}
+					next = _writePage(0, Move(mem));
+				}
+				return next;
+			}
+
+			sl_bool _freeOverflow(sl_uint64 page)
+			{
+				while (page) {
+					Memory mem = _readPageForWrite(page);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* data = (sl_uint8*)(mem.getData());
+					if (data[0] != PAGE_TYPE_OVERFLOW) {
+						return sl_false;
+					}
+					_freePage(page);
+					page = MIO::readUint64LE(data + 8);
+				}
+				return sl_true;
+			}
+
+			sl_bool _put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue)
+			{
+				if (m_flagReadOnly) {
+					return sl_false;
+				}
+				if (!sizeKey || sizeKey > m_maxKeySize || sizeValue > MAX_VALUE_SIZE) {
+					return sl_false;
+				}
+				ModifyParam param;
+				param.key = (const sl_uint8*)key;
+				param.sizeKey = (sl_uint32)sizeKey;
+				param.value = (const sl_uint8*)value;
+				param.sizeValue = (sl_uint32)sizeValue;
+				param.flagRemove = sl_false;
+				return _modifyRoot(param);
+			}
+
+			sl_bool _remove(const void* key, sl_size sizeKey, sl_bool& flagRemoved)
+			{
+				if (m_flagReadOnly) {
+					return sl_false;
+				}
+				flagRemoved = sl_false;
+				if (!sizeKey || sizeKey > m_maxKeySize) {
+					return sl_true;
+				}
+				ModifyParam param;
+				param.key = (const sl_uint8*)key;
+				param.sizeKey = (sl_uint32)sizeKey;
+				param.value = sl_null;
+				param.sizeValue = 0;
+				param.flagRemove = sl_true;
+				if (_modifyRoot(param)) {
+					flagRemoved = param.flagChanged;
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			sl_bool _modifyRoot(ModifyParam& param)
+			{
+				param.flagChanged = sl_false;
+				param.countDelta = 0;
+				List<NodePiece> pieces;
+				sl_uint64 root = m_txnMeta.root;
+				if (root) {
+					if (!(_modify(root, param, pieces))) {
+						return sl_false;
+					}
+				} else {
+					if (param.flagRemove) {
+						return sl_true;
+					}
+					Node node;
+					if (!(_putLeafItem(node, 0, sl_false, param))) {
+						return sl_false;
+					}
+					if (!(_storeNode(0, node, pieces))) {
+						return sl_false;
+					}
+				}
+				if (!(param.flagChanged)) {
+					return sl_true;
+				}
+				// grow the tree while the root is split
+				while (pieces.getCount() > 1) {
+					Node node;
+					node.type = PAGE_TYPE_BRANCH;
+					ListElements<NodePiece> list(pieces);
+					node.firstChild = list[0].page;
+					for (sl_size i = 1; i < list.count; i++) {
+						NodeItem item;
+						item.key = (const sl_uint8*)(list[i].key.getData());
+						item.sizeKey = (sl_uint32)(list[i].key.getSize());
+						item.value = sl_null;
+						item.sizeValue = 0;
+						item.overflow = 0;
+						item.child = list[i].page;
+						node.items.add_NoLock(item);
+						node.buffers.add_NoLock(list[i].key);
+					}
+					List<NodePiece> piecesRoot;
+					if (!(_storeNode(0, node, piecesRoot))) {
+						return sl_false;
+					}
+					pieces = Move(piecesRoot);
+				}
+				NodePiece* piece = pieces.getPointerAt(0);
+				if (piece) {
+					m_txnMeta.root = piece->page;
+				} else {
+					m_txnMeta.root = 0;
+				}
+				m_txnMeta.itemCount += param.countDelta;
+				return sl_true;
+			}
+
+			sl_bool _putLeafItem(Node& node, sl_uint32 index, sl_bool flagReplace, ModifyParam& param)
+			{
+				NodeItem item;
+				item.sizeValue = param.sizeValue;
+				item.child = 0;
+				if (param.sizeValue > m_maxInlineValueSize) {
+					Memory mem = Memory::create(param.key, param.sizeKey);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					item.overflow = _writeOverflow(param.value, param.sizeValue);
+					if (!(item.overflow)) {
+						return sl_false;
+					}
+					item.key = (const sl_uint8*)(mem.getData());
+					item.sizeKey = param.sizeKey;
+					item.value = sl_null;
+					node.buffers.add_NoLock(Move(mem));
+				} else {
+					Memory mem = Memory::create(param.sizeKey + param.sizeValue);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* buf = (sl_uint8*)(mem.getData());
+					Base::copyMemory(buf, param.key, param.sizeKey);
+					if (param.sizeValue) {
+						Base::copyMemory(buf + param.sizeKey, param.value, param.sizeValue);
+					}
+					item.key = buf;
+					item.sizeKey = param.sizeKey;
+					item.value = buf + param.sizeKey;
+					item.overflow = 0;
+					node.buffers.add_NoLock(Move(mem));
+				}
+				if (flagReplace) {
+					NodeItem& old = node.getItems()[index];
+					if (old.overflow) {
+						if (!(_freeOverflow(old.overflow))) {
+							return sl_false;
+						}
+					}
+					old = item;
+				} else {
+					if (!(node.items.insert_NoLock(index, item))) {
+						return sl_false;
+					}
+					param.countDelta = 1;
+				}
+				param.flagChanged = sl_true;
+				return sl_true;
+			}
+
+			sl_bool _modify(sl_uint64 page, ModifyParam& param, List<NodePiece>& pieces)
+			{
+				Node node;
+				if (!(_loadNode(page, node))) {
+					return sl_false;
+				}
+				if (node.isLeaf()) {
+					sl_bool flagFound = sl_false;
+					sl_uint32 index = node.search(param.key, param.sizeKey, sl_false, &flagFound);
+					if (param.flagRemove) {
+						if (!flagFound) {
+							return sl_true;
+						}
+						NodeItem& item = node.getItems()[index];
+						if (item.overflow) {
+							if (!(_freeOverflow(item.overflow))) {
+								return sl_false;
+							}
+						}
+						node.items.removeAt_NoLock(index);
+						param.flagChanged = sl_true;
+						param.countDelta = -1;
+					} else {
+						if (!(_putLeafItem(node, index, flagFound, param))) {
+							return sl_false;
+						}
+					}
+				} else {
+					sl_uint32 index = node.search(param.key, param.sizeKey, sl_true);
+					List<NodePiece> piecesChild;
+					if (!(_modify(node.getChild(index), param, piecesChild))) {
+						return sl_false;
+					}
+					if (!(param.flagChanged)) {
+						return sl_true;
+					}
+					ListElements<NodePiece> list(piecesChild);
+					if (list.count) {
+						node.setChild(index, list[0].page);
+						for (sl_size i = 1; i < list.count; i++) {
+							NodeItem item;
+							item.key = (const sl_uint8*)(list[i].key.getData());
+							item.sizeKey = (sl_uint32)(list[i].key.getSize());
+							item.value = sl_null;
+							item.sizeValue = 0;
+							item.overflow = 0;
+							item.child = list[i].page;
+							if (!(node.items.insert_NoLock(index + i - 1, item))) {
+								return sl_false;
+							}
+							node.buffers.add_NoLock(list[i].key);
+						}
+						if (list.count == 1 && list[0].size < (m_pageSize >> 2)) {
+							if (!(_mergeChildren(node, index))) {
+								return sl_false;
+							}
+						}
+					} else {
+						// child became empty
+						if (index) {
+							node.items.removeAt_NoLock(index - 1);
+						} else {
+							NodeItem* item = node.items.getPointerAt(0);
+							if (item) {
+								node.firstChild = item->child;
+								node.items.removeAt_NoLock(0);
+							} else {
+								_freePage(page);
+								return sl_true;
+							}
+						}
+					}
+				}
+				return _storeNode(page, node, pieces);
+			}
+
+			// merges an underfull child with its sibling, when they fit in a page
+			sl_bool _mergeChildren(Node& node, sl_uint32 index)
+			{
+				sl_uint32 nChildren = node.getCount() + 1;
+				if (nChildren < 2) {
+					return sl_true;
+				}
+				sl_uint32 iLeft = index ? index - 1 : 0;
+				sl_uint32 iRight = iLeft + 1;
+				if (iRight >= nChildren) {
+					return sl_true;
+				}
+				sl_uint64 pageLeft = node.getChild(iLeft);
+				sl_uint64 pageRight = node.getChild(iRight);
+				Node left, right;
+				if (!(_loadNode(pageLeft, left))) {
+					return sl_false;
+				}
+				if (!(_loadNode(pageRight, right))) {
+					return sl_false;
+				}
+				if (left.type != right.type) {
+					return sl_true;
+				}
+				NodeItem& separator = node.getItems()[iLeft];
+				if (!(left.isLeaf())) {
+					NodeItem item = separator;
+					item.child = right.firstChild;
+					if (!(left.items.add_NoLock(item))) {
+						return sl_false;
+					}
+				}
+				if (!(left.items.addAll_NoLock(right.items))) {
+					return sl_false;
+				}
+				if (left.getEncodedSize(0, left.getCount()) > ((m_pageSize >> 2) * 3)) {
+					return sl_true;
+				}
+				Memory mem = Memory::create(m_pageSize);
+				if (mem.isNull()) {
+					return sl_false;
+				}
+				left.encode((sl_uint8*)(mem.getData()), m_pageSize, 0, left.getCount(), left.firstChild);
+				sl_uint64 page = _writePage(pageLeft, Move(mem));
+				_freePage(pageRight);
+				node.setChild(iLeft, page);
+				node.items.removeAt_NoLock(iLeft);
+				return sl_true;
+			}
+
+			void _splitRange(const Node& node, const NodeRange& range, List<NodeRange>& ranges)
+			{
+				sl_uint32 n = range.end - range.start;
+				sl_bool flagLeaf = node.isLeaf();
+				if (node.getEncodedSize(range.start, range.end) <= m_pageSize || n < 2) {
+					ranges.add_NoLock(range);
+					return;
+				}
+				NodeItem* items = node.getItems();
+				sl_size total = 0;
+				sl_uint32 i;
+				for (i = range.start; i < range.end; i++) {
+					total += node.getEntrySize(items[i]);
+				}
+				sl_size sum = 0;
+				sl_uint32 mid = range.start;
+				for (i = range.start; i < range.end; i++) {
+					sum += node.getEntrySize(items[i]);
+					if (sum >= (total >> 1)) {
+						mid = i;
+						break;
+					}
+				}
+				if (flagLeaf) {
+					if (mid <= range.start) {
+						mid = range.start + 1;
+					}
+				} else {
+					if (mid >= range.end) {
+						mid = range.end - 1;
+					}
+				}
+				NodeRange left;
+				left.start = range.start;
+				left.end = mid;
+				left.firstChild = range.firstChild;
+				left.separator = range.separator;
+				left.sizeSeparator = range.sizeSeparator;
+				NodeRange right;
+				if (flagLeaf) {
+					// shortest key which is greater than the last key of left, and not greater than the first key of right
+					NodeItem& last = items[mid - 1];
+					NodeItem& first = items[mid];
+					right.start = mid;
+					right.firstChild = 0;
+					right.separator = first.key;
+					right.sizeSeparator = GetCommonPrefixLength(last.key, last.sizeKey, first.key, first.sizeKey) + 1;
+					if (right.sizeSeparator > first.sizeKey) {
+						right.sizeSeparator = first.sizeKey;
+					}
+				} else {
+					right.start = mid + 1;
+					right.firstChild = items[mid].child;
+					right.separator = items[mid].key;
+					right.sizeSeparator = items[mid].sizeKey;
+				}
+				right.end = range.end;
+				_splitRange(node, left, ranges);
+				_splitRange(node, right, ranges);
+			}
+
+			sl_bool _storeNode(sl_uint64 page, Node& node, List<NodePiece>& pieces)
+			{
+				sl_uint32 n = node.getCount();
+				if (!n) {
+					if (node.isLeaf()) {
+						if (page) {
+							_freePage(page);
+						}
+						return sl_true;
+					}
+					// collapse branch having only one child
+					if (page) {
+						_freePage(page);
+					}
+					NodePiece piece;
+					piece.page = node.firstChild;
+					piece.size = m_pageSize;
+					return pieces.add_NoLock(Move(piece));
+				}
+				NodeRange range;
+				range.start = 0;
+				range.end = n;
+				range.firstChild = node.firstChild;
+				range.separator = sl_null;
+				range.sizeSeparator = 0;
+				List<NodeRange> ranges;
+				_splitRange(node, range, ranges);
+				ListElements<NodeRange> list(ranges);
+				for (sl_size i = 0; i < list.count; i++) {
+					NodeRange& r = list[i];
+					Memory mem = Memory::create(m_pageSize);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					node.encode((sl_uint8*)(mem.getData()), m_pageSize, r.start, r.end, r.firstChild);
+					NodePiece piece;
+					piece.size = node.getEncodedSize(r.start, r.end);
+					if (i) {
+						piece.key = Memory::create(r.separator, r.sizeSeparator);
+						if (piece.key.isNull()) {
+							return sl_false;
+						}
+						piece.page = _writePage(0, Move(mem));
+					} else {
+						piece.page = _writePage(page, Move(mem));
+					}
+					if (!(pieces.add_NoLock(Move(piece)))) {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+
+		};
+
+		ReadState::ReadState(BTreeStoreImpl* _store): store(_store)
+		{
+			_store->_beginRead(meta);
+		}
+
+		ReadState::~ReadState()
+		{
+			store->_endRead(meta.txnId);
+		}
+
+		class BTreeStoreWriteBatch : public KeyValueWriteBatch
+		{
+		public:
+			Ref<BTreeStoreImpl> m_store;
+			List<BatchItem> m_items;
+
+		public:
+			BTreeStoreWriteBatch(BTreeStoreImpl* store): m_store(store) {}
+
+			~BTreeStoreWriteBatch()
+			{
+				discard();
+			}
+
+		public:
+			sl_bool put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue) override
+			{
+				BatchItem item;
+				item.key = Memory::create(key, sizeKey);
+				if (item.key.isNull()) {
+					return sl_false;
+				}
+				if (sizeValue) {
+					item.value = Memory::create(value, sizeValue);
+					if (item.value.isNull()) {
+						return sl_false;
+					}
+				}
+				item.flagRemove = sl_false;
+				ObjectLocker lock(this);
+				return m_items.add_NoLock(Move(item));
+			}
+
+			sl_bool remove(const void* key, sl_size sizeKey) override
+			{
+				BatchItem item;
+				item.key = Memory::create(key, sizeKey);
+				if (item.key.isNull()) {
+					return sl_false;
+				}
+				item.flagRemove = sl_true;
+				ObjectLocker lock(this);
+				return m_items.add_NoLock(Move(item));
+			}
+
+			sl_bool _commit() override
+			{
+				if (m_store->applyBatch(m_items)) {
+					m_items.setNull();
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			void _discard() override
+			{
+				m_items.setNull();
+			}
+
+		};
+
+		Ref<KeyValueWriteBatch> BTreeStoreImpl::createWriteBatch()
+		{
+			if (m_flagReadOnly) {
+				return sl_null;
+			}
+			return new BTreeStoreWriteBatch(this);
+		}
+
+		class BTreeStoreIterator : public KeyValueIterator
+		{
+		public:
+			struct Frame
+			{
+				Memory page;
+				sl_uint32 index;
+			};
+
+			Ref<ReadState> m_state;
+			BTreeStoreImpl* m_store;
+			List<Frame> m_stack;
+			sl_bool m_flagValid;
+			sl_bool m_flagStarted;
+
+		public:
+			BTreeStoreIterator(ReadState* state): m_state(state), m_store(state->store.get()), m_flagValid(sl_false), m_flagStarted(sl_false) {}
+
+			~BTreeStoreIterator()
+			{
+			}
+
+		public:
+			sl_bool getKey(MemoryData* pOut) override
+			{
+				Frame* frame = _getLeaf();
+				if (!frame) {
+					return sl_false;
+				}
+				if (!pOut) {
+					return sl_true;
+				}
+				PageView view(frame->page.getData());
+				sl_uint32 size = view.getKeySize(frame->index);
+				if (size <= pOut->size) {
+					view.copyKey(frame->index, pOut->data);
+					pOut->size = size;
+				} else {
+					Memory mem = Memory::create(size);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+					view.copyKey(frame->index, mem.getData());
+					*pOut = Move(mem);
+				}
+				return sl_true;
+			}
+
+			sl_bool getValue(MemoryData* pOut) override
+			{
+				Frame* frame = _getLeaf();
+				if (!frame) {
+					return sl_false;
+				}
+				PageView view(frame->page.getData());
+				return m_store->_getValue(frame->page, view, frame->index, pOut);
+			}
+
+			sl_bool moveFirst() override
+			{
+				m_flagStarted = sl_true;
+				m_stack.setNull();
+				m_flagValid = _descend(m_state->meta.root, sl_false);
+				return m_flagValid;
+			}
+
+			sl_bool moveLast() override
+			{
+				m_flagStarted = sl_true;
+				m_stack.setNull();
+				m_flagValid = _descend(m_state->meta.root, sl_true);
+				return m_flagValid;
+			}
+
+			sl_bool moveNext() override
+			{
+				if (!m_flagStarted) {
+					return moveFirst();
+				}
+				if (!m_flagValid) {
+					return sl_false;
+				}
+				m_flagValid = _moveNext();
+				return m_flagValid;
+			}
+
+			sl_bool movePrevious() override
+			{
+				if (!m_flagStarted) {
+					return moveLast();
+				}
+				if (!m_flagValid) {
+					return sl_false;
+				}
+				m_flagValid = _movePrevious();
+				return m_flagValid;
+			}
+
+			sl_bool seek(const void* key, sl_size sizeKey) override
+			{
+				m_flagStarted = sl_true;
+				m_flagValid = sl_false;
+				m_stack.setNull();
+				sl_uint64 page = m_state->meta.root;
+				while (page) {
+					Frame frame;
+					frame.page = m_store->_readPage(page);
+					if (frame.page.isNull()) {
+						return sl_false;
+					}
+					PageView view(frame.page.getData());
+					if (view.isBranch()) {
+						frame.index = view.search(key, sizeKey, sl_true);
+						page = view.getChild(frame.index);
+						m_stack.add_NoLock(Move(frame));
+					} else if (view.isLeaf()) {
+						frame.index = view.search(key, sizeKey, sl_false);
+						sl_uint32 n = view.count;
+						if (frame.index < n) {
+							m_stack.add_NoLock(Move(frame));
+							m_flagValid = sl_true;
+						} else {
+							// move to the first item of the next leaf
+							if (n) {
+								frame.index = n - 1;
+								m_stack.add_NoLock(Move(frame));
+								m_flagValid = _moveNext();
+							} else {
+								m_flagValid = _moveNextBranch();
+							}
+						}
+						return m_flagValid;
+					} else {
+						return sl_false;
+					}
+				}
+				return sl_false;
+			}
+
+		public:
+			Frame* _getLeaf()
+			{
+				if (!m_flagValid) {
+					return sl_null;
+				}
+				sl_size n = m_stack.getCount();
+				if (!n) {
+					return sl_null;
+				}
+				return m_stack.getData() + (n - 1);
+			}
+
+			sl_bool _descend(sl_uint64 page, sl_bool flagLast)
+			{
+				while (page) {
+					Frame frame;
+					frame.page = m_store->_readPage(page);
+					if (frame.page.isNull()) {
+						return sl_false;
+					}
+					PageView view(frame.page.getData());
+					if (view.isBranch()) {
+						frame.index = flagLast ? view.count : 0;
+						page = view.getChild(frame.index);
+						m_stack.add_NoLock(Move(frame));
+					} else if (view.isLeaf()) {
+						if (!(view.count)) {
+							return sl_false;
+						}
+						frame.index = flagLast ? view.count - 1 : 0;
+						m_stack.add_NoLock(Move(frame));
+						return sl_true;
+					} else {
+						return sl_false;
+					}
+				}
+				return sl_false;
+			}
+
+			sl_bool _moveNext()
+			{
+				Frame* frame = m_stack.getData() + (m_stack.getCount() - 1);
+				PageView view(frame->page.getData());
+				if (frame->index + 1 < view.count) {
+					frame->index++;
+					return sl_true;
+				}
+				m_stack.popBack_NoLock();
+				return _moveNextBranch();
+			}
+
+			sl_bool _moveNextBranch()
+			{
+				for (;;) {
+					sl_size n = m_stack.getCount();
+					if (!n) {
+						return sl_false;
+					}
+					Frame* frame = m_stack.getData() + (n - 1);
+					PageView view(frame->page.getData());
+					if (frame->index < view.count) {
+						frame->index++;
+						return _descend(view.getChild(frame->index), sl_false);
+					}
+					m_stack.popBack_NoLock();
+				}
+			}
+
+			sl_bool _movePrevious()
+			{
+				Frame* frame = m_stack.getData() + (m_stack.getCount() - 1);
+				if (frame->index) {
+					frame->index--;
+					return sl_true;
+				}
+				m_stack.popBack_NoLock();
+				for (;;) {
+					sl_size n = m_stack.getCount();
+					if (!n) {
+						return sl_false;
+					}
+					frame = m_stack.getData() + (n - 1);
+					if (frame->index) {
+						frame->index--;
+						PageView view(frame->page.getData());
+						return _descend(view.getChild(frame->index), sl_true);
+					}
+					m_stack.popBack_NoLock();
+				}
+			}
+
+		};
+
+		Ref<KeyValueIterator> BTreeStoreImpl::getIterator()
+		{
+			Ref<ReadState> state = new ReadState(this);
+			if (state.isNotNull()) {
+				return new BTreeStoreIterator(state.get());
+			}
+			return sl_null;
+		}
+
+		class BTreeStoreSnapshot : public KeyValueSnapshot
+		{
+		public:
+			Ref<ReadState> m_state;
+
+		public:
+			BTreeStoreSnapshot(ReadState* state): m_state(state) {}
+
+			~BTreeStoreSnapshot()
+			{
+			}
+
+		public:
+			sl_bool get(const void* key, sl_size sizeKey, MemoryData* value) override
+			{
+				return m_state->store->_get(m_state->meta.root, key, sizeKey, value);
+			}
+
+			Ref<KeyValueIterator> getIterator() override
+			{
+				return new BTreeStoreIterator(m_state.get());
+			}
+
+		};
+
+		Ref<KeyValueSnapshot> BTreeStoreImpl::getSnapshot()
+		{
+			Ref<ReadState> state = new ReadState(this);
+			if (state.isNotNull()) {
+				return new BTreeStoreSnapshot(state.get());
+			}
+			return sl_null;
+		}
+
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(BTreeStore_Param)
+
+	BTreeStore_Param::BTreeStore_Param()
+	{
+		flagCreateIfMissing = sl_true;
+		flagReadOnly = sl_false;
+		flagSync = sl_true;
+
+		pageSize = DEFAULT_PAGE_SIZE;
+		cacheSize = DEFAULT_CACHE_SIZE;
+	}
+
+
+	SLIB_DEFINE_OBJECT(BTreeStore, KeyValueStore)
+
+	BTreeStore::BTreeStore()
+	{
+	}
+
+	BTreeStore::~BTreeStore()
+	{
+	}
+
+	Ref<BTreeStore> BTreeStore::open(BTreeStore_Param& param)
+	{
+		return Ref<BTreeStore>::cast(BTreeStoreImpl::open(param));
+	}
+
+	Ref<BTreeStore> BTreeStore::open(const StringParam& path)
+	{
+		BTreeStore_Param param;
+		param.path = path.toString();
+		return open(param);
+	}
+
+}
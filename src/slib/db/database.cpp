@@ -25,9 +25,64 @@
 #include "slib/core/string_buffer.h"
 #include "slib/core/log.h"
 
+#define DEFAULT_STATEMENT_CACHE_SIZE 64
+
 namespace slib
 {
 
+	namespace {
+
+		// CREATE, ALTER, DROP
+		static sl_bool IsSchemaChangingSQL(const StringParam& _sql)
+		{
+			StringData sql(_sql);
+			const sl_char8* s = sql.getData();
+			sl_size n = sql.getLength();
+			sl_size i = 0;
+			while (i < n && SLIB_CHAR_IS_WHITE_SPACE(s[i])) {
+				i++;
+			}
+			StringView str(s + i, n - i);
+			return str.startsWith_IgnoreCase("CREATE") || str.startsWith_IgnoreCase("ALTER") || str.startsWith_IgnoreCase("DROP");
+		}
+
+		static sl_size GetInsertRowsPerStatement(DatabaseDialect dialect, sl_size nColumns)
+		{
+			sl_size nMaxParams;
+			sl_size nMaxRows = SLIB_SIZE_MAX;
+			switch (dialect) {
+				case DatabaseDialect::PostgreSQL:
+				case DatabaseDialect::MySQL:
+					nMaxParams = 65535;
+					break;
+				case DatabaseDialect::MSSQL:
+					nMaxParams = 2100;
+					nMaxRows = 1000;
+					break;
+				case DatabaseDialect::Oracle:
+					// multi-row `VALUES` is not supported
+					return 1;
+				default:
+					// SQLITE_MAX_VARIABLE_NUMBER of the versions before 3.32.0
+					nMaxParams = 999;
+					break;
+			}
+			sl_size n = nMaxParams / nColumns;
+			if (n > nMaxRows) {
+				n = nMaxRows;
+			}
+			if (!n) {
+				n = 1;
+			}
+			return n;
+		}
+
+	}
+
+	DatabaseStatementCacheStatistics::DatabaseStatementCacheStatistics() noexcept: hitCount(0), missCount(0), cachedCount(0)
+	{
+	}
+
 	SLIB_DEFINE_OBJECT(Database, Object)
 
 	Database::Database()
@@ -35,17 +90,25 @@ namespace slib
 		m_flagLogSQL = sl_false;
 		m_flagLogErrors = sl_true;
 		m_dialect = DatabaseDialect::Generic;
+
+		m_sizeStatementCache = DEFAULT_STATEMENT_CACHE_SIZE;
+		m_nStatementCacheHits = 0;
+		m_nStatementCacheMisses = 0;
 	}
 
 	Database::~Database()
 	{
+		_freeStatementCache();
 	}
 
-	sl_int64 Database::_executeBy(const StringParam& sql, const Variant* params, sl_size nParams)
+	sl_int64 Database::_executeBy(const StringParam& _sql, const Variant* params, sl_size nParams)
 	{
-		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		String sql = _sql.toString();
+		Ref<DatabaseStatement> statement = _getCachedStatement(sql);
 		if (statement.isNotNull()) {
-			return statement->executeBy(params, nParams);
+			sl_int64 ret = statement->executeBy(params, nParams);
+			_releaseCachedStatement(sql, statement, ret >= 0);
+			return ret;
 		}
 		return -1;
 	}
@@ -55,11 +118,14 @@ namespace slib
 		return _executeBy(sql, sl_null, 0);
 	}
 
-	Ref<DatabaseCursor> Database::_queryBy(const StringParam& sql, const Variant* params, sl_size nParams)
+	Ref<DatabaseCursor> Database::_queryBy(const StringParam& _sql, const Variant* params, sl_size nParams)
 	{
-		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		String sql = _sql.toString();
+		Ref<DatabaseStatement> statement = _getCachedStatement(sql);
 		if (statement.isNotNull()) {
-			return statement->queryBy(params, nParams);
+			Ref<DatabaseCursor> cursor = statement->queryBy(params, nParams);
+			_releaseCachedStatement(sql, statement, cursor.isNotNull());
+			return cursor;
 		}
 		return sl_null;
 	}
@@ -95,6 +161,9 @@ namespace slib
 			_logError(sql, params, nParams);
 		} else {
 			_logSQL(sql, params, nParams);
+			if (IsSchemaChangingSQL(sql)) {
+				clearStatementCache();
+			}
 		}
 		return ret;
 	}
@@ -106,6 +175,9 @@ namespace slib
 			_logError(sql);
 		} else {
 			_logSQL(sql);
+			if (IsSchemaChangingSQL(sql)) {
+				clearStatementCache();
+			}
 		}
 		return ret;
 	}
@@ -202,6 +274,29 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_int64 Database::executeBatch(const StringParam& _sql, const Variant* params, sl_size nParamsPerRow, sl_size nRows)
+	{
+		String sql = _sql.toString();
+		Ref<DatabaseStatement> statement = _getCachedStatement(sql);
+		if (statement.isNull()) {
+			_logError(sql);
+			return -1;
+		}
+		sl_int64 total = 0;
+		for (sl_size i = 0; i < nRows; i++) {
+			const Variant* row = params + i * nParamsPerRow;
+			sl_int64 ret = statement->executeBy(row, nParamsPerRow);
+			if (ret < 0) {
+				_releaseCachedStatement(sql, statement, sl_false);
+				_logError(sql, row, nParamsPerRow);
+				return -1;
+			}
+			total += ret;
+		}
+		_releaseCachedStatement(sql, statement, sl_true);
+		return total;
+	}
+
 	sl_bool Database::isLoggingSQL()
 	{
 		return m_flagLogSQL;
@@ -227,6 +322,144 @@ namespace slib
 		return m_dialect;
 	}
 
+	sl_uint32 Database::getStatementCacheSize()
+	{
+		return m_sizeStatementCache;
+	}
+
+	void Database::setStatementCacheSize(sl_uint32 size)
+	{
+		m_sizeStatementCache = size;
+		List< Ref<DatabaseStatement> > removed;
+		{
+			SpinLocker lock(&m_lockStatementCache);
+			while (m_listCachedStatements.getCount() > size) {
+				Link<CachedStatement>* link = m_listCachedStatements.popLinkFromBack_NoLock();
+				m_mapCachedStatements.remove_NoLock(link->value.sql);
+				removed.add_NoLock(Move(link->value.statement));
+				CLinkedList<CachedStatement>::deleteLink(link);
+			}
+		}
+		ListElements< Ref<DatabaseStatement> > items(removed);
+		for (sl_size i = 0; i < items.count; i++) {
+			items[i]->m_db = this;
+		}
+	}
+
+	void Database::clearStatementCache()
+	{
+		_clearStatementCache(sl_false);
+	}
+
+	void Database::getStatementCacheStatistics(DatabaseStatementCacheStatistics& _out)
+	{
+		SpinLocker lock(&m_lockStatementCache);
+		_out.hitCount = m_nStatementCacheHits;
+		_out.missCount = m_nStatementCacheMisses;
+		_out.cachedCount = m_listCachedStatements.getCount();
+	}
+
+	Ref<DatabaseStatement> Database::_getCachedStatement(const String& sql)
+	{
+		if (!m_sizeStatementCache) {
+			return prepareStatement(sql);
+		}
+		{
+			SpinLocker lock(&m_lockStatementCache);
+			Link<CachedStatement>* link = sl_null;
+			if (m_mapCachedStatements.get_NoLock(sql, &link)) {
+				Ref<DatabaseStatement>& statement = link->value.statement;
+				// the statement is used by another call or by a cursor when it is referenced outside of the cache
+				if (statement->getReferenceCount() == 1) {
+					m_listCachedStatements.removeLink(link);
+					link->before = sl_null;
+					link->next = sl_null;
+					m_listCachedStatements.pushLinkAtFront_NoLock(link);
+					m_nStatementCacheHits++;
+					statement->m_db = this;
+					return statement;
+				}
+			}
+			m_nStatementCacheMisses++;
+		}
+		Ref<DatabaseStatement> statement = prepareStatement(sql);
+		if (statement.isNull()) {
+			return sl_null;
+		}
+		Ref<DatabaseStatement> removed;
+		{
+			SpinLocker lock(&m_lockStatementCache);
+			if (!(m_mapCachedStatements.find_NoLock(sql))) {
+				Link<CachedStatement>* link = m_listCachedStatements.pushFront_NoLock();
+				if (link) {
+					link->value.sql = sql;
+					link->value.statement = statement;
+					if (m_mapCachedStatements.put_NoLock(sql, link)) {
+						if (m_listCachedStatements.getCount() > m_sizeStatementCache) {
+							link = m_listCachedStatements.popLinkFromBack_NoLock();
+							m_mapCachedStatements.remove_NoLock(link->value.sql);
+							removed = Move(link->value.statement);
+							CLinkedList<CachedStatement>::deleteLink(link);
+						}
+					} else {
+						m_listCachedStatements.removeLink(link);
+						CLinkedList<CachedStatement>::deleteLink(link);
+					}
+				}
+			}
+		}
+		if (removed.isNotNull()) {
+			removed->m_db = this;
+		}
+		return statement;
+	}
+
+	void Database::_releaseCachedStatement(const String& sql, Ref<DatabaseStatement>& statement, sl_bool flagSuccess)
+	{
+		Ref<DatabaseStatement> removed;
+		{
+			SpinLocker lock(&m_lockStatementCache);
+			Link<CachedStatement>* link = sl_null;
+			if (m_mapCachedStatements.get_NoLock(sql, &link)) {
+				if (link->value.statement == statement) {
+					if (flagSuccess) {
+						// breaks the reference cycle between the database and the cached statement
+						statement->m_db.setNull();
+					} else {
+						// the statement may be invalidated by the schema change
+						m_mapCachedStatements.remove_NoLock(sql);
+						m_listCachedStatements.removeLink(link);
+						removed = Move(link->value.statement);
+						CLinkedList<CachedStatement>::deleteLink(link);
+					}
+				}
+			}
+		}
+		statement.setNull();
+	}
+
+	void Database::_clearStatementCache(sl_bool flagDestroying)
+	{
+		CLinkedList<CachedStatement> list;
+		{
+			SpinLocker lock(&m_lockStatementCache);
+			m_mapCachedStatements.removeAll_NoLock();
+			list.merge_NoLock(&m_listCachedStatements);
+		}
+		if (!flagDestroying) {
+			Link<CachedStatement>* link = list.getFront();
+			while (link) {
+				link->value.statement->m_db = this;
+				link = link->next;
+			}
+		}
+	}
+
+	void Database::_freeStatementCache()
+	{
+		_clearStatementCache(sl_true);
+	}
+
 	sl_bool Database::createTable(const CreateTableParam& param)
 	{
 		SqlBuilder builder(m_dialect);
@@ -301,6 +534,67 @@ namespace slib
 		return prepareStatement(sql);
 	}
 
+	sl_int64 Database::insertBatch(const DatabaseIdentifier& table, const ListParam<String>& columns, const Variant* values, sl_size nRows)
+	{
+		sl_size nColumns = columns.getCount();
+		if (!nColumns) {
+			return -1;
+		}
+		sl_size nRowsPerStatement = GetInsertRowsPerStatement(m_dialect, nColumns);
+		String sqlFull;
+		sl_int64 total = 0;
+		while (nRows) {
+			sl_size n = nRows;
+			if (n > nRowsPerStatement) {
+				n = nRowsPerStatement;
+			}
+			String sql;
+			if (n == nRowsPerStatement && sqlFull.isNotNull()) {
+				sql = sqlFull;
+			} else {
+				SqlBuilder builder(m_dialect);
+				builder.generateInsert(table, columns, n);
+				sql = builder.toString();
+				if (n == nRowsPerStatement) {
+					sqlFull = sql;
+				}
+			}
+			sl_int64 ret = executeBy(sql, values, n * nColumns);
+			if (ret < 0) {
+				return -1;
+			}
+			total += ret;
+			values += n * nColumns;
+			nRows -= n;
+		}
+		return total;
+	}
+
+	sl_int64 Database::insertBatch(const DatabaseIdentifier& table, const DatabaseRowBatch& batch)
+	{
+		sl_size nColumns = batch.columns.getCount();
+		if (!nColumns) {
+			return -1;
+		}
+		sl_uint32 nRows = batch.rowCount;
+		List<String> names;
+		DatabaseColumnBatch* columns = batch.columns.getData();
+		for (sl_size i = 0; i < nColumns; i++) {
+			names.add_NoLock(columns[i].name);
+		}
+		Array<Variant> values = Array<Variant>::create(nRows * nColumns);
+		if (values.isNull()) {
+			return nRows ? -1 : 0;
+		}
+		Variant* p = values.getData();
+		for (sl_uint32 row = 0; row < nRows; row++) {
+			for (sl_size i = 0; i < nColumns; i++) {
+				*(p++) = columns[i].getValue(row);
+			}
+		}
+		return insertBatch(table, names, values.getData(), nRows);
+	}
+
 	Ref<DatabaseStatement> Database::prepareUpdate(const DatabaseIdentifier& table, const ListParam<String>& columns, const DatabaseExpression& where)
 	{
 		SqlBuilder builder(m_dialect);
@@ -0,0 +1,307 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/db/column_batch.h"
+
+#include "slib/db/cursor.h"
+
+namespace slib
+{
+
+	DatabaseColumnBatch::DatabaseColumnBatch() noexcept: type(DatabaseColumnBatchType::Auto), m_sizeData(0), m_nRows(0), m_capacity(0)
+	{
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DatabaseColumnBatch)
+
+	sl_int64 DatabaseColumnBatch::getInt64(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows) {
+			switch (type) {
+				case DatabaseColumnBatchType::Int64:
+					return ((sl_int64*)(m_values.getData()))[row];
+				case DatabaseColumnBatchType::Double:
+					return (sl_int64)(((double*)(m_values.getData()))[row]);
+				case DatabaseColumnBatchType::String:
+					return getStringView(row).parseInt64();
+				default:
+					break;
+			}
+		}
+		return 0;
+	}
+
+	double DatabaseColumnBatch::getDouble(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows) {
+			switch (type) {
+				case DatabaseColumnBatchType::Int64:
+					return (double)(((sl_int64*)(m_values.getData()))[row]);
+				case DatabaseColumnBatchType::Double:
+					return ((double*)(m_values.getData()))[row];
+				case DatabaseColumnBatchType::String:
+					return getStringView(row).parseDouble();
+				default:
+					break;
+			}
+		}
+		return 0;
+	}
+
+	StringView DatabaseColumnBatch::getStringView(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows) {
+			if (type == DatabaseColumnBatchType::String || type == DatabaseColumnBatchType::Blob) {
+				sl_uint64* ends = (sl_uint64*)(m_values.getData());
+				sl_size start = row ? (sl_size)(ends[row - 1]) : 0;
+				return StringView((sl_char8*)(m_data.getData()) + start, (sl_size)(ends[row]) - start);
+			}
+		}
+		return sl_null;
+	}
+
+	String DatabaseColumnBatch::getString(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows && !(isNull(row))) {
+			switch (type) {
+				case DatabaseColumnBatchType::Int64:
+					return String::fromInt64(((sl_int64*)(m_values.getData()))[row]);
+				case DatabaseColumnBatchType::Double:
+					return String::fromDouble(((double*)(m_values.getData()))[row]);
+				case DatabaseColumnBatchType::String:
+				case DatabaseColumnBatchType::Blob:
+					return String(getStringView(row));
+				default:
+					break;
+			}
+		}
+		return sl_null;
+	}
+
+	Memory DatabaseColumnBatch::getBlob(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows) {
+			if (type == DatabaseColumnBatchType::String || type == DatabaseColumnBatchType::Blob) {
+				StringView view = getStringView(row);
+				return Memory::create(view.getData(), view.getLength());
+			}
+		}
+		return sl_null;
+	}
+
+	Variant DatabaseColumnBatch::getValue(sl_uint32 row) const noexcept
+	{
+		if (row < m_nRows && !(isNull(row))) {
+			switch (type) {
+				case DatabaseColumnBatchType::Int64:
+					return ((sl_int64*)(m_values.getData()))[row];
+				case DatabaseColumnBatchType::Double:
+					return ((double*)(m_values.getData()))[row];
+				case DatabaseColumnBatchType::String:
+					return String(getStringView(row));
+				case DatabaseColumnBatchType::Blob:
+					return getBlob(row);
+				default:
+					break;
+			}
+		}
+		return sl_null;
+	}
+
+	sl_bool DatabaseColumnBatch::reset(sl_uint32 capacity) noexcept
+	{
+		m_nRows = 0;
+		m_sizeData = 0;
+		if (capacity > m_capacity || m_values.isNull()) {
+			if (!capacity) {
+				capacity = 1;
+			}
+			// 8 bytes per row for all types, so that the NULL values added before the type is resolved are valid
+			Memory values = Memory::create(((sl_size)capacity) << 3);
+			if (values.isNull()) {
+				return sl_false;
+			}
+			Memory nulls = Memory::create((capacity + 7) >> 3);
+			if (nulls.isNull()) {
+				return sl_false;
+			}
+			m_values = Move(values);
+			m_nulls = Move(nulls);
+			m_capacity = capacity;
+		}
+		Base::zeroMemory(m_nulls.getData(), (capacity + 7) >> 3);
+		return sl_true;
+	}
+
+	void DatabaseColumnBatch::addNull() noexcept
+	{
+		((sl_uint8*)(m_nulls.getData()))[m_nRows >> 3] |= (sl_uint8)(1 << (m_nRows & 7));
+		if (type == DatabaseColumnBatchType::String || type == DatabaseColumnBatchType::Blob) {
+			((sl_uint64*)(m_values.getData()))[m_nRows] = m_sizeData;
+		} else {
+			((sl_int64*)(m_values.getData()))[m_nRows] = 0;
+		}
+		m_nRows++;
+	}
+
+	void DatabaseColumnBatch::addInt64(sl_int64 value) noexcept
+	{
+		((sl_int64*)(m_values.getData()))[m_nRows] = value;
+		m_nRows++;
+	}
+
+	void DatabaseColumnBatch::addDouble(double value) noexcept
+	{
+		((double*)(m_values.getData()))[m_nRows] = value;
+		m_nRows++;
+	}
+
+	void DatabaseColumnBatch::addBytes(const void* data, sl_size size) noexcept
+	{
+		if (size) {
+			sl_size sizeNew = m_sizeData + size;
+			if (sizeNew > m_data.getSize()) {
+				sl_size capacity = m_data.getSize() << 1;
+				if (capacity < sizeNew) {
+					capacity = sizeNew;
+				}
+				if (capacity < 1024) {
+					capacity = 1024;
+				}
+				Memory mem = Memory::create(capacity);
+				if (mem.isNull()) {
+					addNull();
+					return;
+				}
+				if (m_sizeData) {
+					Base::copyMemory(mem.getData(), m_data.getData(), m_sizeData);
+				}
+				m_data = Move(mem);
+			}
+			Base::copyMemory((sl_uint8*)(m_data.getData()) + m_sizeData, data, size);
+			m_sizeData = sizeNew;
+		}
+		((sl_uint64*)(m_values.getData()))[m_nRows] = m_sizeData;
+		m_nRows++;
+	}
+
+	void DatabaseColumnBatch::addValue(const Variant& value) noexcept
+	{
+		if (value.isNull()) {
+			addNull();
+			return;
+		}
+		if (type == DatabaseColumnBatchType::Auto) {
+			if (value.isIntegerType() || value.isBoolean()) {
+				type = DatabaseColumnBatchType::Int64;
+			} else if (value.isNumberType()) {
+				type = DatabaseColumnBatchType::Double;
+			} else if (value.isMemory()) {
+				type = DatabaseColumnBatchType::Blob;
+			} else {
+				type = DatabaseColumnBatchType::String;
+			}
+		}
+		switch (type) {
+			case DatabaseColumnBatchType::Int64:
+				addInt64(value.getInt64());
+				break;
+			case DatabaseColumnBatchType::Double:
+				addDouble(value.getDouble());
+				break;
+			default:
+				if (value.isMemory()) {
+					Memory mem = value.getMemory();
+					addBytes(mem.getData(), mem.getSize());
+				} else {
+					String str = value.getString();
+					addBytes(str.getData(), str.getLength());
+				}
+				break;
+		}
+	}
+
+
+	DatabaseRowBatch::DatabaseRowBatch() noexcept: rowCount(0)
+	{
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DatabaseRowBatch)
+
+	sl_uint32 DatabaseRowBatch::getColumnCount() const noexcept
+	{
+		return (sl_uint32)(columns.getCount());
+	}
+
+	sl_int32 DatabaseRowBatch::getColumnIndex(const StringView& name) const noexcept
+	{
+		DatabaseColumnBatch* data = columns.getData();
+		sl_size n = columns.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			if (data[i].name == name) {
+				return (sl_int32)i;
+			}
+		}
+		return -1;
+	}
+
+	DatabaseColumnBatch* DatabaseRowBatch::getColumn(sl_uint32 index) const noexcept
+	{
+		if (index < columns.getCount()) {
+			return columns.getData() + index;
+		}
+		return sl_null;
+	}
+
+	DatabaseColumnBatch* DatabaseRowBatch::getColumn(const StringView& name) const noexcept
+	{
+		sl_int32 index = getColumnIndex(name);
+		if (index >= 0) {
+			return columns.getData() + index;
+		}
+		return sl_null;
+	}
+
+	sl_bool DatabaseRowBatch::prepare(DatabaseCursor* cursor, sl_uint32 maxRows) noexcept
+	{
+		rowCount = 0;
+		sl_uint32 nColumns = cursor->getColumnCount();
+		if (columns.getCount() != nColumns) {
+			if (!(columns.setCount_NoLock(nColumns))) {
+				return sl_false;
+			}
+		}
+		DatabaseColumnBatch* data = columns.getData();
+		for (sl_uint32 i = 0; i < nColumns; i++) {
+			DatabaseColumnBatch& column = data[i];
+			if (column.name.isNull()) {
+				column.name = cursor->getColumnName(i);
+			}
+			if (!(column.reset(maxRows))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+}
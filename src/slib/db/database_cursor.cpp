@@ -204,4 +204,22 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_uint32 DatabaseCursor::fetchBatch(DatabaseRowBatch& batch, sl_uint32 maxRows)
+	{
+		if (!(batch.prepare(this, maxRows))) {
+			return 0;
+		}
+		DatabaseColumnBatch* columns = batch.columns.getData();
+		sl_uint32 nColumns = (sl_uint32)(batch.columns.getCount());
+		sl_uint32 nRows = 0;
+		while (nRows < maxRows && moveNext()) {
+			for (sl_uint32 i = 0; i < nColumns; i++) {
+				columns[i].addValue(getValue(i));
+			}
+			nRows++;
+		}
+		batch.rowCount = nRows;
+		return nRows;
+	}
+
 }
@@ -0,0 +1,438 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/db/database_pool.h"
+
+#include "slib/core/event.h"
+#include "slib/core/timeout.h"
+
+namespace slib
+{
+
+	namespace {
+
+		// microseconds, for the statistics
+		static sl_uint64 GetCurrentTime()
+		{
+			return (sl_uint64)(Time::now().toInt());
+		}
+
+		static sl_uint64 GetElapsedTime(sl_uint64 start, sl_uint64 now)
+		{
+			return now > start ? now - start : 0;
+		}
+
+	}
+
+	DatabasePoolParam::DatabasePoolParam()
+	{
+		checkSQL = "SELECT 1";
+		minimumSize = 1;
+		maximumSize = 8;
+		idleTimeout = 60000;
+		checkInterval = 30000;
+		borrowTimeout = 30000;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DatabasePoolParam)
+
+
+	DatabasePoolStatistics::DatabasePoolStatistics() noexcept
+	{
+		Base::zeroMemory(this, sizeof(DatabasePoolStatistics));
+	}
+
+
+	DatabaseLease::DatabaseLease() noexcept: m_timeBorrowed(0)
+	{
+	}
+
+	DatabaseLease::DatabaseLease(DatabasePool* pool, Ref<Database>&& db, sl_uint64 timeBorrowed) noexcept: m_pool(pool), m_db(Move(db)), m_timeBorrowed(timeBorrowed)
+	{
+	}
+
+	DatabaseLease::~DatabaseLease()
+	{
+		_release(sl_false);
+	}
+
+	DatabaseLease::DatabaseLease(DatabaseLease&& other): m_pool(Move(other.m_pool)), m_db(Move(other.m_db)), m_timeBorrowed(other.m_timeBorrowed)
+	{
+	}
+
+	DatabaseLease& DatabaseLease::operator=(DatabaseLease&& other)
+	{
+		if (this != &other) {
+			_release(sl_false);
+			m_pool = Move(other.m_pool);
+			m_db = Move(other.m_db);
+			m_timeBorrowed = other.m_timeBorrowed;
+		}
+		return *this;
+	}
+
+	void DatabaseLease::release() noexcept
+	{
+		_release(sl_false);
+	}
+
+	void DatabaseLease::discard() noexcept
+	{
+		_release(sl_true);
+	}
+
+	void DatabaseLease::_release(sl_bool flagDiscard) noexcept
+	{
+		Ref<DatabasePool> pool = Move(m_pool);
+		if (m_db.isNotNull()) {
+			if (pool.isNotNull()) {
+				pool->_return(m_db, m_timeBorrowed, flagDiscard);
+			}
+			m_db.setNull();
+		}
+	}
+
+
+	SLIB_DEFINE_OBJECT(DatabasePool, Object)
+
+	DatabasePool::DatabasePool()
+	{
+		m_flagClosed = sl_false;
+		m_timeCreated = 0;
+
+		m_nTotal = 0;
+		m_nBorrowed = 0;
+
+		m_nBorrows = 0;
+		m_nWaits = 0;
+		m_nTimeouts = 0;
+		m_nCreates = 0;
+		m_nCreateFailures = 0;
+		m_nCloses = 0;
+		m_nCheckFailures = 0;
+		m_timeTotalWait = 0;
+		m_timeMaxWait = 0;
+		m_timeTotalBorrowed = 0;
+	}
+
+	DatabasePool::~DatabasePool()
+	{
+	}
+
+	Ref<DatabasePool> DatabasePool::create(const DatabasePoolParam& param)
+	{
+		if (param.onCreate.isNull() || !(param.maximumSize)) {
+			return sl_null;
+		}
+		Ref<DatabasePool> ret = new DatabasePool;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->m_param = param;
+		if (param.minimumSize > param.maximumSize) {
+			ret->m_param.minimumSize = param.maximumSize;
+		}
+		sl_uint64 now = System::getTickCount64();
+		ret->m_timeCreated = GetCurrentTime();
+		for (sl_uint32 i = 0; i < ret->m_param.minimumSize; i++) {
+			Ref<Database> db = ret->_createConnection();
+			if (db.isNull()) {
+				return sl_null;
+			}
+			if (!(ret->m_listIdle.pushBack_NoLock(IdleConnection{ Move(db), now }))) {
+				return sl_null;
+			}
+			ret->m_nTotal++;
+		}
+		return ret;
+	}
+
+	DatabaseLease DatabasePool::borrow()
+	{
+		return borrow(m_param.borrowTimeout);
+	}
+
+	DatabaseLease DatabasePool::borrow(sl_int32 timeout)
+	{
+		sl_uint64 timeBorrowed = 0;
+		Ref<Database> db = _borrow(timeout, timeBorrowed);
+		if (db.isNotNull()) {
+			return DatabaseLease(this, Move(db), timeBorrowed);
+		}
+		return DatabaseLease();
+	}
+
+	void DatabasePool::evictIdleConnections()
+	{
+		List< Ref<Database> > evicted;
+		MutexLocker lock(&m_lock);
+		_evictIdleConnections(evicted, System::getTickCount64());
+		lock.unlock();
+	}
+
+	void DatabasePool::close()
+	{
+		CLinkedList<IdleConnection> idle;
+		{
+			MutexLocker lock(&m_lock);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagClosed = sl_true;
+			sl_uint32 n = (sl_uint32)(m_listIdle.getCount());
+			m_nTotal -= n;
+			m_nCloses += n;
+			idle.merge_NoLock(&m_listIdle);
+			while (_wakeWaiter_NoLock(sl_null)) {
+			}
+		}
+	}
+
+	sl_bool DatabasePool::isClosed()
+	{
+		return m_flagClosed;
+	}
+
+	void DatabasePool::getStatistics(DatabasePoolStatistics& _out)
+	{
+		MutexLocker lock(&m_lock);
+		_out.totalCount = m_nTotal;
+		_out.idleCount = (sl_uint32)(m_listIdle.getCount());
+		_out.borrowedCount = m_nBorrowed;
+		_out.waitingCount = (sl_uint32)(m_listWaiters.getCount());
+		_out.borrowCount = m_nBorrows;
+		_out.waitCount = m_nWaits;
+		_out.timeoutCount = m_nTimeouts;
+		_out.createCount = m_nCreates;
+		_out.createFailureCount = m_nCreateFailures;
+		_out.closeCount = m_nCloses;
+		_out.checkFailureCount = m_nCheckFailures;
+		_out.totalWaitTime = m_timeTotalWait;
+		_out.maxWaitTime = m_timeMaxWait;
+		_out.totalBorrowedTime = m_timeTotalBorrowed;
+		sl_uint64 elapsed = GetElapsedTime(m_timeCreated, GetCurrentTime());
+		if (elapsed) {
+			_out.utilization = (double)m_timeTotalBorrowed / ((double)elapsed * (double)(m_param.maximumSize));
+		} else {
+			_out.utilization = 0;
+		}
+	}
+
+	Ref<Database> DatabasePool::_borrow(sl_int32 timeout, sl_uint64& timeBorrowed)
+	{
+		sl_int64 tickEnd = GetTickFromTimeout(timeout);
+		sl_uint64 timeStart = GetCurrentTime();
+		sl_bool flagWaited = sl_false;
+		Ref<Event> event;
+		List< Ref<Database> > evicted;
+		for (;;) {
+			Ref<Database> db;
+			sl_bool flagCreate = sl_false;
+			sl_bool flagCheck = sl_false;
+			{
+				MutexLocker lock(&m_lock);
+				if (m_flagClosed) {
+					return sl_null;
+				}
+				sl_uint64 now = System::getTickCount64();
+				_evictIdleConnections(evicted, now);
+				Link<IdleConnection>* link = m_listIdle.popLinkFromFront_NoLock();
+				if (link) {
+					db = Move(link->value.db);
+					flagCheck = now - link->value.timeReturned >= m_param.checkInterval;
+					CLinkedList<IdleConnection>::deleteLink(link);
+					m_nBorrowed++;
+				} else if (m_nTotal < m_param.maximumSize) {
+					// reserves the slot before creating the connection out of the lock
+					m_nTotal++;
+					m_nBorrowed++;
+					flagCreate = sl_true;
+				} else {
+					sl_int32 t = GetTimeoutFromTick(tickEnd);
+					if (!t) {
+						m_nTimeouts++;
+						if (flagWaited) {
+							_addWaitTime_NoLock(timeStart);
+						}
+						return sl_null;
+					}
+					if (event.isNull()) {
+						event = Event::create();
+						if (event.isNull()) {
+							return sl_null;
+						}
+					}
+					Waiter waiter;
+					waiter.event = event;
+					waiter.flagWoken = sl_false;
+					Link<Waiter*>* linkWaiter = m_listWaiters.pushBack_NoLock(&waiter);
+					if (!linkWaiter) {
+						return sl_null;
+					}
+					flagWaited = sl_true;
+					lock.unlock();
+					evicted.setNull();
+					event->wait(t);
+					lock.lock(&m_lock);
+					if (!(waiter.flagWoken)) {
+						m_listWaiters.removeLink(linkWaiter);
+						CLinkedList<Waiter*>::deleteLink(linkWaiter);
+						continue;
+					}
+					if (waiter.db.isNull()) {
+						// a slot is released, or the pool is closed
+						continue;
+					}
+					// handed over by `_return()`, which counted it as borrowed
+					db = Move(waiter.db);
+					timeBorrowed = waiter.timeHandedOver;
+				}
+			}
+			evicted.setNull();
+			if (flagCreate) {
+				db = _createConnection();
+				if (db.isNull()) {
+					MutexLocker lock(&m_lock);
+					m_nTotal--;
+					m_nBorrowed--;
+					_wakeWaiter_NoLock(sl_null);
+					return sl_null;
+				}
+			} else if (flagCheck) {
+				if (!(_check(db.get()))) {
+					{
+						MutexLocker lock(&m_lock);
+						m_nCheckFailures++;
+						m_nCloses++;
+						m_nTotal--;
+						m_nBorrowed--;
+					}
+					db.setNull();
+					continue;
+				}
+			}
+			MutexLocker lock(&m_lock);
+			m_nBorrows++;
+			if (flagWaited) {
+				m_nWaits++;
+				_addWaitTime_NoLock(timeStart);
+			}
+			if (!timeBorrowed) {
+				timeBorrowed = GetCurrentTime();
+			}
+			return db;
+		}
+	}
+
+	void DatabasePool::_return(Ref<Database>& db, sl_uint64 timeBorrowed, sl_bool flagDiscard)
+	{
+		Ref<Database> closing;
+		List< Ref<Database> > evicted;
+		MutexLocker lock(&m_lock);
+		sl_uint64 now = System::getTickCount64();
+		m_nBorrowed--;
+		m_timeTotalBorrowed += GetElapsedTime(timeBorrowed, GetCurrentTime());
+		if (flagDiscard || m_flagClosed) {
+			m_nTotal--;
+			m_nCloses++;
+			closing = Move(db);
+			_wakeWaiter_NoLock(sl_null);
+		} else {
+			if (!(_wakeWaiter_NoLock(&db))) {
+				m_listIdle.pushFront_NoLock(IdleConnection{ Move(db), now });
+			}
+		}
+		_evictIdleConnections(evicted, now);
+		lock.unlock();
+	}
+
+	sl_bool DatabasePool::_check(Database* db)
+	{
+		if (m_param.onCheck.isNotNull()) {
+			return m_param.onCheck(db);
+		}
+		Ref<DatabaseCursor> cursor = db->query(m_param.checkSQL);
+		if (cursor.isNotNull()) {
+			return cursor->moveNext();
+		}
+		return sl_false;
+	}
+
+	Ref<Database> DatabasePool::_createConnection()
+	{
+		Ref<Database> db = m_param.onCreate();
+		MutexLocker lock(&m_lock);
+		if (db.isNotNull()) {
+			m_nCreates++;
+		} else {
+			m_nCreateFailures++;
+		}
+		return db;
+	}
+
+	sl_bool DatabasePool::_wakeWaiter_NoLock(Ref<Database>* db)
+	{
+		Link<Waiter*>* link = m_listWaiters.popLinkFromFront_NoLock();
+		if (!link) {
+			return sl_false;
+		}
+		Waiter* waiter = link->value;
+		CLinkedList<Waiter*>::deleteLink(link);
+		if (db) {
+			waiter->db = Move(*db);
+			waiter->timeHandedOver = GetCurrentTime();
+			m_nBorrowed++;
+		}
+		waiter->flagWoken = sl_true;
+		waiter->event->set();
+		return sl_true;
+	}
+
+	void DatabasePool::_addWaitTime_NoLock(sl_uint64 timeStart)
+	{
+		sl_uint64 t = GetElapsedTime(timeStart, GetCurrentTime());
+		m_timeTotalWait += t;
+		if (t > m_timeMaxWait) {
+			m_timeMaxWait = t;
+		}
+	}
+
+	void DatabasePool::_evictIdleConnections(List< Ref<Database> >& evicted, sl_uint64 now)
+	{
+		if (!(m_param.idleTimeout)) {
+			return;
+		}
+		while (m_nTotal > m_param.minimumSize) {
+			Link<IdleConnection>* link = m_listIdle.getBack();
+			if (!link || now - link->value.timeReturned < m_param.idleTimeout) {
+				break;
+			}
+			m_listIdle.removeLink(link);
+			evicted.add_NoLock(Move(link->value.db));
+			CLinkedList<IdleConnection>::deleteLink(link);
+			m_nTotal--;
+			m_nCloses++;
+		}
+	}
+
+}
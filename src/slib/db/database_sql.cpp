@@ -654,6 +654,40 @@ namespace slib
 		appendStatic(")");
 	}
 
+	void SqlBuilder::generateInsert(const DatabaseIdentifier& table, const ListParam<String>& _columns, sl_size nRows)
+	{
+		ListLocker<String> columns(_columns);
+		if (columns.count < 1 || !nRows) {
+			return;
+		}
+		appendStatic("INSERT INTO ");
+		appendIdentifier(table);
+		appendStatic(" (");
+		{
+			for (sl_size i = 0; i < columns.count; i++) {
+				if (i) {
+					appendStatic(", ");
+				}
+				appendIdentifier(columns[i]);
+			}
+		}
+		appendStatic(") VALUES ");
+		for (sl_size k = 0; k < nRows; k++) {
+			if (k) {
+				appendStatic(", (");
+			} else {
+				appendStatic("(");
+			}
+			for (sl_size i = 0; i < columns.count; i++) {
+				if (i) {
+					appendStatic(", ");
+				}
+				appendParameter();
+			}
+			appendStatic(")");
+		}
+	}
+
 	void SqlBuilder::generateUpdate(const DatabaseIdentifier& table, const ListParam<DatabaseColumn>& _columns, const DatabaseExpression& where)
 	{
 		ListLocker<DatabaseColumn> columns(_columns);
@@ -1062,6 +1062,7 @@ namespace slib
 
 			~DatabaseImpl()
 			{
+				_freeStatementCache();
 				mysql_close(m_mysql);
 			}
 
@@ -25,12 +25,15 @@
 #include "slib/db/leveldb.h"
 #include "slib/data/json.h"
 #include "slib/data/serialize.h"
+#include "slib/core/timer.h"
+#include "slib/core/mutex.h"
 
 #define KEY_LENGTH_MAX 1024
 #define KEY_BUFFER_SIZE (KEY_LENGTH_MAX + 16)
 #define VALUE_BUFFER_SIZE 1024
 #define DICTIONARY_BUFFER_SIZE 128
 #define DICTIONARY_REMOVE_BATCH_SIZE 1024
+#define WRITE_BEHIND_BATCH_SIZE_DEFAULT 1024
 #define KEY_NAME_LAST_DICTIONARY_ID "last_dictionary_id"
 
 namespace slib
@@ -68,6 +71,46 @@ namespace slib
 			return 0;
 		}
 
+		// Cached values must not be modified through the references held by the callers
+		static Variant DuplicateValue(const Variant& value)
+		{
+			sl_uint8 type = value.getType();
+			if (type == VariantType::List) {
+				ListElements<Variant> src(value.getVariantList());
+				VariantList list = VariantList::create(src.count);
+				if (list.isNotNull()) {
+					Variant* dst = list.getData();
+					for (sl_size i = 0; i < src.count; i++) {
+						dst[i] = DuplicateValue(src[i]);
+					}
+				}
+				return list;
+			} else if (type == VariantType::Map) {
+				VariantMap src = value.getVariantMap();
+				VariantMap map;
+				auto node = src.getFirstNode();
+				while (node) {
+					map.add_NoLock(node->key, DuplicateValue(node->value));
+					node = node->next;
+				}
+				return map;
+			} else if (type == VariantType::Memory) {
+				return value.getMemory().duplicate();
+			}
+			return value;
+		}
+
+		class PendingItem
+		{
+		public:
+			Variant value;
+			sl_bool flagRemove;
+
+		public:
+			PendingItem(const Variant& _value, sl_bool _flagRemove): value(_value), flagRemove(_flagRemove) {}
+
+		};
+
 		class DictionaryImpl;
 
 		class ObjectStoreManagerImpl : public ObjectStoreManager
@@ -75,6 +118,39 @@ namespace slib
 		public:
 			Ref<KeyValueStore> m_store;
 
+			// `m_cache` holds the recent generation, `m_cacheOld` the previous one
+			sl_uint32 m_sizeCache;
+			CHashMap<String, Variant> m_cache;
+			CHashMap<String, Variant> m_cacheOld;
+			// incremented on every cache update, so that a reader does not cache a value which was overwritten during its store lookup
+			sl_uint64 m_seqUpdate;
+
+			sl_bool m_flagWriteBehind;
+			sl_uint32 m_sizeWriteBehindBatch;
+			CHashMap<String, PendingItem> m_pending;
+			CHashMap<String, PendingItem> m_flushing;
+			Ref<Timer> m_timerFlush;
+
+			Mutex m_lockCache;
+			Mutex m_lockWrite;
+
+		public:
+			ObjectStoreManagerImpl()
+			{
+				m_sizeCache = 0;
+				m_seqUpdate = 0;
+				m_flagWriteBehind = sl_false;
+				m_sizeWriteBehindBatch = 0;
+			}
+
+			~ObjectStoreManagerImpl()
+			{
+				if (m_timerFlush.isNotNull()) {
+					m_timerFlush->stopAndWait();
+				}
+				flush();
+			}
+
 		public:
 			static Ref<ObjectStoreManagerImpl> open(const ObjectStoreParam& param)
 			{
@@ -90,6 +166,14 @@ namespace slib
 				Ref<ObjectStoreManagerImpl> ret = new ObjectStoreManagerImpl;
 				if (ret.isNotNull()) {
 					ret->m_store = Move(store);
+					ret->m_sizeCache = param.cacheSize;
+					if (param.writeBehindDelay || param.writeBehindBatchSize) {
+						ret->m_flagWriteBehind = sl_true;
+						ret->m_sizeWriteBehindBatch = param.writeBehindBatchSize ? param.writeBehindBatchSize : WRITE_BEHIND_BATCH_SIZE_DEFAULT;
+						if (param.writeBehindDelay) {
+							ret->m_timerFlush = Timer::start(SLIB_FUNCTION_WEAKREF(ret, onFlushTimer), param.writeBehindDelay);
+						}
+					}
 					return ret;
 				}
 				return sl_null;
@@ -103,6 +187,63 @@ namespace slib
 
 			Ref<ObjectStoreDictionary> getRootDictionary() override;
 
+			sl_bool flush() override
+			{
+				if (!m_flagWriteBehind) {
+					return sl_true;
+				}
+				MutexLocker lockWrite(&m_lockWrite);
+				{
+					MutexLocker lock(&m_lockCache);
+					if (m_pending.isEmpty()) {
+						return sl_true;
+					}
+					m_flushing = Move(m_pending);
+				}
+				// `m_flushing` is only modified by the flushing thread, so it can be read without locking here
+				sl_bool flagSuccess = sl_false;
+				Ref<KeyValueWriteBatch> batch = m_store->createWriteBatch();
+				if (batch.isNotNull()) {
+					flagSuccess = sl_true;
+					auto node = m_flushing.getFirstNode();
+					while (node) {
+						String& key = node->key;
+						if (node->value.flagRemove) {
+							flagSuccess = batch->remove(key.getData(), key.getLength());
+						} else {
+							flagSuccess = batch->put(StringView(key), node->value.value);
+						}
+						if (!flagSuccess) {
+							break;
+						}
+						node = node->next;
+					}
+					if (flagSuccess) {
+						flagSuccess = batch->commit();
+					} else {
+						batch->discard();
+					}
+				}
+				MutexLocker lock(&m_lockCache);
+				if (!flagSuccess) {
+					// keep failed items pending unless they were overwritten meanwhile
+					auto node = m_flushing.getFirstNode();
+					while (node) {
+						if (!(m_pending.find_NoLock(node->key))) {
+							m_pending.add_NoLock(node->key, Move(node->value));
+						}
+						node = node->next;
+					}
+				}
+				m_flushing.removeAll_NoLock();
+				return flagSuccess;
+			}
+
+			void onFlushTimer(Timer*)
+			{
+				flush();
+			}
+
 		public:
 			Ref<ObjectStoreDictionary> createDictionary(sl_uint64 parentId, const StringView& key);
 
@@ -117,13 +258,20 @@ namespace slib
 				}
 				sl_uint64 childId = getDictionaryId(key, nKey);
 				if (childId) {
+					if (!(flush())) {
+						return sl_false;
+					}
+					sl_bool flagSuccess = sl_false;
 					if (removeChildDictionaries(childId)) {
 						if (removeChildItems(childId)) {
 							if (m_store->remove(StringView((char*)key, nKey))) {
-								return sl_true;
+								flagSuccess = sl_true;
 							}
 						}
 					}
+					// descendant dictionaries and items are not tracked individually
+					clearCache();
+					return flagSuccess;
 				}
 				return sl_false;
 			}
@@ -134,11 +282,30 @@ namespace slib
 			{
 				sl_uint8 key[KEY_BUFFER_SIZE];
 				sl_uint32 nKey = PrepareKey(key, parentId, sl_false, _key);
-				if (nKey) {
-					return m_store->get(StringView((char*)key, nKey));
-				} else {
+				if (!nKey) {
 					return Variant();
 				}
+				if (!m_sizeCache && !m_flagWriteBehind) {
+					return m_store->get(StringView((char*)key, nKey));
+				}
+				String strKey((char*)key, nKey);
+				Variant ret;
+				sl_uint64 seq;
+				{
+					MutexLocker lock(&m_lockCache);
+					if (getCachedItem(strKey, ret)) {
+						return DuplicateValue(ret);
+					}
+					seq = m_seqUpdate;
+				}
+				ret = m_store->get(StringView(strKey));
+				if (m_sizeCache) {
+					MutexLocker lock(&m_lockCache);
+					if (seq == m_seqUpdate) {
+						putCache(strKey, DuplicateValue(ret));
+					}
+				}
+				return ret;
 			}
 
 			sl_bool putItem(sl_uint64 parentId, const StringView& _key, const Variant& value)
@@ -146,7 +313,7 @@ namespace slib
 				sl_uint8 key[KEY_BUFFER_SIZE];
 				sl_uint32 nKey = PrepareKey(key, parentId, sl_false, _key);
 				if (nKey) {
-					return m_store->put(StringView((char*)key, nKey), value);
+					return writeItem(key, nKey, value, sl_false);
 				} else {
 					return sl_false;
 				}
@@ -157,15 +324,158 @@ namespace slib
 				sl_uint8 key[KEY_BUFFER_SIZE];
 				sl_uint32 nKey = PrepareKey(key, parentId, sl_false, _key);
 				if (nKey) {
-					return m_store->remove(StringView((char*)key, nKey));
+					return writeItem(key, nKey, Variant(), sl_true);
 				} else {
 					return sl_false;
 				}
 			}
 
+			sl_bool writeItem(sl_uint8* key, sl_uint32 nKey, const Variant& value, sl_bool flagRemove)
+			{
+				if (!m_sizeCache && !m_flagWriteBehind) {
+					if (flagRemove) {
+						return m_store->remove(StringView((char*)key, nKey));
+					} else {
+						return m_store->put(StringView((char*)key, nKey), value);
+					}
+				}
+				String strKey((char*)key, nKey);
+				if (strKey.isNull()) {
+					return sl_false;
+				}
+				Variant valueCache = DuplicateValue(value);
+				if (m_flagWriteBehind) {
+					sl_size nPending;
+					{
+						MutexLocker lock(&m_lockCache);
+						if (flagRemove) {
+							// report missing items like the write-through mode
+							Variant current;
+							if (getCachedItem(strKey, current)) {
+								if (current.isUndefined()) {
+									return sl_false;
+								}
+							} else {
+								if (m_store->get(StringView(strKey)).isUndefined()) {
+									return sl_false;
+								}
+							}
+						}
+						if (!(m_pending.put_NoLock(strKey, PendingItem(valueCache, flagRemove)))) {
+							return sl_false;
+						}
+						m_seqUpdate++;
+						putCache(strKey, valueCache);
+						nPending = m_pending.getCount();
+					}
+					if (nPending >= m_sizeWriteBehindBatch) {
+						return flush();
+					}
+					return sl_true;
+				}
+				// serialize write-through updates, so that the cache follows the order of the store
+				MutexLocker lockWrite(&m_lockWrite);
+				sl_bool flagSuccess;
+				if (flagRemove) {
+					flagSuccess = m_store->remove(StringView(strKey));
+				} else {
+					flagSuccess = m_store->put(StringView(strKey), value);
+				}
+				MutexLocker lock(&m_lockCache);
+				m_seqUpdate++;
+				if (flagSuccess) {
+					putCache(strKey, valueCache);
+				} else {
+					m_cache.remove_NoLock(strKey);
+					m_cacheOld.remove_NoLock(strKey);
+				}
+				return flagSuccess;
+			}
+
+			sl_bool getCachedItem(const String& key, Variant& _out)
+			{
+				PendingItem* item = m_pending.getItemPointer(key);
+				if (!item) {
+					item = m_flushing.getItemPointer(key);
+				}
+				if (item) {
+					_out = item->value;
+					return sl_true;
+				}
+				if (m_sizeCache) {
+					return getCache(key, _out);
+				}
+				return sl_false;
+			}
+
+			sl_bool getCache(const String& key, Variant& _out)
+			{
+				Variant* p = m_cache.getItemPointer(key);
+				if (p) {
+					_out = *p;
+					return sl_true;
+				}
+				auto node = m_cacheOld.find_NoLock(key);
+				if (node) {
+					_out = node->value;
+					// promote to the recent generation
+					putCache(key, Move(node->value));
+					m_cacheOld.removeAt(node);
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			void putCache(const String& key, const Variant& value)
+			{
+				if (!m_sizeCache) {
+					return;
+				}
+				m_cacheOld.remove_NoLock(key);
+				sl_bool flagInsert = sl_false;
+				m_cache.put_NoLock(key, value, &flagInsert);
+				if (flagInsert) {
+					sl_size nHalf = m_sizeCache >> 1;
+					if (m_cache.getCount() > nHalf) {
+						m_cacheOld = Move(m_cache);
+					}
+				}
+			}
+
+			void clearCache()
+			{
+				MutexLocker lock(&m_lockCache);
+				m_seqUpdate++;
+				m_cache.removeAll_NoLock();
+				m_cacheOld.removeAll_NoLock();
+			}
+
 			PropertyIterator getItemIterator(sl_uint64 parentId);
 
 			sl_uint64 getDictionaryId(sl_uint8* key, sl_uint32 nKey)
+			{
+				if (!m_sizeCache) {
+					return getStoredDictionaryId(key, nKey);
+				}
+				String strKey((char*)key, nKey);
+				sl_uint64 seq;
+				{
+					MutexLocker lock(&m_lockCache);
+					Variant id;
+					if (getCache(strKey, id)) {
+						return id.getUint64();
+					}
+					seq = m_seqUpdate;
+				}
+				sl_uint64 id = getStoredDictionaryId(key, nKey);
+				MutexLocker lock(&m_lockCache);
+				if (seq == m_seqUpdate) {
+					putCache(strKey, id);
+				}
+				return id;
+			}
+
+			sl_uint64 getStoredDictionaryId(sl_uint8* key, sl_uint32 nKey)
 			{
 				char buf[DICTIONARY_BUFFER_SIZE];
 				sl_reg n = m_store->get(key, nKey, buf, sizeof(buf));
@@ -394,6 +704,11 @@ namespace slib
 						sl_uint32 size = CVLI::encode(buf, newId);
 						if (batch->put(key, nKey, buf, size)) {
 							if (batch->commit()) {
+								if (m_sizeCache) {
+									MutexLocker lockCache(&m_lockCache);
+									m_seqUpdate++;
+									putCache(String((char*)key, nKey), newId);
+								}
 								return new DictionaryImpl(this, newId);
 							}
 						}
@@ -519,6 +834,8 @@ namespace slib
 
 		Iterator<String, ObjectStore> ObjectStoreManagerImpl::getDictionaryIterator(sl_uint64 parentId)
 		{
+			// iterators read the store directly, so they see every write made before their creation
+			flush();
 			Ref<KeyValueIterator> iterator = m_store->getIterator();
 			if (iterator.isNotNull()) {
 				return new DictionaryIterator(this, parentId, Move(iterator));
@@ -547,6 +864,7 @@ namespace slib
 
 		PropertyIterator ObjectStoreManagerImpl::getItemIterator(sl_uint64 parentId)
 		{
+			flush();
 			Ref<KeyValueIterator> iterator = m_store->getIterator();
 			if (iterator.isNotNull()) {
 				return new ItemIterator(this, parentId, Move(iterator));
@@ -583,6 +901,9 @@ namespace slib
 
 	ObjectStoreParam::ObjectStoreParam()
 	{
+		cacheSize = 0;
+		writeBehindDelay = 0;
+		writeBehindBatchSize = 0;
 	}
 
 
@@ -702,6 +1023,15 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool ObjectStore::flush() const
+	{
+		Ref<ObjectStoreManager> manager = getManager();
+		if (manager.isNotNull()) {
+			return manager->flush();
+		}
+		return sl_false;
+	}
+
 	sl_bool ObjectStore::isUndefined() const noexcept
 	{
 		return value.isUndefined();
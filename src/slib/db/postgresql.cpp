@@ -283,6 +283,7 @@ namespace slib
 
 				ObjectLocker lock(m_db.get());
 				PGresult* res = PQexecPrepared(m_connection, m_name.getData(), (int)nParams, values, lengths, formats, 0);
+				sl_int64 ret = -1;
 				if (res) {
 					if (PQresultStatus(res) == PGRES_COMMAND_OK) {
 						char* s = PQcmdTuples(res);
@@ -290,11 +291,11 @@ namespace slib
 						if (s) {
 							String::parseUint64(10, &n, s);
 						}
-						return n;
+						ret = n;
 					}
 					PQclear(res);
 				}
-				return -1;
+				return ret;
 			}
 
 			Ref<DatabaseCursor> queryBy(const Variant* params, sl_size _nParams) override
@@ -332,6 +333,7 @@ namespace slib
 
 			~DatabaseImpl()
 			{
+				_freeStatementCache();
 				if (m_connection) {
 					PQfinish(m_connection);
 				}
@@ -392,6 +394,9 @@ namespace slib
 
 			sl_int64 _executeBy(const StringParam& _sql, const Variant* params, sl_size _nParams) override
 			{
+				if (m_sizeStatementCache) {
+					return Database::_executeBy(_sql, params, _nParams);
+				}
 				StringCstr sql(_sql);
 				sl_uint32 nParams = (sl_uint32)_nParams;
 				SLIB_SCOPED_BUFFER(String, 32, strings, nParams)
@@ -422,6 +427,9 @@ namespace slib
 
 			Ref<DatabaseCursor> _queryBy(const StringParam& _sql, const Variant* params, sl_size _nParams) override
 			{
+				if (m_sizeStatementCache) {
+					return Database::_queryBy(_sql, params, _nParams);
+				}
 				StringCstr sql(_sql);
 				sl_uint32 nParams = (sl_uint32)_nParams;
 				SLIB_SCOPED_BUFFER(String, 32, strings, nParams)
@@ -538,7 +546,8 @@ namespace slib
 
 		StatementImpl::~StatementImpl()
 		{
-			if (m_name.isNotEmpty()) {
+			// `m_db` is null when the statement is freed from the cache of the closing database
+			if (m_name.isNotEmpty() && m_db.isNotNull()) {
 				((DatabaseImpl*)(m_db.get()))->m_queueRemovingStatements.push(m_name);
 			}
 		}
@@ -50,12 +50,15 @@ namespace slib
 			String* m_columnNames;
 			CHashMap<String, sl_int32> m_mapColumnIndexes;
 
+			sl_bool m_flagFinished;
+
 		public:
 			CursorImpl(Database* db, DatabaseStatement* statementObj, sqlite3_stmt* statement)
 			{
 				m_db = db;
 				m_statementObj = statementObj;
 				m_statement = statement;
+				m_flagFinished = sl_false;
 
 				sl_int32 cols = sqlite3_column_count(statement);
 				for (sl_int32 i = 0; i < cols; i++) {
@@ -294,6 +297,74 @@ namespace slib
 				return sl_false;
 			}
 
+			sl_uint32 fetchBatch(DatabaseRowBatch& batch, sl_uint32 maxRows) override
+			{
+				if (!(batch.prepare(this, maxRows))) {
+					return 0;
+				}
+				if (m_flagFinished) {
+					// `sqlite3_step()` restarts the statement after the end
+					return 0;
+				}
+				DatabaseColumnBatch* columns = batch.columns.getData();
+				sl_uint32 nColumns = (sl_uint32)(batch.columns.getCount());
+				sl_uint32 nRows = 0;
+				while (nRows < maxRows) {
+					if (sqlite3_step(m_statement) != SQLITE_ROW) {
+						m_flagFinished = sl_true;
+						break;
+					}
+					for (sl_uint32 i = 0; i < nColumns; i++) {
+						DatabaseColumnBatch& column = columns[i];
+						int type = sqlite3_column_type(m_statement, i);
+						if (type == SQLITE_NULL) {
+							column.addNull();
+							continue;
+						}
+						if (column.type == DatabaseColumnBatchType::Auto) {
+							switch (type) {
+								case SQLITE_INTEGER:
+									column.type = DatabaseColumnBatchType::Int64;
+									break;
+								case SQLITE_FLOAT:
+									column.type = DatabaseColumnBatchType::Double;
+									break;
+								case SQLITE_BLOB:
+									column.type = DatabaseColumnBatchType::Blob;
+									break;
+								default:
+									column.type = DatabaseColumnBatchType::String;
+									break;
+							}
+						}
+						// sqlite converts the values to the requested type
+						switch (column.type) {
+							case DatabaseColumnBatchType::Int64:
+								column.addInt64(sqlite3_column_int64(m_statement, i));
+								break;
+							case DatabaseColumnBatchType::Double:
+								column.addDouble(sqlite3_column_double(m_statement, i));
+								break;
+							case DatabaseColumnBatchType::Blob:
+								{
+									const void* data = sqlite3_column_blob(m_statement, i);
+									column.addBytes(data, sqlite3_column_bytes(m_statement, i));
+								}
+								break;
+							default:
+								{
+									const void* data = sqlite3_column_text(m_statement, i);
+									column.addBytes(data, sqlite3_column_bytes(m_statement, i));
+								}
+								break;
+						}
+					}
+					nRows++;
+				}
+				batch.rowCount = nRows;
+				return nRows;
+			}
+
 		};
 
 		class StatementImpl : public DatabaseStatement
@@ -455,6 +526,7 @@ namespace slib
 
 			~DatabaseImpl()
 			{
+				_freeStatementCache();
 				if (m_db) {
 					sqlite3_close(m_db);
 				}
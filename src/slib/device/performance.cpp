@@ -81,6 +81,41 @@ namespace slib
 #else
 		unsigned int eax, ebx, ecx, edx;
 		return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx & (1 << 20)) != 0);
+#endif
+	}
+
+	sl_bool Cpu::isSupportedAVX2() noexcept
+	{
+		// AVX2 needs the OS to save YMM registers (OSXSAVE, and XCR0 bits 1, 2)
+#if defined(SLIB_COMPILER_IS_VC)
+		int cpu_info[4];
+		__cpuid(cpu_info, 1);
+		if ((cpu_info[2] & (3 << 27)) != (3 << 27)) {
+			return sl_false;
+		}
+		if ((_xgetbv(0) & 6) != 6) {
+			return sl_false;
+		}
+		__cpuidex(cpu_info, 7, 0);
+		return (cpu_info[1] & (1 << 5)) != 0;
+#else
+		unsigned int eax, ebx, ecx, edx;
+		if (!(__get_cpuid(1, &eax, &ebx, &ecx, &edx))) {
+			return sl_false;
+		}
+		if ((ecx & (3 << 27)) != (3 << 27)) {
+			return sl_false;
+		}
+		unsigned int xcr0, xcr0_high;
+		__asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+		if ((xcr0 & 6) != 6) {
+			return sl_false;
+		}
+		if (__get_cpuid_max(0, sl_null) < 7) {
+			return sl_false;
+		}
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		return (ebx & (1 << 5)) != 0;
 #endif
 	}
 #endif
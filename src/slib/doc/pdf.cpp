@@ -23,6 +23,8 @@
 #include "slib/doc/pdf.h"
 
 #include "slib/core/thread.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
 #include "slib/core/mio.h"
 #include "slib/core/string_buffer.h"
 #include "slib/core/memory_buffer.h"
@@ -34,16 +36,19 @@
 #include "slib/io/sample_reader.h"
 #include "slib/data/zlib.h"
 #include "slib/data/lzw.h"
+#include "slib/data/concurrent_expiring_map.h"
 #include "slib/crypto/md5.h"
 #include "slib/crypto/rc4.h"
 #include "slib/graphics/freetype.h"
 #include "slib/graphics/font.h"
 #include "slib/graphics/canvas.h"
+#include "slib/graphics/bitmap.h"
 #include "slib/graphics/path.h"
 #include "slib/graphics/cmyk.h"
 #include "slib/graphics/cie.h"
 #include "slib/graphics/image.h"
 #include "slib/math/transform2d.h"
+#include "slib/device/cpu.h"
 
 #define MAX_PDF_FILE_SIZE 0x40000000
 #define MAX_WORD_LENGTH 256
@@ -51,6 +56,7 @@
 #define MAX_STRING_LENGTH 32767
 #define EXPIRE_DURATION_OBJECT 5000
 #define EXPIRE_DURATION_OBJECT_STREAM 10000
+#define MAX_IDLE_READER_COUNT 16
 #define EXPIRE_DURATION_FONT_GLYPH 15000
 #define MAX_IMAGE_WIDTH 1000
 #define MAX_IMAGE_HEIGHT 700
@@ -920,11 +926,16 @@ namespace slib
 			Context* m_baseContext;
 			sl_uint32 m_maxObjectNumber = 0;
 			Array<CrossReferenceEntry> m_references;
-			ExpiringMap<sl_uint64, PdfValue> m_objectsCache;
+			ConcurrentExpiringMap<sl_uint64, PdfValue> m_objectsCache;
 			CHashMap< sl_uint32, Pair<PdfValue, sl_uint32> > m_objectsUpdate;
 			ExpiringMap< sl_uint64, Ref<ObjectStream> > m_objectStreams;
 			Ref<PageTreeParent> m_pageTree;
 
+			// Idle readers having their own positions in the source, used to resolve the objects from concurrent threads after the document is opened
+			sl_bool m_flagUseReaderPool = sl_false;
+			List< Ref<Context> > m_readerPool;
+			Mutex m_lockReaderPool;
+
 		public:
 			Context(sl_bool flagRefContext)
 			{
@@ -942,6 +953,7 @@ namespace slib
 			virtual PdfValue readObject(sl_uint32 pos, sl_uint32& outOffsetAfterEndObj, PdfReference& outRef, sl_bool flagReadOnlyStream) = 0;
 			virtual Memory readContent(sl_uint32 offset, sl_uint32 size, const PdfReference& ref) = 0;
 			virtual sl_bool readDocument(const PdfDocumentParam& param) = 0;
+			virtual Ref<Context> createReader() = 0;
 
 		public:
 			void _init()
@@ -950,6 +962,59 @@ namespace slib
 				m_objectStreams.setExpiringMilliseconds(EXPIRE_DURATION_OBJECT_STREAM);
 			}
 
+			void setUseReaderPool(sl_bool flag)
+			{
+				m_flagUseReaderPool = flag;
+			}
+
+			Ref<Context> acquireReader()
+			{
+				{
+					MutexLocker lock(&m_lockReaderPool);
+					Ref<Context> ret;
+					if (m_readerPool.popBack_NoLock(&ret)) {
+						return ret;
+					}
+				}
+				return createReader();
+			}
+
+			void releaseReader(Ref<Context>&& reader)
+			{
+				MutexLocker lock(&m_lockReaderPool);
+				if (m_readerPool.getCount() < MAX_IDLE_READER_COUNT) {
+					m_readerPool.add_NoLock(Move(reader));
+				}
+			}
+
+			PdfValue readObjectAt(sl_uint32 pos, sl_uint32& outOffsetAfterEndObj, PdfReference& outRef, sl_bool flagReadOnlyStream)
+			{
+				if (m_flagUseReaderPool) {
+					Ref<Context> reader = acquireReader();
+					if (reader.isNotNull()) {
+						PdfValue ret = reader->readObject(pos, outOffsetAfterEndObj, outRef, flagReadOnlyStream);
+						releaseReader(Move(reader));
+						return ret;
+					}
+				}
+				ObjectLocker lock(this);
+				return readObject(pos, outOffsetAfterEndObj, outRef, flagReadOnlyStream);
+			}
+
+			Memory readContentAt(sl_uint32 offset, sl_uint32 size, const PdfReference& ref)
+			{
+				if (m_flagUseReaderPool) {
+					Ref<Context> reader = acquireReader();
+					if (reader.isNotNull()) {
+						Memory ret = reader->readContent(offset, size, ref);
+						releaseReader(Move(reader));
+						return ret;
+					}
+				}
+				ObjectLocker lock(this);
+				return readContent(offset, size, ref);
+			}
+
 			sl_uint32 getMaximumObjectNumber()
 			{
 				return m_maxObjectNumber;
@@ -982,7 +1047,7 @@ namespace slib
 						}
 						PdfReference n;
 						sl_uint32 offsetEnd;
-						PdfValue ret = readObject(entry.offset, offsetEnd, n, flagReadOnlyStream);
+						PdfValue ret = readObjectAt(entry.offset, offsetEnd, n, flagReadOnlyStream);
 						if (ret.isNotUndefined() && n.objectNumber == objectNumber) {
 							if (generation >= 0) {
 								if (n.generation != generation) {
@@ -1018,16 +1083,18 @@ namespace slib
 				if (!objectNumber) {
 					return PdfValue();
 				}
-				Pair<PdfValue, sl_uint32>* pItem = m_objectsUpdate.getItemPointer(objectNumber);
-				if (pItem) {
-					if (generation >= 0) {
-						if (generation != pItem->second) {
-							return sl_false;
+				if (m_objectsUpdate.isNotEmpty()) {
+					Pair<PdfValue, sl_uint32> item;
+					if (m_objectsUpdate.get(objectNumber, &item)) {
+						if (generation >= 0) {
+							if ((sl_uint32)generation != item.second) {
+								return sl_false;
+							}
+						} else {
+							generation = (sl_int32)(item.second);
 						}
-					} else {
-						generation = pItem->second;
+						return item.first;
 					}
-					return pItem->first;
 				}
 				if (generation >= 0) {
 					sl_uint64 _id = GetObjectId(objectNumber, generation);
@@ -1038,7 +1105,8 @@ namespace slib
 				}
 				PdfValue ret = readObject(objectNumber, generation, flagReadOnlyStream);
 				if (ret.isNotUndefined()) {
-					m_objectsCache.put(GetObjectId(objectNumber, generation), ret);
+					sl_uint64 _id = GetObjectId(objectNumber, generation);
+					m_objectsCache.put(_id, ret);
 					return ret;
 				}
 				return PdfValue();
@@ -1057,14 +1125,7 @@ namespace slib
 
 			sl_bool _setObject(const PdfReference& ref, const PdfValue& value)
 			{
-				Pair<PdfValue, sl_uint32>* pItem = m_objectsUpdate.getItemPointer(ref.objectNumber);
-				if (pItem) {
-					pItem->first = value;
-					pItem->second = ref.generation;
-					return sl_true;
-				} else {
-					return m_objectsUpdate.add_NoLock(ref.objectNumber, value, ref.generation);
-				}
+				return m_objectsUpdate.put(ref.objectNumber, Pair<PdfValue, sl_uint32>(value, ref.generation));
 			}
 
 			sl_bool setObject(const PdfReference& ref, const PdfValue& value)
@@ -1127,7 +1188,7 @@ namespace slib
 				m_objectsCache.remove(_id);
 				CrossReferenceEntry* entry = m_references.getPointerAt(ref.objectNumber);
 				if (entry) {
-					m_objectsUpdate.remove_NoLock(ref.objectNumber);
+					m_objectsUpdate.remove(ref.objectNumber);
 					if (entry->type == (sl_uint32)(CrossReferenceEntryType::Normal)) {
 						if (entry->generation == ref.generation) {
 							entry->type = (sl_uint32)(CrossReferenceEntryType::Free);
@@ -1143,7 +1204,7 @@ namespace slib
 					}
 					return sl_false;
 				} else {
-					return m_objectsUpdate.remove_NoLock(ref.objectNumber);
+					return m_objectsUpdate.remove(ref.objectNumber);
 				}
 			}
 
@@ -2106,8 +2167,22 @@ namespace slib
 		{
 		public:
 			BufferedSeekableReader reader;
+			String filePath;
 
 		public:
+			sl_bool openReader(const BufferedReaderBase& other)
+			{
+				if (other.filePath.isNull()) {
+					return sl_false;
+				}
+				Ref<FileIO> file = FileIO::openForRead(other.filePath);
+				if (file.isNull()) {
+					return sl_false;
+				}
+				filePath = other.filePath;
+				return reader.open(file);
+			}
+
 			sl_bool readChar(sl_char8& ch)
 			{
 				return reader.readInt8((sl_int8*)((void*)&ch));
@@ -2182,6 +2257,14 @@ namespace slib
 			Ref<CRef> refSource;
 
 		public:
+			sl_bool openReader(const MemoryReaderBase& other)
+			{
+				source = other.source;
+				sizeSource = other.sizeSource;
+				refSource = other.refSource;
+				return sl_true;
+			}
+
 			sl_bool readChar(sl_char8& ch)
 			{
 				if (pos < sizeSource) {
@@ -2327,6 +2410,20 @@ namespace slib
 			ContextT(Context* baseContext): Context(baseContext) {}
 
 		public:
+			Ref<Context> createReader() override
+			{
+				Ref< ContextT<READER_BASE> > ret = new ContextT<READER_BASE>(m_baseContext);
+				if (ret.isNotNull()) {
+					if (ret->openReader(*this)) {
+						ret->flagDecryptContents = flagDecryptContents;
+						Base::copyMemory(ret->encryptionKey, encryptionKey, sizeof(encryptionKey));
+						ret->lenEncryptionKey = lenEncryptionKey;
+						return ret;
+					}
+				}
+				return sl_null;
+			}
+
 			sl_bool peekCharAndEquals(sl_char8 _ch)
 			{
 				sl_char8 ch;
@@ -3921,7 +4018,6 @@ namespace slib
 			if (ret.getReference(ref)) {
 				Ref<Context> context = GetContextRef(m_context);
 				if (context.isNotNull()) {
-					ObjectLocker locker(context.get());
 					return context->getObject(ref);
 				}
 			} else {
@@ -3965,7 +4061,6 @@ namespace slib
 			if (ret.getReference(ref)) {
 				Ref<Context> context = GetContextRef(m_context);
 				if (context.isNotNull()) {
-					ObjectLocker locker(context.get());
 					return context->getObject(ref);
 				}
 			} else {
@@ -4029,8 +4124,7 @@ namespace slib
 		}
 		Ref<Context> context = GetContextRef(m_context);
 		if (context.isNotNull()) {
-			ObjectLocker locker(context.get());
-			return context->readContent(m_offsetContent, m_sizeContent, m_ref);
+			return context->readContentAt(m_offsetContent, m_sizeContent, m_ref);
 		}
 		return sl_null;
 	}
@@ -8744,11 +8838,13 @@ namespace slib
 			if (!(contextFile->reader.open(file))) {
 				return sl_null;
 			}
+			contextFile->filePath = param.filePath.toString();
 			context = Move(contextFile);
 		} else {
 			return sl_null;
 		}
 		if (context->readDocument(param)) {
+			context->setUseReaderPool(sl_true);
 			Ref<PdfDocument> ret = new PdfDocument;
 			if (ret.isNotNull()) {
 				ret->m_context = Move(context);
@@ -8789,14 +8885,12 @@ namespace slib
 	PdfValue PdfDocument::getObject(const PdfReference& ref)
 	{
 		Context* context = GetContext(m_context);
-		ObjectLocker lock(context);
 		return context->getObject(ref);
 	}
 
 	PdfValue PdfDocument::getObject(sl_uint32 objectNumber, sl_uint32& outGeneration)
 	{
 		Context* context = GetContext(m_context);
-		ObjectLocker lock(context);
 		sl_int32& gen = *((sl_int32*)&outGeneration);
 		gen = -1;
 		return context->getObject(objectNumber, gen);
@@ -8805,7 +8899,6 @@ namespace slib
 	Ref<PdfStream> PdfDocument::getStream(sl_uint32 objectNumber, sl_uint32& outGeneration)
 	{
 		Context* context = GetContext(m_context);
-		ObjectLocker lock(context);
 		sl_int32& gen = *((sl_int32*)&outGeneration);
 		gen = -1;
 		return context->getStream(objectNumber, gen);
@@ -8889,17 +8982,104 @@ namespace slib
 	Ref<PdfFont> PdfDocument::getFont(const PdfReference& ref, PdfResourceCache& cache)
 	{
 		Context* context = GetContext(m_context);
-		ObjectLocker lock(context);
 		return context->getFont(ref, cache);
 	}
 
 	Ref<PdfExternalObject> PdfDocument::getExternalObject(const PdfReference& ref, PdfResourceCache& cache)
 	{
 		Context* context = GetContext(m_context);
-		ObjectLocker lock(context);
 		return context->getExternalObject(ref, cache);
 	}
 
+	sl_bool PdfDocument::renderPages(sl_uint32 startIndex, sl_uint32 count, sl_uint32 width, sl_uint32 height, sl_uint32 threadCount, const Function<void(sl_uint32 pageIndex, Bitmap* bitmap)>& callback, const Ref<PdfResourceCache>& _cache)
+	{
+		if (!width || !height) {
+			return sl_false;
+		}
+		sl_uint32 nPages = getPageCount();
+		if (startIndex >= nPages) {
+			return sl_false;
+		}
+		if (count > nPages - startIndex) {
+			count = nPages - startIndex;
+		}
+		if (!count) {
+			return sl_false;
+		}
+		Ref<PdfResourceCache> cache = _cache;
+		if (cache.isNull()) {
+			cache = new PdfResourceCache;
+			if (cache.isNull()) {
+				return sl_false;
+			}
+		}
+		if (!threadCount) {
+			threadCount = Cpu::getCoreCount();
+		}
+		if (threadCount > count) {
+			threadCount = count;
+		}
+		Ref<ThreadPool> pool = ThreadPool::create(threadCount, threadCount);
+		if (pool.isNull()) {
+			return sl_false;
+		}
+		Ref<Event> eventDone = Event::create();
+		if (eventDone.isNull()) {
+			return sl_false;
+		}
+		volatile sl_int32 nRemaining = (sl_int32)count;
+		volatile sl_int32 nFailed = 0;
+		auto renderPage = [&](sl_uint32 index) {
+			sl_bool flagSuccess = sl_false;
+			Ref<PdfPage> page = getPage(index);
+			if (page.isNotNull()) {
+				Rectangle box = page->getMediaBox();
+				sl_real w = box.getWidth();
+				sl_real h = box.getHeight();
+				if (w > SLIB_EPSILON && h > SLIB_EPSILON) {
+					sl_real scale = Math::min((sl_real)width / w, (sl_real)height / h);
+					sl_uint32 bw = Math::max((sl_uint32)(w * scale + 0.5f), (sl_uint32)1);
+					sl_uint32 bh = Math::max((sl_uint32)(h * scale + 0.5f), (sl_uint32)1);
+					Ref<Bitmap> bitmap = Bitmap::create(bw, bh);
+					if (bitmap.isNotNull()) {
+						bitmap->resetPixels(Color::White);
+						Ref<Canvas> canvas = bitmap->getCanvas();
+						if (canvas.isNotNull()) {
+							PdfPage::RenderParam param;
+							param.canvas = canvas.get();
+							param.cache = cache;
+							param.bounds.left = 0;
+							param.bounds.top = 0;
+							param.bounds.right = (sl_real)bw;
+							param.bounds.bottom = (sl_real)bh;
+							page->render(param);
+							canvas.setNull();
+							callback(index, bitmap.get());
+							flagSuccess = sl_true;
+						}
+					}
+				}
+			}
+			if (!flagSuccess) {
+				Base::interlockedIncrement32(&nFailed);
+			}
+			if (!(Base::interlockedDecrement32(&nRemaining))) {
+				eventDone->set();
+			}
+		};
+		for (sl_uint32 i = 0; i < count; i++) {
+			sl_uint32 index = startIndex + i;
+			if (!(pool->addTask([&renderPage, index]() {
+				renderPage(index);
+			}))) {
+				renderPage(index);
+			}
+		}
+		eventDone->wait();
+		pool->release();
+		return !nFailed;
+	}
+
 	sl_bool PdfDocument::isEncrypted()
 	{
 		Context* context = GetContext(m_context);
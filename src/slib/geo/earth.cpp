@@ -126,6 +126,36 @@ namespace slib
 		return g_globe.getGeoLocation(position.x, position.y, position.z);
 	}
 
+	void Earth::getCartesianPositions(const double* latitudes, const double* longitudes, const double* altitudes, double* outX, double* outY, double* outZ, sl_size count, ThreadPool* threadPool)
+	{
+		g_globe.getCartesianPositions(latitudes, longitudes, altitudes, outX, outY, outZ, count, threadPool);
+	}
+
+	void Earth::getGeoLocations(const double* x, const double* y, const double* z, double* outLatitudes, double* outLongitudes, double* outAltitudes, sl_size count, ThreadPool* threadPool)
+	{
+		g_globe.getGeoLocations(x, y, z, outLatitudes, outLongitudes, outAltitudes, count, threadPool);
+	}
+
+	double Earth::getDistance(const LatLon& from, const LatLon& to)
+	{
+		return SphericalGlobe(SLIB_GEO_EARTH_AVERAGE_RADIUS).getDistance(from, to);
+	}
+
+	double Earth::getBearing(const LatLon& from, const LatLon& to)
+	{
+		return SphericalGlobe::getBearing(from, to);
+	}
+
+	void Earth::getDistances(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outDistances, sl_size count, ThreadPool* threadPool)
+	{
+		SphericalGlobe(SLIB_GEO_EARTH_AVERAGE_RADIUS).getDistances(latitudes1, longitudes1, latitudes2, longitudes2, outDistances, count, threadPool);
+	}
+
+	void Earth::getBearings(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outBearings, sl_size count, ThreadPool* threadPool)
+	{
+		SphericalGlobe::getBearings(latitudes1, longitudes1, latitudes2, longitudes2, outBearings, count, threadPool);
+	}
+
 
 	namespace
 	{
@@ -0,0 +1,204 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "geo_batch.h"
+
+#include "slib/core/base.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/device/cpu.h"
+#include "slib/math/math.h"
+
+#define MINIMUM_RANGE_SIZE 16384
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			namespace {
+
+				class VectorGeneric
+				{
+				public:
+					typedef double T;
+					static constexpr sl_uint32 Lanes = 1;
+
+				public:
+					SLIB_INLINE static T load(const double* p) { return *p; }
+					SLIB_INLINE static void store(double* p, T v) { *p = v; }
+					SLIB_INLINE static T set(double v) { return v; }
+					SLIB_INLINE static T add(T a, T b) { return a + b; }
+					SLIB_INLINE static T sub(T a, T b) { return a - b; }
+					SLIB_INLINE static T mul(T a, T b) { return a * b; }
+					SLIB_INLINE static T div(T a, T b) { return a / b; }
+					SLIB_INLINE static T sqrt(T a) { return Math::sqrt(a); }
+
+					SLIB_INLINE static sl_uint64 toBits(T v)
+					{
+						sl_uint64 n;
+						Base::copyMemory(&n, &v, 8);
+						return n;
+					}
+
+					SLIB_INLINE static T fromBits(sl_uint64 n)
+					{
+						T v;
+						Base::copyMemory(&v, &n, 8);
+						return v;
+					}
+
+					SLIB_INLINE static T bitAnd(T a, T b) { return fromBits(toBits(a) & toBits(b)); }
+					SLIB_INLINE static T bitOr(T a, T b) { return fromBits(toBits(a) | toBits(b)); }
+					SLIB_INLINE static T bitAndNot(T a, T b) { return fromBits(~(toBits(a)) & toBits(b)); }
+					SLIB_INLINE static T bitXor(T a, T b) { return fromBits(toBits(a) ^ toBits(b)); }
+					SLIB_INLINE static T lessThan(T a, T b) { return fromBits(a < b ? SLIB_UINT64_MAX : 0); }
+					SLIB_INLINE static T lessEqual(T a, T b) { return fromBits(a <= b ? SLIB_UINT64_MAX : 0); }
+					SLIB_INLINE static T equal(T a, T b) { return fromBits(a == b ? SLIB_UINT64_MAX : 0); }
+					SLIB_INLINE static T truncate(T a) { return (double)((sl_int32)a); }
+					SLIB_INLINE static T getExponent(T a) { return (double)((sl_int32)((toBits(a) >> 52) & 0x7ff) - 1022); }
+					SLIB_INLINE static T getMantissa(T a) { return fromBits((toBits(a) & SLIB_UINT64(0x000FFFFFFFFFFFFF)) | SLIB_UINT64(0x3FE0000000000000)); }
+					SLIB_INLINE static T pow2(T n) { return fromBits((sl_uint64)((sl_int32)n + 1023) << 52); }
+				};
+
+			}
+
+		}
+	}
+
+}
+
+#include "geo_batch_kernels.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			EllipsoidParam::EllipsoidParam(double _radiusEquatorial, double _eccentricitySquared): radiusEquatorial(_radiusEquatorial), eccentricitySquared(_eccentricitySquared)
+			{
+				radiusPolar = radiusEquatorial * Math::sqrt(1 - eccentricitySquared);
+				secondEccentricitySquared = eccentricitySquared / (1 - eccentricitySquared);
+			}
+
+			// same constants as `UTM::getCoordinate` and `UTM::getLatLon`
+			UTMParam::UTMParam(double _referenceLongitude, double scaleFactor): referenceLongitude(_referenceLongitude)
+			{
+				double a = 6378137.0;
+				double f = 1 / 298.257223563;
+				double n = f / (2.0 - f);
+				double n2 = n * n;
+				double n3 = n2 * n;
+				double n4 = n3 * n;
+				A0 = scaleFactor * a / (1.0 + n) * (1.0 + n2 / 4.0 + n4 / 64.0);
+				t1 = 2.0 * Math::sqrt(n) / (1 + n);
+				a1 = n / 2.0 - n2 * 2.0 / 3.0 + n3 * 5.0 / 16.0;
+				a2 = n2 * 13.0 / 48.0 - n3 * 3.0 / 5.0;
+				a3 = n3 * 61.0 / 240.0;
+				b1 = n / 2.0 - n2 * 2.0 / 3.0 + n3 * 37.0 / 96.0;
+				b2 = n2 / 48.0 + n3 / 15.0;
+				b3 = n3 * 17.0 / 480.0;
+				g1 = 2.0 * n - n2 * 2.0 / 3.0 - 2.0 * n3;
+				g2 = n2 * 7.0 / 3.0 - n3 * 8.0 / 5.0;
+				g3 = n3 * 56.0 / 15.0;
+			}
+
+			namespace {
+
+				static const Kernels* SelectKernels()
+				{
+#if defined(SLIB_GEO_BATCH_SUPPORT_AVX2)
+					if (Cpu::isSupportedAVX2()) {
+						return &(GetKernels_AVX2());
+					}
+#endif
+#if defined(SLIB_GEO_BATCH_SUPPORT_SSE2)
+					return &(GetKernels_SSE2());
+#else
+					return &(GetKernels_Generic());
+#endif
+				}
+
+			}
+
+			const Kernels& GetKernels()
+			{
+				static const Kernels* kernels = SelectKernels();
+				return *kernels;
+			}
+
+			const Kernels& GetKernels_Generic()
+			{
+				return KernelsOf<VectorGeneric>::get();
+			}
+
+			void Run(sl_size count, ThreadPool* threadPool, const Function<void(sl_size offset, sl_size count)>& task)
+			{
+				if (!count) {
+					return;
+				}
+				if (!threadPool) {
+					task(0, count);
+					return;
+				}
+				sl_size nRanges = Cpu::getCoreCount();
+				sl_size sizeRange = (count + nRanges - 1) / nRanges;
+				if (sizeRange < MINIMUM_RANGE_SIZE) {
+					sizeRange = MINIMUM_RANGE_SIZE;
+				}
+				if (sizeRange >= count) {
+					task(0, count);
+					return;
+				}
+				Ref<Event> event = Event::create(sl_false);
+				if (event.isNull()) {
+					task(0, count);
+					return;
+				}
+				sl_int32 nRemaining = (sl_int32)((count + sizeRange - 1) / sizeRange) - 1;
+				volatile sl_int32* pRemaining = &nRemaining;
+				for (sl_size offset = sizeRange; offset < count; offset += sizeRange) {
+					sl_size n = SLIB_MIN(sizeRange, count - offset);
+					auto range = [task, offset, n, pRemaining, event]() {
+						task(offset, n);
+						if (!(Base::interlockedDecrement32(pRemaining))) {
+							event->set();
+						}
+					};
+					if (!(threadPool->addTask(range))) {
+						range();
+					}
+				}
+				task(0, sizeRange);
+				event->wait();
+			}
+
+		}
+	}
+
+}
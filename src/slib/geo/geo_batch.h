@@ -0,0 +1,112 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_GEO_BATCH
+#define CHECKHEADER_SLIB_GEO_BATCH
+
+#include "slib/geo/definition.h"
+
+#include "slib/core/function.h"
+
+#if defined(SLIB_ARCH_IS_X64)
+#	define SLIB_GEO_BATCH_SUPPORT_SSE2
+#	if !defined(SLIB_PLATFORM_IS_MOBILE)
+#		define SLIB_GEO_BATCH_SUPPORT_AVX2
+#	endif
+#endif
+
+/*
+	Kernels for the batched coordinate transforms.
+	The kernels evaluate the trigonometric, exponential and logarithmic functions with the Cephes polynomials, and compile the same code for every instruction set (see geo_batch_kernels.h).
+	Angles are in radians here; the conversions from and to degrees are done in the kernels.
+*/
+
+namespace slib
+{
+
+	class ThreadPool;
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			class EllipsoidParam
+			{
+			public:
+				double radiusEquatorial;
+				double eccentricitySquared;
+				// derived from the above
+				double radiusPolar;
+				double secondEccentricitySquared;
+
+			public:
+				EllipsoidParam(double radiusEquatorial, double eccentricitySquared);
+			};
+
+			class UTMParam
+			{
+			public:
+				double referenceLongitude;
+				double A0;
+				double t1;
+				double a1, a2, a3;
+				double b1, b2, b3;
+				double g1, g2, g3;
+
+			public:
+				UTMParam(double referenceLongitude, double scaleFactor);
+			};
+
+			class Kernels
+			{
+			public:
+				void (*getCartesianPositions)(const EllipsoidParam& param, const double* latitudes, const double* longitudes, const double* altitudes, double* x, double* y, double* z, sl_size count);
+				void (*getGeoLocations)(const EllipsoidParam& param, const double* x, const double* y, const double* z, double* latitudes, double* longitudes, double* altitudes, sl_size count);
+				void (*getUTMCoordinates)(const UTMParam& param, const double* latitudes, const double* longitudes, double* N, double* E, sl_size count);
+				void (*getUTMLatLons)(const UTMParam& param, const double* N, const double* E, double* latitudes, double* longitudes, sl_size count);
+				void (*getDistances)(double radius, const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* distances, sl_size count);
+				void (*getBearings)(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* bearings, sl_size count);
+			};
+
+			// selects the widest instruction set supported by the processor
+			const Kernels& GetKernels();
+
+			const Kernels& GetKernels_Generic();
+
+#if defined(SLIB_GEO_BATCH_SUPPORT_SSE2)
+			const Kernels& GetKernels_SSE2();
+#endif
+
+#if defined(SLIB_GEO_BATCH_SUPPORT_AVX2)
+			const Kernels& GetKernels_AVX2();
+#endif
+
+			// calls `task(offset, count)` on the ranges of the array, concurrently when `threadPool` is not null and the array is large enough
+			void Run(sl_size count, ThreadPool* threadPool, const Function<void(sl_size offset, sl_size count)>& task);
+
+		}
+	}
+
+}
+
+#endif
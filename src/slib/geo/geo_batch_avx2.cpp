@@ -0,0 +1,109 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "geo_batch.h"
+
+#if defined(SLIB_GEO_BATCH_SUPPORT_AVX2)
+
+#include <immintrin.h>
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			namespace {
+
+				class VectorAVX2
+				{
+				public:
+					typedef __m256d T;
+					static constexpr sl_uint32 Lanes = 4;
+
+				public:
+					SLIB_INLINE static T load(const double* p) { return _mm256_loadu_pd(p); }
+					SLIB_INLINE static void store(double* p, T v) { _mm256_storeu_pd(p, v); }
+					SLIB_INLINE static T set(double v) { return _mm256_set1_pd(v); }
+					SLIB_INLINE static T add(T a, T b) { return _mm256_add_pd(a, b); }
+					SLIB_INLINE static T sub(T a, T b) { return _mm256_sub_pd(a, b); }
+					SLIB_INLINE static T mul(T a, T b) { return _mm256_mul_pd(a, b); }
+					SLIB_INLINE static T div(T a, T b) { return _mm256_div_pd(a, b); }
+					SLIB_INLINE static T sqrt(T a) { return _mm256_sqrt_pd(a); }
+					SLIB_INLINE static T bitAnd(T a, T b) { return _mm256_and_pd(a, b); }
+					SLIB_INLINE static T bitOr(T a, T b) { return _mm256_or_pd(a, b); }
+					SLIB_INLINE static T bitAndNot(T a, T b) { return _mm256_andnot_pd(a, b); }
+					SLIB_INLINE static T bitXor(T a, T b) { return _mm256_xor_pd(a, b); }
+					SLIB_INLINE static T lessThan(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+					SLIB_INLINE static T lessEqual(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+					SLIB_INLINE static T equal(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+					SLIB_INLINE static T truncate(T a) { return _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+					// exponent bits as the mantissa of 2^52
+					SLIB_INLINE static T getExponent(T a)
+					{
+						__m256i e = _mm256_or_si256(_mm256_srli_epi64(_mm256_castpd_si256(a), 52), _mm256_set1_epi64x(0x4330000000000000LL));
+						return _mm256_sub_pd(_mm256_castsi256_pd(e), _mm256_set1_pd(4503599627370496.0 + 1022.0));
+					}
+
+					SLIB_INLINE static T getMantissa(T a)
+					{
+						return _mm256_or_pd(_mm256_and_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL))), _mm256_set1_pd(0.5));
+					}
+
+					SLIB_INLINE static T pow2(T n)
+					{
+						__m256i e = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627370496.0 + 1023.0)));
+						return _mm256_castsi256_pd(_mm256_slli_epi64(e, 52));
+					}
+				};
+
+			}
+
+		}
+	}
+
+}
+
+#include "geo_batch_kernels.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			const Kernels& GetKernels_AVX2()
+			{
+				return KernelsOf<VectorAVX2>::get();
+			}
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,537 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_GEO_BATCH_KERNELS
+#define CHECKHEADER_SLIB_GEO_BATCH_KERNELS
+
+#include "geo_batch.h"
+
+/*
+	Included by every instruction set specific source, which instantiates `KernelsOf<V>` with its vector class `V`:
+
+		typedef ... T; // vector of doubles; the comparisons return the masks in the same type
+		static constexpr sl_uint32 Lanes;
+		load, store, set, add, sub, mul, div, sqrt, bitAnd, bitOr, bitAndNot (~a & b), bitXor,
+		lessThan, lessEqual, equal,
+		truncate: rounds toward zero (|x| < 2^31),
+		getExponent, getMantissa: `frexp` for positive normal numbers,
+		pow2: 2^n for the integer n in [-1022, 1023]
+
+	The functions follow the double precision Cephes library; each of them is accurate to a few ulps in the ranges used by the transforms.
+*/
+
+#define GEO_BATCH_PI 3.14159265358979323846
+#define GEO_BATCH_DEG_TO_RAD (GEO_BATCH_PI / 180.0)
+#define GEO_BATCH_RAD_TO_DEG (180.0 / GEO_BATCH_PI)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			namespace {
+
+				template <class V>
+				class MathV
+				{
+				public:
+					typedef typename V::T T;
+
+				public:
+					SLIB_INLINE static T c(double v)
+					{
+						return V::set(v);
+					}
+
+					SLIB_INLINE static T abs(T x)
+					{
+						return V::bitAndNot(V::set(-0.0), x);
+					}
+
+					SLIB_INLINE static T signOf(T x)
+					{
+						return V::bitAnd(V::set(-0.0), x);
+					}
+
+					SLIB_INLINE static T select(T mask, T a, T b)
+					{
+						return V::bitOr(V::bitAnd(mask, a), V::bitAndNot(mask, b));
+					}
+
+					SLIB_INLINE static T floor(T x)
+					{
+						T t = V::truncate(x);
+						return V::sub(t, V::bitAnd(V::lessThan(x, t), c(1.0)));
+					}
+
+					// coefficient[0] * x^N + ... + coefficient[N]
+					template <sl_uint32 N>
+					SLIB_INLINE static T polevl(T x, const double* coefficients)
+					{
+						T r = c(coefficients[0]);
+						for (sl_uint32 i = 1; i <= N; i++) {
+							r = V::add(V::mul(r, x), c(coefficients[i]));
+						}
+						return r;
+					}
+
+					// x^N + coefficient[0] * x^(N-1) + ... + coefficient[N-1]
+					template <sl_uint32 N>
+					SLIB_INLINE static T p1evl(T x, const double* coefficients)
+					{
+						T r = V::add(x, c(coefficients[0]));
+						for (sl_uint32 i = 1; i < N; i++) {
+							r = V::add(V::mul(r, x), c(coefficients[i]));
+						}
+						return r;
+					}
+
+					// |x| < 2^30
+					static void sincos(T x, T& _sin, T& _cos)
+					{
+						static const double S[] = {1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6, -1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1};
+						static const double C[] = {-1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7, 2.48015872888517045348E-5, -1.38888888888730564116E-3, 4.16666666666665929218E-2};
+						T sign = signOf(x);
+						x = abs(x);
+						// quadrant
+						T n = V::truncate(V::add(V::mul(x, c(2.0 / GEO_BATCH_PI)), c(0.5)));
+						T j = V::add(n, n);
+						T z = V::sub(V::sub(V::sub(x, V::mul(j, c(7.85398125648498535156E-1))), V::mul(j, c(3.77489470793079817668E-8))), V::mul(j, c(2.69515142907905952645E-15)));
+						T zz = V::mul(z, z);
+						T s = V::add(z, V::mul(V::mul(z, zz), polevl<5>(zz, S)));
+						T k = V::add(V::sub(c(1.0), V::mul(zz, c(0.5))), V::mul(V::mul(zz, zz), polevl<5>(zz, C)));
+						T q = V::sub(n, V::mul(V::truncate(V::mul(n, c(0.25))), c(4.0)));
+						T q1 = V::equal(q, c(1.0));
+						T q2 = V::equal(q, c(2.0));
+						T q3 = V::equal(q, c(3.0));
+						T flagSwap = V::bitOr(q1, q3);
+						T flagNegativeSin = V::bitOr(q2, q3);
+						T flagNegativeCos = V::bitOr(q1, q2);
+						T minus = c(-0.0);
+						_sin = V::bitXor(V::bitXor(select(flagSwap, k, s), V::bitAnd(flagNegativeSin, minus)), sign);
+						_cos = V::bitXor(select(flagSwap, s, k), V::bitAnd(flagNegativeCos, minus));
+					}
+
+					static T atan(T x)
+					{
+						static const double P[] = {-8.750608600031904122785E-1, -1.615753718733365076637E1, -7.500855792314704667340E1, -1.228866684490136173410E2, -6.485021904942025371773E1};
+						static const double Q[] = {2.485846490142306297962E1, 1.650270098316988542046E2, 4.328810604912902668951E2, 4.853903996359136964868E2, 1.945506571482613964425E2};
+						const double MOREBITS = 6.123233995736765886130E-17;
+						T sign = signOf(x);
+						x = abs(x);
+						T flagLarge = V::lessThan(c(2.41421356237309504880), x);
+						T flagMedium = V::bitAndNot(flagLarge, V::lessThan(c(0.66), x));
+						T one = c(1.0);
+						T r = select(flagLarge, V::div(c(-1.0), x), select(flagMedium, V::div(V::sub(x, one), V::add(x, one)), x));
+						T y = select(flagLarge, c(GEO_BATCH_PI / 2), V::bitAnd(flagMedium, c(GEO_BATCH_PI / 4)));
+						T more = select(flagLarge, c(MOREBITS), V::bitAnd(flagMedium, c(0.5 * MOREBITS)));
+						T z = V::mul(r, r);
+						z = V::div(V::mul(z, polevl<4>(z, P)), p1evl<5>(z, Q));
+						z = V::add(V::add(V::mul(r, z), r), more);
+						return V::bitXor(V::add(y, z), sign);
+					}
+
+					static T atan2(T y, T x)
+					{
+						T zero = V::set(0.0);
+						T q = V::bitAndNot(V::bitAnd(V::equal(x, zero), V::equal(y, zero)), V::div(y, x));
+						T w = V::bitAnd(V::lessThan(x, zero), V::bitXor(c(GEO_BATCH_PI), signOf(y)));
+						return V::add(atan(q), w);
+					}
+
+					// x > 0
+					static T log(T x)
+					{
+						static const double P[] = {1.01875663804580931796E-4, 4.97494994976747001425E-1, 4.70579119878881725854E0, 1.44989225341610930846E1, 1.79368678507819816313E1, 7.70838733755885391666E0};
+						static const double Q[] = {1.12873587189167450590E1, 4.52279145837532221105E1, 8.29875266912776603211E1, 7.11544750618563894466E1, 2.31251620126765340583E1};
+						T e = V::getExponent(x);
+						T m = V::getMantissa(x);
+						T flagSmall = V::lessThan(m, c(0.70710678118654752440));
+						e = V::sub(e, V::bitAnd(flagSmall, c(1.0)));
+						m = V::sub(select(flagSmall, V::add(m, m), m), c(1.0));
+						T z = V::mul(m, m);
+						T y = V::div(V::mul(V::mul(m, z), polevl<5>(m, P)), p1evl<5>(m, Q));
+						y = V::sub(y, V::mul(e, c(2.121944400546905827679E-4)));
+						y = V::sub(y, V::mul(z, c(0.5)));
+						return V::add(V::add(m, y), V::mul(e, c(0.693359375)));
+					}
+
+					// |x| < 700
+					static T exp(T x)
+					{
+						static const double P[] = {1.26177193074810590878E-4, 3.02994407707441961300E-2, 9.99999999999999999910E-1};
+						static const double Q[] = {3.00198505138664455042E-6, 2.52448340349684104192E-3, 2.27265548208155028766E-1, 2.00000000000000000009E0};
+						T n = floor(V::add(V::mul(x, c(1.4426950408889634073599)), c(0.5)));
+						x = V::sub(x, V::mul(n, c(6.93145751953125E-1)));
+						x = V::sub(x, V::mul(n, c(1.42860682030941723212E-6)));
+						T xx = V::mul(x, x);
+						T p = V::mul(x, polevl<2>(xx, P));
+						x = V::div(p, V::sub(polevl<3>(xx, Q), p));
+						x = V::add(c(1.0), V::add(x, x));
+						return V::mul(x, V::pow2(n));
+					}
+
+				};
+
+				template <class V>
+				class CartesianKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: latitude, longitude, altitude(optional) / output: x, y, z
+					static void run(const EllipsoidParam& param, const T* in, T* out, sl_bool flagAltitude)
+					{
+						T sinLat, cosLat, sinLon, cosLon;
+						M::sincos(V::mul(in[0], M::c(GEO_BATCH_DEG_TO_RAD)), sinLat, cosLat);
+						M::sincos(V::mul(in[1], M::c(GEO_BATCH_DEG_TO_RAD)), sinLon, cosLon);
+						T h = flagAltitude ? in[2] : V::set(0.0);
+						double e2 = param.eccentricitySquared;
+						// radius of vertical in prime meridian
+						T rv = V::div(M::c(param.radiusEquatorial), V::sqrt(V::sub(M::c(1.0), V::mul(V::mul(M::c(e2), sinLat), sinLat))));
+						out[1] = V::mul(sinLat, V::add(V::mul(rv, M::c(1 - e2)), h));
+						T rxz = V::mul(cosLat, V::add(rv, h));
+						out[0] = V::mul(rxz, sinLon);
+						out[2] = V::bitXor(V::mul(rxz, cosLon), M::c(-0.0));
+					}
+				};
+
+				/*
+					Bowring's method with two iterations.
+					Converges to the scalar path within 1e-9 meters for the altitudes from -10km to 10000km.
+				*/
+				template <class V>
+				class GeoLocationKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: x, y, z / output: latitude, longitude, altitude
+					static void run(const EllipsoidParam& param, const T* in, T* out, sl_bool)
+					{
+						double a = param.radiusEquatorial;
+						double b = param.radiusPolar;
+						double e2 = param.eccentricitySquared;
+						double ep2 = param.secondEccentricitySquared;
+						T X = V::bitXor(in[2], M::c(-0.0));
+						T Y = in[0];
+						T Z = in[1];
+						T p = V::sqrt(V::add(V::mul(X, X), V::mul(Y, Y)));
+						// tangent of the parametric latitude: u / v
+						T u = V::mul(Z, M::c(a));
+						T v = V::mul(p, M::c(b));
+						T num, den;
+						for (sl_uint32 i = 0; i < 2; i++) {
+							T r = V::sqrt(V::add(V::mul(u, u), V::mul(v, v)));
+							T sinBeta = V::div(u, r);
+							T cosBeta = V::div(v, r);
+							num = V::add(Z, V::mul(M::c(ep2 * b), V::mul(V::mul(sinBeta, sinBeta), sinBeta)));
+							den = V::sub(p, V::mul(M::c(e2 * a), V::mul(V::mul(cosBeta, cosBeta), cosBeta)));
+							u = V::mul(num, M::c(b));
+							v = V::mul(den, M::c(a));
+						}
+						T r = V::sqrt(V::add(V::mul(num, num), V::mul(den, den)));
+						T sinLat = V::div(num, r);
+						T cosLat = V::div(den, r);
+						T rn = V::mul(M::c(a), V::sqrt(V::sub(M::c(1.0), V::mul(V::mul(M::c(e2), sinLat), sinLat))));
+						out[0] = V::mul(M::atan2(num, den), M::c(GEO_BATCH_RAD_TO_DEG));
+						out[1] = V::mul(M::atan2(Y, X), M::c(GEO_BATCH_RAD_TO_DEG));
+						out[2] = V::sub(V::add(V::mul(p, cosLat), V::mul(Z, sinLat)), rn);
+					}
+				};
+
+				// Krüger series of the third order, as `UTM::getCoordinate`
+				template <class V>
+				class UTMCoordinateKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: latitude, longitude / output: N, E
+					static void run(const UTMParam& param, const T* in, T* out, sl_bool)
+					{
+						T one = M::c(1.0);
+						T half = M::c(0.5);
+						T flagSouthern = V::lessThan(in[0], V::set(0.0));
+						T sinLat, cosLat, sinLon, cosLon;
+						M::sincos(V::mul(M::abs(in[0]), M::c(GEO_BATCH_DEG_TO_RAD)), sinLat, cosLat);
+						M::sincos(V::mul(V::sub(in[1], M::c(param.referenceLongitude)), M::c(GEO_BATCH_DEG_TO_RAD)), sinLon, cosLon);
+						T t1s = V::mul(sinLat, M::c(param.t1));
+						// t = sinh(atanh(sinLat) - t1 * atanh(t1 * sinLat))
+						T l1 = M::log(V::div(V::add(one, sinLat), V::sub(one, sinLat)));
+						T l2 = M::log(V::div(V::add(one, t1s), V::sub(one, t1s)));
+						T eu = M::exp(V::mul(V::sub(l1, V::mul(M::c(param.t1), l2)), half));
+						T t = V::mul(V::sub(eu, V::div(one, eu)), half);
+						T p = M::atan(V::div(t, cosLon));
+						T tt = V::mul(t, t);
+						T cc = V::mul(cosLon, cosLon);
+						T rr = V::add(tt, cc);
+						T sin2p = V::div(V::mul(M::c(2.0), V::mul(t, cosLon)), rr);
+						T cos2p = V::div(V::sub(cc, tt), rr);
+						// q = atanh(w)
+						T w = V::div(sinLon, V::sqrt(V::add(one, tt)));
+						T e2q = V::div(V::add(one, w), V::sub(one, w));
+						T q = V::mul(M::log(e2q), half);
+						T sinh2q = V::mul(V::sub(e2q, V::div(one, e2q)), half);
+						T cosh2q = V::mul(V::add(e2q, V::div(one, e2q)), half);
+						T sin4p = V::mul(M::c(2.0), V::mul(sin2p, cos2p));
+						T cos4p = V::sub(V::mul(cos2p, cos2p), V::mul(sin2p, sin2p));
+						T sin6p = V::add(V::mul(sin2p, cos4p), V::mul(cos2p, sin4p));
+						T cos6p = V::sub(V::mul(cos2p, cos4p), V::mul(sin2p, sin4p));
+						T sinh4q = V::mul(M::c(2.0), V::mul(sinh2q, cosh2q));
+						T cosh4q = V::add(V::mul(cosh2q, cosh2q), V::mul(sinh2q, sinh2q));
+						T sinh6q = V::add(V::mul(sinh2q, cosh4q), V::mul(cosh2q, sinh4q));
+						T cosh6q = V::add(V::mul(cosh2q, cosh4q), V::mul(sinh2q, sinh4q));
+						T a1 = M::c(param.a1);
+						T a2 = M::c(param.a2);
+						T a3 = M::c(param.a3);
+						T A0 = M::c(param.A0);
+						T E = V::add(q, V::add(V::add(V::mul(a1, V::mul(cos2p, sinh2q)), V::mul(a2, V::mul(cos4p, sinh4q))), V::mul(a3, V::mul(cos6p, sinh6q))));
+						T N = V::add(p, V::add(V::add(V::mul(a1, V::mul(sin2p, cosh2q)), V::mul(a2, V::mul(sin4p, cosh4q))), V::mul(a3, V::mul(sin6p, cosh6q))));
+						out[0] = V::add(V::mul(A0, N), V::bitAnd(flagSouthern, M::c(10000000.0)));
+						out[1] = V::add(M::c(500000.0), V::mul(A0, E));
+					}
+				};
+
+				template <class V>
+				class UTMLatLonKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: N, E / output: latitude, longitude
+					static void run(const UTMParam& param, const T* in, T* out, sl_bool)
+					{
+						T one = M::c(1.0);
+						T half = M::c(0.5);
+						T two = M::c(2.0);
+						T flagSouthern = V::lessEqual(M::c(10000000.0), in[0]);
+						T N = V::sub(in[0], V::bitAnd(flagSouthern, M::c(10000000.0)));
+						T A0 = M::c(param.A0);
+						T x = V::div(N, A0);
+						T y = V::div(V::sub(in[1], M::c(500000.0)), A0);
+						T sin2x, cos2x;
+						M::sincos(V::add(x, x), sin2x, cos2x);
+						T e2y = M::exp(V::add(y, y));
+						T sinh2y = V::mul(V::sub(e2y, V::div(one, e2y)), half);
+						T cosh2y = V::mul(V::add(e2y, V::div(one, e2y)), half);
+						T sin4x = V::mul(two, V::mul(sin2x, cos2x));
+						T cos4x = V::sub(V::mul(cos2x, cos2x), V::mul(sin2x, sin2x));
+						T sin6x = V::add(V::mul(sin2x, cos4x), V::mul(cos2x, sin4x));
+						T cos6x = V::sub(V::mul(cos2x, cos4x), V::mul(sin2x, sin4x));
+						T sinh4y = V::mul(two, V::mul(sinh2y, cosh2y));
+						T cosh4y = V::add(V::mul(cosh2y, cosh2y), V::mul(sinh2y, sinh2y));
+						T sinh6y = V::add(V::mul(sinh2y, cosh4y), V::mul(cosh2y, sinh4y));
+						T cosh6y = V::add(V::mul(cosh2y, cosh4y), V::mul(sinh2y, sinh4y));
+						T b1 = M::c(param.b1);
+						T b2 = M::c(param.b2);
+						T b3 = M::c(param.b3);
+						T p = V::sub(x, V::add(V::add(V::mul(b1, V::mul(sin2x, cosh2y)), V::mul(b2, V::mul(sin4x, cosh4y))), V::mul(b3, V::mul(sin6x, cosh6y))));
+						T q = V::sub(y, V::add(V::add(V::mul(b1, V::mul(cos2x, sinh2y)), V::mul(b2, V::mul(cos4x, sinh4y))), V::mul(b3, V::mul(cos6x, sinh6y))));
+						T sinP, cosP;
+						M::sincos(p, sinP, cosP);
+						T eq = M::exp(q);
+						T sinhQ = V::mul(V::sub(eq, V::div(one, eq)), half);
+						T coshQ = V::mul(V::add(eq, V::div(one, eq)), half);
+						// z = asin(sinP / coshQ)
+						T sinZ = V::div(sinP, coshQ);
+						T cosZ = V::sqrt(V::sub(one, V::mul(sinZ, sinZ)));
+						T z = M::atan2(sinZ, cosZ);
+						T sin2z = V::mul(two, V::mul(sinZ, cosZ));
+						T cos2z = V::sub(one, V::mul(two, V::mul(sinZ, sinZ)));
+						T sin4z = V::mul(two, V::mul(sin2z, cos2z));
+						T cos4z = V::sub(V::mul(cos2z, cos2z), V::mul(sin2z, sin2z));
+						T sin6z = V::add(V::mul(sin2z, cos4z), V::mul(cos2z, sin4z));
+						T lat = V::add(z, V::add(V::add(V::mul(M::c(param.g1), sin2z), V::mul(M::c(param.g2), sin4z)), V::mul(M::c(param.g3), sin6z)));
+						T lon = M::atan(V::div(sinhQ, cosP));
+						lat = V::mul(lat, M::c(GEO_BATCH_RAD_TO_DEG));
+						out[0] = V::bitXor(lat, V::bitAnd(flagSouthern, M::c(-0.0)));
+						out[1] = V::add(M::c(param.referenceLongitude), V::mul(lon, M::c(GEO_BATCH_RAD_TO_DEG)));
+					}
+				};
+
+				// haversine formula
+				template <class V>
+				class DistanceKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: latitude1, longitude1, latitude2, longitude2 / output: distance
+					static void run(const double& radius, const T* in, T* out, sl_bool)
+					{
+						T one = M::c(1.0);
+						T halfDegree = M::c(0.5 * GEO_BATCH_DEG_TO_RAD);
+						T s1, c1, s2, c2, sinLat, sinLon, k;
+						M::sincos(V::mul(in[0], M::c(GEO_BATCH_DEG_TO_RAD)), s1, c1);
+						M::sincos(V::mul(in[2], M::c(GEO_BATCH_DEG_TO_RAD)), s2, c2);
+						M::sincos(V::mul(V::sub(in[2], in[0]), halfDegree), sinLat, k);
+						M::sincos(V::mul(V::sub(in[3], in[1]), halfDegree), sinLon, k);
+						T h = V::add(V::mul(sinLat, sinLat), V::mul(V::mul(c1, c2), V::mul(sinLon, sinLon)));
+						h = M::select(V::lessThan(one, h), one, h);
+						out[0] = V::mul(M::c(2 * radius), M::atan2(V::sqrt(h), V::sqrt(V::sub(one, h))));
+					}
+				};
+
+				template <class V>
+				class BearingKernel
+				{
+				public:
+					typedef typename V::T T;
+					typedef MathV<V> M;
+
+				public:
+					// input: latitude1, longitude1, latitude2, longitude2 / output: bearing
+					static void run(const double&, const T* in, T* out, sl_bool)
+					{
+						T s1, c1, s2, c2, sinLon, cosLon;
+						M::sincos(V::mul(in[0], M::c(GEO_BATCH_DEG_TO_RAD)), s1, c1);
+						M::sincos(V::mul(in[2], M::c(GEO_BATCH_DEG_TO_RAD)), s2, c2);
+						M::sincos(V::mul(V::sub(in[3], in[1]), M::c(GEO_BATCH_DEG_TO_RAD)), sinLon, cosLon);
+						T y = V::mul(sinLon, c2);
+						T x = V::sub(V::mul(c1, s2), V::mul(V::mul(s1, c2), cosLon));
+						T r = V::mul(M::atan2(y, x), M::c(GEO_BATCH_RAD_TO_DEG));
+						out[0] = V::add(r, V::bitAnd(V::lessThan(r, V::set(0.0)), M::c(360.0)));
+					}
+				};
+
+				// the last input is optional, and is zero when it is null
+				template <class V, class KERNEL, sl_uint32 N_IN, sl_uint32 N_OUT, class PARAM>
+				static void RunKernel(const PARAM& param, const double* const* inputs, double* const* outputs, sl_size count)
+				{
+					typedef typename V::T T;
+					sl_bool flagLastInput = inputs[N_IN - 1] != sl_null;
+					sl_uint32 nInputs = flagLastInput ? N_IN : N_IN - 1;
+					T in[N_IN];
+					T out[N_OUT];
+					in[N_IN - 1] = V::set(0.0);
+					sl_size i = 0;
+					for (; i + V::Lanes <= count; i += V::Lanes) {
+						for (sl_uint32 k = 0; k < nInputs; k++) {
+							in[k] = V::load(inputs[k] + i);
+						}
+						KERNEL::run(param, in, out, flagLastInput);
+						for (sl_uint32 k = 0; k < N_OUT; k++) {
+							V::store(outputs[k] + i, out[k]);
+						}
+					}
+					if (i < count) {
+						// pads the last vector with the first remaining element
+						sl_size n = count - i;
+						double buf[V::Lanes];
+						for (sl_uint32 k = 0; k < nInputs; k++) {
+							for (sl_uint32 l = 0; l < V::Lanes; l++) {
+								buf[l] = inputs[k][i + (l < n ? l : 0)];
+							}
+							in[k] = V::load(buf);
+						}
+						KERNEL::run(param, in, out, flagLastInput);
+						for (sl_uint32 k = 0; k < N_OUT; k++) {
+							V::store(buf, out[k]);
+							for (sl_size l = 0; l < n; l++) {
+								outputs[k][i + l] = buf[l];
+							}
+						}
+					}
+				}
+
+				template <class V>
+				class KernelsOf
+				{
+				public:
+					static void getCartesianPositions(const EllipsoidParam& param, const double* latitudes, const double* longitudes, const double* altitudes, double* x, double* y, double* z, sl_size count)
+					{
+						const double* inputs[] = {latitudes, longitudes, altitudes};
+						double* outputs[] = {x, y, z};
+						RunKernel< V, CartesianKernel<V>, 3, 3 >(param, inputs, outputs, count);
+					}
+
+					static void getGeoLocations(const EllipsoidParam& param, const double* x, const double* y, const double* z, double* latitudes, double* longitudes, double* altitudes, sl_size count)
+					{
+						const double* inputs[] = {x, y, z};
+						double* outputs[] = {latitudes, longitudes, altitudes};
+						RunKernel< V, GeoLocationKernel<V>, 3, 3 >(param, inputs, outputs, count);
+					}
+
+					static void getUTMCoordinates(const UTMParam& param, const double* latitudes, const double* longitudes, double* N, double* E, sl_size count)
+					{
+						const double* inputs[] = {latitudes, longitudes};
+						double* outputs[] = {N, E};
+						RunKernel< V, UTMCoordinateKernel<V>, 2, 2 >(param, inputs, outputs, count);
+					}
+
+					static void getUTMLatLons(const UTMParam& param, const double* N, const double* E, double* latitudes, double* longitudes, sl_size count)
+					{
+						const double* inputs[] = {N, E};
+						double* outputs[] = {latitudes, longitudes};
+						RunKernel< V, UTMLatLonKernel<V>, 2, 2 >(param, inputs, outputs, count);
+					}
+
+					static void getDistances(double radius, const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* distances, sl_size count)
+					{
+						const double* inputs[] = {latitudes1, longitudes1, latitudes2, longitudes2};
+						double* outputs[] = {distances};
+						RunKernel< V, DistanceKernel<V>, 4, 1 >(radius, inputs, outputs, count);
+					}
+
+					static void getBearings(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* bearings, sl_size count)
+					{
+						const double* inputs[] = {latitudes1, longitudes1, latitudes2, longitudes2};
+						double* outputs[] = {bearings};
+						RunKernel< V, BearingKernel<V>, 4, 1 >(0.0, inputs, outputs, count);
+					}
+
+					static const Kernels& get()
+					{
+						static const Kernels kernels = {
+							&getCartesianPositions,
+							&getGeoLocations,
+							&getUTMCoordinates,
+							&getUTMLatLons,
+							&getDistances,
+							&getBearings
+						};
+						return kernels;
+					}
+				};
+
+			}
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "geo_batch.h"
+
+#if defined(SLIB_GEO_BATCH_SUPPORT_SSE2)
+
+#include <emmintrin.h>
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			namespace {
+
+				class VectorSSE2
+				{
+				public:
+					typedef __m128d T;
+					static constexpr sl_uint32 Lanes = 2;
+
+				public:
+					SLIB_INLINE static T load(const double* p) { return _mm_loadu_pd(p); }
+					SLIB_INLINE static void store(double* p, T v) { _mm_storeu_pd(p, v); }
+					SLIB_INLINE static T set(double v) { return _mm_set1_pd(v); }
+					SLIB_INLINE static T add(T a, T b) { return _mm_add_pd(a, b); }
+					SLIB_INLINE static T sub(T a, T b) { return _mm_sub_pd(a, b); }
+					SLIB_INLINE static T mul(T a, T b) { return _mm_mul_pd(a, b); }
+					SLIB_INLINE static T div(T a, T b) { return _mm_div_pd(a, b); }
+					SLIB_INLINE static T sqrt(T a) { return _mm_sqrt_pd(a); }
+					SLIB_INLINE static T bitAnd(T a, T b) { return _mm_and_pd(a, b); }
+					SLIB_INLINE static T bitOr(T a, T b) { return _mm_or_pd(a, b); }
+					SLIB_INLINE static T bitAndNot(T a, T b) { return _mm_andnot_pd(a, b); }
+					SLIB_INLINE static T bitXor(T a, T b) { return _mm_xor_pd(a, b); }
+					SLIB_INLINE static T lessThan(T a, T b) { return _mm_cmplt_pd(a, b); }
+					SLIB_INLINE static T lessEqual(T a, T b) { return _mm_cmple_pd(a, b); }
+					SLIB_INLINE static T equal(T a, T b) { return _mm_cmpeq_pd(a, b); }
+					SLIB_INLINE static T truncate(T a) { return _mm_cvtepi32_pd(_mm_cvttpd_epi32(a)); }
+
+					// exponent bits as the mantissa of 2^52
+					SLIB_INLINE static T getExponent(T a)
+					{
+						__m128i e = _mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(a), 52), _mm_set1_epi64x(0x4330000000000000LL));
+						return _mm_sub_pd(_mm_castsi128_pd(e), _mm_set1_pd(4503599627370496.0 + 1022.0));
+					}
+
+					SLIB_INLINE static T getMantissa(T a)
+					{
+						return _mm_or_pd(_mm_and_pd(a, _mm_castsi128_pd(_mm_set1_epi64x(0x000FFFFFFFFFFFFFLL))), _mm_set1_pd(0.5));
+					}
+
+					SLIB_INLINE static T pow2(T n)
+					{
+						__m128i e = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627370496.0 + 1023.0)));
+						return _mm_castsi128_pd(_mm_slli_epi64(e, 52));
+					}
+				};
+
+			}
+
+		}
+	}
+
+}
+
+#include "geo_batch_kernels.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace geo_batch
+		{
+
+			const Kernels& GetKernels_SSE2()
+			{
+				return KernelsOf<VectorSSE2>::get();
+			}
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,1577 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/geo/geo_rtree.h"
+
+#include "slib/geo/earth.h"
+#include "slib/math/math.h"
+#include "slib/core/sort.h"
+
+#define PACKED_NODE_SIZE_MIN 2
+#define PACKED_NODE_SIZE_MAX 256
+
+// R*-tree parameters: minimum fill is 40%, and 30% of the entries are reinserted on the first overflow of each level
+#define RTREE_MAX_ENTRIES 16
+#define RTREE_MIN_ENTRIES 6
+#define RTREE_REINSERT_COUNT 5
+
+#define HILBERT_GRID 65535.0
+
+namespace slib
+{
+
+	class GeoRTree::Node
+	{
+	public:
+		Node* parent;
+		// 0: leaf
+		sl_uint32 level;
+		sl_uint32 count;
+		// one more entry for the overflow
+		GeoRTreeBox boxes[RTREE_MAX_ENTRIES + 1];
+		union {
+			Node* children[RTREE_MAX_ENTRIES + 1];
+			sl_size ids[RTREE_MAX_ENTRIES + 1];
+		};
+
+	public:
+		Node(Node* _parent, sl_uint32 _level): parent(_parent), level(_level), count(0) {}
+
+	};
+
+	namespace {
+
+		typedef GeoRTree::Node Node;
+
+		SLIB_INLINE static sl_bool IsIntersecting(const GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			return a.west <= b.east && b.west <= a.east && a.south <= b.north && b.south <= a.north;
+		}
+
+		SLIB_INLINE static sl_bool IsContaining(const GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			return a.west <= b.west && b.east <= a.east && a.south <= b.south && b.north <= a.north;
+		}
+
+		SLIB_INLINE static sl_bool IsEqual(const GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			return a.west == b.west && a.east == b.east && a.south == b.south && a.north == b.north;
+		}
+
+		SLIB_INLINE static void Unite(GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			if (b.west < a.west) {
+				a.west = b.west;
+			}
+			if (b.east > a.east) {
+				a.east = b.east;
+			}
+			if (b.south < a.south) {
+				a.south = b.south;
+			}
+			if (b.north > a.north) {
+				a.north = b.north;
+			}
+		}
+
+		SLIB_INLINE static double GetArea(const GeoRTreeBox& box)
+		{
+			return (box.east - box.west) * (box.north - box.south);
+		}
+
+		SLIB_INLINE static double GetMargin(const GeoRTreeBox& box)
+		{
+			return (box.east - box.west) + (box.north - box.south);
+		}
+
+		SLIB_INLINE static double GetOverlap(const GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			double w = Math::min(a.east, b.east) - Math::max(a.west, b.west);
+			if (w <= 0) {
+				return 0;
+			}
+			double h = Math::min(a.north, b.north) - Math::max(a.south, b.south);
+			if (h <= 0) {
+				return 0;
+			}
+			return w * h;
+		}
+
+		SLIB_INLINE static double GetEnlargedArea(const GeoRTreeBox& a, const GeoRTreeBox& b)
+		{
+			return (Math::max(a.east, b.east) - Math::min(a.west, b.west)) * (Math::max(a.north, b.north) - Math::min(a.south, b.south));
+		}
+
+		static double NormalizeLongitude(double longitude)
+		{
+			if (longitude < -180 || longitude > 180) {
+				return LatLon::normalizeLongitude(longitude);
+			}
+			return longitude;
+		}
+
+		static double NormalizeLatitude(double latitude)
+		{
+			return Math::clamp(latitude, -90.0, 90.0);
+		}
+
+		static GeoRTreeBox GetPointBox(double latitude, double longitude)
+		{
+			GeoRTreeBox box;
+			box.south = box.north = NormalizeLatitude(latitude);
+			box.west = box.east = NormalizeLongitude(longitude);
+			return box;
+		}
+
+		// returns the original box, which is `west > east` when it crosses the antimeridian
+		static GeoRTreeBox GetRectangleBox(const GeoRectangle& rect)
+		{
+			GeoRTreeBox box;
+			box.south = NormalizeLatitude(Math::min(rect.bottomLeft.latitude, rect.topRight.latitude));
+			box.north = NormalizeLatitude(Math::max(rect.bottomLeft.latitude, rect.topRight.latitude));
+			if (rect.topRight.longitude - rect.bottomLeft.longitude >= 360) {
+				box.west = -180;
+				box.east = 180;
+			} else {
+				box.west = NormalizeLongitude(rect.bottomLeft.longitude);
+				box.east = NormalizeLongitude(rect.topRight.longitude);
+			}
+			return box;
+		}
+
+		static sl_uint32 GetPieces(const GeoRTreeBox& box, GeoRTreeBox* pieces)
+		{
+			if (box.west <= box.east) {
+				pieces[0] = box;
+				return 1;
+			}
+			pieces[0] = box;
+			pieces[0].east = 180;
+			pieces[1] = box;
+			pieces[1].west = -180;
+			return 2;
+		}
+
+		static sl_uint32 GetHilbertValue(sl_uint32 x, sl_uint32 y)
+		{
+			sl_uint32 a = x ^ y;
+			sl_uint32 b = 0xFFFF ^ a;
+			sl_uint32 c = 0xFFFF ^ (x | y);
+			sl_uint32 d = x & (y ^ 0xFFFF);
+			sl_uint32 A = a | (b >> 1);
+			sl_uint32 B = (a >> 1) ^ a;
+			sl_uint32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+			sl_uint32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+			a = A; b = B; c = C; d = D;
+			A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+			B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+			C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+			D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+			a = A; b = B; c = C; d = D;
+			A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+			B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+			C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+			D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+			a = A; b = B; c = C; d = D;
+			C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+			D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+			a = C ^ (C >> 1);
+			b = D ^ (D >> 1);
+
+			sl_uint32 i0 = x ^ y;
+			sl_uint32 i1 = b | (0xFFFF ^ (i0 | a));
+
+			i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+			i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+			i0 = (i0 | (i0 << 2)) & 0x33333333;
+			i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+			i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+			i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+			i1 = (i1 | (i1 << 2)) & 0x33333333;
+			i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+			return (i1 << 1) | i0;
+		}
+
+		class HilbertItem
+		{
+		public:
+			sl_uint32 value;
+			sl_size index;
+
+		public:
+			sl_compare_result compare(const HilbertItem& other) const
+			{
+				return ComparePrimitiveValues(value, other.value);
+			}
+		};
+
+		// point in radians, with the cached trigonometric values
+		class QueryPoint
+		{
+		public:
+			double latitude; // degrees
+			double longitude; // degrees
+			double lat;
+			double lon;
+			double sinLat;
+			double cosLat;
+
+		public:
+			QueryPoint(const LatLon& pt)
+			{
+				latitude = NormalizeLatitude(pt.latitude);
+				longitude = NormalizeLongitude(pt.longitude);
+				lat = Math::getRadianFromDegrees(latitude);
+				lon = Math::getRadianFromDegrees(longitude);
+				sinLat = Math::sin(lat);
+				cosLat = Math::cos(lat);
+			}
+
+			// central angle by the haversine formula
+			double getAngle(double lat2, double lon2) const
+			{
+				double sLat = Math::sin((lat2 - lat) / 2);
+				double sLon = Math::sin((lon2 - lon) / 2);
+				double h = sLat * sLat + cosLat * Math::cos(lat2) * sLon * sLon;
+				if (h > 1) {
+					h = 1;
+				}
+				return 2 * Math::arcsin(Math::sqrt(h));
+			}
+
+			// central angle to the nearest point of the box
+			double getAngle(const GeoRTreeBox& box) const
+			{
+				if (box.west <= longitude && longitude <= box.east) {
+					if (latitude < box.south) {
+						return Math::getRadianFromDegrees(box.south - latitude);
+					}
+					if (latitude > box.north) {
+						return Math::getRadianFromDegrees(latitude - box.north);
+					}
+					return 0;
+				}
+				double south = Math::getRadianFromDegrees(box.south);
+				double north = Math::getRadianFromDegrees(box.north);
+				// the distance to a meridian grows with the difference of the longitudes
+				double dWest = Math::normalizeDegreeDistance(box.west - longitude);
+				double dEast = Math::normalizeDegreeDistance(box.east - longitude);
+				double d = Math::abs(dWest) <= Math::abs(dEast) ? dWest : dEast;
+				double lonEdge = lon + Math::getRadianFromDegrees(d);
+				if (box.south == box.north) {
+					return getAngle(south, lonEdge);
+				}
+				double cosD = Math::cos(Math::getRadianFromDegrees(d));
+				if (cosD > 0) {
+					// the nearest point on the meridian
+					double latEdge = Math::arctan2(sinLat, cosLat * cosD);
+					return getAngle(Math::clamp(latEdge, south, north), lonEdge);
+				} else {
+					return Math::min(getAngle(south, lonEdge), getAngle(north, lonEdge));
+				}
+			}
+
+			// bounding boxes of the circle
+			sl_uint32 getCircleBoxes(double angle, GeoRTreeBox* boxes) const
+			{
+				double d = Math::getDegreesFromRadian(angle);
+				GeoRTreeBox box;
+				box.south = latitude - d;
+				box.north = latitude + d;
+				if (box.south <= -90 || box.north >= 90 || angle >= SLIB_PI_DUAL) {
+					box.south = Math::max(box.south, -90.0);
+					box.north = Math::min(box.north, 90.0);
+					box.west = -180;
+					box.east = 180;
+					boxes[0] = box;
+					return 1;
+				}
+				double s = Math::sin(angle) / cosLat;
+				if (s >= 1) {
+					box.west = -180;
+					box.east = 180;
+					boxes[0] = box;
+					return 1;
+				}
+				double dLon = Math::getDegreesFromRadian(Math::arcsin(s));
+				box.west = NormalizeLongitude(longitude - dLon);
+				box.east = NormalizeLongitude(longitude + dLon);
+				return GetPieces(box, boxes);
+			}
+
+		};
+
+		class Entries
+		{
+		public:
+			const HashMap<sl_size, GeoRTreeBox>& wrapped;
+
+		public:
+			Entries(const HashMap<sl_size, GeoRTreeBox>& _wrapped): wrapped(_wrapped) {}
+
+		public:
+			// returns the number of the pieces, and the index of `box` in the pieces
+			sl_uint32 getPieces(const GeoRTreeBox& box, sl_size id, GeoRTreeBox* pieces, sl_uint32& index) const
+			{
+				index = 0;
+				pieces[0] = box;
+				if (box.west != -180 && box.east != 180) {
+					return 1;
+				}
+				GeoRTreeBox original;
+				if (!(wrapped.get_NoLock(id, &original))) {
+					return 1;
+				}
+				GetPieces(original, pieces);
+				if (box.west == -180 && box.east != 180) {
+					index = 1;
+				}
+				return 2;
+			}
+
+			// reports each entry once: at the first piece intersecting the first query piece
+			sl_bool isFirstIntersection(const GeoRTreeBox& box, sl_size id, const GeoRTreeBox* queries, sl_uint32 nQueries, sl_uint32 indexQuery) const
+			{
+				GeoRTreeBox pieces[2];
+				sl_uint32 indexPiece;
+				sl_uint32 nPieces = getPieces(box, id, pieces, indexPiece);
+				for (sl_uint32 q = 0; q <= indexQuery; q++) {
+					sl_uint32 n = q < indexQuery ? nPieces : indexPiece;
+					for (sl_uint32 i = 0; i < n; i++) {
+						if (IsIntersecting(pieces[i], queries[q])) {
+							return sl_false;
+						}
+					}
+				}
+				return sl_true;
+			}
+
+			double getAngle(const QueryPoint& pt, const GeoRTreeBox& box, sl_size id, sl_bool& flagFirst) const
+			{
+				double angle = pt.getAngle(box);
+				flagFirst = sl_true;
+				GeoRTreeBox pieces[2];
+				sl_uint32 indexPiece;
+				sl_uint32 nPieces = getPieces(box, id, pieces, indexPiece);
+				if (nPieces > 1) {
+					double other = pt.getAngle(pieces[1 - indexPiece]);
+					if (indexPiece ? other <= angle : other < angle) {
+						flagFirst = sl_false;
+					}
+				}
+				return angle;
+			}
+
+		};
+
+		/*
+			Accessors of the trees for the queries:
+
+				typedef ... Handle;
+				Handle getRoot();
+				// calls `visitor.onItem(box, id)` or `visitor.onNode(box, handle)` on the children, stops when they return `sl_false`
+				template <class VISITOR> sl_bool enumerate(Handle node, VISITOR& visitor);
+		*/
+
+		class PackedAccess
+		{
+		public:
+			typedef sl_size Handle;
+
+			const GeoRTreeBox* boxes;
+			const sl_size* indices;
+			sl_size countItems;
+			sl_size countSlots;
+			const sl_size* levelEnds;
+			sl_size countLevels;
+			sl_uint32 nodeSize;
+
+		public:
+			Handle getRoot() const
+			{
+				return countSlots - 1;
+			}
+
+			template <class VISITOR>
+			sl_bool enumerate(Handle node, VISITOR& visitor) const
+			{
+				sl_size start = indices[node];
+				sl_size end = start + nodeSize;
+				for (sl_size i = 0; i < countLevels; i++) {
+					if (start < levelEnds[i]) {
+						if (end > levelEnds[i]) {
+							end = levelEnds[i];
+						}
+						break;
+					}
+				}
+				if (start < countItems) {
+					for (sl_size i = start; i < end; i++) {
+						if (!(visitor.onItem(boxes[i], indices[i]))) {
+							return sl_false;
+						}
+					}
+				} else {
+					for (sl_size i = start; i < end; i++) {
+						if (!(visitor.onNode(boxes[i], i))) {
+							return sl_false;
+						}
+					}
+				}
+				return sl_true;
+			}
+		};
+
+		class DynamicAccess
+		{
+		public:
+			typedef Node* Handle;
+
+			Node* root;
+
+		public:
+			Handle getRoot() const
+			{
+				return root;
+			}
+
+			template <class VISITOR>
+			sl_bool enumerate(Handle node, VISITOR& visitor) const
+			{
+				sl_uint32 n = node->count;
+				if (node->level) {
+					for (sl_uint32 i = 0; i < n; i++) {
+						if (!(visitor.onNode(node->boxes[i], node->children[i]))) {
+							return sl_false;
+						}
+					}
+				} else {
+					for (sl_uint32 i = 0; i < n; i++) {
+						if (!(visitor.onItem(node->boxes[i], node->ids[i]))) {
+							return sl_false;
+						}
+					}
+				}
+				return sl_true;
+			}
+		};
+
+		template <class ACCESS>
+		class BoxSearch
+		{
+		public:
+			typedef typename ACCESS::Handle Handle;
+
+			const ACCESS& access;
+			Entries entries;
+			const Function<sl_bool(sl_size id)>& callback;
+			GeoRTreeBox queries[2];
+			sl_uint32 nQueries;
+			sl_uint32 indexQuery;
+			List<Handle> stack;
+
+		public:
+			BoxSearch(const ACCESS& _access, const HashMap<sl_size, GeoRTreeBox>& wrapped, const GeoRectangle& rect, const Function<sl_bool(sl_size id)>& _callback): access(_access), entries(wrapped), callback(_callback)
+			{
+				nQueries = GetPieces(GetRectangleBox(rect), queries);
+				indexQuery = 0;
+			}
+
+		public:
+			void run()
+			{
+				for (indexQuery = 0; indexQuery < nQueries; indexQuery++) {
+					stack.removeAll_NoLock();
+					stack.add_NoLock(access.getRoot());
+					Handle node;
+					while (stack.popBack_NoLock(&node)) {
+						if (!(access.enumerate(node, *this))) {
+							return;
+						}
+					}
+				}
+			}
+
+			sl_bool onItem(const GeoRTreeBox& box, sl_size id)
+			{
+				if (IsIntersecting(box, queries[indexQuery])) {
+					if (entries.isFirstIntersection(box, id, queries, nQueries, indexQuery)) {
+						return callback(id);
+					}
+				}
+				return sl_true;
+			}
+
+			sl_bool onNode(const GeoRTreeBox& box, Handle handle)
+			{
+				if (IsIntersecting(box, queries[indexQuery])) {
+					stack.add_NoLock(handle);
+				}
+				return sl_true;
+			}
+		};
+
+		template <class ACCESS>
+		class RadiusSearch
+		{
+		public:
+			typedef typename ACCESS::Handle Handle;
+
+			const ACCESS& access;
+			Entries entries;
+			const Function<sl_bool(sl_size id)>& callback;
+			QueryPoint center;
+			double angle;
+			GeoRTreeBox bounds[2];
+			sl_uint32 nBounds;
+			List<Handle> stack;
+
+		public:
+			RadiusSearch(const ACCESS& _access, const HashMap<sl_size, GeoRTreeBox>& wrapped, const LatLon& _center, double radius, const Function<sl_bool(sl_size id)>& _callback): access(_access), entries(wrapped), callback(_callback), center(_center)
+			{
+				angle = radius / SLIB_GEO_EARTH_AVERAGE_RADIUS;
+				nBounds = center.getCircleBoxes(angle, bounds);
+			}
+
+		public:
+			void run()
+			{
+				if (angle < 0) {
+					return;
+				}
+				stack.add_NoLock(access.getRoot());
+				Handle node;
+				while (stack.popBack_NoLock(&node)) {
+					if (!(access.enumerate(node, *this))) {
+						return;
+					}
+				}
+			}
+
+			sl_bool isInBounds(const GeoRTreeBox& box)
+			{
+				if (IsIntersecting(box, bounds[0])) {
+					return sl_true;
+				}
+				return nBounds > 1 && IsIntersecting(box, bounds[1]);
+			}
+
+			sl_bool onItem(const GeoRTreeBox& box, sl_size id)
+			{
+				if (isInBounds(box)) {
+					sl_bool flagFirst;
+					if (entries.getAngle(center, box, id, flagFirst) <= angle && flagFirst) {
+						return callback(id);
+					}
+				}
+				return sl_true;
+			}
+
+			sl_bool onNode(const GeoRTreeBox& box, Handle handle)
+			{
+				if (isInBounds(box)) {
+					if (center.getAngle(box) <= angle) {
+						stack.add_NoLock(handle);
+					}
+				}
+				return sl_true;
+			}
+		};
+
+		// best-first search
+		template <class ACCESS>
+		class NearestSearch
+		{
+		public:
+			typedef typename ACCESS::Handle Handle;
+
+			class Candidate
+			{
+			public:
+				double angle;
+				sl_bool flagItem;
+				Handle node;
+				sl_size id;
+			};
+
+			const ACCESS& access;
+			Entries entries;
+			QueryPoint center;
+			sl_size countMax;
+			double angleMax;
+			List<Candidate> heap;
+			List<sl_size> result;
+
+		public:
+			NearestSearch(const ACCESS& _access, const HashMap<sl_size, GeoRTreeBox>& wrapped, const LatLon& _center, sl_size count, double maxDistance): access(_access), entries(wrapped), center(_center), countMax(count)
+			{
+				angleMax = maxDistance < 0 ? SLIB_PI : maxDistance / SLIB_GEO_EARTH_AVERAGE_RADIUS;
+			}
+
+		public:
+			void run()
+			{
+				if (!countMax) {
+					return;
+				}
+				Candidate root;
+				root.angle = 0;
+				root.flagItem = sl_false;
+				root.node = access.getRoot();
+				root.id = 0;
+				push(root);
+				Candidate c;
+				while (pop(c)) {
+					if (c.flagItem) {
+						result.add_NoLock(c.id);
+						if (result.getCount() >= countMax) {
+							return;
+						}
+					} else {
+						access.enumerate(c.node, *this);
+					}
+				}
+			}
+
+			sl_bool onItem(const GeoRTreeBox& box, sl_size id)
+			{
+				sl_bool flagFirst;
+				double angle = entries.getAngle(center, box, id, flagFirst);
+				if (flagFirst && angle <= angleMax) {
+					Candidate c;
+					c.angle = angle;
+					c.flagItem = sl_true;
+					c.id = id;
+					push(c);
+				}
+				return sl_true;
+			}
+
+			sl_bool onNode(const GeoRTreeBox& box, Handle handle)
+			{
+				double angle = center.getAngle(box);
+				if (angle <= angleMax) {
+					Candidate c;
+					c.angle = angle;
+					c.flagItem = sl_false;
+					c.node = handle;
+					c.id = 0;
+					push(c);
+				}
+				return sl_true;
+			}
+
+			void push(const Candidate& c)
+			{
+				if (!(heap.add_NoLock(c))) {
+					return;
+				}
+				Candidate* data = heap.getData();
+				sl_size i = heap.getCount() - 1;
+				while (i) {
+					sl_size parent = (i - 1) >> 1;
+					if (data[parent].angle <= c.angle) {
+						break;
+					}
+					data[i] = data[parent];
+					i = parent;
+				}
+				data[i] = c;
+			}
+
+			sl_bool pop(Candidate& _out)
+			{
+				sl_size n = heap.getCount();
+				if (!n) {
+					return sl_false;
+				}
+				Candidate* data = heap.getData();
+				_out = data[0];
+				n--;
+				Candidate last = data[n];
+				heap.setCount_NoLock(n);
+				if (!n) {
+					return sl_true;
+				}
+				sl_size i = 0;
+				for (;;) {
+					sl_size child = (i << 1) + 1;
+					if (child >= n) {
+						break;
+					}
+					if (child + 1 < n && data[child + 1].angle < data[child].angle) {
+						child++;
+					}
+					if (last.angle <= data[child].angle) {
+						break;
+					}
+					data[i] = data[child];
+					i = child;
+				}
+				data[i] = last;
+				return sl_true;
+			}
+		};
+
+		class ResultCollector
+		{
+		public:
+			List<sl_size> result;
+
+		public:
+			Function<sl_bool(sl_size id)> getCallback()
+			{
+				List<sl_size>* list = &result;
+				return [list](sl_size id) {
+					list->add_NoLock(id);
+					return sl_true;
+				};
+			}
+		};
+
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(GeoPackedRTree)
+
+	GeoPackedRTree::GeoPackedRTree(): m_countItems(0), m_countSlots(0), m_nodeSize(16)
+	{
+	}
+
+	sl_bool GeoPackedRTree::build(const double* latitudes, const double* longitudes, sl_size count, sl_uint32 nodeSize)
+	{
+		List<GeoRTreeBox> boxes = List<GeoRTreeBox>::create(count);
+		if (boxes.isNull() && count) {
+			return sl_false;
+		}
+		GeoRTreeBox* pBoxes = boxes.getData();
+		for (sl_size i = 0; i < count; i++) {
+			pBoxes[i] = GetPointBox(latitudes[i], longitudes[i]);
+		}
+		m_wrapped.removeAll_NoLock();
+		return _build(pBoxes, sl_null, count, nodeSize);
+	}
+
+	sl_bool GeoPackedRTree::build(const LatLon* points, sl_size count, sl_uint32 nodeSize)
+	{
+		List<GeoRTreeBox> boxes = List<GeoRTreeBox>::create(count);
+		if (boxes.isNull() && count) {
+			return sl_false;
+		}
+		GeoRTreeBox* pBoxes = boxes.getData();
+		for (sl_size i = 0; i < count; i++) {
+			pBoxes[i] = GetPointBox(points[i].latitude, points[i].longitude);
+		}
+		m_wrapped.removeAll_NoLock();
+		return _build(pBoxes, sl_null, count, nodeSize);
+	}
+
+	sl_bool GeoPackedRTree::build(const GeoRectangle* rectangles, sl_size count, sl_uint32 nodeSize)
+	{
+		List<GeoRTreeBox> boxes;
+		List<sl_size> ids;
+		m_wrapped.removeAll_NoLock();
+		for (sl_size i = 0; i < count; i++) {
+			GeoRTreeBox box = GetRectangleBox(rectangles[i]);
+			GeoRTreeBox pieces[2];
+			sl_uint32 n = GetPieces(box, pieces);
+			for (sl_uint32 k = 0; k < n; k++) {
+				if (!(boxes.add_NoLock(pieces[k]))) {
+					return sl_false;
+				}
+				if (!(ids.add_NoLock(i))) {
+					return sl_false;
+				}
+			}
+			if (n > 1) {
+				if (!(m_wrapped.put_NoLock(i, box))) {
+					return sl_false;
+				}
+			}
+		}
+		return _build(boxes.getData(), ids.getData(), boxes.getCount(), nodeSize);
+	}
+
+	sl_bool GeoPackedRTree::_build(const GeoRTreeBox* boxes, const sl_size* ids, sl_size count, sl_uint32 nodeSize)
+	{
+		m_countItems = 0;
+		m_countSlots = 0;
+		m_boxes.setNull();
+		m_indices.setNull();
+		m_levelEnds.setNull();
+		if (!count) {
+			return sl_true;
+		}
+		nodeSize = Math::clamp(nodeSize, (sl_uint32)PACKED_NODE_SIZE_MIN, (sl_uint32)PACKED_NODE_SIZE_MAX);
+
+		// levels
+		List<sl_size> levelEnds;
+		sl_size nSlots = count;
+		{
+			sl_size n = count;
+			if (!(levelEnds.add_NoLock(nSlots))) {
+				return sl_false;
+			}
+			do {
+				n = (n + nodeSize - 1) / nodeSize;
+				nSlots += n;
+				if (!(levelEnds.add_NoLock(nSlots))) {
+					return sl_false;
+				}
+			} while (n > 1);
+		}
+
+		List<GeoRTreeBox> listBoxes = List<GeoRTreeBox>::create(nSlots);
+		List<sl_size> listIndices = List<sl_size>::create(nSlots);
+		List<HilbertItem> listHilbert = List<HilbertItem>::create(count);
+		if (listBoxes.isNull() || listIndices.isNull() || listHilbert.isNull()) {
+			return sl_false;
+		}
+		GeoRTreeBox* pBoxes = listBoxes.getData();
+		sl_size* pIndices = listIndices.getData();
+
+		// sorts the items by the Hilbert values of the centers
+		HilbertItem* hilbert = listHilbert.getData();
+		for (sl_size i = 0; i < count; i++) {
+			const GeoRTreeBox& box = boxes[i];
+			sl_uint32 x = (sl_uint32)(HILBERT_GRID * ((box.west + box.east) / 2 + 180) / 360);
+			sl_uint32 y = (sl_uint32)(HILBERT_GRID * ((box.south + box.north) / 2 + 90) / 180);
+			hilbert[i].value = GetHilbertValue(x, y);
+			hilbert[i].index = i;
+		}
+		QuickSort::sortAsc(hilbert, count);
+		for (sl_size i = 0; i < count; i++) {
+			sl_size index = hilbert[i].index;
+			pBoxes[i] = boxes[index];
+			pIndices[i] = ids ? ids[index] : index;
+		}
+		listHilbert.setNull();
+
+		// nodes
+		sl_size pos = count;
+		sl_size start = 0;
+		sl_size* ends = levelEnds.getData();
+		sl_size nLevels = levelEnds.getCount();
+		for (sl_size iLevel = 0; iLevel + 1 < nLevels; iLevel++) {
+			sl_size end = ends[iLevel];
+			for (sl_size i = start; i < end; i += nodeSize) {
+				sl_size n = Math::min((sl_size)nodeSize, end - i);
+				GeoRTreeBox box = pBoxes[i];
+				for (sl_size k = 1; k < n; k++) {
+					Unite(box, pBoxes[i + k]);
+				}
+				pBoxes[pos] = box;
+				pIndices[pos] = i;
+				pos++;
+			}
+			start = end;
+		}
+
+		m_countItems = count;
+		m_countSlots = nSlots;
+		m_nodeSize = nodeSize;
+		m_boxes = Move(listBoxes);
+		m_indices = Move(listIndices);
+		m_levelEnds = Move(levelEnds);
+		return sl_true;
+	}
+
+	sl_size GeoPackedRTree::getCount() const
+	{
+		if (m_wrapped.isNotEmpty()) {
+			return m_countItems - m_wrapped.getCount();
+		}
+		return m_countItems;
+	}
+
+	sl_bool GeoPackedRTree::isEmpty() const
+	{
+		return !m_countItems;
+	}
+
+#define DEFINE_PACKED_ACCESS(NAME) \
+	PackedAccess NAME; \
+	NAME.boxes = m_boxes.getData(); \
+	NAME.indices = m_indices.getData(); \
+	NAME.countItems = m_countItems; \
+	NAME.countSlots = m_countSlots; \
+	NAME.levelEnds = m_levelEnds.getData(); \
+	NAME.countLevels = m_levelEnds.getCount(); \
+	NAME.nodeSize = m_nodeSize;
+
+	void GeoPackedRTree::search(const GeoRectangle& rect, const Function<sl_bool(sl_size id)>& callback) const
+	{
+		if (!m_countItems) {
+			return;
+		}
+		DEFINE_PACKED_ACCESS(access)
+		BoxSearch<PackedAccess> search(access, m_wrapped, rect, callback);
+		search.run();
+	}
+
+	List<sl_size> GeoPackedRTree::search(const GeoRectangle& rect) const
+	{
+		ResultCollector collector;
+		search(rect, collector.getCallback());
+		return collector.result;
+	}
+
+	void GeoPackedRTree::searchInRadius(const LatLon& center, double radius, const Function<sl_bool(sl_size id)>& callback) const
+	{
+		if (!m_countItems) {
+			return;
+		}
+		DEFINE_PACKED_ACCESS(access)
+		RadiusSearch<PackedAccess> search(access, m_wrapped, center, radius, callback);
+		search.run();
+	}
+
+	List<sl_size> GeoPackedRTree::searchInRadius(const LatLon& center, double radius) const
+	{
+		ResultCollector collector;
+		searchInRadius(center, radius, collector.getCallback());
+		return collector.result;
+	}
+
+	List<sl_size> GeoPackedRTree::searchNearest(const LatLon& pt, sl_size count, double maxDistance) const
+	{
+		if (!m_countItems) {
+			return sl_null;
+		}
+		DEFINE_PACKED_ACCESS(access)
+		NearestSearch<PackedAccess> search(access, m_wrapped, pt, count, maxDistance);
+		search.run();
+		return search.result;
+	}
+
+
+	namespace {
+
+		class DynamicEntry
+		{
+		public:
+			GeoRTreeBox box;
+			Node* child;
+			sl_size id;
+		};
+
+		static GeoRTreeBox GetNodeBox(Node* node)
+		{
+			GeoRTreeBox box = node->boxes[0];
+			for (sl_uint32 i = 1; i < node->count; i++) {
+				Unite(box, node->boxes[i]);
+			}
+			return box;
+		}
+
+		static sl_uint32 GetIndexInParent(Node* node)
+		{
+			Node* parent = node->parent;
+			for (sl_uint32 i = 0; i < parent->count; i++) {
+				if (parent->children[i] == node) {
+					return i;
+				}
+			}
+			return 0;
+		}
+
+		static void AddEntry(Node* node, const DynamicEntry& entry)
+		{
+			sl_uint32 n = node->count;
+			node->boxes[n] = entry.box;
+			if (node->level) {
+				node->children[n] = entry.child;
+				entry.child->parent = node;
+			} else {
+				node->ids[n] = entry.id;
+			}
+			node->count = n + 1;
+		}
+
+		static void GetEntry(Node* node, sl_uint32 index, DynamicEntry& entry)
+		{
+			entry.box = node->boxes[index];
+			if (node->level) {
+				entry.child = node->children[index];
+				entry.id = 0;
+			} else {
+				entry.child = sl_null;
+				entry.id = node->ids[index];
+			}
+		}
+
+		static void RemoveEntry(Node* node, sl_uint32 index)
+		{
+			sl_uint32 last = node->count - 1;
+			if (index != last) {
+				node->boxes[index] = node->boxes[last];
+				if (node->level) {
+					node->children[index] = node->children[last];
+				} else {
+					node->ids[index] = node->ids[last];
+				}
+			}
+			node->count = last;
+		}
+
+		// tightens the boxes of the ancestors
+		static void UpdateBoxes(Node* node)
+		{
+			while (node->parent && node->count) {
+				Node* parent = node->parent;
+				parent->boxes[GetIndexInParent(node)] = GetNodeBox(node);
+				node = parent;
+			}
+		}
+
+		static Node* ChooseSubtree(Node* root, const GeoRTreeBox& box, sl_uint32 level)
+		{
+			Node* node = root;
+			while (node->level > level) {
+				sl_uint32 n = node->count;
+				sl_uint32 best = 0;
+				if (node->level == 1) {
+					// minimum overlap enlargement
+					double bestOverlap = 0, bestEnlargement = 0, bestArea = 0;
+					for (sl_uint32 i = 0; i < n; i++) {
+						const GeoRTreeBox& child = node->boxes[i];
+						GeoRTreeBox enlarged = child;
+						Unite(enlarged, box);
+						double overlap = 0;
+						for (sl_uint32 k = 0; k < n; k++) {
+							if (k != i) {
+								overlap += GetOverlap(enlarged, node->boxes[k]) - GetOverlap(child, node->boxes[k]);
+							}
+						}
+						double area = GetArea(child);
+						double enlargement = GetArea(enlarged) - area;
+						if (!i || overlap < bestOverlap || (overlap == bestOverlap && (enlargement < bestEnlargement || (enlargement == bestEnlargement && area < bestArea)))) {
+							best = i;
+							bestOverlap = overlap;
+							bestEnlargement = enlargement;
+							bestArea = area;
+						}
+					}
+				} else {
+					// minimum area enlargement
+					double bestEnlargement = 0, bestArea = 0;
+					for (sl_uint32 i = 0; i < n; i++) {
+						const GeoRTreeBox& child = node->boxes[i];
+						double area = GetArea(child);
+						double enlargement = GetEnlargedArea(child, box) - area;
+						if (!i || enlargement < bestEnlargement || (enlargement == bestEnlargement && area < bestArea)) {
+							best = i;
+							bestEnlargement = enlargement;
+							bestArea = area;
+						}
+					}
+				}
+				node = node->children[best];
+			}
+			return node;
+		}
+
+		class SplitSorter
+		{
+		public:
+			const GeoRTreeBox* boxes;
+			sl_uint32 axis; // 0: latitude, 1: longitude
+			sl_bool flagUpper;
+
+		public:
+			double getKey(sl_uint32 index) const
+			{
+				const GeoRTreeBox& box = boxes[index];
+				if (axis) {
+					return flagUpper ? box.east : box.west;
+				} else {
+					return flagUpper ? box.north : box.south;
+				}
+			}
+
+			sl_bool operator()(sl_uint32 a, sl_uint32 b) const
+			{
+				return getKey(a) < getKey(b);
+			}
+
+			void sort(sl_uint32* order, sl_uint32 n) const
+			{
+				for (sl_uint32 i = 0; i < n; i++) {
+					order[i] = i;
+				}
+				for (sl_uint32 i = 1; i < n; i++) {
+					sl_uint32 v = order[i];
+					sl_uint32 k = i;
+					while (k && (*this)(v, order[k - 1])) {
+						order[k] = order[k - 1];
+						k--;
+					}
+					order[k] = v;
+				}
+			}
+		};
+
+		// R* split, returns the new sibling holding the second group
+		static Node* Split(Node* node)
+		{
+			const sl_uint32 N = RTREE_MAX_ENTRIES + 1;
+			const sl_uint32 M = RTREE_MIN_ENTRIES;
+			const sl_uint32 nDistributions = N - 2 * M + 1;
+			SplitSorter sorter;
+			sorter.boxes = node->boxes;
+			sl_uint32 orders[4][N];
+			GeoRTreeBox lower[N], upper[N];
+			double margins[2] = {0, 0};
+			for (sl_uint32 s = 0; s < 4; s++) {
+				sorter.axis = s >> 1;
+				sorter.flagUpper = s & 1;
+				sorter.sort(orders[s], N);
+				sl_uint32* order = orders[s];
+				lower[0] = node->boxes[order[0]];
+				for (sl_uint32 i = 1; i < N; i++) {
+					lower[i] = lower[i - 1];
+					Unite(lower[i], node->boxes[order[i]]);
+				}
+				upper[N - 1] = node->boxes[order[N - 1]];
+				for (sl_uint32 i = N - 1; i > 0; i--) {
+					upper[i - 1] = upper[i];
+					Unite(upper[i - 1], node->boxes[order[i - 1]]);
+				}
+				for (sl_uint32 k = 0; k < nDistributions; k++) {
+					sl_uint32 n1 = M + k;
+					margins[s >> 1] += GetMargin(lower[n1 - 1]) + GetMargin(upper[n1]);
+				}
+			}
+			sl_uint32 axis = margins[1] < margins[0] ? 1 : 0;
+			sl_uint32 bestSort = axis << 1;
+			sl_uint32 bestCount = M;
+			double bestOverlap = 0, bestArea = 0;
+			sl_bool flagFirst = sl_true;
+			for (sl_uint32 s = axis << 1; s < (axis << 1) + 2; s++) {
+				sl_uint32* order = orders[s];
+				lower[0] = node->boxes[order[0]];
+				for (sl_uint32 i = 1; i < N; i++) {
+					lower[i] = lower[i - 1];
+					Unite(lower[i], node->boxes[order[i]]);
+				}
+				upper[N - 1] = node->boxes[order[N - 1]];
+				for (sl_uint32 i = N - 1; i > 0; i--) {
+					upper[i - 1] = upper[i];
+					Unite(upper[i - 1], node->boxes[order[i - 1]]);
+				}
+				for (sl_uint32 k = 0; k < nDistributions; k++) {
+					sl_uint32 n1 = M + k;
+					double overlap = GetOverlap(lower[n1 - 1], upper[n1]);
+					double area = GetArea(lower[n1 - 1]) + GetArea(upper[n1]);
+					if (flagFirst || overlap < bestOverlap || (overlap == bestOverlap && area < bestArea)) {
+						flagFirst = sl_false;
+						bestSort = s;
+						bestCount = n1;
+						bestOverlap = overlap;
+						bestArea = area;
+					}
+				}
+			}
+			Node* sibling = new Node(node->parent, node->level);
+			if (!sibling) {
+				return sl_null;
+			}
+			DynamicEntry entries[N];
+			for (sl_uint32 i = 0; i < N; i++) {
+				GetEntry(node, orders[bestSort][i], entries[i]);
+			}
+			node->count = 0;
+			for (sl_uint32 i = 0; i < bestCount; i++) {
+				AddEntry(node, entries[i]);
+			}
+			for (sl_uint32 i = bestCount; i < N; i++) {
+				AddEntry(sibling, entries[i]);
+			}
+			return sibling;
+		}
+
+		class DynamicInserter
+		{
+		public:
+			Node*& root;
+			// levels already treated by the reinsertion
+			sl_uint32 reinsertedLevels;
+
+		public:
+			DynamicInserter(Node*& _root): root(_root), reinsertedLevels(0) {}
+
+		public:
+			sl_bool insert(const DynamicEntry& entry, sl_uint32 level)
+			{
+				Node* node = ChooseSubtree(root, entry.box, level);
+				AddEntry(node, entry);
+				while (node) {
+					if (node->count > RTREE_MAX_ENTRIES) {
+						sl_uint32 bit = 1 << (node->level & 31);
+						if (node != root && !(reinsertedLevels & bit)) {
+							reinsertedLevels |= bit;
+							return reinsert(node);
+						}
+						Node* sibling = Split(node);
+						if (!sibling) {
+							return sl_false;
+						}
+						if (node == root) {
+							Node* newRoot = new Node(sl_null, node->level + 1);
+							if (!newRoot) {
+								return sl_false;
+							}
+							DynamicEntry e;
+							e.box = GetNodeBox(node);
+							e.child = node;
+							e.id = 0;
+							AddEntry(newRoot, e);
+							e.box = GetNodeBox(sibling);
+							e.child = sibling;
+							AddEntry(newRoot, e);
+							root = newRoot;
+							return sl_true;
+						}
+						Node* parent = node->parent;
+						parent->boxes[GetIndexInParent(node)] = GetNodeBox(node);
+						DynamicEntry e;
+						e.box = GetNodeBox(sibling);
+						e.child = sibling;
+						e.id = 0;
+						AddEntry(parent, e);
+						node = parent;
+					} else {
+						UpdateBoxes(node);
+						return sl_true;
+					}
+				}
+				return sl_true;
+			}
+
+			// removes the entries farthest from the center of the node, and inserts them again from the nearest
+			sl_bool reinsert(Node* node)
+			{
+				const sl_uint32 N = RTREE_MAX_ENTRIES + 1;
+				GeoRTreeBox box = GetNodeBox(node);
+				double cx = (box.west + box.east) / 2;
+				double cy = (box.south + box.north) / 2;
+				double distances[N];
+				sl_uint32 order[N];
+				for (sl_uint32 i = 0; i < N; i++) {
+					const GeoRTreeBox& b = node->boxes[i];
+					double dx = (b.west + b.east) / 2 - cx;
+					double dy = (b.south + b.north) / 2 - cy;
+					distances[i] = dx * dx + dy * dy;
+					order[i] = i;
+				}
+				for (sl_uint32 i = 1; i < N; i++) {
+					sl_uint32 v = order[i];
+					sl_uint32 k = i;
+					while (k && distances[v] < distances[order[k - 1]]) {
+						order[k] = order[k - 1];
+						k--;
+					}
+					order[k] = v;
+				}
+				DynamicEntry entries[N];
+				for (sl_uint32 i = 0; i < N; i++) {
+					GetEntry(node, order[i], entries[i]);
+				}
+				const sl_uint32 nKeep = N - RTREE_REINSERT_COUNT;
+				node->count = 0;
+				for (sl_uint32 i = 0; i < nKeep; i++) {
+					AddEntry(node, entries[i]);
+				}
+				UpdateBoxes(node);
+				sl_uint32 level = node->level;
+				for (sl_uint32 i = nKeep; i < N; i++) {
+					if (!(insert(entries[i], level))) {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+		};
+
+		static Node* FindLeaf(Node* node, const GeoRTreeBox& box, sl_size id, sl_uint32& index)
+		{
+			if (!(node->level)) {
+				for (sl_uint32 i = 0; i < node->count; i++) {
+					if (node->ids[i] == id && IsEqual(node->boxes[i], box)) {
+						index = i;
+						return node;
+					}
+				}
+				return sl_null;
+			}
+			for (sl_uint32 i = 0; i < node->count; i++) {
+				if (IsContaining(node->boxes[i], box)) {
+					Node* leaf = FindLeaf(node->children[i], box, id, index);
+					if (leaf) {
+						return leaf;
+					}
+				}
+			}
+			return sl_null;
+		}
+
+		static void CollectItems(Node* node, List<DynamicEntry>& items)
+		{
+			if (node->level) {
+				for (sl_uint32 i = 0; i < node->count; i++) {
+					CollectItems(node->children[i], items);
+				}
+			} else {
+				for (sl_uint32 i = 0; i < node->count; i++) {
+					DynamicEntry entry;
+					GetEntry(node, i, entry);
+					items.add_NoLock(entry);
+				}
+			}
+			delete node;
+		}
+
+	}
+
+	GeoRTree::GeoRTree(): m_root(sl_null), m_count(0)
+	{
+	}
+
+	GeoRTree::~GeoRTree()
+	{
+		removeAll();
+	}
+
+	GeoRTree::GeoRTree(GeoRTree&& other): m_root(other.m_root), m_count(other.m_count), m_wrapped(Move(other.m_wrapped))
+	{
+		other.m_root = sl_null;
+		other.m_count = 0;
+	}
+
+	GeoRTree& GeoRTree::operator=(GeoRTree&& other)
+	{
+		if (this != &other) {
+			removeAll();
+			m_root = other.m_root;
+			m_count = other.m_count;
+			m_wrapped = Move(other.m_wrapped);
+			other.m_root = sl_null;
+			other.m_count = 0;
+		}
+		return *this;
+	}
+
+	sl_bool GeoRTree::insert(const LatLon& pt, sl_size id)
+	{
+		if (!(_insert(GetPointBox(pt.latitude, pt.longitude), id))) {
+			return sl_false;
+		}
+		m_count++;
+		return sl_true;
+	}
+
+	sl_bool GeoRTree::insert(const GeoRectangle& rect, sl_size id)
+	{
+		GeoRTreeBox box = GetRectangleBox(rect);
+		GeoRTreeBox pieces[2];
+		sl_uint32 n = GetPieces(box, pieces);
+		if (n > 1) {
+			if (!(m_wrapped.put_NoLock(id, box))) {
+				return sl_false;
+			}
+		}
+		for (sl_uint32 i = 0; i < n; i++) {
+			if (!(_insert(pieces[i], id))) {
+				return sl_false;
+			}
+		}
+		m_count++;
+		return sl_true;
+	}
+
+	sl_bool GeoRTree::remove(const LatLon& pt, sl_size id)
+	{
+		if (!(_remove(GetPointBox(pt.latitude, pt.longitude), id))) {
+			return sl_false;
+		}
+		m_count--;
+		return sl_true;
+	}
+
+	sl_bool GeoRTree::remove(const GeoRectangle& rect, sl_size id)
+	{
+		GeoRTreeBox box = GetRectangleBox(rect);
+		GeoRTreeBox pieces[2];
+		sl_uint32 n = GetPieces(box, pieces);
+		if (!(_remove(pieces[0], id))) {
+			return sl_false;
+		}
+		if (n > 1) {
+			_remove(pieces[1], id);
+			m_wrapped.remove_NoLock(id);
+		}
+		m_count--;
+		return sl_true;
+	}
+
+	void GeoRTree::removeAll()
+	{
+		if (m_root) {
+			_freeNode(m_root);
+			m_root = sl_null;
+		}
+		m_count = 0;
+		m_wrapped.removeAll_NoLock();
+	}
+
+	sl_size GeoRTree::getCount() const
+	{
+		return m_count;
+	}
+
+	sl_bool GeoRTree::isEmpty() const
+	{
+		return !m_count;
+	}
+
+	void GeoRTree::search(const GeoRectangle& rect, const Function<sl_bool(sl_size id)>& callback) const
+	{
+		if (!m_root) {
+			return;
+		}
+		DynamicAccess access;
+		access.root = m_root;
+		BoxSearch<DynamicAccess> search(access, m_wrapped, rect, callback);
+		search.run();
+	}
+
+	List<sl_size> GeoRTree::search(const GeoRectangle& rect) const
+	{
+		ResultCollector collector;
+		search(rect, collector.getCallback());
+		return collector.result;
+	}
+
+	void GeoRTree::searchInRadius(const LatLon& center, double radius, const Function<sl_bool(sl_size id)>& callback) const
+	{
+		if (!m_root) {
+			return;
+		}
+		DynamicAccess access;
+		access.root = m_root;
+		RadiusSearch<DynamicAccess> search(access, m_wrapped, center, radius, callback);
+		search.run();
+	}
+
+	List<sl_size> GeoRTree::searchInRadius(const LatLon& center, double radius) const
+	{
+		ResultCollector collector;
+		searchInRadius(center, radius, collector.getCallback());
+		return collector.result;
+	}
+
+	List<sl_size> GeoRTree::searchNearest(const LatLon& pt, sl_size count, double maxDistance) const
+	{
+		if (!m_root) {
+			return sl_null;
+		}
+		DynamicAccess access;
+		access.root = m_root;
+		NearestSearch<DynamicAccess> search(access, m_wrapped, pt, count, maxDistance);
+		search.run();
+		return search.result;
+	}
+
+	sl_bool GeoRTree::_insert(const GeoRTreeBox& box, sl_size id)
+	{
+		if (!m_root) {
+			m_root = new Node(sl_null, 0);
+			if (!m_root) {
+				return sl_false;
+			}
+		}
+		DynamicEntry entry;
+		entry.box = box;
+		entry.child = sl_null;
+		entry.id = id;
+		DynamicInserter inserter(m_root);
+		return inserter.insert(entry, 0);
+	}
+
+	sl_bool GeoRTree::_remove(const GeoRTreeBox& box, sl_size id)
+	{
+		if (!m_root) {
+			return sl_false;
+		}
+		sl_uint32 index = 0;
+		Node* node = FindLeaf(m_root, box, id, index);
+		if (!node) {
+			return sl_false;
+		}
+		RemoveEntry(node, index);
+		// condenses the tree
+		List<DynamicEntry> orphans;
+		while (node->parent) {
+			Node* parent = node->parent;
+			sl_uint32 indexInParent = GetIndexInParent(node);
+			if (node->count < RTREE_MIN_ENTRIES) {
+				RemoveEntry(parent, indexInParent);
+				CollectItems(node, orphans);
+			} else {
+				parent->boxes[indexInParent] = GetNodeBox(node);
+			}
+			node = parent;
+		}
+		while (m_root->level && m_root->count == 1) {
+			Node* child = m_root->children[0];
+			child->parent = sl_null;
+			delete m_root;
+			m_root = child;
+		}
+		if (!(m_root->count)) {
+			delete m_root;
+			m_root = sl_null;
+		}
+		ListElements<DynamicEntry> items(orphans);
+		for (sl_size i = 0; i < items.count; i++) {
+			_insert(items[i].box, items[i].id);
+		}
+		return sl_true;
+	}
+
+	void GeoRTree::_freeNode(Node* node)
+	{
+		if (node->level) {
+			for (sl_uint32 i = 0; i < node->count; i++) {
+				_freeNode(node->children[i]);
+			}
+		}
+		delete node;
+	}
+
+}
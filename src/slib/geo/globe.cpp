@@ -22,6 +22,8 @@
 
 #include "slib/geo/globe.h"
 
+#include "geo_batch.h"
+
 #include "slib/math/math.h"
 
 namespace slib
@@ -275,6 +277,24 @@ namespace slib
 		return getGeoLocation(position.x, position.y, position.z);
 	}
 
+	void Globe::getCartesianPositions(const double* latitudes, const double* longitudes, const double* altitudes, double* outX, double* outY, double* outZ, sl_size count, ThreadPool* threadPool) const
+	{
+		priv::geo_batch::EllipsoidParam param(radiusEquatorial, eccentricitySquared);
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getCartesianPositions(param, latitudes + offset, longitudes + offset, altitudes ? altitudes + offset : sl_null, outX + offset, outY + offset, outZ + offset, n);
+		});
+	}
+
+	void Globe::getGeoLocations(const double* x, const double* y, const double* z, double* outLatitudes, double* outLongitudes, double* outAltitudes, sl_size count, ThreadPool* threadPool) const
+	{
+		priv::geo_batch::EllipsoidParam param(radiusEquatorial, eccentricitySquared);
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getGeoLocations(param, x + offset, y + offset, z + offset, outLatitudes + offset, outLongitudes + offset, outAltitudes + offset, n);
+		});
+	}
+
 
 	SphericalGlobe::SphericalGlobe() = default;
 
@@ -393,4 +413,48 @@ namespace slib
 		return getGeoLocation(position.x, position.y, position.z);
 	}
 
+	double SphericalGlobe::getDistance(const LatLon& from, const LatLon& to) const
+	{
+		double lat1 = Math::getRadianFromDegrees(from.latitude);
+		double lat2 = Math::getRadianFromDegrees(to.latitude);
+		double sinLat = Math::sin((lat2 - lat1) / 2);
+		double sinLon = Math::sin(Math::getRadianFromDegrees(to.longitude - from.longitude) / 2);
+		double h = sinLat * sinLat + Math::cos(lat1) * Math::cos(lat2) * sinLon * sinLon;
+		if (h > 1) {
+			h = 1;
+		}
+		return 2 * radius * Math::arcsin(Math::sqrt(h));
+	}
+
+	double SphericalGlobe::getBearing(const LatLon& from, const LatLon& to)
+	{
+		double lat1 = Math::getRadianFromDegrees(from.latitude);
+		double lat2 = Math::getRadianFromDegrees(to.latitude);
+		double lon = Math::getRadianFromDegrees(to.longitude - from.longitude);
+		double y = Math::sin(lon) * Math::cos(lat2);
+		double x = Math::cos(lat1) * Math::sin(lat2) - Math::sin(lat1) * Math::cos(lat2) * Math::cos(lon);
+		double bearing = Math::getDegreesFromRadian(Math::arctan2(y, x));
+		if (bearing < 0) {
+			bearing += 360;
+		}
+		return bearing;
+	}
+
+	void SphericalGlobe::getDistances(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outDistances, sl_size count, ThreadPool* threadPool) const
+	{
+		double r = radius;
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getDistances(r, latitudes1 + offset, longitudes1 + offset, latitudes2 + offset, longitudes2 + offset, outDistances + offset, n);
+		});
+	}
+
+	void SphericalGlobe::getBearings(const double* latitudes1, const double* longitudes1, const double* latitudes2, const double* longitudes2, double* outBearings, sl_size count, ThreadPool* threadPool)
+	{
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getBearings(latitudes1 + offset, longitudes1 + offset, latitudes2 + offset, longitudes2 + offset, outBearings + offset, n);
+		});
+	}
+
 }
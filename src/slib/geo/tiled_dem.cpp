@@ -0,0 +1,1151 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/geo/tiled_dem.h"
+
+#include "slib/geo/dem.h"
+#include "slib/geo/earth.h"
+#include "slib/core/mio.h"
+#include "slib/core/endian.h"
+#include "slib/core/dispatch.h"
+
+/*
+	File Layout (little endian)
+
+		Header
+			0: Signature "SDEM"
+			4: Version (uint32)
+			8: Tile Size (uint32)
+			12: Level Count (uint32)
+			16: South, West, North, East (double)
+		Levels (16 bytes per level)
+			0: Width (uint32)
+			4: Height (uint32)
+			8: Offset of the first tile (uint64)
+		Tiles
+			Tile Size x Tile Size floats per tile, tiles of each level are stored in rows.
+			The samples outside of the level are filled by the nearest edge sample.
+*/
+
+#define FILE_VERSION 1
+#define HEADER_SIZE 48
+#define LEVEL_HEADER_SIZE 16
+#define TILE_SIZE_MIN 16
+#define TILE_SIZE_MAX 4096
+
+#define DEFAULT_MAX_CACHED_TILES 256
+#define SAMPLER_TILE_COUNT 4
+#define SAMPLE_CHUNK_SIZE 256
+#define MAX_PREFETCH_TILES 4096
+#define SORT_MIN_SAMPLES 64
+#define SORT_MAX_TILES 0x1000000
+
+namespace slib
+{
+
+	namespace
+	{
+		static const char g_signature[] = { 'S', 'D', 'E', 'M' };
+
+		SLIB_INLINE static sl_uint64 GetTileKey(sl_uint32 level, sl_uint32 tx, sl_uint32 ty)
+		{
+			return ((sl_uint64)level << 56) | ((sl_uint64)ty << 28) | (sl_uint64)tx;
+		}
+
+		SLIB_INLINE static void ParseTileKey(sl_uint64 key, sl_uint32& level, sl_uint32& tx, sl_uint32& ty)
+		{
+			level = (sl_uint32)(key >> 56);
+			ty = (sl_uint32)((key >> 28) & 0xFFFFFFF);
+			tx = (sl_uint32)(key & 0xFFFFFFF);
+		}
+
+		static double GetWidthDegrees(const GeoRectangle& bounds)
+		{
+			double w = bounds.topRight.longitude - bounds.bottomLeft.longitude;
+			if (w <= 0) {
+				// crossing the antimeridian
+				w += 360.0;
+			}
+			return w;
+		}
+
+		static void DecodeTile(float* data, sl_size count)
+		{
+			if (Endian::isBE()) {
+				for (sl_size i = 0; i < count; i++) {
+					data[i] = Endian::swapFloat(data[i]);
+				}
+			}
+		}
+
+		static sl_bool WriteLevel(const File& file, sl_uint32 width, sl_uint32 height, sl_uint32 countTilesX, sl_uint32 countTilesY, sl_uint64 offset, sl_uint32 tileSize, const Function<sl_bool(sl_uint32 y, float* row)>& readRow)
+		{
+			sl_size widthBand = (sl_size)countTilesX * tileSize;
+			Array<float> band = Array<float>::create(widthBand * tileSize);
+			if (band.isNull()) {
+				return sl_false;
+			}
+			sl_size sizeTile = (sl_size)tileSize * tileSize * 4;
+			Memory memTile = Memory::create(sizeTile);
+			if (memTile.isNull()) {
+				return sl_false;
+			}
+			float* pBand = band.getData();
+			sl_uint8* pTile = (sl_uint8*)(memTile.getData());
+			for (sl_uint32 ty = 0; ty < countTilesY; ty++) {
+				for (sl_uint32 i = 0; i < tileSize; i++) {
+					sl_uint32 y = ty * tileSize + i;
+					float* row = pBand + i * widthBand;
+					if (y < height) {
+						if (!(readRow(y, row))) {
+							return sl_false;
+						}
+						float f = row[width - 1];
+						for (sl_size x = width; x < widthBand; x++) {
+							row[x] = f;
+						}
+					} else {
+						Base::copyMemory(row, row - widthBand, widthBand * sizeof(float));
+					}
+				}
+				for (sl_uint32 tx = 0; tx < countTilesX; tx++) {
+					sl_uint8* p = pTile;
+					for (sl_uint32 i = 0; i < tileSize; i++) {
+						float* row = pBand + i * widthBand + tx * tileSize;
+						for (sl_uint32 j = 0; j < tileSize; j++) {
+							MIO::writeFloatLE(p, row[j]);
+							p += 4;
+						}
+					}
+					if (file.writeFullyAt(offset, pTile, sizeTile) != (sl_reg)sizeTile) {
+						return sl_false;
+					}
+					offset += sizeTile;
+				}
+			}
+			return sl_true;
+		}
+
+		// Reads the rows of a level which is already written, keeping the last two bands of tiles
+		class LevelReader
+		{
+		public:
+			const File* file;
+			sl_uint32 width;
+			sl_uint32 countTilesX;
+			sl_uint64 offset;
+			sl_uint32 tileSize;
+
+			Array<float> bands[2];
+			sl_uint32 bandIndices[2];
+			sl_uint32 lastSlot;
+			Memory memTile;
+
+		public:
+			LevelReader(const File& _file, sl_uint32 _width, sl_uint32 _countTilesX, sl_uint64 _offset, sl_uint32 _tileSize): file(&_file), width(_width), countTilesX(_countTilesX), offset(_offset), tileSize(_tileSize), lastSlot(0)
+			{
+				bandIndices[0] = bandIndices[1] = SLIB_UINT32_MAX;
+			}
+
+		public:
+			const float* getRow(sl_uint32 y)
+			{
+				sl_uint32 ty = y / tileSize;
+				sl_size widthBand = (sl_size)countTilesX * tileSize;
+				sl_size iRow = (y - ty * tileSize) * widthBand;
+				for (sl_uint32 i = 0; i < 2; i++) {
+					if (bandIndices[i] == ty) {
+						lastSlot = i;
+						return bands[i].getData() + iRow;
+					}
+				}
+				sl_uint32 slot = 1 - lastSlot;
+				if (bands[slot].isNull()) {
+					bands[slot] = Array<float>::create(widthBand * tileSize);
+					if (bands[slot].isNull()) {
+						return sl_null;
+					}
+				}
+				sl_size nTile = (sl_size)tileSize * tileSize;
+				sl_size sizeTile = nTile * 4;
+				if (memTile.isNull()) {
+					memTile = Memory::create(sizeTile);
+					if (memTile.isNull()) {
+						return sl_null;
+					}
+				}
+				float* tile = (float*)(memTile.getData());
+				float* band = bands[slot].getData();
+				for (sl_uint32 tx = 0; tx < countTilesX; tx++) {
+					sl_uint64 pos = offset + ((sl_uint64)ty * countTilesX + tx) * sizeTile;
+					if (file->readFullyAt(pos, tile, sizeTile) != (sl_reg)sizeTile) {
+						bandIndices[slot] = SLIB_UINT32_MAX;
+						return sl_null;
+					}
+					DecodeTile(tile, nTile);
+					for (sl_uint32 i = 0; i < tileSize; i++) {
+						Base::copyMemory(band + i * widthBand + tx * tileSize, tile + i * tileSize, tileSize * sizeof(float));
+					}
+				}
+				bandIndices[slot] = ty;
+				lastSlot = slot;
+				return band + iRow;
+			}
+		};
+
+		// Tent filter of the radius of the sampling ratio
+		class OverviewFilter
+		{
+		public:
+			sl_uint32 countTaps;
+			List<sl_uint32> starts;
+			List<float> weights;
+
+		public:
+			sl_bool prepare(sl_uint32 nSource, sl_uint32 nTarget)
+			{
+				double ratio = nTarget > 1 ? (double)(nSource - 1) / (double)(nTarget - 1) : 0.0;
+				double r = Math::max(ratio, 1.0);
+				countTaps = (sl_uint32)(Math::ceil(r)) * 2 + 1;
+				if (!(starts.setCount_NoLock(nTarget))) {
+					return sl_false;
+				}
+				if (!(weights.setCount_NoLock((sl_size)nTarget * countTaps))) {
+					return sl_false;
+				}
+				sl_uint32* pStarts = starts.getData();
+				float* pWeights = weights.getData();
+				for (sl_uint32 i = 0; i < nTarget; i++) {
+					double s = (double)i * ratio;
+					sl_int32 start = (sl_int32)(Math::floor(s - r)) + 1;
+					double sum = 0;
+					double w[64];
+					for (sl_uint32 k = 0; k < countTaps; k++) {
+						double d = Math::abs((double)(start + (sl_int32)k) - s);
+						w[k] = d < r ? 1.0 - d / r : 0.0;
+						sum += w[k];
+					}
+					// clamped to the edges
+					for (sl_uint32 k = 0; k < countTaps; k++) {
+						sl_int32 index = start + (sl_int32)k;
+						if (index < 0 || index >= (sl_int32)nSource) {
+							sl_int32 edge = index < 0 ? 0 : (sl_int32)nSource - 1;
+							w[edge - start] += w[k];
+							w[k] = 0;
+						}
+					}
+					pStarts[i] = (sl_uint32)start;
+					for (sl_uint32 k = 0; k < countTaps; k++) {
+						pWeights[i * countTaps + k] = (float)(w[k] / sum);
+					}
+				}
+				return sl_true;
+			}
+		};
+
+		class OverviewBuilder
+		{
+		public:
+			LevelReader reader;
+			sl_uint32 widthSource;
+			OverviewFilter filterX;
+			OverviewFilter filterY;
+			Array<float> rowSource;
+
+		public:
+			OverviewBuilder(const File& file, sl_uint32 _widthSource, sl_uint32 countTilesX, sl_uint64 offset, sl_uint32 tileSize): reader(file, _widthSource, countTilesX, offset, tileSize), widthSource(_widthSource)
+			{
+			}
+
+		public:
+			sl_bool prepare(sl_uint32 heightSource, sl_uint32 widthTarget, sl_uint32 heightTarget)
+			{
+				rowSource = Array<float>::create(widthSource);
+				if (rowSource.isNull()) {
+					return sl_false;
+				}
+				return filterX.prepare(widthSource, widthTarget) && filterY.prepare(heightSource, heightTarget);
+			}
+
+			sl_bool readRow(sl_uint32 y, float* _out)
+			{
+				float* row = rowSource.getData();
+				sl_uint32 nTaps = filterY.countTaps;
+				sl_int32 start = (sl_int32)(filterY.starts.getData()[y]);
+				const float* weights = filterY.weights.getData() + y * nTaps;
+				Base::zeroMemory(row, widthSource * sizeof(float));
+				for (sl_uint32 k = 0; k < nTaps; k++) {
+					float w = weights[k];
+					if (w != 0.0f) {
+						const float* src = reader.getRow((sl_uint32)(start + (sl_int32)k));
+						if (!src) {
+							return sl_false;
+						}
+						for (sl_uint32 x = 0; x < widthSource; x++) {
+							row[x] += w * src[x];
+						}
+					}
+				}
+				sl_uint32 widthTarget = (sl_uint32)(filterX.starts.getCount());
+				nTaps = filterX.countTaps;
+				const sl_uint32* starts = filterX.starts.getData();
+				weights = filterX.weights.getData();
+				for (sl_uint32 x = 0; x < widthTarget; x++) {
+					sl_int32 s = (sl_int32)(starts[x]);
+					float f = 0;
+					for (sl_uint32 k = 0; k < nTaps; k++) {
+						float w = weights[k];
+						if (w != 0.0f) {
+							f += w * row[s + (sl_int32)k];
+						}
+					}
+					_out[x] = f;
+					weights += nTaps;
+				}
+				return sl_true;
+			}
+		};
+
+		SLIB_INLINE static void GetCubicWeights(float t, float* w)
+		{
+			w[0] = ((-t + 2.0f) * t - 1.0f) * t * 0.5f;
+			w[1] = ((3.0f * t - 5.0f) * t * t + 2.0f) * 0.5f;
+			w[2] = ((-3.0f * t + 4.0f) * t + 1.0f) * t * 0.5f;
+			w[3] = (t - 1.0f) * t * t * 0.5f;
+		}
+
+		static void GetUnitVector(const LatLon& pt, double* v)
+		{
+			double lat = Math::getRadianFromDegrees(pt.latitude);
+			double lon = Math::getRadianFromDegrees(pt.longitude);
+			double c = Math::cos(lat);
+			v[0] = c * Math::cos(lon);
+			v[1] = c * Math::sin(lon);
+			v[2] = Math::sin(lat);
+		}
+
+		class LatLonArray
+		{
+		public:
+			const LatLon* locations;
+
+		public:
+			LatLonArray(const LatLon* _locations): locations(_locations) {}
+
+		public:
+			SLIB_INLINE double getLatitude(sl_size index) const
+			{
+				return locations[index].latitude;
+			}
+
+			SLIB_INLINE double getLongitude(sl_size index) const
+			{
+				return locations[index].longitude;
+			}
+		};
+
+		class LatitudeLongitudeArrays
+		{
+		public:
+			const double* latitudes;
+			const double* longitudes;
+
+		public:
+			LatitudeLongitudeArrays(const double* _latitudes, const double* _longitudes): latitudes(_latitudes), longitudes(_longitudes) {}
+
+		public:
+			SLIB_INLINE double getLatitude(sl_size index) const
+			{
+				return latitudes[index];
+			}
+
+			SLIB_INLINE double getLongitude(sl_size index) const
+			{
+				return longitudes[index];
+			}
+		};
+
+		// Interpolates along the great circle
+		class GreatCircle
+		{
+		public:
+			double a[3];
+			double b[3];
+			double angle;
+			double sinAngle;
+
+		public:
+			GreatCircle(const LatLon& start, const LatLon& end)
+			{
+				GetUnitVector(start, a);
+				GetUnitVector(end, b);
+				double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+				double cx = a[1] * b[2] - a[2] * b[1];
+				double cy = a[2] * b[0] - a[0] * b[2];
+				double cz = a[0] * b[1] - a[1] * b[0];
+				sinAngle = Math::sqrt(cx * cx + cy * cy + cz * cz);
+				angle = Math::arctan2(sinAngle, dot);
+			}
+
+		public:
+			LatLon getPoint(double t)
+			{
+				double fa, fb;
+				if (sinAngle < 1e-12) {
+					fa = 1.0 - t;
+					fb = t;
+				} else {
+					fa = Math::sin((1.0 - t) * angle) / sinAngle;
+					fb = Math::sin(t * angle) / sinAngle;
+				}
+				double x = fa * a[0] + fb * b[0];
+				double y = fa * a[1] + fb * b[1];
+				double z = fa * a[2] + fb * b[2];
+				LatLon ret;
+				ret.latitude = Math::getDegreesFromRadian(Math::arctan2(z, Math::sqrt(x * x + y * y)));
+				ret.longitude = Math::getDegreesFromRadian(Math::arctan2(y, x));
+				return ret;
+			}
+		};
+	}
+
+	class TiledDEM::Sampler
+	{
+	public:
+		TiledDEM* dem;
+		sl_uint32 level;
+		sl_uint32 width;
+		sl_uint32 height;
+		sl_uint32 tileSize;
+		double scaleX;
+		double scaleY;
+
+		sl_uint64 keys[SAMPLER_TILE_COUNT];
+		Array<float> tiles[SAMPLER_TILE_COUNT];
+		sl_uint32 nextSlot;
+
+	public:
+		Sampler(TiledDEM* _dem, sl_uint32 _level): dem(_dem), nextSlot(0)
+		{
+			if (_level >= dem->m_countLevels) {
+				_level = dem->m_countLevels - 1;
+			}
+			level = _level;
+			Level& info = dem->m_levels[level];
+			width = info.width;
+			height = info.height;
+			tileSize = dem->m_tileSize;
+			scaleX = (double)(width - 1) / dem->m_widthDegrees;
+			scaleY = (double)(height - 1) / dem->m_heightDegrees;
+			for (sl_uint32 i = 0; i < SAMPLER_TILE_COUNT; i++) {
+				keys[i] = SLIB_UINT64_MAX;
+			}
+		}
+
+	public:
+		const float* getTile(sl_uint32 tx, sl_uint32 ty)
+		{
+			sl_uint64 key = GetTileKey(level, tx, ty);
+			for (sl_uint32 i = 0; i < SAMPLER_TILE_COUNT; i++) {
+				if (keys[i] == key) {
+					return tiles[i].getData();
+				}
+			}
+			sl_uint32 slot = nextSlot;
+			nextSlot = (nextSlot + 1) % SAMPLER_TILE_COUNT;
+			tiles[slot] = dem->_getTile(level, tx, ty);
+			if (tiles[slot].isNull()) {
+				keys[slot] = SLIB_UINT64_MAX;
+				return sl_null;
+			}
+			keys[slot] = key;
+			return tiles[slot].getData();
+		}
+
+		float getPixel(sl_int32 x, sl_int32 y)
+		{
+			x = Math::clamp(x, 0, (sl_int32)width - 1);
+			y = Math::clamp(y, 0, (sl_int32)height - 1);
+			sl_uint32 tx = (sl_uint32)x / tileSize;
+			sl_uint32 ty = (sl_uint32)y / tileSize;
+			const float* tile = getTile(tx, ty);
+			if (tile) {
+				return tile[((sl_uint32)y - ty * tileSize) * tileSize + ((sl_uint32)x - tx * tileSize)];
+			}
+			return 0.0f;
+		}
+
+		// Reads the block of N x N samples starting at (x, y)
+		template <sl_uint32 N>
+		void getBlock(sl_int32 x, sl_int32 y, float* _out)
+		{
+			if (x >= 0 && y >= 0 && x + (sl_int32)N <= (sl_int32)width && y + (sl_int32)N <= (sl_int32)height) {
+				sl_uint32 tx = (sl_uint32)x / tileSize;
+				sl_uint32 ty = (sl_uint32)y / tileSize;
+				sl_uint32 ix = (sl_uint32)x - tx * tileSize;
+				sl_uint32 iy = (sl_uint32)y - ty * tileSize;
+				if (ix + N <= tileSize && iy + N <= tileSize) {
+					const float* tile = getTile(tx, ty);
+					if (tile) {
+						const float* p = tile + iy * tileSize + ix;
+						for (sl_uint32 i = 0; i < N; i++) {
+							for (sl_uint32 j = 0; j < N; j++) {
+								_out[i * N + j] = p[j];
+							}
+							p += tileSize;
+						}
+					} else {
+						for (sl_uint32 i = 0; i < N * N; i++) {
+							_out[i] = 0.0f;
+						}
+					}
+					return;
+				}
+			}
+			for (sl_uint32 i = 0; i < N; i++) {
+				for (sl_uint32 j = 0; j < N; j++) {
+					_out[i * N + j] = getPixel(x + (sl_int32)j, y + (sl_int32)i);
+				}
+			}
+		}
+
+		void getPosition(double latitude, double longitude, double& fx, double& fy)
+		{
+			double dx = longitude - dem->m_bounds.bottomLeft.longitude;
+			if (dx < 0 && dem->m_bounds.bottomLeft.longitude > dem->m_bounds.topRight.longitude) {
+				dx += 360.0;
+			}
+			fx = Math::clamp(dx * scaleX, 0.0, (double)(width - 1));
+			fy = Math::clamp((dem->m_bounds.topRight.latitude - latitude) * scaleY, 0.0, (double)(height - 1));
+			if (!(fx == fx) || !(fy == fy)) {
+				// NaN
+				fx = 0;
+				fy = 0;
+			}
+		}
+
+		float getAltitude(double latitude, double longitude, DEMInterpolation interpolation)
+		{
+			double fx, fy;
+			getPosition(latitude, longitude, fx, fy);
+			if (interpolation == DEMInterpolation::Nearest) {
+				return getPixel((sl_int32)(fx + 0.5), (sl_int32)(fy + 0.5));
+			}
+			sl_int32 x = (sl_int32)fx;
+			sl_int32 y = (sl_int32)fy;
+			float tx = (float)(fx - (double)x);
+			float ty = (float)(fy - (double)y);
+			if (interpolation == DEMInterpolation::Bicubic) {
+				float p[16];
+				getBlock<4>(x - 1, y - 1, p);
+				float wx[4], wy[4];
+				GetCubicWeights(tx, wx);
+				GetCubicWeights(ty, wy);
+				float f = 0;
+				for (sl_uint32 i = 0; i < 4; i++) {
+					f += wy[i] * (wx[0] * p[i * 4] + wx[1] * p[i * 4 + 1] + wx[2] * p[i * 4 + 2] + wx[3] * p[i * 4 + 3]);
+				}
+				return f;
+			} else {
+				float p[4];
+				getBlock<2>(x, y, p);
+				return (1.0f - ty) * ((1.0f - tx) * p[0] + tx * p[1]) + ty * ((1.0f - tx) * p[2] + tx * p[3]);
+			}
+		}
+
+		template <class LOCATIONS>
+		void getAltitudes(float* _out, const LOCATIONS& locations, sl_size count, DEMInterpolation interpolation)
+		{
+			Level& info = dem->m_levels[level];
+			sl_size nTiles = (sl_size)(info.countTilesX) * info.countTilesY;
+			Array<sl_uint32> tiles;
+			Array<sl_size> starts;
+			Array<sl_size> order;
+			if (count >= SORT_MIN_SAMPLES && nTiles > 1 && nTiles <= SORT_MAX_TILES) {
+				tiles = Array<sl_uint32>::create(count);
+				starts = Array<sl_size>::create(nTiles + 1);
+				order = Array<sl_size>::create(count);
+			}
+			if (order.isNull() || starts.isNull() || tiles.isNull()) {
+				for (sl_size i = 0; i < count; i++) {
+					_out[i] = getAltitude(locations.getLatitude(i), locations.getLongitude(i), interpolation);
+				}
+				return;
+			}
+			// groups the samples by the tiles (counting sort), so that every tile is loaded once in a batch
+			sl_uint32* pTiles = tiles.getData();
+			sl_size* pStarts = starts.getData();
+			sl_size* pOrder = order.getData();
+			Base::zeroMemory(pStarts, (nTiles + 1) * sizeof(sl_size));
+			for (sl_size i = 0; i < count; i++) {
+				double fx, fy;
+				getPosition(locations.getLatitude(i), locations.getLongitude(i), fx, fy);
+				sl_uint32 t = ((sl_uint32)fy / tileSize) * info.countTilesX + (sl_uint32)fx / tileSize;
+				pTiles[i] = t;
+				pStarts[t + 1]++;
+			}
+			for (sl_size t = 0; t < nTiles; t++) {
+				pStarts[t + 1] += pStarts[t];
+			}
+			for (sl_size i = 0; i < count; i++) {
+				pOrder[pStarts[pTiles[i]]++] = i;
+			}
+			for (sl_size k = 0; k < count; k++) {
+				sl_size i = pOrder[k];
+				_out[i] = getAltitude(locations.getLatitude(i), locations.getLongitude(i), interpolation);
+			}
+		}
+
+		void getTileRange(double latitude, double longitude, sl_uint32& tx0, sl_uint32& ty0, sl_uint32& tx1, sl_uint32& ty1)
+		{
+			double fx, fy;
+			getPosition(latitude, longitude, fx, fy);
+			sl_int32 x = (sl_int32)fx;
+			sl_int32 y = (sl_int32)fy;
+			// footprint of the bicubic interpolation
+			tx0 = (sl_uint32)(Math::clamp(x - 1, 0, (sl_int32)width - 1)) / tileSize;
+			ty0 = (sl_uint32)(Math::clamp(y - 1, 0, (sl_int32)height - 1)) / tileSize;
+			tx1 = (sl_uint32)(Math::clamp(x + 2, 0, (sl_int32)width - 1)) / tileSize;
+			ty1 = (sl_uint32)(Math::clamp(y + 2, 0, (sl_int32)height - 1)) / tileSize;
+		}
+	};
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(TiledDEMParam)
+
+	TiledDEMParam::TiledDEMParam()
+	{
+		maxCachedTiles = DEFAULT_MAX_CACHED_TILES;
+	}
+
+	SLIB_DEFINE_OBJECT(TiledDEM, Object)
+
+	TiledDEM::TiledDEM()
+	{
+		m_widthDegrees = 0;
+		m_heightDegrees = 0;
+		m_tileSize = 0;
+		m_countLevels = 0;
+		m_countCachedTiles = 0;
+		m_cacheHead = SLIB_UINT32_MAX;
+		m_cacheTail = SLIB_UINT32_MAX;
+	}
+
+	TiledDEM::~TiledDEM()
+	{
+	}
+
+	sl_bool TiledDEM::create(const StringParam& filePath, sl_uint32 width, sl_uint32 height, const GeoRectangle& bounds, const Function<sl_bool(sl_uint32 y, float* row)>& readRow, sl_uint32 tileSize)
+	{
+		if (width < 2 || height < 2) {
+			return sl_false;
+		}
+		if (tileSize < TILE_SIZE_MIN || tileSize > TILE_SIZE_MAX) {
+			return sl_false;
+		}
+		if (!(bounds.bottomLeft.latitude < bounds.topRight.latitude)) {
+			return sl_false;
+		}
+		Level levels[SLIB_TILED_DEM_MAX_LEVEL_COUNT];
+		sl_uint32 nLevels = 0;
+		{
+			sl_uint32 w = width;
+			sl_uint32 h = height;
+			for (;;) {
+				Level& level = levels[nLevels];
+				level.width = w;
+				level.height = h;
+				level.countTilesX = (w + tileSize - 1) / tileSize;
+				level.countTilesY = (h + tileSize - 1) / tileSize;
+				nLevels++;
+				if ((w <= tileSize && h <= tileSize) || nLevels >= SLIB_TILED_DEM_MAX_LEVEL_COUNT) {
+					break;
+				}
+				w = (w + 1) >> 1;
+				h = (h + 1) >> 1;
+			}
+		}
+		sl_uint32 sizeHeader = HEADER_SIZE + LEVEL_HEADER_SIZE * nLevels;
+		sl_uint8 header[HEADER_SIZE + LEVEL_HEADER_SIZE * SLIB_TILED_DEM_MAX_LEVEL_COUNT];
+		Base::copyMemory(header, g_signature, 4);
+		MIO::writeUint32LE(header + 4, FILE_VERSION);
+		MIO::writeUint32LE(header + 8, tileSize);
+		MIO::writeUint32LE(header + 12, nLevels);
+		MIO::writeDoubleLE(header + 16, bounds.bottomLeft.latitude);
+		MIO::writeDoubleLE(header + 24, bounds.bottomLeft.longitude);
+		MIO::writeDoubleLE(header + 32, bounds.topRight.latitude);
+		MIO::writeDoubleLE(header + 40, bounds.topRight.longitude);
+		sl_uint64 offset = sizeHeader;
+		sl_uint64 sizeTile = (sl_uint64)tileSize * tileSize * 4;
+		for (sl_uint32 i = 0; i < nLevels; i++) {
+			Level& level = levels[i];
+			level.offset = offset;
+			sl_uint8* p = header + HEADER_SIZE + LEVEL_HEADER_SIZE * i;
+			MIO::writeUint32LE(p, level.width);
+			MIO::writeUint32LE(p + 4, level.height);
+			MIO::writeUint64LE(p + 8, offset);
+			offset += (sl_uint64)(level.countTilesX) * level.countTilesY * sizeTile;
+		}
+		File file = File::open(filePath, FileMode::ReadWrite);
+		if (file.isNone()) {
+			return sl_false;
+		}
+		if (file.writeFullyAt(0, header, sizeHeader) != (sl_reg)sizeHeader) {
+			return sl_false;
+		}
+		if (!(WriteLevel(file, width, height, levels[0].countTilesX, levels[0].countTilesY, levels[0].offset, tileSize, readRow))) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 1; i < nLevels; i++) {
+			Level& source = levels[i - 1];
+			Level& target = levels[i];
+			OverviewBuilder builder(file, source.width, source.countTilesX, source.offset, tileSize);
+			if (!(builder.prepare(source.height, target.width, target.height))) {
+				return sl_false;
+			}
+			OverviewBuilder* pBuilder = &builder;
+			auto readOverviewRow = [pBuilder](sl_uint32 y, float* row) {
+				return pBuilder->readRow(y, row);
+			};
+			if (!(WriteLevel(file, target.width, target.height, target.countTilesX, target.countTilesY, target.offset, tileSize, readOverviewRow))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool TiledDEM::create(const StringParam& filePath, const float* data, sl_uint32 width, sl_uint32 height, const GeoRectangle& bounds, sl_uint32 tileSize)
+	{
+		if (!data) {
+			return sl_false;
+		}
+		auto readRow = [data, width](sl_uint32 y, float* row) {
+			Base::copyMemory(row, data + (sl_size)y * width, width * sizeof(float));
+			return sl_true;
+		};
+		return create(filePath, width, height, bounds, readRow, tileSize);
+	}
+
+	sl_bool TiledDEM::create(const StringParam& filePath, const DEM& dem, const GeoRectangle& bounds, sl_uint32 tileSize)
+	{
+		return create(filePath, dem.pixels, dem.N, dem.N, bounds, tileSize);
+	}
+
+	Ref<TiledDEM> TiledDEM::open(const TiledDEMParam& param)
+	{
+		File file = File::openForRandomRead(param.filePath);
+		if (file.isNone()) {
+			return sl_null;
+		}
+		sl_uint8 header[HEADER_SIZE + LEVEL_HEADER_SIZE * SLIB_TILED_DEM_MAX_LEVEL_COUNT];
+		if (file.readFullyAt(0, header, HEADER_SIZE) != HEADER_SIZE) {
+			return sl_null;
+		}
+		if (!(Base::equalsMemory(header, g_signature, 4))) {
+			return sl_null;
+		}
+		if (MIO::readUint32LE(header + 4) != FILE_VERSION) {
+			return sl_null;
+		}
+		sl_uint32 tileSize = MIO::readUint32LE(header + 8);
+		sl_uint32 nLevels = MIO::readUint32LE(header + 12);
+		if (tileSize < TILE_SIZE_MIN || tileSize > TILE_SIZE_MAX || !nLevels || nLevels > SLIB_TILED_DEM_MAX_LEVEL_COUNT) {
+			return sl_null;
+		}
+		GeoRectangle bounds;
+		bounds.bottomLeft.latitude = MIO::readDoubleLE(header + 16);
+		bounds.bottomLeft.longitude = MIO::readDoubleLE(header + 24);
+		bounds.topRight.latitude = MIO::readDoubleLE(header + 32);
+		bounds.topRight.longitude = MIO::readDoubleLE(header + 40);
+		if (!(bounds.bottomLeft.latitude < bounds.topRight.latitude)) {
+			return sl_null;
+		}
+		sl_uint32 sizeLevels = LEVEL_HEADER_SIZE * nLevels;
+		if (file.readFullyAt(HEADER_SIZE, header + HEADER_SIZE, sizeLevels) != (sl_reg)sizeLevels) {
+			return sl_null;
+		}
+		sl_uint64 sizeFile = file.getSize();
+		sl_uint64 sizeTile = (sl_uint64)tileSize * tileSize * 4;
+		Ref<TiledDEM> ret = new TiledDEM;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		for (sl_uint32 i = 0; i < nLevels; i++) {
+			Level& level = ret->m_levels[i];
+			sl_uint8* p = header + HEADER_SIZE + LEVEL_HEADER_SIZE * i;
+			level.width = MIO::readUint32LE(p);
+			level.height = MIO::readUint32LE(p + 4);
+			level.offset = MIO::readUint64LE(p + 8);
+			if (level.width < 1 || level.height < 1) {
+				return sl_null;
+			}
+			level.countTilesX = (level.width + tileSize - 1) / tileSize;
+			level.countTilesY = (level.height + tileSize - 1) / tileSize;
+			if (level.offset + (sl_uint64)(level.countTilesX) * level.countTilesY * sizeTile > sizeFile) {
+				return sl_null;
+			}
+		}
+		sl_uint32 nCache = param.maxCachedTiles;
+		if (nCache < SAMPLER_TILE_COUNT) {
+			nCache = SAMPLER_TILE_COUNT;
+		}
+		ret->m_cache = Array<CachedTile>::create(nCache);
+		if (ret->m_cache.isNull()) {
+			return sl_null;
+		}
+		ret->m_file = Move(file);
+		ret->m_bounds = bounds;
+		ret->m_widthDegrees = GetWidthDegrees(bounds);
+		ret->m_heightDegrees = bounds.topRight.latitude - bounds.bottomLeft.latitude;
+		ret->m_tileSize = tileSize;
+		ret->m_countLevels = nLevels;
+		return ret;
+	}
+
+	Ref<TiledDEM> TiledDEM::open(const StringParam& filePath)
+	{
+		TiledDEMParam param;
+		param.filePath = filePath;
+		return open(param);
+	}
+
+	const GeoRectangle& TiledDEM::getBounds()
+	{
+		return m_bounds;
+	}
+
+	sl_uint32 TiledDEM::getTileSize()
+	{
+		return m_tileSize;
+	}
+
+	sl_uint32 TiledDEM::getLevelCount()
+	{
+		return m_countLevels;
+	}
+
+	sl_uint32 TiledDEM::getWidth(sl_uint32 level)
+	{
+		if (level < m_countLevels) {
+			return m_levels[level].width;
+		}
+		return 0;
+	}
+
+	sl_uint32 TiledDEM::getHeight(sl_uint32 level)
+	{
+		if (level < m_countLevels) {
+			return m_levels[level].height;
+		}
+		return 0;
+	}
+
+	sl_uint32 TiledDEM::getLevelForResolution(double metersPerSample)
+	{
+		double metersPerDegree = Math::getRadianFromDegrees(SLIB_GEO_EARTH_AVERAGE_RADIUS);
+		sl_uint32 ret = 0;
+		for (sl_uint32 i = 1; i < m_countLevels; i++) {
+			sl_uint32 h = m_levels[i].height;
+			if (h < 2) {
+				break;
+			}
+			double spacing = m_heightDegrees / (double)(h - 1) * metersPerDegree;
+			if (spacing > metersPerSample) {
+				break;
+			}
+			ret = i;
+		}
+		return ret;
+	}
+
+	float TiledDEM::getAltitudeAt(const LatLon& location, DEMInterpolation interpolation, sl_uint32 level)
+	{
+		if (!m_countLevels) {
+			return 0;
+		}
+		Sampler sampler(this, level);
+		return sampler.getAltitude(location.latitude, location.longitude, interpolation);
+	}
+
+	void TiledDEM::getAltitudes(float* _out, const LatLon* locations, sl_size count, DEMInterpolation interpolation, sl_uint32 level)
+	{
+		if (!m_countLevels) {
+			Base::zeroMemory(_out, count * sizeof(float));
+			return;
+		}
+		Sampler sampler(this, level);
+		sampler.getAltitudes(_out, LatLonArray(locations), count, interpolation);
+	}
+
+	void TiledDEM::getAltitudes(float* _out, const double* latitudes, const double* longitudes, sl_size count, DEMInterpolation interpolation, sl_uint32 level)
+	{
+		if (!m_countLevels) {
+			Base::zeroMemory(_out, count * sizeof(float));
+			return;
+		}
+		Sampler sampler(this, level);
+		sampler.getAltitudes(_out, LatitudeLongitudeArrays(latitudes, longitudes), count, interpolation);
+	}
+
+	void TiledDEM::getProfile(float* _out, const LatLon& start, const LatLon& end, sl_uint32 count, DEMInterpolation interpolation, sl_uint32 level)
+	{
+		if (!count) {
+			return;
+		}
+		if (!m_countLevels) {
+			Base::zeroMemory(_out, count * sizeof(float));
+			return;
+		}
+		LatLon path[2] = { start, end };
+		_prefetchTiles(_getTilesAlongPath(path, 2, level));
+		GreatCircle circle(start, end);
+		Sampler sampler(this, level);
+		for (sl_uint32 i = 0; i < count; i++) {
+			double t = count > 1 ? (double)i / (double)(count - 1) : 0.0;
+			LatLon pt = circle.getPoint(t);
+			_out[i] = sampler.getAltitude(pt.latitude, pt.longitude, interpolation);
+		}
+	}
+
+	sl_bool TiledDEM::isVisible(const GeoLocation& from, const GeoLocation& to, sl_uint32 level)
+	{
+		if (!m_countLevels) {
+			return sl_true;
+		}
+		if (level >= m_countLevels) {
+			level = m_countLevels - 1;
+		}
+		LatLon path[2] = { from.getLatLon(), to.getLatLon() };
+		_prefetchTiles(_getTilesAlongPath(path, 2, level));
+		Double3 p1 = Earth::getCartesianPosition(from);
+		Double3 p2 = Earth::getCartesianPosition(to);
+		double spacing = Math::getRadianFromDegrees(SLIB_GEO_EARTH_AVERAGE_RADIUS) * m_heightDegrees / (double)(Math::max(m_levels[level].height, 2u) - 1);
+		double n = Math::ceil(p1.getLength(p2) / spacing * 2.0);
+		if (n < 2) {
+			n = 2;
+		} else if (n > 1e8) {
+			n = 1e8;
+		}
+		sl_uint32 nSamples = (sl_uint32)n;
+		double x[SAMPLE_CHUNK_SIZE], y[SAMPLE_CHUNK_SIZE], z[SAMPLE_CHUNK_SIZE];
+		double lat[SAMPLE_CHUNK_SIZE], lon[SAMPLE_CHUNK_SIZE], alt[SAMPLE_CHUNK_SIZE];
+		Sampler sampler(this, level);
+		// excludes the end points
+		for (sl_uint32 i = 1; i < nSamples; i += SAMPLE_CHUNK_SIZE) {
+			sl_uint32 m = Math::min((sl_uint32)SAMPLE_CHUNK_SIZE, nSamples - i);
+			for (sl_uint32 k = 0; k < m; k++) {
+				double t = (double)(i + k) / (double)nSamples;
+				x[k] = p1.x + (p2.x - p1.x) * t;
+				y[k] = p1.y + (p2.y - p1.y) * t;
+				z[k] = p1.z + (p2.z - p1.z) * t;
+			}
+			Earth::getGeoLocations(x, y, z, lat, lon, alt, m);
+			for (sl_uint32 k = 0; k < m; k++) {
+				if (alt[k] < sampler.getAltitude(lat[k], lon[k], DEMInterpolation::Bilinear)) {
+					return sl_false;
+				}
+			}
+		}
+		return sl_true;
+	}
+
+	void TiledDEM::prefetchPath(const LatLon* points, sl_size count, sl_uint32 level)
+	{
+		if (!m_countLevels) {
+			return;
+		}
+		_prefetchTiles(_getTilesAlongPath(points, count, level));
+	}
+
+	void TiledDEM::clearCache()
+	{
+		ObjectLocker lock(this);
+		CachedTile* cache = m_cache.getData();
+		for (sl_uint32 i = 0; i < m_countCachedTiles; i++) {
+			cache[i].data.setNull();
+		}
+		m_mapCache.removeAll_NoLock();
+		m_countCachedTiles = 0;
+		m_cacheHead = SLIB_UINT32_MAX;
+		m_cacheTail = SLIB_UINT32_MAX;
+	}
+
+	Array<float> TiledDEM::_getTile(sl_uint32 level, sl_uint32 tx, sl_uint32 ty)
+	{
+		sl_uint64 key = GetTileKey(level, tx, ty);
+		Array<float> ret;
+		if (_getCachedTile(key, ret)) {
+			return ret;
+		}
+		Level& info = m_levels[level];
+		if (tx >= info.countTilesX || ty >= info.countTilesY) {
+			return sl_null;
+		}
+		MutexLocker lockFile(&m_lockFile);
+		// could be loaded by another thread while waiting
+		if (_getCachedTile(key, ret)) {
+			return ret;
+		}
+		sl_size nTile = (sl_size)m_tileSize * m_tileSize;
+		sl_size sizeTile = nTile * 4;
+		ret = Array<float>::create(nTile);
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		sl_uint64 offset = info.offset + ((sl_uint64)ty * info.countTilesX + tx) * sizeTile;
+		if (m_file.readFullyAt(offset, ret.getData(), sizeTile) != (sl_reg)sizeTile) {
+			return sl_null;
+		}
+		DecodeTile(ret.getData(), nTile);
+		_putCachedTile(key, ret);
+		return ret;
+	}
+
+	sl_bool TiledDEM::_getCachedTile(sl_uint64 key, Array<float>& _out)
+	{
+		ObjectLocker lock(this);
+		sl_uint32 index;
+		if (!(m_mapCache.get_NoLock(key, &index))) {
+			return sl_false;
+		}
+		CachedTile* cache = m_cache.getData();
+		CachedTile& entry = cache[index];
+		if (m_cacheHead != index) {
+			// move to the head
+			cache[entry.prev].next = entry.next;
+			if (entry.next != SLIB_UINT32_MAX) {
+				cache[entry.next].prev = entry.prev;
+			} else {
+				m_cacheTail = entry.prev;
+			}
+			entry.prev = SLIB_UINT32_MAX;
+			entry.next = m_cacheHead;
+			cache[m_cacheHead].prev = index;
+			m_cacheHead = index;
+		}
+		_out = entry.data;
+		return sl_true;
+	}
+
+	void TiledDEM::_putCachedTile(sl_uint64 key, const Array<float>& data)
+	{
+		ObjectLocker lock(this);
+		if (m_mapCache.find_NoLock(key)) {
+			return;
+		}
+		CachedTile* cache = m_cache.getData();
+		sl_uint32 index;
+		if (m_countCachedTiles < (sl_uint32)(m_cache.getCount())) {
+			index = m_countCachedTiles;
+			m_countCachedTiles++;
+		} else {
+			// evict the least recently used
+			index = m_cacheTail;
+			CachedTile& tail = cache[index];
+			m_mapCache.remove_NoLock(tail.key);
+			m_cacheTail = tail.prev;
+			if (m_cacheTail != SLIB_UINT32_MAX) {
+				cache[m_cacheTail].next = SLIB_UINT32_MAX;
+			} else {
+				m_cacheHead = SLIB_UINT32_MAX;
+			}
+		}
+		CachedTile& entry = cache[index];
+		entry.key = key;
+		entry.data = data;
+		entry.prev = SLIB_UINT32_MAX;
+		entry.next = m_cacheHead;
+		if (m_cacheHead != SLIB_UINT32_MAX) {
+			cache[m_cacheHead].prev = index;
+		} else {
+			m_cacheTail = index;
+		}
+		m_cacheHead = index;
+		m_mapCache.put_NoLock(key, index);
+	}
+
+	List<sl_uint64> TiledDEM::_getTilesAlongPath(const LatLon* points, sl_size count, sl_uint32 level)
+	{
+		if (!count) {
+			return sl_null;
+		}
+		Sampler sampler(this, level);
+		double spacing = m_heightDegrees / (double)(Math::max(sampler.height, 2u) - 1);
+		// samples in every quarter of a tile
+		double step = Math::getRadianFromDegrees(spacing * (double)m_tileSize / 4.0);
+		sl_uint32 maxTiles = Math::min((sl_uint32)(m_cache.getCount()), (sl_uint32)MAX_PREFETCH_TILES);
+		List<sl_uint64> ret;
+		HashMap<sl_uint64, sl_bool> added;
+		auto addTiles = [&](const LatLon& pt) {
+			sl_uint32 tx0, ty0, tx1, ty1;
+			sampler.getTileRange(pt.latitude, pt.longitude, tx0, ty0, tx1, ty1);
+			for (sl_uint32 ty = ty0; ty <= ty1; ty++) {
+				for (sl_uint32 tx = tx0; tx <= tx1; tx++) {
+					if (ret.getCount() >= maxTiles) {
+						return sl_false;
+					}
+					sl_uint64 key = GetTileKey(sampler.level, tx, ty);
+					if (!(added.find_NoLock(key))) {
+						added.put_NoLock(key, sl_true);
+						ret.add_NoLock(key);
+					}
+				}
+			}
+			return sl_true;
+		};
+		if (!(addTiles(points[0]))) {
+			return ret;
+		}
+		for (sl_size i = 1; i < count; i++) {
+			GreatCircle circle(points[i - 1], points[i]);
+			sl_uint32 n = (sl_uint32)(Math::min(Math::ceil(circle.angle / step), 1e6));
+			for (sl_uint32 k = 1; k <= n; k++) {
+				if (!(addTiles(circle.getPoint((double)k / (double)n)))) {
+					return ret;
+				}
+			}
+			if (!n) {
+				if (!(addTiles(points[i]))) {
+					return ret;
+				}
+			}
+		}
+		return ret;
+	}
+
+	void TiledDEM::_prefetchTiles(const List<sl_uint64>& tiles)
+	{
+		if (tiles.getCount() <= SAMPLER_TILE_COUNT) {
+			// loaded on demand
+			return;
+		}
+		Ref<TiledDEM> thiz = this;
+		Dispatch::dispatch([thiz, tiles]() {
+			ListElements<sl_uint64> keys(tiles);
+			for (sl_size i = 0; i < keys.count; i++) {
+				sl_uint32 level, tx, ty;
+				ParseTileKey(keys[i], level, tx, ty);
+				thiz->_getTile(level, tx, ty);
+			}
+		});
+	}
+
+}
@@ -22,6 +22,8 @@
 
 #include "slib/geo/utm.h"
 
+#include "geo_batch.h"
+
 #include "slib/math/math.h"
 
 #define DEFAULT_SCALE_FACTOR 0.9996
@@ -129,4 +131,22 @@ namespace slib
 		return LatLon(lat, lon);
 	}
 
+	void UTM::getCoordinates(const double* latitudes, const double* longitudes, double* outN, double* outE, sl_size count, ThreadPool* threadPool) const
+	{
+		priv::geo_batch::UTMParam param(referenceLongitude, scaleFactor);
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getUTMCoordinates(param, latitudes + offset, longitudes + offset, outN + offset, outE + offset, n);
+		});
+	}
+
+	void UTM::getLatLons(const double* N, const double* E, double* outLatitudes, double* outLongitudes, sl_size count, ThreadPool* threadPool) const
+	{
+		priv::geo_batch::UTMParam param(referenceLongitude, scaleFactor);
+		const priv::geo_batch::Kernels& kernels = priv::geo_batch::GetKernels();
+		priv::geo_batch::Run(count, threadPool, [&](sl_size offset, sl_size n) {
+			kernels.getUTMLatLons(param, N + offset, E + offset, outLatitudes + offset, outLongitudes + offset, n);
+		});
+	}
+
 }
@@ -22,9 +22,14 @@
 
 #include "slib/graphics/bitmap_data.h"
 
+#include "bitmap_data_simd.h"
+
 #include "slib/graphics/yuv.h"
 #include "slib/core/base.h"
 #include "slib/core/compile_optimize.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/device/cpu.h"
 
 namespace slib
 {
@@ -3487,6 +3492,335 @@ CASES_FOR_PLANAR_YUV(CASE)
 			}
 		}
 
+		SLIB_INLINE static sl_bool GetRGBA32Order(BitmapFormat format, sl_bool& flagBGRA)
+		{
+			switch (format) {
+				case BitmapFormat::RGBA:
+				case BitmapFormat::RGBA_PA:
+					flagBGRA = sl_false;
+					return sl_true;
+				case BitmapFormat::BGRA:
+				case BitmapFormat::BGRA_PA:
+					flagBGRA = sl_true;
+					return sl_true;
+				default:
+					break;
+			}
+			return sl_false;
+		}
+
+		SLIB_INLINE static sl_bool IsNormal32(BitmapFormat format)
+		{
+			switch (format) {
+				case BitmapFormat::RGBA:
+				case BitmapFormat::BGRA:
+				case BitmapFormat::ARGB:
+				case BitmapFormat::ABGR:
+					return sl_true;
+				default:
+					break;
+			}
+			return sl_false;
+		}
+
+		// returns sl_false when the chroma samples are neither planar nor interleaved
+		static sl_bool GetYUV420Layout(ColorComponentBuffer* components, sl_bool& flagPlanar, sl_bool& flagVU)
+		{
+			if (components[0].sampleStride != 1) {
+				return sl_false;
+			}
+			sl_uint8* u = (sl_uint8*)(components[1].data);
+			sl_uint8* v = (sl_uint8*)(components[2].data);
+			if (components[1].sampleStride == 1 && components[2].sampleStride == 1) {
+				flagPlanar = sl_true;
+				flagVU = sl_false;
+				return sl_true;
+			}
+			if (components[1].sampleStride == 2 && components[2].sampleStride == 2) {
+				flagPlanar = sl_false;
+				if (v == u + 1) {
+					flagVU = sl_false;
+					return sl_true;
+				}
+				if (u == v + 1) {
+					flagVU = sl_true;
+					return sl_true;
+				}
+			}
+			return sl_false;
+		}
+
+		static sl_bool CopyPixels_YUV420ToRGBA_Accelerated(sl_uint32 width, sl_uint32 height, BitmapData& src, sl_uint8* dst, sl_reg dst_pitch, sl_bool flagBGRA)
+		{
+#if defined(SLIB_BITMAP_DATA_SUPPORT_SSE2)
+			ColorComponentBuffer components[3];
+			if (src.getColorComponentBuffers(components) != 3) {
+				return sl_false;
+			}
+			sl_bool flagPlanar, flagVU;
+			if (!(GetYUV420Layout(components, flagPlanar, flagVU))) {
+				return sl_false;
+			}
+			sl_uint32 (*funcPlanar)(sl_uint32, const sl_uint8*, const sl_uint8*, const sl_uint8*, sl_uint8*, sl_bool) = &(priv::bitmap_data::ConvertYUV420PlanarRowToRGBA_SSE2);
+			sl_uint32 (*funcInterleaved)(sl_uint32, const sl_uint8*, const sl_uint8*, sl_bool, sl_uint8*, sl_bool) = &(priv::bitmap_data::ConvertYUV420InterleavedRowToRGBA_SSE2);
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+			if (Cpu::isSupportedAVX2()) {
+				funcPlanar = &(priv::bitmap_data::ConvertYUV420PlanarRowToRGBA_AVX2);
+				funcInterleaved = &(priv::bitmap_data::ConvertYUV420InterleavedRowToRGBA_AVX2);
+			}
+#endif
+			sl_reg us = components[1].sampleStride;
+			sl_reg vs = components[2].sampleStride;
+			sl_uint8 r, g, b;
+			for (sl_uint32 i = 0; i < height; i++) {
+				sl_uint8* y = (sl_uint8*)(components[0].data) + components[0].pitch * (sl_reg)i;
+				sl_uint8* u = (sl_uint8*)(components[1].data) + components[1].pitch * (sl_reg)(i >> 1);
+				sl_uint8* v = (sl_uint8*)(components[2].data) + components[2].pitch * (sl_reg)(i >> 1);
+				sl_uint8* d = dst + dst_pitch * (sl_reg)i;
+				sl_uint32 n;
+				if (flagPlanar) {
+					n = funcPlanar(width, y, u, v, d, flagBGRA);
+				} else {
+					n = funcInterleaved(width, y, flagVU ? v : u, flagVU, d, flagBGRA);
+				}
+				d += n << 2;
+				for (sl_uint32 j = n; j < width; j++) {
+					YUV::convertYUVToRGB(y[j], u[(j >> 1) * us], v[(j >> 1) * vs], r, g, b);
+					if (flagBGRA) {
+						BGRA_PROC::writeSample(d, r, g, b, 255);
+					} else {
+						RGBA_PROC::writeSample(d, r, g, b, 255);
+					}
+					d += 4;
+				}
+			}
+			return sl_true;
+#else
+			return sl_false;
+#endif
+		}
+
+		static sl_bool CopyPixels_RGBAToYUV420_Accelerated(sl_uint32 width, sl_uint32 height, sl_uint8* src, sl_reg src_pitch, sl_bool flagBGRA, BitmapData& dst)
+		{
+#if defined(SLIB_BITMAP_DATA_SUPPORT_SSE2)
+			ColorComponentBuffer components[3];
+			if (dst.getColorComponentBuffers(components) != 3) {
+				return sl_false;
+			}
+			sl_bool flagPlanar, flagVU;
+			if (!(GetYUV420Layout(components, flagPlanar, flagVU))) {
+				return sl_false;
+			}
+			sl_uint32 uvStride = flagPlanar ? 1 : 2;
+			sl_uint32 H2 = height >> 1;
+			sl_uint8 R, G, B, A, U, V;
+			sl_uint32 TU, TV;
+			for (sl_uint32 i = 0; i < H2; i++) {
+				sl_uint8* s0 = src + src_pitch * (sl_reg)(i << 1);
+				sl_uint8* s1 = s0 + src_pitch;
+				sl_uint8* y0 = (sl_uint8*)(components[0].data) + components[0].pitch * (sl_reg)(i << 1);
+				sl_uint8* y1 = y0 + components[0].pitch;
+				sl_uint8* u = (sl_uint8*)(components[1].data) + components[1].pitch * (sl_reg)i;
+				sl_uint8* v = (sl_uint8*)(components[2].data) + components[2].pitch * (sl_reg)i;
+				sl_uint32 n = priv::bitmap_data::ConvertRGBARowsToYUV420_SSE2(width, s0, s1, flagBGRA, y0, y1, u, v, uvStride);
+				s0 += n << 2; s1 += n << 2;
+				y0 += n; y1 += n;
+				u += (n >> 1) * uvStride; v += (n >> 1) * uvStride;
+				for (sl_uint32 j = n; j < width; j += 2) {
+					TU = 0; TV = 0;
+					for (sl_uint32 k = 0; k < 2; k++) {
+						if (flagBGRA) {
+							BGRA_PROC::readSample(s0, R, G, B, A);
+						} else {
+							RGBA_PROC::readSample(s0, R, G, B, A);
+						}
+						YUV::convertRGBToYUV(R, G, B, *y0, U, V);
+						TU += U; TV += V;
+						if (flagBGRA) {
+							BGRA_PROC::readSample(s1, R, G, B, A);
+						} else {
+							RGBA_PROC::readSample(s1, R, G, B, A);
+						}
+						YUV::convertRGBToYUV(R, G, B, *y1, U, V);
+						TU += U; TV += V;
+						s0 += 4; s1 += 4; y0++; y1++;
+					}
+					*u = (sl_uint8)(TU >> 2); *v = (sl_uint8)(TV >> 2);
+					u += uvStride; v += uvStride;
+				}
+			}
+			return sl_true;
+#else
+			return sl_false;
+#endif
+		}
+
+		static sl_bool CopyPixels_RGBToRGBA_Accelerated(sl_uint32 width, sl_uint32 height, sl_uint8* src, sl_reg src_pitch, sl_uint8* dst, sl_reg dst_pitch, sl_bool flagSwapRB)
+		{
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+			if (!(Cpu::isSupportedAVX2())) {
+				return sl_false;
+			}
+			sl_uint32 ir = flagSwapRB ? 2 : 0;
+			for (sl_uint32 i = 0; i < height; i++) {
+				sl_uint8* s = src + src_pitch * (sl_reg)i;
+				sl_uint8* d = dst + dst_pitch * (sl_reg)i;
+				sl_uint32 n = priv::bitmap_data::ConvertRGBRowToRGBA_AVX2(width, s, d, flagSwapRB);
+				s += n * 3;
+				d += n << 2;
+				for (sl_uint32 j = n; j < width; j++) {
+					d[0] = s[ir];
+					d[1] = s[1];
+					d[2] = s[2 - ir];
+					d[3] = 255;
+					s += 3;
+					d += 4;
+				}
+			}
+			return sl_true;
+#else
+			return sl_false;
+#endif
+		}
+
+		static sl_bool CopyPixels_RGBAToRGB_Accelerated(sl_uint32 width, sl_uint32 height, sl_uint8* src, sl_reg src_pitch, sl_uint8* dst, sl_reg dst_pitch, sl_bool flagSwapRB)
+		{
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+			if (!(Cpu::isSupportedAVX2())) {
+				return sl_false;
+			}
+			sl_uint32 ir = flagSwapRB ? 2 : 0;
+			for (sl_uint32 i = 0; i < height; i++) {
+				sl_uint8* s = src + src_pitch * (sl_reg)i;
+				sl_uint8* d = dst + dst_pitch * (sl_reg)i;
+				sl_uint32 n = priv::bitmap_data::ConvertRGBARowToRGB_AVX2(width, s, d, flagSwapRB);
+				s += n << 2;
+				d += n * 3;
+				for (sl_uint32 j = n; j < width; j++) {
+					d[0] = s[ir];
+					d[1] = s[1];
+					d[2] = s[2 - ir];
+					s += 4;
+					d += 3;
+				}
+			}
+			return sl_true;
+#else
+			return sl_false;
+#endif
+		}
+
+		static sl_bool CopyPixels_PremultiplyAlpha_Accelerated(sl_uint32 width, sl_uint32 height, sl_uint8* src, sl_reg src_pitch, sl_uint8* dst, sl_reg dst_pitch, sl_uint32 alphaIndex)
+		{
+#if defined(SLIB_BITMAP_DATA_SUPPORT_SSE2)
+			sl_uint32 (*func)(sl_uint32, const sl_uint8*, sl_uint8*, sl_uint32) = &(priv::bitmap_data::PremultiplyAlphaRow_SSE2);
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+			if (Cpu::isSupportedAVX2()) {
+				func = &(priv::bitmap_data::PremultiplyAlphaRow_AVX2);
+			}
+#endif
+			for (sl_uint32 i = 0; i < height; i++) {
+				sl_uint8* s = src + src_pitch * (sl_reg)i;
+				sl_uint8* d = dst + dst_pitch * (sl_reg)i;
+				sl_uint32 n = func(width, s, d, alphaIndex);
+				s += n << 2;
+				d += n << 2;
+				for (sl_uint32 j = n; j < width; j++) {
+					sl_uint32 a = s[alphaIndex] + 1;
+					for (sl_uint32 k = 0; k < 4; k++) {
+						if (k == alphaIndex) {
+							d[k] = s[k];
+						} else {
+							d[k] = (sl_uint8)((s[k] * a) >> 8);
+						}
+					}
+					s += 4;
+					d += 4;
+				}
+			}
+			return sl_true;
+#else
+			return sl_false;
+#endif
+		}
+
+		static void CopyPixels_UnpremultiplyAlpha(sl_uint32 width, sl_uint32 height, sl_uint8* src, sl_reg src_pitch, sl_uint8* dst, sl_reg dst_pitch, sl_uint32 alphaIndex)
+		{
+			// (c << 8) / (a + 1) == (c * ceil(2^24 / (a + 1))) >> 16, for all c, a in [0, 255]
+			sl_uint32 reciprocals[256];
+			for (sl_uint32 a = 0; a < 256; a++) {
+				reciprocals[a] = ((1 << 24) + a) / (a + 1);
+			}
+			for (sl_uint32 i = 0; i < height; i++) {
+				sl_uint8* s = src + src_pitch * (sl_reg)i;
+				sl_uint8* d = dst + dst_pitch * (sl_reg)i;
+				for (sl_uint32 j = 0; j < width; j++) {
+					sl_uint8 a = s[alphaIndex];
+					sl_uint32 m = reciprocals[a];
+					for (sl_uint32 k = 0; k < 4; k++) {
+						if (k == alphaIndex) {
+							d[k] = a;
+						} else {
+							sl_uint32 c = (s[k] * m) >> 16;
+							d[k] = (sl_uint8)(c > 255 ? 255 : c);
+						}
+					}
+					s += 4;
+					d += 4;
+				}
+			}
+		}
+
+		// row kernels for the common conversions, returns sl_false if the pair is not accelerated on this platform
+		static sl_bool CopyPixels_Accelerated(sl_uint32 width, sl_uint32 height, BitmapData& src, BitmapData& dst)
+		{
+			BitmapFormat src_format = src.format;
+			BitmapFormat dst_format = dst.format;
+			sl_uint8* dataSrc = (sl_uint8*)(src.data);
+			sl_uint8* dataDst = (sl_uint8*)(dst.data);
+			sl_bool flagBGRA;
+			if (BitmapFormats::isYUV_420(src_format)) {
+				if (dst.sampleStride == 4 && GetRGBA32Order(dst_format, flagBGRA)) {
+					return CopyPixels_YUV420ToRGBA_Accelerated(width, height, src, dataDst, dst.pitch, flagBGRA);
+				}
+				return sl_false;
+			}
+			if (BitmapFormats::isYUV_420(dst_format)) {
+				if (src.sampleStride == 4 && (src_format == BitmapFormat::RGBA || src_format == BitmapFormat::BGRA)) {
+					return CopyPixels_RGBAToYUV420_Accelerated(width, height, dataSrc, src.pitch, src_format == BitmapFormat::BGRA, dst);
+				}
+				return sl_false;
+			}
+			if (src_format == BitmapFormat::RGB || src_format == BitmapFormat::BGR) {
+				if (src.sampleStride == 3 && dst.sampleStride == 4 && GetRGBA32Order(dst_format, flagBGRA)) {
+					return CopyPixels_RGBToRGBA_Accelerated(width, height, dataSrc, src.pitch, dataDst, dst.pitch, (src_format == BitmapFormat::BGR) != flagBGRA);
+				}
+				return sl_false;
+			}
+			if (src.sampleStride != 4 || dst.sampleStride != 4) {
+				return sl_false;
+			}
+			if (dst_format == BitmapFormat::RGB || dst_format == BitmapFormat::BGR) {
+				if (src_format == BitmapFormat::RGBA || src_format == BitmapFormat::BGRA) {
+					return CopyPixels_RGBAToRGB_Accelerated(width, height, dataSrc, src.pitch, dataDst, dst.pitch, (src_format == BitmapFormat::BGRA) != (dst_format == BitmapFormat::BGR));
+				}
+				return sl_false;
+			}
+			if (IsNormal32(src_format)) {
+				if (BitmapFormats::isPrecomputedAlpha(dst_format) && BitmapFormats::getNonPrecomputedAlphaFormat(dst_format) == src_format) {
+					sl_uint32 alphaIndex = (src_format == BitmapFormat::ARGB || src_format == BitmapFormat::ABGR) ? 0 : 3;
+					return CopyPixels_PremultiplyAlpha_Accelerated(width, height, dataSrc, src.pitch, dataDst, dst.pitch, alphaIndex);
+				}
+			} else if (IsNormal32(dst_format)) {
+				if (BitmapFormats::isPrecomputedAlpha(src_format) && BitmapFormats::getNonPrecomputedAlphaFormat(src_format) == dst_format) {
+					sl_uint32 alphaIndex = (dst_format == BitmapFormat::ARGB || dst_format == BitmapFormat::ABGR) ? 0 : 3;
+					CopyPixels_UnpremultiplyAlpha(width, height, dataSrc, src.pitch, dataDst, dst.pitch, alphaIndex);
+					return sl_true;
+				}
+			}
+			return sl_false;
+		}
+
 	}
 
 	void BitmapData::copyPixelsFrom(const BitmapData& _other) const
@@ -3535,6 +3869,10 @@ CASES_FOR_PLANAR_YUV(CASE)
 		src.fillDefaultValues();
 		dst.fillDefaultValues();
 
+		if (CopyPixels_Accelerated(width, height, src, dst)) {
+			return;
+		}
+
 #define DEFINE_SRC_COMPONENTS \
 		sl_uint8* src_planes[4]; \
 		sl_reg src_pitches[4]; \
@@ -3715,6 +4053,86 @@ CASES_FOR_PLANAR_YUV(CASE)
 		}
 	}
 
+	namespace {
+
+		static void GetBitmapBand(const BitmapData& bd, sl_uint32 row, sl_uint32 nRows, BitmapData& _out)
+		{
+			_out = bd;
+			_out.height = nRows;
+			sl_uint32 nPlanes = BitmapFormats::getPlaneCount(bd.format);
+			if (BitmapFormats::isYUV_420(bd.format)) {
+				nPlanes = (bd.format == BitmapFormat::YUV_I420 || bd.format == BitmapFormat::YUV_YV12) ? 3 : 2;
+			}
+			for (sl_uint32 i = 0; i < nPlanes; i++) {
+				sl_uint32 r = row;
+				if (i && BitmapFormats::isYUV_420(bd.format)) {
+					r >>= 1;
+				}
+				_out.planeData(i) = (sl_uint8*)(bd.planeData(i)) + bd.planePitch(i) * (sl_reg)r;
+			}
+		}
+
+	}
+
+	void BitmapData::copyPixelsFrom(const BitmapData& other, ThreadPool* threadPool, sl_uint32 nBands) const
+	{
+		sl_uint32 nRows = SLIB_MIN(height, other.height);
+		if (!threadPool) {
+			copyPixelsFrom(other);
+			return;
+		}
+		if (!nBands) {
+			nBands = Cpu::getCoreCount();
+		}
+		sl_uint32 nRowsPerBand = (nRows + nBands - 1) / nBands;
+		if (nRowsPerBand < 32) {
+			nRowsPerBand = 32;
+		}
+		// bands of YUV 4:2:0 must start at even rows
+		nRowsPerBand = (nRowsPerBand + 1) & 0xFFFFFFFE;
+		if (nRowsPerBand >= nRows) {
+			copyPixelsFrom(other);
+			return;
+		}
+		BitmapData src(other);
+		BitmapData dst(*this);
+		if (BitmapFormats::isYUV_420(src.format) || BitmapFormats::isYUV_420(dst.format)) {
+			if ((src.width | src.height | dst.width | dst.height) & 1) {
+				return;
+			}
+		}
+		src.fillDefaultValues();
+		dst.fillDefaultValues();
+
+		sl_int32 nRemaining = (sl_int32)((nRows + nRowsPerBand - 1) / nRowsPerBand) - 1;
+		volatile sl_int32* pRemaining = &nRemaining;
+		Ref<Event> event = Event::create(sl_false);
+		if (event.isNull()) {
+			copyPixelsFrom(other);
+			return;
+		}
+		for (sl_uint32 row = nRowsPerBand; row < nRows; row += nRowsPerBand) {
+			sl_uint32 n = SLIB_MIN(nRowsPerBand, nRows - row);
+			BitmapData bandSrc, bandDst;
+			GetBitmapBand(src, row, n, bandSrc);
+			GetBitmapBand(dst, row, n, bandDst);
+			auto task = [bandSrc, bandDst, pRemaining, event]() {
+				bandDst.copyPixelsFrom(bandSrc);
+				if (!(Base::interlockedDecrement32(pRemaining))) {
+					event->set();
+				}
+			};
+			if (!(threadPool->addTask(task))) {
+				task();
+			}
+		}
+		BitmapData bandSrc, bandDst;
+		GetBitmapBand(src, 0, nRowsPerBand, bandSrc);
+		GetBitmapBand(dst, 0, nRowsPerBand, bandDst);
+		bandDst.copyPixelsFrom(bandSrc);
+		event->wait();
+	}
+
 	void BitmapData::setFromColors(sl_uint32 _width, sl_uint32 _height, const Color* colors, sl_reg stride)
 	{
 		width = _width;
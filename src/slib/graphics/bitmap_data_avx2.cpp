@@ -0,0 +1,227 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "bitmap_data_simd.h"
+
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+
+#include <immintrin.h>
+
+#define YUV_YG 18997
+#define YUV_BB (-128 * 128 - 1160)
+#define YUV_BG (25 * 128 + 52 * 128 - 1160)
+#define YUV_BR (-102 * 128 - 1160)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace bitmap_data
+		{
+
+			namespace {
+
+				class YUVToRGBConstants
+				{
+				public:
+					__m256i zero;
+					__m256i alpha;
+					__m256i yg;
+					__m256i bb;
+					__m256i bg;
+					__m256i br;
+					__m256i ub;
+					__m256i uvg;
+					__m256i vr;
+
+				public:
+					YUVToRGBConstants(sl_bool flagVU)
+					{
+						zero = _mm256_setzero_si256();
+						alpha = _mm256_set1_epi8((char)255);
+						yg = _mm256_set1_epi16(YUV_YG);
+						bb = _mm256_set1_epi32(YUV_BB);
+						bg = _mm256_set1_epi32(YUV_BG);
+						br = _mm256_set1_epi32(YUV_BR);
+						if (flagVU) {
+							ub = _mm256_set1_epi32(128 << 16);
+							uvg = _mm256_set1_epi32((sl_int32)((sl_uint32)(-25) << 16) | (sl_uint16)(-52));
+							vr = _mm256_set1_epi32(102);
+						} else {
+							ub = _mm256_set1_epi32(128);
+							uvg = _mm256_set1_epi32((sl_int32)((sl_uint32)(-52) << 16) | (sl_uint16)(-25));
+							vr = _mm256_set1_epi32(102 << 16);
+						}
+					}
+
+				};
+
+				SLIB_INLINE static __m256i ComputeChannel(__m256i yl, __m256i yh, __m256i c, __m256i bias)
+				{
+					__m256i l = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(yl, bias), _mm256_unpacklo_epi32(c, c)), 6);
+					__m256i h = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(yh, bias), _mm256_unpackhi_epi32(c, c)), 6);
+					__m256i v = _mm256_packs_epi32(l, h);
+					return _mm256_packus_epi16(v, v);
+				}
+
+				// converts 16 pixels; `y`, `uv`: 16-bit lanes
+				SLIB_INLINE static void ConvertYUV16(const YUVToRGBConstants& k, __m256i y, __m256i uv, sl_uint8* dst, sl_bool flagBGRA)
+				{
+					y = _mm256_or_si256(y, _mm256_slli_epi16(y, 8));
+					y = _mm256_mulhi_epu16(y, k.yg);
+					// unpacking works inside 128-bit lanes: `yl` holds pixels 0~3 and 8~11, `yh` holds 4~7 and 12~15
+					__m256i yl = _mm256_unpacklo_epi16(y, k.zero);
+					__m256i yh = _mm256_unpackhi_epi16(y, k.zero);
+					__m256i b = ComputeChannel(yl, yh, _mm256_madd_epi16(uv, k.ub), k.bb);
+					__m256i g = ComputeChannel(yl, yh, _mm256_madd_epi16(uv, k.uvg), k.bg);
+					__m256i r = ComputeChannel(yl, yh, _mm256_madd_epi16(uv, k.vr), k.br);
+					__m256i c01, c23;
+					if (flagBGRA) {
+						c01 = _mm256_unpacklo_epi8(b, g);
+						c23 = _mm256_unpacklo_epi8(r, k.alpha);
+					} else {
+						c01 = _mm256_unpacklo_epi8(r, g);
+						c23 = _mm256_unpacklo_epi8(b, k.alpha);
+					}
+					__m256i l = _mm256_unpacklo_epi16(c01, c23);
+					__m256i h = _mm256_unpackhi_epi16(c01, c23);
+					_mm256_storeu_si256((__m256i*)dst, _mm256_permute2x128_si256(l, h, 0x20));
+					_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_permute2x128_si256(l, h, 0x31));
+				}
+
+				template <sl_uint32 ALPHA_INDEX>
+				SLIB_INLINE static __m256i BroadcastAlpha(__m256i v)
+				{
+					v = _mm256_shufflelo_epi16(v, _MM_SHUFFLE(ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX));
+					return _mm256_shufflehi_epi16(v, _MM_SHUFFLE(ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX));
+				}
+
+				template <sl_uint32 ALPHA_INDEX>
+				static sl_uint32 PremultiplyAlphaRow(sl_uint32 width, const sl_uint8* src, sl_uint8* dst)
+				{
+					__m256i zero = _mm256_setzero_si256();
+					__m256i one = _mm256_set1_epi16(1);
+					__m256i mask = _mm256_set1_epi32((sl_int32)(0xFFu << (ALPHA_INDEX << 3)));
+					sl_uint32 i = 0;
+					for (; i + 8 <= width; i += 8) {
+						__m256i px = _mm256_loadu_si256((const __m256i*)src);
+						__m256i l = _mm256_unpacklo_epi8(px, zero);
+						__m256i h = _mm256_unpackhi_epi8(px, zero);
+						l = _mm256_srli_epi16(_mm256_mullo_epi16(l, _mm256_add_epi16(BroadcastAlpha<ALPHA_INDEX>(l), one)), 8);
+						h = _mm256_srli_epi16(_mm256_mullo_epi16(h, _mm256_add_epi16(BroadcastAlpha<ALPHA_INDEX>(h), one)), 8);
+						__m256i ret = _mm256_packus_epi16(l, h);
+						ret = _mm256_blendv_epi8(ret, px, mask);
+						_mm256_storeu_si256((__m256i*)dst, ret);
+						src += 32;
+						dst += 32;
+					}
+					return i;
+				}
+
+			}
+
+			sl_uint32 ConvertYUV420PlanarRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* y, const sl_uint8* u, const sl_uint8* v, sl_uint8* dst, sl_bool flagBGRA)
+			{
+				YUVToRGBConstants k(sl_false);
+				sl_uint32 i = 0;
+				for (; i + 16 <= width; i += 16) {
+					__m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)u), _mm_loadl_epi64((const __m128i*)v));
+					ConvertYUV16(k, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)y)), _mm256_cvtepu8_epi16(c), dst, flagBGRA);
+					y += 16;
+					u += 8;
+					v += 8;
+					dst += 64;
+				}
+				return i;
+			}
+
+			sl_uint32 ConvertYUV420InterleavedRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* y, const sl_uint8* uv, sl_bool flagVU, sl_uint8* dst, sl_bool flagBGRA)
+			{
+				YUVToRGBConstants k(flagVU);
+				sl_uint32 i = 0;
+				for (; i + 16 <= width; i += 16) {
+					__m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)uv));
+					ConvertYUV16(k, _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)y)), c, dst, flagBGRA);
+					y += 16;
+					uv += 16;
+					dst += 64;
+				}
+				return i;
+			}
+
+			sl_uint32 ConvertRGBRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_bool flagSwapRB)
+			{
+				__m256i shuffle;
+				if (flagSwapRB) {
+					shuffle = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+				} else {
+					shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+				}
+				__m256i alpha = _mm256_set1_epi32((sl_int32)0xFF000000);
+				sl_uint32 i = 0;
+				// the upper lane reads 4 bytes beyond the 8 pixels
+				for (; i + 10 <= width; i += 8) {
+					__m256i px = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)), _mm_loadu_si128((const __m128i*)(src + 12)), 1);
+					_mm256_storeu_si256((__m256i*)dst, _mm256_or_si256(_mm256_shuffle_epi8(px, shuffle), alpha));
+					src += 24;
+					dst += 32;
+				}
+				return i;
+			}
+
+			sl_uint32 ConvertRGBARowToRGB_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_bool flagSwapRB)
+			{
+				__m256i shuffle;
+				if (flagSwapRB) {
+					shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+				} else {
+					shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+				}
+				sl_uint32 i = 0;
+				// each lane writes 4 bytes beyond its 4 pixels
+				for (; i + 10 <= width; i += 8) {
+					__m256i px = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), shuffle);
+					_mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(px));
+					_mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(px, 1));
+					src += 32;
+					dst += 24;
+				}
+				return i;
+			}
+
+			sl_uint32 PremultiplyAlphaRow_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_uint32 alphaIndex)
+			{
+				if (alphaIndex) {
+					return PremultiplyAlphaRow<3>(width, src, dst);
+				} else {
+					return PremultiplyAlphaRow<0>(width, src, dst);
+				}
+			}
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_GRAPHICS_BITMAP_DATA_SIMD
+#define CHECKHEADER_SLIB_GRAPHICS_BITMAP_DATA_SIMD
+
+#include "slib/graphics/definition.h"
+
+#if defined(SLIB_ARCH_IS_X64)
+#	define SLIB_BITMAP_DATA_SUPPORT_SSE2
+#	if !defined(SLIB_PLATFORM_IS_MOBILE)
+#		define SLIB_BITMAP_DATA_SUPPORT_AVX2
+#	endif
+#endif
+
+/*
+	Row kernels for the common pixel format conversions.
+	Every kernel converts the leading part of the row and returns the number of processed pixels; the caller converts the rest.
+	The results are identical to `YUV::convertYUVToRGB`, `YUV::convertRGBToYUV` and `Color::convertNPAtoPA`.
+*/
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace bitmap_data
+		{
+
+#if defined(SLIB_BITMAP_DATA_SUPPORT_SSE2)
+			// `u`, `v`: planar chroma samples
+			sl_uint32 ConvertYUV420PlanarRowToRGBA_SSE2(sl_uint32 width, const sl_uint8* y, const sl_uint8* u, const sl_uint8* v, sl_uint8* dst, sl_bool flagBGRA);
+
+			// `uv`: interleaved chroma samples (NV12: UVUV..., NV21: VUVU...)
+			sl_uint32 ConvertYUV420InterleavedRowToRGBA_SSE2(sl_uint32 width, const sl_uint8* y, const sl_uint8* uv, sl_bool flagVU, sl_uint8* dst, sl_bool flagBGRA);
+
+			// converts two rows; `uvStride` is 1 for planar and 2 for interleaved chroma
+			sl_uint32 ConvertRGBARowsToYUV420_SSE2(sl_uint32 width, const sl_uint8* src0, const sl_uint8* src1, sl_bool flagBGRA, sl_uint8* y0, sl_uint8* y1, sl_uint8* u, sl_uint8* v, sl_uint32 uvStride);
+
+			// `alphaIndex`: 3 for RGBA/BGRA, 0 for ARGB/ABGR
+			sl_uint32 PremultiplyAlphaRow_SSE2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_uint32 alphaIndex);
+#endif
+
+#if defined(SLIB_BITMAP_DATA_SUPPORT_AVX2)
+			sl_uint32 ConvertYUV420PlanarRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* y, const sl_uint8* u, const sl_uint8* v, sl_uint8* dst, sl_bool flagBGRA);
+
+			sl_uint32 ConvertYUV420InterleavedRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* y, const sl_uint8* uv, sl_bool flagVU, sl_uint8* dst, sl_bool flagBGRA);
+
+			// RGB/BGR -> RGBA/BGRA with opaque alpha
+			sl_uint32 ConvertRGBRowToRGBA_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_bool flagSwapRB);
+
+			// RGBA/BGRA -> RGB/BGR
+			sl_uint32 ConvertRGBARowToRGB_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_bool flagSwapRB);
+
+			sl_uint32 PremultiplyAlphaRow_AVX2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_uint32 alphaIndex);
+#endif
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "bitmap_data_simd.h"
+
+#if defined(SLIB_BITMAP_DATA_SUPPORT_SSE2)
+
+#include "slib/core/base.h"
+
+#include <emmintrin.h>
+
+#define YUV_YG 18997
+#define YUV_BB (-128 * 128 - 1160)
+#define YUV_BG (25 * 128 + 52 * 128 - 1160)
+#define YUV_BR (-102 * 128 - 1160)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace bitmap_data
+		{
+
+			namespace {
+
+				SLIB_INLINE static __m128i Load32(const sl_uint8* p)
+				{
+					sl_int32 n;
+					Base::copyMemory(&n, p, 4);
+					return _mm_cvtsi32_si128(n);
+				}
+
+				SLIB_INLINE static void Store32(sl_uint8* p, __m128i v)
+				{
+					sl_int32 n = _mm_cvtsi128_si32(v);
+					Base::copyMemory(p, &n, 4);
+				}
+
+				class YUVToRGBConstants
+				{
+				public:
+					__m128i zero;
+					__m128i alpha;
+					__m128i yg;
+					__m128i bb;
+					__m128i bg;
+					__m128i br;
+					// multipliers for (U, V) pairs
+					__m128i ub;
+					__m128i uvg;
+					__m128i vr;
+
+				public:
+					YUVToRGBConstants(sl_bool flagVU)
+					{
+						zero = _mm_setzero_si128();
+						alpha = _mm_set1_epi8((char)255);
+						yg = _mm_set1_epi16(YUV_YG);
+						bb = _mm_set1_epi32(YUV_BB);
+						bg = _mm_set1_epi32(YUV_BG);
+						br = _mm_set1_epi32(YUV_BR);
+						if (flagVU) {
+							ub = _mm_set1_epi32(128 << 16);
+							uvg = _mm_set1_epi32((sl_int32)((sl_uint32)(-25) << 16) | (sl_uint16)(-52));
+							vr = _mm_set1_epi32(102);
+						} else {
+							ub = _mm_set1_epi32(128);
+							uvg = _mm_set1_epi32((sl_int32)((sl_uint32)(-52) << 16) | (sl_uint16)(-25));
+							vr = _mm_set1_epi32(102 << 16);
+						}
+					}
+
+				};
+
+				SLIB_INLINE static __m128i ComputeChannel(__m128i yl, __m128i yh, __m128i c, __m128i bias)
+				{
+					__m128i l = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(yl, bias), _mm_unpacklo_epi32(c, c)), 6);
+					__m128i h = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(yh, bias), _mm_unpackhi_epi32(c, c)), 6);
+					__m128i v = _mm_packs_epi32(l, h);
+					return _mm_packus_epi16(v, v);
+				}
+
+				// converts 8 pixels; `uv`: 4 chroma pairs in 16-bit lanes
+				SLIB_INLINE static void ConvertYUV8(const YUVToRGBConstants& k, __m128i y, __m128i uv, sl_uint8* dst, sl_bool flagBGRA)
+				{
+					y = _mm_unpacklo_epi8(y, k.zero);
+					y = _mm_or_si128(y, _mm_slli_epi16(y, 8));
+					y = _mm_mulhi_epu16(y, k.yg);
+					__m128i yl = _mm_unpacklo_epi16(y, k.zero);
+					__m128i yh = _mm_unpackhi_epi16(y, k.zero);
+					__m128i b = ComputeChannel(yl, yh, _mm_madd_epi16(uv, k.ub), k.bb);
+					__m128i g = ComputeChannel(yl, yh, _mm_madd_epi16(uv, k.uvg), k.bg);
+					__m128i r = ComputeChannel(yl, yh, _mm_madd_epi16(uv, k.vr), k.br);
+					__m128i c01, c23;
+					if (flagBGRA) {
+						c01 = _mm_unpacklo_epi8(b, g);
+						c23 = _mm_unpacklo_epi8(r, k.alpha);
+					} else {
+						c01 = _mm_unpacklo_epi8(r, g);
+						c23 = _mm_unpacklo_epi8(b, k.alpha);
+					}
+					_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(c01, c23));
+					_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(c01, c23));
+				}
+
+				// returns the dot products of 4 pixels and `coef`
+				SLIB_INLINE static __m128i Dot4(__m128i px, __m128i coef, __m128i zero)
+				{
+					__m128 l = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coef));
+					__m128 h = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coef));
+					__m128i a = _mm_castps_si128(_mm_shuffle_ps(l, h, _MM_SHUFFLE(2, 0, 2, 0)));
+					__m128i b = _mm_castps_si128(_mm_shuffle_ps(l, h, _MM_SHUFFLE(3, 1, 3, 1)));
+					return _mm_add_epi32(a, b);
+				}
+
+				// sums horizontally adjacent pairs of the 8 values in `a` and `b`
+				SLIB_INLINE static __m128i SumPairs(__m128i a, __m128i b)
+				{
+					__m128 l = _mm_castsi128_ps(a);
+					__m128 h = _mm_castsi128_ps(b);
+					return _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(l, h, _MM_SHUFFLE(2, 0, 2, 0))), _mm_castps_si128(_mm_shuffle_ps(l, h, _MM_SHUFFLE(3, 1, 3, 1))));
+				}
+
+				template <sl_uint32 ALPHA_INDEX>
+				SLIB_INLINE static __m128i BroadcastAlpha(__m128i v)
+				{
+					v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX));
+					return _mm_shufflehi_epi16(v, _MM_SHUFFLE(ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX, ALPHA_INDEX));
+				}
+
+				template <sl_uint32 ALPHA_INDEX>
+				static sl_uint32 PremultiplyAlphaRow(sl_uint32 width, const sl_uint8* src, sl_uint8* dst)
+				{
+					__m128i zero = _mm_setzero_si128();
+					__m128i one = _mm_set1_epi16(1);
+					__m128i mask = _mm_set1_epi32((sl_int32)(0xFFu << (ALPHA_INDEX << 3)));
+					sl_uint32 i = 0;
+					for (; i + 4 <= width; i += 4) {
+						__m128i px = _mm_loadu_si128((const __m128i*)src);
+						__m128i l = _mm_unpacklo_epi8(px, zero);
+						__m128i h = _mm_unpackhi_epi8(px, zero);
+						l = _mm_srli_epi16(_mm_mullo_epi16(l, _mm_add_epi16(BroadcastAlpha<ALPHA_INDEX>(l), one)), 8);
+						h = _mm_srli_epi16(_mm_mullo_epi16(h, _mm_add_epi16(BroadcastAlpha<ALPHA_INDEX>(h), one)), 8);
+						__m128i ret = _mm_packus_epi16(l, h);
+						ret = _mm_or_si128(_mm_andnot_si128(mask, ret), _mm_and_si128(mask, px));
+						_mm_storeu_si128((__m128i*)dst, ret);
+						src += 16;
+						dst += 16;
+					}
+					return i;
+				}
+
+			}
+
+			sl_uint32 ConvertYUV420PlanarRowToRGBA_SSE2(sl_uint32 width, const sl_uint8* y, const sl_uint8* u, const sl_uint8* v, sl_uint8* dst, sl_bool flagBGRA)
+			{
+				YUVToRGBConstants k(sl_false);
+				sl_uint32 i = 0;
+				for (; i + 8 <= width; i += 8) {
+					__m128i uv = _mm_unpacklo_epi8(_mm_unpacklo_epi8(Load32(u), Load32(v)), k.zero);
+					ConvertYUV8(k, _mm_loadl_epi64((const __m128i*)y), uv, dst, flagBGRA);
+					y += 8;
+					u += 4;
+					v += 4;
+					dst += 32;
+				}
+				return i;
+			}
+
+			sl_uint32 ConvertYUV420InterleavedRowToRGBA_SSE2(sl_uint32 width, const sl_uint8* y, const sl_uint8* uv, sl_bool flagVU, sl_uint8* dst, sl_bool flagBGRA)
+			{
+				YUVToRGBConstants k(flagVU);
+				sl_uint32 i = 0;
+				for (; i + 8 <= width; i += 8) {
+					__m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)uv), k.zero);
+					ConvertYUV8(k, _mm_loadl_epi64((const __m128i*)y), c, dst, flagBGRA);
+					y += 8;
+					uv += 8;
+					dst += 32;
+				}
+				return i;
+			}
+
+			sl_uint32 ConvertRGBARowsToYUV420_SSE2(sl_uint32 width, const sl_uint8* src0, const sl_uint8* src1, sl_bool flagBGRA, sl_uint8* y0, sl_uint8* y1, sl_uint8* u, sl_uint8* v, sl_uint32 uvStride)
+			{
+				__m128i zero = _mm_setzero_si128();
+				__m128i cy, cu, cv;
+				if (flagBGRA) {
+					cy = _mm_setr_epi16(25, 129, 66, 0, 25, 129, 66, 0);
+					cu = _mm_setr_epi16(112, -74, -38, 0, 112, -74, -38, 0);
+					cv = _mm_setr_epi16(-18, -94, 112, 0, -18, -94, 112, 0);
+				} else {
+					cy = _mm_setr_epi16(66, 129, 25, 0, 66, 129, 25, 0);
+					cu = _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+					cv = _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+				}
+				__m128i biasY = _mm_set1_epi32(0x1080);
+				__m128i biasUV = _mm_set1_epi32(0x8080);
+				sl_uint32 i = 0;
+				for (; i + 8 <= width; i += 8) {
+					__m128i a0 = _mm_loadu_si128((const __m128i*)src0);
+					__m128i b0 = _mm_loadu_si128((const __m128i*)(src0 + 16));
+					__m128i a1 = _mm_loadu_si128((const __m128i*)src1);
+					__m128i b1 = _mm_loadu_si128((const __m128i*)(src1 + 16));
+					__m128i t = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(a0, cy, zero), biasY), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(b0, cy, zero), biasY), 8));
+					_mm_storel_epi64((__m128i*)y0, _mm_packus_epi16(t, t));
+					t = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(a1, cy, zero), biasY), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(b1, cy, zero), biasY), 8));
+					_mm_storel_epi64((__m128i*)y1, _mm_packus_epi16(t, t));
+					// chroma is the average of the chroma of 2x2 pixels
+					__m128i sa = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(a0, cu, zero), biasUV), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(a1, cu, zero), biasUV), 8));
+					__m128i sb = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(b0, cu, zero), biasUV), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(b1, cu, zero), biasUV), 8));
+					__m128i cU = _mm_srli_epi32(SumPairs(sa, sb), 2);
+					sa = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(a0, cv, zero), biasUV), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(a1, cv, zero), biasUV), 8));
+					sb = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(Dot4(b0, cv, zero), biasUV), 8), _mm_srai_epi32(_mm_add_epi32(Dot4(b1, cv, zero), biasUV), 8));
+					__m128i cV = _mm_srli_epi32(SumPairs(sa, sb), 2);
+					cU = _mm_packs_epi32(cU, cU);
+					cU = _mm_packus_epi16(cU, cU);
+					cV = _mm_packs_epi32(cV, cV);
+					cV = _mm_packus_epi16(cV, cV);
+					if (uvStride == 1) {
+						Store32(u, cU);
+						Store32(v, cV);
+						u += 4;
+						v += 4;
+					} else {
+						sl_uint32 nU = (sl_uint32)(_mm_cvtsi128_si32(cU));
+						sl_uint32 nV = (sl_uint32)(_mm_cvtsi128_si32(cV));
+						for (sl_uint32 k = 0; k < 4; k++) {
+							*u = (sl_uint8)nU;
+							*v = (sl_uint8)nV;
+							nU >>= 8;
+							nV >>= 8;
+							u += uvStride;
+							v += uvStride;
+						}
+					}
+					src0 += 32;
+					src1 += 32;
+					y0 += 8;
+					y1 += 8;
+				}
+				return i;
+			}
+
+			sl_uint32 PremultiplyAlphaRow_SSE2(sl_uint32 width, const sl_uint8* src, sl_uint8* dst, sl_uint32 alphaIndex)
+			{
+				if (alphaIndex) {
+					return PremultiplyAlphaRow<3>(width, src, dst);
+				} else {
+					return PremultiplyAlphaRow<0>(width, src, dst);
+				}
+			}
+
+		}
+	}
+
+}
+
+#endif
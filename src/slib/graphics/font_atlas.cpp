@@ -24,12 +24,15 @@
 
 #include "slib/graphics/image.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/scoped_buffer.h"
 
 #define PLANE_SIZE_MIN 32
 #define PLANE_WIDTH_DEFAULT 0
 #define PLANE_HEIGHT_DEFAULT 0
 #define MAX_PLANES_DEFAULT 16
+#define DISTANCE_FIELD_SPREAD_DEFAULT 4
 #define FONT_SIZE_MIN 4
+#define DISTANCE_INFINITE 1e20f
 
 namespace slib
 {
@@ -51,7 +54,7 @@ namespace slib
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(FontAtlasBaseParam)
 
-	FontAtlasBaseParam::FontAtlasBaseParam(): color(Color::White), scale(1.0f), strokeWidth(0.0f), planeWidth(PLANE_WIDTH_DEFAULT), planeHeight(PLANE_HEIGHT_DEFAULT), maxPlanes(MAX_PLANES_DEFAULT)
+	FontAtlasBaseParam::FontAtlasBaseParam(): color(Color::White), scale(1.0f), strokeWidth(0.0f), planeWidth(PLANE_WIDTH_DEFAULT), planeHeight(PLANE_HEIGHT_DEFAULT), maxPlanes(MAX_PLANES_DEFAULT), flagSignedDistanceField(sl_false), distanceFieldSpread(DISTANCE_FIELD_SPREAD_DEFAULT)
 	{
 	}
 
@@ -73,17 +76,113 @@ namespace slib
 		m_planeWidth = PLANE_WIDTH_DEFAULT;
 		m_planeHeight = PLANE_HEIGHT_DEFAULT;
 		m_maxPlanes = MAX_PLANES_DEFAULT;
+		m_flagSignedDistanceField = sl_false;
+		m_distanceFieldSpread = DISTANCE_FIELD_SPREAD_DEFAULT;
 
-		m_countPlanes = 0;
-		m_currentPlaneY = 0;
-		m_currentPlaneX = 0;
-		m_currentPlaneRowHeight = 0;
+		m_clock = 0;
 	}
 
 	FontAtlas::~FontAtlas()
 	{
 	}
 
+	FontAtlas::Plane::Plane(const Ref<Bitmap>& _bitmap, sl_uint32 width): bitmap(_bitmap), lastUsed(0)
+	{
+		reset(width);
+	}
+
+	sl_bool FontAtlas::Plane::findPosition(sl_uint32 width, sl_uint32 height, sl_uint32 planeWidth, sl_uint32 planeHeight, sl_uint32& outX, sl_uint32& outY)
+	{
+		SkylineSegment* segments = skyline.getData();
+		sl_size n = skyline.getCount();
+		sl_bool flagFound = sl_false;
+		sl_uint32 bestY = 0;
+		sl_uint32 bestWidth = 0;
+		for (sl_size i = 0; i < n; i++) {
+			sl_uint32 x = segments[i].x;
+			if (x + width > planeWidth) {
+				break;
+			}
+			// the top of the region is the highest segment under it
+			sl_uint32 y = 0;
+			sl_uint32 widthLeft = width;
+			for (sl_size j = i; j < n; j++) {
+				if (segments[j].y > y) {
+					y = segments[j].y;
+				}
+				if (segments[j].width >= widthLeft) {
+					break;
+				}
+				widthLeft -= segments[j].width;
+			}
+			if (y + height > planeHeight) {
+				continue;
+			}
+			if (!flagFound || y < bestY || (y == bestY && segments[i].width < bestWidth)) {
+				flagFound = sl_true;
+				outX = x;
+				outY = y;
+				bestY = y;
+				bestWidth = segments[i].width;
+			}
+		}
+		return flagFound;
+	}
+
+	void FontAtlas::Plane::addRegion(sl_uint32 x, sl_uint32 y, sl_uint32 width, sl_uint32 height)
+	{
+		sl_size n = skyline.getCount();
+		sl_size index = 0;
+		while (index < n && skyline.getData()[index].x != x) {
+			index++;
+		}
+		SkylineSegment segment;
+		segment.x = x;
+		segment.y = y + height;
+		segment.width = width;
+		if (!(skyline.insert_NoLock(index, segment))) {
+			return;
+		}
+		// shrinks the segments under the new one
+		sl_uint32 right = x + width;
+		sl_size i = index + 1;
+		while (i < skyline.getCount()) {
+			SkylineSegment& next = skyline.getData()[i];
+			if (next.x >= right) {
+				break;
+			}
+			if (next.x + next.width <= right) {
+				skyline.removeAt_NoLock(i);
+			} else {
+				next.width -= right - next.x;
+				next.x = right;
+				break;
+			}
+		}
+		// merges the neighbors at the same height
+		i = 1;
+		while (i < skyline.getCount()) {
+			SkylineSegment* segments = skyline.getData();
+			if (segments[i - 1].y == segments[i].y) {
+				segments[i - 1].width += segments[i].width;
+				skyline.removeAt_NoLock(i);
+			} else {
+				i++;
+			}
+		}
+	}
+
+	void FontAtlas::Plane::reset(sl_uint32 width)
+	{
+		SkylineSegment segment;
+		segment.x = 0;
+		segment.y = 0;
+		segment.width = width;
+		skyline.removeAll_NoLock();
+		skyline.add_NoLock(segment);
+		chars.removeAll_NoLock();
+	}
+
 	namespace
 	{
 		typedef CHashMap< String, WeakRef<FontAtlas> > FontAtlasMap;
@@ -151,7 +250,7 @@ namespace slib
 					return sl_null;
 				}
 				sl_real fontSize = param.font->getSize();
-				if (fontSize > param.maximumFontSize) {
+				if (param.flagSignedDistanceField || fontSize > param.maximumFontSize) {
 					fontSize = param.maximumFontSize;
 				}
 				if (fontSize < FONT_SIZE_MIN) {
@@ -182,22 +281,12 @@ namespace slib
 				if (planeHeight < PLANE_SIZE_MIN) {
 					planeHeight = PLANE_SIZE_MIN;
 				}
-				Ref<Bitmap> plane = Bitmap::create(planeWidth, planeHeight);
-				if (plane.isNull()) {
-					return sl_null;
-				}
-				Ref<Canvas> canvas = plane->getCanvas();
-				if (canvas.isNull()) {
-					return sl_null;
-				}
 				Ref<FontAtlasImpl> ret = new FontAtlasImpl;
 				if (ret.isNull()) {
 					return sl_null;
 				}
 				ret->_initialize(param, sourceHeight, fontHeight, strokeWidth, planeWidth, planeHeight);
 				ret->m_font = Move(font);
-				ret->m_currentPlane = Move(plane);
-				ret->m_currentCanvas = Move(canvas);
 				return ret;
 			}
 
@@ -246,9 +335,17 @@ namespace slib
 				return m_font->measureChar(ch, _out);
 			}
 
-			Ref<Bitmap> _drawChar(sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) override
+			sl_bool _drawChar(Bitmap* plane, sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) override
 			{
-				m_currentPlane->resetPixels(dstX, dstY, width, height, Color::zero());
+				if (m_currentPlane != plane) {
+					Ref<Canvas> canvas = plane->getCanvas();
+					if (canvas.isNull()) {
+						return sl_false;
+					}
+					m_currentPlane = plane;
+					m_currentCanvas = Move(canvas);
+				}
+				plane->resetPixels(dstX, dstY, width, height, Color::zero());
 				Canvas::DrawTextParam param;
 				param.text = String::create(&ch, 1);
 				param.x = charX;
@@ -258,23 +355,13 @@ namespace slib
 				param.strokeColor = m_strokeColor;
 				param.strokeWidth = m_strokeWidth;
 				m_currentCanvas->drawText(param);
-				m_currentPlane->update(dstX, dstY, width, height);
-				return m_currentPlane;
+				plane->update(dstX, dstY, width, height);
+				return sl_true;
 			}
 
-			sl_bool _createPlane() override
+			Ref<Bitmap> _createPlane() override
 			{
-				Ref<Bitmap> plane = Bitmap::create(m_planeWidth, m_planeHeight);
-				if (plane.isNull()) {
-					return sl_false;
-				}
-				Ref<Canvas> canvas = plane->getCanvas();
-				if (canvas.isNull()) {
-					return sl_false;
-				}
-				m_currentPlane = Move(plane);
-				m_currentCanvas = Move(canvas);
-				return sl_true;
+				return Bitmap::create(m_planeWidth, m_planeHeight);
 			}
 		};
 	}
@@ -299,9 +386,18 @@ namespace slib
 		m_textColor = param.color;
 		m_strokeColor = param.strokeColor;
 		m_strokeWidth = strokeWidth;
+		if (param.flagSignedDistanceField) {
+			m_flagSignedDistanceField = sl_true;
+			m_distanceFieldSpread = param.distanceFieldSpread;
+			if (!(param.planeHeight)) {
+				planeHeight += m_distanceFieldSpread << 1;
+			}
+			m_textColor = Color::White;
+			m_strokeColor = Color::zero();
+			m_strokeWidth = 0.0f;
+		}
 		m_planeWidth = planeWidth;
 		m_planeHeight = planeHeight;
-		m_countPlanes = 1;
 		sl_uint32 maxPlanes = param.maxPlanes;
 		if (maxPlanes < 1) {
 			maxPlanes = 1;
@@ -323,82 +419,285 @@ namespace slib
 			}
 			return sl_true;
 		}
+		if (_getDirectChar(ch, flagSizeOnly, _out)) {
+			return sl_true;
+		}
+		m_clock++;
 		sl_real charX, charY;
 		sl_uint32 widthChar, heightChar;
-		if (m_map.get_NoLock(ch, &_out)) {
-			if (_out.metrics.advanceX == 0.0f) {
+		Glyph glyph;
+		if (m_map.get_NoLock(ch, &glyph)) {
+			if (glyph.metrics.advanceX == 0.0f) {
+				_out = glyph;
 				return sl_false;
 			}
-			if (flagSizeOnly) {
-				return sl_true;
-			}
-			if (_out.bitmap.isNotNull()) {
+			if (flagSizeOnly || glyph.bitmap.isNotNull()) {
+				if (glyph.plane.isNotNull()) {
+					glyph.plane->lastUsed = m_clock;
+				}
+				_out = glyph;
 				return sl_true;
 			}
-			charX = _out.metrics.left / m_drawScale;
-			charY = _out.metrics.top / m_drawScale;
-			widthChar = (sl_int32)(Math::ceil(_out.metrics.getWidth() / m_drawScale));
-			heightChar = (sl_int32)(Math::ceil(_out.metrics.getHeight() / m_drawScale));
+			charX = glyph.metrics.left / m_drawScale;
+			charY = glyph.metrics.top / m_drawScale;
+			widthChar = (sl_int32)(Math::ceil(glyph.metrics.getWidth() / m_drawScale));
+			heightChar = (sl_int32)(Math::ceil(glyph.metrics.getHeight() / m_drawScale));
 		} else {
 			TextMetrics tm;
 			if (!(_measureChar(ch, tm))) {
-				_out.metrics.setZero();
-				m_map.put_NoLock(ch, _out);
+				glyph.metrics.setZero();
+				m_map.put_NoLock(ch, glyph);
+				_out = glyph;
 				return sl_false;
 			}
 			sl_real m = m_strokeColor.isNotZero() ? (m_strokeWidth + 2.0f) : 2.0f;
+			if (m_flagSignedDistanceField) {
+				m += (sl_real)m_distanceFieldSpread;
+			}
 			tm.left -= m;
 			tm.top -= m;
 			tm.right += m;
 			tm.bottom += m;
-			_out.metrics.left = tm.left * m_drawScale;
-			_out.metrics.top = tm.top * m_drawScale;
-			_out.metrics.right = tm.right * m_drawScale;
-			_out.metrics.bottom = tm.bottom * m_drawScale;
-			_out.metrics.advanceX = tm.advanceX * m_drawScale;
-			_out.metrics.advanceY = tm.advanceY * m_drawScale;
-			_out.bitmap.setNull();
+			glyph.metrics.left = tm.left * m_drawScale;
+			glyph.metrics.top = tm.top * m_drawScale;
+			glyph.metrics.right = tm.right * m_drawScale;
+			glyph.metrics.bottom = tm.bottom * m_drawScale;
+			glyph.metrics.advanceX = tm.advanceX * m_drawScale;
+			glyph.metrics.advanceY = tm.advanceY * m_drawScale;
 			if (flagSizeOnly) {
-				return m_map.put_NoLock(ch, _out);
+				_putGlyph(ch, glyph);
+				_out = glyph;
+				return sl_true;
 			}
 			charX = tm.left;
 			charY = tm.top;
 			widthChar = (sl_int32)(Math::ceil(tm.getWidth()));
 			heightChar = (sl_int32)(Math::ceil(tm.getHeight()));
 		}
-		if (m_currentPlaneX > 0 && m_currentPlaneX + widthChar > m_planeWidth) {
-			m_currentPlaneX = 0;
-			m_currentPlaneY += m_currentPlaneRowHeight;
-			m_currentPlaneRowHeight = 0;
+		if (widthChar > m_planeWidth) {
+			widthChar = m_planeWidth;
+		}
+		if (heightChar > m_planeHeight) {
+			heightChar = m_planeHeight;
+		}
+
+		sl_uint32 x, y;
+		Ref<Plane> plane = _allocateRegion(widthChar, heightChar, x, y);
+		if (plane.isNull()) {
+			return sl_false;
 		}
-		if (m_currentPlaneY > 0 && m_currentPlaneY + heightChar > m_planeHeight) {
-			if (m_countPlanes >= m_maxPlanes) {
-				m_map.removeAll_NoLock();
-				m_countPlanes = 1;
+		Bitmap* bitmap = plane->bitmap.get();
+		if (!(_drawChar(bitmap, x, y, widthChar, heightChar, (sl_real)x - charX, (sl_real)y - charY, ch))) {
+			return sl_false;
+		}
+		if (m_flagSignedDistanceField) {
+			_applyDistanceField(bitmap, x, y, widthChar, heightChar);
+		}
+		plane->chars.add_NoLock(ch);
+		plane->lastUsed = m_clock;
+
+		glyph.region.left = x;
+		glyph.region.top = y;
+		glyph.region.right = x + widthChar;
+		glyph.region.bottom = y + heightChar;
+		glyph.bitmap = plane->bitmap;
+		glyph.plane = Move(plane);
+		_putGlyph(ch, glyph);
+		_out = glyph;
+		return sl_true;
+	}
+
+	sl_bool FontAtlas::_getDirectChar(sl_char32 ch, sl_bool flagSizeOnly, FontAtlasChar& _out)
+	{
+		if (ch >= SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT) {
+			return sl_false;
+		}
+		Ref<DirectChar> dc = m_directChars[ch];
+		if (dc.isNull()) {
+			return sl_false;
+		}
+		Glyph& glyph = dc->glyph;
+		if (flagSizeOnly || glyph.bitmap.isNotNull()) {
+			if (glyph.plane.isNotNull()) {
+				glyph.plane->lastUsed = m_clock;
+			}
+			_out = glyph;
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void FontAtlas::_putGlyph(sl_char32 ch, const Glyph& glyph)
+	{
+		m_map.put_NoLock(ch, glyph);
+		if (ch < SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT) {
+			Ref<DirectChar> dc = new DirectChar;
+			if (dc.isNotNull()) {
+				dc->glyph = glyph;
+				m_directChars[ch] = Move(dc);
+			}
+		}
+	}
+
+	Ref<FontAtlas::Plane> FontAtlas::_allocateRegion(sl_uint32 width, sl_uint32 height, sl_uint32& outX, sl_uint32& outY)
+	{
+		Ref<Plane> plane;
+		sl_uint32 x = 0, y = 0;
+		for (auto& item : m_planes) {
+			sl_uint32 tx, ty;
+			if (item->findPosition(width, height, m_planeWidth, m_planeHeight, tx, ty)) {
+				if (plane.isNull() || ty < y) {
+					plane = item;
+					x = tx;
+					y = ty;
+				}
+			}
+		}
+		if (plane.isNull()) {
+			if (m_planes.getCount() < m_maxPlanes) {
+				Ref<Bitmap> bitmap = _createPlane();
+				if (bitmap.isNull()) {
+					return sl_null;
+				}
+				plane = new Plane(bitmap, m_planeWidth);
+				if (plane.isNull()) {
+					return sl_null;
+				}
+				if (!(m_planes.add_NoLock(plane))) {
+					return sl_null;
+				}
 			} else {
-				if (!(_createPlane())) {
-					return sl_false;
+				// reuses the least recently used plane
+				for (auto& item : m_planes) {
+					if (plane.isNull() || item->lastUsed < plane->lastUsed) {
+						plane = item;
+					}
+				}
+				if (plane.isNull()) {
+					return sl_null;
+				}
+				_clearPlane(plane.get());
+			}
+			if (!(plane->findPosition(width, height, m_planeWidth, m_planeHeight, x, y))) {
+				return sl_null;
+			}
+		}
+		plane->addRegion(x, y, width, height);
+		outX = x;
+		outY = y;
+		return plane;
+	}
+
+	void FontAtlas::_clearPlane(Plane* plane)
+	{
+		// the glyphs drawn on the plane keep their metrics
+		for (auto& ch : plane->chars) {
+			Glyph* glyph = m_map.getItemPointer(ch);
+			if (glyph && glyph->plane.get() == plane) {
+				glyph->bitmap.setNull();
+				glyph->plane.setNull();
+				if (ch < SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT) {
+					m_directChars[ch].setNull();
+				}
+			}
+		}
+		plane->reset(m_planeWidth);
+	}
+
+	namespace
+	{
+		// squared euclidean distance transform of a sampled function (Felzenszwalb and Huttenlocher)
+		static void TransformDistance(float* f, sl_uint32 n, sl_reg step, float* g, float* d, sl_int32* v, float* z)
+		{
+			for (sl_uint32 q = 0; q < n; q++) {
+				g[q] = f[q * step];
+			}
+			sl_int32 k = 0;
+			v[0] = 0;
+			z[0] = -DISTANCE_INFINITE;
+			z[1] = DISTANCE_INFINITE;
+			for (sl_int32 q = 1; q < (sl_int32)n; q++) {
+				float s;
+				for (;;) {
+					sl_int32 r = v[k];
+					s = ((g[q] + (float)(q * q)) - (g[r] + (float)(r * r))) / (float)((q - r) << 1);
+					if (s > z[k]) {
+						break;
+					}
+					k--;
 				}
-				m_countPlanes++;
+				k++;
+				v[k] = q;
+				z[k] = s;
+				z[k + 1] = DISTANCE_INFINITE;
+			}
+			k = 0;
+			for (sl_int32 q = 0; q < (sl_int32)n; q++) {
+				while (z[k + 1] < (float)q) {
+					k++;
+				}
+				sl_int32 r = v[k];
+				d[q] = (float)((q - r) * (q - r)) + g[r];
+			}
+			for (sl_uint32 q = 0; q < n; q++) {
+				f[q * step] = d[q];
 			}
-			m_currentPlaneX = 0;
-			m_currentPlaneY = 0;
-			m_currentPlaneRowHeight = 0;
 		}
 
-		sl_uint32 x = m_currentPlaneX;
-		sl_uint32 y = m_currentPlaneY;
-		_out.region.left = x;
-		_out.region.top = y;
-		_out.region.right = x + widthChar;
-		_out.region.bottom = y + heightChar;
-		_out.bitmap = _drawChar(x, y, widthChar, heightChar, (sl_real)x - charX, (sl_real)y - charY, ch);
+		static void TransformDistance2D(float* f, sl_uint32 width, sl_uint32 height, float* g, float* d, sl_int32* v, float* z)
+		{
+			for (sl_uint32 x = 0; x < width; x++) {
+				TransformDistance(f + x, height, width, g, d, v, z);
+			}
+			for (sl_uint32 y = 0; y < height; y++) {
+				TransformDistance(f + y * width, width, 1, g, d, v, z);
+			}
+		}
+	}
 
-		m_currentPlaneX += widthChar;
-		if (heightChar > m_currentPlaneRowHeight) {
-			m_currentPlaneRowHeight = heightChar;
+	void FontAtlas::_applyDistanceField(Bitmap* plane, sl_uint32 x, sl_uint32 y, sl_uint32 width, sl_uint32 height)
+	{
+		sl_uint32 n = width * height;
+		sl_uint32 m = Math::max(width, height);
+		SLIB_SCOPED_BUFFER(Color, 4096, colors, n)
+		SLIB_SCOPED_BUFFER(float, 4096, distIn, n) // to the nearest inside pixel
+		SLIB_SCOPED_BUFFER(float, 4096, distOut, n) // to the nearest outside pixel
+		SLIB_SCOPED_BUFFER(float, 256, g, m)
+		SLIB_SCOPED_BUFFER(float, 256, d, m)
+		SLIB_SCOPED_BUFFER(float, 257, z, m + 1)
+		SLIB_SCOPED_BUFFER(sl_int32, 256, v, m)
+		if (!(colors && distIn && distOut && g && d && z && v)) {
+			return;
+		}
+		if (!(plane->readPixels(x, y, width, height, colors))) {
+			return;
 		}
-		return m_map.put_NoLock(ch, _out);
+		for (sl_uint32 i = 0; i < n; i++) {
+			Color& c = colors[i];
+			sl_bool flagInside = c.a * (c.r + c.g + c.b) >= 765 * 128;
+			distIn[i] = flagInside ? 0.0f : DISTANCE_INFINITE;
+			distOut[i] = flagInside ? DISTANCE_INFINITE : 0.0f;
+		}
+		TransformDistance2D(distIn, width, height, g, d, v, z);
+		TransformDistance2D(distOut, width, height, g, d, v, z);
+		float scale = 127.5f / (float)(m_distanceFieldSpread ? m_distanceFieldSpread : 1);
+		for (sl_uint32 i = 0; i < n; i++) {
+			float s;
+			if (distOut[i] > 0.0f) {
+				s = Math::sqrt(distOut[i]) - 0.5f;
+			} else {
+				s = 0.5f - Math::sqrt(distIn[i]);
+			}
+			s = 127.5f + s * scale;
+			if (s < 0.0f) {
+				s = 0.0f;
+			} else if (s > 255.0f) {
+				s = 255.0f;
+			}
+			colors[i] = Color(255, 255, 255, (sl_uint32)s);
+		}
+		plane->writePixels(x, y, width, height, colors);
+		plane->update(x, y, width, height);
 	}
 
 	sl_bool FontAtlas::getFontMetrics(FontMetrics& _out)
@@ -419,6 +718,9 @@ namespace slib
 
 	sl_bool FontAtlas::getChar(sl_char32 ch, FontAtlasChar& _out)
 	{
+		if (_getDirectChar(ch, sl_false, _out)) {
+			return sl_true;
+		}
 		ObjectLocker lock(this);
 		return _getChar(ch, sl_false, _out);
 	}
@@ -441,6 +743,11 @@ namespace slib
 
 	sl_bool FontAtlas::measureChar(sl_char32 ch, TextMetrics& _out)
 	{
+		FontAtlasChar fac;
+		if (_getDirectChar(ch, sl_true, fac)) {
+			_out = fac.metrics;
+			return sl_true;
+		}
 		ObjectLocker lock(this);
 		return measureChar_NoLock(ch, _out);
 	}
@@ -456,6 +763,10 @@ namespace slib
 
 	Size FontAtlas::getCharAdvance(sl_char32 ch)
 	{
+		FontAtlasChar fac;
+		if (_getDirectChar(ch, sl_true, fac)) {
+			return Size(fac.metrics.advanceX, fac.metrics.advanceY);
+		}
 		ObjectLocker lock(this);
 		return getCharAdvance_NoLock(ch);
 	}
@@ -546,10 +857,32 @@ namespace slib
 	{
 		ObjectLocker lock(this);
 		m_map.removeAll_NoLock();
-		m_countPlanes = 1;
-		m_currentPlaneX = 0;
-		m_currentPlaneY = 0;
-		m_currentPlaneRowHeight = 0;
+		for (sl_uint32 i = 0; i < SLIB_FONT_ATLAS_DIRECT_CHAR_COUNT; i++) {
+			m_directChars[i].setNull();
+		}
+		if (m_planes.getCount() > 1) {
+			m_planes.setCount_NoLock(1);
+		}
+		Ref<Plane> plane = m_planes.getFirstValue_NoLock();
+		if (plane.isNotNull()) {
+			plane->reset(m_planeWidth);
+		}
+	}
+
+	sl_bool FontAtlas::isSignedDistanceField()
+	{
+		return m_flagSignedDistanceField;
+	}
+
+	sl_uint32 FontAtlas::getDistanceFieldSpread()
+	{
+		return m_distanceFieldSpread;
+	}
+
+	sl_uint32 FontAtlas::getPlaneCount()
+	{
+		ObjectLocker lock(this);
+		return (sl_uint32)(m_planes.getCount());
 	}
 
 
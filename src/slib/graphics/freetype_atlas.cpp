@@ -71,17 +71,12 @@ namespace slib
 		if (planeHeight < PLANE_SIZE_MIN) {
 			planeHeight = PLANE_SIZE_MIN;
 		}
-		Ref<Image> plane = Image::create(planeWidth, planeHeight);
-		if (plane.isNull()) {
-			return sl_null;
-		}
 		Ref<FreeTypeAtlas> ret = new FreeTypeAtlas;
 		if (ret.isNull()) {
 			return sl_null;
 		}
 		ret->_initialize(param, fontHeight, fontHeight, strokeWidth, planeWidth, planeHeight);
 		ret->m_font = font;
-		ret->m_currentPlane = Move(plane);
 		return ret;
 	}
 
@@ -122,27 +117,24 @@ namespace slib
 		return m_font->measureChar(ch, _out);
 	}
 
-	Ref<Bitmap> FreeTypeAtlas::_drawChar(sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch)
+	sl_bool FreeTypeAtlas::_drawChar(Bitmap* _plane, sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch)
 	{
-		m_currentPlane->resetPixels(dstX, dstY, width, height, Color::Zero);
+		// the planes are created by `_createPlane()`
+		Ref<Image> plane = (Image*)_plane;
+		plane->resetPixels(dstX, dstY, width, height, Color::Zero);
 		if (m_strokeColor.a) {
-			m_font->strokeChar(m_currentPlane, charX, charY, ch, m_strokeColor, m_strokeWidth * 2.0f);
+			m_font->strokeChar(plane, charX, charY, ch, m_strokeColor, m_strokeWidth * 2.0f);
 		}
 		if (m_textColor.a) {
-			m_font->drawChar(m_currentPlane, charX, charY, ch, m_textColor);
+			m_font->drawChar(plane, charX, charY, ch, m_textColor);
 		}
-		m_currentPlane->update(dstX, dstY, width, height);
-		return m_currentPlane;
+		plane->update(dstX, dstY, width, height);
+		return sl_true;
 	}
 
-	sl_bool FreeTypeAtlas::_createPlane()
+	Ref<Bitmap> FreeTypeAtlas::_createPlane()
 	{
-		Ref<Image> plane = Image::create(m_planeWidth, m_planeHeight);
-		if (plane.isNull()) {
-			return sl_false;
-		}
-		m_currentPlane = Move(plane);
-		return sl_true;
+		return Ref<Bitmap>::cast(Image::create(m_planeWidth, m_planeHeight));
 	}
 
 }
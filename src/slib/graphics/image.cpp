@@ -1900,6 +1900,18 @@ namespace slib
 				Stretch::template stretch<Stretch_FillColor>(dst, src, src_op, blend);
 				return;
 			}
+			if (stretch == StretchMode::Mitchell || stretch == StretchMode::Lanczos3 || stretch == StretchMode::Area) {
+				Ref<Image> resized = Image::allocate(dst.width, dst.height);
+				if (resized.isNotNull()) {
+					ImageDesc desc;
+					resized->getDesc(desc);
+					if (Image::resize(desc, src, stretch)) {
+						Stretch::template stretch<Stretch_Copy>(dst, desc, src_op, blend);
+						return;
+					}
+				}
+				stretch = StretchMode::Box;
+			}
 			if (stretch == StretchMode::Nearest) {
 				Stretch::template stretch<Stretch_Nearest>(dst, src, src_op, blend);
 			} else if (stretch == StretchMode::Linear) {
@@ -2351,8 +2363,9 @@ namespace slib
 		if (width > 0 && height > 0) {
 			Ref<Image> ret = Image::allocate(width, height);
 			if (ret.isNotNull()) {
-				draw(ret->m_desc, m_desc, BlendMode::Copy, stretch);
-				return ret;
+				if (resize(ret->m_desc, m_desc, stretch)) {
+					return ret;
+				}
 			}
 		}
 		return sl_null;
@@ -0,0 +1,555 @@
+/*
+ *   Copyright (c) 2008-2024 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/graphics/image.h"
+
+#include "slib/math/math.h"
+#include "slib/core/memory.h"
+#include "slib/core/scoped_buffer.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/device/cpu.h"
+
+#if defined(SLIB_ARCH_IS_X64)
+#	define RESAMPLE_SUPPORT_SSE2
+#	include <emmintrin.h>
+#endif
+
+#define RESAMPLE_PRECISION 14
+#define RESAMPLE_ONE (1 << RESAMPLE_PRECISION)
+#define RESAMPLE_ROUND (1 << (RESAMPLE_PRECISION - 1))
+#define RESAMPLE_MIN_STRIP_ROWS 16
+
+namespace slib
+{
+
+	namespace
+	{
+
+		static double Sinc(double x)
+		{
+			if (x == 0.0) {
+				return 1.0;
+			}
+			x *= SLIB_PI_LONG;
+			return Math::sin(x) / x;
+		}
+
+		static double FilterLanczos3(double x)
+		{
+			if (x < 0.0) {
+				x = -x;
+			}
+			if (x < 3.0) {
+				return Sinc(x) * Sinc(x / 3.0);
+			}
+			return 0.0;
+		}
+
+		// Mitchell-Netravali with B = C = 1/3
+		static double FilterMitchell(double x)
+		{
+			const double B = 1.0 / 3.0;
+			const double C = 1.0 / 3.0;
+			if (x < 0.0) {
+				x = -x;
+			}
+			if (x < 1.0) {
+				return ((12.0 - 9.0 * B - 6.0 * C) * x * x * x + (-18.0 + 12.0 * B + 6.0 * C) * x * x + (6.0 - 2.0 * B)) / 6.0;
+			}
+			if (x < 2.0) {
+				return ((-B - 6.0 * C) * x * x * x + (6.0 * B + 30.0 * C) * x * x + (-12.0 * B - 48.0 * C) * x + (8.0 * B + 24.0 * C)) / 6.0;
+			}
+			return 0.0;
+		}
+
+		// Per output pixel: first source index, number of taps and 14-bit weights summing to RESAMPLE_ONE
+		class ResampleKernel
+		{
+		public:
+			sl_uint32* start;
+			sl_uint32* count;
+			sl_int16* weights;
+			sl_uint32 maxTaps;
+
+		public:
+			ResampleKernel(): start(sl_null), count(sl_null), weights(sl_null), maxTaps(0)
+			{
+			}
+
+		public:
+			sl_bool prepare(StretchMode mode, sl_uint32 sizeSrc, sl_uint32 sizeDst)
+			{
+				double scale = (double)sizeSrc / (double)sizeDst;
+				double filterScale = scale > 1.0 ? scale : 1.0;
+				double support;
+				double (*filter)(double) = sl_null;
+				if (mode == StretchMode::Lanczos3) {
+					support = 3.0;
+					filter = &FilterLanczos3;
+				} else if (mode == StretchMode::Mitchell) {
+					support = 2.0;
+					filter = &FilterMitchell;
+				} else {
+					support = 0.5;
+				}
+				support *= filterScale;
+				sl_uint32 nMaxTaps = (sl_uint32)(Math::ceil(support)) * 2 + 2;
+				if (nMaxTaps > sizeSrc) {
+					nMaxTaps = sizeSrc;
+				}
+				m_mem = Memory::create((sizeof(sl_uint32) * 2 + sizeof(sl_int16) * nMaxTaps) * sizeDst);
+				if (m_mem.isNull()) {
+					return sl_false;
+				}
+				start = (sl_uint32*)(m_mem.getData());
+				count = start + sizeDst;
+				weights = (sl_int16*)(count + sizeDst);
+				maxTaps = 0;
+
+				SLIB_SCOPED_BUFFER(double, 256, w, nMaxTaps);
+				if (!w) {
+					return sl_false;
+				}
+				for (sl_uint32 i = 0; i < sizeDst; i++) {
+					double center = ((double)i + 0.5) * scale;
+					sl_int32 iMin = (sl_int32)(Math::floor(center - support + 0.5));
+					if (iMin < 0) {
+						iMin = 0;
+					}
+					sl_int32 iMax = (sl_int32)(Math::floor(center + support + 0.5));
+					if (iMax > (sl_int32)sizeSrc) {
+						iMax = sizeSrc;
+					}
+					if (iMax - iMin > (sl_int32)nMaxTaps) {
+						iMax = iMin + nMaxTaps;
+					}
+					sl_uint32 n = (sl_uint32)(iMax - iMin);
+					double sum = 0.0;
+					for (sl_uint32 k = 0; k < n; k++) {
+						double x = (double)(iMin + (sl_int32)k);
+						double v;
+						if (filter) {
+							v = filter((x + 0.5 - center) / filterScale);
+						} else {
+							// exact overlap of the pixel with the footprint of the output sample
+							double s = center - support;
+							double e = center + support;
+							if (s < x) {
+								s = x;
+							}
+							if (e > x + 1.0) {
+								e = x + 1.0;
+							}
+							v = e > s ? e - s : 0.0;
+						}
+						w[k] = v;
+						sum += v;
+					}
+					// trim zero taps on both ends
+					sl_uint32 first = 0;
+					while (first + 1 < n && w[first] == 0.0) {
+						first++;
+					}
+					while (n > first + 1 && w[n - 1] == 0.0) {
+						n--;
+					}
+					sl_int16* weightsOut = weights + i * nMaxTaps;
+					sl_int32 total = 0;
+					sl_uint32 kMax = 0;
+					for (sl_uint32 k = first; k < n; k++) {
+						sl_int32 q = sum != 0.0 ? (sl_int32)(Math::round(w[k] / sum * RESAMPLE_ONE)) : 0;
+						weightsOut[k - first] = (sl_int16)q;
+						total += q;
+						if (w[k] > w[first + kMax]) {
+							kMax = k - first;
+						}
+					}
+					weightsOut[kMax] = (sl_int16)(weightsOut[kMax] + (RESAMPLE_ONE - total));
+					start[i] = (sl_uint32)iMin + first;
+					count[i] = n - first;
+					if (count[i] > maxTaps) {
+						maxTaps = count[i];
+					}
+				}
+				m_stride = nMaxTaps;
+				return sl_true;
+			}
+
+			const sl_int16* getWeights(sl_uint32 i) const
+			{
+				return weights + i * m_stride;
+			}
+
+		private:
+			Memory m_mem;
+			sl_uint32 m_stride;
+
+		};
+
+		SLIB_INLINE static sl_uint8 ClampResampled(sl_int32 v)
+		{
+			return (sl_uint8)(Math::clamp0_255((v + RESAMPLE_ROUND) >> RESAMPLE_PRECISION));
+		}
+
+		static void ResampleRowHorizontal_Generic(const sl_uint8* src, sl_uint8* dst, sl_uint32 width, const ResampleKernel& kernel)
+		{
+			for (sl_uint32 i = 0; i < width; i++) {
+				const sl_uint8* s = src + (kernel.start[i] << 2);
+				const sl_int16* w = kernel.getWeights(i);
+				sl_uint32 n = kernel.count[i];
+				sl_int32 r = 0, g = 0, b = 0, a = 0;
+				for (sl_uint32 k = 0; k < n; k++) {
+					sl_int32 f = w[k];
+					r += s[0] * f;
+					g += s[1] * f;
+					b += s[2] * f;
+					a += s[3] * f;
+					s += 4;
+				}
+				dst[0] = ClampResampled(r);
+				dst[1] = ClampResampled(g);
+				dst[2] = ClampResampled(b);
+				dst[3] = ClampResampled(a);
+				dst += 4;
+			}
+		}
+
+		static void ResampleRowVertical_Generic(const sl_uint8* const* rows, const sl_int16* weights, sl_uint32 nTaps, sl_uint8* dst, sl_uint32 offset, sl_uint32 nBytes)
+		{
+			for (sl_uint32 i = offset; i < nBytes; i++) {
+				sl_int32 v = 0;
+				for (sl_uint32 k = 0; k < nTaps; k++) {
+					v += rows[k][i] * (sl_int32)(weights[k]);
+				}
+				dst[i] = ClampResampled(v);
+			}
+		}
+
+#if defined(RESAMPLE_SUPPORT_SSE2)
+		SLIB_INLINE static __m128i GetWeightPair(sl_int16 w0, sl_int16 w1)
+		{
+			return _mm_set1_epi32((sl_int32)(((sl_uint32)(sl_uint16)w0) | (((sl_uint32)(sl_uint16)w1) << 16)));
+		}
+
+		static void ResampleRowHorizontal(const sl_uint8* src, sl_uint8* dst, sl_uint32 width, const ResampleKernel& kernel)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i round = _mm_set1_epi32(RESAMPLE_ROUND);
+			for (sl_uint32 i = 0; i < width; i++) {
+				const sl_uint8* s = src + (kernel.start[i] << 2);
+				const sl_int16* w = kernel.getWeights(i);
+				sl_uint32 n = kernel.count[i];
+				__m128i acc = round;
+				sl_uint32 k = 0;
+				for (; k + 2 <= n; k += 2) {
+					// r0 r1 g0 g1 b0 b1 a0 a1
+					__m128i p = _mm_loadl_epi64((const __m128i*)(s + (k << 2)));
+					p = _mm_unpacklo_epi8(p, _mm_srli_si128(p, 4));
+					p = _mm_unpacklo_epi8(p, zero);
+					acc = _mm_add_epi32(acc, _mm_madd_epi16(p, GetWeightPair(w[k], w[k + 1])));
+				}
+				if (k < n) {
+					sl_int32 c;
+					Base::copyMemory(&c, s + (k << 2), 4);
+					__m128i p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(c), zero), zero);
+					acc = _mm_add_epi32(acc, _mm_madd_epi16(p, GetWeightPair(w[k], 0)));
+				}
+				acc = _mm_srai_epi32(acc, RESAMPLE_PRECISION);
+				acc = _mm_packs_epi32(acc, acc);
+				sl_int32 c = _mm_cvtsi128_si32(_mm_packus_epi16(acc, acc));
+				Base::copyMemory(dst, &c, 4);
+				dst += 4;
+			}
+		}
+
+		static void ResampleRowVertical(const sl_uint8* const* rows, const sl_int16* weights, sl_uint32 nTaps, sl_uint8* dst, sl_uint32 nBytes)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i round = _mm_set1_epi32(RESAMPLE_ROUND);
+			sl_uint32 i = 0;
+			for (; i + 16 <= nBytes; i += 16) {
+				__m128i acc0 = round;
+				__m128i acc1 = round;
+				__m128i acc2 = round;
+				__m128i acc3 = round;
+				sl_uint32 k = 0;
+				for (; k < nTaps; k += 2) {
+					__m128i a = _mm_loadu_si128((const __m128i*)(rows[k] + i));
+					__m128i b, w;
+					if (k + 1 < nTaps) {
+						b = _mm_loadu_si128((const __m128i*)(rows[k + 1] + i));
+						w = GetWeightPair(weights[k], weights[k + 1]);
+					} else {
+						b = zero;
+						w = GetWeightPair(weights[k], 0);
+					}
+					__m128i al = _mm_unpacklo_epi8(a, zero);
+					__m128i bl = _mm_unpacklo_epi8(b, zero);
+					__m128i ah = _mm_unpackhi_epi8(a, zero);
+					__m128i bh = _mm_unpackhi_epi8(b, zero);
+					acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(al, bl), w));
+					acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(al, bl), w));
+					acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi16(ah, bh), w));
+					acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi16(ah, bh), w));
+				}
+				__m128i lo = _mm_packs_epi32(_mm_srai_epi32(acc0, RESAMPLE_PRECISION), _mm_srai_epi32(acc1, RESAMPLE_PRECISION));
+				__m128i hi = _mm_packs_epi32(_mm_srai_epi32(acc2, RESAMPLE_PRECISION), _mm_srai_epi32(acc3, RESAMPLE_PRECISION));
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+			}
+			ResampleRowVertical_Generic(rows, weights, nTaps, dst, i, nBytes);
+		}
+#else
+		static void ResampleRowHorizontal(const sl_uint8* src, sl_uint8* dst, sl_uint32 width, const ResampleKernel& kernel)
+		{
+			ResampleRowHorizontal_Generic(src, dst, width, kernel);
+		}
+
+		static void ResampleRowVertical(const sl_uint8* const* rows, const sl_int16* weights, sl_uint32 nTaps, sl_uint8* dst, sl_uint32 nBytes)
+		{
+			ResampleRowVertical_Generic(rows, weights, nTaps, dst, 0, nBytes);
+		}
+#endif
+
+		static void PremultiplyRow(const Color* src, Color* dst, sl_uint32 width)
+		{
+			for (sl_uint32 i = 0; i < width; i++) {
+				Color c = src[i];
+				c.convertNPAtoPA();
+				dst[i] = c;
+			}
+		}
+
+		static void UnpremultiplyRow(Color* colors, sl_uint32 width)
+		{
+			for (sl_uint32 i = 0; i < width; i++) {
+				colors[i].convertPAtoNPA();
+			}
+		}
+
+		static sl_bool HasTransparentPixels(const ImageDesc& desc)
+		{
+			const Color* row = desc.colors;
+			for (sl_uint32 y = 0; y < desc.height; y++) {
+				for (sl_uint32 x = 0; x < desc.width; x++) {
+					if (row[x].a != 255) {
+						return sl_true;
+					}
+				}
+				row += desc.stride;
+			}
+			return sl_false;
+		}
+
+		class Resampler
+		{
+		public:
+			ImageDesc dst;
+			ImageDesc src;
+			ResampleKernel kernelX;
+			ResampleKernel kernelY;
+			sl_bool flagResizeX;
+			sl_bool flagResizeY;
+			// filter in premultiplied space so that transparent pixels do not bleed their colors
+			sl_bool flagPremultiply;
+
+		public:
+			sl_bool prepare(StretchMode mode)
+			{
+				flagResizeX = src.width != dst.width;
+				flagResizeY = src.height != dst.height;
+				if (flagResizeX) {
+					if (!(kernelX.prepare(mode, src.width, dst.width))) {
+						return sl_false;
+					}
+				}
+				if (flagResizeY) {
+					if (!(kernelY.prepare(mode, src.height, dst.height))) {
+						return sl_false;
+					}
+				}
+				flagPremultiply = HasTransparentPixels(src);
+				return sl_true;
+			}
+
+			// Produces the source row `sy` resampled to the output width, in `buf` unless the row can be used in place
+			const sl_uint8* getHorizontalRow(sl_uint32 sy, sl_uint8* buf, Color* bufPremultiply)
+			{
+				const Color* row = src.colors + (sl_reg)sy * src.stride;
+				if (flagPremultiply) {
+					if (flagResizeX) {
+						PremultiplyRow(row, bufPremultiply, src.width);
+						ResampleRowHorizontal((const sl_uint8*)bufPremultiply, buf, dst.width, kernelX);
+					} else {
+						PremultiplyRow(row, (Color*)buf, src.width);
+					}
+					return buf;
+				}
+				if (flagResizeX) {
+					ResampleRowHorizontal((const sl_uint8*)row, buf, dst.width, kernelX);
+					return buf;
+				}
+				return (const sl_uint8*)row;
+			}
+
+			sl_bool run(sl_uint32 dyStart, sl_uint32 dyEnd)
+			{
+				sl_uint32 dw = dst.width;
+				sl_size sizeRow = (sl_size)dw << 2;
+				sl_uint32 nRing = flagResizeY ? kernelY.maxTaps : 0;
+				sl_size sizeBuf = sizeRow * nRing + (flagPremultiply && flagResizeX ? ((sl_size)(src.width) << 2) : 0);
+				Memory mem;
+				if (sizeBuf) {
+					mem = Memory::create(sizeBuf);
+					if (mem.isNull()) {
+						return sl_false;
+					}
+				}
+				sl_uint8* ring = (sl_uint8*)(mem.getData());
+				Color* bufPremultiply = (Color*)(ring + sizeRow * nRing);
+				if (!flagResizeY) {
+					for (sl_uint32 dy = dyStart; dy < dyEnd; dy++) {
+						Color* rowDst = dst.colors + (sl_reg)dy * dst.stride;
+						getHorizontalRow(dy, (sl_uint8*)rowDst, bufPremultiply);
+						if (flagPremultiply) {
+							UnpremultiplyRow(rowDst, dw);
+						}
+					}
+					return sl_true;
+				}
+				// rows resampled horizontally are kept in a ring indexed by `sy % nRing`; source windows only move forward
+				SLIB_SCOPED_BUFFER(const sl_uint8*, 64, rowsRing, nRing);
+				SLIB_SCOPED_BUFFER(const sl_uint8*, 64, rows, nRing);
+				if (!rowsRing || !rows) {
+					return sl_false;
+				}
+				sl_uint32 syNext = kernelY.start[dyStart];
+				for (sl_uint32 dy = dyStart; dy < dyEnd; dy++) {
+					sl_uint32 sy = kernelY.start[dy];
+					sl_uint32 n = kernelY.count[dy];
+					if (syNext < sy) {
+						syNext = sy;
+					}
+					for (; syNext < sy + n; syNext++) {
+						sl_uint32 slot = syNext % nRing;
+						rowsRing[slot] = getHorizontalRow(syNext, ring + sizeRow * slot, bufPremultiply);
+					}
+					for (sl_uint32 k = 0; k < n; k++) {
+						rows[k] = rowsRing[(sy + k) % nRing];
+					}
+					Color* rowDst = dst.colors + (sl_reg)dy * dst.stride;
+					ResampleRowVertical(rows, kernelY.getWeights(dy), n, (sl_uint8*)rowDst, (sl_uint32)sizeRow);
+					if (flagPremultiply) {
+						UnpremultiplyRow(rowDst, dw);
+					}
+				}
+				return sl_true;
+			}
+
+		};
+
+		static sl_bool IsResamplingMode(StretchMode mode)
+		{
+			return mode == StretchMode::Lanczos3 || mode == StretchMode::Mitchell || mode == StretchMode::Area;
+		}
+
+	}
+
+	sl_bool Image::resize(ImageDesc& dst, const ImageDesc& src, StretchMode stretch, ThreadPool* threadPool)
+	{
+		if (!(src.width) || !(src.height) || !(src.colors)) {
+			return sl_false;
+		}
+		if (!(dst.width) || !(dst.height) || !(dst.colors)) {
+			return sl_false;
+		}
+		if (!(IsResamplingMode(stretch)) || (src.width == dst.width && src.height == dst.height)) {
+			draw(dst, src, BlendMode::Copy, stretch);
+			return sl_true;
+		}
+		Resampler resampler;
+		resampler.dst = dst;
+		resampler.src = src;
+		if (!(resampler.dst.stride)) {
+			resampler.dst.stride = dst.width;
+		}
+		if (!(resampler.src.stride)) {
+			resampler.src.stride = src.width;
+		}
+		if (!(resampler.prepare(stretch))) {
+			return sl_false;
+		}
+		sl_uint32 nRows = dst.height;
+		sl_uint32 nStrips = threadPool ? Cpu::getCoreCount() : 1;
+		sl_uint32 nRowsPerStrip = (nRows + nStrips - 1) / nStrips;
+		if (nRowsPerStrip < RESAMPLE_MIN_STRIP_ROWS) {
+			nRowsPerStrip = RESAMPLE_MIN_STRIP_ROWS;
+		}
+		if (nRowsPerStrip >= nRows) {
+			return resampler.run(0, nRows);
+		}
+		Ref<Event> event = Event::create(sl_false);
+		if (event.isNull()) {
+			return resampler.run(0, nRows);
+		}
+		sl_int32 nRemaining = (sl_int32)((nRows + nRowsPerStrip - 1) / nRowsPerStrip) - 1;
+		volatile sl_int32* pRemaining = &nRemaining;
+		sl_bool flagSuccess = sl_true;
+		volatile sl_bool* pSuccess = &flagSuccess;
+		Resampler* pResampler = &resampler;
+		for (sl_uint32 row = nRowsPerStrip; row < nRows; row += nRowsPerStrip) {
+			sl_uint32 rowEnd = row + SLIB_MIN(nRowsPerStrip, nRows - row);
+			auto task = [pResampler, row, rowEnd, pRemaining, pSuccess, event]() {
+				if (!(pResampler->run(row, rowEnd))) {
+					*pSuccess = sl_false;
+				}
+				if (!(Base::interlockedDecrement32(pRemaining))) {
+					event->set();
+				}
+			};
+			if (!(threadPool->addTask(task))) {
+				task();
+			}
+		}
+		if (!(resampler.run(0, nRowsPerStrip))) {
+			flagSuccess = sl_false;
+		}
+		event->wait();
+		return flagSuccess;
+	}
+
+	Ref<Image> Image::resize(sl_uint32 width, sl_uint32 height, StretchMode stretch, ThreadPool* threadPool) const
+	{
+		if (!width || !height) {
+			return sl_null;
+		}
+		Ref<Image> ret = Image::allocate(width, height);
+		if (ret.isNotNull()) {
+			if (resize(ret->m_desc, m_desc, stretch, threadPool)) {
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+}
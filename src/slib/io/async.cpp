@@ -647,6 +647,51 @@ namespace slib
 		return create(instance, mode, sl_null);
 	}
 
+	namespace
+	{
+		// read by the I/O loop threads without lock
+		static volatile sl_int32 g_flagUsingMemoryPool = 0;
+
+		SLIB_INLINE static sl_bool IsUsingMemoryPool()
+		{
+			return Base::interlockedAdd32_Relaxed(&g_flagUsingMemoryPool, 0) != 0;
+		}
+	}
+
+	sl_bool AsyncStream::isUsingMemoryPool()
+	{
+		return IsUsingMemoryPool();
+	}
+
+	void AsyncStream::setUsingMemoryPool(sl_bool flag)
+	{
+		sl_int32 value = flag ? 1 : 0;
+		for (;;) {
+			sl_int32 old = g_flagUsingMemoryPool;
+			if (old == value || Base::interlockedCompareExchange32(&g_flagUsingMemoryPool, value, old)) {
+				return;
+			}
+		}
+	}
+
+	Memory AsyncStream::createBuffer(sl_size size)
+	{
+		if (IsUsingMemoryPool()) {
+			return Memory::createPooled(size);
+		} else {
+			return Memory::create(size);
+		}
+	}
+
+	Memory AsyncStream::createBuffer(const void* data, sl_size size)
+	{
+		if (IsUsingMemoryPool()) {
+			return Memory::createPooled(data, size);
+		} else {
+			return Memory::create(data, size);
+		}
+	}
+
 	sl_bool AsyncStream::requestIo(AsyncStreamRequest* request, sl_int32 timeout)
 	{
 		if (timeout >= 0) {
@@ -703,7 +748,7 @@ namespace slib
 
 	void AsyncStream::readFully(sl_size size, const Function<void(AsyncStream*, Memory&, sl_bool flagError)>& callback, sl_int32 timeout)
 	{
-		Memory mem = Memory::create(size);
+		Memory mem = createBuffer(size);
 		if (mem.isNull()) {
 			callback(this, mem, sl_true);
 			return;
@@ -751,7 +796,7 @@ namespace slib
 
 		static void ReadStreamFully(AsyncStream* stream, sl_size size, const Function<void(ReadStreamResult&)>& callback, sl_int32 timeout)
 		{
-			Memory mem = Memory::create(size);
+			Memory mem = AsyncStream::createBuffer(size);
 			if (mem.isNull()) {
 				ReadStreamResult err(stream, callback);
 				callback(err);
@@ -832,7 +877,7 @@ namespace slib
 
 	void AsyncStream::createMemoryAndWrite(const void* data, sl_size size, const Function<void(AsyncStreamResult&)>& callback, sl_int32 timeout)
 	{
-		Memory mem = Memory::create(data, size);
+		Memory mem = createBuffer(data, size);
 		if (mem.isNull()) {
 			AsyncStreamErrorResult result(this, data, size, callback, sl_null);
 			callback(result);
@@ -1310,7 +1355,7 @@ namespace slib
 			ret->m_onEnd = param.onEnd;
 			ret->m_sizeTotal = param.size;
 			for (sl_uint32 i = 0; i < param.bufferCount; i++) {
-				Memory mem = Memory::create(param.bufferSize);
+				Memory mem = AsyncStream::createBuffer(param.bufferSize);
 				if (mem.isNotNull()) {
 					Ref<Buffer> buf = new Buffer;
 					if (buf.isNotNull()) {
@@ -1657,7 +1702,7 @@ namespace slib
 
 	sl_bool AsyncOutputBuffer::write(const void* buf, sl_size size)
 	{
-		return write(Memory::create(buf, size));
+		return write(AsyncStream::createBuffer(buf, size));
 	}
 
 	sl_bool AsyncOutputBuffer::write(const Memory& mem)
@@ -1786,7 +1831,7 @@ namespace slib
 		if (param.stream.isNull()) {
 			return sl_null;
 		}
-		Memory buffer = Memory::create(param.bufferSize);
+		Memory buffer = AsyncStream::createBuffer(param.bufferSize);
 		if (buffer.isNull()) {
 			return sl_null;
 		}
@@ -2039,7 +2084,7 @@ namespace slib
 	{
 		if (data) {
 			if (size) {
-				Memory mem = Memory::create(data, size);
+				Memory mem = AsyncStream::createBuffer(data, size);
 				if (mem.isNotNull()) {
 					return addReadData(mem);
 				}
@@ -2053,7 +2098,7 @@ namespace slib
 	void AsyncStreamFilter::setReadingBufferSize(sl_uint32 sizeBuffer)
 	{
 		if (sizeBuffer > 0) {
-			m_memReading = Memory::create(sizeBuffer);
+			m_memReading = AsyncStream::createBuffer(sizeBuffer);
 		}
 	}
 
@@ -2078,7 +2123,7 @@ namespace slib
 		}
 		Memory mem = m_memReading;
 		if (mem.isNull()) {
-			mem = Memory::create(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
+			mem = AsyncStream::createBuffer(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
 			if (mem.isNull()) {
 				m_flagReadingError = sl_true;
 				_closeAllReadRequests();
@@ -37,6 +37,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #if defined(SLIB_PLATFORM_IS_DESKTOP)
 #	include <sys/ioctl.h>
 #	if defined(SLIB_PLATFORM_IS_MACOS)
@@ -243,6 +244,29 @@ namespace slib
 		return SLIB_IO_ERROR;
 	}
 
+	sl_int32 File::readPositional32(sl_uint64 offset, void* buf, sl_uint32 size) const noexcept
+	{
+		int fd = m_file;
+		if (fd != SLIB_FILE_INVALID_HANDLE) {
+			if (!size) {
+				return SLIB_IO_EMPTY_CONTENT;
+			}
+			for (;;) {
+				ssize_t n = ::pread(fd, buf, size, (off_t)offset);
+				if (n > 0) {
+					return (sl_int32)n;
+				}
+				if (!n) {
+					return SLIB_IO_ENDED;
+				}
+				if (errno != EINTR) {
+					break;
+				}
+			}
+		}
+		return SLIB_IO_ERROR;
+	}
+
 	sl_int32 File::write32(const void* buf, sl_uint32 size, sl_int32 timeout) const noexcept
 	{
 		int fd = m_file;
@@ -316,6 +340,52 @@ namespace slib
 		return sl_false;
 	}
 
+	namespace
+	{
+		class MappedFileRef : public CRef
+		{
+		public:
+			void* data;
+			sl_size size;
+
+		public:
+			MappedFileRef(void* _data, sl_size _size): data(_data), size(_size) {}
+
+			~MappedFileRef()
+			{
+				munmap(data, size);
+			}
+		};
+	}
+
+	Memory File::mapAllBytes(const StringParam& _filePath) noexcept
+	{
+		StringCstr filePath(_filePath);
+		if (filePath.isEmpty()) {
+			return sl_null;
+		}
+		int fd = ::open(filePath.getData(), O_RDONLY);
+		if (fd < 0) {
+			return sl_null;
+		}
+		Memory ret;
+		struct stat st;
+		if (!(fstat(fd, &st)) && st.st_size > 0 && (sl_uint64)(st.st_size) <= (sl_uint64)SLIB_SIZE_MAX) {
+			sl_size size = (sl_size)(st.st_size);
+			void* data = mmap(sl_null, size, PROT_READ, MAP_SHARED, fd, 0);
+			if (data != MAP_FAILED) {
+				Ref<MappedFileRef> ref = new MappedFileRef(data, size);
+				if (ref.isNotNull()) {
+					ret = Memory::createStatic(data, size, Move(ref));
+				} else {
+					munmap(data, size);
+				}
+			}
+		}
+		::close(fd);
+		return ret;
+	}
+
 	sl_bool File::lock(sl_uint64 offset, sl_uint64 length, sl_bool flagShared, sl_bool flagWait) const noexcept
 	{
 		int fd = m_file;
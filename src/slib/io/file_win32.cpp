@@ -209,6 +209,32 @@ namespace slib
 		return SLIB_IO_ERROR;
 	}
 
+	sl_int32 File::readPositional32(sl_uint64 offset, void* buf, sl_uint32 size) const noexcept
+	{
+		HANDLE handle = m_file;
+		if (handle != INVALID_HANDLE_VALUE) {
+			if (!size) {
+				return SLIB_IO_EMPTY_CONTENT;
+			}
+			OVERLAPPED overlapped;
+			Base::zeroMemory(&overlapped, sizeof(overlapped));
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+			sl_uint32 ret = 0;
+			if (ReadFile(handle, buf, size, (DWORD*)&ret, &overlapped)) {
+				if (ret) {
+					return ret;
+				} else {
+					return SLIB_IO_ENDED;
+				}
+			}
+			if (GetLastError() == ERROR_HANDLE_EOF) {
+				return SLIB_IO_ENDED;
+			}
+		}
+		return SLIB_IO_ERROR;
+	}
+
 	sl_int32 File::write32(const void* buf, sl_uint32 size, sl_int32 timeout) const noexcept
 	{
 		HANDLE handle = m_file;
@@ -268,6 +294,53 @@ namespace slib
 		return sl_false;
 	}
 
+	namespace {
+		class MappedFileRef : public CRef
+		{
+		public:
+			void* data;
+
+		public:
+			MappedFileRef(void* _data): data(_data) {}
+
+			~MappedFileRef()
+			{
+				UnmapViewOfFile(data);
+			}
+		};
+	}
+
+	Memory File::mapAllBytes(const StringParam& _filePath) noexcept
+	{
+		StringCstr16 filePath(_filePath);
+		if (filePath.isEmpty()) {
+			return sl_null;
+		}
+		HANDLE handle = CreateFileW((LPCWSTR)(filePath.getData()), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return sl_null;
+		}
+		Memory ret;
+		sl_uint64 size = 0;
+		if (GetFileSizeEx(handle, (PLARGE_INTEGER)(&size)) && size && size <= (sl_uint64)SLIB_SIZE_MAX) {
+			HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping) {
+				void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				if (data) {
+					Ref<MappedFileRef> ref = new MappedFileRef(data);
+					if (ref.isNotNull()) {
+						ret = Memory::createStatic(data, (sl_size)size, Move(ref));
+					} else {
+						UnmapViewOfFile(data);
+					}
+				}
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(handle);
+		return ret;
+	}
+
 	sl_bool File::getDiskSize(sl_uint64& outSize) const noexcept
 	{
 		HANDLE handle = m_file;
@@ -210,6 +210,7 @@ namespace slib
 		m_flagReading = sl_false;
 		m_flagKeepAlive = sl_true;
 		m_timeLastRead = System::getTickCount64();
+		m_idExpiringDeadline = 0;
 	}
 
 	HttpServerConnection::~HttpServerConnection()
@@ -220,7 +221,7 @@ namespace slib
 	Ref<HttpServerConnection> HttpServerConnection::create(HttpServer* server, AsyncStream* io)
 	{
 		if (server && io) {
-			Memory bufRead = Memory::create(SIZE_READ_BUF);
+			Memory bufRead = AsyncStream::createBuffer(SIZE_READ_BUF);
 			if (bufRead.isNotNull()) {
 				Ref<HttpServerConnection> ret = new HttpServerConnection;
 				if (ret.isNotNull()) {
@@ -1140,7 +1141,7 @@ namespace slib
 
 	SLIB_DEFINE_OBJECT(HttpServer, Object)
 
-	HttpServer::HttpServer()
+	HttpServer::HttpServer(): m_connectionDeadlines(System::getTickCount64(), 1000)
 	{
 		m_flagRunning = sl_false;
 		m_flagReleased = sl_false;
@@ -1193,26 +1194,21 @@ namespace slib
 
 	void HttpServer::_onTimerExpireConnections(Timer*)
 	{
-		ObjectLocker lock(&m_connections);
-		sl_uint64 now = System::getTickCount64();
-		auto node = m_connections.getFirstNode();
-		while (node) {
-			auto next = node->next;
-			Ref<HttpServerConnection>& connection = node->value;
-			if (_isConnectionExpiring(connection.get(), now)) {
-				m_connections.removeAt(node);
-			}
-			node = next;
-		}
+		m_connectionDeadlines.advance(System::getTickCount64());
 	}
 
-	sl_bool HttpServer::_isConnectionExpiring(HttpServerConnection* connection, sl_uint64 now)
+	sl_uint64 HttpServer::_checkConnectionDeadline(HttpServerConnection* connection, sl_uint64 now)
 	{
+		sl_uint64 duration = m_param.connectionExpiringDuration;
 		if (connection->m_output->isWriting()) {
-			return sl_false;
+			return now + duration;
 		}
 		sl_uint64 tick = connection->m_timeLastRead;
-		return !(now >= tick && now - tick < m_param.connectionExpiringDuration);
+		if (now >= tick && now - tick < duration) {
+			return tick + duration;
+		}
+		m_connections.remove(connection);
+		return 0;
 	}
 
 	sl_bool HttpServer::start()
@@ -1238,7 +1234,7 @@ namespace slib
 		ioLoop->start();
 
 		if (m_param.connectionExpiringDuration) {
-			m_timerExpireConnections = Timer::startWithLoop(dispatchLoop, SLIB_FUNCTION_WEAKREF(this, _onTimerExpireConnections), m_param.connectionExpiringDuration);
+			m_timerExpireConnections = Timer::startWithLoop(dispatchLoop, SLIB_FUNCTION_WEAKREF(this, _onTimerExpireConnections), SLIB_MIN(m_param.connectionExpiringDuration, 1000));
 		}
 
 		m_dispatchLoop = Move(dispatchLoop);
@@ -1271,6 +1267,7 @@ namespace slib
 			m_ioLoop.setNull();
 		}
 
+		m_connectionDeadlines.removeAll();
 		m_connections.removeAll();
 
 		{
@@ -1784,6 +1781,18 @@ namespace slib
 			connection->setRemoteAddress(remoteAddress);
 			connection->setLocalAddress(localAddress);
 			m_connections.put(connection.get(), connection);
+			if (m_param.connectionExpiringDuration) {
+				WeakRef<HttpServer> weakThis = this;
+				WeakRef<HttpServerConnection> weakConnection = connection;
+				connection->m_idExpiringDeadline = m_connectionDeadlines.addDeadline(System::getTickCount64() + m_param.connectionExpiringDuration, [weakThis, weakConnection](sl_uint64 now) -> sl_uint64 {
+					Ref<HttpServer> thiz = weakThis;
+					Ref<HttpServerConnection> connection = weakConnection;
+					if (thiz.isNull() || connection.isNull()) {
+						return 0;
+					}
+					return thiz->_checkConnectionDeadline(connection.get(), now);
+				});
+			}
 			connection->start();
 		}
 		return connection;
@@ -1794,6 +1803,7 @@ namespace slib
 		if (m_param.flagLogDebug) {
 			Log(SERVER_TAG, "[%s] Connection Closed", String::fromPointerValue(connection));
 		}
+		m_connectionDeadlines.remove(connection->m_idExpiringDeadline);
 		m_connections.remove(connection);
 	}
 
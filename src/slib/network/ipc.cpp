@@ -28,6 +28,19 @@
 #include "slib/io/file.h"
 #include "slib/system/system.h"
 #include "slib/core/thread.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/safe_static.h"
+#include "slib/core/mio.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+#	include <sys/mman.h>
+#	include <sys/socket.h>
+#	include <sys/stat.h>
+#	include <sys/syscall.h>
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <unistd.h>
+#endif
 
 #if defined(SLIB_PLATFORM_IS_WIN32) || defined(SLIB_PLATFORM_IS_MACOS)
 #	define USE_PLATFORM_IPC
@@ -55,6 +68,7 @@ namespace slib
 		flagSelfAlive = sl_true;
 		maximumMessageSize = 0x7fffffff;
 		messageSegmentSize = 0;
+		sharedMemorySize = 0;
 	}
 
 	SLIB_DEFINE_OBJECT(IPCRequest, Object)
@@ -190,6 +204,7 @@ namespace slib
 		maximumMessageSize = 0x7fffffff;
 		messageSegmentSize = 0;
 		flagAcceptOtherUsers = sl_true;
+		flagSharedMemory = sl_false;
 	}
 
 
@@ -253,7 +268,7 @@ namespace slib
 	{
 		if (flagError) {
 			if (stream) {
-				m_streams.remove(stream);
+				closeStream(stream);
 			}
 			return;
 		}
@@ -290,13 +305,18 @@ namespace slib
 	{
 		if (flagError) {
 			if (stream) {
-				m_streams.remove(stream);
+				closeStream(stream);
 			}
 			return;
 		}
 		receiveRequest(stream);
 	}
 
+	void IPCStreamServer::closeStream(AsyncStream* stream)
+	{
+		m_streams.remove(stream);
+	}
+
 	void IPCStreamServer::prepareRequest(AsyncStream* stream, IPCRequestMessage& msg)
 	{
 	}
@@ -409,26 +429,602 @@ namespace slib
 			{
 				Ref<SocketServer> ret = new SocketServer;
 				if (ret.isNotNull()) {
-					if (ret->initialize(param)) {
-						AsyncDomainSocketServerParam serverParam;
+					if (ret->open(param)) {
+						return ret;
+					}
+				}
+				return sl_null;
+			}
+
+		public:
+			sl_bool open(const IPCServerParam& param)
+			{
+				if (!(initialize(param))) {
+					return sl_false;
+				}
+				AsyncDomainSocketServerParam serverParam;
 #ifdef SLIB_PLATFORM_IS_LINUX
-						serverParam.bindPath = DOMAIN_PATH(param.name, param.flagGlobal);
+				serverParam.bindPath = DOMAIN_PATH(param.name, param.flagGlobal);
 #else
-						String path = GetDomainName(param.name, param.flagGlobal);
-						File::deleteFile(path);
-						serverParam.bindPath = DomainSocketPath(path);
+				String path = GetDomainName(param.name, param.flagGlobal);
+				File::deleteFile(path);
+				serverParam.bindPath = DomainSocketPath(path);
 #endif
-						serverParam.ioLoop = ret->m_ioLoop;
-						serverParam.onAccept = SLIB_FUNCTION_WEAKREF(ret, onAccept);
-						Ref<AsyncDomainSocketServer> server = AsyncDomainSocketServer::create(serverParam);
-						if (server.isNotNull()) {
-							ret->m_server = server;
-							ret->m_ioLoop->start();
+				serverParam.ioLoop = m_ioLoop;
+				serverParam.onAccept = SLIB_FUNCTION_WEAKREF(this, onAccept);
+				Ref<AsyncDomainSocketServer> server = AsyncDomainSocketServer::create(serverParam);
+				if (server.isNull()) {
+					return sl_false;
+				}
+				m_server = server;
+				m_ioLoop->start();
 #if !defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_WINDOWS)
-							if (param.flagAcceptOtherUsers) {
-								File::setAttributes(path, FileAttributes::AllAccess);
-							}
+				if (param.flagAcceptOtherUsers) {
+					File::setAttributes(path, FileAttributes::AllAccess);
+				}
 #endif
+				return sl_true;
+			}
+
+		public:
+			void onAccept(AsyncDomainSocketServer*, Socket& socket, DomainSocketPath& path)
+			{
+				Ref<AsyncSocketStream> stream = AsyncSocketStream::create(Move(socket), m_ioLoop);
+				if (stream.isNotNull()) {
+					startStream(stream.get());
+				}
+			}
+		};
+	}
+
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+	// IPC by shared memory rings
+	namespace
+	{
+
+#define SHARED_MEMORY_SUFFIX "__shm"
+#define SHARED_MEMORY_MAGIC 0x4d48534c
+#define SHARED_MEMORY_MAX_RING_SIZE 0x40000000
+#define SHARED_MEMORY_HANDSHAKE_TIMEOUT 5000
+#define SHARED_MEMORY_MAX_IDLE_CHANNELS 16
+#define FRAME_ALIGN 64
+#define FRAME_TYPE_INLINE 0
+#define FRAME_TYPE_RING 1
+#define FRAME_DESCRIPTOR_SIZE 17
+
+		struct RingHeader
+		{
+			volatile sl_int64 head; // bytes published by the producer
+			sl_uint8 _padding1[56];
+			volatile sl_int64 tail; // bytes released by the consumer
+			sl_uint8 _padding2[56];
+		};
+
+		struct RingFrame
+		{
+			sl_uint64 end;
+			sl_bool flagReleased;
+		};
+
+		static sl_size GetPageSize()
+		{
+			return (sl_size)(sysconf(_SC_PAGESIZE));
+		}
+
+		static sl_uint64 GetFrameSize(sl_uint64 size)
+		{
+			return (size + FRAME_ALIGN - 1) & ~((sl_uint64)(FRAME_ALIGN - 1));
+		}
+
+		static sl_uint64 LoadPosition(volatile sl_int64* pos)
+		{
+			return (sl_uint64)(Base::interlockedAdd64(pos, 0));
+		}
+
+		// Layout of the shared memory: [headers page][ring 0][ring 1]
+		// Each ring is mapped twice back to back, so that a frame wrapping around the end of the ring stays contiguous
+		static sl_uint8* MapRings(int fd, sl_size sizePage, sl_size sizeRing)
+		{
+			sl_size sizeMap = sizePage + (sizeRing << 2);
+			void* base = mmap(sl_null, sizeMap, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (base == MAP_FAILED) {
+				return sl_null;
+			}
+			sl_uint8* p = (sl_uint8*)base;
+			if (mmap(p, sizePage, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+				sl_uint32 i = 0;
+				for (; i < 4; i++) {
+					if (mmap(p + sizePage + sizeRing * i, sizeRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t)(sizePage + sizeRing * (i >> 1))) == MAP_FAILED) {
+						break;
+					}
+				}
+				if (i == 4) {
+					return p;
+				}
+			}
+			munmap(base, sizeMap);
+			return sl_null;
+		}
+
+		class SharedMemoryChannel : public CRef
+		{
+		public:
+			Socket socket; // client side
+			String key; // client side
+
+		public:
+			SharedMemoryChannel()
+			{
+				m_base = sl_null;
+				m_sizeMap = 0;
+				m_sizeRing = 0;
+				m_headerIn = sl_null;
+				m_headerOut = sl_null;
+				m_dataIn = sl_null;
+				m_dataOut = sl_null;
+				m_posIn = 0;
+				m_posTail = 0;
+				m_posOut = 0;
+			}
+
+			~SharedMemoryChannel()
+			{
+				if (m_base) {
+					munmap(m_base, m_sizeMap);
+				}
+			}
+
+		public:
+			static Ref<SharedMemoryChannel> create(int fd, sl_size sizeRing, sl_bool flagServer)
+			{
+				sl_size sizePage = GetPageSize();
+				sl_uint8* base = MapRings(fd, sizePage, sizeRing);
+				if (!base) {
+					return sl_null;
+				}
+				Ref<SharedMemoryChannel> ret = new SharedMemoryChannel;
+				if (ret.isNull()) {
+					munmap(base, sizePage + (sizeRing << 2));
+					return sl_null;
+				}
+				ret->m_base = base;
+				ret->m_sizeMap = sizePage + (sizeRing << 2);
+				ret->m_sizeRing = sizeRing;
+				// ring 0: client to server, ring 1: server to client
+				RingHeader* headers = (RingHeader*)base;
+				sl_uint8* rings = base + sizePage;
+				if (flagServer) {
+					ret->m_headerIn = headers;
+					ret->m_dataIn = rings;
+					ret->m_headerOut = headers + 1;
+					ret->m_dataOut = rings + (sizeRing << 1);
+				} else {
+					ret->m_headerIn = headers + 1;
+					ret->m_dataIn = rings + (sizeRing << 1);
+					ret->m_headerOut = headers;
+					ret->m_dataOut = rings;
+				}
+				return ret;
+			}
+
+			static Ref<SharedMemoryChannel> connect(const String& targetName, sl_bool flagGlobal, sl_uint32 sizeRequested, sl_int32 timeout)
+			{
+				sl_size sizePage = GetPageSize();
+				sl_size sizeRing = ((sl_size)sizeRequested + sizePage - 1) / sizePage * sizePage;
+				if (sizeRing > SHARED_MEMORY_MAX_RING_SIZE) {
+					return sl_null;
+				}
+				Socket socket = Socket::openDomainStream();
+				if (socket.isNone()) {
+					return sl_null;
+				}
+				String name = String::concat(targetName, SHARED_MEMORY_SUFFIX);
+				if (!(socket.connectAndWait(DOMAIN_PATH(StringParam(name), flagGlobal), timeout))) {
+					return sl_null;
+				}
+				int fd = (int)(syscall(SYS_memfd_create, "slib_ipc", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+				if (fd < 0) {
+					return sl_null;
+				}
+				Ref<SharedMemoryChannel> ret;
+				// sealed, so that the server can't be crashed by shrinking the memory under its mapping
+				if (!(ftruncate(fd, (off_t)(sizePage + (sizeRing << 1)))) && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != -1) {
+					ret = create(fd, sizeRing, sl_false);
+					if (ret.isNotNull()) {
+						sl_uint8 ack = 0;
+						if (!(sendHandshake(socket, fd, sizeRing)) || socket.readFully(&ack, 1, timeout) != 1 || ack != 1) {
+							ret.setNull();
+						}
+					}
+				}
+				close(fd);
+				if (ret.isNotNull()) {
+					ret->socket = Move(socket);
+				}
+				return ret;
+			}
+
+			static Ref<SharedMemoryChannel> accept(const Socket& socket, sl_int32 timeout)
+			{
+				pollfd pfd;
+				pfd.fd = socket.get();
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				if (poll(&pfd, 1, timeout) <= 0) {
+					return sl_null;
+				}
+				sl_uint8 buf[8];
+				iovec iov;
+				iov.iov_base = buf;
+				iov.iov_len = sizeof(buf);
+				char control[CMSG_SPACE(sizeof(int))];
+				msghdr msg;
+				Base::zeroMemory(&msg, sizeof(msg));
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = control;
+				msg.msg_controllen = sizeof(control);
+				ssize_t n = recvmsg(socket.get(), &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+				if (n < 0) {
+					return sl_null;
+				}
+				int fd = -1;
+				cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+				if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+					Base::copyMemory(&fd, CMSG_DATA(cmsg), sizeof(int));
+				}
+				if (fd < 0) {
+					return sl_null;
+				}
+				Ref<SharedMemoryChannel> ret;
+				if (n == sizeof(buf) && !(msg.msg_flags & MSG_CTRUNC) && MIO::readUint32LE(buf) == SHARED_MEMORY_MAGIC) {
+					sl_size sizePage = GetPageSize();
+					sl_size sizeRing = MIO::readUint32LE(buf + 4);
+					struct stat st;
+					if (sizeRing && sizeRing <= SHARED_MEMORY_MAX_RING_SIZE && !(sizeRing % sizePage) && !(fstat(fd, &st)) && (sl_uint64)(st.st_size) == sizePage + (sizeRing << 1)) {
+						int seals = fcntl(fd, F_GET_SEALS);
+						if (seals != -1 && (seals & F_SEAL_SHRINK)) {
+							ret = create(fd, sizeRing, sl_true);
+						}
+					}
+				}
+				close(fd);
+				if (ret.isNotNull()) {
+					sl_uint8 ack = 1;
+					if (socket.send(&ack, 1) != 1) {
+						return sl_null;
+					}
+				}
+				return ret;
+			}
+
+		public:
+			// Returns the frame to be sent through the socket. The message is copied into the outgoing ring if it has room, otherwise the frame carries the message itself
+			Memory writeMessage(const void* data, sl_size size)
+			{
+				sl_uint64 n = GetFrameSize(size);
+				if (size && n <= m_sizeRing) {
+					sl_uint64 tail = LoadPosition(&(m_headerOut->tail));
+					sl_uint64 nUsed = m_posOut - tail;
+					if (nUsed <= m_sizeRing && m_sizeRing - nUsed >= n) {
+						Memory ret = Memory::create(FRAME_DESCRIPTOR_SIZE);
+						if (ret.isNull()) {
+							return sl_null;
+						}
+						Base::copyMemory(m_dataOut + (sl_size)(m_posOut % m_sizeRing), data, size);
+						Base::interlockedAdd64(&(m_headerOut->head), (sl_int64)n);
+						sl_uint8* p = (sl_uint8*)(ret.getData());
+						p[0] = FRAME_TYPE_RING;
+						MIO::writeUint64LE(p + 1, m_posOut);
+						MIO::writeUint64LE(p + 9, size);
+						m_posOut += n;
+						return ret;
+					}
+				}
+				Memory ret = Memory::create(size + 1);
+				if (ret.isNull()) {
+					return sl_null;
+				}
+				sl_uint8* p = (sl_uint8*)(ret.getData());
+				p[0] = FRAME_TYPE_INLINE;
+				Base::copyMemory(p + 1, data, size);
+				return ret;
+			}
+
+			// The returned memory views the incoming ring, and its space is given back to the producer when the memory is freed
+			sl_bool readMessage(const Memory& frame, sl_size maxSize, Memory& _out)
+			{
+				sl_size n = frame.getSize();
+				if (!n) {
+					return sl_false;
+				}
+				sl_uint8* p = (sl_uint8*)(frame.getData());
+				if (p[0] == FRAME_TYPE_INLINE) {
+					if (n - 1 > maxSize) {
+						return sl_false;
+					}
+					_out = frame.sub(1);
+					return sl_true;
+				}
+				if (p[0] == FRAME_TYPE_RING && n == FRAME_DESCRIPTOR_SIZE) {
+					sl_uint64 size = MIO::readUint64LE(p + 9);
+					if (size > maxSize) {
+						return sl_false;
+					}
+					return readFrame(MIO::readUint64LE(p + 1), (sl_size)size, _out);
+				}
+				return sl_false;
+			}
+
+			void releaseFrame(sl_uint64 end)
+			{
+				SpinLocker lock(&m_lockFrames);
+				Link<RingFrame>* link = m_framesIn.getFront();
+				while (link) {
+					if (link->value.end == end) {
+						link->value.flagReleased = sl_true;
+						break;
+					}
+					link = link->next;
+				}
+				sl_uint64 tail = m_posTail;
+				RingFrame frame;
+				while (m_framesIn.getFrontValue_NoLock(&frame) && frame.flagReleased) {
+					m_framesIn.popFront_NoLock();
+					tail = frame.end;
+				}
+				if (tail != m_posTail) {
+					Base::interlockedAdd64(&(m_headerIn->tail), (sl_int64)(tail - m_posTail));
+					m_posTail = tail;
+				}
+			}
+
+			// no request is left unanswered on the idle channels, so any readable event means that the server closed the connection
+			sl_bool isAlive()
+			{
+				pollfd pfd;
+				pfd.fd = socket.get();
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				return !(poll(&pfd, 1, 0));
+			}
+
+		private:
+			static sl_bool sendHandshake(const Socket& socket, int fd, sl_size sizeRing)
+			{
+				sl_uint8 buf[8];
+				MIO::writeUint32LE(buf, SHARED_MEMORY_MAGIC);
+				MIO::writeUint32LE(buf + 4, (sl_uint32)sizeRing);
+				iovec iov;
+				iov.iov_base = buf;
+				iov.iov_len = sizeof(buf);
+				char control[CMSG_SPACE(sizeof(int))];
+				Base::zeroMemory(control, sizeof(control));
+				msghdr msg;
+				Base::zeroMemory(&msg, sizeof(msg));
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = control;
+				msg.msg_controllen = sizeof(control);
+				cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+				cmsg->cmsg_level = SOL_SOCKET;
+				cmsg->cmsg_type = SCM_RIGHTS;
+				cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+				Base::copyMemory(CMSG_DATA(cmsg), &fd, sizeof(int));
+				return sendmsg(socket.get(), &msg, MSG_NOSIGNAL) == (ssize_t)(sizeof(buf));
+			}
+
+			sl_bool readFrame(sl_uint64 pos, sl_size size, Memory& _out);
+
+		private:
+			sl_uint8* m_base;
+			sl_size m_sizeMap;
+			sl_size m_sizeRing;
+			RingHeader* m_headerIn;
+			RingHeader* m_headerOut;
+			sl_uint8* m_dataIn;
+			sl_uint8* m_dataOut;
+
+			sl_uint64 m_posIn; // end of the received frames
+			sl_uint64 m_posTail; // end of the released frames
+			CLinkedList<RingFrame> m_framesIn;
+			SpinLock m_lockFrames;
+
+			sl_uint64 m_posOut;
+		};
+
+		class SharedMemoryFrame : public CRef
+		{
+		public:
+			Ref<SharedMemoryChannel> channel;
+			sl_uint64 end;
+
+		public:
+			SharedMemoryFrame(SharedMemoryChannel* _channel, sl_uint64 _end): channel(_channel), end(_end) {}
+
+			~SharedMemoryFrame()
+			{
+				channel->releaseFrame(end);
+			}
+		};
+
+		sl_bool SharedMemoryChannel::readFrame(sl_uint64 pos, sl_size size, Memory& _out)
+		{
+			sl_uint64 n = GetFrameSize(size);
+			if (!size || n > m_sizeRing) {
+				return sl_false;
+			}
+			sl_uint64 end = pos + n;
+			{
+				SpinLocker lock(&m_lockFrames);
+				if (pos != m_posIn) {
+					return sl_false;
+				}
+				sl_uint64 nPublished = LoadPosition(&(m_headerIn->head)) - pos;
+				if (nPublished < n || nPublished > m_sizeRing) {
+					return sl_false;
+				}
+				RingFrame frame;
+				frame.end = end;
+				frame.flagReleased = sl_false;
+				if (!(m_framesIn.pushBack_NoLock(frame))) {
+					return sl_false;
+				}
+				m_posIn = end;
+			}
+			Ref<SharedMemoryFrame> frame = new SharedMemoryFrame(this, end);
+			if (frame.isNull()) {
+				releaseFrame(end);
+				return sl_false;
+			}
+			_out = Memory::createStatic(m_dataIn + (sl_size)(pos % m_sizeRing), size, frame);
+			return _out.isNotNull();
+		}
+
+		class SharedMemoryPool
+		{
+		public:
+			CList< Ref<SharedMemoryChannel> > idleChannels;
+			Ref<ThreadPool> threadPool;
+
+		public:
+			SharedMemoryPool()
+			{
+				threadPool = ThreadPool::create(0, 1024);
+			}
+
+		public:
+			Ref<SharedMemoryChannel> getIdleChannel(const String& key)
+			{
+				MutexLocker lock(idleChannels.getLocker());
+				sl_size i = idleChannels.getCount();
+				while (i > 0) {
+					i--;
+					Ref<SharedMemoryChannel> channel = idleChannels.getValueAt_NoLock(i);
+					if (channel->key == key) {
+						idleChannels.removeAt_NoLock(i);
+						if (channel->isAlive()) {
+							return channel;
+						}
+					}
+				}
+				return sl_null;
+			}
+
+			void putIdleChannel(const Ref<SharedMemoryChannel>& channel)
+			{
+				MutexLocker lock(idleChannels.getLocker());
+				if (idleChannels.getCount() < SHARED_MEMORY_MAX_IDLE_CHANNELS) {
+					idleChannels.add_NoLock(channel);
+				}
+			}
+		};
+
+		SLIB_SAFE_STATIC_GETTER(SharedMemoryPool, GetSharedMemoryPool)
+
+		static sl_bool SendMessageBySharedMemory(const IPCRequestParam& param, IPCResponseMessage& response)
+		{
+			SharedMemoryPool* pool = GetSharedMemoryPool();
+			if (!pool) {
+				return sl_false;
+			}
+			sl_int64 tickEnd = GetTickFromTimeout(param.timeout);
+			String targetName = param.targetName.toString();
+			String key = String::concat(String::fromUint32(param.sharedMemorySize), param.flagGlobal ? StringView::literal("G") : StringView::literal("U"), targetName);
+			Ref<SharedMemoryChannel> channel = pool->getIdleChannel(key);
+			if (channel.isNull()) {
+				channel = SharedMemoryChannel::connect(targetName, param.flagGlobal, param.sharedMemorySize, param.timeout);
+				if (channel.isNull()) {
+					// The server doesn't accept the shared memory transport
+					IPCRequestParam paramSocket = param;
+					paramSocket.sharedMemorySize = 0;
+					paramSocket.timeout = GetTimeoutFromTick(tickEnd);
+					return SocketIPC::sendMessageSynchronous(paramSocket, response);
+				}
+				channel->key = key;
+			}
+			Memory frame = channel->writeMessage(param.message.data, param.message.size);
+			if (frame.isNull()) {
+				return sl_false;
+			}
+			if (!(ChunkIO::write(&(channel->socket), frame, GetTimeoutFromTick(tickEnd)))) {
+				return sl_false;
+			}
+			CurrentThread thread;
+			if (thread.isStopping()) {
+				return sl_false;
+			}
+			sl_uint32 maxSize = param.maximumMessageSize;
+			Nullable<Memory> ret = ChunkIO::read(&(channel->socket), maxSize < 0xffffffff ? maxSize + 1 : maxSize, param.messageSegmentSize, GetTimeoutFromTick(tickEnd));
+			if (ret.isNull()) {
+				return sl_false;
+			}
+			Memory content;
+			if (!(channel->readMessage(ret.value, maxSize, content))) {
+				return sl_false;
+			}
+			response.setMemory(content);
+			pool->putIdleChannel(channel);
+			return sl_true;
+		}
+
+		class SharedMemoryRequest : public IPCRequest
+		{
+		public:
+			void start(const IPCRequestParam& param)
+			{
+				m_targetName = param.targetName.toString();
+				m_param = param;
+				m_param.targetName = m_targetName;
+				m_param.message.setMemory(param.message.getMemory());
+				m_param.dispatcher.setNull();
+				m_param.onResponse.setNull();
+				initialize(param);
+				SharedMemoryPool* pool = GetSharedMemoryPool();
+				if (pool) {
+					if (pool->threadPool->addTask(SLIB_FUNCTION_WEAKREF(this, run))) {
+						return;
+					}
+				}
+				dispatchError();
+			}
+
+			void run()
+			{
+				IPCRequestParam param = m_param;
+				param.timeout = GetTimeoutFromTick(m_tickEnd);
+				IPCResponseMessage response;
+				if (SendMessageBySharedMemory(param, response)) {
+					dispatchResponse(response.getMemory());
+				} else {
+					dispatchError();
+				}
+			}
+
+		protected:
+			String m_targetName;
+			IPCRequestParam m_param;
+		};
+
+		class SharedMemoryServer : public SocketServer
+		{
+		public:
+			Ref<AsyncDomainSocketServer> m_serverSharedMemory;
+			CHashMap< AsyncStream*, Ref<SharedMemoryChannel> > m_channels;
+
+		public:
+			static Ref<SharedMemoryServer> create(const IPCServerParam& param)
+			{
+				Ref<SharedMemoryServer> ret = new SharedMemoryServer;
+				if (ret.isNotNull()) {
+					if (ret->open(param)) {
+						AsyncDomainSocketServerParam serverParam;
+						String name = String::concat(param.name, SHARED_MEMORY_SUFFIX);
+						serverParam.bindPath = DOMAIN_PATH(StringParam(name), param.flagGlobal);
+						serverParam.ioLoop = ret->m_ioLoop;
+						serverParam.onAccept = SLIB_FUNCTION_WEAKREF(ret, onAcceptSharedMemory);
+						ret->m_serverSharedMemory = AsyncDomainSocketServer::create(serverParam);
+						if (ret->m_serverSharedMemory.isNotNull()) {
 							return ret;
 						}
 					}
@@ -437,18 +1033,90 @@ namespace slib
 			}
 
 		public:
-			void onAccept(AsyncDomainSocketServer*, Socket& socket, DomainSocketPath& path)
+			void onAcceptSharedMemory(AsyncDomainSocketServer*, Socket& socket, DomainSocketPath& path)
 			{
-				Ref<AsyncSocketStream> stream = AsyncSocketStream::create(Move(socket), m_ioLoop);
-				if (stream.isNotNull()) {
-					startStream(stream.get());
+				SharedMemoryPool* pool = GetSharedMemoryPool();
+				if (!pool) {
+					return;
+				}
+				// the handshake waits for the client, so it runs out of the I/O loop
+				sl_socket handle = socket.release();
+				WeakRef<SharedMemoryServer> thiz = this;
+				if (!(pool->threadPool->addTask([this, thiz, handle]() {
+					Socket socket(handle);
+					Ref<SharedMemoryServer> ref = thiz;
+					if (ref.isNull()) {
+						return;
+					}
+					Ref<SharedMemoryChannel> channel = SharedMemoryChannel::accept(socket, m_responseTimeout >= 0 ? m_responseTimeout : SHARED_MEMORY_HANDSHAKE_TIMEOUT);
+					if (channel.isNull()) {
+						return;
+					}
+					Ref<AsyncSocketStream> stream = AsyncSocketStream::create(Move(socket), m_ioLoop);
+					if (stream.isNotNull()) {
+						m_channels.put(stream.get(), channel);
+						startStream(stream.get());
+					}
+				}))) {
+					Socket::close(handle);
+				}
+			}
+
+		protected:
+			void processRequest(AsyncStream* stream, const Memory& data) override
+			{
+				Ref<SharedMemoryChannel> channel;
+				if (m_channels.get(stream, &channel)) {
+					Memory content;
+					if (channel->readMessage(data, m_maximumMessageSize, content)) {
+						SocketServer::processRequest(stream, content);
+					} else {
+						closeStream(stream);
+					}
+				} else {
+					SocketServer::processRequest(stream, data);
 				}
 			}
+
+			void sendResponse(AsyncStream* stream, const Memory& data) override
+			{
+				Ref<SharedMemoryChannel> channel;
+				if (m_channels.get(stream, &channel)) {
+					Memory frame = channel->writeMessage(data.getData(), data.getSize());
+					if (frame.isNotNull()) {
+						SocketServer::sendResponse(stream, frame);
+					} else {
+						closeStream(stream);
+					}
+				} else {
+					SocketServer::sendResponse(stream, data);
+				}
+			}
+
+			void closeStream(AsyncStream* stream) override
+			{
+				m_channels.remove(stream);
+				SocketServer::closeStream(stream);
+			}
 		};
+
 	}
+#endif
 
 	Ref<SocketIPC::Request> SocketIPC::sendMessage(const RequestParam& param)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		if (param.sharedMemorySize) {
+			Ref<SharedMemoryRequest> request = new SharedMemoryRequest;
+			if (request.isNotNull()) {
+				request->start(param);
+				return request;
+			}
+			ResponseMessage errorMsg;
+			param.onResponse(errorMsg);
+			return sl_null;
+		}
+#endif
 		Ref<SocketRequest> request = new SocketRequest;
 		if (request.isNotNull()) {
 			Ref<AsyncDomainSocket> socket = AsyncDomainSocket::create(param.ioLoop);
@@ -475,6 +1143,11 @@ namespace slib
 
 	sl_bool SocketIPC::sendMessageSynchronous(const RequestParam& param, ResponseMessage& response)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		if (param.sharedMemorySize) {
+			return SendMessageBySharedMemory(param, response);
+		}
+#endif
 		Socket socket = Socket::openDomainStream();
 		if (socket.isNone()) {
 			return sl_false;
@@ -510,6 +1183,11 @@ namespace slib
 
 	Ref<SocketIPC::Server> SocketIPC::createServer(const ServerParam& param)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		if (param.flagSharedMemory) {
+			return Ref<SocketIPC::Server>::cast(SharedMemoryServer::create(param));
+		}
+#endif
 		return Ref<SocketIPC::Server>::cast(SocketServer::create(param));
 	}
 
@@ -25,8 +25,6 @@
 #include "slib/network/ntlm.h"
 #include "slib/network/dce_rpc.h"
 
-#include "slib/network/event.h"
-#include "slib/network/netbios.h"
 #include "slib/data/asn1.h"
 #include "slib/io/memory_reader.h"
 #include "slib/io/memory_output.h"
@@ -44,6 +42,14 @@
 #define FILE_ID_WKSSVC 1
 #define FILE_ID_SRVSVC 2
 
+#define MAX_CREDITS 512
+#define MAX_PARALLEL_MESSAGES 16
+#define MAX_READ_SIZE 0x800000
+#define MAX_MESSAGE_SIZE 0xffffff
+#define READ_BUFFER_SIZE 0x10000
+#define WRITE_BUFFER_SIZE 0x10000
+#define ZERO_COPY_SIZE 0x4000
+
 #define FILE_ACCESS_MASK (SmbAccessMask::Read | SmbAccessMask::ReadAttributes | SmbAccessMask::ReadExtendedAttributes | SmbAccessMask::ReadControl | SmbAccessMask::Execute | SmbAccessMask::WriteDAC | SmbAccessMask::WriteOwner | SmbAccessMask::Synchronize)
 #define ALLOCATION_SIZE 0x200
 
@@ -156,7 +162,8 @@ namespace slib
 	{
 		Context* context = (Context*)_context;
 		if (context) {
-			return context->file.readAt32(offset, buf, size);
+			// the pipelined READs of the same file are processed concurrently
+			return context->file.readPositional32(offset, buf, size);
 		}
 		return -1;
 	}
@@ -275,6 +282,375 @@ namespace slib
 	}
 
 
+	namespace {
+
+		static sl_bool IsParallelMessage(const Memory& message)
+		{
+			sl_uint8* data = (sl_uint8*)(message.getData());
+			if (message.getSize() < sizeof(Smb2Header) + sizeof(Smb2ReadRequestMessage)) {
+				return sl_false;
+			}
+			if (data[0] != 0xfe || data[1] != 'S' || data[2] != 'M' || data[3] != 'B') {
+				return sl_false;
+			}
+			Smb2Header* smb = (Smb2Header*)data;
+			return smb->getCommand() == Smb2Command::Read && !(smb->getChainOffset());
+		}
+
+	}
+
+	class SmbServer::Connection : public CRef
+	{
+	public:
+		WeakRef<SmbServer> server;
+		Ref<AsyncTcpSocket> socket;
+		Ref<AsyncIoLoop> ioLoop;
+		Ref<ThreadPool> threadPool;
+		Session session;
+
+	protected:
+		Memory m_memRead;
+		Memory m_memWrite;
+
+		sl_uint8 m_bufHeader[4];
+		sl_uint32 m_sizeHeader;
+		Memory m_memMessage;
+		sl_uint32 m_sizeMessage;
+		sl_uint32 m_sizeReceived;
+		sl_bool m_flagReadingMessage;
+		// reading is paused while the messages in progress fill the credit window
+		sl_bool m_flagReadPaused;
+
+		Mutex m_lock;
+		sl_bool m_flagClosed;
+		// messages waiting for the worker threads
+		CLinkedList<Memory> m_queue;
+		sl_uint32 m_nParallel;
+		sl_bool m_flagSerial;
+		// NetBIOS frames waiting for the socket
+		MemoryBuffer m_bufWrite;
+		sl_bool m_flagWriting;
+		sl_bool m_flagFlushRequested;
+
+		SpinLock m_lockCredits;
+		sl_uint32 m_nCredits;
+
+	public:
+		Connection()
+		{
+			m_sizeHeader = 0;
+			m_sizeMessage = 0;
+			m_sizeReceived = 0;
+			m_flagReadingMessage = sl_false;
+			m_flagReadPaused = sl_false;
+			m_flagClosed = sl_false;
+			m_nParallel = 0;
+			m_flagSerial = sl_false;
+			m_flagWriting = sl_false;
+			m_flagFlushRequested = sl_false;
+			m_nCredits = 1;
+		}
+
+	public:
+		sl_bool initialize()
+		{
+			m_memRead = Memory::create(READ_BUFFER_SIZE);
+			if (m_memRead.isNull()) {
+				return sl_false;
+			}
+			m_memWrite = Memory::create(WRITE_BUFFER_SIZE);
+			if (m_memWrite.isNull()) {
+				return sl_false;
+			}
+			return sl_true;
+		}
+
+		void start()
+		{
+			_read();
+		}
+
+		void close()
+		{
+			{
+				MutexLocker lock(&m_lock);
+				if (m_flagClosed) {
+					return;
+				}
+				m_flagClosed = sl_true;
+				m_queue.removeAll_NoLock();
+				m_bufWrite.clear();
+			}
+			socket->close();
+			Ref<SmbServer> server = this->server;
+			if (server.isNotNull()) {
+				server->m_connections.remove(this);
+			}
+		}
+
+		// called by the worker threads
+		sl_bool send(MemoryBuffer& output)
+		{
+			sl_size size = output.getSize();
+			if (!size) {
+				return sl_true;
+			}
+			if (size > MAX_MESSAGE_SIZE) {
+				return sl_false;
+			}
+			sl_uint8 header[4];
+			MIO::writeUint32BE(header, (sl_uint32)size);
+			header[0] = 0;
+			MutexLocker lock(&m_lock);
+			if (m_flagClosed) {
+				return sl_false;
+			}
+			if (!(m_bufWrite.addNew(header, 4))) {
+				return sl_false;
+			}
+			m_bufWrite.link(output);
+			if (m_flagWriting || m_flagFlushRequested) {
+				return sl_true;
+			}
+			m_flagFlushRequested = sl_true;
+			Ref<Connection> thiz = this;
+			return ioLoop->dispatch([thiz]() {
+				thiz->_flush();
+			});
+		}
+
+		sl_uint16 grantCredits(sl_uint16 charge, sl_uint16 requested)
+		{
+			SpinLocker lock(&m_lockCredits);
+			sl_uint32 balance = m_nCredits > charge ? m_nCredits - charge : 0;
+			sl_uint32 n = requested ? requested : 1;
+			if (balance + n > MAX_CREDITS) {
+				n = balance < MAX_CREDITS ? MAX_CREDITS - balance : 0;
+			}
+			if (!n && !balance) {
+				// client should not run out of credits
+				n = 1;
+			}
+			m_nCredits = balance + n;
+			return (sl_uint16)n;
+		}
+
+	protected:
+		void _read()
+		{
+			Ref<Connection> thiz = this;
+			if (m_memMessage.isNotNull()) {
+				// reads the rest of large message directly into its buffer
+				m_flagReadingMessage = sl_true;
+				socket->read((sl_uint8*)(m_memMessage.getData()) + m_sizeReceived, m_sizeMessage - m_sizeReceived, [thiz](AsyncStreamResult& result) {
+					thiz->_onRead(result);
+				});
+			} else {
+				m_flagReadingMessage = sl_false;
+				socket->read(m_memRead.getData(), m_memRead.getSize(), [thiz](AsyncStreamResult& result) {
+					thiz->_onRead(result);
+				});
+			}
+		}
+
+		void _onRead(AsyncStreamResult& result)
+		{
+			if (!(result.isSuccess()) || !(result.size)) {
+				close();
+				return;
+			}
+			if (m_flagReadingMessage) {
+				m_sizeReceived += (sl_uint32)(result.size);
+				if (m_sizeReceived >= m_sizeMessage) {
+					_dispatchMessage();
+				}
+			} else {
+				if (!(_parse((sl_uint8*)(result.data), result.size))) {
+					close();
+					return;
+				}
+			}
+			{
+				MutexLocker lock(&m_lock);
+				if (m_flagClosed) {
+					return;
+				}
+				if (_isWindowFull()) {
+					// a client ignoring the granted credits does not grow the queue without limit
+					m_flagReadPaused = sl_true;
+					return;
+				}
+			}
+			_read();
+		}
+
+		// `m_lock` should be locked
+		sl_bool _isWindowFull()
+		{
+			return m_queue.getCount() + m_nParallel + (m_flagSerial ? 1 : 0) >= MAX_CREDITS;
+		}
+
+		sl_bool _parse(sl_uint8* data, sl_size size)
+		{
+			while (size) {
+				if (m_memMessage.isNotNull()) {
+					sl_uint32 n = m_sizeMessage - m_sizeReceived;
+					if (n > size) {
+						n = (sl_uint32)size;
+					}
+					Base::copyMemory((sl_uint8*)(m_memMessage.getData()) + m_sizeReceived, data, n);
+					m_sizeReceived += n;
+					data += n;
+					size -= n;
+					if (m_sizeReceived >= m_sizeMessage) {
+						_dispatchMessage();
+					}
+					continue;
+				}
+				m_bufHeader[m_sizeHeader] = *data;
+				m_sizeHeader++;
+				data++;
+				size--;
+				if (m_sizeHeader < 4) {
+					continue;
+				}
+				m_sizeHeader = 0;
+				if (m_bufHeader[0]) {
+					// not session message
+					return sl_false;
+				}
+				m_sizeMessage = SLIB_MAKE_DWORD(0, m_bufHeader[1], m_bufHeader[2], m_bufHeader[3]);
+				if (m_sizeMessage) {
+					m_memMessage = Memory::createPooled(m_sizeMessage);
+					if (m_memMessage.isNull()) {
+						return sl_false;
+					}
+					m_sizeReceived = 0;
+				}
+			}
+			return sl_true;
+		}
+
+		void _dispatchMessage()
+		{
+			MutexLocker lock(&m_lock);
+			m_queue.pushBack_NoLock(Move(m_memMessage));
+			m_memMessage.setNull();
+			_schedule();
+		}
+
+		// `m_lock` should be locked. READ requests run in parallel, and the others run one by one in order.
+		void _schedule()
+		{
+			while (!m_flagSerial && !m_flagClosed) {
+				Memory message;
+				if (!(m_queue.getFrontValue_NoLock(&message))) {
+					return;
+				}
+				sl_bool flagParallel = IsParallelMessage(message);
+				if (flagParallel ? m_nParallel >= MAX_PARALLEL_MESSAGES : m_nParallel != 0) {
+					return;
+				}
+				m_queue.popFront_NoLock();
+				if (flagParallel) {
+					m_nParallel++;
+				} else {
+					m_flagSerial = sl_true;
+				}
+				Ref<Connection> thiz = this;
+				if (!(threadPool->addTask([thiz, message, flagParallel]() {
+					thiz->_process(message, flagParallel);
+				}))) {
+					// thread pool is released
+					if (flagParallel) {
+						m_nParallel--;
+					} else {
+						m_flagSerial = sl_false;
+					}
+					return;
+				}
+			}
+		}
+
+		void _process(const Memory& message, sl_bool flagParallel)
+		{
+			if (!m_flagClosed) {
+				Ref<SmbServer> server = this->server;
+				if (server.isNotNull()) {
+					server->_processMessage(this, message);
+				}
+			}
+			MutexLocker lock(&m_lock);
+			if (flagParallel) {
+				m_nParallel--;
+			} else {
+				m_flagSerial = sl_false;
+			}
+			_schedule();
+			if (m_flagReadPaused && !m_flagClosed && !(_isWindowFull())) {
+				m_flagReadPaused = sl_false;
+				Ref<Connection> thiz = this;
+				ioLoop->dispatch([thiz]() {
+					thiz->_read();
+				});
+			}
+		}
+
+		void _flush()
+		{
+			MemoryData data;
+			{
+				MutexLocker lock(&m_lock);
+				m_flagFlushRequested = sl_false;
+				if (m_flagWriting || m_flagClosed) {
+					return;
+				}
+				if (!(m_bufWrite.pop(data))) {
+					return;
+				}
+				if (data.size < ZERO_COPY_SIZE) {
+					// coalesces the small segments (headers and short responses), and sends the large ones (file data) without copying
+					sl_uint8* buf = (sl_uint8*)(m_memWrite.getData());
+					sl_size size = data.size;
+					Base::copyMemory(buf, data.data, size);
+					MemoryData next;
+					while (m_bufWrite.pop(next)) {
+						if (next.size >= ZERO_COPY_SIZE || size + next.size > WRITE_BUFFER_SIZE) {
+							m_bufWrite.pushFront(next);
+							break;
+						}
+						Base::copyMemory(buf + size, next.data, next.size);
+						size += next.size;
+					}
+					data.data = buf;
+					data.size = size;
+					data.ref.setNull();
+				}
+				m_flagWriting = sl_true;
+			}
+			Ref<Connection> thiz = this;
+			Ref<CRef> ref = Move(data.ref);
+			socket->write(data.data, data.size, [thiz, ref](AsyncStreamResult& result) {
+				thiz->_onWrite(result);
+			});
+		}
+
+		void _onWrite(AsyncStreamResult& result)
+		{
+			if (!(result.isSuccess())) {
+				close();
+				return;
+			}
+			{
+				MutexLocker lock(&m_lock);
+				m_flagWriting = sl_false;
+			}
+			_flush();
+		}
+
+	};
+
+
 	SLIB_DEFINE_OBJECT(SmbServer, Object)
 
 	SmbServer::SmbServer()
@@ -351,13 +727,33 @@ namespace slib
 		if (threadPool.isNull()) {
 			return sl_false;
 		}
-		Ref<Thread> threadListen = Thread::start(SLIB_FUNCTION_MEMBER(this, _onRunListen));
-		if (threadListen.isNull()) {
+		Ref<AsyncIoLoop> ioLoop = m_param.ioLoop;
+		if (ioLoop.isNull()) {
+			ioLoop = AsyncIoLoop::create();
+			if (ioLoop.isNull()) {
+				return sl_false;
+			}
+		}
+		m_threadPool = threadPool;
+		m_ioLoop = ioLoop;
+
+		AsyncTcpServerParam serverParam;
+		serverParam.socket = Move(m_socketListen);
+		serverParam.flagIPv6 = m_param.bindAddress.isIPv6();
+		serverParam.ioLoop = ioLoop;
+		WeakRef<SmbServer> thiz = this;
+		serverParam.onAccept = [thiz](AsyncTcpServer*, Socket& socket, SocketAddress&) {
+			Ref<SmbServer> server = thiz;
+			if (server.isNotNull()) {
+				server->_onAccept(socket);
+			}
+		};
+		Ref<AsyncTcpServer> server = AsyncTcpServer::create(serverParam);
+		if (server.isNull()) {
 			return sl_false;
 		}
 
-		m_threadListen = Move(threadListen);
-		m_threadPool = Move(threadPool);
+		m_server = Move(server);
 		m_timeStarted = Time::now();
 		m_flagRunning = sl_true;
 
@@ -374,11 +770,17 @@ namespace slib
 		m_flagReleased = sl_true;
 		m_flagRunning = sl_false;
 
-		Ref<Thread> threadListen = m_threadListen;
-		if (threadListen.isNotNull()) {
-			threadListen->finishAndWait();
-			threadListen.setNull();
+		Ref<AsyncTcpServer> server = m_server;
+		if (server.isNotNull()) {
+			server->close();
+			m_server.setNull();
+		}
+
+		ListElements< Ref<Connection> > connections(m_connections.getAllValues());
+		for (sl_size i = 0; i < connections.count; i++) {
+			connections[i]->close();
 		}
+		m_connections.removeAll();
 
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNotNull()) {
@@ -386,6 +788,13 @@ namespace slib
 			m_threadPool.setNull();
 		}
 
+		if (m_ioLoop.isNotNull()) {
+			if (m_ioLoop != m_param.ioLoop) {
+				m_ioLoop->release();
+			}
+			m_ioLoop.setNull();
+		}
+
 		m_socketListen.close();
 
 	}
@@ -405,82 +814,58 @@ namespace slib
 		return m_param;
 	}
 
-	void SmbServer::_onRunListen()
+	void SmbServer::_onAccept(Socket& socket)
 	{
-		Thread* thread = Thread::getCurrent();
-		if (!thread) {
-			return;
-		}
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNull()) {
 			return;
 		}
-		Socket& socket = m_socketListen;
-		socket.setNonBlockingMode();
-		socket.listen();
-		Ref<SocketEvent> ev = SocketEvent::createRead(socket);
-		if (ev.isNull()) {
+		Ref<AsyncIoLoop> ioLoop = m_ioLoop;
+		if (ioLoop.isNull()) {
 			return;
 		}
-		while (thread->isNotStopping()) {
-			SocketAddress address;
-			MoveT<Socket> client = socket.accept(address);
-			if (client.isNotNone()) {
-				threadPool->addTask([client, this]() {
-					_onRunClient(client);
-				});
-			} else {
-				ev->wait();
-			}
+		AsyncTcpSocketParam socketParam;
+		socketParam.socket = Move(socket);
+		socketParam.flagIPv6 = m_param.bindAddress.isIPv6();
+		socketParam.ioLoop = ioLoop;
+		Ref<AsyncTcpSocket> stream = AsyncTcpSocket::create(socketParam);
+		if (stream.isNull()) {
+			return;
 		}
-	}
-
-	void SmbServer::_onRunClient(const Socket& socket)
-	{
-		Thread* thread = Thread::getCurrent();
-		if (!thread) {
+		Ref<Connection> connection = new Connection;
+		if (connection.isNull()) {
 			return;
 		}
-
-		socket.setNonBlockingMode();
-		Ref<SocketEvent> ev = SocketEvent::createReadWrite(socket);
-		if (ev.isNull()) {
+		if (!(connection->initialize())) {
 			return;
 		}
-
-		Session session;
-		session.server = this;
-
-		NetBIOS_SessionMessage msg;
-		while (thread->isNotStopping()) {
-			sl_int32 n = msg.read(socket);
-			if (n == SLIB_IO_ENDED) {
-				IOParam param;
-				param.socket = &socket;
-				param.event = ev.get();
-				param.data = msg.message;
-				param.size = msg.sizeMessage;
-				param.session = &session;
-				if (!(_onProcessMessage(param))) {
-					break;
-				}
-				msg.reset();
-			} else if (n < 0) {
-				if (n == SLIB_IO_WOULD_BLOCK) {
-					ev->wait();
-				} else {
-					break;
-				}
+		connection->server = this;
+		connection->socket = Move(stream);
+		connection->ioLoop = Move(ioLoop);
+		connection->threadPool = Move(threadPool);
+		connection->session.server = this;
+		m_connections.put(connection.get(), connection);
+		connection->start();
+	}
+
+	void SmbServer::_processMessage(Connection* connection, const Memory& message)
+	{
+		MemoryBuffer output;
+		IOParam param;
+		param.connection = connection;
+		param.data = (sl_uint8*)(message.getData());
+		param.size = (sl_uint32)(message.getSize());
+		param.session = &(connection->session);
+		param.output = &output;
+		if (_onProcessMessage(param)) {
+			if (connection->send(output)) {
+				return;
 			}
 		}
+		connection->close();
 	}
 
 	namespace {
-		
-		struct Smb2Chain
-		{
-			MemoryBuffer buffer;
-		};
 
 		static void InitSmb2ResponseHeader(Smb2Header& header)
 		{
@@ -506,79 +891,63 @@ namespace slib
 			response.setTreeId(request.getTreeId());
 		}
 
-		static sl_bool WriteNetBIOSHeader(SmbServer::Connection& connection, sl_size sizeMessage)
+		static void SetResponseCredits(SmbServer::Connection* connection, const Smb2Header* request, Smb2Header& response)
 		{
-			sl_uint8 buf[4];
-			MIO::writeUint32BE(buf, (sl_uint32)sizeMessage);
-			buf[0] = 0;
-			return connection.socket->sendFully(buf, 4, connection.event) == 4;
+			if (request) {
+				sl_uint16 charge = request->getCreditCharge();
+				if (!charge) {
+					charge = 1;
+				}
+				response.setCreditCharge(charge);
+				response.setCreditGranted(connection->grantCredits(charge, request->getCreditRequested()));
+				if (request->getFlags() & Smb2HeaderFlags::Chained) {
+					response.setFlags(response.getFlags() | Smb2HeaderFlags::Chained);
+				}
+			} else {
+				response.setCreditGranted(connection->grantCredits(1, 1));
+			}
 		}
 
-		static sl_bool WriteResponse(SmbServer::Smb2Param& param, Smb2Header& smb, const void* response, sl_size sizeResponse, const void* blob = sl_null, sl_size sizeBlob = 0)
+		static sl_bool WriteResponse(SmbServer::Smb2Param& param, Smb2Header& smb, const void* response, sl_size sizeResponse, const MemoryData& blob)
 		{
+			SetResponseCredits(param.connection, param.smb, smb);
+			MemoryBuffer& output = *(param.output);
+			sl_uint32 size = (sl_uint32)(sizeof(Smb2Header) + sizeResponse + blob.size);
+			sl_uint32 sizeChain = 0;
 			if (param.smb->getChainOffset()) {
-				Smb2Chain* chain;
-				if (param.chain) {
-					chain = (Smb2Chain*)(param.chain);
-				} else {
-					chain = new Smb2Chain;
-					if (!chain) {
-						return sl_false;
-					}
-					param.chain = chain;
-				}
-				sl_uint32 size = (sl_uint32)(sizeof(Smb2Header) + sizeResponse + sizeBlob);
-				sl_uint32 sizeChain = ((size - 1) | 7) + 1;
+				sizeChain = ((size - 1) | 7) + 1;
 				smb.setChainOffset(sizeChain);
-				if (!(chain->buffer.addNew(&smb, sizeof(Smb2Header)))) {
-					return sl_false;
-				}
-				if (!(chain->buffer.addNew(response, sizeResponse))) {
-					return sl_false;
-				}
-				if (sizeBlob) {
-					if (!(chain->buffer.addNew(blob, sizeBlob))) {
-						return sl_false;
-					}
-				}
-				if (sizeChain > size) {
-					sl_uint8 zero[8] = { 0 };
-					if (!(chain->buffer.addNew(zero, sizeChain - size))) {
-						return sl_false;
-					}
-				}
-				return sl_true;
-			} else {
-				if (param.chain) {
-					Smb2Chain* chain = (Smb2Chain*)(param.chain);
-					Memory mem = chain->buffer.merge();
-					if (mem.isNull()) {
-						return sl_false;
-					}
-					if (!(WriteNetBIOSHeader(param, mem.getSize() + sizeof(Smb2Header) + sizeResponse + sizeBlob))) {
-						return sl_false;
-					}
-					if (param.socket->sendFully(mem.getData(), mem.getSize(), param.event) != mem.getSize()) {
+			}
+			if (!(output.addNew(&smb, sizeof(Smb2Header)))) {
+				return sl_false;
+			}
+			if (!(output.addNew(response, sizeResponse))) {
+				return sl_false;
+			}
+			if (blob.size) {
+				if (blob.ref.isNotNull()) {
+					// sends without copying
+					if (!(output.add(blob))) {
 						return sl_false;
 					}
 				} else {
-					if (!(WriteNetBIOSHeader(param, sizeof(Smb2Header) + sizeResponse + sizeBlob))) {
+					if (!(output.addNew(blob.data, blob.size))) {
 						return sl_false;
 					}
 				}
-				if (param.socket->sendFully(&smb, sizeof(Smb2Header), param.event) != sizeof(Smb2Header)) {
-					return sl_false;
-				}
-				if (param.socket->sendFully(response, sizeResponse, param.event) != sizeResponse) {
+			}
+			if (sizeChain > size) {
+				sl_uint8 zero[8] = { 0 };
+				if (!(output.addNew(zero, sizeChain - size))) {
 					return sl_false;
 				}
-				if (sizeBlob) {
-					if (param.socket->sendFully(blob, sizeBlob, param.event) != sizeBlob) {
-						return sl_false;
-					}
-				}
-				return sl_true;
 			}
+			return sl_true;
+		}
+
+		static sl_bool WriteResponse(SmbServer::Smb2Param& param, Smb2Header& smb, const void* response, sl_size sizeResponse, const void* blob = sl_null, sl_size sizeBlob = 0)
+		{
+			return WriteResponse(param, smb, response, sizeResponse, MemoryData(blob, sizeBlob));
 		}
 
 		template <class RESPONSE>
@@ -621,27 +990,31 @@ namespace slib
 				if (param.size >= sizeof(Smb2Header)) {
 					Smb2Param smb;
 					*((IOParam*)&smb) = param;
-					smb.chain = sl_null;
+					smb.smb = sl_null;
 					smb.lastCreatedFileId = 0;
-					sl_bool flagSuccess = sl_true;
 					for (;;) {
+						Smb2Header* prev = smb.smb;
 						smb.smb = (Smb2Header*)(smb.data);
+						if (prev && (smb.smb->getFlags() & Smb2HeaderFlags::Chained)) {
+							// related operation in the compounded request
+							smb.smb->setSessionId(prev->getSessionId());
+							smb.smb->setTreeId(prev->getTreeId());
+						}
 						if (!(_onProcessSMB2(smb))) {
-							flagSuccess = sl_false;
-							break;
+							return sl_false;
 						}
 						sl_uint32 chainOffset = smb.smb->getChainOffset();
 						if (chainOffset) {
+							if (chainOffset + sizeof(Smb2Header) > smb.size) {
+								return sl_false;
+							}
 							smb.data += chainOffset;
 							smb.size -= chainOffset;
 						} else {
 							break;
 						}
 					}
-					if (smb.chain) {
-						delete ((Smb2Chain*)(smb.chain));
-					}
-					return flagSuccess;
+					return sl_true;
 				}
 			}
 		}
@@ -708,14 +1081,14 @@ namespace slib
 			return buf.merge();
 		}
 
-		static sl_bool WriteSmb2NegotiateContext(SmbServer::Connection& connection, Smb2NegotiateContextType type, const void* data, sl_size len)
+		static sl_bool WriteSmb2NegotiateContext(MemoryBuffer& output, Smb2NegotiateContextType type, const void* data, sl_size len)
 		{
 			Smb2NegotiateContextHeader header;
 			Base::zeroMemory(&header, sizeof(header));
 			header.setType(type);
 			header.setDataLength((sl_uint16)len);
-			if (connection.socket->sendFully(&header, sizeof(header), connection.event) == sizeof(header)) {
-				return connection.socket->sendFully(data, len, connection.event) == len;
+			if (output.addNew(&header, sizeof(header))) {
+				return output.addNew(data, len);
 			}
 			return sl_false;
 		}
@@ -735,7 +1108,7 @@ namespace slib
 		Base::copyMemory(response.getGuid(), m_serverGuid, 16);
 		response.setCapabilities(Smb2Capabilities::LargeMtu);
 		response.setMaxTransationSize(0x800000); // 8MB
-		response.setMaxReadSize(0x800000);
+		response.setMaxReadSize(MAX_READ_SIZE);
 		response.setMaxWriteSize(0x800000);
 		response.setCurrentTime(Time::now());
 		response.setBlobOffset(sizeof(smb) + sizeof(response));
@@ -764,39 +1137,33 @@ namespace slib
 			memPreauthContext.writeUint16(1); // Hash Algorithm: SHA-512
 			memPreauthContext.write(m_hashSalt, sizeof(m_hashSalt));
 
-			if (!(WriteNetBIOSHeader(param, nSizeBeforeContext + sizeof(Smb2NegotiateContextHeader) + memPreauthContext.getSize()))) {
-				return sl_false;
-			}
-
 		} else {
-
 			response.setDialect(0x02ff);
-
-			if (!(WriteNetBIOSHeader(param, nSizeBeforeContext))) {
-				return sl_false;
-			}
 		}
 
-		if (param.socket->sendFully(&smb, sizeof(smb), param.event) != sizeof(smb)) {
+		SetResponseCredits(param.connection, param.smb, smb);
+
+		MemoryBuffer& output = *(param.output);
+		if (!(output.addNew(&smb, sizeof(smb)))) {
 			return sl_false;
 		}
-		if (param.socket->sendFully(&response, sizeof(response), param.event) != sizeof(response)) {
+		if (!(output.addNew(&response, sizeof(response)))) {
 			return sl_false;
 		}
 		if (nSizeSecurityBlob) {
-			if (param.socket->sendFully(memSecurityBlob.getData(), nSizeSecurityBlob, param.event) != nSizeSecurityBlob) {
+			if (!(output.add(memSecurityBlob))) {
 				return sl_false;
 			}
 		}
 		if (memPreauthContext.getSize()) {
 			if (nPaddingBeforeContext) {
 				sl_uint8 zeros[16] = { 0 };
-				if (param.socket->sendFully(zeros, nPaddingBeforeContext, param.event) != nPaddingBeforeContext) {
+				if (!(output.addNew(zeros, nPaddingBeforeContext))) {
 					return sl_false;
 				}
 			}
 			Memory mem = memPreauthContext.merge();
-			if (!(WriteSmb2NegotiateContext(param, Smb2NegotiateContextType::PREAUTH_INTEGRITY_CAPABILITIES, mem.getData(), mem.getSize()))) {
+			if (!(WriteSmb2NegotiateContext(output, Smb2NegotiateContextType::PREAUTH_INTEGRITY_CAPABILITIES, mem.getData(), mem.getSize()))) {
 				return sl_false;
 			}
 		}
@@ -1176,7 +1543,6 @@ namespace slib
 		}
 
 		Smb2ReadRequestMessage* request = (Smb2ReadRequestMessage*)(param.data + sizeof(Smb2Header));
-		sl_uint8 stack[65536];
 		MemoryData data;
 
 		sl_uint64 fileId = GetFileId(param, request->getGuid());
@@ -1204,20 +1570,22 @@ namespace slib
 				Ref<FileContext> file = param.session->getFile(fileId);
 				if (file.isNotNull()) {
 					sl_uint32 len = request->getReadLength();
-					if (len <= sizeof(stack)) {
-						data.data = stack;
-					} else {
-						data = MemoryData(Memory::create(len));
-						if (!(data.data)) {
-							return WriteErrorResponse(param, SmbStatus::Unsuccessful);
-						}
+					sl_uint32 charge = param.smb->getCreditCharge();
+					if (len > MAX_READ_SIZE || (charge && len > (charge << 16))) {
+						return WriteErrorResponse(param, SmbStatus::InvalidParameter);
+					}
+					// file data is read into the buffer passed to the socket
+					Memory mem = Memory::createPooled(len);
+					if (mem.isNull()) {
+						return WriteErrorResponse(param, SmbStatus::Unsuccessful);
 					}
-					sl_int32 result = share->readFile(file.get(), request->getFileOffset(), data.data, len);
+					sl_int32 result = share->readFile(file.get(), request->getFileOffset(), mem.getData(), len);
 					if (result == SLIB_IO_ENDED) {
 						return WriteErrorResponse(param, SmbStatus::EndOfFile);
 					} else if (result < 0) {
 						return WriteErrorResponse(param, SmbStatus::Unsuccessful);
 					}
+					data = Move(mem);
 					data.size = result;
 				}
 			}
@@ -1236,7 +1604,7 @@ namespace slib
 		response.setDataOffset(sizeof(smb) + sizeof(response));
 		response.setReadCount((sl_uint32)(data.size));
 
-		return WriteResponse(param, smb, response, data.data, data.size);
+		return WriteResponse(param, smb, &response, sizeof(response), data);
 	}
 
 	sl_bool SmbServer::_onProcessWrite(SmbServer::Smb2Param& param)
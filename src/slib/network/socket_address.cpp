@@ -356,9 +356,10 @@ namespace slib
 						}
 						Base::copyMemory(data, str, len);
 					}
-					length = len;
-					return sl_true;
 				}
+				// unnamed address of the peer which is not bound
+				length = len;
+				return sl_true;
 			}
 		}
 		return sl_false;
@@ -20,9 +20,17 @@
  *   THE SOFTWARE.
  */
 
+
 #include "slib/network/curl.h"
 
+#include "slib/network/url.h"
 #include "slib/io/file.h"
+#include "slib/core/thread.h"
+#include "slib/core/safe_static.h"
+
+#if defined(SLIB_PLATFORM_IS_UNIX)
+#	include "slib/io/pipe_event.h"
+#endif
 
 #if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
 #	include "slib/dl/linux/curl.h"
@@ -40,30 +48,106 @@
 #	undef DELETE
 #endif
 
+#define DEFAULT_MAX_CONNECTIONS_PER_HOST 6
+
 namespace slib
 {
 
 	namespace {
 
+		sl_bool g_flagMultiEngine = sl_false;
+		sl_uint32 g_nMaxConnectionsPerHost = DEFAULT_MAX_CONNECTIONS_PER_HOST;
+
+		class CurlShare
+		{
+		public:
+			CURLSH* handle;
+			Mutex locks[CURL_LOCK_DATA_LAST];
+
+		public:
+			CurlShare()
+			{
+				handle = sl_null;
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+				if (!(curl::getApi_curl_share_init())) {
+					return;
+				}
+#endif
+				CURLSH* share = curl_share_init();
+				if (share) {
+					curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &callbackLock);
+					curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &callbackUnlock);
+					curl_share_setopt(share, CURLSHOPT_USERDATA, (void*)this);
+					curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+					curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+					// The connection cache is not shared: libcurl does not support using it from the concurrent transfers on the different threads. The transfers of the multi engine reuse the connections in the cache of the multi handle.
+					handle = share;
+				}
+			}
+
+			~CurlShare()
+			{
+				if (handle) {
+					curl_share_cleanup(handle);
+				}
+			}
+
+		public:
+			static void callbackLock(CURL* curl, curl_lock_data data, curl_lock_access access, void* user_data)
+			{
+				CurlShare* share = (CurlShare*)user_data;
+				if ((sl_uint32)data < CURL_LOCK_DATA_LAST) {
+					share->locks[data].lock();
+				}
+			}
+
+			static void callbackUnlock(CURL* curl, curl_lock_data data, void* user_data)
+			{
+				CurlShare* share = (CurlShare*)user_data;
+				if ((sl_uint32)data < CURL_LOCK_DATA_LAST) {
+					share->locks[data].unlock();
+				}
+			}
+
+		};
+
+		SLIB_SAFE_STATIC_GETTER(CurlShare, GetCurlShare)
+
+		class CurlMultiEngine;
+
+		static CurlMultiEngine* GetOpenedCurlMultiEngine();
+
 		class CurlRequestImpl : public UrlRequest
 		{
 			friend class CurlRequest;
+			friend class CurlMultiEngine;
 
 		public:
 			CURL* m_curl;
+			curl_slist* m_headerChunk;
 			sl_bool m_flagClosed;
 			sl_bool m_flagProcessResponse;
+			sl_bool m_flagMultiEngine;
+			String m_hostKey;
+			// index in the running requests of the multi engine
+			sl_size m_indexRunning;
 
 		public:
 			CurlRequestImpl()
 			{
 				m_curl = sl_null;
+				m_headerChunk = sl_null;
 				m_flagClosed = sl_false;
 				m_flagProcessResponse = sl_false;
+				m_flagMultiEngine = sl_false;
+				m_indexRunning = 0;
 			}
 
 			~CurlRequestImpl()
 			{
+				if (m_headerChunk) {
+					curl_slist_free_all(m_headerChunk);
+				}
 			}
 
 		public:
@@ -75,19 +159,29 @@ namespace slib
 #endif
 				Ref<CurlRequestImpl> ret = new CurlRequestImpl;
 				if (ret.isNotNull()) {
+					if (g_flagMultiEngine && GetOpenedCurlMultiEngine()) {
+						ret->m_flagMultiEngine = sl_true;
+						Url u(url);
+						ret->m_hostKey = String::concat(u.scheme, "://", u.host).toLower();
+					}
 					ret->_init(param, url);
 					return ret;
 				}
 				return sl_null;
 			}
 
-			void _cancel() override
-			{
-				m_flagClosed = sl_true;
-			}
+			void _cancel() override;
+
+			void _sendAsync() override;
 
 			void _sendSync() override
 			{
+				if (m_flagMultiEngine) {
+					// waits for the completion on the engine
+					UrlRequest::_sendSync();
+					return;
+				}
+
 #if defined(SLIB_PLATFORM_IS_TIZEN)
 				connection_h connection;
 				if (connection_create(&connection) != CONNECTION_ERROR_NONE) {
@@ -130,9 +224,30 @@ namespace slib
 				connection_set_proxy_address_changed_cb(connection, UrlRequest_Impl::callbackProxyChanged, (void*)this);
 #endif
 
+				prepare(curl);
+
+				/* getting data */
+				CURLcode err = curl_easy_perform(curl);
+
+				complete(err);
+
+				curl_easy_cleanup(curl);
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+				connection_destroy(connection);
+#endif
+
+			}
+
+			void prepare(CURL* curl)
+			{
 				StringCstr url = m_url;
 				curl_easy_setopt(curl, CURLOPT_URL, url.getData());
 
+				CurlShare* share = GetCurlShare();
+				if (share && share->handle) {
+					curl_easy_setopt(curl, CURLOPT_SHARE, share->handle);
+				}
+
 				curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 				curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
 
@@ -187,16 +302,16 @@ namespace slib
 				if (headerChunk) {
 					curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerChunk);
 				}
+				m_headerChunk = headerChunk;
 
 				// post data
-				Memory requestBody = m_requestBody;
 				if (m_method == HttpMethod::POST) {
-					curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBody.getData());
-					curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, requestBody.getSize());
+					curl_easy_setopt(curl, CURLOPT_POSTFIELDS, m_requestBody.getData());
+					curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, m_requestBody.getSize());
 				} else {
-					if (requestBody.isNotNull()) {
+					if (m_requestBody.isNotNull()) {
 						curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
-						curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)requestBody.getSize());
+						curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)(m_requestBody.getSize()));
 						curl_easy_setopt(curl, CURLOPT_READFUNCTION, CurlRequestImpl::callbackRead);
 						curl_easy_setopt(curl, CURLOPT_READDATA, (void*)this);
 					}
@@ -210,9 +325,11 @@ namespace slib
 				curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, CurlRequestImpl::callbackWrite);
 				curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)this);
 
-				/* getting data */
-				CURLcode err = curl_easy_perform(curl);
+				curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)this);
+			}
 
+			void complete(CURLcode err)
+			{
 				processResponse();
 
 				if (err == CURLE_OK) {
@@ -223,15 +340,16 @@ namespace slib
 					onError();
 				}
 
-				if (headerChunk) {
-					curl_slist_free_all(headerChunk);
-				}
-
-				curl_easy_cleanup(curl);
-#if defined(SLIB_PLATFORM_IS_TIZEN)
-				connection_destroy(connection);
-#endif
+				release();
+			}
 
+			void release()
+			{
+				if (m_headerChunk) {
+					curl_slist_free_all(m_headerChunk);
+					m_headerChunk = sl_null;
+				}
+				m_curl = sl_null;
 			}
 
 			void processResponse()
@@ -389,6 +507,337 @@ namespace slib
 
 		};
 
+		// drives the asynchronous requests from a single multi handle on its own thread
+		class CurlMultiEngine
+		{
+		public:
+			class Host
+			{
+			public:
+				sl_uint32 nRunning;
+				List<CURL*> idleHandles;
+				LinkedList< Ref<CurlRequestImpl> > pendingRequests;
+
+			public:
+				Host(): nRunning(0) {}
+			};
+
+		public:
+			CURLM* m_multi;
+			Ref<Thread> m_thread;
+#if defined(SLIB_PLATFORM_IS_UNIX)
+			Ref<PipeEvent> m_eventWake;
+#endif
+			LinkedList< Ref<CurlRequestImpl> > m_requestsNew;
+
+			// accessed only on the engine thread
+			List< Ref<CurlRequestImpl> > m_requestsRunning;
+			HashMap<String, Host> m_hosts;
+
+		public:
+			CurlMultiEngine()
+			{
+				m_multi = sl_null;
+				// the share must be destroyed after the engine thread
+				GetCurlShare();
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+				if (!(curl::getApi_curl_multi_wait()) || !(curl::getApi_curl_easy_reset())) {
+					return;
+				}
+#endif
+#if defined(SLIB_PLATFORM_IS_UNIX)
+				m_eventWake = PipeEvent::create();
+				if (m_eventWake.isNull()) {
+					return;
+				}
+#endif
+				CURLM* multi = curl_multi_init();
+				if (!multi) {
+					return;
+				}
+				// multiplexes the transfers to the same HTTP/2 host
+				curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+				m_multi = multi;
+				m_thread = Thread::start(SLIB_FUNCTION_MEMBER(this, run));
+				if (m_thread.isNull()) {
+					curl_multi_cleanup(multi);
+					m_multi = sl_null;
+				}
+			}
+
+			~CurlMultiEngine()
+			{
+				if (m_thread.isNotNull()) {
+					m_thread->finish();
+					wake();
+					m_thread->finishAndWait();
+				}
+				if (m_multi) {
+					curl_multi_cleanup(m_multi);
+				}
+			}
+
+		public:
+			sl_bool isOpened()
+			{
+				return m_multi != sl_null;
+			}
+
+			sl_bool addRequest(CurlRequestImpl* request)
+			{
+				if (m_requestsNew.pushBack(request)) {
+					wake();
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			void wake()
+			{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+				m_eventWake->set();
+#endif
+			}
+
+			void run()
+			{
+				Thread* thread = Thread::getCurrent();
+				if (!thread) {
+					return;
+				}
+				while (thread->isNotStopping()) {
+					Ref<CurlRequestImpl> request;
+					while (m_requestsNew.popFront(&request)) {
+						enqueueRequest(request);
+					}
+					removeClosedRequests();
+					int nRunning = 0;
+					curl_multi_perform(m_multi, &nRunning);
+					processFinishedTransfers();
+					int nEvents = 0;
+#if defined(SLIB_PLATFORM_IS_UNIX)
+					curl_waitfd fd;
+					fd.fd = (curl_socket_t)(m_eventWake->getReadPipeHandle());
+					fd.events = CURL_WAIT_POLLIN;
+					fd.revents = 0;
+					curl_multi_wait(m_multi, &fd, 1, 1000, &nEvents);
+					if (fd.revents) {
+						m_eventWake->reset();
+					}
+#else
+					curl_multi_wait(m_multi, sl_null, 0, 10, &nEvents);
+#endif
+				}
+				for (auto& item : m_requestsRunning) {
+					curl_multi_remove_handle(m_multi, item->m_curl);
+					curl_easy_cleanup(item->m_curl);
+					item->release();
+				}
+				m_requestsRunning.removeAll_NoLock();
+				for (auto& item : m_hosts) {
+					for (auto& curl : item.value.idleHandles) {
+						curl_easy_cleanup(curl);
+					}
+				}
+				m_hosts.removeAll_NoLock();
+				m_requestsNew.removeAll();
+			}
+
+			void enqueueRequest(const Ref<CurlRequestImpl>& request)
+			{
+				Host* host = m_hosts.getItemPointer(request->m_hostKey);
+				if (!host) {
+					if (!(m_hosts.put_NoLock(request->m_hostKey, Host()))) {
+						request->onError();
+						return;
+					}
+					host = m_hosts.getItemPointer(request->m_hostKey);
+				}
+				if (host->nRunning < g_nMaxConnectionsPerHost || !(host->nRunning)) {
+					startRequest(host, request);
+				} else {
+					host->pendingRequests.pushBack_NoLock(request);
+				}
+			}
+
+			void startRequest(Host* host, const Ref<CurlRequestImpl>& request)
+			{
+				if (request->m_flagClosed) {
+					abortRequest(request.get());
+					return;
+				}
+				CURL* curl = sl_null;
+				if (!(host->idleHandles.popBack_NoLock(&curl))) {
+					curl = curl_easy_init();
+					if (!curl) {
+						request->onError();
+						return;
+					}
+				}
+				request->m_curl = curl;
+				request->prepare(curl);
+				if (curl_multi_add_handle(m_multi, curl) == CURLM_OK) {
+					request->m_indexRunning = m_requestsRunning.getCount();
+					if (m_requestsRunning.add_NoLock(request)) {
+						host->nRunning++;
+						return;
+					}
+					curl_multi_remove_handle(m_multi, curl);
+				}
+				request->release();
+				releaseHandle(host, curl);
+				request->onError();
+			}
+
+			void startPendingRequests(const String& hostKey)
+			{
+				Host* host = m_hosts.getItemPointer(hostKey);
+				if (!host) {
+					return;
+				}
+				Ref<CurlRequestImpl> request;
+				while (host->nRunning < g_nMaxConnectionsPerHost || !(host->nRunning)) {
+					if (!(host->pendingRequests.popFront_NoLock(&request))) {
+						break;
+					}
+					startRequest(host, request);
+				}
+			}
+
+			void releaseHandle(Host* host, CURL* curl)
+			{
+				if (host->idleHandles.getCount() < g_nMaxConnectionsPerHost) {
+					// keeps the live connections, the DNS cache and the session ID cache
+					curl_easy_reset(curl);
+					if (host->idleHandles.add_NoLock(curl)) {
+						return;
+					}
+				}
+				curl_easy_cleanup(curl);
+			}
+
+			// detaches the transfer from the multi handle, and returns the request holding it
+			Ref<CurlRequestImpl> takeRunningRequest(sl_size index)
+			{
+				Ref<CurlRequestImpl> request = m_requestsRunning.getValueAt_NoLock(index);
+				// the last request fills the hole, so that the indices of the others are kept
+				sl_size last = m_requestsRunning.getCount() - 1;
+				if (index != last) {
+					Ref<CurlRequestImpl>& moved = m_requestsRunning[index];
+					moved = m_requestsRunning.getValueAt_NoLock(last);
+					moved->m_indexRunning = index;
+				}
+				m_requestsRunning.popBack_NoLock();
+				curl_multi_remove_handle(m_multi, request->m_curl);
+				Host* host = m_hosts.getItemPointer(request->m_hostKey);
+				if (host) {
+					host->nRunning--;
+				}
+				return request;
+			}
+
+			void finishRequest(const Ref<CurlRequestImpl>& request, CURL* curl)
+			{
+				Host* host = m_hosts.getItemPointer(request->m_hostKey);
+				if (host) {
+					releaseHandle(host, curl);
+				} else {
+					curl_easy_cleanup(curl);
+				}
+				startPendingRequests(request->m_hostKey);
+			}
+
+			void processFinishedTransfers()
+			{
+				for (;;) {
+					int nMessages = 0;
+					CURLMsg* msg = curl_multi_info_read(m_multi, &nMessages);
+					if (!msg) {
+						break;
+					}
+					if (msg->msg != CURLMSG_DONE) {
+						continue;
+					}
+					CURL* curl = msg->easy_handle;
+					CURLcode err = msg->data.result;
+					char* _private = sl_null;
+					curl_easy_getinfo(curl, CURLINFO_PRIVATE, &_private);
+					CurlRequestImpl* impl = (CurlRequestImpl*)_private;
+					if (!impl) {
+						continue;
+					}
+					sl_size index = impl->m_indexRunning;
+					Ref<CurlRequestImpl>* pRequest = m_requestsRunning.getPointerAt(index);
+					if (pRequest && pRequest->get() == impl) {
+						Ref<CurlRequestImpl> request = takeRunningRequest(index);
+						request->complete(err);
+						finishRequest(request, curl);
+					}
+				}
+			}
+
+			void removeClosedRequests()
+			{
+				sl_size i = m_requestsRunning.getCount();
+				while (i > 0) {
+					i--;
+					if (m_requestsRunning.getValueAt_NoLock(i)->m_flagClosed) {
+						Ref<CurlRequestImpl> request = takeRunningRequest(i);
+						CURL* curl = request->m_curl;
+						abortRequest(request.get());
+						finishRequest(request, curl);
+					}
+				}
+			}
+
+			void abortRequest(CurlRequestImpl* request)
+			{
+				request->release();
+				Ref<Event> event = request->m_eventSync;
+				if (event.isNotNull()) {
+					event->set();
+				}
+			}
+
+		};
+
+		SLIB_SAFE_STATIC_GETTER(CurlMultiEngine, GetCurlMultiEngine)
+
+		static CurlMultiEngine* GetOpenedCurlMultiEngine()
+		{
+			CurlMultiEngine* engine = GetCurlMultiEngine();
+			if (engine && engine->isOpened()) {
+				return engine;
+			}
+			return sl_null;
+		}
+
+		void CurlRequestImpl::_cancel()
+		{
+			m_flagClosed = sl_true;
+			if (m_flagMultiEngine) {
+				CurlMultiEngine* engine = GetOpenedCurlMultiEngine();
+				if (engine) {
+					engine->wake();
+				}
+			}
+		}
+
+		void CurlRequestImpl::_sendAsync()
+		{
+			if (m_flagMultiEngine) {
+				CurlMultiEngine* engine = GetOpenedCurlMultiEngine();
+				if (engine) {
+					if (engine->addRequest(this)) {
+						return;
+					}
+				}
+				onError();
+				return;
+			}
+			UrlRequest::_sendAsync();
+		}
+
 	}
 
 #define URL_REQUEST CurlRequest
@@ -399,6 +848,26 @@ namespace slib
 		return Ref<UrlRequest>::cast(CurlRequestImpl::create(param, url));
 	}
 
+	sl_bool CurlRequest::isMultiEngineEnabled()
+	{
+		return g_flagMultiEngine;
+	}
+
+	void CurlRequest::setMultiEngineEnabled(sl_bool flag)
+	{
+		g_flagMultiEngine = flag;
+	}
+
+	sl_uint32 CurlRequest::getMaximumConnectionsPerHost()
+	{
+		return g_nMaxConnectionsPerHost;
+	}
+
+	void CurlRequest::setMaximumConnectionsPerHost(sl_uint32 n)
+	{
+		g_nMaxConnectionsPerHost = n;
+	}
+
 #if defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_ANDROID)
 	Ref<UrlRequest> UrlRequest::_create(const UrlRequestParam& param, const String& url)
 	{
@@ -47,6 +47,13 @@
 #define MAP_FOV_Y (SLIB_PI / 3.0)
 #define ALTITUDE_RATIO 0.8660254037844386 // (1 - 0.5^2)^0.5
 
+// Below this count, visiting all children is cheaper than querying the index
+#define CULLING_MIN_CHILDREN 64
+// Margin in pixels for the sprites and texts drawn around their locations
+#define CULLING_MARGIN 256.0
+// Maximum altitude of the objects to be seen beyond the horizon
+#define CULLING_MAX_OBJECT_ALTITUDE 20000.0
+
 namespace slib
 {
 
@@ -2060,6 +2067,7 @@ namespace slib
 		m_flagOverlay = sl_false;
 		m_flagMaxEyeAltitude = sl_false;
 		m_maxEyeAltitude = 0.0;
+		m_indexInParent = 0;
 	}
 
 	MapViewObject::~MapViewObject()
@@ -2183,6 +2191,19 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool MapViewObject::getBounds(GeoRectangle& _out)
+	{
+		return sl_false;
+	}
+
+	void MapViewObject::invalidateBounds()
+	{
+		Ref<MapViewObjectList> parent = m_parent;
+		if (parent.isNotNull()) {
+			parent->_updateChild(this, m_indexInParent);
+		}
+	}
+
 	SLIB_DEFINE_OBJECT(MapViewObjectList, MapViewObject)
 
 	MapViewObjectList::MapViewObjectList()
@@ -2197,20 +2218,169 @@ namespace slib
 
 	void MapViewObjectList::addChild(const Ref<MapViewObject>& child)
 	{
+		if (child.isNull()) {
+			return;
+		}
 		ObjectLocker lock(this);
-		m_children.add_NoLock(child);
+		sl_size index = m_children.getCount();
+		if (!(m_children.add_NoLock(child))) {
+			return;
+		}
+		GeoRectangle bounds;
+		sl_bool flagBounds = child->getBounds(bounds);
+		if (flagBounds) {
+			flagBounds = m_index.insert(bounds, index);
+		}
+		if (!flagBounds) {
+			m_unboundedChildren.add_NoLock(index);
+		}
+		m_childBounds.add_NoLock(bounds);
+		m_childBoundsFlags.add_NoLock(flagBounds);
+		child->m_parent = this;
+		child->m_indexInParent = index;
+	}
+
+	void MapViewObjectList::updateChild(const Ref<MapViewObject>& child)
+	{
+		ObjectLocker lock(this);
+		sl_reg index = m_children.indexOf_NoLock(child);
+		if (index < 0) {
+			return;
+		}
+		_updateChild(child.get(), index);
+	}
+
+	void MapViewObjectList::_updateChild(MapViewObject* child, sl_size index)
+	{
+		ObjectLocker lock(this);
+		Ref<MapViewObject>* pChild = m_children.getPointerAt(index);
+		if (!pChild || pChild->get() != child) {
+			return;
+		}
+		GeoRectangle* pBounds = m_childBounds.getPointerAt(index);
+		sl_bool* pFlag = m_childBoundsFlags.getPointerAt(index);
+		if (!pBounds || !pFlag) {
+			return;
+		}
+		if (*pFlag) {
+			m_index.remove(*pBounds, index);
+		} else {
+			m_unboundedChildren.remove_NoLock((sl_size)index);
+		}
+		sl_bool flagBounds = child->getBounds(*pBounds);
+		if (flagBounds) {
+			flagBounds = m_index.insert(*pBounds, index);
+		}
+		if (!flagBounds) {
+			m_unboundedChildren.add_NoLock(index);
+		}
+		*pFlag = flagBounds;
 	}
 
 	void MapViewObjectList::removeAll()
 	{
 		ObjectLocker lock(this);
+		ListElements< Ref<MapViewObject> > children(m_children);
+		for (sl_size i = 0; i < children.count; i++) {
+			MapViewObject* child = children[i].get();
+			Ref<MapViewObjectList> parent = child->m_parent;
+			if (parent.get() == this) {
+				child->m_parent.setNull();
+			}
+		}
 		m_children.removeAll_NoLock();
+		m_childBounds.removeAll_NoLock();
+		m_childBoundsFlags.removeAll_NoLock();
+		m_index.removeAll();
+		m_unboundedChildren.removeAll_NoLock();
+	}
+
+	sl_bool MapViewObjectList::_getVisibleChildren(MapViewData* data, MapPlane* plane, List<sl_size>& _out)
+	{
+		if (m_children.getCount() < CULLING_MIN_CHILDREN) {
+			return sl_false;
+		}
+		if (plane) {
+			RectangleT<double> viewport = plane->getViewport();
+			double left = viewport.left - CULLING_MARGIN;
+			double top = viewport.top - CULLING_MARGIN;
+			double right = viewport.right + CULLING_MARGIN;
+			double bottom = viewport.bottom + CULLING_MARGIN;
+			if (plane->getMapLocationFromViewPoint(Double2(right, top)).E - plane->getMapLocationFromViewPoint(Double2(left, top)).E >= EARTH_CIRCUMFERENCE) {
+				return sl_false;
+			}
+			double cx = (left + right) / 2.0;
+			double cy = (top + bottom) / 2.0;
+			Double2 pts[] = {
+				Double2(left, top), Double2(cx, top), Double2(right, top),
+				Double2(left, cy), Double2(right, cy),
+				Double2(left, bottom), Double2(cx, bottom), Double2(right, bottom)
+			};
+			LatLon center = plane->getLatLonFromMapLocation(plane->getMapLocationFromViewPoint(Double2(cx, cy)));
+			double south = center.latitude;
+			double north = center.latitude;
+			// longitudes relative to the center, to keep the box continuous across the antimeridian
+			double west = 0;
+			double east = 0;
+			for (sl_size i = 0; i < CountOfArray(pts); i++) {
+				LatLon pt = plane->getLatLonFromMapLocation(plane->getMapLocationFromViewPoint(pts[i]));
+				if (pt.latitude < south) {
+					south = pt.latitude;
+				}
+				if (pt.latitude > north) {
+					north = pt.latitude;
+				}
+				double d = Math::normalizeDegreeDistance(pt.longitude - center.longitude);
+				if (d < west) {
+					west = d;
+				}
+				if (d > east) {
+					east = d;
+				}
+			}
+			if (east - west >= 360.0) {
+				return sl_false;
+			}
+			GeoRectangle rect;
+			rect.bottomLeft.latitude = south;
+			rect.bottomLeft.longitude = LatLon::normalizeLongitude(center.longitude + west);
+			rect.topRight.latitude = north;
+			rect.topRight.longitude = LatLon::normalizeLongitude(center.longitude + east);
+			_out = m_index.search(rect);
+		} else {
+			GeoLocation& eye = data->getMapState().eyeLocation;
+			double h = eye.altitude;
+			if (h < 0) {
+				h = 0;
+			}
+			double R = MapEarth::getRadius();
+			double angle = Math::arccos(R / (R + h)) + Math::arccos(R / (R + CULLING_MAX_OBJECT_ALTITUDE));
+			if (angle >= SLIB_PI) {
+				return sl_false;
+			}
+			_out = m_index.searchInRadius(eye.getLatLon(), angle * SLIB_GEO_EARTH_AVERAGE_RADIUS);
+		}
+		_out.addAll_NoLock(m_unboundedChildren);
+		// keep the drawing order
+		_out.sort();
+		return sl_true;
 	}
 
 	void MapViewObjectList::draw(Canvas* canvas, MapViewData* data, MapPlane* plane)
 	{
 		ObjectLocker lock(this);
 		ListElements< Ref<MapViewObject> > children(m_children);
+		List<sl_size> listVisible;
+		if (_getVisibleChildren(data, plane, listVisible)) {
+			ListElements<sl_size> indices(listVisible);
+			for (sl_size i = 0; i < indices.count; i++) {
+				Ref<MapViewObject>& child = children[indices[i]];
+				if (child->isVisibleState(data, plane)) {
+					child->draw(canvas, data, plane);
+				}
+			}
+			return;
+		}
 		for (sl_size i = 0; i < children.count; i++) {
 			Ref<MapViewObject>& child = children[i];
 			if (child->isVisibleState(data, plane)) {
@@ -2224,8 +2394,12 @@ namespace slib
 		MapViewState& state = data->getMapState();
 		ObjectLocker lock(this);
 		ListElements< Ref<MapViewObject> > children(m_children);
-		for (sl_size i = 0; i < children.count; i++) {
-			Ref<MapViewObject>& child = children[i];
+		List<sl_size> listVisible;
+		sl_bool flagCulling = _getVisibleChildren(data, sl_null, listVisible);
+		ListElements<sl_size> indices(listVisible);
+		sl_size n = flagCulling ? indices.count : children.count;
+		for (sl_size i = 0; i < n; i++) {
+			Ref<MapViewObject>& child = children[flagCulling ? indices[i] : i];
 			if (child->isVisibleState(data, sl_null)) {
 				if (child->isOverlay()) {
 					engine->setDepthStencilState(state.overlayDepthState);
@@ -2338,11 +2512,13 @@ namespace slib
 	void MapViewSprite::setLocation(const GeoLocation& location)
 	{
 		m_location.setValue(location);
+		invalidateBounds();
 	}
 
 	void MapViewSprite::setLocation(const LatLon& location)
 	{
 		m_location.setValue(location);
+		invalidateBounds();
 	}
 
 	const Size& MapViewSprite::getSize()
@@ -2432,6 +2608,13 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool MapViewSprite::getBounds(GeoRectangle& _out)
+	{
+		_out.bottomLeft = m_location.getValue();
+		_out.topRight = _out.bottomLeft;
+		return sl_true;
+	}
+
 	void MapViewSprite::onPreDrawOrRender(MapViewData* data)
 	{
 		m_lastDrawId = data->getMapState().drawId;
@@ -2506,11 +2689,13 @@ namespace slib
 	void MapViewLine::setStartLocation(const LatLon& location)
 	{
 		m_startLocation.setValue(location);
+		invalidateBounds();
 	}
 
 	void MapViewLine::setStartLocation(const GeoLocation& location)
 	{
 		m_startLocation.setValue(location);
+		invalidateBounds();
 	}
 
 	const LatLon& MapViewLine::getEndLocation()
@@ -2526,11 +2711,13 @@ namespace slib
 	void MapViewLine::setEndLocation(const LatLon& location)
 	{
 		m_endLocation.setValue(location);
+		invalidateBounds();
 	}
 
 	void MapViewLine::setEndLocation(const GeoLocation& location)
 	{
 		m_endLocation.setValue(location);
+		invalidateBounds();
 	}
 
 	sl_real MapViewLine::getLineWidth()
@@ -2588,6 +2775,12 @@ namespace slib
 		data->renderLine(engine, vp1, vp2, m_lineColor, m_lineWidth);
 	}
 
+	sl_bool MapViewLine::getBounds(GeoRectangle& _out)
+	{
+		_out = GeoRectangle(m_startLocation.getValue(), m_endLocation.getValue());
+		return sl_true;
+	}
+
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(MapViewState)
 
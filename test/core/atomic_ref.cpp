@@ -0,0 +1,209 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define DURATION 500
+
+class Value : public CRef
+{
+public:
+	Value(sl_uint32 _n): n(_n)
+	{
+		Base::interlockedIncrement32(&nAlive);
+	}
+
+	~Value()
+	{
+		// poisoned, so that the readers of a freed value notice it
+		check = 0;
+		Base::interlockedDecrement32(&nAlive);
+	}
+
+public:
+	sl_uint32 n;
+	sl_uint32 check = 0x12345678;
+	static sl_int32 nAlive;
+};
+
+sl_int32 Value::nAlive = 0;
+
+// readers keep loading while a writer keeps replacing the value
+static void Benchmark(sl_uint32 nReaders)
+{
+	AtomicRef<Value> ref = new Value(0);
+	AtomicString str = String::fromUint32(0);
+	volatile sl_bool flagRunning = sl_true;
+	volatile sl_int64 nLoads = 0;
+	volatile sl_int32 nErrors = 0;
+
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nReaders; i++) {
+		threads.add_NoLock(Thread::start([&]() {
+			sl_int64 n = 0;
+			while (flagRunning) {
+				Ref<Value> value = ref;
+				String s = str;
+				if (value.isNull() || value->check != 0x12345678 || s.isEmpty()) {
+					Base::interlockedIncrement32(&nErrors);
+				}
+				n++;
+			}
+			Base::interlockedAdd64(&nLoads, n);
+		}));
+	}
+	sl_uint32 nWrites = 0;
+	TimeCounter tc;
+	while (tc.getElapsedMilliseconds() < DURATION) {
+		nWrites++;
+		ref = new Value(nWrites);
+		str = String::fromUint32(nWrites);
+		System::yield();
+	}
+	flagRunning = sl_false;
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	SLIB_ASSERT(!nErrors);
+	Println("%d readers: %d loads/ms, %d writes", nReaders, nLoads / DURATION, nWrites);
+}
+
+// several writers replace the value back to back, so that the epoch advances twice while a reader is entering
+static sl_int32 StressWriters(sl_uint32 nReaders, sl_uint32 nWriters)
+{
+	AtomicRef<Value> ref = new Value(0);
+	EpochLock lock;
+	Value* volatile raw = new Value(0);
+	volatile sl_bool flagRunning = sl_true;
+	volatile sl_int32 nErrors = 0;
+	volatile sl_int64 nWrites = 0;
+
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nReaders; i++) {
+		threads.add_NoLock(Thread::start([&]() {
+			while (flagRunning) {
+				Ref<Value> value = ref;
+				if (value.isNull() || value->check != 0x12345678) {
+					Base::interlockedIncrement32(&nErrors);
+				}
+				sl_int32 ticket = lock.enter();
+				Value* v = raw;
+				for (sl_uint32 k = 0; k < 8; k++) {
+					if (v->check != 0x12345678) {
+						Base::interlockedIncrement32(&nErrors);
+						break;
+					}
+					System::yield();
+				}
+				lock.leave(ticket);
+			}
+		}));
+	}
+	for (sl_uint32 i = 0; i < nWriters; i++) {
+		threads.add_NoLock(Thread::start([&, i]() {
+			sl_uint32 n = 0;
+			while (flagRunning) {
+				n++;
+				ref = new Value(n);
+				lock.lock();
+				Value* old = raw;
+				raw = new Value(n);
+				lock.synchronize();
+				lock.unlock();
+				delete old;
+				Base::interlockedIncrement64(&nWrites);
+				if (n & 1) {
+					System::yield();
+				}
+			}
+		}));
+	}
+	Thread::sleep(DURATION);
+	flagRunning = sl_false;
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	delete raw;
+	Println("%d readers, %d writers: %d writes, %d errors", nReaders, nWriters, (sl_int32)nWrites, nErrors);
+	return nErrors;
+}
+
+// more readers than the epoch counter held in 15 bits
+static sl_bool TestManyReaders()
+{
+	EpochLock lock;
+	List<sl_int32> tickets;
+	for (sl_uint32 i = 0; i < 100000; i++) {
+		tickets.add_NoLock(lock.enter());
+	}
+	volatile sl_bool flagSynchronized = sl_false;
+	Ref<Thread> writer = Thread::start([&lock, &flagSynchronized]() {
+		lock.lock();
+		lock.synchronize();
+		lock.unlock();
+		flagSynchronized = sl_true;
+	});
+	Thread::sleep(100);
+	sl_bool flagWaited = !flagSynchronized;
+	for (auto& ticket : tickets) {
+		lock.leave(ticket);
+	}
+	writer->finishAndWait();
+	return flagWaited && flagSynchronized;
+}
+
+// the writers make progress while the readers keep entering and leaving
+static sl_bool TestWriterProgress(sl_uint32 nReaders)
+{
+	EpochLock lock;
+	volatile sl_bool flagRunning = sl_true;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nReaders; i++) {
+		threads.add_NoLock(Thread::start([&lock, &flagRunning]() {
+			while (flagRunning) {
+				lock.leave(lock.enter());
+			}
+		}));
+	}
+	sl_uint32 nLocked = 0;
+	TimeCounter tc;
+	while (nLocked < 10000 && tc.getElapsedMilliseconds() < 10000) {
+		lock.lock();
+		lock.synchronize();
+		lock.unlock();
+		nLocked++;
+	}
+	sl_uint64 elapsed = tc.getElapsedMilliseconds();
+	flagRunning = sl_false;
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	Println("%d readers: %d writes in %dms", nReaders, nLocked, (sl_int32)elapsed);
+	return nLocked == 10000;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_int32 nErrors = 0;
+	for (sl_uint32 n = 1; n <= 64; n <<= 1) {
+		Benchmark(n);
+	}
+	nErrors += StressWriters(4, 2);
+	nErrors += StressWriters(8, 4);
+	nErrors += StressWriters(2, 8);
+	sl_bool flagWriterProgress = TestWriterProgress(8);
+	if (!flagWriterProgress) {
+		Println("Failed: the writer did not make progress under the reader traffic");
+		nErrors++;
+	}
+	sl_bool flagManyReaders = TestManyReaders();
+	if (!flagManyReaders) {
+		Println("Failed: the writer did not wait for the readers");
+		nErrors++;
+	}
+	SLIB_ASSERT(!(Value::nAlive));
+	if (nErrors || Value::nAlive) {
+		return 1;
+	}
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,189 @@
+#include <slib.h>
+#include <slib/data/expiring_map.h>
+#include <slib/data/concurrent_expiring_map.h>
+
+using namespace slib;
+
+#define OPERATION_COUNT 2000000
+#define KEY_COUNT 100000
+
+template <class FN>
+static sl_uint64 RunThreads(sl_uint32 threadCount, const FN& fn)
+{
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < threadCount; i++) {
+		threads.add_NoLock(Thread::start([i, threadCount, &fn]() {
+			sl_uint64 seed = i + 1;
+			sl_uint32 n = OPERATION_COUNT / threadCount;
+			for (sl_uint32 k = 0; k < n; k++) {
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				fn((sl_uint32)(seed >> 32) % KEY_COUNT, (k & 7) == 0);
+			}
+		}));
+	}
+	for (auto&& thread : threads) {
+		thread->finishAndWait();
+	}
+	return tc.getElapsedMilliseconds();
+}
+
+int main(int argc, const char * argv[])
+{
+	// basic operations
+	{
+		ConcurrentExpiringMap<String, sl_int32> map(4);
+		SLIB_ASSERT(map.getShardCount() == 4);
+		sl_uint32 nFailed = 0;
+		for (sl_int32 i = 0; i < 1000; i++) {
+			if (!(map.put(String::fromInt32(i), i))) {
+				nFailed++;
+			}
+		}
+		SLIB_ASSERT(!nFailed);
+		SLIB_ASSERT(map.getCount() == 1000);
+		sl_int32 v = 0;
+		sl_bool flagFound = map.get("500", &v);
+		SLIB_ASSERT(flagFound && v == 500);
+		flagFound = map.get("1000");
+		SLIB_ASSERT(!flagFound);
+		v = map.getValue("1000", -1);
+		SLIB_ASSERT(v == -1);
+		sl_bool flagPut = map.put("500", 5000);
+		SLIB_ASSERT(flagPut);
+		v = map.getValue("500", -1);
+		SLIB_ASSERT(v == 5000);
+		sl_bool flagRemoved = map.remove("500", &v);
+		SLIB_ASSERT(flagRemoved && v == 5000);
+		SLIB_ASSERT(!(map.contains("500")));
+		SLIB_ASSERT(map.getCount() == 999 && map.getAllKeys().getCount() == 999 && map.toList().getCount() == 999);
+		SLIB_ASSERT(map.getHitCount() == 2 && map.getMissCount() == 2);
+		map.removeAll();
+		SLIB_ASSERT(map.isEmpty());
+		flagPut = map.put("a", 1);
+		v = map.getValue("a", 0);
+		SLIB_ASSERT(flagPut && v == 1);
+	}
+
+	// expiration
+	{
+		Ref<DispatchLoop> loop = DispatchLoop::create();
+		ConcurrentExpiringMap<sl_uint32, sl_uint32> map;
+		map.setDispatchLoop(loop);
+		map.setExpiringMilliseconds(100);
+		volatile sl_int32 nExpired = 0;
+		map.setOnExpired([&nExpired](HashMap<sl_uint32, sl_uint32>& items) {
+			Base::interlockedAdd32(&nExpired, (sl_int32)(items.getCount()));
+		});
+		for (sl_uint32 i = 0; i < 100; i++) {
+			map.put(i, i);
+		}
+		map.put(1000, 1000, 0);
+		map.put(1001, 1001, 2000);
+		Thread::sleep(50);
+		sl_bool flagFound = map.get(0);
+		SLIB_ASSERT(flagFound);
+		Thread::sleep(70);
+		// item 0 is refreshed by the access
+		flagFound = map.get(0);
+		sl_bool flagExpired = !(map.get(1));
+		SLIB_ASSERT(flagFound && flagExpired);
+		Thread::sleep(400);
+		SLIB_ASSERT(!(map.contains(0)));
+		SLIB_ASSERT(map.contains(1000) && map.contains(1001));
+		SLIB_ASSERT(nExpired == 100 && map.getExpirationCount() == 100);
+		SLIB_ASSERT(map.getCount() == 2);
+
+		// the items put while the timer stops itself on the empty map are still swept
+		map.removeAll();
+		nExpired = 0;
+		for (sl_uint32 i = 0; i < 200; i++) {
+			map.put(i, i, 5);
+			Thread::sleep(i % 13);
+		}
+		Thread::sleep(300);
+		SLIB_ASSERT(nExpired == 200 && map.getCount() == 0);
+		loop->release();
+	}
+
+	// admission: the one-time keys interleaved with the frequently used keys do not flush them
+	{
+		ConcurrentExpiringMap<sl_uint32, sl_uint32> map(16, 1600);
+		sl_uint64 seed = 1;
+		sl_uint32 nHotAccess = 0;
+		sl_uint32 nHotHit = 0;
+		for (sl_uint32 i = 0; i < 400000; i++) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			sl_uint32 r = (sl_uint32)(seed >> 32);
+			if (r & 1) {
+				sl_uint32 key = (r >> 1) % 1000;
+				sl_bool flagHit = map.get(key);
+				if (!flagHit) {
+					map.put(key, key);
+				}
+				if (i >= 100000) {
+					nHotAccess++;
+					if (flagHit) {
+						nHotHit++;
+					}
+				}
+			} else {
+				map.put(1000000 + i, i);
+			}
+		}
+		SLIB_ASSERT(map.getCount() <= 1600);
+		double ratio = (double)nHotHit / (double)nHotAccess;
+		Println("Hit ratio of the hot keys under scan: %.3f, evicted %d, rejected %d", ratio, map.getEvictionCount(), map.getRejectionCount());
+		SLIB_ASSERT(ratio > 0.9);
+		SLIB_ASSERT(map.getRejectionCount() > 100000);
+
+		// the hot set moves to the new keys
+		map.resetCounters();
+		for (sl_uint32 k = 0; k < 10; k++) {
+			for (sl_uint32 i = 0; i < 1000; i++) {
+				sl_uint32 key = 2000000 + i;
+				if (!(map.get(key))) {
+					map.put(key, i);
+				}
+			}
+		}
+		Println("Hit ratio on the new hot set: %.3f", (double)(map.getHitCount()) / (double)(map.getHitCount() + map.getMissCount()));
+		SLIB_ASSERT(map.getHitCount() > 5000);
+	}
+
+	// throughput: 1 write per 8 reads
+	{
+		sl_uint32 nThreads = Math::max(Cpu::getCoreCount(), (sl_uint32)4);
+		for (sl_uint32 threadCount = 1; ; threadCount = Math::min(threadCount * 2, nThreads)) {
+			ExpiringMap<sl_uint32, sl_uint32> map1;
+			map1.setupTimer(60000, sl_null);
+			ConcurrentExpiringMap<sl_uint32, sl_uint32> map2;
+			map2.setExpiringMilliseconds(60000);
+			for (sl_uint32 i = 0; i < KEY_COUNT; i++) {
+				map1.put(i, i);
+				map2.put(i, i);
+			}
+			sl_uint64 t1 = RunThreads(threadCount, [&map1](sl_uint32 key, sl_bool flagWrite) {
+				if (flagWrite) {
+					map1.put(key, key);
+				} else {
+					map1.get(key);
+				}
+			});
+			sl_uint64 t2 = RunThreads(threadCount, [&map2](sl_uint32 key, sl_bool flagWrite) {
+				if (flagWrite) {
+					map2.put(key, key);
+				} else {
+					map2.get(key);
+				}
+			});
+			Println("%d threads: ExpiringMap %dns/op, ConcurrentExpiringMap %dns/op", threadCount, (sl_int32)(t1 * 1000000 / OPERATION_COUNT), (sl_int32)(t2 * 1000000 / OPERATION_COUNT));
+			if (threadCount >= nThreads) {
+				break;
+			}
+		}
+	}
+
+	Println("OK");
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include <slib.h>
+#include <slib/core/memory_pool.h>
+
+using namespace slib;
+
+#define THREAD_COUNT 8
+#define ITERATIONS 200000
+
+static const sl_size g_sizes[] = { 100, 1024, 4096, 16384, 65536 };
+
+static void Run(const char* name, const Function<Memory(sl_size)>& create)
+{
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < THREAD_COUNT; i++) {
+		threads.add_NoLock(Thread::start([create, i]() {
+			Memory window[16];
+			for (sl_uint32 k = 0; k < ITERATIONS; k++) {
+				sl_size size = g_sizes[(k + i) % CountOfArray(g_sizes)];
+				Memory& mem = window[k & 15];
+				mem = create(size);
+				SLIB_ASSERT(mem.getSize() == size);
+				((sl_uint8*)(mem.getData()))[size - 1] = (sl_uint8)k;
+			}
+		}));
+	}
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	Println("%s: %dms", name, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	SLIB_ASSERT(MemoryPool::getSizeClass(0) < 0);
+	SLIB_ASSERT(MemoryPool::getSizeClass(1) == 0);
+	SLIB_ASSERT(MemoryPool::getSizeClass(SLIB_MEMORY_POOL_MIN_SIZE + 1) == 1);
+	SLIB_ASSERT(MemoryPool::getSizeClass(SLIB_MEMORY_POOL_MAX_SIZE) == SLIB_MEMORY_POOL_SIZE_CLASS_COUNT - 1);
+	SLIB_ASSERT(MemoryPool::getSizeClass(SLIB_MEMORY_POOL_MAX_SIZE + 1) < 0);
+	{
+		// blocks out of the pooled range
+		Memory mem = Memory::createPooled(SLIB_MEMORY_POOL_MAX_SIZE * 2);
+		SLIB_ASSERT(mem.getSize() == SLIB_MEMORY_POOL_MAX_SIZE * 2);
+	}
+	for (sl_uint32 k = 0; k < 2; k++) {
+		// more free blocks than the shared list can keep
+		Memory mems[32];
+		for (sl_uint32 i = 0; i < CountOfArray(mems); i++) {
+			mems[i] = Memory::createPooled(SLIB_MEMORY_POOL_MAX_SIZE);
+			SLIB_ASSERT(mems[i].isNotNull());
+			Base::resetMemory(mems[i].getData(), SLIB_MEMORY_POOL_MAX_SIZE, (sl_uint8)i);
+		}
+		for (sl_uint32 i = 0; i < CountOfArray(mems); i++) {
+			SLIB_ASSERT(((sl_uint8*)(mems[i].getData()))[SLIB_MEMORY_POOL_MAX_SIZE - 1] == (sl_uint8)i);
+			mems[i].setNull();
+		}
+	}
+
+	Run("Memory::create", [](sl_size size) { return Memory::create(size); });
+	Run("Memory::createPooled", [](sl_size size) { return Memory::createPooled(size); });
+
+	for (sl_uint32 i = 0; i < SLIB_MEMORY_POOL_SIZE_CLASS_COUNT; i++) {
+		MemoryPoolStatistics stats;
+		MemoryPool::getStatistics(i, stats);
+		if (stats.hitCount || stats.missCount) {
+			Println("%d bytes: hit=%d, miss=%d, cached=%d", stats.blockSize, stats.hitCount, stats.missCount, stats.cachedCount);
+		}
+	}
+	MemoryPool::trim();
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <slib.h>
+
+#include <regex>
+
+using namespace slib;
+
+static const char* g_patterns[] = {
+	"", "a", "abc", "a*", "a+b", "a?b?c?", "(ab)*", "(a|b)*c", "a{2}", "a{2,}", "a{1,3}b", "(?:ab|cd)+e",
+	"^ab", "ab$", "^$", "^a*$", ".*", "a.c", "[abc]+", "[^abc]+", "[a-c0-9]*", "[\\d\\s]+", "\\w+", "\\W", "\\D\\S",
+	"\\bab\\b", "\\Bb", "a\\x62", "\\.", "[.\\]]", "(a*)*b", "(a|aa)+$", "(x+x+)+y", "a*?b", "ab|cd|ef", "(^a|b$)",
+	"[a-]+", "c\\b", "\\b", "(a|)+"
+};
+
+static const char* g_subjects[] = {
+	"", "a", "ab", "abc", "aab", "aaab", "cab", "abab", "abcd", "ab cd", "cdcde", "xxxxy", "a.c", "a\nc", "0 1",
+	"ab ab", "bbbc", "aaaaaaaaaa", "zab", "]", "-a-", "abc abc_d"
+};
+
+int main(int argc, const char * argv[])
+{
+	// compares with std::regex
+	sl_uint32 nCompared = 0;
+	for (sl_size i = 0; i < CountOfArray(g_patterns); i++) {
+		for (int icase = 0; icase < 2; icase++) {
+			RegularExpression re(g_patterns[i], icase ? RegularExpressionFlags::Icase : RegularExpressionFlags::Default);
+			std::regex sre(g_patterns[i], icase ? std::regex_constants::icase | std::regex_constants::ECMAScript : std::regex_constants::ECMAScript);
+			for (sl_size k = 0; k < CountOfArray(g_subjects); k++) {
+				const char* s = g_subjects[k];
+				String upper = String(s).toUpper();
+				SLIB_ASSERT(re.match(s) == std::regex_match(s, sre));
+				SLIB_ASSERT(re.search(s) == std::regex_search(s, sre));
+				SLIB_ASSERT(re.search(upper) == std::regex_search(upper.getData(), sre));
+				SLIB_ASSERT(re.search(s, RegularExpressionMatchFlags::NotBol) == std::regex_search(s, sre, std::regex_constants::match_not_bol));
+				SLIB_ASSERT(re.search(s, RegularExpressionMatchFlags::NotEol) == std::regex_search(s, sre, std::regex_constants::match_not_eol));
+				SLIB_ASSERT(re.search(s, RegularExpressionMatchFlags::Continuous) == std::regex_search(s, sre, std::regex_constants::match_continuous));
+				SLIB_ASSERT(re.search(s, RegularExpressionMatchFlags::NotNull) == std::regex_search(s, sre, std::regex_constants::match_not_null));
+				nCompared++;
+			}
+		}
+	}
+	Println("Compared: %d", nCompared);
+
+	// the pattern which has too many DFA states falls back to NFA simulation
+	{
+		const char* pattern = "[ab]*a[ab]{14}c";
+		RegularExpression re(pattern);
+		std::regex sre(pattern);
+		String s = String::allocate(20000);
+		sl_char8* p = s.getData();
+		for (sl_uint32 i = 0; i < 20000; i++) {
+			p[i] = (Math::randomInt() & 1) ? 'a' : 'b';
+		}
+		p[19999] = 'c';
+		SLIB_ASSERT(re.match(s) == std::regex_match(p, p + 20000, sre));
+		p[19984] = 'b';
+		SLIB_ASSERT(re.match(s) == std::regex_match(p, p + 20000, sre));
+		SLIB_ASSERT(!(re.search(s.substring(0, 19999))));
+	}
+
+	// backreferences and lookarounds are processed by std::regex
+	SLIB_ASSERT(RegularExpression("(a+)b\\1").match("aabaa"));
+	SLIB_ASSERT(!(RegularExpression("(a+)b\\1").match("aaba")));
+	SLIB_ASSERT(RegularExpression("a(?=b)").search("ab"));
+	SLIB_ASSERT(RegularExpression("a+", RegularExpressionFlags::StdRegex).match("aaa"));
+	SLIB_ASSERT(RegularExpression("a|b", RegularExpressionFlags::Extended).match("b"));
+	SLIB_ASSERT(RegularExpression("(ab").isNone());
+	SLIB_ASSERT(RegularExpression("a**").isNone());
+
+	SLIB_ASSERT(RegularExpression::matchEmail("test@example.com"));
+	SLIB_ASSERT(!(RegularExpression::matchEmail("test@example..com")));
+
+	// catastrophic backtracking patterns run in linear time
+	{
+		String s('a', 100000);
+		TimeCounter tc;
+		sl_bool r1 = RegularExpression("(a*)*b").match(s);
+		sl_bool r2 = RegularExpression("(a|aa)+c").search(s);
+		sl_bool r3 = RegularExpression("(x+x+)+y|a$").search(s);
+		SLIB_ASSERT(!r1 && !r2 && r3);
+		Println("Pathological: %dms", tc.getElapsedMilliseconds());
+	}
+
+	// searching in a large text
+	{
+		StringBuffer sb;
+		for (sl_uint32 i = 0; i < 100000; i++) {
+			sb.add(String::format("line %d: the quick brown fox jumps over the lazy dog\n", i));
+		}
+		sb.add("error: code=1234\n");
+		String text = sb.merge();
+		const char* pattern = "error: code=\\d+";
+		TimeCounter tc;
+		RegularExpression re(pattern);
+		sl_bool r1 = re.search(text);
+		sl_uint64 t1 = tc.getElapsedMilliseconds();
+		tc.reset();
+		std::regex sre(pattern);
+		sl_bool r2 = std::regex_search(text.getData(), text.getData() + text.getLength(), sre);
+		sl_uint64 t2 = tc.getElapsedMilliseconds();
+		tc.reset();
+		RegularExpression re2("[a-z]+: code=\\d+");
+		sl_bool r3 = re2.search(text);
+		sl_uint64 t3 = tc.getElapsedMilliseconds();
+		SLIB_ASSERT(r1 && r2 && r3);
+		Println("Search %d bytes: native=%dms, std::regex=%dms, native without prefix=%dms", text.getLength(), t1, t2, t3);
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,180 @@
+#include <slib.h>
+
+#include <time.h>
+#include <stdlib.h>
+
+using namespace slib;
+
+#define THREAD_COUNT 8
+#define ITERATIONS 200000
+
+static sl_int64 GetLibcOffset(sl_int64 t)
+{
+	time_t v = (time_t)t;
+	tm comps;
+	if (!(localtime_r(&v, &comps))) {
+		return 0;
+	}
+	return comps.tm_gmtoff;
+}
+
+// compares the offsets with libc for every zone of the system database
+static void TestZones(const String& dir)
+{
+	List<String> names = File::getAllDescendantFiles(dir);
+	sl_uint32 nZones = 0;
+	sl_uint32 nMismatches = 0;
+	for (auto& name : names) {
+		if (!(SLIB_CHAR_IS_ALPHA(name.getAt(0)) && name.getAt(0) <= 'Z') || name.contains('.') || name.startsWith("SystemV")) {
+			continue;
+		}
+		Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::load(name);
+		if (zone.isNull()) {
+			continue;
+		}
+		setenv("TZ", name.getData(), 1);
+		tzset();
+		nZones++;
+		// 1950 ~ 2100, in steps of about 11 days
+		for (sl_int64 t = -631152000; t < 4102444800LL; t += 987654) {
+			if (zone->getOffsetAt(t) != GetLibcOffset(t)) {
+				if (nMismatches < 10) {
+					Println("Mismatch: %s at %s, %d != %d", name, Time::withSeconds(t).toString(TimeZone::UTC()), zone->getOffsetAt(t), GetLibcOffset(t));
+				}
+				nMismatches++;
+			}
+		}
+	}
+	unsetenv("TZ");
+	tzset();
+	SLIB_ASSERT(!nMismatches);
+	Println("Zones: %d, mismatches=%d", nZones, nMismatches);
+}
+
+static void TestRules()
+{
+	Ref<ZoneInfoTimeZone> zone = ZoneInfoTimeZone::createFromRule("EST5EDT,M3.2.0,M11.1.0");
+	SLIB_ASSERT(zone.isNotNull());
+	// 2024-03-10 07:00 UTC: daylight saving starts at 02:00 EST
+	SLIB_ASSERT(zone->getOffsetAt(1710054000 - 1) == -5 * 3600);
+	SLIB_ASSERT(zone->getOffsetAt(1710054000) == -4 * 3600);
+	// 2024-11-03 06:00 UTC: ends at 02:00 EDT
+	SLIB_ASSERT(zone->getOffsetAt(1730613600 - 1) == -4 * 3600);
+	SLIB_ASSERT(zone->getOffsetAt(1730613600) == -5 * 3600);
+
+	// southern hemisphere
+	zone = ZoneInfoTimeZone::createFromRule("AEST-10AEDT,M10.1.0,M4.1.0/3");
+	SLIB_ASSERT(zone.isNotNull());
+	SLIB_ASSERT(zone->getOffsetAt(Time(2024, 1, 15, TimeZone::UTC()).getSecondCount()) == 11 * 3600);
+	SLIB_ASSERT(zone->getOffsetAt(Time(2024, 7, 15, TimeZone::UTC()).getSecondCount()) == 10 * 3600);
+
+	zone = ZoneInfoTimeZone::createFromRule("<+0330>-3:30");
+	SLIB_ASSERT(zone.isNotNull() && zone->getOffsetAt(0) == 12600);
+	SLIB_ASSERT(ZoneInfoTimeZone::createFromRule("5EST").isNull());
+	SLIB_ASSERT(ZoneInfoTimeZone::createFromRule("EST5EDT,M13.1.0,M11.1.0").isNull());
+
+	// local time in a zone
+	zone = ZoneInfoTimeZone::createFromRule("CET-1CEST,M3.5.0,M10.5.0/3");
+	TimeZone cet(zone);
+	Time t(2024, 7, 1, 12, 0, 0, 0, 0, cet);
+	SLIB_ASSERT(t.getSecondCount() == Time(2024, 7, 1, 10, 0, 0, 0, 0, TimeZone::UTC()).getSecondCount());
+	SLIB_ASSERT(t.getHour(cet) == 12);
+	t = Time(2024, 1, 1, 12, 0, 0, 0, 0, cet);
+	SLIB_ASSERT(t.getHour(TimeZone::UTC()) == 11);
+	Println("Rules: OK");
+}
+
+// civil time of UTC is calculated without libc
+static void TestUTC()
+{
+	for (sl_int64 t = -5000000000LL; t < 10000000000LL; t += 7777777) {
+		time_t v = (time_t)t;
+		tm comps;
+		gmtime_r(&v, &comps);
+		TimeComponents c;
+		Time::withSeconds(t).getUTC(c);
+		SLIB_ASSERT(c.year == comps.tm_year + 1900 && c.month == comps.tm_mon + 1 && c.day == comps.tm_mday && c.dayOfWeek == comps.tm_wday);
+		SLIB_ASSERT(c.hour == comps.tm_hour && c.minute == comps.tm_min && c.second == comps.tm_sec);
+		SLIB_ASSERT(Time(c, TimeZone::UTC()).getSecondCountF() == (double)t);
+	}
+	Println("UTC: OK");
+}
+
+// local time uses the zone of `TZ` or `/etc/localtime`, and follows the changes checked once per second
+static void TestLocal(const char* tz)
+{
+	if (tz) {
+		setenv("TZ", tz, 1);
+	} else {
+		unsetenv("TZ");
+	}
+	tzset();
+	Thread::sleep(1100);
+	sl_uint32 nMismatches = 0;
+	for (sl_int64 t = 0; t < 4102444800LL; t += 3333333) {
+		time_t v = (time_t)t;
+		tm comps;
+		localtime_r(&v, &comps);
+		TimeComponents c;
+		Time::withSeconds(t).get(c);
+		if (!(c.year == comps.tm_year + 1900 && c.month == comps.tm_mon + 1 && c.day == comps.tm_mday && c.hour == comps.tm_hour && c.minute == comps.tm_min)) {
+			nMismatches++;
+		}
+		if (Time(c).getSecondCountF() != (double)t) {
+			nMismatches++;
+		}
+	}
+	SLIB_ASSERT(!nMismatches);
+	Println("Local (TZ=%s): mismatches=%d, offset=%d", tz ? tz : "<not set>", nMismatches, Time::now().getLocalTimeOffset());
+}
+
+static void Benchmark(const char* name, const Function<void()>& task)
+{
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < THREAD_COUNT; i++) {
+		threads.add_NoLock(Thread::start([task]() {
+			for (sl_uint32 k = 0; k < ITERATIONS; k++) {
+				task();
+			}
+		}));
+	}
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	Println("%s: %dms", name, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	TestRules();
+	TestUTC();
+	const char* tzs[] = { sl_null, "Asia/Seoul", "America/New_York", "Europe/London", "Australia/Lord_Howe", "EST5EDT,M3.2.0,M11.1.0", "<+0330>-3:30", "", sl_null };
+	for (sl_size i = 0; i < CountOfArray(tzs); i++) {
+		TestLocal(tzs[i]);
+	}
+	if (File::isDirectory("/usr/share/zoneinfo")) {
+		TestZones("/usr/share/zoneinfo");
+	}
+
+	Benchmark("localtime_r", []() {
+		time_t t = time(sl_null);
+		tm v;
+		localtime_r(&t, &v);
+	});
+	Benchmark("Time::now().toString()", []() {
+		Time::now().toString();
+	});
+	Benchmark("CachedTimeText::getLocalString()", []() {
+		CachedTimeText::getLocalString();
+	});
+	Benchmark("Time::now()", []() {
+		Time::now();
+	});
+	Benchmark("Time::nowCoarse()", []() {
+		Time::nowCoarse();
+	});
+	SLIB_ASSERT(CachedTimeText::getHttpDate().endsWith(" GMT"));
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,378 @@
+#include <slib.h>
+#include <slib/core/timing_wheel.h>
+
+using namespace slib;
+
+#define SERVER_PORT 18431
+
+static sl_uint32 nErrors = 0;
+
+static void Check(sl_bool flag, const char* message)
+{
+	if (!flag) {
+		Println("Failed: %s", message);
+		nErrors++;
+	}
+}
+
+struct Fired
+{
+	sl_uint64 expireTime;
+	sl_uint32 order;
+	sl_uint64 now;
+};
+
+static void TestOrder()
+{
+	TimingWheel wheel(0, 1);
+	CList<Fired> fired;
+	volatile sl_uint64 now = 0;
+	sl_uint64 seed = 7;
+	sl_uint32 nAdded = 0;
+	for (sl_uint32 i = 0; i < 3000; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		// several entries share the same tick
+		sl_uint64 t = 1 + (sl_uint32)(seed >> 33) % 1000;
+		Fired item = {t, i, 0};
+		if (wheel.add(t, [&fired, &now, item]() {
+			Fired f = item;
+			f.now = now;
+			fired.add_NoLock(f);
+		})) {
+			nAdded++;
+		}
+	}
+	Check(nAdded == 3000 && wheel.getCount() == 3000, "add");
+	// one advance spans all the ticks
+	now = 1000;
+	wheel.advance(now);
+	Check(fired.getCount() == 3000 && !(wheel.getCount()), "all expired");
+	sl_uint32 nDisorder = 0;
+	for (sl_size i = 1; i < fired.getCount(); i++) {
+		Fired& a = fired[i - 1];
+		Fired& b = fired[i];
+		if (a.expireTime > b.expireTime || (a.expireTime == b.expireTime && a.order > b.order)) {
+			nDisorder++;
+		}
+	}
+	Check(!nDisorder, "entries run in the order of the deadlines, and in the order of adding on the same tick");
+
+	// coarse ticks: the entries in one tick keep the order of adding
+	TimingWheel wheel2(0, 100);
+	fired.removeAll_NoLock();
+	for (sl_uint32 i = 0; i < 50; i++) {
+		Fired item = {(sl_uint64)(199 - i), i, 0};
+		wheel2.add(item.expireTime, [&fired, item]() {
+			fired.add_NoLock(item);
+		});
+	}
+	wheel2.advance(199);
+	Check(!(fired.getCount()), "no early expiration");
+	wheel2.advance(200);
+	nDisorder = 0;
+	for (sl_size i = 0; i < fired.getCount(); i++) {
+		if (fired[i].order != i) {
+			nDisorder++;
+		}
+	}
+	Check(fired.getCount() == 50 && !nDisorder, "same tick keeps the order of adding");
+}
+
+static void TestCascade()
+{
+	TimingWheel wheel(0, 1);
+	CList<Fired> fired;
+	volatile sl_uint64 now = 0;
+	// one entry on each level, and the entries beyond the range of the wheel
+	sl_uint64 times[] = {
+		5, 255, 256, 257, 300, 65535, 65536, 65537, 70000,
+		16777215, 16777216, 16777217, 17000000,
+		4294967295ULL, 4294967296ULL, 4294967297ULL, 5000000000ULL
+	};
+	sl_uint32 nTimes = (sl_uint32)(CountOfArray(times));
+	for (sl_uint32 i = 0; i < nTimes; i++) {
+		Fired item = {times[i], i, 0};
+		wheel.add(times[i], [&fired, &now, item]() {
+			Fired f = item;
+			f.now = now;
+			fired.add_NoLock(f);
+		});
+	}
+	Check(wheel.getNextExpireTime() >= 0 && (sl_uint64)(wheel.getNextExpireTime()) <= 5, "next expire time");
+
+	// fine steps around every boundary, and coarse jumps between them
+	sl_uint32 nEarly = 0;
+	sl_uint32 nLate = 0;
+	for (sl_uint32 i = 0; i < nTimes; i++) {
+		sl_uint64 t = times[i];
+		sl_uint64 start = t > 3 ? t - 3 : 0;
+		if (start > now) {
+			now = start;
+			wheel.advance(now);
+		}
+		for (sl_uint64 k = now + 1; k <= t + 2; k++) {
+			now = k;
+			wheel.advance(now);
+		}
+	}
+	for (sl_size i = 0; i < fired.getCount(); i++) {
+		Fired& f = fired[i];
+		if (f.now < f.expireTime) {
+			nEarly++;
+		}
+		if (f.now > f.expireTime) {
+			nLate++;
+		}
+	}
+	Check(fired.getCount() == nTimes && !(wheel.getCount()), "cascaded entries expire");
+	Check(!nEarly && !nLate, "cascaded entries expire on their ticks");
+	sl_uint32 nDisorder = 0;
+	for (sl_size i = 0; i < fired.getCount(); i++) {
+		if (fired[i].order != i) {
+			nDisorder++;
+		}
+	}
+	Check(!nDisorder, "cascaded entries keep the order of the deadlines");
+
+	// a single advance over all the levels
+	TimingWheel wheel2(0, 1);
+	fired.removeAll_NoLock();
+	for (sl_uint32 i = 0; i < nTimes - 4; i++) {
+		Fired item = {times[nTimes - 5 - i], nTimes - 5 - i, 0};
+		wheel2.add(item.expireTime, [&fired, item]() {
+			fired.add_NoLock(item);
+		});
+	}
+	wheel2.advance(20000000);
+	nDisorder = 0;
+	for (sl_size i = 0; i < fired.getCount(); i++) {
+		if (fired[i].order != i) {
+			nDisorder++;
+		}
+	}
+	Check(fired.getCount() == nTimes - 4 && !nDisorder, "single advance over all the levels");
+}
+
+static void TestCancel()
+{
+	TimingWheel wheel(0, 1);
+	sl_uint32 counts[100] = {0};
+	sl_uint64 ids[100];
+	for (sl_uint32 i = 0; i < 100; i++) {
+		ids[i] = wheel.add(10 + i * 100, [&counts, i]() {
+			counts[i]++;
+		});
+	}
+	sl_uint32 nRemoved = 0;
+	for (sl_uint32 i = 1; i < 100; i += 2) {
+		if (wheel.remove(ids[i])) {
+			nRemoved++;
+		}
+	}
+	Check(nRemoved == 50 && wheel.getCount() == 50, "remove");
+	sl_bool flagRemoved = wheel.remove(ids[1]);
+	Check(!flagRemoved, "remove twice");
+	// rescheduled before expiring, and after cascading
+	sl_bool flagRescheduled = wheel.reschedule(ids[0], 20000);
+	Check(flagRescheduled, "reschedule");
+	flagRescheduled = wheel.reschedule(ids[1], 20000);
+	Check(!flagRescheduled, "reschedule the removed entry");
+	wheel.advance(9000);
+	flagRescheduled = wheel.reschedule(ids[98], 30000);
+	Check(flagRescheduled, "reschedule the cascaded entry");
+	wheel.advance(10000);
+	sl_uint32 nWrong = 0;
+	for (sl_uint32 i = 0; i < 100; i++) {
+		sl_uint32 expected = (i & 1) || !i || i == 98 ? 0 : 1;
+		if (counts[i] != expected) {
+			nWrong++;
+		}
+	}
+	Check(!nWrong, "removed and rescheduled entries do not run");
+	wheel.advance(30000);
+	Check(counts[0] == 1 && counts[98] == 1 && !(wheel.getCount()), "rescheduled entries run");
+
+	// the ids of the freed entries are not reused
+	sl_uint64 id = wheel.add(30010, []() {});
+	flagRemoved = wheel.remove(ids[2]);
+	Check(!flagRemoved && wheel.getCount() == 1, "stale id");
+	flagRemoved = wheel.remove(id);
+	Check(flagRemoved && !(wheel.getCount()), "remove by id");
+
+	// removing and rescheduling from the callbacks: the entries on the same tick are already collected
+	sl_uint32 nA = 0, nB = 0, nC = 0, nD = 0;
+	sl_uint64 idB = 0, idC = 0, idD = 0;
+	TimingWheel* pWheel = &wheel;
+	wheel.add(30100, [&]() {
+		nA++;
+		pWheel->remove(idB);
+		pWheel->reschedule(idC, 30500);
+	});
+	idB = wheel.add(30100, [&]() {
+		nB++;
+	});
+	idC = wheel.add(30100, [&]() {
+		nC++;
+	});
+	idD = wheel.add(30100, [&]() {
+		nD++;
+		// rescheduling itself keeps the entry
+		if (nD < 3) {
+			pWheel->reschedule(idD, 30200 + nD * 100);
+		}
+	});
+	wheel.advance(30100);
+	Check(nA == 1 && !nB && !nC && nD == 1, "removed in the callback");
+	wheel.advance(30300);
+	Check(!nC && nD == 2, "rescheduled in the callback");
+	wheel.advance(31000);
+	Check(nC == 1 && nD == 3 && !(wheel.getCount()), "entries rescheduled in the callbacks run later");
+
+	// deadlines: `check` returns the next deadline
+	sl_uint32 nChecks = 0;
+	wheel.addDeadline(32000, [&nChecks](sl_uint64 now) -> sl_uint64 {
+		nChecks++;
+		if (nChecks < 5) {
+			return now + 1000;
+		}
+		return 0;
+	});
+	for (sl_uint64 t = 32000; t <= 40000; t += 500) {
+		wheel.advance(t);
+	}
+	Check(nChecks == 5 && !(wheel.getCount()), "deadline");
+
+	// removeAll in the callback
+	sl_uint32 nRun = 0;
+	for (sl_uint32 i = 0; i < 10; i++) {
+		wheel.add(41000, [&nRun, pWheel]() {
+			nRun++;
+			pWheel->removeAll();
+		});
+	}
+	wheel.add(42000, [&nRun]() {
+		nRun++;
+	});
+	wheel.advance(50000);
+	Check(nRun == 1 && !(wheel.getCount()), "removeAll in the callback");
+}
+
+static void TestDispatchLoop()
+{
+	Ref<DispatchLoop> loop = DispatchLoop::create();
+	Check(loop.isNotNull(), "dispatch loop");
+	if (loop.isNull()) {
+		return;
+	}
+	Mutex lock;
+	List<sl_uint32> order;
+	sl_uint64 seed = 3;
+	sl_uint32 delays[40];
+	for (sl_uint32 i = 0; i < 40; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		delays[i] = 50 + ((sl_uint32)(seed >> 33) % 20) * 20;
+	}
+	// blocks the loop, so that the delayed tasks expire together
+	loop->dispatch([]() {
+		Thread::sleep(600);
+	});
+	for (sl_uint32 i = 0; i < 40; i++) {
+		sl_uint32 index = i;
+		loop->dispatch([&lock, &order, index]() {
+			MutexLocker locker(&lock);
+			order.add_NoLock(index);
+		}, delays[i]);
+	}
+	volatile sl_int32 nTimer = 0;
+	Ref<Timer> timer = Timer::startWithLoop(loop, [&nTimer](Timer*) {
+		Base::interlockedIncrement32(&nTimer);
+	}, 50);
+	Thread::sleep(1000);
+	timer->stopAndWait();
+	sl_int32 nTimerStopped = nTimer;
+	Thread::sleep(200);
+	MutexLocker locker(&lock);
+	Check(order.getCount() == 40, "delayed tasks");
+	sl_uint32 nDisorder = 0;
+	for (sl_size i = 1; i < order.getCount(); i++) {
+		sl_uint32 a = order[i - 1];
+		sl_uint32 b = order[i];
+		if (delays[a] > delays[b] || (delays[a] == delays[b] && a > b)) {
+			nDisorder++;
+		}
+	}
+	Check(!nDisorder, "delayed tasks run in the order of the deadlines");
+	Check(nTimerStopped >= 5 && nTimer == nTimerStopped, "timer");
+	loop->release();
+}
+
+static sl_int32 Receive(const Socket& socket, sl_int32 timeout)
+{
+	char buf[4096];
+	sl_reg n = socket.receiveFully(buf, sizeof(buf), sl_null, timeout);
+	if (n == SLIB_IO_TIMEOUT) {
+		return -1;
+	}
+	if (n < 0) {
+		return 0;
+	}
+	return (sl_int32)n;
+}
+
+static void TestHttpServer()
+{
+	HttpServerParam param;
+	param.port = SERVER_PORT;
+	param.connectionExpiringDuration = 1500;
+	param.onRequest = [](HttpServerContext* context) -> Variant {
+		return "OK";
+	};
+	Ref<HttpServer> server = HttpServer::create(param);
+	Check(server.isNotNull(), "http server");
+	if (server.isNull()) {
+		return;
+	}
+	SocketAddress address(IPv4Address(127, 0, 0, 1), SERVER_PORT);
+	Socket idle = Socket::openTcp_ConnectAndWait(address, 3000);
+	Socket active = Socket::openTcp_ConnectAndWait(address, 3000);
+	Check(idle.isOpened() && active.isOpened(), "connect");
+	if (!(idle.isOpened() && active.isOpened())) {
+		return;
+	}
+	idle.setNonBlockingMode();
+	active.setNonBlockingMode();
+	const char* request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+	sl_size lenRequest = Base::getStringLength(request);
+	sl_uint32 nResponses = 0;
+	sl_bool flagIdleClosed = sl_false;
+	sl_uint64 timeIdleClosed = 0;
+	TimeCounter tc;
+	while (tc.getElapsedMilliseconds() < 5000) {
+		if (active.sendFully(request, lenRequest, sl_null, 1000) == (sl_reg)lenRequest && Receive(active, 200) > 0) {
+			nResponses++;
+		}
+		if (!flagIdleClosed && !(Receive(idle, 100))) {
+			flagIdleClosed = sl_true;
+			timeIdleClosed = tc.getElapsedMilliseconds();
+		}
+	}
+	Println("Idle connection closed after %dms, %d responses on the active connection", (sl_int32)timeIdleClosed, nResponses);
+	Check(flagIdleClosed && timeIdleClosed >= 1400 && timeIdleClosed < 4000, "idle connection expires");
+	Check(nResponses >= 10 && Receive(active, 0) == -1, "active connection is kept");
+	server->release();
+}
+
+int main(int argc, const char * argv[])
+{
+	TestOrder();
+	TestCascade();
+	TestCancel();
+	TestDispatchLoop();
+	TestHttpServer();
+	if (nErrors) {
+		Println("Failed: %d", nErrors);
+		return 1;
+	}
+	Println("OK");
+	return 0;
+}
@@ -0,0 +1,450 @@
+#include <slib.h>
+#include <slib/data/xml_push_parser.h>
+#include <slib/io/memory_reader.h>
+#include <slib/io/async_file.h>
+
+using namespace slib;
+
+static sl_uint32 nErrors = 0;
+
+static void Check(sl_bool flag, const String& message)
+{
+	if (!flag) {
+		Println("Failed: %s", message);
+		nErrors++;
+	}
+}
+
+// records the events as text; adjacent text pieces are joined
+class EventLog
+{
+public:
+	StringBuffer events;
+	StringBuffer text;
+	sl_uint32 nTextPieces = 0;
+	sl_size maxTextPiece = 0;
+
+public:
+	void flushText()
+	{
+		if (text.getLength()) {
+			events.add("T:" + text.merge() + "\n");
+			text.clear();
+		}
+	}
+
+	void add(const String& event)
+	{
+		flushText();
+		events.add(event + "\n");
+	}
+
+	String merge()
+	{
+		flushText();
+		return events.merge();
+	}
+
+};
+
+// copies the options of `options`, and records the events into `log`
+static XmlPushParser_Param MakeParam(EventLog* log, const XmlPushParser_Param& options)
+{
+	XmlPushParser_Param param;
+	param.maxTokenSize = options.maxTokenSize;
+	param.maxDepth = options.maxDepth;
+	param.flagDecodeEntities = options.flagDecodeEntities;
+	param.flagIgnoreWhiteSpaces = options.flagIgnoreWhiteSpaces;
+	param.onStartElement = [log](XmlPushParser*, const StringView& name, const XmlPushAttribute* attributes, sl_size nAttributes) {
+		StringBuffer sb;
+		sb.add("S:" + name);
+		for (sl_size i = 0; i < nAttributes; i++) {
+			sb.add(" " + attributes[i].name + "=[" + attributes[i].value + "]");
+		}
+		log->add(sb.merge());
+	};
+	param.onEndElement = [log](XmlPushParser*, const StringView& name) {
+		log->add("E:" + name);
+	};
+	param.onText = [log](XmlPushParser*, const StringView& text) {
+		log->text.add(text);
+		log->nTextPieces++;
+		if (text.getLength() > log->maxTextPiece) {
+			log->maxTextPiece = text.getLength();
+		}
+	};
+	param.onCDATA = [log](XmlPushParser*, const StringView& text) {
+		log->add("C:[" + text + "]");
+	};
+	param.onComment = [log](XmlPushParser*, const StringView& content) {
+		log->add("M:[" + content + "]");
+	};
+	param.onProcessingInstruction = [log](XmlPushParser*, const StringView& target, const StringView& content) {
+		log->add("P:" + target + "=[" + content + "]");
+	};
+	return param;
+}
+
+struct Result
+{
+	sl_bool flagSuccess;
+	String log;
+	String error;
+	sl_uint64 errorPosition;
+};
+
+// pushes `doc` in chunks which end at `splits` (sorted)
+static Result Parse(const XmlPushParser_Param& options, const String& doc, const sl_size* splits, sl_size nSplits, EventLog* pLog = sl_null)
+{
+	EventLog logLocal;
+	EventLog& log = pLog ? *pLog : logLocal;
+	Ref<XmlPushParser> parser = XmlPushParser::create(MakeParam(&log, options));
+	const sl_char8* data = doc.getData();
+	sl_size len = doc.getLength();
+	sl_size start = 0;
+	sl_bool flagSuccess = sl_true;
+	for (sl_size i = 0; i <= nSplits && flagSuccess; i++) {
+		sl_size end = i < nSplits ? splits[i] : len;
+		flagSuccess = parser->push(data + start, end - start);
+		start = end;
+	}
+	if (flagSuccess) {
+		flagSuccess = parser->finish();
+	}
+	Result ret;
+	ret.flagSuccess = flagSuccess;
+	ret.log = log.merge();
+	ret.error = parser->getErrorMessage();
+	ret.errorPosition = parser->getErrorPosition();
+	return ret;
+}
+
+static Result ParseWhole(const String& doc, const XmlPushParser_Param& options)
+{
+	return Parse(options, doc, sl_null, 0);
+}
+
+static Result ParseSplit(const String& doc, const XmlPushParser_Param& options, sl_size split)
+{
+	return Parse(options, doc, &split, 1);
+}
+
+static Result ParseBytes(const String& doc, const XmlPushParser_Param& options, EventLog* pLog = sl_null)
+{
+	List<sl_size> splits;
+	for (sl_size i = 1; i < doc.getLength(); i++) {
+		splits.add_NoLock(i);
+	}
+	return Parse(options, doc, splits.getData(), splits.getCount(), pLog);
+}
+
+// the document gives the same events however it is split
+static void CheckSplits(const String& name, const String& doc, const XmlPushParser_Param& param, const Result& expected)
+{
+	sl_uint32 nMismatch = 0;
+	for (sl_size i = 0; i <= doc.getLength(); i++) {
+		Result r = ParseSplit(doc, param, i);
+		if (r.flagSuccess != expected.flagSuccess || r.log != expected.log || r.error != expected.error || r.errorPosition != expected.errorPosition) {
+			if (!nMismatch) {
+				Println("%s: split at %d\n%s%s", name, (sl_int32)i, r.log, r.error);
+			}
+			nMismatch++;
+		}
+	}
+	Result r = ParseBytes(doc, param);
+	if (r.flagSuccess != expected.flagSuccess || r.log != expected.log || r.error != expected.error || r.errorPosition != expected.errorPosition) {
+		Println("%s: byte by byte\n%s%s", name, r.log, r.error);
+		nMismatch++;
+	}
+	Check(!nMismatch, name + ": splits");
+}
+
+static const char* g_document =
+	"\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	"<!DOCTYPE root [ <!ENTITY e \"<>\"> ]>\n"
+	"<!-- head - comment -->\n"
+	"<root a=\"1 &lt; 2\" b='&#65;&#x42;' c = \"x>y\" d=\"'\">\n"
+	"  text &amp; more &#x4E2D;&quot;&apos;&gt;\n"
+	"  <child/>\n"
+	"  <item id=\"1\">\xED\x95\x9C</item>\n"
+	"  <![CDATA[ <not> & markup ]] ]>]]>\n"
+	"  <?pi some data ? > ?>\n"
+	"  <!-- inner > comment -->\n"
+	"  <e></e >\n"
+	"</root>\n"
+	"<!-- tail -->\n";
+
+static const char* g_events =
+	"M:[ head - comment ]\n"
+	"S:root a=[1 < 2] b=[AB] c=[x>y] d=[']\n"
+	"T:\n  text & more \xE4\xB8\xAD\"'>\n  \n"
+	"S:child\n"
+	"E:child\n"
+	"S:item id=[1]\n"
+	"T:\xED\x95\x9C\n"
+	"E:item\n"
+	"C:[ <not> & markup ]] ]>]\n"
+	"P:pi=[some data ? > ]\n"
+	"M:[ inner > comment ]\n"
+	"S:e\n"
+	"E:e\n"
+	"E:root\n"
+	"M:[ tail ]\n";
+
+static void TestEvents()
+{
+	XmlPushParser_Param param;
+	param.flagIgnoreWhiteSpaces = sl_true;
+	String doc = g_document;
+	Result r = ParseWhole(doc, param);
+	Check(r.flagSuccess, "document: " + r.error);
+	Check(r.log == g_events, "document: events\n" + r.log);
+	CheckSplits("document", doc, param, r);
+
+	// the entities are kept when decoding is disabled
+	param.flagDecodeEntities = sl_false;
+	r = ParseWhole("<a x=\"&lt;\">&amp;&#65;</a>", param);
+	Check(r.flagSuccess && r.log == "S:a x=[&lt;]\nT:&amp;&#65;\nE:a\n", "raw entities\n" + r.log);
+
+	// the white spaces are reported unless ignored
+	param.flagDecodeEntities = sl_true;
+	param.flagIgnoreWhiteSpaces = sl_false;
+	r = ParseWhole(" <a> <b/> </a> ", param);
+	Check(r.flagSuccess && r.log == "S:a\nT: \nS:b\nE:b\nT: \nE:a\n", "white spaces\n" + r.log);
+}
+
+static void TestLimits()
+{
+	XmlPushParser_Param param;
+	param.flagIgnoreWhiteSpaces = sl_true;
+
+	// depth
+	param.maxDepth = 3;
+	String doc = "<a><b><c><d/></c></b></a>";
+	Result r = ParseWhole(doc, param);
+	Check(r.flagSuccess, "depth within the limit");
+	CheckSplits("depth within the limit", doc, param, r);
+	doc = "<a><b><c><d></d></c></b></a>";
+	r = ParseWhole(doc, param);
+	Check(!(r.flagSuccess) && r.error == "Elements are nested too deeply" && r.errorPosition == 12, "depth over the limit: " + r.error);
+	CheckSplits("depth over the limit", doc, param, r);
+	param.maxDepth = 1024;
+
+	// a markup kept across chunks is bounded
+	param.maxTokenSize = 16;
+	doc = "<root><element attribute=\"long value\"/></root>";
+	r = ParseBytes(doc, param);
+	Check(!(r.flagSuccess) && r.error == "Markup is too long", "markup over the limit: " + r.error);
+	doc = "<root><!-- long comment over the limit --></root>";
+	r = ParseBytes(doc, param);
+	Check(!(r.flagSuccess) && r.error == "Markup is too long", "comment over the limit: " + r.error);
+	doc = "<root><e a=\"1\"/></root>";
+	r = ParseBytes(doc, param);
+	Check(r.flagSuccess, "markup within the limit: " + r.error);
+
+	// a long text is delivered in pieces, without splitting the entities
+	StringBuffer sb;
+	StringBuffer sbExpected;
+	sb.addStatic("<root>");
+	for (sl_uint32 i = 0; i < 200; i++) {
+		sb.add(String::fromUint32(i));
+		sbExpected.add(String::fromUint32(i));
+		switch (i % 4) {
+			case 0:
+				sb.addStatic("&amp;");
+				sbExpected.addStatic("&");
+				break;
+			case 1:
+				sb.addStatic("&#x4E2D;");
+				sbExpected.addStatic("\xE4\xB8\xAD");
+				break;
+			case 2:
+				sb.addStatic("&quot;");
+				sbExpected.addStatic("\"");
+				break;
+			default:
+				sb.addStatic(" ");
+				sbExpected.addStatic(" ");
+				break;
+		}
+	}
+	sb.addStatic("</root>");
+	doc = sb.merge();
+	String expected = "S:root\nT:" + sbExpected.merge() + "\nE:root\n";
+	for (sl_size max = 16; max <= 64; max += 7) {
+		param.maxTokenSize = max;
+		EventLog log;
+		r = ParseBytes(doc, param, &log);
+		Check(r.flagSuccess && r.log == expected, String::format("long text (max %d): %s\n%s", max, r.error, r.log));
+		Check(log.nTextPieces > 1 && log.maxTextPiece <= max * 3, String::format("long text (max %d): pieces", max));
+	}
+}
+
+static void TestMalformed()
+{
+	XmlPushParser_Param param;
+	struct Case
+	{
+		const char* doc;
+		const char* error;
+	} cases[] = {
+		{ "", "Root element is missing" },
+		{ "  \n", "Root element is missing" },
+		{ "<?xml version=\"1.0\"?>", "Root element is missing" },
+		{ "<a>", "Unexpected end of document" },
+		{ "<a><b></a></b>", "End tag does not match the start tag" },
+		{ "<a></a></b>", "Unexpected end tag" },
+		{ "<a/><b/>", "Only one root element is allowed" },
+		{ "text<a/>", "Text is not allowed outside of the root element" },
+		{ "<a/>text", "Text is not allowed outside of the root element" },
+		{ "<![CDATA[x]]><a/>", "CDATA is not allowed outside of the root element" },
+		{ "<a x=1/>", "Attribute value must be quoted" },
+		{ "<a x></a>", "Invalid attribute" },
+		{ "<a =\"1\"></a>", "Invalid attribute" },
+		{ "<a x=\"1></a>", "Unexpected end of document in markup" },
+		{ "< a/>", "Element name is empty" },
+		{ "<a>&bogus;</a>", "Invalid entity" },
+		{ "<a>&#xZZ;</a>", "Invalid entity" },
+		{ "<a>&#x110000;</a>", "Invalid entity" },
+		{ "<a>&amp</a>", "Invalid entity" },
+		{ "<a x=\"&unknown;\"/>", "Invalid entity" },
+		{ "<a><!-x></a>", "Invalid comment" },
+		{ "<a><!---></a>", "Unexpected end of document in markup" },
+		{ "<a><![CDAT[x]]></a>", "Invalid CDATA section" },
+		{ "<a><? ?></a>", "Invalid processing instruction" },
+		{ "<a><!-- x", "Unexpected end of document in markup" },
+		{ "<a", "Unexpected end of document in markup" },
+		{ "\xEF\xBB<a/>", "Invalid byte order mark" }
+	};
+	for (sl_size i = 0; i < CountOfArray(cases); i++) {
+		String doc = cases[i].doc;
+		Result r = ParseWhole(doc, param);
+		Check(!(r.flagSuccess) && r.error == cases[i].error, String::format("malformed %s: %s", doc, r.error));
+		Check(r.errorPosition <= doc.getLength(), String::format("malformed %s: position", doc));
+		CheckSplits(String::format("malformed %s", doc), doc, param, r);
+	}
+
+	// the error position points after the markup which is detected as wrong
+	Result r = ParseWhole("<a></b>", param);
+	Check(r.errorPosition == 7, "error position");
+	r = ParseWhole("<a>\n  &bad;</a>", param);
+	Check(r.errorPosition == 11, "error position of text");
+}
+
+static void TestControl()
+{
+	// stop in a callback
+	EventLog log;
+	XmlPushParser_Param param = MakeParam(&log, XmlPushParser_Param());
+	XmlPushParser* stopped = sl_null;
+	param.onStartElement = [&log, &stopped](XmlPushParser* parser, const StringView& name, const XmlPushAttribute*, sl_size) {
+		log.add("S:" + name);
+		if (name == "stop") {
+			stopped = parser;
+			parser->stop();
+		}
+	};
+	Ref<XmlPushParser> parser = XmlPushParser::create(param);
+	sl_bool flagPushed = parser->push("<a><b/><stop/><c/></a>", 22);
+	Check(!flagPushed && stopped == parser.get() && !(parser->isError()), "stop");
+	// no event after stopping
+	Check(log.merge() == "S:a\nS:b\nE:b\nS:stop\n", "stop: events");
+	flagPushed = parser->push("<d/>", 4);
+	Check(!flagPushed, "push after stop");
+
+	// reset after an error
+	log.events.clear();
+	parser->reset();
+	flagPushed = parser->push("<a><b", 5);
+	Check(flagPushed && parser->getDepth() == 1 && parser->getPosition() == 5, "depth and position");
+	flagPushed = parser->push("></c></a>", 9);
+	Check(!flagPushed && parser->isError() && parser->getErrorPosition() == 10, "error");
+	parser->reset();
+	flagPushed = parser->push("<x>1</x>", 8);
+	sl_bool flagFinished = parser->finish();
+	Check(flagPushed && flagFinished && !(parser->isError()) && !(parser->getDepth()), "reset");
+}
+
+static void TestReaders()
+{
+	String doc = g_document;
+	String path = File::concatPath(System::getTempDirectory(), "slib_test_xml_push_parser.xml");
+	sl_bool flagWritten = File::writeAllBytes(path, doc.getData(), doc.getLength());
+	Check(flagWritten, "write the temporary file");
+
+	XmlPushParser_Param options;
+	options.flagIgnoreWhiteSpaces = sl_true;
+	sl_size chunkSizes[] = { 1, 3, 7, 64, 65536 };
+	for (sl_size i = 0; i < CountOfArray(chunkSizes); i++) {
+		sl_size chunkSize = chunkSizes[i];
+		// IReader
+		{
+			EventLog log;
+			Ref<XmlPushParser> parser = XmlPushParser::create(MakeParam(&log, options));
+			MemoryReader reader(doc.getData(), doc.getLength());
+			sl_bool flagSuccess = parser->parse(&reader, chunkSize);
+			Check(flagSuccess && log.merge() == g_events, String::format("IReader (chunk %d)", chunkSize));
+			Check(parser->getPosition() == doc.getLength(), String::format("IReader (chunk %d): position", chunkSize));
+		}
+		// AsyncStream
+		{
+			EventLog log;
+			Ref<XmlPushParser> parser = XmlPushParser::create(MakeParam(&log, options));
+			Ref<AsyncFile> file = AsyncFile::openForRead(path);
+			Check(file.isNotNull(), "open the async file");
+			if (file.isNull()) {
+				continue;
+			}
+			Ref<Event> ev = Event::create();
+			volatile sl_int32 nCompleted = 0;
+			sl_bool flagResult = sl_false;
+			parser->parse(Ref<AsyncStream>::cast(file), [&](XmlPushParser*, sl_bool flagSuccess) {
+				flagResult = flagSuccess;
+				Base::interlockedIncrement32(&nCompleted);
+				ev->set();
+			}, chunkSize);
+			ev->wait(10000);
+			Thread::sleep(10);
+			Check(nCompleted == 1 && flagResult && log.merge() == g_events, String::format("AsyncStream (chunk %d)", chunkSize));
+			file->close();
+		}
+	}
+
+	// malformed document and read errors
+	{
+		EventLog log;
+		XmlPushParser_Param param = MakeParam(&log, XmlPushParser_Param());
+		Ref<XmlPushParser> parser = XmlPushParser::create(param);
+		MemoryReader reader("<a><b></a>", 10);
+		sl_bool flagSuccess = parser->parse(&reader, 4);
+		Check(!flagSuccess && parser->isError(), "IReader: malformed");
+		parser->reset();
+		MemoryReader readerIncomplete("<a><b></b>", 10);
+		flagSuccess = parser->parse(&readerIncomplete, 4);
+		Check(!flagSuccess && parser->getErrorMessage() == "Unexpected end of document", "IReader: incomplete");
+		flagSuccess = parser->parse((IReader*)sl_null);
+		Check(!flagSuccess, "IReader: null");
+		sl_bool flagCalled = sl_false;
+		parser->parse(Ref<AsyncStream>::null(), [&flagCalled](XmlPushParser*, sl_bool flagSuccess) {
+			flagCalled = !flagSuccess;
+		});
+		Check(flagCalled, "AsyncStream: null");
+	}
+
+	File::deleteFile(path);
+}
+
+int main(int argc, const char * argv[])
+{
+	TestEvents();
+	TestLimits();
+	TestMalformed();
+	TestControl();
+	TestReaders();
+	if (nErrors) {
+		Println("Failed: %d", nErrors);
+		return 1;
+	}
+	Println("OK");
+	return 0;
+}
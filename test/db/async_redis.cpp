@@ -0,0 +1,333 @@
+#include <slib.h>
+#include <slib/db/async_redis.h>
+
+using namespace slib;
+
+#define COMMAND_COUNT 100000
+
+// binds to an ephemeral port on the loopback interface
+static Socket OpenListener()
+{
+	Socket socket = Socket::openTcp();
+	if (socket.isOpened() && socket.bind(SocketAddress(IPv4Address(127, 0, 0, 1), 0)) && socket.listen()) {
+		return socket;
+	}
+	return Socket();
+}
+
+// minimal RESP server standing in for Redis: PING, HELLO, SET, GET, INCR, DEL, PUBLISHME (RESP3 push)
+class Server
+{
+public:
+	Socket listener;
+	SocketAddress address;
+	Mutex lock;
+	HashMap<String, String> values;
+	volatile sl_int32 nCommands = 0;
+
+public:
+	sl_bool start()
+	{
+		listener = OpenListener();
+		if (listener.isNone() || !(listener.getLocalAddress(address))) {
+			return sl_false;
+		}
+		Thread::start([this]() {
+			for (;;) {
+				Socket client;
+				SocketAddress addr;
+				if (!(listener.accept(client, addr))) {
+					return;
+				}
+				Socket* p = new Socket(Move(client));
+				Thread::start([this, p]() {
+					serve(*p);
+					delete p;
+				});
+			}
+		});
+		return sl_true;
+	}
+
+	void serve(Socket& socket)
+	{
+		socket.setTcpNoDelay();
+		String input;
+		sl_bool flagResp3 = sl_false;
+		char buf[65536];
+		for (;;) {
+			sl_int32 n = socket.receive(buf, sizeof(buf));
+			if (n <= 0) {
+				return;
+			}
+			input = String::concat(input, StringView(buf, n));
+			String output;
+			sl_size pos = 0;
+			List<String> args;
+			while (parseCommand(input, pos, args)) {
+				Base::interlockedIncrement32(&nCommands);
+				output += execute(args, flagResp3);
+				args.setNull();
+			}
+			input = input.substring(pos);
+			if (output.isNotEmpty() && socket.send(output.getData(), output.getLength()) != (sl_int32)(output.getLength())) {
+				return;
+			}
+		}
+	}
+
+	static sl_bool readLine(const String& input, sl_size& pos, String& line)
+	{
+		sl_reg end = input.indexOf("\r\n", pos);
+		if (end < 0) {
+			return sl_false;
+		}
+		line = input.substring(pos, end);
+		pos = end + 2;
+		return sl_true;
+	}
+
+	static sl_bool parseCommand(const String& input, sl_size& pos, List<String>& args)
+	{
+		sl_size p = pos;
+		String line;
+		if (!(readLine(input, p, line)) || !(line.startsWith('*'))) {
+			return sl_false;
+		}
+		sl_uint32 n = line.substring(1).parseUint32();
+		for (sl_uint32 i = 0; i < n; i++) {
+			if (!(readLine(input, p, line))) {
+				return sl_false;
+			}
+			sl_size len = line.substring(1).parseUint32();
+			if (p + len + 2 > input.getLength()) {
+				return sl_false;
+			}
+			args.add_NoLock(input.substring(p, p + len));
+			p += len + 2;
+		}
+		pos = p;
+		return sl_true;
+	}
+
+	static String bulk(const String& s)
+	{
+		return String::format("$%d\r\n%s\r\n", s.getLength(), s);
+	}
+
+	String execute(const List<String>& args, sl_bool& flagResp3)
+	{
+		String cmd = args.getValueAt_NoLock(0).toUpper();
+		String key = args.getValueAt_NoLock(1);
+		MutexLocker locker(&lock);
+		if (cmd == "PING") {
+			return "+PONG\r\n";
+		} else if (cmd == "HELLO") {
+			flagResp3 = key == "3";
+			if (flagResp3) {
+				return "%2\r\n+server\r\n+stand-in\r\n+proto\r\n:3\r\n";
+			}
+			return "*4\r\n$6\r\nserver\r\n$8\r\nstand-in\r\n$5\r\nproto\r\n:2\r\n";
+		} else if (cmd == "SET") {
+			values.put_NoLock(key, args.getValueAt_NoLock(2));
+			return "+OK\r\n";
+		} else if (cmd == "GET") {
+			String value;
+			if (values.get_NoLock(key, &value)) {
+				return bulk(value);
+			}
+			return flagResp3 ? "_\r\n" : "$-1\r\n";
+		} else if (cmd == "INCR") {
+			sl_int64 n = values.getValue_NoLock(key).parseInt64() + 1;
+			values.put_NoLock(key, String::fromInt64(n));
+			return String::format(":%d\r\n", n);
+		} else if (cmd == "DEL") {
+			return String::format(":%d\r\n", values.remove_NoLock(key) ? 1 : 0);
+		} else if (cmd == "PUBLISHME" && flagResp3) {
+			return String::format(">2\r\n+message\r\n%s#t\r\n", bulk(key));
+		}
+		return String::format("-ERR unknown command '%s'\r\n", cmd);
+	}
+
+};
+
+static AsyncRedisResult Execute(const Promise<AsyncRedisResult>& promise)
+{
+	AsyncRedisResult result;
+	sl_bool flagCompleted = promise.wait(&result, 10000);
+	SLIB_ASSERT(flagCompleted);
+	return result;
+}
+
+static void TestCommands(Server& server)
+{
+	Ref<AsyncRedis> redis = AsyncRedis::create(server.address);
+	SLIB_ASSERT(redis.isNotNull());
+	AsyncRedisResult result = Execute(redis->execute("PING"));
+	SLIB_ASSERT(result.value.getString() == "PONG");
+	result = Execute(redis->set("a", "hello"));
+	SLIB_ASSERT(result.isSuccess());
+	result = Execute(redis->get("a"));
+	SLIB_ASSERT(result.value.getString() == "hello");
+	result = Execute(redis->get("missing"));
+	SLIB_ASSERT(result.value.isNull());
+	result = Execute(redis->incr("n"));
+	SLIB_ASSERT(result.value.getInt64() == 1);
+	result = Execute(redis->incr("n"));
+	SLIB_ASSERT(result.value.getInt64() == 2);
+	result = Execute(redis->del("a"));
+	SLIB_ASSERT(result.value.getInt64() == 1);
+	result = Execute(redis->execute("NOPE"));
+	SLIB_ASSERT(result.isError() && result.error.startsWith("ERR unknown"));
+	// binary safe
+	String binary("a\r\nb\0c", 6);
+	result = Execute(redis->set("bin", binary));
+	SLIB_ASSERT(result.isSuccess());
+	result = Execute(redis->get("bin"));
+	SLIB_ASSERT(result.value.getString() == binary);
+	// large value split over several reads
+	String large('x', 1000000);
+	result = Execute(redis->set("large", large));
+	SLIB_ASSERT(result.isSuccess());
+	result = Execute(redis->get("large"));
+	SLIB_ASSERT(result.value.getString() == large);
+	Println("Commands: OK");
+}
+
+static void TestPipelining(Server& server)
+{
+	Ref<AsyncRedis> redis = AsyncRedis::create(server.address);
+	SLIB_ASSERT(redis.isNotNull());
+	AsyncRedisResult result = Execute(redis->execute("PING"));
+	SLIB_ASSERT(result.isSuccess());
+
+	// sequential round trips
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < COMMAND_COUNT / 100; i++) {
+		Execute(redis->incr("seq"));
+	}
+	sl_uint64 timeSequential = tc.getElapsedMilliseconds() * 100;
+
+	// pipelined
+	tc.reset();
+	Ref<Event> event = Event::create();
+	volatile sl_int32 nRemaining = COMMAND_COUNT;
+	volatile sl_int64 last = 0;
+	volatile sl_bool flagOrdered = sl_true;
+	for (sl_uint32 i = 0; i < COMMAND_COUNT; i++) {
+		Variant args[] = { "INCR", "pipe" };
+		redis->executeBy(args, 2, [&](AsyncRedisResult& result) {
+			sl_int64 n = result.value.getInt64();
+			if (n != last + 1) {
+				flagOrdered = sl_false;
+			}
+			last = n;
+			if (!(Base::interlockedDecrement32(&nRemaining))) {
+				event->set();
+			}
+		});
+	}
+	sl_bool flagCompleted = event->wait(30000);
+	SLIB_ASSERT(flagCompleted);
+	SLIB_ASSERT(flagOrdered && last == COMMAND_COUNT);
+	sl_uint64 timePipelined = tc.getElapsedMilliseconds();
+	Println("Pipelining: %d commands, sequential=%dms (estimated), pipelined=%dms", COMMAND_COUNT, timeSequential, timePipelined);
+}
+
+static void TestSharding(Server& server1, Server& server2)
+{
+	SLIB_ASSERT(AsyncRedis::getHashSlot("123456789") == (0x31C3 & 16383));
+	SLIB_ASSERT(AsyncRedis::getHashSlot("{user1000}.following") == AsyncRedis::getHashSlot("{user1000}.followers"));
+	SLIB_ASSERT(AsyncRedis::getHashSlot("foo{{bar}}zap") == AsyncRedis::getHashSlot("{bar"));
+
+	AsyncRedisParam param;
+	param.addresses.add_NoLock(server1.address);
+	param.addresses.add_NoLock(server2.address);
+	Ref<AsyncRedis> redis = AsyncRedis::create(param);
+	SLIB_ASSERT(redis.isNotNull());
+	SLIB_ASSERT(redis->getShardCount() == 2);
+	sl_int32 n1 = server1.nCommands;
+	sl_int32 n2 = server2.nCommands;
+	List< Promise<AsyncRedisResult> > promises;
+	for (sl_uint32 i = 0; i < 1000; i++) {
+		promises.add_NoLock(redis->set(String::format("key%d", i), i));
+	}
+	sl_uint32 nErrors = 0;
+	for (auto& promise : promises) {
+		if (!(Execute(promise).isSuccess())) {
+			nErrors++;
+		}
+	}
+	for (sl_uint32 i = 0; i < 1000; i++) {
+		if (Execute(redis->get(String::format("key%d", i))).value.getString() != String::fromUint32(i)) {
+			nErrors++;
+		}
+	}
+	SLIB_ASSERT(!nErrors);
+	n1 = server1.nCommands - n1;
+	n2 = server2.nCommands - n2;
+	SLIB_ASSERT(n1 + n2 == 2000 && n1 > 500 && n2 > 500);
+	Println("Sharding: %d/%d commands", n1, n2);
+}
+
+static void TestResp3(Server& server)
+{
+	Ref<Event> eventPush = Event::create();
+	AsyncRedisParam param;
+	param.addresses.add_NoLock(server.address);
+	param.protocolVersion = 3;
+	param.onPush = [eventPush](AsyncRedis*, Variant& message) {
+		VariantList list = message.getVariantList();
+		if (list.getValueAt_NoLock(0).getString() == "message" && list.getValueAt_NoLock(1).getString() == "hi") {
+			eventPush->set();
+		}
+	};
+	Ref<AsyncRedis> redis = AsyncRedis::create(param);
+	SLIB_ASSERT(redis.isNotNull());
+	AsyncRedisResult result = Execute(redis->get("resp3_missing"));
+	SLIB_ASSERT(result.value.isNull());
+	result = Execute(redis->execute("PUBLISHME", "hi"));
+	SLIB_ASSERT(result.value.getBoolean());
+	sl_bool flagPushed = eventPush->wait(10000);
+	SLIB_ASSERT(flagPushed);
+	Println("RESP3: OK");
+}
+
+static void TestErrors(Server& server)
+{
+	// nothing listens on this port
+	Socket socket = OpenListener();
+	SocketAddress address;
+	socket.getLocalAddress(address);
+	socket.close();
+	AsyncRedisParam param;
+	param.addresses.add_NoLock(address);
+	param.flagLogErrors = sl_false;
+	Ref<AsyncRedis> redis = AsyncRedis::create(param);
+	SLIB_ASSERT(redis.isNotNull());
+	AsyncRedisResult result = Execute(redis->get("a"));
+	SLIB_ASSERT(result.isError());
+	// closed client
+	redis = AsyncRedis::create(server.address);
+	result = Execute(redis->execute("PING"));
+	SLIB_ASSERT(result.isSuccess());
+	redis->close();
+	result = Execute(redis->execute("PING"));
+	SLIB_ASSERT(result.error == "Closed");
+	Println("Errors: OK");
+}
+
+int main(int argc, const char * argv[])
+{
+	Server server1, server2;
+	sl_bool flagStarted1 = server1.start();
+	sl_bool flagStarted2 = server2.start();
+	SLIB_ASSERT(flagStarted1 && flagStarted2);
+	TestCommands(server1);
+	TestPipelining(server1);
+	TestSharding(server1, server2);
+	TestResp3(server1);
+	TestErrors(server1);
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include <slib.h>
+#include <slib/db/btree_store.h>
+#include <slib/db/lmdb.h>
+
+using namespace slib;
+
+#define ITEM_COUNT 100000
+#define BATCH_SIZE 1000
+
+static String GetKey(sl_uint32 i)
+{
+	return String::concat("key_", String::fromUint32(i * 7919 % ITEM_COUNT, 10, 8));
+}
+
+static String GetValue(sl_uint32 i)
+{
+	if (i % 1000 == 0) {
+		// large value stored in overflow pages
+		return String('v', 10000 + i % 7);
+	}
+	return String::concat("value_", String::fromUint32(i));
+}
+
+static void TestCorrectness(const String& path)
+{
+	File::deleteFile(path);
+	BTreeStore_Param param;
+	param.path = path;
+	param.flagSync = sl_false;
+	param.cacheSize = 256;
+	Ref<BTreeStore> store = BTreeStore::open(param);
+	SLIB_ASSERT(store.isNotNull());
+
+	for (sl_uint32 k = 0; k < ITEM_COUNT / BATCH_SIZE; k++) {
+		Ref<KeyValueWriteBatch> batch = store->createWriteBatch();
+		for (sl_uint32 i = k * BATCH_SIZE; i < (k + 1) * BATCH_SIZE; i++) {
+			batch->put(GetKey(i), GetValue(i));
+		}
+		sl_bool flagCommitted = batch->commit();
+		SLIB_ASSERT(flagCommitted);
+	}
+	SLIB_ASSERT(store->getCount() == ITEM_COUNT);
+
+	Ref<KeyValueSnapshot> snapshot = store->getSnapshot();
+	for (sl_uint32 i = 0; i < ITEM_COUNT; i += 2) {
+		sl_bool flagRemoved = store->remove(GetKey(i));
+		SLIB_ASSERT(flagRemoved);
+	}
+	SLIB_ASSERT(store->getCount() == ITEM_COUNT / 2);
+	for (sl_uint32 i = 0; i < ITEM_COUNT; i++) {
+		Variant value = store->get(GetKey(i));
+		if (i & 1) {
+			SLIB_ASSERT(value.getString() == GetValue(i));
+		} else {
+			SLIB_ASSERT(value.isUndefined());
+		}
+		// snapshot still sees the removed items
+		SLIB_ASSERT(snapshot->get(GetKey(i)).getString() == GetValue(i));
+	}
+	snapshot.setNull();
+
+	// reopen and iterate in order
+	store.setNull();
+	store = BTreeStore::open(param);
+	SLIB_ASSERT(store.isNotNull());
+	SLIB_ASSERT(store->getCount() == ITEM_COUNT / 2);
+	Ref<KeyValueIterator> iterator = store->getIterator();
+	sl_uint32 n = 0;
+	String last;
+	while (iterator->moveNext()) {
+		String key = iterator->getKey();
+		SLIB_ASSERT(key > last);
+		last = key;
+		n++;
+	}
+	SLIB_ASSERT(n == ITEM_COUNT / 2);
+	sl_bool flagFound = iterator->seek("key_00050000");
+	SLIB_ASSERT(flagFound);
+	SLIB_ASSERT(iterator->getKey() >= "key_00050000");
+	iterator.setNull();
+
+	for (sl_uint32 i = 0; i < ITEM_COUNT; i++) {
+		store->remove(GetKey(i));
+	}
+	SLIB_ASSERT(store->getCount() == 0);
+	Println("Correctness: OK, file size=%d", File::getSize(path));
+}
+
+template <class STORE>
+static void Benchmark(const String& name, const Ref<STORE>& store)
+{
+	TimeCounter tc;
+	for (sl_uint32 k = 0; k < ITEM_COUNT / BATCH_SIZE; k++) {
+		Ref<KeyValueWriteBatch> batch = store->createWriteBatch();
+		for (sl_uint32 i = k * BATCH_SIZE; i < (k + 1) * BATCH_SIZE; i++) {
+			batch->put(GetKey(i), GetValue(i));
+		}
+		batch->commit();
+	}
+	sl_uint64 timeWrite = tc.getElapsedMilliseconds();
+	tc.reset();
+	for (sl_uint32 i = 0; i < ITEM_COUNT; i++) {
+		store->get(GetKey(i));
+	}
+	sl_uint64 timeRead = tc.getElapsedMilliseconds();
+	tc.reset();
+	sl_uint32 n = 0;
+	Ref<KeyValueIterator> iterator = store->getIterator();
+	while (iterator->moveNext()) {
+		n++;
+	}
+	sl_uint64 timeScan = tc.getElapsedMilliseconds();
+	Println("%s: write=%dms, read=%dms, scan=%dms (%d items)", name, timeWrite, timeRead, timeScan, n);
+}
+
+int main(int argc, const char * argv[])
+{
+	String dir = File::concatPath(System::getTempDirectory(), "btree_store_test");
+	File::createDirectories(dir);
+
+	TestCorrectness(File::concatPath(dir, "test.db"));
+
+	{
+		String path = File::concatPath(dir, "bench.db");
+		File::deleteFile(path);
+		BTreeStore_Param param;
+		param.path = path;
+		Benchmark("BTreeStore", BTreeStore::open(param));
+	}
+	{
+		String path = File::concatPath(dir, "lmdb");
+		File::remove(path, FileOperationFlags::Recursive);
+		Ref<LMDB> lmdb = LMDB::open(path);
+		if (lmdb.isNotNull()) {
+			Benchmark("LMDB", lmdb);
+		}
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
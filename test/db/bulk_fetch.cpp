@@ -0,0 +1,146 @@
+#include <slib.h>
+#include <slib/db/sqlite.h>
+
+using namespace slib;
+
+#define ROW_COUNT 200000
+#define BATCH_SIZE 1024
+
+static String GetName(sl_uint32 i)
+{
+	return String::concat("item", String::fromUint32(i));
+}
+
+int main(int argc, const char * argv[])
+{
+	String path = File::concatPath(System::getTempDirectory(), "bulk_fetch_test.db");
+	File::deleteFile(path);
+	Ref<SQLite> db = SQLite::open(path);
+	SLIB_ASSERT(db.isNotNull());
+	db->execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, price REAL, stock INTEGER)");
+
+	// bulk insert
+	{
+		List<Variant> values;
+		for (sl_uint32 i = 0; i < ROW_COUNT; i++) {
+			values.add_NoLock(i);
+			values.add_NoLock(GetName(i));
+			values.add_NoLock(i * 0.5);
+			if (i % 10) {
+				values.add_NoLock(i % 100);
+			} else {
+				values.add_NoLock(sl_null);
+			}
+		}
+		TimeCounter tc;
+		db->startTransaction();
+		sl_int64 n = db->executeBatch("INSERT INTO item (id, name, price, stock) VALUES (?, ?, ?, ?)", values.getData(), 4, ROW_COUNT);
+		db->commitTransaction();
+		SLIB_ASSERT(n == ROW_COUNT);
+		sl_uint64 timeExecuteBatch = tc.getElapsedMilliseconds();
+		db->execute("DELETE FROM item");
+		tc.reset();
+		db->startTransaction();
+		n = db->insertBatch("item", List<String>::createFromElements("id", "name", "price", "stock"), values.getData(), ROW_COUNT);
+		db->commitTransaction();
+		SLIB_ASSERT(n == ROW_COUNT);
+		Println("executeBatch: %dms, insertBatch: %dms", timeExecuteBatch, tc.getElapsedMilliseconds());
+	}
+
+	// correctness
+	{
+		Ref<DatabaseCursor> cursor = db->query("SELECT id, name, price, stock FROM item ORDER BY id");
+		SLIB_ASSERT(cursor.isNotNull());
+		DatabaseRowBatch batch;
+		sl_uint32 nTotal = 0;
+		sl_uint32 nRows;
+		while ((nRows = cursor->fetchBatch(batch, BATCH_SIZE))) {
+			SLIB_ASSERT(batch.getColumnCount() == 4);
+			DatabaseColumnBatch* id = batch.getColumn("id");
+			DatabaseColumnBatch* name = batch.getColumn("name");
+			DatabaseColumnBatch* price = batch.getColumn(2);
+			DatabaseColumnBatch* stock = batch.getColumn(3);
+			SLIB_ASSERT(id->type == DatabaseColumnBatchType::Int64);
+			SLIB_ASSERT(name->type == DatabaseColumnBatchType::String);
+			SLIB_ASSERT(price->type == DatabaseColumnBatchType::Double);
+			SLIB_ASSERT(stock->type == DatabaseColumnBatchType::Int64);
+			const sl_int64* ids = id->getInt64Values();
+			const double* prices = price->getDoubleValues();
+			for (sl_uint32 k = 0; k < nRows; k++) {
+				sl_uint32 i = nTotal + k;
+				SLIB_ASSERT(ids[k] == i);
+				SLIB_ASSERT(name->getStringView(k) == GetName(i));
+				SLIB_ASSERT(prices[k] == i * 0.5);
+				if (i % 10) {
+					SLIB_ASSERT(!(stock->isNull(k)) && stock->getInt64(k) == i % 100);
+				} else {
+					SLIB_ASSERT(stock->isNull(k) && stock->getValue(k).isNull());
+				}
+			}
+			nTotal += nRows;
+		}
+		SLIB_ASSERT(nTotal == ROW_COUNT);
+	}
+
+	// the types set before fetching convert the values
+	{
+		Ref<DatabaseCursor> cursor = db->query("SELECT id, price FROM item WHERE id<?", 10);
+		DatabaseRowBatch batch;
+		batch.columns.setCount_NoLock(2);
+		batch.columns[0].type = DatabaseColumnBatchType::String;
+		batch.columns[1].type = DatabaseColumnBatchType::Int64;
+		sl_uint32 nRows = cursor->fetchBatch(batch, 100);
+		SLIB_ASSERT(nRows == 10);
+		SLIB_ASSERT(batch.columns[0].getString(7) == "7");
+		SLIB_ASSERT(batch.columns[1].getInt64Values()[7] == 3);
+		nRows = cursor->fetchBatch(batch, 100);
+		SLIB_ASSERT(!nRows);
+	}
+
+	// copy a batch into another table
+	{
+		db->execute("CREATE TABLE item_copy (id INTEGER PRIMARY KEY, name TEXT, price REAL, stock INTEGER)");
+		Ref<DatabaseCursor> cursor = db->query("SELECT id, name, price, stock FROM item WHERE id<?", 1000);
+		DatabaseRowBatch batch;
+		sl_uint32 nRows = cursor->fetchBatch(batch, 1000);
+		SLIB_ASSERT(nRows == 1000);
+		cursor.setNull();
+		sl_int64 nInserted = db->insertBatch("item_copy", batch);
+		SLIB_ASSERT(nInserted == 1000);
+		sl_int32 nNull = db->getValue("SELECT COUNT(*) FROM item_copy WHERE stock IS NULL").getInt32();
+		SLIB_ASSERT(nNull == 100);
+		String name = db->getValue("SELECT name FROM item_copy WHERE id=?", 999).getString();
+		SLIB_ASSERT(name == GetName(999));
+	}
+
+	// benchmark
+	{
+		TimeCounter tc;
+		double sum1 = 0;
+		List<VariantMap> records = db->getRecords("SELECT id, name, price, stock FROM item");
+		for (auto& record : records) {
+			sum1 += record["price"].getDouble();
+		}
+		sl_uint64 timeRecords = tc.getElapsedMilliseconds();
+		records.setNull();
+		tc.reset();
+		double sum2 = 0;
+		Ref<DatabaseCursor> cursor = db->query("SELECT id, name, price, stock FROM item");
+		DatabaseRowBatch batch;
+		sl_uint32 nRows;
+		while ((nRows = cursor->fetchBatch(batch, BATCH_SIZE))) {
+			const double* prices = batch.columns[2].getDoubleValues();
+			for (sl_uint32 k = 0; k < nRows; k++) {
+				sum2 += prices[k];
+			}
+		}
+		sl_uint64 timeBatch = tc.getElapsedMilliseconds();
+		SLIB_ASSERT(sum1 == sum2);
+		Println("getRecords: %dms, fetchBatch: %dms", timeRecords, timeBatch);
+	}
+
+	db.setNull();
+	File::deleteFile(path);
+	Println("Test: OK!!!");
+	return 0;
+}
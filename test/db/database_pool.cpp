@@ -0,0 +1,176 @@
+#include <slib.h>
+#include <slib/db/sqlite.h>
+#include <slib/db/database_pool.h>
+
+using namespace slib;
+
+#define READER_COUNT 8
+#define WRITE_COUNT 2000
+
+int main(int argc, const char * argv[])
+{
+	String path = File::concatPath(System::getTempDirectory(), "database_pool_test.db");
+	File::deleteFile(path);
+	File::deleteFile(path + "-wal");
+	File::deleteFile(path + "-shm");
+
+	volatile sl_bool flagHealthy = sl_true;
+	DatabasePoolParam param;
+	param.onCreate = [path]() -> Ref<Database> {
+		Ref<SQLite> db = SQLite::open(path);
+		if (db.isNotNull()) {
+			db->execute("PRAGMA journal_mode=WAL");
+			db->execute("PRAGMA busy_timeout=5000");
+		}
+		return db;
+	};
+	param.minimumSize = 2;
+	param.maximumSize = 4;
+	param.borrowTimeout = 10000;
+	Ref<DatabasePool> pool = DatabasePool::create(param);
+	SLIB_ASSERT(pool.isNotNull());
+	{
+		DatabaseLease db = pool->borrow();
+		SLIB_ASSERT(db.isNotNull());
+		SLIB_ASSERT(db->getValue("PRAGMA journal_mode").getString() == "wal");
+		db->execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT)");
+	}
+
+	// one writer and many readers
+	{
+		TimeCounter tc;
+		volatile sl_bool flagWriting = sl_true;
+		volatile sl_int32 nErrors = 0;
+		volatile sl_int64 nReads = 0;
+		Ref<Thread> writer = Thread::start([&]() {
+			for (sl_uint32 i = 0; i < WRITE_COUNT; i++) {
+				DatabaseLease db = pool->borrow();
+				if (db.isNull() || db->execute("INSERT INTO item (id, name) VALUES (?, ?)", i, String::fromUint32(i)) != 1) {
+					Base::interlockedIncrement32(&nErrors);
+				}
+			}
+			flagWriting = sl_false;
+		});
+		List< Ref<Thread> > readers;
+		for (sl_uint32 k = 0; k < READER_COUNT; k++) {
+			readers.add_NoLock(Thread::start([&]() {
+				sl_int64 last = 0;
+				while (flagWriting) {
+					DatabaseLease db = pool->borrow();
+					if (db.isNull()) {
+						Base::interlockedIncrement32(&nErrors);
+						continue;
+					}
+					sl_int64 n = db->getValue("SELECT COUNT(*) FROM item").getInt64();
+					// a reader never sees the count going back
+					if (n < last) {
+						Base::interlockedIncrement32(&nErrors);
+					}
+					last = n;
+					Base::interlockedIncrement64(&nReads);
+				}
+			}));
+		}
+		writer->finishAndWait();
+		for (auto& reader : readers) {
+			reader->finishAndWait();
+		}
+		SLIB_ASSERT(!nErrors);
+		DatabasePoolStatistics stats;
+		pool->getStatistics(stats);
+		Println("%d writes, %d reads in %dms: total=%d, borrows=%d, waits=%d, avg wait=%dus, max wait=%dus, utilization=%.2f", WRITE_COUNT, nReads, tc.getElapsedMilliseconds(), stats.totalCount, stats.borrowCount, stats.waitCount, stats.waitCount ? stats.totalWaitTime / stats.waitCount : 0, stats.maxWaitTime, stats.utilization);
+		SLIB_ASSERT(stats.totalCount <= 4);
+		SLIB_ASSERT(stats.borrowedCount == 0);
+		SLIB_ASSERT(stats.idleCount == stats.totalCount);
+		SLIB_ASSERT(stats.waitingCount == 0);
+		DatabaseLease db = pool->borrow();
+		SLIB_ASSERT(db->getValue("SELECT COUNT(*) FROM item").getInt32() == WRITE_COUNT);
+	}
+
+	// borrow timeout
+	{
+		DatabaseLease leases[4];
+		for (sl_uint32 i = 0; i < 4; i++) {
+			leases[i] = pool->borrow();
+			SLIB_ASSERT(leases[i].isNotNull());
+		}
+		DatabasePoolStatistics stats;
+		pool->getStatistics(stats);
+		sl_uint64 nTimeouts = stats.timeoutCount;
+		TimeCounter tc;
+		SLIB_ASSERT(pool->borrow(100).isNull());
+		SLIB_ASSERT(tc.getElapsedMilliseconds() >= 90);
+		pool->getStatistics(stats);
+		SLIB_ASSERT(stats.timeoutCount == nTimeouts + 1);
+
+		// a returned connection is handed over to the waiter
+		Ref<Thread> thread = Thread::start([&]() {
+			Thread::sleep(50);
+			leases[0].release();
+		});
+		DatabaseLease db = pool->borrow(5000);
+		SLIB_ASSERT(db.isNotNull());
+		thread->finishAndWait();
+
+		// a discarded connection frees the slot for a new connection
+		pool->getStatistics(stats);
+		sl_uint64 nCreates = stats.createCount;
+		thread = Thread::start([&]() {
+			Thread::sleep(50);
+			leases[1].discard();
+		});
+		DatabaseLease db2 = pool->borrow(5000);
+		SLIB_ASSERT(db2.isNotNull());
+		thread->finishAndWait();
+		pool->getStatistics(stats);
+		SLIB_ASSERT(stats.createCount == nCreates + 1);
+		SLIB_ASSERT(stats.totalCount == 4);
+	}
+
+	// health check and idle eviction
+	{
+		DatabasePoolParam param2 = param;
+		param2.checkInterval = 0;
+		param2.idleTimeout = 100;
+		param2.minimumSize = 1;
+		param2.onCheck = [&flagHealthy](Database* db) {
+			return flagHealthy && db->getValue("SELECT 1").getInt32() == 1;
+		};
+		Ref<DatabasePool> pool2 = DatabasePool::create(param2);
+		SLIB_ASSERT(pool2.isNotNull());
+		{
+			DatabaseLease db1 = pool2->borrow();
+			DatabaseLease db2 = pool2->borrow();
+			DatabaseLease db3 = pool2->borrow();
+			SLIB_ASSERT(db1.isNotNull() && db2.isNotNull() && db3.isNotNull());
+		}
+		DatabasePoolStatistics stats;
+		pool2->getStatistics(stats);
+		SLIB_ASSERT(stats.totalCount == 3 && stats.idleCount == 3);
+		Thread::sleep(200);
+		pool2->evictIdleConnections();
+		pool2->getStatistics(stats);
+		SLIB_ASSERT(stats.totalCount == 1 && stats.closeCount == 2);
+
+		flagHealthy = sl_false;
+		{
+			DatabaseLease db = pool2->borrow();
+			SLIB_ASSERT(db.isNotNull());
+		}
+		pool2->getStatistics(stats);
+		SLIB_ASSERT(stats.checkFailureCount == 1);
+		SLIB_ASSERT(stats.totalCount == 1);
+
+		pool2->close();
+		SLIB_ASSERT(pool2->borrow().isNull());
+		pool2->getStatistics(stats);
+		SLIB_ASSERT(stats.totalCount == 0);
+	}
+
+	pool.setNull();
+	File::deleteFile(path);
+	File::deleteFile(path + "-wal");
+	File::deleteFile(path + "-shm");
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include <slib.h>
+#include <slib/db/object_store.h>
+#include <slib/db/btree_store.h>
+
+using namespace slib;
+
+static Ref<BTreeStore> OpenBackingStore(const String& path)
+{
+	File::deleteFile(path);
+	BTreeStore_Param param;
+	param.path = path;
+	param.flagSync = sl_false;
+	return BTreeStore::open(param);
+}
+
+static void TestCache(const String& path)
+{
+	ObjectStoreParam param;
+	param.store = OpenBackingStore(path);
+	param.cacheSize = 64;
+	ObjectStore store = ObjectStore::open(param);
+	SLIB_ASSERT(store.isNotUndefined());
+
+	VariantMap map;
+	map.put_NoLock("a", 1);
+	VariantList list;
+	list.add_NoLock(map);
+	sl_bool flagPut = store.putItem("list", list);
+	SLIB_ASSERT(flagPut);
+
+	// the value passed to putItem is copied into the cache
+	map.put_NoLock("a", 2);
+	list.add_NoLock(3);
+	Variant item = store.getItem("list");
+	SLIB_ASSERT(item.getVariantList().getCount() == 1);
+	SLIB_ASSERT(item[0]["a"].getInt32() == 1);
+
+	// the returned value does not share the cached one
+	item.getVariantList().add_NoLock(4);
+	item[0].getVariantMap().put_NoLock("a", 5);
+	item = store.getItem("list");
+	SLIB_ASSERT(item.getVariantList().getCount() == 1);
+	SLIB_ASSERT(item[0]["a"].getInt32() == 1);
+
+	for (sl_uint32 i = 0; i < 1000; i++) {
+		store.putItem(String::fromUint32(i), i);
+	}
+	sl_uint32 nMismatch = 0;
+	for (sl_uint32 i = 0; i < 1000; i++) {
+		if (store.getItem(String::fromUint32(i)).getUint32() != i) {
+			nMismatch++;
+		}
+	}
+	SLIB_ASSERT(!nMismatch);
+}
+
+static void TestWriteBehind(const String& path)
+{
+	Ref<BTreeStore> backing = OpenBackingStore(path);
+	SLIB_ASSERT(backing.isNotNull());
+	{
+		ObjectStoreParam param;
+		param.store = backing;
+		sl_bool flagPut = ObjectStore::open(param).putItem("stored", 1);
+		SLIB_ASSERT(flagPut);
+	}
+	sl_uint64 nStored = backing->getCount();
+
+	ObjectStoreParam param;
+	param.store = backing;
+	param.cacheSize = 64;
+	param.writeBehindDelay = 60000;
+	ObjectStore store = ObjectStore::open(param);
+
+	// removing reports missing items
+	sl_bool flagRemoved = store.removeItem("missing");
+	SLIB_ASSERT(!flagRemoved);
+	flagRemoved = store.removeItem("stored");
+	SLIB_ASSERT(flagRemoved);
+	flagRemoved = store.removeItem("stored");
+	SLIB_ASSERT(!flagRemoved);
+	sl_bool flagPut = store.putItem("pending", 1);
+	SLIB_ASSERT(flagPut);
+	flagRemoved = store.removeItem("pending");
+	SLIB_ASSERT(flagRemoved);
+	SLIB_ASSERT(store.getItem("pending").isUndefined());
+	SLIB_ASSERT(backing->getCount() == nStored);
+
+	// without writeBehindBatchSize the pending writes are flushed at the default limit
+	for (sl_uint32 i = 0; i < 2000; i++) {
+		store.putItem(String::fromUint32(i), i);
+	}
+	SLIB_ASSERT(backing->getCount() >= 1000);
+	sl_bool flagFlushed = store.flush();
+	SLIB_ASSERT(flagFlushed);
+	SLIB_ASSERT(backing->getCount() == 2000);
+	sl_uint32 nMismatch = 0;
+	for (sl_uint32 i = 0; i < 2000; i++) {
+		if (store.getItem(String::fromUint32(i)).getUint32() != i) {
+			nMismatch++;
+		}
+	}
+	SLIB_ASSERT(!nMismatch);
+}
+
+int main(int argc, const char * argv[])
+{
+	String path = File::concatPath(System::getTempDirectory(), "slib_test_object_store.db");
+	TestCache(path);
+	TestWriteBehind(path);
+	File::deleteFile(path);
+	Println("Test: OK!!!");
+	return 0;
+}
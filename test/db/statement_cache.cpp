@@ -0,0 +1,90 @@
+#include <slib.h>
+#include <slib/db/sqlite.h>
+
+using namespace slib;
+
+#define ROW_COUNT 20000
+#define THREAD_COUNT 4
+
+static sl_uint64 Run(const Ref<SQLite>& db)
+{
+	db->execute("DROP TABLE IF EXISTS item");
+	db->execute("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, price REAL)");
+	TimeCounter tc;
+	db->startTransaction();
+	for (sl_uint32 i = 0; i < ROW_COUNT; i++) {
+		db->execute("INSERT INTO item (id, name, price) VALUES (?, ?, ?)", i, String::concat("item", String::fromUint32(i)), i * 0.5);
+	}
+	db->commitTransaction();
+	for (sl_uint32 i = 0; i < ROW_COUNT; i++) {
+		Variant name = db->getValue("SELECT name FROM item WHERE id=?", i);
+		SLIB_ASSERT(name.getString() == String::concat("item", String::fromUint32(i)));
+	}
+	return tc.getElapsedMilliseconds();
+}
+
+int main(int argc, const char * argv[])
+{
+	String path = File::concatPath(System::getTempDirectory(), "statement_cache_test.db");
+	File::deleteFile(path);
+	Ref<SQLite> db = SQLite::open(path);
+	SLIB_ASSERT(db.isNotNull());
+
+	db->setStatementCacheSize(0);
+	sl_uint64 timeWithoutCache = Run(db);
+	db->setStatementCacheSize(64);
+	sl_uint64 timeWithCache = Run(db);
+	DatabaseStatementCacheStatistics stats;
+	db->getStatementCacheStatistics(stats);
+	Println("Without cache: %dms, With cache: %dms, hit=%d, miss=%d, cached=%d", timeWithoutCache, timeWithCache, stats.hitCount, stats.missCount, stats.cachedCount);
+	SLIB_ASSERT(stats.hitCount >= ROW_COUNT * 2 - 2);
+
+	// nested queries with the same SQL
+	{
+		Ref<DatabaseCursor> c1 = db->query("SELECT id FROM item WHERE id<?", 3);
+		Ref<DatabaseCursor> c2 = db->query("SELECT id FROM item WHERE id<?", 2);
+		sl_uint32 n1 = 0, n2 = 0;
+		while (c1->moveNext()) {
+			n1++;
+		}
+		while (c2->moveNext()) {
+			n2++;
+		}
+		SLIB_ASSERT(n1 == 3 && n2 == 2);
+	}
+
+	// schema change invalidates the cache
+	sl_int64 nAltered = db->execute("ALTER TABLE item ADD COLUMN stock INTEGER DEFAULT 7");
+	SLIB_ASSERT(nAltered >= 0);
+	db->getStatementCacheStatistics(stats);
+	SLIB_ASSERT(!(stats.cachedCount));
+	sl_int32 stock = db->getValue("SELECT stock FROM item WHERE id=?", 1).getInt32();
+	SLIB_ASSERT(stock == 7);
+
+	// shared connection
+	{
+		volatile sl_int32 nErrors = 0;
+		List< Ref<Thread> > threads;
+		for (sl_uint32 k = 0; k < THREAD_COUNT; k++) {
+			threads.add_NoLock(Thread::start([&db, &nErrors, k]() {
+				for (sl_uint32 i = k; i < ROW_COUNT; i += THREAD_COUNT) {
+					Variant price = db->getValue("SELECT price FROM item WHERE id=?", i);
+					if (price.getDouble() != i * 0.5) {
+						Base::interlockedIncrement32(&nErrors);
+					}
+				}
+			}));
+		}
+		for (auto& thread : threads) {
+			thread->finishAndWait();
+		}
+		SLIB_ASSERT(!nErrors);
+	}
+
+	WeakRef<SQLite> weak = db;
+	db.setNull();
+	SLIB_ASSERT(weak.lock().isNull());
+	File::deleteFile(path);
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include <slib.h>
+#include <slib/doc/pdf.h>
+#include <slib/data/zlib.h>
+
+using namespace slib;
+
+#define PAGE_COUNT 500
+#define THUMBNAIL_SIZE 200
+
+// Writes a sample document whose pages share one image and draw compressed vector contents
+static Memory GenerateSamplePdf(sl_uint32 nPages)
+{
+	MemoryBuffer buf;
+	List<sl_size> offsets;
+	sl_size size = 0;
+	auto write = [&](const String& s) {
+		buf.add(s.toMemory());
+		size += s.getLength();
+	};
+	auto writeStream = [&](const String& dict, const Memory& data) {
+		write(String::format("<< %s /Length %d /Filter /FlateDecode >>\nstream\n", dict, data.getSize()));
+		buf.add(data);
+		size += data.getSize();
+		write("\nendstream\nendobj\n");
+	};
+	auto beginObject = [&](sl_uint32 n) {
+		offsets.add_NoLock(size);
+		write(String::format("%d 0 obj\n", n));
+	};
+	write("%PDF-1.4\n");
+	beginObject(1);
+	write("<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+	beginObject(2);
+	{
+		StringBuffer kids;
+		for (sl_uint32 i = 0; i < nPages; i++) {
+			kids.add(String::format("%d 0 R ", 4 + i * 2));
+		}
+		write(String::format("<< /Type /Pages /Count %d /Kids [%s] >>\nendobj\n", nPages, kids.merge()));
+	}
+	beginObject(3);
+	{
+		Memory pixels = Memory::create(128 * 128 * 3);
+		sl_uint8* p = (sl_uint8*)(pixels.getData());
+		for (sl_uint32 y = 0; y < 128; y++) {
+			for (sl_uint32 x = 0; x < 128; x++) {
+				*(p++) = (sl_uint8)(x * 2);
+				*(p++) = (sl_uint8)(y * 2);
+				*(p++) = (sl_uint8)((x ^ y) * 2);
+			}
+		}
+		writeStream("/Type /XObject /Subtype /Image /Width 128 /Height 128 /ColorSpace /DeviceRGB /BitsPerComponent 8", Zlib::compress(pixels.getData(), pixels.getSize()));
+	}
+	for (sl_uint32 i = 0; i < nPages; i++) {
+		beginObject(4 + i * 2);
+		write(String::format("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] /Resources << /XObject << /Im1 3 0 R >> >> /Contents %d 0 R >>\nendobj\n", 5 + i * 2));
+		StringBuffer content;
+		for (sl_uint32 k = 0; k < 300; k++) {
+			sl_uint32 x = (i * 37 + k * 53) % 560;
+			sl_uint32 y = (i * 17 + k * 71) % 740;
+			content.add(String::format("%.3f %.3f %.3f rg %d %d 40 30 re f %d %d m %d %d %d %d %d %d c S\n", (k % 7) / 7.0, (k % 11) / 11.0, (i % 5) / 5.0, x, y, x, y, x + 30, y + 60, x + 60, y - 20, x + 90, y + 10));
+		}
+		content.add("q 200 0 0 200 200 300 cm /Im1 Do Q\n");
+		String s = content.merge();
+		beginObject(5 + i * 2);
+		writeStream("", Zlib::compress(s.getData(), s.getLength()));
+	}
+	sl_size posXref = size;
+	sl_uint32 nObjects = (sl_uint32)(offsets.getCount()) + 1;
+	write(String::format("xref\n0 %d\n0000000000 65535 f \n", nObjects));
+	for (auto&& offset : offsets) {
+		write(String::format("%010d 00000 n \n", offset));
+	}
+	write(String::format("trailer\n<< /Size %d /Root 1 0 R >>\nstartxref\n%d\n%%%%EOF\n", nObjects, posXref));
+	return buf.merge();
+}
+
+// Resolves the page objects and decodes their contents from `threadCount` threads
+static sl_uint64 ParsePages(PdfDocument* doc, sl_uint32 threadCount)
+{
+	sl_uint32 nPages = doc->getPageCount();
+	volatile sl_int32 next = 0;
+	volatile sl_int32 nOperations = 0;
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < threadCount; i++) {
+		threads.add_NoLock(Thread::start([&]() {
+			for (;;) {
+				sl_int32 index = Base::interlockedIncrement32(&next) - 1;
+				if (index >= (sl_int32)nPages) {
+					break;
+				}
+				Ref<PdfPage> page = doc->getPage(index);
+				SLIB_ASSERT(page.isNotNull());
+				Base::interlockedAdd32(&nOperations, (sl_int32)(page->getContent().getCount()));
+				SLIB_ASSERT(page->getResource("XObject", "Im1").getStream().isNotNull());
+			}
+		}));
+	}
+	for (auto&& thread : threads) {
+		thread->finishAndWait();
+	}
+	SLIB_ASSERT(nOperations == (sl_int32)(nPages * 1804));
+	return tc.getElapsedMilliseconds();
+}
+
+int main(int argc, const char * argv[])
+{
+	String path;
+	sl_bool flagGenerated = sl_false;
+	if (argc > 1) {
+		path = argv[1];
+	} else {
+		path = File::concatPath(System::getTempDirectory(), "slib_test_pdf_render_pages.pdf");
+		Memory content = GenerateSamplePdf(PAGE_COUNT);
+		sl_bool flagWritten = File::writeAllBytes(path, content);
+		SLIB_ASSERT(flagWritten);
+		flagGenerated = sl_true;
+	}
+	sl_uint32 nThreads = Math::max(Cpu::getCoreCount(), (sl_uint32)4);
+
+	if (flagGenerated) {
+		sl_uint64 t1 = ParsePages(PdfDocument::openFile(path).get(), 1);
+		sl_uint64 tN = ParsePages(PdfDocument::openFile(path).get(), nThreads);
+		Println("Parse %d pages from file: 1 thread %dms, %d threads %dms", PAGE_COUNT, t1, nThreads, tN);
+		Memory content = File::readAllBytes(path);
+		t1 = ParsePages(PdfDocument::openMemory(content).get(), 1);
+		tN = ParsePages(PdfDocument::openMemory(content).get(), nThreads);
+		Println("Parse %d pages from memory: 1 thread %dms, %d threads %dms", PAGE_COUNT, t1, nThreads, tN);
+	}
+
+	for (sl_uint32 threadCount = 1; ; threadCount = Math::min(threadCount * 2, nThreads)) {
+		Ref<PdfDocument> doc = PdfDocument::openFile(path);
+		SLIB_ASSERT(doc.isNotNull());
+		sl_uint32 nPages = doc->getPageCount();
+		volatile sl_int32 nRendered = 0;
+		TimeCounter tc;
+		sl_bool bRet = doc->renderPages(0, nPages, THUMBNAIL_SIZE, THUMBNAIL_SIZE, threadCount, [&](sl_uint32 index, Bitmap* bitmap) {
+			SLIB_ASSERT(bitmap->getWidth() <= THUMBNAIL_SIZE && bitmap->getHeight() <= THUMBNAIL_SIZE);
+			Base::interlockedIncrement32(&nRendered);
+		});
+		sl_uint64 t = tc.getElapsedMilliseconds();
+		SLIB_ASSERT(bRet && nRendered == (sl_int32)nPages);
+		Println("Render %d pages with %d threads: %dms (%.1f pages/s)", nPages, threadCount, t, (double)nPages * 1000.0 / (double)(t ? t : 1));
+		if (threadCount >= nThreads) {
+			break;
+		}
+	}
+
+	if (flagGenerated) {
+		File::deleteFile(path);
+	}
+	Println("OK");
+	return 0;
+}
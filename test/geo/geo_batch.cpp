@@ -0,0 +1,261 @@
+#include <slib.h>
+#include <slib/geo/utm.h>
+
+using namespace slib;
+
+#define POINT_COUNT 1000000
+#define UTM_REFERENCE_LONGITUDE 129
+
+static sl_uint64 g_seed = 1;
+
+static double GetRandom(double from, double to)
+{
+	g_seed = g_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return from + (to - from) * (double)(g_seed >> 11) / (double)(1ULL << 53);
+}
+
+static double GetMaxError(const double* a, const double* b, sl_size n)
+{
+	double ret = 0;
+	for (sl_size i = 0; i < n; i++) {
+		double d = Math::abs(a[i] - b[i]);
+		if (!(d <= ret)) {
+			ret = d;
+		}
+	}
+	return ret;
+}
+
+static double GetMaxAngleError(const double* a, const double* b, sl_size n)
+{
+	double ret = 0;
+	for (sl_size i = 0; i < n; i++) {
+		double d = Math::abs(a[i] - b[i]);
+		if (d > 180) {
+			d = 360 - d;
+		}
+		if (!(d <= ret)) {
+			ret = d;
+		}
+	}
+	return ret;
+}
+
+// distance along the parallel, unit: m
+static double GetMaxLongitudeError(const double* a, const double* b, const double* latitudes, sl_size n)
+{
+	double ret = 0;
+	for (sl_size i = 0; i < n; i++) {
+		double d = Math::abs(a[i] - b[i]);
+		if (d > 180) {
+			d = 360 - d;
+		}
+		d = Math::getRadianFromDegrees(d) * SLIB_GEO_EARTH_RADIUS_EQUATORIAL_WGS84 * Math::cos(Math::getRadianFromDegrees(latitudes[i]));
+		if (!(d <= ret)) {
+			ret = d;
+		}
+	}
+	return ret;
+}
+
+class Arrays
+{
+public:
+	List<double> lists[5];
+	double* data[5];
+
+public:
+	Arrays()
+	{
+		for (sl_uint32 i = 0; i < 5; i++) {
+			lists[i] = List<double>::create(POINT_COUNT);
+			data[i] = lists[i].getData();
+		}
+	}
+
+	double* operator[](sl_uint32 i)
+	{
+		return data[i];
+	}
+};
+
+static void PrintTimes(const char* title, sl_uint64 tScalar, sl_uint64 tBatch, sl_uint64 tThreads)
+{
+	Println("  %s: scalar %dms, batch %dms, batch+threads %dms", title, (sl_uint32)tScalar, (sl_uint32)tBatch, (sl_uint32)tThreads);
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<ThreadPool> pool = ThreadPool::create(0, Cpu::getCoreCount());
+	const Globe& globe = Earth::getGlobe();
+	UTM utm(UTM_REFERENCE_LONGITUDE);
+
+	Arrays input, scalar, batch;
+	for (sl_size i = 0; i < POINT_COUNT; i++) {
+		input[0][i] = GetRandom(-89.9, 89.9);
+		input[1][i] = GetRandom(-180, 180);
+		input[2][i] = GetRandom(-10000, 1000000);
+		input[3][i] = GetRandom(-80, 84);
+		input[4][i] = UTM_REFERENCE_LONGITUDE + GetRandom(-6, 6);
+	}
+	// special points
+	double specials[][3] = {{0, 0, 0}, {90, 0, 0}, {-90, 45, 100}, {0, 180, 0}, {0, -180, 0}, {0, 90, 0}, {45, -90, -1000}, {30, 120, 35786000}};
+	for (sl_size i = 0; i < sizeof(specials) / sizeof(specials[0]); i++) {
+		input[0][i] = specials[i][0];
+		input[1][i] = specials[i][1];
+		input[2][i] = specials[i][2];
+	}
+	input[3][0] = 0;
+	input[4][0] = UTM_REFERENCE_LONGITUDE;
+
+	Println("Accuracy (max difference from the single point functions), %d points", POINT_COUNT);
+	{
+		// LatLon -> ECEF
+		TimeCounter tc;
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			Double3 pt = globe.getCartesianPosition(input[0][i], input[1][i], input[2][i]);
+			scalar[0][i] = pt.x;
+			scalar[1][i] = pt.y;
+			scalar[2][i] = pt.z;
+		}
+		sl_uint64 tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		globe.getCartesianPositions(input[0], input[1], input[2], batch[0], batch[1], batch[2], POINT_COUNT);
+		sl_uint64 tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		globe.getCartesianPositions(input[0], input[1], input[2], batch[0], batch[1], batch[2], POINT_COUNT, pool.get());
+		sl_uint64 tThreads = tc.getElapsedMilliseconds();
+		double e = SLIB_MAX(GetMaxError(scalar[0], batch[0], POINT_COUNT), SLIB_MAX(GetMaxError(scalar[1], batch[1], POINT_COUNT), GetMaxError(scalar[2], batch[2], POINT_COUNT)));
+		Println("LatLon -> ECEF: %.3e m", e);
+		PrintTimes("LatLon -> ECEF", tScalar, tBatch, tThreads);
+		SLIB_ASSERT(e < 1e-7);
+	}
+	{
+		// ECEF -> LatLon
+		Arrays ecef;
+		globe.getCartesianPositions(input[0], input[1], input[2], ecef[0], ecef[1], ecef[2], POINT_COUNT);
+		TimeCounter tc;
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			GeoLocation loc = globe.getGeoLocation(ecef[0][i], ecef[1][i], ecef[2][i]);
+			scalar[0][i] = loc.latitude;
+			scalar[1][i] = loc.longitude;
+			scalar[2][i] = loc.altitude;
+		}
+		sl_uint64 tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		globe.getGeoLocations(ecef[0], ecef[1], ecef[2], batch[0], batch[1], batch[2], POINT_COUNT);
+		sl_uint64 tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		globe.getGeoLocations(ecef[0], ecef[1], ecef[2], batch[0], batch[1], batch[2], POINT_COUNT, pool.get());
+		sl_uint64 tThreads = tc.getElapsedMilliseconds();
+		double eLat = GetMaxError(scalar[0], batch[0], POINT_COUNT);
+		double eLon = GetMaxLongitudeError(scalar[1], batch[1], scalar[0], POINT_COUNT);
+		double eAlt = GetMaxError(scalar[2], batch[2], POINT_COUNT);
+		Println("ECEF -> LatLon: latitude %.3e deg, longitude %.3e m, altitude %.3e m", eLat, eLon, eAlt);
+		PrintTimes("ECEF -> LatLon", tScalar, tBatch, tThreads);
+		// the single point function loses the precision of the longitude near the antimeridian
+		SLIB_ASSERT(eLat < 1e-10 && eLon < 1e-4 && eAlt < 1e-7);
+		double eRoundTrip = GetMaxLongitudeError(input[1], batch[1], input[0], POINT_COUNT);
+		Println("LatLon -> ECEF -> LatLon: longitude %.3e m", eRoundTrip);
+		SLIB_ASSERT(eRoundTrip < 1e-7);
+	}
+	{
+		// LatLon -> UTM
+		TimeCounter tc;
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			UTMCoordinate c = utm.getCoordinate(LatLon(input[3][i], input[4][i]));
+			scalar[0][i] = c.N;
+			scalar[1][i] = c.E;
+		}
+		sl_uint64 tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		utm.getCoordinates(input[3], input[4], batch[0], batch[1], POINT_COUNT);
+		sl_uint64 tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		utm.getCoordinates(input[3], input[4], batch[0], batch[1], POINT_COUNT, pool.get());
+		sl_uint64 tThreads = tc.getElapsedMilliseconds();
+		double e = SLIB_MAX(GetMaxError(scalar[0], batch[0], POINT_COUNT), GetMaxError(scalar[1], batch[1], POINT_COUNT));
+		Println("LatLon -> UTM: %.3e m", e);
+		PrintTimes("LatLon -> UTM", tScalar, tBatch, tThreads);
+		SLIB_ASSERT(e < 1e-7);
+	}
+	{
+		// UTM -> LatLon
+		Arrays coords;
+		utm.getCoordinates(input[3], input[4], coords[0], coords[1], POINT_COUNT);
+		TimeCounter tc;
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			LatLon ll = utm.getLatLon(UTMCoordinate(coords[0][i], coords[1][i]));
+			scalar[0][i] = ll.latitude;
+			scalar[1][i] = ll.longitude;
+		}
+		sl_uint64 tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		utm.getLatLons(coords[0], coords[1], batch[0], batch[1], POINT_COUNT);
+		sl_uint64 tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		utm.getLatLons(coords[0], coords[1], batch[0], batch[1], POINT_COUNT, pool.get());
+		sl_uint64 tThreads = tc.getElapsedMilliseconds();
+		double e = SLIB_MAX(GetMaxError(scalar[0], batch[0], POINT_COUNT), GetMaxError(scalar[1], batch[1], POINT_COUNT));
+		Println("UTM -> LatLon: %.3e deg", e);
+		PrintTimes("UTM -> LatLon", tScalar, tBatch, tThreads);
+		SLIB_ASSERT(e < 1e-10);
+		double eRoundTrip = SLIB_MAX(GetMaxError(input[3], batch[0], POINT_COUNT), GetMaxError(input[4], batch[1], POINT_COUNT));
+		Println("LatLon -> UTM -> LatLon: %.3e deg", eRoundTrip);
+	}
+	{
+		// great-circle distances and bearings
+		TimeCounter tc;
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			scalar[0][i] = Earth::getDistance(LatLon(input[0][i], input[1][i]), LatLon(input[3][i], input[4][i]));
+		}
+		sl_uint64 tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		Earth::getDistances(input[0], input[1], input[3], input[4], batch[0], POINT_COUNT);
+		sl_uint64 tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		Earth::getDistances(input[0], input[1], input[3], input[4], batch[0], POINT_COUNT, pool.get());
+		sl_uint64 tThreads = tc.getElapsedMilliseconds();
+		double e = GetMaxError(scalar[0], batch[0], POINT_COUNT);
+		Println("Distance: %.3e m", e);
+		PrintTimes("Distance", tScalar, tBatch, tThreads);
+		SLIB_ASSERT(e < 1e-5);
+
+		tc.reset();
+		for (sl_size i = 0; i < POINT_COUNT; i++) {
+			scalar[1][i] = Earth::getBearing(LatLon(input[0][i], input[1][i]), LatLon(input[3][i], input[4][i]));
+		}
+		tScalar = tc.getElapsedMilliseconds();
+		tc.reset();
+		Earth::getBearings(input[0], input[1], input[3], input[4], batch[1], POINT_COUNT);
+		tBatch = tc.getElapsedMilliseconds();
+		tc.reset();
+		Earth::getBearings(input[0], input[1], input[3], input[4], batch[1], POINT_COUNT, pool.get());
+		tThreads = tc.getElapsedMilliseconds();
+		e = GetMaxAngleError(scalar[1], batch[1], POINT_COUNT);
+		Println("Bearing: %.3e deg", e);
+		PrintTimes("Bearing", tScalar, tBatch, tThreads);
+		SLIB_ASSERT(e < 1e-10);
+
+		double d = Earth::getDistance(LatLon(0, 0), LatLon(0, 90));
+		SLIB_ASSERT(Math::abs(d - SLIB_GEO_EARTH_AVERAGE_RADIUS * SLIB_PI_LONG / 2) < 1e-6);
+		SLIB_ASSERT(Math::abs(Earth::getBearing(LatLon(0, 0), LatLon(0, 90)) - 90) < 1e-12);
+		SLIB_ASSERT(Math::abs(Earth::getBearing(LatLon(0, 0), LatLon(-10, 0)) - 180) < 1e-12);
+	}
+	{
+		// arrays shorter than a vector, and without altitudes
+		double lat[3] = {10, 20, 30};
+		double lon[3] = {100, 110, 120};
+		double x[3], y[3], z[3];
+		for (sl_size n = 1; n <= 3; n++) {
+			Earth::getCartesianPositions(lat, lon, sl_null, x, y, z, n);
+			for (sl_size i = 0; i < n; i++) {
+				Double3 pt = Earth::getCartesianPosition(LatLon(lat[i], lon[i]));
+				SLIB_ASSERT(Math::abs(pt.x - x[i]) < 1e-7 && Math::abs(pt.y - y[i]) < 1e-7 && Math::abs(pt.z - z[i]) < 1e-7);
+			}
+		}
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,308 @@
+#include <slib.h>
+#include <slib/geo/geo_rtree.h>
+
+using namespace slib;
+
+#define POINT_COUNT 10000000
+#define CHECK_COUNT 20000
+#define QUERY_COUNT 10000
+
+static sl_uint64 g_seed = 1;
+
+static double GetRandom(double from, double to)
+{
+	g_seed = g_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return from + (to - from) * (double)(g_seed >> 11) / (double)(1ULL << 53);
+}
+
+static sl_bool IsInRectangle(const GeoRectangle& rect, const LatLon& pt)
+{
+	if (pt.latitude < rect.bottomLeft.latitude || pt.latitude > rect.topRight.latitude) {
+		return sl_false;
+	}
+	if (rect.bottomLeft.longitude <= rect.topRight.longitude) {
+		return rect.bottomLeft.longitude <= pt.longitude && pt.longitude <= rect.topRight.longitude;
+	} else {
+		return rect.bottomLeft.longitude <= pt.longitude || pt.longitude <= rect.topRight.longitude;
+	}
+}
+
+static sl_bool IsIntersecting(const GeoRectangle& a, const GeoRectangle& b)
+{
+	if (a.topRight.latitude < b.bottomLeft.latitude || b.topRight.latitude < a.bottomLeft.latitude) {
+		return sl_false;
+	}
+	double aw[2], ae[2], bw[2], be[2];
+	sl_uint32 na = 1, nb = 1;
+	aw[0] = a.bottomLeft.longitude; ae[0] = a.topRight.longitude;
+	if (aw[0] > ae[0]) {
+		aw[1] = -180; ae[1] = ae[0]; ae[0] = 180; na = 2;
+	}
+	bw[0] = b.bottomLeft.longitude; be[0] = b.topRight.longitude;
+	if (bw[0] > be[0]) {
+		bw[1] = -180; be[1] = be[0]; be[0] = 180; nb = 2;
+	}
+	for (sl_uint32 i = 0; i < na; i++) {
+		for (sl_uint32 k = 0; k < nb; k++) {
+			if (aw[i] <= be[k] && bw[k] <= ae[i]) {
+				return sl_true;
+			}
+		}
+	}
+	return sl_false;
+}
+
+static double GetDistance(const LatLon& a, const LatLon& b)
+{
+	return Earth::getDistance(a, b);
+}
+
+static List<sl_size> Sort(const List<sl_size>& list)
+{
+	List<sl_size> ret = list.duplicate();
+	ret.sort();
+	return ret;
+}
+
+static sl_bool IsSame(const List<sl_size>& a, const List<sl_size>& b)
+{
+	List<sl_size> x = Sort(a);
+	List<sl_size> y = Sort(b);
+	if (x.getCount() != y.getCount()) {
+		return sl_false;
+	}
+	for (sl_size i = 0; i < x.getCount(); i++) {
+		if (x[i] != y[i]) {
+			return sl_false;
+		}
+	}
+	return sl_true;
+}
+
+static GeoRectangle GetRandomRectangle(double size)
+{
+	GeoRectangle rect;
+	double lat = GetRandom(-90, 90 - size);
+	double lon = GetRandom(-180, 180);
+	rect.bottomLeft = LatLon(lat, lon);
+	rect.topRight = LatLon(lat + GetRandom(0, size), LatLon::normalizeLongitude(lon + GetRandom(0, size)));
+	return rect;
+}
+
+static void CheckPoints(const LatLon* points, sl_size n, const GeoPackedRTree& packed, const GeoRTree& dynamic)
+{
+	for (sl_uint32 q = 0; q < 100; q++) {
+		GeoRectangle rect = GetRandomRectangle(q ? 30 : 2);
+		if (q == 1) {
+			// crossing the antimeridian
+			rect.bottomLeft = LatLon(-20, 170);
+			rect.topRight = LatLon(20, -170);
+		}
+		List<sl_size> expected;
+		for (sl_size i = 0; i < n; i++) {
+			if (IsInRectangle(rect, points[i])) {
+				expected.add_NoLock(i);
+			}
+		}
+		SLIB_ASSERT(IsSame(expected, packed.search(rect)));
+		SLIB_ASSERT(IsSame(expected, dynamic.search(rect)));
+
+		LatLon center(GetRandom(-90, 90), GetRandom(-180, 180));
+		if (q == 1) {
+			center = LatLon(10, 179.5);
+		} else if (q == 2) {
+			center = LatLon(89.5, 0);
+		}
+		double radius = GetRandom(1000, 2000000);
+		expected.removeAll_NoLock();
+		for (sl_size i = 0; i < n; i++) {
+			if (GetDistance(center, points[i]) <= radius) {
+				expected.add_NoLock(i);
+			}
+		}
+		SLIB_ASSERT(IsSame(expected, packed.searchInRadius(center, radius)));
+		SLIB_ASSERT(IsSame(expected, dynamic.searchInRadius(center, radius)));
+
+		List<sl_size> nearest = packed.searchNearest(center, 10);
+		List<sl_size> nearest2 = dynamic.searchNearest(center, 10);
+		SLIB_ASSERT(nearest.getCount() == 10 && nearest2.getCount() == 10);
+		double kth = GetDistance(center, points[nearest[9]]);
+		sl_size nCloser = 0;
+		for (sl_size i = 0; i < n; i++) {
+			if (GetDistance(center, points[i]) < kth) {
+				nCloser++;
+			}
+		}
+		SLIB_ASSERT(nCloser <= 9);
+		for (sl_size i = 1; i < 10; i++) {
+			SLIB_ASSERT(GetDistance(center, points[nearest[i - 1]]) <= GetDistance(center, points[nearest[i]]));
+		}
+		SLIB_ASSERT(Math::abs(GetDistance(center, points[nearest2[9]]) - kth) < 1e-6);
+	}
+}
+
+static void CheckRectangles()
+{
+	sl_size n = 5000;
+	List<GeoRectangle> rects;
+	for (sl_size i = 0; i < n; i++) {
+		rects.add_NoLock(GetRandomRectangle(20));
+	}
+	// crossing the antimeridian
+	rects[0] = GeoRectangle();
+	rects[0].bottomLeft = LatLon(0, 175);
+	rects[0].topRight = LatLon(5, -175);
+	GeoPackedRTree packed;
+	sl_bool flagBuilt = packed.build(rects.getData(), n);
+	SLIB_ASSERT(flagBuilt);
+	SLIB_ASSERT(packed.getCount() == n);
+	GeoRTree dynamic;
+	sl_size nFailed = 0;
+	for (sl_size i = 0; i < n; i++) {
+		if (!(dynamic.insert(rects[i], i))) {
+			nFailed++;
+		}
+	}
+	SLIB_ASSERT(!nFailed);
+	for (sl_uint32 q = 0; q < 200; q++) {
+		GeoRectangle query = GetRandomRectangle(40);
+		if (!q) {
+			query.bottomLeft = LatLon(-10, 170);
+			query.topRight = LatLon(10, -170);
+		}
+		List<sl_size> expected;
+		for (sl_size i = 0; i < n; i++) {
+			if (IsIntersecting(query, rects[i])) {
+				expected.add_NoLock(i);
+			}
+		}
+		SLIB_ASSERT(IsSame(expected, packed.search(query)));
+		SLIB_ASSERT(IsSame(expected, dynamic.search(query)));
+	}
+	List<sl_size> nearest = packed.searchNearest(LatLon(2, 179), 1);
+	SLIB_ASSERT(nearest.getCount() == 1 && IsInRectangle(rects[nearest[0]], LatLon(2, 179)));
+	nearest = dynamic.searchNearest(LatLon(2, -179), 1);
+	SLIB_ASSERT(nearest.getCount() == 1 && IsInRectangle(rects[nearest[0]], LatLon(2, -179)));
+
+	// removing
+	for (sl_size i = 0; i < n; i += 2) {
+		if (!(dynamic.remove(rects[i], i))) {
+			nFailed++;
+		}
+	}
+	SLIB_ASSERT(!nFailed);
+	SLIB_ASSERT(dynamic.getCount() == n / 2);
+	GeoRectangle all;
+	all.bottomLeft = LatLon(-90, -180);
+	all.topRight = LatLon(90, 180);
+	List<sl_size> rest = dynamic.search(all);
+	SLIB_ASSERT(rest.getCount() == n / 2);
+	for (sl_size i = 0; i < rest.getCount(); i++) {
+		SLIB_ASSERT(rest[i] & 1);
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	{
+		// correctness against the linear search
+		List<LatLon> points;
+		for (sl_size i = 0; i < CHECK_COUNT; i++) {
+			points.add_NoLock(LatLon(GetRandom(-90, 90), GetRandom(-180, 180)));
+		}
+		points[0] = LatLon(0, 180);
+		points[1] = LatLon(0, -180);
+		points[2] = LatLon(90, 0);
+		GeoPackedRTree packed;
+		sl_bool flagBuilt = packed.build(points.getData(), CHECK_COUNT);
+		SLIB_ASSERT(flagBuilt);
+		GeoRTree dynamic;
+		sl_size nFailed = 0;
+		for (sl_size i = 0; i < CHECK_COUNT; i++) {
+			if (!(dynamic.insert(points[i], i))) {
+				nFailed++;
+			}
+		}
+		SLIB_ASSERT(!nFailed);
+		SLIB_ASSERT(dynamic.getCount() == CHECK_COUNT);
+		CheckPoints(points.getData(), CHECK_COUNT, packed, dynamic);
+		for (sl_size i = 0; i < CHECK_COUNT; i += 3) {
+			if (!(dynamic.remove(points[i], i))) {
+				nFailed++;
+			}
+		}
+		for (sl_size i = 0; i < CHECK_COUNT; i += 3) {
+			if (!(dynamic.insert(points[i], i))) {
+				nFailed++;
+			}
+		}
+		SLIB_ASSERT(!nFailed);
+		CheckPoints(points.getData(), CHECK_COUNT, packed, dynamic);
+		CheckRectangles();
+	}
+
+	// latency for 10M points
+	List<double> latitudes = List<double>::create(POINT_COUNT);
+	List<double> longitudes = List<double>::create(POINT_COUNT);
+	for (sl_size i = 0; i < POINT_COUNT; i++) {
+		latitudes[i] = GetRandom(-85, 85);
+		longitudes[i] = GetRandom(-180, 180);
+	}
+	GeoPackedRTree packed;
+	TimeCounter tc;
+	sl_bool flagBuilt = packed.build(latitudes.getData(), longitudes.getData(), POINT_COUNT);
+	SLIB_ASSERT(flagBuilt);
+	Println("Packed build: %dms", (sl_uint32)(tc.getElapsedMilliseconds()));
+	GeoRTree dynamic;
+	tc.reset();
+	for (sl_size i = 0; i < POINT_COUNT; i++) {
+		dynamic.insert(LatLon(latitudes[i], longitudes[i]), i);
+	}
+	Println("R*-tree insert: %dms", (sl_uint32)(tc.getElapsedMilliseconds()));
+
+	List<LatLon> centers;
+	for (sl_size i = 0; i < QUERY_COUNT; i++) {
+		centers.add_NoLock(LatLon(GetRandom(-80, 80), GetRandom(-180, 180)));
+	}
+	sl_size nResults = 0;
+	auto counter = [&nResults](sl_size) {
+		nResults++;
+		return sl_true;
+	};
+	const char* names[] = {"Packed", "R*-tree"};
+	for (sl_uint32 k = 0; k < 2; k++) {
+		// box of 0.1 degrees
+		nResults = 0;
+		tc.reset();
+		for (sl_size i = 0; i < QUERY_COUNT; i++) {
+			GeoRectangle rect(centers[i], LatLon(centers[i].latitude + 0.1, centers[i].longitude + 0.1));
+			if (k) {
+				dynamic.search(rect, counter);
+			} else {
+				packed.search(rect, counter);
+			}
+		}
+		Println("%s box query: %.2fus/query, %d results/query", names[k], (double)(tc.getElapsedMilliseconds()) * 1000 / QUERY_COUNT, (sl_uint32)(nResults / QUERY_COUNT));
+		// radius of 10km
+		nResults = 0;
+		tc.reset();
+		for (sl_size i = 0; i < QUERY_COUNT; i++) {
+			if (k) {
+				dynamic.searchInRadius(centers[i], 10000, counter);
+			} else {
+				packed.searchInRadius(centers[i], 10000, counter);
+			}
+		}
+		Println("%s radius query: %.2fus/query, %d results/query", names[k], (double)(tc.getElapsedMilliseconds()) * 1000 / QUERY_COUNT, (sl_uint32)(nResults / QUERY_COUNT));
+		// 10 nearest neighbours
+		tc.reset();
+		for (sl_size i = 0; i < QUERY_COUNT; i++) {
+			List<sl_size> list = k ? dynamic.searchNearest(centers[i], 10) : packed.searchNearest(centers[i], 10);
+			SLIB_ASSERT(list.getCount() == 10);
+		}
+		Println("%s 10-NN query: %.2fus/query", names[k], (double)(tc.getElapsedMilliseconds()) * 1000 / QUERY_COUNT);
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <slib.h>
+#include <slib/geo/tiled_dem.h>
+
+using namespace slib;
+
+#define WIDTH 3001
+#define HEIGHT 2001
+#define TILE_SIZE 256
+#define SAMPLE_COUNT 1000000
+
+static sl_uint64 g_seed = 1;
+
+static double GetRandom(double from, double to)
+{
+	g_seed = g_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return from + (to - from) * (double)(g_seed >> 11) / (double)(1ULL << 53);
+}
+
+// smooth terrain in the pixel space
+static double GetTerrain(double x, double y)
+{
+	return 1000.0 * Math::sin(x / 150.0) * Math::cos(y / 110.0) + 0.05 * x + 300.0;
+}
+
+static float GetBilinear(const float* data, double fx, double fy)
+{
+	sl_int32 x = Math::min((sl_int32)fx, WIDTH - 2);
+	sl_int32 y = Math::min((sl_int32)fy, HEIGHT - 2);
+	double tx = fx - x;
+	double ty = fy - y;
+	const float* p = data + y * WIDTH + x;
+	return (float)((1 - ty) * ((1 - tx) * p[0] + tx * p[1]) + ty * ((1 - tx) * p[WIDTH] + tx * p[WIDTH + 1]));
+}
+
+int main(int argc, const char * argv[])
+{
+	String path = File::concatPath(System::getTempDirectory(), "slib_test_tiled_dem.bin");
+	GeoRectangle bounds;
+	bounds.bottomLeft = LatLon(36.0, 126.0);
+	bounds.topRight = LatLon(38.0, 129.0);
+	double scaleX = (double)(WIDTH - 1) / 3.0;
+	double scaleY = (double)(HEIGHT - 1) / 2.0;
+
+	Array<float> data = Array<float>::create(WIDTH * HEIGHT);
+	float* pData = data.getData();
+	for (sl_uint32 y = 0; y < HEIGHT; y++) {
+		for (sl_uint32 x = 0; x < WIDTH; x++) {
+			pData[y * WIDTH + x] = (float)(GetTerrain(x, y));
+		}
+	}
+
+	TimeCounter tc;
+	sl_bool flagCreated = TiledDEM::create(path, pData, WIDTH, HEIGHT, bounds, TILE_SIZE);
+	SLIB_ASSERT(flagCreated);
+	Println("Create: %d x %d, %dms", WIDTH, HEIGHT, tc.getElapsedMilliseconds());
+
+	TiledDEMParam param;
+	param.filePath = path;
+	param.maxCachedTiles = 16;
+	Ref<TiledDEM> dem = TiledDEM::open(param);
+	SLIB_ASSERT(dem.isNotNull());
+	SLIB_ASSERT(dem->getLevelCount() == 5);
+	SLIB_ASSERT(dem->getWidth(1) == 1501 && dem->getHeight(1) == 1001);
+	SLIB_ASSERT(dem->getWidth(4) == 188 && dem->getHeight(4) == 126);
+
+	// samples at the grid points
+	for (sl_uint32 i = 0; i < 1000; i++) {
+		sl_uint32 x = (sl_uint32)(GetRandom(0, WIDTH - 1) + 0.5);
+		sl_uint32 y = (sl_uint32)(GetRandom(0, HEIGHT - 1) + 0.5);
+		LatLon pt(38.0 - y / scaleY, 126.0 + x / scaleX);
+		float f = pData[y * WIDTH + x];
+		SLIB_ASSERT(Math::abs(dem->getAltitudeAt(pt, DEMInterpolation::Nearest) - f) < 1e-3f);
+		SLIB_ASSERT(Math::abs(dem->getAltitudeAt(pt, DEMInterpolation::Bilinear) - f) < 1e-2f);
+		SLIB_ASSERT(Math::abs(dem->getAltitudeAt(pt, DEMInterpolation::Bicubic) - f) < 1e-2f);
+	}
+
+	// batched sampling at random locations, compared with the in-memory grid
+	List<LatLon> points;
+	points.setCount_NoLock(SAMPLE_COUNT);
+	LatLon* pts = points.getData();
+	for (sl_uint32 i = 0; i < SAMPLE_COUNT; i++) {
+		pts[i] = LatLon(GetRandom(36.0, 38.0), GetRandom(126.0, 129.0));
+	}
+	List<float> outBilinear, outBicubic;
+	outBilinear.setCount_NoLock(SAMPLE_COUNT);
+	outBicubic.setCount_NoLock(SAMPLE_COUNT);
+	dem->clearCache();
+	tc.reset();
+	dem->getAltitudes(outBilinear.getData(), pts, SAMPLE_COUNT, DEMInterpolation::Bilinear);
+	Println("Bilinear (random, 16 cached tiles): %dns/sample", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / SAMPLE_COUNT));
+	tc.reset();
+	dem->getAltitudes(outBicubic.getData(), pts, SAMPLE_COUNT, DEMInterpolation::Bicubic);
+	Println("Bicubic (random, 16 cached tiles): %dns/sample", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / SAMPLE_COUNT));
+	double errorBilinear = 0, errorBicubic = 0;
+	for (sl_uint32 i = 0; i < SAMPLE_COUNT; i++) {
+		double fx = (pts[i].longitude - 126.0) * scaleX;
+		double fy = (38.0 - pts[i].latitude) * scaleY;
+		SLIB_ASSERT(Math::abs(outBilinear[i] - GetBilinear(pData, fx, fy)) < 1e-2f);
+		if (fx >= 1 && fy >= 1 && fx < WIDTH - 2 && fy < HEIGHT - 2) {
+			double f = GetTerrain(fx, fy);
+			errorBilinear = Math::max(errorBilinear, Math::abs(outBilinear[i] - f));
+			errorBicubic = Math::max(errorBicubic, Math::abs(outBicubic[i] - f));
+		}
+	}
+	Println("Max error: bilinear %.4fm, bicubic %.4fm", errorBilinear, errorBicubic);
+	SLIB_ASSERT(errorBicubic < errorBilinear);
+
+	// coherent path across the tiles
+	LatLon start(36.1, 126.1), end(37.9, 128.9);
+	List<float> profile;
+	profile.setCount_NoLock(SAMPLE_COUNT);
+	dem->clearCache();
+	tc.reset();
+	dem->getProfile(profile.getData(), start, end, SAMPLE_COUNT);
+	Println("Profile: %dns/sample", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / SAMPLE_COUNT));
+	SLIB_ASSERT(Math::abs(profile[0] - dem->getAltitudeAt(start)) < 1e-3f);
+	SLIB_ASSERT(Math::abs(profile[SAMPLE_COUNT - 1] - dem->getAltitudeAt(end)) < 1e-3f);
+
+	// overviews
+	{
+		sl_uint32 level = dem->getLevelForResolution(500);
+		SLIB_ASSERT(level == 2);
+		LatLon pt(37.0, 127.5);
+		float f0 = dem->getAltitudeAt(pt, DEMInterpolation::Bilinear, 0);
+		float f2 = dem->getAltitudeAt(pt, DEMInterpolation::Bilinear, level);
+		SLIB_ASSERT(Math::abs(f0 - f2) < 50.0f);
+	}
+
+	// line of sight
+	{
+		LatLon a(36.5, 127.0), b(37.5, 128.0);
+		SLIB_ASSERT(dem->isVisible(GeoLocation(a, 5000), GeoLocation(b, 5000)));
+		SLIB_ASSERT(!(dem->isVisible(GeoLocation(a, dem->getAltitudeAt(a) + 1), GeoLocation(LatLon(37.9, 128.9), -2000))));
+		LatLon route[] = { a, b, LatLon(36.2, 128.8) };
+		dem->prefetchPath(route, 3);
+	}
+
+	dem.setNull();
+	File::deleteFile(path);
+	Println("OK");
+	return 0;
+}
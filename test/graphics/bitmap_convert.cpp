@@ -0,0 +1,279 @@
+#include <slib.h>
+#include <slib/graphics/yuv.h>
+
+using namespace slib;
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define ITERATIONS 20
+
+static Memory CreatePixels(sl_size size)
+{
+	Memory mem = Memory::create(size);
+	sl_uint8* p = (sl_uint8*)(mem.getData());
+	sl_uint32 seed = 1234;
+	for (sl_size i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		p[i] = (sl_uint8)(seed >> 16);
+	}
+	return mem;
+}
+
+static BitmapData CreateBitmapData(BitmapFormat format, sl_uint32 width, sl_uint32 height, Memory& mem)
+{
+	BitmapData bd;
+	bd.width = width;
+	bd.height = height;
+	bd.format = format;
+	if (BitmapFormats::isYUV_420(format)) {
+		mem = CreatePixels(width * height * 3 / 2);
+		bd.pitch = width;
+		bd.data = mem.getData();
+		if (format == BitmapFormat::YUV_I420 || format == BitmapFormat::YUV_YV12) {
+			bd.pitch1 = width >> 1;
+			bd.pitch2 = width >> 1;
+		}
+		bd.fillDefaultValues();
+	} else {
+		// default pitch is aligned to 4 bytes
+		bd.fillDefaultValues();
+		mem = CreatePixels(bd.pitch * height);
+		bd.data = mem.getData();
+	}
+	return bd;
+}
+
+// byte offsets of R, G, B, A (-1: no alpha) in the packed formats
+static sl_bool GetPackedLayout(BitmapFormat format, sl_uint32& nBytes, sl_int32* offsets)
+{
+	switch (format) {
+		case BitmapFormat::RGB:
+			nBytes = 3; offsets[0] = 0; offsets[1] = 1; offsets[2] = 2; offsets[3] = -1;
+			return sl_true;
+		case BitmapFormat::BGR:
+			nBytes = 3; offsets[0] = 2; offsets[1] = 1; offsets[2] = 0; offsets[3] = -1;
+			return sl_true;
+		case BitmapFormat::RGBA:
+		case BitmapFormat::RGBA_PA:
+			nBytes = 4; offsets[0] = 0; offsets[1] = 1; offsets[2] = 2; offsets[3] = 3;
+			return sl_true;
+		case BitmapFormat::BGRA:
+		case BitmapFormat::BGRA_PA:
+			nBytes = 4; offsets[0] = 2; offsets[1] = 1; offsets[2] = 0; offsets[3] = 3;
+			return sl_true;
+		case BitmapFormat::ARGB:
+		case BitmapFormat::ARGB_PA:
+			nBytes = 4; offsets[0] = 1; offsets[1] = 2; offsets[2] = 3; offsets[3] = 0;
+			return sl_true;
+		case BitmapFormat::ABGR:
+		case BitmapFormat::ABGR_PA:
+			nBytes = 4; offsets[0] = 3; offsets[1] = 2; offsets[2] = 1; offsets[3] = 0;
+			return sl_true;
+		default:
+			break;
+	}
+	return sl_false;
+}
+
+// reads the stored samples of a pixel, without converting the alpha mode
+static Color ReadPixel(const BitmapData& bd, sl_uint32 x, sl_uint32 y)
+{
+	sl_uint32 nBytes;
+	sl_int32 offsets[4];
+	if (GetPackedLayout(bd.format, nBytes, offsets)) {
+		sl_uint8* p = (sl_uint8*)(bd.data) + bd.pitch * (sl_reg)y + x * nBytes;
+		return Color(p[offsets[0]], p[offsets[1]], p[offsets[2]], offsets[3] >= 0 ? p[offsets[3]] : 255);
+	}
+	ColorComponentBuffer c[3];
+	bd.getColorComponentBuffers(c);
+	sl_uint8 Y = ((sl_uint8*)(c[0].data))[c[0].pitch * (sl_reg)y + c[0].sampleStride * x];
+	sl_uint8 U = ((sl_uint8*)(c[1].data))[c[1].pitch * (sl_reg)(y >> 1) + c[1].sampleStride * (x >> 1)];
+	sl_uint8 V = ((sl_uint8*)(c[2].data))[c[2].pitch * (sl_reg)(y >> 1) + c[2].sampleStride * (x >> 1)];
+	Color color;
+	YUV::convertYUVToRGB(Y, U, V, color.r, color.g, color.b);
+	color.a = 255;
+	return color;
+}
+
+// premultiplied samples must not exceed alpha
+static void FixPremultipliedSamples(const BitmapData& bd)
+{
+	sl_uint32 nBytes;
+	sl_int32 offsets[4];
+	if (!(BitmapFormats::isPrecomputedAlpha(bd.format)) || !(GetPackedLayout(bd.format, nBytes, offsets))) {
+		return;
+	}
+	for (sl_uint32 y = 0; y < bd.height; y++) {
+		sl_uint8* p = (sl_uint8*)(bd.data) + bd.pitch * (sl_reg)y;
+		for (sl_uint32 x = 0; x < bd.width; x++) {
+			sl_uint8 a = p[offsets[3]];
+			for (sl_uint32 k = 0; k < 3; k++) {
+				if (p[offsets[k]] > a) {
+					p[offsets[k]] = a;
+				}
+			}
+			p += nBytes;
+		}
+	}
+}
+
+// compares the conversion with a plain per-pixel loop over the color model functions
+static sl_uint32 CheckConversion(BitmapFormat src_format, BitmapFormat dst_format, sl_uint32 width, sl_uint32 height)
+{
+	Memory memSrc, memDst;
+	BitmapData src = CreateBitmapData(src_format, width, height, memSrc);
+	BitmapData dst = CreateBitmapData(dst_format, width, height, memDst);
+	FixPremultipliedSamples(src);
+	Memory memOriginal = memDst.duplicate();
+	dst.copyPixelsFrom(src);
+
+	if ((BitmapFormats::isYUV_420(src_format) || BitmapFormats::isYUV_420(dst_format)) && ((width | height) & 1)) {
+		// odd sizes are not supported by YUV 4:2:0, and the destination must be untouched
+		return Base::equalsMemory(memDst.getData(), memOriginal.getData(), memDst.getSize()) ? 0 : 1;
+	}
+
+	sl_bool flagSrcPA = BitmapFormats::isPrecomputedAlpha(src_format);
+	sl_bool flagDstPA = BitmapFormats::isPrecomputedAlpha(dst_format);
+	sl_uint32 nMismatch = 0;
+	sl_uint32 nBytes;
+	sl_int32 offsets[4];
+	if (GetPackedLayout(dst_format, nBytes, offsets)) {
+		for (sl_uint32 y = 0; y < height; y++) {
+			for (sl_uint32 x = 0; x < width; x++) {
+				Color expected = ReadPixel(src, x, y);
+				if (flagSrcPA && !flagDstPA) {
+					expected.convertPAtoNPA();
+				} else if (!flagSrcPA && flagDstPA) {
+					expected.convertNPAtoPA();
+				}
+				Color c = ReadPixel(dst, x, y);
+				if (c.r != expected.r || c.g != expected.g || c.b != expected.b || (offsets[3] >= 0 && c.a != expected.a)) {
+					nMismatch++;
+				}
+			}
+		}
+		return nMismatch;
+	}
+	// YUV 4:2:0: luma per pixel, chroma averaged over 2x2 blocks
+	ColorComponentBuffer c[3];
+	dst.getColorComponentBuffers(c);
+	for (sl_uint32 y = 0; y < height; y += 2) {
+		for (sl_uint32 x = 0; x < width; x += 2) {
+			sl_uint32 TU = 0, TV = 0;
+			for (sl_uint32 k = 0; k < 4; k++) {
+				sl_uint32 px = x + (k & 1);
+				sl_uint32 py = y + (k >> 1);
+				Color color = ReadPixel(src, px, py);
+				sl_uint8 Y, U, V;
+				YUV::convertRGBToYUV(color.r, color.g, color.b, Y, U, V);
+				TU += U;
+				TV += V;
+				if (((sl_uint8*)(c[0].data))[c[0].pitch * (sl_reg)py + c[0].sampleStride * px] != Y) {
+					nMismatch++;
+				}
+			}
+			if (((sl_uint8*)(c[1].data))[c[1].pitch * (sl_reg)(y >> 1) + c[1].sampleStride * (x >> 1)] != (sl_uint8)(TU >> 2)) {
+				nMismatch++;
+			}
+			if (((sl_uint8*)(c[2].data))[c[2].pitch * (sl_reg)(y >> 1) + c[2].sampleStride * (x >> 1)] != (sl_uint8)(TV >> 2)) {
+				nMismatch++;
+			}
+		}
+	}
+	return nMismatch;
+}
+
+// the banded conversion must produce the same bytes as the serial one
+static sl_uint32 CheckParallel(BitmapFormat src_format, BitmapFormat dst_format, sl_uint32 width, sl_uint32 height, ThreadPool* pool, sl_uint32 nBands)
+{
+	Memory memSrc, memSerial, memParallel;
+	BitmapData src = CreateBitmapData(src_format, width, height, memSrc);
+	BitmapData serial = CreateBitmapData(dst_format, width, height, memSerial);
+	BitmapData parallel = CreateBitmapData(dst_format, width, height, memParallel);
+	FixPremultipliedSamples(src);
+	serial.copyPixelsFrom(src);
+	parallel.copyPixelsFrom(src, pool, nBands);
+	return Base::equalsMemory(memSerial.getData(), memParallel.getData(), memSerial.getSize()) ? 0 : 1;
+}
+
+static void Benchmark(const char* name, BitmapFormat src_format, BitmapFormat dst_format, ThreadPool* pool)
+{
+	Memory memSrc, memDst;
+	BitmapData src = CreateBitmapData(src_format, WIDTH, HEIGHT, memSrc);
+	BitmapData dst = CreateBitmapData(dst_format, WIDTH, HEIGHT, memDst);
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < ITERATIONS; i++) {
+		dst.copyPixelsFrom(src);
+	}
+	double timeSerial = (double)(tc.getElapsedMilliseconds()) / ITERATIONS;
+	tc.reset();
+	for (sl_uint32 i = 0; i < ITERATIONS; i++) {
+		dst.copyPixelsFrom(src, pool);
+	}
+	double timeParallel = (double)(tc.getElapsedMilliseconds()) / ITERATIONS;
+	Println("%s: %.2fms, parallel: %.2fms", name, timeSerial, timeParallel);
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 nFailed = 0;
+	// widths around the kernel block sizes exercise the scalar tails
+	for (sl_uint32 width = 30; width <= 46; width++) {
+		nFailed += CheckConversion(BitmapFormat::YUV_I420, BitmapFormat::RGBA, width, 6);
+		nFailed += CheckConversion(BitmapFormat::YUV_NV12, BitmapFormat::BGRA, width, 6);
+		nFailed += CheckConversion(BitmapFormat::YUV_NV21, BitmapFormat::RGBA, width, 6);
+		nFailed += CheckConversion(BitmapFormat::RGBA, BitmapFormat::YUV_I420, width, 6);
+		nFailed += CheckConversion(BitmapFormat::BGRA, BitmapFormat::YUV_NV12, width, 6);
+		nFailed += CheckConversion(BitmapFormat::RGBA, BitmapFormat::YUV_NV21, width, 6);
+	}
+	for (sl_uint32 width = 1; width < 70; width++) {
+		nFailed += CheckConversion(BitmapFormat::RGB, BitmapFormat::BGRA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::BGR, BitmapFormat::BGRA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::RGB, BitmapFormat::RGBA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::RGBA, BitmapFormat::BGR, width, 3);
+		nFailed += CheckConversion(BitmapFormat::RGBA, BitmapFormat::RGB, width, 3);
+		nFailed += CheckConversion(BitmapFormat::RGBA, BitmapFormat::RGBA_PA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::ABGR, BitmapFormat::ABGR_PA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::RGBA_PA, BitmapFormat::RGBA, width, 3);
+		nFailed += CheckConversion(BitmapFormat::ARGB_PA, BitmapFormat::ARGB, width, 3);
+	}
+	Println("Conversion: %s", nFailed ? "FAILED" : "OK");
+
+	Ref<ThreadPool> pool = ThreadPool::create();
+	sl_uint32 nFailedParallel = 0;
+	// heights which are not divided evenly into the bands
+	sl_uint32 heights[] = { 98, 150, 202, 334 };
+	sl_uint32 bands[] = { 2, 3, 4, 7 };
+	for (sl_uint32 h = 0; h < CountOfArray(heights); h++) {
+		for (sl_uint32 b = 0; b < CountOfArray(bands); b++) {
+			sl_uint32 height = heights[h];
+			sl_uint32 nBands = bands[b];
+			nFailedParallel += CheckParallel(BitmapFormat::YUV_I420, BitmapFormat::RGBA, 94, height, pool.get(), nBands);
+			nFailedParallel += CheckParallel(BitmapFormat::YUV_NV21, BitmapFormat::BGRA, 94, height, pool.get(), nBands);
+			nFailedParallel += CheckParallel(BitmapFormat::RGBA, BitmapFormat::YUV_NV12, 94, height, pool.get(), nBands);
+			nFailedParallel += CheckParallel(BitmapFormat::RGB, BitmapFormat::RGBA, 93, height + 1, pool.get(), nBands);
+			nFailedParallel += CheckParallel(BitmapFormat::RGBA_PA, BitmapFormat::RGBA, 93, height + 1, pool.get(), nBands);
+			nFailedParallel += CheckParallel(BitmapFormat::ARGB, BitmapFormat::RGBA, 93, height + 1, pool.get(), nBands);
+		}
+	}
+	Println("Parallel: %s", nFailedParallel ? "FAILED" : "OK");
+	nFailed += nFailedParallel;
+
+	Benchmark("I420 -> RGBA", BitmapFormat::YUV_I420, BitmapFormat::RGBA, pool.get());
+	Benchmark("NV12 -> RGBA", BitmapFormat::YUV_NV12, BitmapFormat::RGBA, pool.get());
+	Benchmark("NV21 -> BGRA", BitmapFormat::YUV_NV21, BitmapFormat::BGRA, pool.get());
+	Benchmark("RGBA -> I420", BitmapFormat::RGBA, BitmapFormat::YUV_I420, pool.get());
+	Benchmark("BGRA -> NV12", BitmapFormat::BGRA, BitmapFormat::YUV_NV12, pool.get());
+	Benchmark("RGB -> RGBA", BitmapFormat::RGB, BitmapFormat::RGBA, pool.get());
+	Benchmark("RGBA -> RGB", BitmapFormat::RGBA, BitmapFormat::RGB, pool.get());
+	Benchmark("RGBA -> RGBA_PA", BitmapFormat::RGBA, BitmapFormat::RGBA_PA, pool.get());
+	Benchmark("RGBA_PA -> RGBA", BitmapFormat::RGBA_PA, BitmapFormat::RGBA, pool.get());
+	Benchmark("ARGB -> RGBA (generic)", BitmapFormat::ARGB, BitmapFormat::RGBA, pool.get());
+
+	if (nFailed) {
+		Println("Test: FAILED (%d)", nFailed);
+		return 1;
+	}
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,215 @@
+#include <slib.h>
+#include <slib/graphics/font_atlas.h>
+
+using namespace slib;
+
+#define CHAR_HEIGHT 20
+#define MISSING_CHAR 0xFFFF
+#define THREAD_COUNT 4
+#define READ_COUNT 1000000
+
+// draws each character as a filled box whose color encodes the character
+class TestAtlas : public FontAtlas
+{
+public:
+	static Ref<TestAtlas> create(sl_uint32 planeSize, sl_uint32 maxPlanes, sl_bool flagSignedDistanceField = sl_false)
+	{
+		Ref<TestAtlas> ret = new TestAtlas;
+		FontAtlasBaseParam param;
+		param.planeWidth = planeSize;
+		param.planeHeight = planeSize;
+		param.maxPlanes = maxPlanes;
+		param.flagSignedDistanceField = flagSignedDistanceField;
+		ret->_initialize(param, CHAR_HEIGHT, CHAR_HEIGHT, 0.0f, planeSize, planeSize);
+		return ret;
+	}
+
+	static sl_uint32 getCharWidth(sl_char32 ch)
+	{
+		return 6 + ch % 11;
+	}
+
+	static sl_uint32 getCharHeight(sl_char32 ch)
+	{
+		return 10 + ch % 7;
+	}
+
+	static Color getCharColor(sl_char32 ch)
+	{
+		return Color(ch & 255, (ch >> 8) & 255, 255, 255);
+	}
+
+public:
+	sl_bool getCharImage_NoLock(sl_char32 ch, FontAtlasCharImage& _out) override
+	{
+		return sl_false;
+	}
+
+protected:
+	sl_bool _getFontMetrics(FontMetrics& _out) override
+	{
+		_out.ascent = CHAR_HEIGHT;
+		_out.descent = 0;
+		_out.leading = 0;
+		return sl_true;
+	}
+
+	sl_bool _measureChar(sl_char32 ch, TextMetrics& _out) override
+	{
+		if (ch == MISSING_CHAR) {
+			return sl_false;
+		}
+		_out.left = 0;
+		_out.top = 0;
+		_out.right = (sl_real)(getCharWidth(ch));
+		_out.bottom = (sl_real)(getCharHeight(ch));
+		_out.advanceX = _out.right;
+		_out.advanceY = CHAR_HEIGHT;
+		return sl_true;
+	}
+
+	sl_bool _drawChar(Bitmap* plane, sl_uint32 dstX, sl_uint32 dstY, sl_uint32 width, sl_uint32 height, sl_real charX, sl_real charY, sl_char32 ch) override
+	{
+		plane->resetPixels(dstX, dstY, width, height, Color::zero());
+		plane->resetPixels((sl_uint32)charX, (sl_uint32)charY, getCharWidth(ch), getCharHeight(ch), isSignedDistanceField() ? Color::White : getCharColor(ch));
+		return sl_true;
+	}
+
+	Ref<Bitmap> _createPlane() override
+	{
+		return Ref<Bitmap>::cast(Image::create(m_planeWidth, m_planeHeight));
+	}
+};
+
+// the center of the box must keep the color of the character
+static sl_bool CheckChar(TestAtlas* atlas, sl_char32 ch)
+{
+	FontAtlasChar fac;
+	sl_bool flagFound = atlas->getChar(ch, fac);
+	if (!flagFound || fac.bitmap.isNull()) {
+		return sl_false;
+	}
+	Image* image = (Image*)(fac.bitmap.get());
+	sl_int32 x = (fac.region.left + fac.region.right) / 2;
+	sl_int32 y = (fac.region.top + fac.region.bottom) / 2;
+	return image->getPixel(x, y) == TestAtlas::getCharColor(ch);
+}
+
+static sl_bool IsOverlapped(const List<FontAtlasChar>& chars)
+{
+	sl_size n = chars.getCount();
+	FontAtlasChar* data = chars.getData();
+	for (sl_size i = 0; i < n; i++) {
+		for (sl_size j = i + 1; j < n; j++) {
+			if (data[i].bitmap == data[j].bitmap) {
+				const RectangleI& a = data[i].region;
+				const RectangleI& b = data[j].region;
+				if (a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom) {
+					return sl_true;
+				}
+			}
+		}
+	}
+	return sl_false;
+}
+
+int main(int argc, const char * argv[])
+{
+	{
+		// skyline packing without eviction
+		Ref<TestAtlas> atlas = TestAtlas::create(256, 4);
+		List<FontAtlasChar> chars;
+		for (sl_char32 ch = 0x4E00; ch < 0x4E00 + 500; ch++) {
+			FontAtlasChar fac;
+			sl_bool flagFound = atlas->getChar(ch, fac);
+			SLIB_ASSERT(flagFound);
+			SLIB_ASSERT(fac.region.right <= 256 && fac.region.bottom <= 256);
+			chars.add_NoLock(fac);
+		}
+		SLIB_ASSERT(!(IsOverlapped(chars)));
+		for (sl_char32 ch = 0x4E00; ch < 0x4E00 + 500; ch++) {
+			sl_bool bRet = CheckChar(atlas.get(), ch);
+			SLIB_ASSERT(bRet);
+		}
+		Println("Packed 500 glyphs into %d planes", atlas->getPlaneCount());
+		FontAtlasChar fac;
+		sl_bool flagFound = atlas->getChar(MISSING_CHAR, fac);
+		SLIB_ASSERT(!flagFound);
+	}
+	{
+		// the least recently used planes are reused, and the hot characters stay
+		Ref<TestAtlas> atlas = TestAtlas::create(128, 3);
+		for (sl_char32 ch = 0x4E00; ch < 0x4E00 + 3000; ch++) {
+			sl_bool bRet = CheckChar(atlas.get(), ch);
+			SLIB_ASSERT(bRet);
+			bRet = CheckChar(atlas.get(), 'A');
+			SLIB_ASSERT(bRet);
+		}
+		SLIB_ASSERT(atlas->getPlaneCount() == 3);
+		TextMetrics tm;
+		sl_bool flagMeasured = atlas->measureChar(0x4E00, tm);
+		SLIB_ASSERT(flagMeasured);
+		SLIB_ASSERT(tm.advanceX == (sl_real)(TestAtlas::getCharWidth(0x4E00)));
+		atlas->removeAll();
+		SLIB_ASSERT(atlas->getPlaneCount() == 1);
+		sl_bool bRet = CheckChar(atlas.get(), 'A');
+		SLIB_ASSERT(bRet);
+	}
+	{
+		// signed distance field
+		Ref<TestAtlas> atlas = TestAtlas::create(128, 1, sl_true);
+		sl_char32 ch = 'Z';
+		FontAtlasChar fac;
+		sl_bool flagFound = atlas->getChar(ch, fac);
+		SLIB_ASSERT(flagFound);
+		sl_uint32 spread = atlas->getDistanceFieldSpread();
+		SLIB_ASSERT(fac.region.getWidth() == (sl_int32)(TestAtlas::getCharWidth(ch) + (2 + spread) * 2));
+		Image* image = (Image*)(fac.bitmap.get());
+		sl_int32 left = fac.region.left + 2 + spread;
+		sl_int32 cy = (fac.region.top + fac.region.bottom) / 2;
+		SLIB_ASSERT(image->getPixel((fac.region.left + fac.region.right) / 2, cy).a > 160);
+		SLIB_ASSERT(image->getPixel(left, cy).a > 128);
+		SLIB_ASSERT(image->getPixel(left - 1, cy).a < 128);
+		SLIB_ASSERT(image->getPixel(fac.region.left, fac.region.top).a == 0);
+	}
+	{
+		// direct characters are read without the object lock
+		Ref<TestAtlas> atlas = TestAtlas::create(256, 4);
+		for (sl_char32 ch = 32; ch < 128; ch++) {
+			sl_bool bRet = CheckChar(atlas.get(), ch);
+			SLIB_ASSERT(bRet);
+		}
+		volatile sl_int32 nErrors = 0;
+		for (sl_uint32 k = 0; k < 2; k++) {
+			sl_bool flagLock = k == 0;
+			TimeCounter tc;
+			List< Ref<Thread> > threads;
+			for (sl_uint32 i = 0; i < THREAD_COUNT; i++) {
+				threads.add_NoLock(Thread::start([atlas, flagLock, &nErrors]() {
+					FontAtlasChar fac;
+					for (sl_uint32 n = 0; n < READ_COUNT; n++) {
+						sl_char32 ch = 32 + n % 96;
+						sl_bool flagFound;
+						if (flagLock) {
+							ObjectLocker lock(atlas.get());
+							flagFound = atlas->getChar_NoLock(ch, fac);
+						} else {
+							flagFound = atlas->getChar(ch, fac);
+						}
+						if (!flagFound || fac.metrics.advanceX != (sl_real)(TestAtlas::getCharWidth(ch))) {
+							Base::interlockedIncrement32(&nErrors);
+						}
+					}
+				}));
+			}
+			for (auto& thread : threads) {
+				thread->finishAndWait();
+			}
+			Println("%s: %d threads x %d lookups: %dms", flagLock ? "Locked" : "Direct", THREAD_COUNT, READ_COUNT, tc.getElapsedMilliseconds());
+		}
+		SLIB_ASSERT(!nErrors);
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
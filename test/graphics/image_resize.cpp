@@ -0,0 +1,92 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define ITERATIONS 5
+
+static Ref<Image> CreateTestImage(sl_uint32 width, sl_uint32 height)
+{
+	Ref<Image> image = Image::allocate(width, height);
+	for (sl_uint32 y = 0; y < height; y++) {
+		Color* row = image->getColorsAt(0, y);
+		for (sl_uint32 x = 0; x < width; x++) {
+			row[x] = Color((sl_uint8)(x * 255 / width), (sl_uint8)(y * 255 / height), (sl_uint8)((x ^ y) & 255), 255);
+		}
+	}
+	return image;
+}
+
+static void TestCorrectness()
+{
+	StretchMode modes[] = { StretchMode::Mitchell, StretchMode::Lanczos3, StretchMode::Area };
+	for (auto mode : modes) {
+		// solid colors are preserved (up to the premultiplied round trip)
+		Ref<Image> solid = Image::allocate(97, 61);
+		solid->fillColor(Color(10, 200, 30, 128));
+		sl_uint32 sizes[][2] = { { 13, 7 }, { 200, 150 }, { 97, 20 }, { 30, 61 }, { 1, 1 } };
+		for (auto& size : sizes) {
+			Ref<Image> image = solid->resize(size[0], size[1], mode);
+			SLIB_ASSERT(image.isNotNull());
+			for (sl_uint32 y = 0; y < size[1]; y++) {
+				for (sl_uint32 x = 0; x < size[0]; x++) {
+					Color c = image->getPixel(x, y);
+					SLIB_ASSERT(Math::abs((sl_int32)(c.r) - 10) <= 2 && Math::abs((sl_int32)(c.g) - 200) <= 2 && Math::abs((sl_int32)(c.b) - 30) <= 2 && c.a == 128);
+				}
+			}
+		}
+		// gradients stay close to the box filter
+		Ref<Image> src = CreateTestImage(640, 480);
+		Ref<Image> ref = src->stretch(160, 120, StretchMode::Box);
+		Ref<ThreadPool> pool = ThreadPool::create();
+		Ref<Image> image = src->resize(160, 120, mode);
+		Ref<Image> imageParallel = src->resize(160, 120, mode, pool.get());
+		for (sl_uint32 y = 0; y < 120; y++) {
+			for (sl_uint32 x = 0; x < 160; x++) {
+				Color c1 = image->getPixel(x, y);
+				Color c2 = ref->getPixel(x, y);
+				SLIB_ASSERT(c1 == imageParallel->getPixel(x, y));
+				SLIB_ASSERT(Math::abs((sl_int32)(c1.r) - (sl_int32)(c2.r)) <= 4 && Math::abs((sl_int32)(c1.g) - (sl_int32)(c2.g)) <= 4);
+			}
+		}
+	}
+	Println("Correctness: OK");
+}
+
+static void Benchmark(const char* name, const Ref<Image>& src, sl_uint32 width, sl_uint32 height, StretchMode mode, ThreadPool* pool)
+{
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < ITERATIONS; i++) {
+		src->resize(width, height, mode, pool);
+	}
+	Println("%s %dx%d -> %dx%d: %dms", name, src->getWidth(), src->getHeight(), width, height, (sl_uint32)(tc.getElapsedMilliseconds() / ITERATIONS));
+}
+
+int main(int argc, const char * argv[])
+{
+	TestCorrectness();
+
+	Ref<ThreadPool> pool = ThreadPool::create();
+	Ref<Image> photo = CreateTestImage(4000, 3000);
+	Ref<Image> small = CreateTestImage(960, 540);
+	struct {
+		const char* name;
+		StretchMode mode;
+		ThreadPool* pool;
+	} cases[] = {
+		{ "Nearest", StretchMode::Nearest, sl_null },
+		{ "Linear", StretchMode::Linear, sl_null },
+		{ "Box", StretchMode::Box, sl_null },
+		{ "Mitchell", StretchMode::Mitchell, sl_null },
+		{ "Lanczos3", StretchMode::Lanczos3, sl_null },
+		{ "Area", StretchMode::Area, sl_null },
+		{ "Lanczos3 (parallel)", StretchMode::Lanczos3, pool.get() },
+		{ "Area (parallel)", StretchMode::Area, pool.get() }
+	};
+	for (auto& item : cases) {
+		Benchmark(item.name, photo, 400, 300, item.mode, item.pool);
+		Benchmark(item.name, small, 1920, 1080, item.mode, item.pool);
+	}
+
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include <slib.h>
+#include <slib/network/async_coroutine.h>
+
+using namespace slib;
+
+#define PORT 10090
+#define ROUND_TRIPS 10000
+
+static Task<> ServeConnection(Ref<AsyncTcpSocket> socket)
+{
+	char buf[256];
+	for (;;) {
+		AsyncStreamAwaitResult result = co_await AsyncStreamCoroutine::read(socket, buf, sizeof(buf));
+		if (!(result.isSuccess())) {
+			break;
+		}
+		result = co_await AsyncStreamCoroutine::write(socket, buf, result.size);
+		if (!(result.isSuccess())) {
+			break;
+		}
+	}
+}
+
+static Task<> Serve(Ref<AsyncTcpAcceptor> acceptor)
+{
+	for (;;) {
+		Socket socket;
+		SocketAddress address;
+		if (!(co_await acceptor->accept(socket, address))) {
+			break;
+		}
+		AsyncTcpSocketParam param;
+		param.socket = Move(socket);
+		ServeConnection(AsyncTcpSocket::create(param)).start();
+	}
+}
+
+static Task<sl_uint32> Echo(sl_uint32 count)
+{
+	Ref<AsyncTcpSocket> socket = AsyncTcpSocket::create();
+	if (!(co_await AsyncSocketCoroutine::connect(socket, SocketAddress(IPv4Address::Loopback, PORT)))) {
+		co_return 0;
+	}
+	sl_uint32 n = 0;
+	for (sl_uint32 i = 0; i < count; i++) {
+		sl_uint32 value = i, echo = 0;
+		if (!((co_await AsyncStreamCoroutine::write(socket, &value, sizeof(value))).isSuccess())) {
+			break;
+		}
+		if (!((co_await AsyncStreamCoroutine::readFully(socket, &echo, sizeof(echo))).isSuccess())) {
+			break;
+		}
+		if (echo != value) {
+			break;
+		}
+		n++;
+	}
+	co_return n;
+}
+
+static Task<sl_uint32> Sum(sl_uint32 n)
+{
+	sl_uint32 sum = 0;
+	for (sl_uint32 i = 1; i <= n; i++) {
+		sum += co_await Promise<sl_uint32>::fromValue(i);
+	}
+	co_await Coroutine::sleep(10);
+	co_return sum;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 sum = 0;
+	Coroutine::toPromise(Sum(100)).wait(&sum);
+	SLIB_ASSERT(sum == 5050);
+
+	AsyncTcpServerParam param;
+	param.bindAddress.port = PORT;
+	Ref<AsyncTcpAcceptor> acceptor = AsyncTcpAcceptor::create(param);
+	if (acceptor.isNull()) {
+		Println("Failed to listen on %d", PORT);
+		return -1;
+	}
+	Serve(acceptor).start();
+
+	TimeCounter tc;
+	sl_uint32 n = 0;
+	Coroutine::toPromise(Echo(ROUND_TRIPS)).wait(&n);
+	Println("%d round trips: %dms", n, tc.getElapsedMilliseconds());
+	SLIB_ASSERT(n == ROUND_TRIPS);
+
+	acceptor->close();
+	Println("Test: OK!!!");
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define SERVER_PORT 18089
+#define SERVER_URL "http://127.0.0.1:18089"
+#define MAX_CONNECTIONS 4
+#define REQUEST_COUNT 200
+
+static CHashMap<String, sl_bool> g_connections;
+static volatile sl_int32 g_nRunning = 0;
+static volatile sl_int32 g_nMaxRunning = 0;
+
+static Variant OnRequest(HttpServerContext* context)
+{
+	g_connections.put(context->getRemoteAddress().toString(), sl_true);
+	if (context->getPath() == "/slow") {
+		sl_int32 n = Base::interlockedIncrement32(&g_nRunning);
+		for (;;) {
+			sl_int32 m = g_nMaxRunning;
+			if (n <= m || Base::interlockedCompareExchange32(&g_nMaxRunning, n, m)) {
+				break;
+			}
+		}
+		System::sleep(50);
+		Base::interlockedDecrement32(&g_nRunning);
+	}
+	return String::concat(context->getPath(), ":", context->getParameter("n"));
+}
+
+// sends the requests at once, and returns the number of the correct responses
+static sl_uint32 SendRequests(const String& path, sl_uint32 count)
+{
+	Ref<Event> ev = Event::create();
+	volatile sl_int32 nSuccess = 0;
+	volatile sl_int32 nFinished = 0;
+	for (sl_uint32 i = 0; i < count; i++) {
+		String expected = String::concat(path, ":", String::fromUint32(i));
+		UrlRequestParam param;
+		param.url = String::concat(SERVER_URL, path, "?n=", String::fromUint32(i));
+		param.onComplete = [&, expected, count](UrlRequest* request) {
+			if (!(request->isError()) && request->getResponseContentAsString() == expected) {
+				Base::interlockedIncrement32(&nSuccess);
+			}
+			if (Base::interlockedIncrement32(&nFinished) == (sl_int32)count) {
+				ev->set();
+			}
+		};
+		CurlRequest::send(param);
+	}
+	ev->wait();
+	return (sl_uint32)nSuccess;
+}
+
+static void Benchmark(const char* title)
+{
+	TimeCounter tc;
+	sl_uint32 n = SendRequests("/fast", REQUEST_COUNT);
+	SLIB_ASSERT(n == REQUEST_COUNT);
+	Println("%s: %d requests: %dms", title, REQUEST_COUNT, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	HttpServerParam serverParam;
+	serverParam.port = SERVER_PORT;
+	serverParam.dispatcher = ThreadPool::create(0, 64);
+	serverParam.onRequest = &OnRequest;
+	Ref<HttpServer> server = HttpServer::create(serverParam);
+	SLIB_ASSERT(server.isNotNull());
+
+	CurlRequest::setMultiEngineEnabled(sl_true);
+	CurlRequest::setMaximumConnectionsPerHost(MAX_CONNECTIONS);
+	{
+		// concurrent transfers are limited per host
+		sl_uint32 n = SendRequests("/slow", 16);
+		SLIB_ASSERT(n == 16);
+		SLIB_ASSERT(g_nMaxRunning <= MAX_CONNECTIONS);
+	}
+	{
+		// the connections are reused
+		sl_uint32 n = SendRequests("/fast", REQUEST_COUNT);
+		SLIB_ASSERT(n == REQUEST_COUNT);
+		SLIB_ASSERT(g_connections.getCount() <= MAX_CONNECTIONS);
+	}
+	{
+		// synchronous request on the engine
+		Ref<UrlRequest> request = CurlRequest::sendSynchronous(SERVER_URL "/sync?n=1");
+		SLIB_ASSERT(request.isNotNull());
+		SLIB_ASSERT(request->getResponseContentAsString() == "/sync:1");
+	}
+	{
+		// cancelled request is not completed
+		volatile sl_bool flagCompleted = sl_false;
+		UrlRequestParam param;
+		param.url = SERVER_URL "/slow";
+		param.onComplete = [&flagCompleted](UrlRequest*) {
+			flagCompleted = sl_true;
+		};
+		Ref<UrlRequest> request = CurlRequest::send(param);
+		SLIB_ASSERT(request.isNotNull());
+		System::sleep(10);
+		request->cancel();
+		sl_uint32 n = SendRequests("/fast", 8);
+		SLIB_ASSERT(n == 8);
+		System::sleep(100);
+		SLIB_ASSERT(!flagCompleted);
+	}
+
+	Benchmark("Multi engine");
+	CurlRequest::setMultiEngineEnabled(sl_false);
+	Benchmark("Thread pool");
+
+	Println("Test: OK!!!");
+	return 0;
+}
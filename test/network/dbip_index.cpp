@@ -0,0 +1,162 @@
+// Build with extra/dbip/dbip.cpp
+
+#include <slib.h>
+
+#include "../../extra/dbip/dbip.h"
+
+using namespace slib;
+
+#define IPV4_RANGE_COUNT 400000
+#define IPV6_RANGE_COUNT 200000
+#define LOOKUP_COUNT 2000000
+
+static sl_uint64 g_seed = 1;
+
+static sl_uint32 GetRandom()
+{
+	g_seed = g_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (sl_uint32)(g_seed >> 32);
+}
+
+static IPv6Address GetIPv6(sl_uint64 high, sl_uint64 low)
+{
+	IPv6Address ip;
+	MIO::writeUint64BE(ip.m, high);
+	MIO::writeUint64BE(ip.m + 8, low);
+	return ip;
+}
+
+// Sorted ranges with gaps between them
+static String GenerateCsv()
+{
+	StringBuffer sb;
+	sl_uint32 ipv4 = 0x01000000;
+	for (sl_uint32 i = 0; i < IPV4_RANGE_COUNT; i++) {
+		sl_uint32 size = (GetRandom() & 0x3ff) + 1;
+		sl_uint32 end = ipv4 + size - 1;
+		sl_char8 c1 = (sl_char8)('A' + GetRandom() % 26);
+		sl_char8 c2 = (sl_char8)('A' + GetRandom() % 10);
+		sb.add(String::format("\"%s\",\"%s\",\"%c%c\"\n", IPv4Address(ipv4).toString(), IPv4Address(end).toString(), c1, c2));
+		ipv4 = end + 1 + (GetRandom() % 3 ? 0 : (GetRandom() & 0xff) + 1);
+	}
+	sl_uint64 ipv6 = 0x2001000000000000ULL;
+	for (sl_uint32 i = 0; i < IPV6_RANGE_COUNT; i++) {
+		sl_uint64 size = ((sl_uint64)(GetRandom() & 0xfff) + 1) << 32;
+		sl_uint64 end = ipv6 + size - 1;
+		sl_char8 c1 = (sl_char8)('A' + GetRandom() % 26);
+		sl_char8 c2 = (sl_char8)('A' + GetRandom() % 10);
+		sb.add(String::format("\"%s\",\"%s\",\"%c%c\"\n", GetIPv6(ipv6, 0).toString(), GetIPv6(end, 0xffffffffffffffffULL).toString(), c1, c2));
+		ipv6 = end + 1 + (GetRandom() % 3 ? 0 : ((sl_uint64)(GetRandom() & 0xff) + 1) << 32);
+	}
+	return sb.merge();
+}
+
+static sl_bool EqualsCode(const char* a, const char* b)
+{
+	if (a && b) {
+		return StringView(a).equals(StringView(b));
+	}
+	return !a && !b;
+}
+
+int main(int argc, const char * argv[])
+{
+	String dir = System::getTempDirectory();
+	String pathCsv = File::concatPath(dir, "slib_test_dbip.csv");
+	String pathIndex = File::concatPath(dir, "slib_test_dbip.idx");
+	sl_bool flagWritten = File::writeAllTextUTF8(pathCsv, GenerateCsv());
+	SLIB_ASSERT(flagWritten);
+
+	DbIp dbCsv;
+	TimeCounter tc;
+	sl_bool flagParsed = dbCsv.parseFile(pathCsv);
+	SLIB_ASSERT(flagParsed);
+	Println("Parse CSV: %dms", tc.getElapsedMilliseconds());
+
+	tc.reset();
+	sl_bool flagCompiled = DbIp::compileIndex(pathCsv, pathIndex);
+	SLIB_ASSERT(flagCompiled);
+	Println("Compile index: %dms, %d bytes", tc.getElapsedMilliseconds(), File::getSize(pathIndex));
+
+	DbIp dbIndex;
+	tc.reset();
+	sl_bool flagOpened = dbIndex.openIndex(pathIndex);
+	SLIB_ASSERT(flagOpened);
+	Println("Open index: %dms", tc.getElapsedMilliseconds());
+	SLIB_ASSERT(dbIndex.isIndexLoaded());
+
+	// random addresses covering the ranges, the gaps and the outside
+	List<IPv4Address> list4;
+	List<IPv6Address> list6;
+	for (sl_uint32 i = 0; i < LOOKUP_COUNT; i++) {
+		list4.add_NoLock(IPv4Address(0x01000000 + GetRandom() % 0x10000000));
+		list6.add_NoLock(GetIPv6(0x2001000000000000ULL + ((sl_uint64)(GetRandom() % 0x40000000) << 24), (sl_uint64)GetRandom() << 16));
+	}
+	list4.add_NoLock(IPv4Address((sl_uint32)0));
+	list4.add_NoLock(IPv4Address(0x01000000));
+	list4.add_NoLock(IPv4Address(0xffffffff));
+	list6.add_NoLock(GetIPv6(0, 0));
+	list6.add_NoLock(GetIPv6(0x2001000000000000ULL, 0));
+	list6.add_NoLock(GetIPv6(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+	sl_size n4 = list4.getCount();
+	sl_size n6 = list6.getCount();
+	IPv4Address* ips4 = list4.getData();
+	IPv6Address* ips6 = list6.getData();
+
+	List<const char*> expected4, expected6, codes;
+	expected4.setCount_NoLock(n4);
+	expected6.setCount_NoLock(n6);
+	codes.setCount_NoLock(Math::max(n4, n6));
+
+	tc.reset();
+	for (sl_size i = 0; i < n4; i++) {
+		expected4[i] = dbCsv.getCountryCode(ips4[i]);
+	}
+	Println("IPv4 lookup (CSV, binary search): %dns", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / n4));
+	tc.reset();
+	for (sl_size i = 0; i < n4; i++) {
+		codes[i] = dbIndex.getCountryCode(ips4[i]);
+	}
+	Println("IPv4 lookup (index): %dns", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / n4));
+	for (sl_size i = 0; i < n4; i++) {
+		SLIB_ASSERT(EqualsCode(codes[i], expected4[i]));
+	}
+	tc.reset();
+	dbIndex.getCountryCodes(codes.getData(), ips4, n4);
+	Println("IPv4 lookup (index, batch): %dns", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / n4));
+	for (sl_size i = 0; i < n4; i++) {
+		SLIB_ASSERT(EqualsCode(codes[i], expected4[i]));
+	}
+
+	tc.reset();
+	for (sl_size i = 0; i < n6; i++) {
+		expected6[i] = dbCsv.getCountryCode(ips6[i]);
+	}
+	Println("IPv6 lookup (CSV, binary search): %dns", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / n6));
+	tc.reset();
+	dbIndex.getCountryCodes(codes.getData(), ips6, n6);
+	Println("IPv6 lookup (index, batch): %dns", (sl_int32)(tc.getElapsedMilliseconds() * 1000000 / n6));
+	for (sl_size i = 0; i < n6; i++) {
+		SLIB_ASSERT(EqualsCode(codes[i], expected6[i]));
+		SLIB_ASSERT(EqualsCode(dbIndex.getCountryCode(ips6[i]), expected6[i]));
+	}
+
+	// exact match and deeper reverse search
+	for (sl_size i = 0; i < 10000; i++) {
+		SLIB_ASSERT(EqualsCode(dbIndex.getCountryCode(ips4[i], 0), dbCsv.getCountryCode(ips4[i], 0)));
+		SLIB_ASSERT(EqualsCode(dbIndex.getCountryCode(ips4[i], 3), dbCsv.getCountryCode(ips4[i], 3)));
+	}
+	List<DbIp::IPv4Item> items1 = dbCsv.getIPv4Items("KA");
+	List<DbIp::IPv4Item> items2 = dbIndex.getIPv4Items("KA");
+	SLIB_ASSERT(items1.getCount() == items2.getCount() && items1.getCount() > 0);
+	for (sl_size i = 0; i < items1.getCount(); i++) {
+		SLIB_ASSERT(items1[i].start == items2[i].start && items1[i].end == items2[i].end);
+	}
+	SLIB_ASSERT(dbCsv.getIPv6Items("KA").getCount() == dbIndex.getIPv6Items("KA").getCount());
+
+	dbIndex.clearAll();
+	File::deleteFile(pathCsv);
+	File::deleteFile(pathIndex);
+	Println("OK");
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define SERVER_NAME "slib_test_ipc_shm"
+#define PLAIN_SERVER_NAME "slib_test_ipc_plain"
+#define RING_SIZE 0x4000000
+#define FRAME_SIZE 0x1000000
+#define ROUND_TRIPS 20
+
+static Memory CreateMessage(sl_size size, sl_uint32 seed)
+{
+	Memory mem = Memory::create(size);
+	SLIB_ASSERT(mem.isNotNull());
+	sl_uint32* p = (sl_uint32*)(mem.getData());
+	for (sl_size i = 0; i < (size >> 2); i++) {
+		p[i] = (sl_uint32)i * 2654435761u + seed;
+	}
+	return mem;
+}
+
+// the server answers with the request whose first word is inverted
+static void OnReceiveMessage(IPCRequestMessage& request, IPCResponseMessage& response)
+{
+	Memory mem = Memory::create(request.data, request.size);
+	if (mem.getSize() >= 4) {
+		sl_uint32* p = (sl_uint32*)(mem.getData());
+		*p = ~(*p);
+	}
+	response.setMemory(mem);
+}
+
+static sl_bool CheckResponse(const Memory& request, const IPCResponseMessage& response)
+{
+	if (response.size != request.getSize()) {
+		return sl_false;
+	}
+	const sl_uint32* p = (const sl_uint32*)(request.getData());
+	const sl_uint32* q = (const sl_uint32*)(response.data);
+	return p[0] == ~(q[0]) && Base::equalsMemory(p + 1, q + 1, request.getSize() - 4);
+}
+
+static IPCResponseMessage SendMessage(const StringParam& name, const Memory& request, sl_uint32 sizeRing)
+{
+	IPCRequestParam param;
+	param.targetName = name;
+	param.message.setMemory(request);
+	param.sharedMemorySize = sizeRing;
+	param.timeout = 10000;
+	IPCResponseMessage response;
+	sl_bool flagSuccess = IPC::sendMessageSynchronous(param, response);
+	SLIB_ASSERT(flagSuccess);
+	return response;
+}
+
+static void Benchmark(const char* title, sl_uint32 sizeRing)
+{
+	Memory request = CreateMessage(FRAME_SIZE, 7);
+	// touches every page of the rings before measuring
+	for (sl_uint32 i = 0; i < (RING_SIZE / FRAME_SIZE) * 2; i++) {
+		SendMessage(SERVER_NAME, request, sizeRing);
+	}
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < ROUND_TRIPS; i++) {
+		IPCResponseMessage response = SendMessage(SERVER_NAME, request, sizeRing);
+		SLIB_ASSERT(CheckResponse(request, response));
+	}
+	Println("%s: %d x %dMB round trips: %dms", title, ROUND_TRIPS, FRAME_SIZE >> 20, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	IPCServerParam serverParam;
+	serverParam.name = SERVER_NAME;
+	serverParam.flagSharedMemory = sl_true;
+	serverParam.responseTimeout = 10000;
+	serverParam.onReceiveMessage = &OnReceiveMessage;
+	Ref<IPCServer> server = IPC::createServer(serverParam);
+	SLIB_ASSERT(server.isNotNull());
+
+	serverParam.name = PLAIN_SERVER_NAME;
+	serverParam.flagSharedMemory = sl_false;
+	Ref<IPCServer> serverPlain = IPC::createServer(serverParam);
+	SLIB_ASSERT(serverPlain.isNotNull());
+
+	{
+		// small, empty and wrapped-around messages
+		for (sl_uint32 i = 0; i < 200; i++) {
+			Memory request = CreateMessage(4 + ((i * 7919) % 0x40000), i);
+			IPCResponseMessage response = SendMessage(SERVER_NAME, request, 0x100000);
+			SLIB_ASSERT(CheckResponse(request, response));
+		}
+		IPCResponseMessage response = SendMessage(SERVER_NAME, sl_null, 0x100000);
+		SLIB_ASSERT(!(response.size));
+	}
+	{
+		// held responses fill the ring, and the messages go through the socket until they are freed
+		List<IPCResponseMessage> responses;
+		Memory request = CreateMessage(0x60000, 1);
+		for (sl_uint32 i = 0; i < 8; i++) {
+			IPCResponseMessage response = SendMessage(SERVER_NAME, request, 0x100000);
+			SLIB_ASSERT(CheckResponse(request, response));
+			responses.add_NoLock(Move(response));
+		}
+		for (auto& response : responses) {
+			SLIB_ASSERT(CheckResponse(request, response));
+		}
+	}
+	{
+		// larger than the ring
+		Memory request = CreateMessage(0x300000, 2);
+		IPCResponseMessage response = SendMessage(SERVER_NAME, request, 0x100000);
+		SLIB_ASSERT(CheckResponse(request, response));
+	}
+	{
+		// the server without the shared memory transport
+		Memory request = CreateMessage(0x10000, 3);
+		IPCResponseMessage response = SendMessage(PLAIN_SERVER_NAME, request, 0x100000);
+		SLIB_ASSERT(CheckResponse(request, response));
+	}
+	{
+		// asynchronous requests
+		Memory request = CreateMessage(0x200000, 4);
+		Ref<Event> ev = Event::create();
+		volatile sl_int32 nSuccess = 0;
+		volatile sl_int32 nFinished = 0;
+		for (sl_uint32 i = 0; i < 8; i++) {
+			IPCRequestParam param;
+			param.targetName = SERVER_NAME;
+			param.message.setMemory(request);
+			param.sharedMemorySize = RING_SIZE;
+			param.timeout = 10000;
+			param.onResponse = [&](IPCResponseMessage& response) {
+				if (CheckResponse(request, response)) {
+					Base::interlockedIncrement32(&nSuccess);
+				}
+				if (Base::interlockedIncrement32(&nFinished) == 8) {
+					ev->set();
+				}
+			};
+			IPC::sendMessage(param);
+		}
+		ev->wait();
+		SLIB_ASSERT(nSuccess == 8);
+	}
+
+	Benchmark("Shared memory", RING_SIZE);
+	Benchmark("Domain socket", 0);
+
+	Println("Test: OK!!!");
+	return 0;
+}
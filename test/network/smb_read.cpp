@@ -0,0 +1,474 @@
+#include <slib.h>
+#include <slib/network/smb.h>
+#include <slib/network/smb_packet.h>
+
+using namespace slib;
+
+#define FILE_SIZE 0x400000
+#define BLOCK_SIZE 0x10000
+#define CLIENT_COUNT 200
+#define PIPELINE_DEPTH 16
+#define FLOOD_COUNT 5000
+
+static sl_uint8 GetFileByte(sl_uint64 offset)
+{
+	return (sl_uint8)((offset * 7919) >> 5);
+}
+
+// minimal SMB2 client on blocking socket
+class Client
+{
+public:
+	Socket socket;
+	sl_uint64 messageId = 0;
+	sl_uint64 sessionId = 0;
+	sl_uint32 treeId = 0;
+	sl_uint32 credits = 1;
+
+public:
+	static void InitHeader(Smb2Header& smb, Smb2Command command, sl_uint64 messageId)
+	{
+		Base::zeroMemory(&smb, sizeof(smb));
+		smb.setSmb2();
+		smb.setHeaderLength(sizeof(smb));
+		smb.setCommand(command);
+		smb.setCreditCharge(1);
+		smb.setCreditRequested(8);
+		smb.setMessageId(messageId);
+	}
+
+	void initHeader(Smb2Header& smb, Smb2Command command)
+	{
+		InitHeader(smb, command, messageId++);
+		smb.setSessionId(sessionId);
+		smb.setTreeId(treeId);
+	}
+
+	sl_bool sendFrame(const Memory& frame)
+	{
+		sl_uint8 header[4];
+		MIO::writeUint32BE(header, (sl_uint32)(frame.getSize()));
+		header[0] = 0;
+		if (socket.sendFully(header, 4) != 4) {
+			return sl_false;
+		}
+		return socket.sendFully(frame.getData(), frame.getSize()) == (sl_reg)(frame.getSize());
+	}
+
+	sl_bool receive(void* _buf, sl_uint32 size)
+	{
+		sl_uint8* buf = (sl_uint8*)_buf;
+		while (size) {
+			sl_int32 n = socket.receive(buf, size);
+			if (n <= 0) {
+				return sl_false;
+			}
+			buf += n;
+			size -= n;
+		}
+		return sl_true;
+	}
+
+	Memory receiveFrame()
+	{
+		sl_uint8 header[4];
+		if (!(receive(header, 4))) {
+			return sl_null;
+		}
+		sl_uint32 size = SLIB_MAKE_DWORD(0, header[1], header[2], header[3]);
+		Memory mem = Memory::create(size);
+		if (mem.isNull() || !(receive(mem.getData(), size))) {
+			return sl_null;
+		}
+		return mem;
+	}
+
+	template <class MESSAGE>
+	Memory request(Smb2Header& smb, const MESSAGE& msg, const void* blob = sl_null, sl_size sizeBlob = 0)
+	{
+		MemoryBuffer buf;
+		buf.addNew(&smb, sizeof(smb));
+		buf.addNew(&msg, sizeof(msg));
+		buf.addNew(blob, sizeBlob);
+		if (!(sendFrame(buf.merge()))) {
+			return sl_null;
+		}
+		Memory ret = receiveFrame();
+		if (ret.getSize() >= sizeof(Smb2Header)) {
+			credits += ((Smb2Header*)(ret.getData()))->getCreditGranted() - 1;
+		}
+		return ret;
+	}
+
+	static Memory BuildCreate(Smb2Header& smb, const StringView16& name)
+	{
+		Smb2CreateRequestMessage msg;
+		Base::zeroMemory(&msg, sizeof(msg));
+		msg.setSize(sizeof(msg), sl_true);
+		msg.setDisposition(SmbDisposition::Open);
+		msg.setFileNameOffset(sizeof(Smb2Header) + sizeof(msg));
+		msg.setFileNameLength((sl_uint16)(name.getLength() << 1));
+		MemoryBuffer buf;
+		buf.addNew(&smb, sizeof(smb));
+		buf.addNew(&msg, sizeof(msg));
+		buf.addNew(name.getData(), name.getLength() << 1);
+		return buf.merge();
+	}
+
+	static Memory BuildRead(Smb2Header& smb, sl_uint64 fileId, sl_uint64 offset, sl_uint32 size)
+	{
+		Smb2ReadRequestMessage msg;
+		Base::zeroMemory(&msg, sizeof(msg));
+		msg.setSize(sizeof(msg), sl_true);
+		msg.setReadLength(size);
+		msg.setFileOffset(offset);
+		MIO::writeUint64LE(msg.getGuid(), fileId);
+		MIO::writeUint64LE(msg.getGuid() + 8, fileId);
+		MemoryBuffer buf;
+		buf.addNew(&smb, sizeof(smb));
+		buf.addNew(&msg, sizeof(msg));
+		return buf.merge();
+	}
+
+	sl_bool connect(const SocketAddress& address)
+	{
+		socket = Socket::openTcp();
+		if (!(socket.connectAndWait(address, 5000) && socket.setNonBlockingMode(sl_false))) {
+			return sl_false;
+		}
+		{
+			Smb2Header smb;
+			initHeader(smb, Smb2Command::Negotiate);
+			Smb2Message msg;
+			Base::zeroMemory(&msg, sizeof(msg));
+			Memory res = request(smb, msg);
+			if (res.getSize() < sizeof(Smb2Header)) {
+				return sl_false;
+			}
+		}
+		for (sl_uint32 i = 0; i < 2; i++) {
+			Smb2Header smb;
+			initHeader(smb, Smb2Command::SessionSetup);
+			Smb2Message msg;
+			Base::zeroMemory(&msg, sizeof(msg));
+			Memory res = request(smb, msg);
+			if (res.getSize() < sizeof(Smb2Header)) {
+				return sl_false;
+			}
+			sessionId = ((Smb2Header*)(res.getData()))->getSessionId();
+		}
+		{
+			Smb2Header smb;
+			initHeader(smb, Smb2Command::TreeConnect);
+			String16 path = SLIB_UNICODE("\\\\127.0.0.1\\Test");
+			Smb2TreeConnectRequestMessage msg;
+			Base::zeroMemory(&msg, sizeof(msg));
+			msg.setSize(sizeof(msg), sl_true);
+			msg.setTreeOffset(sizeof(Smb2Header) + sizeof(msg));
+			msg.setTreeLength((sl_uint16)(path.getLength() << 1));
+			Memory res = request(smb, msg, path.getData(), path.getLength() << 1);
+			if (res.getSize() < sizeof(Smb2Header) || ((Smb2Header*)(res.getData()))->getStatus() != SmbStatus::Success) {
+				return sl_false;
+			}
+			treeId = ((Smb2Header*)(res.getData()))->getTreeId();
+		}
+		return sl_true;
+	}
+
+	sl_uint64 open(const StringView16& name)
+	{
+		Smb2Header smb;
+		initHeader(smb, Smb2Command::Create);
+		if (!(sendFrame(BuildCreate(smb, name)))) {
+			return 0;
+		}
+		Memory res = receiveFrame();
+		if (res.getSize() < sizeof(Smb2Header) + sizeof(Smb2CreateResponseMessage)) {
+			return 0;
+		}
+		Smb2CreateResponseMessage* msg = (Smb2CreateResponseMessage*)((sl_uint8*)(res.getData()) + sizeof(Smb2Header));
+		return MIO::readUint64LE(msg->getGuid());
+	}
+
+};
+
+static sl_bool CheckReadResponse(const Memory& frame, sl_uint32 pos, sl_uint64 offset, sl_uint32 size)
+{
+	sl_uint8* data = (sl_uint8*)(frame.getData()) + pos;
+	Smb2Header* smb = (Smb2Header*)data;
+	if (smb->getStatus() != SmbStatus::Success) {
+		return sl_false;
+	}
+	Smb2ReadResponseMessage* msg = (Smb2ReadResponseMessage*)(data + sizeof(Smb2Header));
+	if (msg->getReadCount() != size) {
+		return sl_false;
+	}
+	sl_uint8* content = data + msg->getDataOffset();
+	if (pos + msg->getDataOffset() + size > frame.getSize()) {
+		return sl_false;
+	}
+	for (sl_uint32 i = 0; i < size; i++) {
+		if (content[i] != GetFileByte(offset + i)) {
+			return sl_false;
+		}
+	}
+	return sl_true;
+}
+
+static void TestCompound(const SocketAddress& address)
+{
+	Client client;
+	sl_bool flagConnected = client.connect(address);
+	SLIB_ASSERT(flagConnected);
+
+	// CREATE + READ + CLOSE in a frame, the last two using the created file
+	MemoryBuffer buf;
+	Smb2Header smb;
+	client.initHeader(smb, Smb2Command::Create);
+	Memory create = Client::BuildCreate(smb, SLIB_UNICODE("data.bin"));
+	sl_uint32 sizeCreate = ((sl_uint32)(create.getSize()) + 7) & ~7;
+	((Smb2Header*)(create.getData()))->setChainOffset(sizeCreate);
+	buf.add(create);
+	sl_uint8 zero[8] = { 0 };
+	buf.addNew(zero, sizeCreate - create.getSize());
+
+	client.initHeader(smb, Smb2Command::Read);
+	smb.setFlags(Smb2HeaderFlags::Chained);
+	smb.setTreeId(0xffffffff);
+	Memory read = Client::BuildRead(smb, SLIB_UINT64(0xffffffffffffffff), 1000, 5000);
+	sl_uint32 sizeRead = ((sl_uint32)(read.getSize()) + 7) & ~7;
+	((Smb2Header*)(read.getData()))->setChainOffset(sizeRead);
+	buf.add(read);
+	buf.addNew(zero, sizeRead - read.getSize());
+
+	client.initHeader(smb, Smb2Command::Close);
+	smb.setFlags(Smb2HeaderFlags::Chained);
+	Smb2CloseRequestMessage close;
+	Base::zeroMemory(&close, sizeof(close));
+	close.setSize(sizeof(close), sl_false);
+	MIO::writeUint64LE(close.getGuid(), SLIB_UINT64(0xffffffffffffffff));
+	buf.addNew(&smb, sizeof(smb));
+	buf.addNew(&close, sizeof(close));
+
+	client.sendFrame(buf.merge());
+	Memory res = client.receiveFrame();
+	SLIB_ASSERT(res.getSize() > sizeof(Smb2Header));
+
+	sl_uint32 pos = 0;
+	Smb2Command commands[] = { Smb2Command::Create, Smb2Command::Read, Smb2Command::Close };
+	for (sl_uint32 i = 0; i < 3; i++) {
+		SLIB_ASSERT(pos + sizeof(Smb2Header) <= res.getSize());
+		Smb2Header* header = (Smb2Header*)((sl_uint8*)(res.getData()) + pos);
+		SLIB_ASSERT(header->getCommand() == commands[i]);
+		SLIB_ASSERT(header->getStatus() == SmbStatus::Success);
+		SLIB_ASSERT(header->getCreditGranted() >= 1);
+		if (i == 1) {
+			sl_bool flagValid = CheckReadResponse(res, pos, 1000, 5000);
+			SLIB_ASSERT(flagValid);
+		}
+		if (i == 2) {
+			SLIB_ASSERT(!(header->getChainOffset()));
+		} else {
+			SLIB_ASSERT(header->getChainOffset());
+			pos += header->getChainOffset();
+		}
+	}
+	Println("Compounded request: OK");
+}
+
+static void TestCredits(const SocketAddress& address)
+{
+	Client client;
+	sl_bool flagConnected = client.connect(address);
+	SLIB_ASSERT(flagConnected);
+	sl_uint64 fileId = client.open(SLIB_UNICODE("data.bin"));
+	SLIB_ASSERT(fileId);
+
+	// large read needs multiple credits
+	Smb2Header smb;
+	client.initHeader(smb, Smb2Command::Read);
+	smb.setCreditCharge(1);
+	client.sendFrame(Client::BuildRead(smb, fileId, 0, 0x100000));
+	Memory res = client.receiveFrame();
+	SLIB_ASSERT(((Smb2Header*)(res.getData()))->getStatus() == SmbStatus::InvalidParameter);
+
+	client.initHeader(smb, Smb2Command::Read);
+	smb.setCreditCharge(16);
+	client.messageId += 15;
+	client.sendFrame(Client::BuildRead(smb, fileId, 0, 0x100000));
+	res = client.receiveFrame();
+	sl_bool flagValid = CheckReadResponse(res, 0, 0, 0x100000);
+	SLIB_ASSERT(flagValid);
+	SLIB_ASSERT(((Smb2Header*)(res.getData()))->getCreditCharge() == 16);
+
+	// credits granted to the client are limited
+	sl_uint32 total = 0;
+	for (sl_uint32 i = 0; i < 200; i++) {
+		client.initHeader(smb, Smb2Command::Read);
+		smb.setCreditRequested(1000);
+		client.sendFrame(Client::BuildRead(smb, fileId, 0, 16));
+		res = client.receiveFrame();
+		total += ((Smb2Header*)(res.getData()))->getCreditGranted() - 1;
+	}
+	SLIB_ASSERT(total > 0 && total <= 512);
+	Println("Credits: OK");
+}
+
+// the client sends far more requests than its credits, and the server keeps up without queuing all of them
+static void TestFlood(const SocketAddress& address)
+{
+	Client client;
+	sl_bool flagConnected = client.connect(address);
+	SLIB_ASSERT(flagConnected);
+	sl_uint64 fileId = client.open(SLIB_UNICODE("data.bin"));
+	SLIB_ASSERT(fileId);
+	sl_uint64 firstId = client.messageId;
+	client.messageId += FLOOD_COUNT;
+	volatile sl_bool flagSent = sl_false;
+	Ref<Thread> sender = Thread::start([&client, &flagSent, firstId, fileId]() {
+		MemoryBuffer buf;
+		for (sl_uint32 i = 0; i < FLOOD_COUNT; i++) {
+			Smb2Header smb;
+			Client::InitHeader(smb, i % 250 ? Smb2Command::Read : Smb2Command::Create, firstId + i);
+			smb.setSessionId(client.sessionId);
+			smb.setTreeId(client.treeId);
+			Memory frame;
+			if (i % 250) {
+				frame = Client::BuildRead(smb, fileId, (firstId + i) % 1000, 0x1000);
+			} else {
+				// serial requests in between
+				frame = Client::BuildCreate(smb, SLIB_UNICODE("data.bin"));
+			}
+			sl_uint8 header[4];
+			MIO::writeUint32BE(header, (sl_uint32)(frame.getSize()));
+			header[0] = 0;
+			buf.addNew(header, 4);
+			buf.add(frame);
+		}
+		Memory all = buf.merge();
+		flagSent = client.socket.sendFully(all.getData(), all.getSize()) == (sl_reg)(all.getSize());
+	});
+	sl_uint32 nReceived = 0;
+	sl_uint32 nInvalid = 0;
+	for (; nReceived < FLOOD_COUNT; nReceived++) {
+		Memory res = client.receiveFrame();
+		if (res.getSize() < sizeof(Smb2Header)) {
+			break;
+		}
+		Smb2Header* smb = (Smb2Header*)(res.getData());
+		sl_uint64 id = smb->getMessageId();
+		if (id < firstId || id >= firstId + FLOOD_COUNT) {
+			nInvalid++;
+		} else if ((id - firstId) % 250) {
+			if (!(CheckReadResponse(res, 0, id % 1000, 0x1000))) {
+				nInvalid++;
+			}
+		} else if (smb->getCommand() != Smb2Command::Create || smb->getStatus() != SmbStatus::Success) {
+			nInvalid++;
+		}
+	}
+	sender->finishAndWait();
+	SLIB_ASSERT(flagSent && nReceived == FLOOD_COUNT && !nInvalid);
+	Println("Flooded requests: %d responses, %d invalid", nReceived, nInvalid);
+}
+
+static void RunClient(const SocketAddress& address, volatile sl_int32* nErrors)
+{
+	Client client;
+	if (!(client.connect(address))) {
+		Base::interlockedIncrement32(nErrors);
+		return;
+	}
+	sl_uint64 fileId = client.open(SLIB_UNICODE("data.bin"));
+	if (!fileId) {
+		Base::interlockedIncrement32(nErrors);
+		return;
+	}
+	// pipelines the READ requests, and matches the responses by message id
+	sl_uint64 firstId = client.messageId;
+	MemoryBuffer buf;
+	for (sl_uint32 i = 0; i < PIPELINE_DEPTH; i++) {
+		Smb2Header smb;
+		client.initHeader(smb, Smb2Command::Read);
+		sl_uint64 offset = (sl_uint64)(((firstId + i) * 13) % (FILE_SIZE / BLOCK_SIZE)) * BLOCK_SIZE;
+		Memory frame = Client::BuildRead(smb, fileId, offset, BLOCK_SIZE);
+		sl_uint8 header[4];
+		MIO::writeUint32BE(header, (sl_uint32)(frame.getSize()));
+		header[0] = 0;
+		buf.addNew(header, 4);
+		buf.add(frame);
+	}
+	Memory all = buf.merge();
+	if (client.socket.sendFully(all.getData(), all.getSize()) != (sl_reg)(all.getSize())) {
+		Base::interlockedIncrement32(nErrors);
+		return;
+	}
+	for (sl_uint32 i = 0; i < PIPELINE_DEPTH; i++) {
+		Memory res = client.receiveFrame();
+		if (res.getSize() < sizeof(Smb2Header)) {
+			Base::interlockedIncrement32(nErrors);
+			return;
+		}
+		sl_uint64 id = ((Smb2Header*)(res.getData()))->getMessageId();
+		sl_uint64 offset = (sl_uint64)((id * 13) % (FILE_SIZE / BLOCK_SIZE)) * BLOCK_SIZE;
+		if (id < firstId || id >= firstId + PIPELINE_DEPTH || !(CheckReadResponse(res, 0, offset, BLOCK_SIZE))) {
+			Base::interlockedIncrement32(nErrors);
+			return;
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	String dir = File::concatPath(System::getTempDirectory(), "smb_read_test");
+	File::createDirectories(dir);
+	{
+		Memory mem = Memory::create(FILE_SIZE);
+		sl_uint8* data = (sl_uint8*)(mem.getData());
+		for (sl_uint32 i = 0; i < FILE_SIZE; i++) {
+			data[i] = GetFileByte(i);
+		}
+		sl_bool flagWritten = File::writeAllBytes(File::concatPath(dir, "data.bin"), mem);
+		SLIB_ASSERT(flagWritten);
+	}
+
+	Ref<SmbServer> server;
+	SocketAddress address;
+	for (sl_uint32 i = 0; i < 100 && server.isNull(); i++) {
+		SmbServerParam param;
+		param.bindAddress = IPv4Address(127, 0, 0, 1);
+		param.port = (sl_uint16)(20000 + Math::randomInt() % 30000);
+		param.maxThreadCount = 8;
+		param.addFileShare("Test", dir);
+		server = SmbServer::create(param);
+		address = SocketAddress(param.bindAddress, param.port);
+	}
+	SLIB_ASSERT(server.isNotNull());
+
+	TestCompound(address);
+	TestCredits(address);
+	TestFlood(address);
+
+	volatile sl_int32 nErrors = 0;
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < CLIENT_COUNT; i++) {
+		threads.add_NoLock(Thread::start([address, &nErrors]() {
+			RunClient(address, &nErrors);
+		}));
+	}
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	Println("%d clients x %d pipelined reads: %dms", CLIENT_COUNT, PIPELINE_DEPTH, tc.getElapsedMilliseconds());
+
+	server->release();
+	File::remove(dir, FileOperationFlags::Recursive);
+	// the responses are checked also in the release build
+	if (nErrors) {
+		Println("Test: FAILED (%d clients)", nErrors);
+		return 1;
+	}
+	Println("Test: OK!!!");
+	return 0;
+}